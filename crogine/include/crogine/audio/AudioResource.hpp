@@ -30,6 +30,7 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
+#include <crogine/core/AsyncLoader.hpp>
 #include <crogine/detail/Types.hpp>
 #include <crogine/audio/AudioSource.hpp>
 
@@ -54,10 +55,10 @@ namespace cro
 
         ~AudioResource() = default;
         AudioResource(const AudioResource&) = delete;
-        AudioResource(AudioResource&&) noexcept = default;
+        AudioResource(AudioResource&&) noexcept;
 
         AudioResource& operator = (const AudioResource&) = delete;
-        AudioResource& operator = (AudioResource&&) noexcept = default;
+        AudioResource& operator = (AudioResource&&) noexcept;
 
         /*!
         \brief Loads an audio file and maps the resulting data to the given ID
@@ -80,6 +81,19 @@ namespace cro
         */
         std::int32_t load(const std::string& path, bool streaming = false);
 
+        /*!
+        \brief Loads an audio file asynchronously and maps it to the given ID.
+        The file is decoded on a worker thread and the buffer created on the
+        main thread by the AsyncLoader. Streaming sources only decode a small
+        amount of data up front so are not supported: use load() instead.
+        Until the returned handle is ready get() returns an empty buffer.
+        \param id Unique ID to map to the new data source. If the ID is in use this will fail.
+        \param path String containing the path to the file to load.
+        \returns AsyncHandle used to query whether the file was successfully loaded.
+        \see AsyncLoader
+        */
+        AsyncHandle loadAsync(std::int32_t id, const std::string& path);
+
         /*!
         \brief Attempts to return the loaded data mapped to the given ID
         If the requested ID is not found an empty buffer will be returned
@@ -91,5 +105,8 @@ namespace cro
         std::unique_ptr<AudioSource> m_fallback;
         std::unordered_map<std::int32_t, std::unique_ptr<AudioSource>> m_sources;
         std::unordered_map<std::string, std::int32_t> m_usedPaths;
+
+        std::shared_ptr<AudioResource*> m_asyncOwner;
+        std::unordered_map<std::int32_t, AsyncHandle> m_asyncHandles;
     };
 }
\ No newline at end of file
@@ -241,6 +241,7 @@ namespace cro
         std::vector<std::pair<std::function<void()>, const GuiClient*>> m_debugWindows;
         std::vector<std::pair<std::function<void()>, const GuiClient*>> m_guiWindows;
         bool m_drawDebugWindows;
+        ConvarConnection m_drawDebugWindowsConnection;
         void doImGui();
 
         static void addConsoleTab(const std::string&, const std::function<void()>&, const GuiClient*);
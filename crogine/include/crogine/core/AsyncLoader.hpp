@@ -0,0 +1,176 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/core/Clock.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <future>
+
+namespace cro
+{
+    /*!
+    \brief Handle to a job submitted to the AsyncLoader.
+    Resources which support asynchronous loading return one of these
+    so that the caller can poll for completion, or wait for it.
+    Handles are cheap to copy and may be freely shared.
+    */
+    class CRO_EXPORT_API AsyncHandle final
+    {
+    public:
+        /*!
+        \brief Returns true if this handle refers to a submitted job
+        */
+        bool valid() const;
+
+        /*!
+        \brief Returns true once the job has completed, successfully or not
+        */
+        bool isReady() const;
+
+        /*!
+        \brief Returns true if the job completed successfully.
+        Returns false if the job failed, or has not yet completed.
+        */
+        bool succeeded() const;
+
+        /*!
+        \brief Blocks until the job completes and returns whether or
+        not it succeeded. Pending uploads are processed while waiting
+        so this MUST only be called from the main thread.
+        */
+        bool wait() const;
+
+        /*!
+        \brief Creates a handle which is already complete with the given result.
+        Useful for returning from functions which can complete immediately,
+        for example when a resource has already been loaded.
+        */
+        static AsyncHandle fromResult(bool result);
+
+    private:
+        friend class AsyncLoader;
+        std::shared_future<bool> m_future;
+    };
+
+    /*!
+    \brief Job based asset loader.
+    Loading an asset is split into two stages. The first stage, performing
+    file I/O and decoding, is run on a pool of worker threads. The second
+    stage, creating any graphics or audio API objects from the decoded data,
+    is queued to be run on the main thread where the rendering context is
+    current. Upload stages are processed each frame by the App, up to a
+    configurable time budget, so that large amounts of data can be streamed
+    in without stalling the frame. Window::loadResources() additionally waits
+    for all outstanding work to complete before returning, so that the worker
+    threads can decode in parallel while the loading screen is displayed.
+
+    TextureResource, MeshResource, AudioResource and ModelDefinition all provide
+    asynchronous variants of their load functions built on this class, but
+    custom jobs can also be submitted directly.
+    */
+    class CRO_EXPORT_API AsyncLoader final
+    {
+    public:
+        /*!
+        \brief Run on a worker thread. Should return true if the data
+        was successfully loaded and decoded.
+        */
+        using DecodeFunc = std::function<bool()>;
+
+        /*!
+        \brief Run on the main thread. Is passed the result of the decode
+        stage and should return whether or not the job as a whole succeeded.
+        Upload functions are always called, even if decoding failed, so that
+        they can create fallback resources if needed.
+        */
+        using UploadFunc = std::function<bool(bool decoded)>;
+
+        /*!
+        \brief Submits a job to the loader.
+        Any data shared between the decode and upload stages should be captured
+        by the functions in a shared_ptr. Upload functions which refer to an object
+        which may be destroyed before the upload is run should check its lifetime,
+        for example via a captured weak_ptr.
+        \param decode Function run on a worker thread
+        \param upload Function run on the main thread once decoding has completed.
+        May be nullptr if no upload stage is required.
+        \returns AsyncHandle used to query the status of the job
+        */
+        static AsyncHandle submit(DecodeFunc decode, UploadFunc upload = nullptr);
+
+        /*!
+        \brief Processes pending uploads until either the queue is empty
+        or the upload budget has been exceeded. This is called automatically
+        by the App once per frame.
+        */
+        static void update();
+
+        /*!
+        \brief Blocks until all submitted jobs have completed.
+        While waiting the calling thread helps decode pending jobs, and
+        processes uploads without a time budget. Main thread only.
+        */
+        static void finish();
+
+        /*!
+        \brief Sets the maximum time spent processing uploads each frame.
+        At least one upload is always processed per frame if one is pending.
+        Defaults to 4 milliseconds.
+        */
+        static void setUploadBudget(Time budget);
+
+        /*!
+        \brief Returns the current upload budget
+        */
+        static Time getUploadBudget();
+
+        /*!
+        \brief Returns the number of jobs which have been submitted but
+        have not yet completed
+        */
+        static std::size_t getPendingCount();
+
+        /*!
+        \brief Returns the number of worker threads used for decoding
+        */
+        static std::size_t getThreadCount();
+
+        /*!
+        \brief Cancels any jobs which have not yet started decoding, waits for
+        running jobs to finish and stops the worker threads. Called by the App
+        before the render context is destroyed. Jobs submitted afterwards will
+        restart the worker threads.
+        */
+        static void shutdown();
+    };
+}
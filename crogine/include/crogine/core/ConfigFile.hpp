@@ -41,6 +41,10 @@ source distribution.
 #include <crogine/detail/glm/vec3.hpp>
 #include <crogine/detail/glm/vec4.hpp>
 
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -74,6 +78,9 @@ namespace cro
     private:
         ConfigItem* m_parent;
         std::string m_name;
+        std::size_t m_nameHash; //compared before the name when searching
+
+        friend class ConfigObject;
     };
     
     /*!
@@ -110,7 +117,11 @@ namespace cro
     private:
         std::string m_value;
         bool m_isStringValue;
-        std::vector<float> valueAsArray() const;
+
+        //comma separated values are parsed once when the value is set
+        std::array<float, 4u> m_array = {};
+        void parseArray();
+        const std::array<float, 4u>& valueAsArray() const { return m_array; }
     };
 
 #include "ConfigFile.inl"
@@ -262,12 +273,11 @@ namespace cro
         std::vector<ConfigProperty> m_properties;
         std::vector<ConfigObject> m_objects;
 
-        static NameValue getObjectName(const std::string& line);
-        static NameValue getPropertyName(const std::string& line);
-        static bool isProperty(const std::string& line);
-        static void removeComment(std::string& line);
+        ConfigProperty* findProperty(const std::string& name, std::size_t hash) const;
+        ConfigObject* findObjectWithName(const std::string& name, std::size_t hash) const;
 
-        bool parseAsJson(SDL_RWops*);
+        bool parse(std::vector<char>& data, const std::string& path);
+        bool parseAsJson(const std::vector<char>& data);
 
         std::size_t write(SDL_RWops* file, std::uint16_t depth = 0u);
     };
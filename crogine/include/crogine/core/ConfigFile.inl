@@ -48,28 +48,42 @@ inline cro::String ConfigProperty::getValue<cro::String>() const
 template <>
 inline std::int32_t ConfigProperty::getValue<std::int32_t>() const
 {
-    std::int32_t retVal;
-    std::istringstream is(m_value);
-    if (is >> retVal) return retVal;
-    return 0;
+    char* end = nullptr;
+    auto retVal = std::strtoll(m_value.c_str(), &end, 10);
+    if (end == m_value.c_str()
+        || retVal < std::numeric_limits<std::int32_t>::min()
+        || retVal > std::numeric_limits<std::int32_t>::max())
+    {
+        return 0;
+    }
+    return static_cast<std::int32_t>(retVal);
 }
 
 template <>
 inline std::uint32_t ConfigProperty::getValue<std::uint32_t>() const
 {
-    std::uint32_t retVal;
-    std::istringstream is(m_value);
-    if (is >> retVal) return retVal;
-    return 0;
+    //negative values wrap, as they would when read from a stream
+    char* end = nullptr;
+    auto retVal = std::strtoll(m_value.c_str(), &end, 10);
+    if (end == m_value.c_str()
+        || retVal > std::numeric_limits<std::uint32_t>::max()
+        || retVal < -static_cast<std::int64_t>(std::numeric_limits<std::uint32_t>::max()))
+    {
+        return 0;
+    }
+    return static_cast<std::uint32_t>(retVal);
 }
 
 template <>
 inline float ConfigProperty::getValue<float>() const
 {
-    float retVal;
-    std::istringstream is(m_value);
-    if (is >> retVal) return retVal;
-    return 0.f;
+    char* end = nullptr;
+    auto retVal = std::strtof(m_value.c_str(), &end);
+    if (end == m_value.c_str() || !std::isfinite(retVal))
+    {
+        return 0.f;
+    }
+    return retVal;
 }
 
 template <>
@@ -81,53 +95,35 @@ inline bool ConfigProperty::getValue<bool>() const
 template <>
 inline glm::vec2 ConfigProperty::getValue<glm::vec2>() const
 {
-    auto values = valueAsArray();
-    glm::vec2 retval(0.f); //loop allows for values to be the wrong size
-    for (auto i = 0u; i < values.size() && i < 2; ++i)
-    {
-        retval[i] = values[i];
-    }
-
-    return retval;
+    const auto& values = valueAsArray();
+    return glm::vec2(values[0], values[1]);
 }
 
 template <>
 inline glm::vec3 ConfigProperty::getValue<glm::vec3>() const
 {
-    auto values = valueAsArray();
-    glm::vec3 retval(0.f);
-    for (auto i = 0u; i < values.size() && i < 3; ++i)
-    {
-        retval[i] = values[i];
-    }
-
-    return retval;
+    const auto& values = valueAsArray();
+    return glm::vec3(values[0], values[1], values[2]);
 }
 
 template <>
 inline glm::vec4 ConfigProperty::getValue<glm::vec4>() const
 {
-    auto values = valueAsArray();
-    glm::vec4 retval(0.f);
-    for (auto i = 0u; i < values.size() && i < 4; ++i)
-    {
-        retval[i] = values[i];
-    }
-
-    return retval;
+    const auto& values = valueAsArray();
+    return glm::vec4(values[0], values[1], values[2], values[3]);
 }
 
 template <>
 inline FloatRect ConfigProperty::getValue<FloatRect>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     return { values[0], values[1], values[2], values[3] };
 }
 
 template <>
 inline Colour ConfigProperty::getValue<Colour>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     auto clamp = [](float v)
     {
         return std::max(0.f, std::min(1.f, v));
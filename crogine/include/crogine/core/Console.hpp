@@ -32,14 +32,184 @@ source distribution.
 #include <crogine/Config.hpp>
 #include <crogine/core/ConfigFile.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace cro
 {
     class ConsoleClient;
     class GuiClient;
+
+    template <typename T>
+    class Convar;
+
+    namespace Detail
+    {
+        /*!
+        \brief Storage for a convar registered with Console::registerConvar().
+        Slots are owned by the console and never move once created, so
+        handles can safely hold a pointer to them.
+        */
+        class CRO_EXPORT_API ConvarSlot
+        {
+        public:
+            ConvarSlot(const std::string& name, const std::string& help)
+                : m_name(name), m_help(help) {}
+            virtual ~ConvarSlot() = default;
+
+            ConvarSlot(const ConvarSlot&) = delete;
+            ConvarSlot& operator = (const ConvarSlot&) = delete;
+
+            const std::string& getName() const { return m_name; }
+            const std::string& getHelp() const { return m_help; }
+
+            //parses the value from the given property and raises callbacks
+            virtual void read(const ConfigProperty&) = 0;
+            //writes the current value to the given property
+            virtual void write(ConfigProperty&) const = 0;
+            //removes the callback with the given ID, used by ConvarConnection
+            virtual void removeCallback(std::uint32_t id) = 0;
+
+        private:
+            std::string m_name;
+            std::string m_help;
+        };
+
+        template <typename T>
+        class TypedConvarSlot final : public ConvarSlot
+        {
+        public:
+            TypedConvarSlot(const std::string& name, const T& v, const std::string& help)
+                : ConvarSlot(name, help), value(v) {}
+
+            void read(const ConfigProperty& property) override
+            {
+                value = property.getValue<T>();
+                notify();
+            }
+
+            void write(ConfigProperty& property) const override
+            {
+                property.setValue(value);
+            }
+
+            void notify()
+            {
+                //callbacks may be removed while notifying, in which
+                //case they're cleared here and erased afterwards
+                m_notifying = true;
+                for (auto i = 0u; i < m_callbacks.size(); ++i)
+                {
+                    if (m_callbacks[i].second)
+                    {
+                        m_callbacks[i].second(value);
+                    }
+                }
+                m_notifying = false;
+
+                m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+                    [](const auto& cb) { return !cb.second; }), m_callbacks.end());
+            }
+
+            std::uint32_t addCallback(const std::function<void(const T&)>& cb)
+            {
+                m_callbacks.emplace_back(++m_nextCallbackID, cb);
+                return m_nextCallbackID;
+            }
+
+            void removeCallback(std::uint32_t id) override
+            {
+                auto result = std::find_if(m_callbacks.begin(), m_callbacks.end(),
+                    [id](const auto& cb) { return cb.first == id; });
+                if (result != m_callbacks.end())
+                {
+                    if (m_notifying)
+                    {
+                        result->second = nullptr;
+                    }
+                    else
+                    {
+                        m_callbacks.erase(result);
+                    }
+                }
+            }
+
+            T value;
+
+        private:
+            std::vector<std::pair<std::uint32_t, std::function<void(const T&)>>> m_callbacks;
+            std::uint32_t m_nextCallbackID = 0;
+            bool m_notifying = false;
+        };
+    }
+
+    /*!
+    \brief Returned by Convar::addCallback(). The callback is removed when
+    the connection is destroyed or release() is called, so a connection
+    should be stored alongside anything the callback captures, such as a
+    State capturing 'this'. Console variables exist for the lifetime of the
+    application, so a callback which outlives what it captures will be
+    called with dangling references the next time the variable changes.
+    Connections are move-only.
+    */
+    class CRO_EXPORT_API ConvarConnection final
+    {
+    public:
+        ConvarConnection() = default;
+        ~ConvarConnection() { release(); }
+
+        ConvarConnection(const ConvarConnection&) = delete;
+        ConvarConnection& operator = (const ConvarConnection&) = delete;
+
+        ConvarConnection(ConvarConnection&& other) noexcept
+            : m_slot(other.m_slot), m_id(other.m_id)
+        {
+            other.m_slot = nullptr;
+        }
+
+        ConvarConnection& operator = (ConvarConnection&& other) noexcept
+        {
+            if (&other != this)
+            {
+                release();
+                m_slot = other.m_slot;
+                m_id = other.m_id;
+                other.m_slot = nullptr;
+            }
+            return *this;
+        }
+
+        /*!
+        \brief Removes the callback, if it hasn't already been removed
+        */
+        void release()
+        {
+            if (m_slot)
+            {
+                m_slot->removeCallback(m_id);
+                m_slot = nullptr;
+            }
+        }
+
+        /*!
+        \brief Returns true if the connection still has a callback registered
+        */
+        bool connected() const { return m_slot != nullptr; }
+
+    private:
+        ConvarConnection(Detail::ConvarSlot* slot, std::uint32_t id) : m_slot(slot), m_id(id) {}
+
+        Detail::ConvarSlot* m_slot = nullptr;
+        std::uint32_t m_id = 0;
+
+        template <typename T>
+        friend class Convar;
+    };
     
     /*!
     \brief Console class.
@@ -85,6 +255,24 @@ namespace cro
         */
         static void addConvar(const std::string& name, const std::string& value, const std::string& helpText = "");
 
+        /*!
+        \brief Registers a typed convar and returns a handle to it.
+        Reading the value through the returned handle does not require any
+        string lookups, so handles should be preferred over getConvarValue()
+        in code which queries a variable every frame. If the variable already
+        exists, for example because it was loaded from the convar file or
+        added with addConvar(), the existing value is kept and the default
+        value is ignored. Registering the same name more than once returns
+        a handle to the same variable.
+        \param name Name of the variable as it appears in the console
+        \param defaultValue Value of the variable if it doesn't already exist
+        \param helpText Optional string describing the variable
+        \returns Convar handle. This is invalid if the variable was previously
+        registered with a different type.
+        */
+        template <typename T>
+        static Convar<T> registerConvar(const std::string& name, const T& defaultValue, const std::string& helpText = "");
+
         /*!
         \brief Attempts to retrieve the current value of the given console variable
         \returns Default constructed of type if the variable doesn't exist
@@ -122,6 +310,10 @@ namespace cro
                 if (auto val = obj->findProperty("value"); val != nullptr)
                 {
                     val->setValue(value);
+                    if (auto* slot = findConvarSlot(convar); slot != nullptr)
+                    {
+                        slot->read(*val);
+                    }
                     finalise(); //saves convar file.
                 }
                 return;
@@ -147,6 +339,8 @@ namespace cro
     private:
         friend class App;
         friend class ConsoleClient;
+        template <typename T>
+        friend class Convar;
 
         static std::vector<std::string> m_debugLines;
 
@@ -163,8 +357,105 @@ namespace cro
         static void finalise();
 
         static cro::ConfigObject& getConvars();
+
+        static Detail::ConvarSlot* findConvarSlot(const std::string& name);
+        static Detail::ConvarSlot* insertConvarSlot(std::unique_ptr<Detail::ConvarSlot> slot);
+        static void writeConvarSlot(const Detail::ConvarSlot& slot);
     };
 
-//#include "Console.inl"
+    /*!
+    \brief Handle to a console variable registered with Console::registerConvar().
+    Reading the value is a single pointer dereference, and callbacks can be
+    registered to be notified whenever the value changes, be it via the handle,
+    Console::setConvarValue() or by entering the variable in the console window.
+    Handles are cheap to copy and remain valid for the lifetime of the application,
+    but callbacks are only raised while the ConvarConnection returned when adding
+    them exists.
+    */
+    template <typename T>
+    class Convar final
+    {
+    public:
+        Convar() = default;
+
+        /*!
+        \brief Returns true if this handle refers to a registered variable
+        */
+        bool valid() const { return m_slot != nullptr; }
+
+        /*!
+        \brief Returns the current value of the variable
+        */
+        const T& get() const
+        {
+            CRO_ASSERT(m_slot, "Convar handle is not valid");
+            return m_slot->value;
+        }
+
+        operator const T& () const { return get(); }
+
+        /*!
+        \brief Sets the value of the variable and raises any registered callbacks.
+        The new value is written to the convar file when the console is shut down.
+        */
+        void set(const T& value) const
+        {
+            CRO_ASSERT(m_slot, "Convar handle is not valid");
+            m_slot->value = value;
+            Console::writeConvarSlot(*m_slot);
+            m_slot->notify();
+        }
+
+        /*!
+        \brief Adds a callback which is executed with the new value
+        each time the value of the variable changes.
+        \returns A ConvarConnection which must be kept for as long as the
+        callback should be raised. Destroying the connection removes the
+        callback, so callers must release it before anything the callback
+        captures is destroyed.
+        */
+        [[nodiscard]] ConvarConnection addCallback(const std::function<void(const T&)>& cb) const
+        {
+            CRO_ASSERT(m_slot, "Convar handle is not valid");
+            return ConvarConnection(m_slot, m_slot->addCallback(cb));
+        }
+
+        /*!
+        \brief Returns the name of the variable
+        */
+        const std::string& getName() const
+        {
+            CRO_ASSERT(m_slot, "Convar handle is not valid");
+            return m_slot->getName();
+        }
+
+    private:
+        explicit Convar(Detail::TypedConvarSlot<T>* slot) : m_slot(slot) {}
+        Detail::TypedConvarSlot<T>* m_slot = nullptr;
+
+        friend class Console;
+    };
+
+    template <typename T>
+    Convar<T> Console::registerConvar(const std::string& name, const T& defaultValue, const std::string& helpText)
+    {
+        static_assert(std::is_same_v<T, std::string> || std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::uint32_t>
+            || std::is_same_v<T, float> || std::is_same_v<T, bool> || std::is_same_v<T, glm::vec2>
+            || std::is_same_v<T, glm::vec3> || std::is_same_v<T, glm::vec4> || std::is_same_v<T, FloatRect>
+            || std::is_same_v<T, Colour>, "Type is not supported by ConfigFile");
+
+        if (auto* slot = findConvarSlot(name); slot != nullptr)
+        {
+            if (auto* typed = dynamic_cast<Detail::TypedConvarSlot<T>*>(slot); typed != nullptr)
+            {
+                return Convar<T>(typed);
+            }
+            LogE << name << ": convar is already registered with a different type" << std::endl;
+            return {};
+        }
+
+        auto* slot = insertConvarSlot(std::make_unique<Detail::TypedConvarSlot<T>>(name, defaultValue, helpText));
+        return Convar<T>(static_cast<Detail::TypedConvarSlot<T>*>(slot));
+    }
 
 }
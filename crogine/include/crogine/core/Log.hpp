@@ -48,14 +48,34 @@ source distribution.
 #include <Windows.h>
 #endif //_MSC_VER
 
+/*!
+\brief Messages with a Logger::Type lower than this are compiled out
+of the LogI/LogW/LogE macros. 0 logs everything, 1 warnings and errors,
+2 only errors and 3 nothing. Messages may also be filtered at runtime
+with Logger::setLogLevel()
+*/
+#ifndef CRO_LOG_LEVEL
+#define CRO_LOG_LEVEL 0
+#endif
+
 namespace cro
 {
+    class App;
     class String;
 
     /*!
     \brief Class to allowing messages to be logged to a combination
     of one or more destinations such as the console, log file or
-    output window in Visual Studio
+    output window in Visual Studio.
+
+    Logging never blocks the caller: messages are queued and written
+    by a background thread which keeps the log file open, so it is safe
+    to log from parallel systems. Messages printed to the Console are
+    passed to the main thread and printed each frame, up to 1024 lines
+    per frame, after which a count of the dropped lines is printed.
+    Each distinct message is written at most 5 times per second, any
+    further repeats are counted and the total written once the second
+    has passed.
     */
     class CRO_EXPORT_API Logger final
     {
@@ -84,15 +104,37 @@ namespace cro
         /*!
         \brief Allows logging with C++ streams.
         \param type Type of log message to print.
-        Note that this will not output to file, only to the console
+        Note that this will not output to file, only to the console.
+        Each thread has its own stream, so lines logged from different
+        threads are not interleaved.
         */
         static std::ostream& log(Type type = Type::Info);
 
-    private:
-        static std::list<std::string> m_buffer;
-        static std::string m_output;
+        /*!
+        \brief Sets the minimum type of message which is logged at runtime.
+        Defaults to Type::Info, ie all messages are logged
+        */
+        static void setLogLevel(Type type);
+
+        /*!
+        \brief Returns the current runtime log level
+        */
+        static Type getLogLevel();
+
+        /*!
+        \brief Blocks until every message logged so far has been
+        written to stdout and the log file.
+        This is called automatically after logging an Error, and by
+        CRO_ASSERT before aborting, so that the message isn't lost if
+        the application terminates immediately afterwards.
+        */
+        static void flush();
 
-        static void updateOutString(std::size_t maxBuffer);
+    private:
+        //prints any queued lines to the Console. Called
+        //by the App on the main thread at the start of each frame
+        static void printConsoleLines();
+        friend class App;
     };
 
     namespace Detail
@@ -103,10 +145,27 @@ namespace cro
             LogBuf();
             ~LogBuf();
 
+            //queues any partially written line
+            void flushLine();
+
+            //lines of Error type are flushed when queued
+            void setType(Logger::Type type) { m_type = type; }
+
         private:
+            //text since the last new line
+            std::string m_line;
+            Logger::Type m_type = Logger::Type::Info;
 
             int overflow(int character) override;
             int sync() override;
+
+            void queueLine();
+        };
+
+        //used by the LogI/LogW/LogE macros to make both sides of the ternary void
+        struct LogVoidify final
+        {
+            void operator & (std::ostream&) {}
         };
 
         class LogStream final : public std::ostream
@@ -114,6 +173,10 @@ namespace cro
         public:
             LogStream();
 
+            void flushLine();
+
+            void setType(Logger::Type type) { m_buffer.setType(type); }
+
         private:
             LogBuf m_buffer;
         };
@@ -148,9 +211,11 @@ std::ostream& operator << (std::ostream& out, cro::Rectangle<T> r)
     return out;
 }
 
-#define LogI cro::Logger::log(cro::Logger::Type::Info)
-#define LogW cro::Logger::log(cro::Logger::Type::Warning)
-#define LogE cro::Logger::log(cro::Logger::Type::Error)
+//the stream expression binds more tightly than operator &, so when
+//a level is compiled out none of the streamed values are evaluated
+#define LogI (CRO_LOG_LEVEL > 0) ? (void)0 : cro::Detail::LogVoidify() & cro::Logger::log(cro::Logger::Type::Info)
+#define LogW (CRO_LOG_LEVEL > 1) ? (void)0 : cro::Detail::LogVoidify() & cro::Logger::log(cro::Logger::Type::Warning)
+#define LogE (CRO_LOG_LEVEL > 2) ? (void)0 : cro::Detail::LogVoidify() & cro::Logger::log(cro::Logger::Type::Error)
 
 #ifndef CRO_DEBUG_
 #define LOG(message, type)
@@ -31,11 +31,12 @@ source distribution.
 
 #include <crogine/core/Message.hpp>
 
-#include <vector>
-
-#ifdef USE_PARALLEL_PROCESSING
+#include <array>
+#include <cstddef>
+#include <memory>
 #include <mutex>
-#endif
+#include <thread>
+#include <vector>
 
 namespace cro
 {   
@@ -54,6 +55,12 @@ namespace cro
     GhostEvent,
     BadgerEvent //etc...
     };
+
+    Each thread which posts messages writes them to its own buffer, so
+    systems running in parallel can post without waiting on each other.
+    When messages are read those posted by each thread are delivered in
+    the order in which that thread posted them. Buffers grow as needed
+    so there is no limit on the number of messages posted per frame.
     */
     class CRO_EXPORT_API MessageBus final
     {
@@ -87,38 +94,13 @@ namespace cro
         template <typename T>
         T* post(Message::ID id)
         {
-            if (!m_enabled) return static_cast<T*>((void*)m_pendingBuffer.data());
-
             static_assert(sizeof(T) < 128, "MEssage size limit is 128 bytes");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Message data is over-aligned");
 
-            const auto dataSize = sizeof(T);
-            static const auto msgSize = sizeof(Message);
-            //CRO_ASSERT(dataSize < 128, "message size exceeds 128 bytes"); //limit custom data to 128 bytes
-            CRO_ASSERT(m_pendingBuffer.size() - (m_inPointer - m_pendingBuffer.data()) > (dataSize + msgSize), "buffer overflow " + std::to_string(m_pendingCount)); //make sure we have enough room in the buffer
-            //CRO_WARNING(m_pendingBuffer.size() - (m_inPointer - m_pendingBuffer.data()) < 128, "Messagebus buffer is heavily contended!");
-
-
-            //this is probably not ideal - the returned
-            //message is probably modified outside of the lock
-            //however what we're *really* protecting here
-            //is creation of new messages on the bus
-            //ALSO a lot of threads waiting on this will probably cause
-            //a stall - if we're smart each thread/group of threads
-            //would have their own mutexes and the message bus
-            //would do a collection from all of them each frame
-#ifdef USE_PARALLEL_PROCESSING
-            std::scoped_lock l(m_mutex);
-#endif
-
-            Message* msg = new (m_inPointer)Message();
-            m_inPointer += msgSize;
-            msg->id = id;
-            msg->m_dataSize = dataSize;
-            msg->m_data = new (m_inPointer)T();
-            m_inPointer += dataSize;
-
-            m_pendingCount++;
-            return static_cast<T*>(msg->m_data);
+            if (!m_enabled) return static_cast<T*>((void*)m_scratchBuffer.data());
+
+            Message* msg = allocate(id, sizeof(T));
+            return new (msg->m_data)T();
         }
 
         /*!
@@ -140,16 +122,44 @@ namespace cro
 
     private:
 
-        std::vector<char> m_currentBuffer;
-        std::vector<char> m_pendingBuffer;
-        char* m_inPointer;
-        char* m_outPointer;
+        //messages are written to fixed size pages, with more
+        //pages chained on if a frame posts more than fits in one
+        struct Page final
+        {
+            static constexpr std::size_t Size = 16384;
+            alignas(std::max_align_t) std::array<char, Size> data;
+            std::size_t used = 0;
+        };
+        using PageList = std::vector<std::unique_ptr<Page>>;
+
+        //each thread which posts a message is assigned a lane,
+        //which is removed once the thread has exited
+        struct Lane final
+        {
+            std::thread::id thread;
+            std::weak_ptr<int> owner;
+            PageList pending;
+            PageList current;
+            std::size_t pendingPage = 0;
+            std::size_t pendingCount = 0;
+
+            //only contended when the lanes are swapped
+            std::mutex mutex;
+        };
+        std::vector<std::unique_ptr<Lane>> m_lanes;
+        std::mutex m_laneMutex;
+        const std::uint64_t m_uid; //identifies this bus in each thread's lane cache
+
+        //read position in the current lists
+        std::size_t m_readLane;
+        std::size_t m_readPage;
+        std::size_t m_readOffset;
         std::size_t m_currentCount;
-        std::size_t m_pendingCount;
 
         bool m_enabled;
-#ifdef USE_PARALLEL_PROCESSING
-        std::mutex m_mutex;
-#endif
+        alignas(std::max_align_t) std::array<char, 128> m_scratchBuffer = {}; //returned when disabled
+
+        Message* allocate(Message::ID, std::size_t);
+        Lane& getLane();
     };
-}
\ No newline at end of file
+}
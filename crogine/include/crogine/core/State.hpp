@@ -36,6 +36,7 @@ source distribution.
 
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 namespace cro
 {
@@ -95,7 +96,8 @@ namespace cro
 
         /*!
         \brief Receives system messages handed down from the StateStack.
-        All states receive all messages regardless.
+        States receive all messages unless they subscribe to specific IDs.
+        \see subscribe()
         */
         virtual void handleMessage(const cro::Message&) = 0;
 
@@ -175,6 +177,24 @@ namespace cro
         cached this one.
         */
         bool isCached() const { return m_cached; }
+
+        /*!
+        \brief Subscribes the State to messages with the given ID.
+        By default handleMessage() is called for every message posted
+        on the MessageBus. Once a State has subscribed to an ID,
+        handleMessage() is only called for messages with a subscribed ID.
+        Note that States usually forward messages to their Scenes, so
+        a State which subscribes must also subscribe to any IDs which
+        its Scenes' Systems and Directors rely on.
+        */
+        void subscribe(Message::ID id);
+
+        /*!
+        \brief Unsubscribes the State from messages with the given ID.
+        A State which unsubscribes from all of its IDs receives no messages.
+        */
+        void unsubscribe(Message::ID id);
+
     private:
         StateStack& m_stack;
         Context m_context;
@@ -182,6 +202,11 @@ namespace cro
         bool m_inUse; //only relevant if this is a cached state
 
         std::vector<std::int32_t> m_cachedIDs;
+
+        std::vector<Message::ID> m_subscriptions;
+        bool m_filterMessages;
+        bool receivesMessage(Message::ID) const;
+
         friend class StateStack;
     };
 }
\ No newline at end of file
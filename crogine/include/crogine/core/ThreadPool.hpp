@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Work stealing thread pool.
+    Each worker thread owns a queue of tasks. Tasks submitted from a worker
+    are placed on that worker's own queue, tasks submitted from any other
+    thread are distributed round-robin. Idle workers steal tasks from the
+    front of other workers' queues.
+
+    Tasks should not block waiting on other tasks submitted to the same
+    pool - instead the waiting thread can call runPendingTask() to help
+    drain the queues while it waits.
+    */
+    class CRO_EXPORT_API ThreadPool final
+    {
+    public:
+        using Task = std::function<void()>;
+
+        /*!
+        \brief Constructor.
+        \param threadCount Number of worker threads to create. If this is
+        zero then one less than the number of hardware threads is used, so
+        that the calling thread may also perform work.
+        */
+        explicit ThreadPool(std::size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+        ThreadPool& operator = (ThreadPool&&) = delete;
+
+        /*!
+        \brief Queues the given task for execution on a worker thread
+        */
+        void submit(Task task);
+
+        /*!
+        \brief Attempts to remove a single pending task from any of the
+        worker queues and execute it on the calling thread.
+        \returns true if a task was executed
+        */
+        bool runPendingTask();
+
+        /*!
+        \brief Returns the number of worker threads in the pool
+        */
+        std::size_t getThreadCount() const { return m_threads.size(); }
+
+        /*!
+        \brief Returns the index of the worker thread which calls this
+        function, starting at 1, or 0 if it is called from a thread which
+        does not belong to a ThreadPool (such as the main thread).
+        */
+        static std::uint32_t getCurrentThreadIndex();
+
+    private:
+        struct Queue final
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        std::atomic<bool> m_running;
+        std::atomic<std::size_t> m_nextQueue;
+        std::atomic<std::size_t> m_pendingCount;
+
+        std::mutex m_waitMutex;
+        std::condition_variable m_condition;
+
+        bool popTask(std::size_t queueIndex, Task&);
+        bool stealTask(std::size_t queueIndex, Task&);
+
+        void threadFunc(std::size_t index);
+    };
+}
@@ -201,7 +201,9 @@ namespace cro
         /*!
         \brief Executes a given function in its own thread, while displaying
         a loading screen. Usually you pass a std::function object which loads
-        OpenGL resources.
+        OpenGL resources. Any jobs submitted to the AsyncLoader by the function
+        are completed before this returns, so assets loaded asynchronously are
+        decoded in parallel while the loading screen is displayed.
         */
         void loadResources(const std::function<void()>&);
 
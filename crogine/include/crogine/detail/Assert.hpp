@@ -48,6 +48,7 @@ do \
         std::stringstream ss; \
         ss << "Assertion failed in " << __FILE__ << ", function `" << __func__ << "`, line " << __LINE__ << ": " << message; \
         cro::Logger::log(ss.str(), cro::Logger::Type::Error, cro::Logger::Output::All); \
+        cro::Logger::flush(); \
         abort(); \
     } \
 }while (false)
@@ -31,6 +31,7 @@ source distribution.
 
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/graphics/BoundingBox.hpp>
+#include <crogine/graphics/Spatial.hpp>
 
 #include <vector>
 #include <limits>
@@ -79,6 +80,9 @@ namespace cro::Detail
         explicit BalancedTree(float unitsPerMetre);
 
         std::int32_t addToTree(Entity, Box bounds);
+
+        //as addToTree() but the bounds are already in world space
+        std::int32_t insert(Entity, Box worldBounds);
         void removeFromTree(std::int32_t);
 
         //moves a proxy with the specified treeID. If the entity
@@ -90,6 +94,16 @@ namespace cro::Detail
 
         const std::vector<TreeNode>& getNodes() const { return m_nodes; }
 
+        /*!
+        \brief Appends the entities whose fattened bounds are in front of
+        all the planes of the given frustum to the results vector.
+        Each entity is paired with true if its bounds are entirely inside
+        the frustum, in which case no further visibility tests are needed.
+        Branches of the tree which are entirely inside or outside the
+        frustum are accepted or rejected without testing their children.
+        */
+        void queryFrustum(const Frustum& frustum, std::vector<std::pair<Entity, bool>>& results) const;
+
     private:
         std::int32_t m_root;
 
@@ -80,6 +80,14 @@ namespace cro::Detail::ModelBinary
         HeaderV2() { version = 2; };
     };
 
+    //version 3 header for quantised mesh data. Version 3
+    //files use MeshHeaderV3 in place of MeshHeader. Skeleton
+    //data is unchanged from version 2
+    struct CRO_EXPORT_API HeaderV3 final : public Header
+    {
+        HeaderV3() { version = 3; };
+    };
+
 
     //appears at Header::meshOffset bytes from beginning of the file
     struct CRO_EXPORT_API MeshHeader final
@@ -114,6 +122,68 @@ namespace cro::Detail::ModelBinary
     Vertex data is interleaved in the above order
     */
 
+    //storage format of a vertex attribute in a version 3 file
+    namespace AttributeFormat
+    {
+        enum : std::uint8_t
+        {
+            Float,   //32 bit float per component
+            SNorm16, //int16 per component, mapped to -1 - 1
+            UNorm8,  //uint8 per component, mapped to 0 - 1
+            UInt8,   //uint8 per component, unnormalised
+            UInt16   //uint16 per component, unnormalised
+        };
+    }
+
+    //compression applied to a version 3 mesh payload
+    namespace Compression
+    {
+        enum : std::uint8_t
+        {
+            None,
+            LZ4 //LZ4 block format
+        };
+    }
+
+    //appears at Header::meshOffset bytes from the beginning of
+    //a version 3 file
+    struct CRO_EXPORT_API MeshHeaderV3 final
+    {
+        //number of vertices in the vertex data
+        std::uint32_t vertexCount = 0;
+        //vertex attribute flags, as MeshHeader::flags
+        std::uint16_t flags = 0;
+        //number of index arrays, as MeshHeader::indexArrayCount
+        std::uint16_t indexArrayCount = 0;
+        //AttributeFormat of each attribute in flags
+        std::uint8_t attributeFormats[Mesh::Attribute::Total] = {};
+        //size of a single index in bytes, 2 or 4
+        std::uint8_t indexSize = 4;
+        //Compression applied to the payload
+        std::uint8_t compression = Compression::None;
+        std::uint8_t reserved = 0;
+        //size of the payload once decompressed
+        std::uint32_t payloadSize = 0;
+        //size of the payload as stored in the file
+        std::uint32_t storedSize = 0;
+    };
+    static_assert(sizeof(MeshHeaderV3) == 28, "");
+    /*!
+    The payload of storedSize bytes follows the header. Once decompressed it contains:
+        std::uint32_t arraySizes[MeshHeaderV3::indexArrayCount]
+        vertexData[vertexCount] //interleaved in the same order as version 2, with each attribute in its attributeFormat
+        padding to a 4 byte boundary
+        indexArrays //contiguous arrays of indexSize indices
+
+    Component counts match version 2. Positions and UVs are always Float, normals and
+    tangents are SNorm16 and blend weights are UNorm8. Colours are UNorm8 if all values
+    are in the 0 - 1 range, else Float. Blend indices are UInt8 or UInt16 if there are
+    more than 256 joints.
+
+    Triangles are ordered for the post-transform cache, and vertices in the order in which
+    they are first referenced, so the data can be uploaded as is.
+    */
+
 
 
 
@@ -273,7 +343,13 @@ namespace cro::Detail::ModelBinary
         }
     };
 
-    CRO_EXPORT_API bool write(cro::Entity, const std::string&, bool includeSkeleton = true);
+    /*!
+    \brief Writes the Model and Skeleton data of the given entity to a binary file at the given path
+    \param includeSkeleton If false any skeleton and vertex blend data are omitted
+    \param compress If true the mesh data is optimised, quantised and compressed as a
+    version 3 file, else a version 2 file is written for compatibility with older builds
+    */
+    CRO_EXPORT_API bool write(cro::Entity, const std::string&, bool includeSkeleton = true, bool compress = true);
 
     /*!
     \brief Reads vertex positions and index arrays from a binary file at the given path
@@ -281,6 +357,7 @@ namespace cro::Detail::ModelBinary
     given vectors, and meta data returned in the cro::MeshData struct
     Note that this only loads position data from the file, as it is currently used
     for loading collision meshes into the golf game. TODO: fix this.
+    Version 3 data is unpacked to the same layout as version 2, and indices widened to 32 bit.
     */
     CRO_EXPORT_API cro::Mesh::Data read(const std::string&, std::vector<float>& dstVert, std::vector<std::vector<std::uint32_t>>& dstIdx);
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+namespace cro::Detail
+{
+    /*!
+    \brief Components which inherit this are stored in a packed (sparse set)
+    pool rather than a pool indexed directly by entity ID.
+
+    Packed pools only allocate memory for the components which actually exist,
+    storing them contiguously in fixed size pages alongside an entity index
+    indirection table. This is preferable for component types which are used
+    by a small number of entities in a large scene, or which are frequently
+    added and removed, as iterating them with Scene::forEachComponent() is a
+    linear walk over only the live components.
+
+    Packed pages are never reallocated so references remain valid when the
+    pool grows. However when a component is removed the last component in the
+    pool is moved into its place, so references which need to persist over
+    multiple frames should be retrieved via their Entity handle.
+
+    Unlike NonResizeable this is an empty type, so it adds no overhead to
+    the component which inherits it.
+    */
+    struct PackedStorage {};
+}
@@ -0,0 +1,86 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/*
+Keys used to sort the ModelRenderer's draw lists. Opaque draws are
+sorted by shader, then material, then mesh, then front to back. All
+transparent draws are sorted after opaque ones, back to front.
+*/
+
+namespace cro::Detail::SortKey
+{
+    //the bit pattern of a positive float increases with its value,
+    //so the top bits can be used as a depth key without having to
+    //know the range of the camera's depth buffer
+    inline std::uint64_t quantiseDepth(float distance)
+    {
+        distance = std::max(0.f, distance);
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &distance, sizeof(bits));
+        return (bits >> 7) & 0xFFFFFF;
+    }
+
+    //opaque draws only use depth to reduce overdraw within a run of
+    //identical state, so the lower precision leaves room for the mesh
+    inline std::uint64_t quantiseOpaqueDepth(float distance)
+    {
+        return quantiseDepth(distance) >> 8;
+    }
+
+    //draw lists are stored per pass so the pass doesn't need to be part
+    //of the key. Shader IDs are 15 bits and materials 16. These are
+    //truncated GL handles, so a collision only costs a state change.
+    //Opaque keys use 16 bits for the mesh, so that runs of the same mesh
+    //aren't split by other buffers and can be instanced. Transparent keys
+    //are sorted by depth first, so 8 bits is enough to order equal depths.
+    static constexpr std::uint64_t TransparentBit = (1ull << 63);
+
+    inline std::uint64_t opaque(std::uint32_t shader, std::uint32_t material, std::uint32_t mesh, float distance)
+    {
+        return (static_cast<std::uint64_t>(shader & 0x7FFF) << 48)
+            | (static_cast<std::uint64_t>(material & 0xFFFF) << 32)
+            | (static_cast<std::uint64_t>(mesh & 0xFFFF) << 16)
+            | quantiseOpaqueDepth(distance);
+    }
+
+    inline std::uint64_t transparent(std::uint32_t shader, std::uint32_t material, std::uint32_t mesh, float distance)
+    {
+        return TransparentBit
+            | ((~quantiseDepth(distance) & 0xFFFFFF) << 39)
+            | (static_cast<std::uint64_t>(shader & 0x7FFF) << 24)
+            | (static_cast<std::uint64_t>(material & 0xFFFF) << 8)
+            | static_cast<std::uint64_t>(mesh & 0xFF);
+    }
+}
@@ -32,8 +32,15 @@ source distribution.
 #include <crogine/detail/Detail.hpp>
 #include <crogine/detail/Assert.hpp>
 #include <crogine/detail/NoResize.hpp>
+#include <crogine/detail/PackedStorage.hpp>
 
 #include <vector>
+#include <memory>
+#include <new>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
 
 namespace cro
 {
@@ -53,6 +60,7 @@ namespace cro
         Note: components which inherit NoResize or have no copy assignment
         (eg move-only types such as Model or AudioEmitter) reserve MinFreeID
         slots in a pool, to prevent resizing and invalidating components.
+        Components which inherit PackedStorage use PackedComponentPool instead.
         */
         template <class T>
         class ComponentPool final : public Pool
@@ -87,6 +95,20 @@ namespace cro
             }
             void clear() override { m_pool.clear(); }
 
+            /*!
+            \brief Assigns the given component to the entity at the given index,
+            resizing the pool if necessary
+            */
+            T& insert(std::size_t idx, T&& component)
+            {
+                if (idx >= m_pool.size())
+                {
+                    resize(std::min(static_cast<std::size_t>(MinFreeIDs), idx + 128));
+                }
+                m_pool[idx] = std::move(component);
+                return m_pool[idx];
+            }
+
             T& at(std::size_t idx) { return m_pool.at(idx); }
             const T& at(std::size_t idx) const { return m_pool.at(idx); }
 
@@ -98,5 +120,199 @@ namespace cro
         private:
             std::vector<T> m_pool;
         };
+
+        /*!
+        \brief Sparse set storage for components which inherit PackedStorage.
+
+        Components are stored contiguously in the order in which they were
+        added, in fixed size pages which are never reallocated. A sparse table
+        maps entity indices to their position in the packed array, so lookups
+        remain O(1), and removal swaps the last component into the vacated slot.
+        */
+        template <class T>
+        class PackedComponentPool final : public Pool
+        {
+        public:
+            static constexpr std::size_t PageSize = 256;
+            static constexpr std::uint32_t NullIndex = std::numeric_limits<std::uint32_t>::max();
+
+            explicit PackedComponentPool(std::size_t size = 128)
+            {
+                m_sparse.reserve(size);
+            }
+
+            ~PackedComponentPool() { clear(); }
+
+            PackedComponentPool(const PackedComponentPool&) = delete;
+            PackedComponentPool(PackedComponentPool&&) = delete;
+            PackedComponentPool& operator = (const PackedComponentPool&) = delete;
+            PackedComponentPool& operator = (PackedComponentPool&&) = delete;
+
+            /*!
+            \brief Returns the number of components currently in the pool
+            */
+            std::size_t size() const { return m_size; }
+            bool empty() const { return m_size == 0; }
+
+            /*!
+            \brief Returns true if the entity at the given index has a component in this pool
+            */
+            bool contains(std::size_t idx) const
+            {
+                return idx < m_sparse.size() && m_sparse[idx] != NullIndex;
+            }
+
+            /*!
+            \brief Adds or replaces the component belonging to the entity at the given index
+            */
+            T& insert(std::size_t idx, T&& value)
+            {
+                if (contains(idx))
+                {
+                    auto& c = component(m_sparse[idx]);
+                    c = std::move(value);
+                    return c;
+                }
+
+                if (idx >= m_sparse.size())
+                {
+                    m_sparse.resize(idx + 1, NullIndex);
+                }
+
+                if (m_size == m_pages.size() * PageSize)
+                {
+                    m_pages.emplace_back(std::make_unique<Storage[]>(PageSize));
+                }
+
+                const auto packedIdx = static_cast<std::uint32_t>(m_size++);
+                m_sparse[idx] = packedIdx;
+                m_entities.push_back(static_cast<std::uint32_t>(idx));
+
+                return *new (slot(packedIdx)) T(std::move(value));
+            }
+
+            T& at(std::size_t idx)
+            {
+                CRO_ASSERT(contains(idx), "Component does not exist");
+                return component(m_sparse[idx]);
+            }
+
+            const T& at(std::size_t idx) const
+            {
+                CRO_ASSERT(contains(idx), "Component does not exist");
+                return component(m_sparse[idx]);
+            }
+
+            T& operator [] (std::size_t idx) { return at(idx); }
+            const T& operator [] (std::size_t idx) const { return at(idx); }
+
+            /*!
+            \brief Returns the component at the given position in the packed array
+            */
+            T& component(std::size_t packedIdx)
+            {
+                CRO_ASSERT(packedIdx < m_size, "Index out of range");
+                return *std::launder(reinterpret_cast<T*>(slot(packedIdx)));
+            }
+
+            const T& component(std::size_t packedIdx) const
+            {
+                CRO_ASSERT(packedIdx < m_size, "Index out of range");
+                return *std::launder(reinterpret_cast<const T*>(slot(packedIdx)));
+            }
+
+            /*!
+            \brief Returns the index of the entity which owns the component
+            at the given position in the packed array
+            */
+            std::uint32_t entityIndex(std::size_t packedIdx) const
+            {
+                CRO_ASSERT(packedIdx < m_size, "Index out of range");
+                return m_entities[packedIdx];
+            }
+
+            /*!
+            \brief Removes the component belonging to the entity at the given index, if it exists
+            */
+            void reset(std::size_t idx) override
+            {
+                if (contains(idx))
+                {
+                    const auto packedIdx = m_sparse[idx];
+                    const auto lastIdx = static_cast<std::uint32_t>(m_size - 1);
+
+                    //the removed component is destroyed before the last is moved
+                    //into its place, rather than being assigned over, so that types
+                    //which refer to each other (eg a Transform and its children)
+                    //are detached first
+                    component(packedIdx).~T();
+                    if (packedIdx != lastIdx)
+                    {
+                        new (slot(packedIdx)) T(std::move(component(lastIdx)));
+                        component(lastIdx).~T();
+
+                        const auto lastEntity = m_entities[lastIdx];
+                        m_entities[packedIdx] = lastEntity;
+                        m_sparse[lastEntity] = packedIdx;
+                    }
+
+                    m_entities.pop_back();
+                    m_sparse[idx] = NullIndex;
+                    m_size--;
+                }
+            }
+
+            void clear() override
+            {
+                for (auto i = 0u; i < m_size; ++i)
+                {
+                    component(i).~T();
+                }
+                m_size = 0;
+                m_entities.clear();
+                m_sparse.clear();
+                m_pages.clear();
+            }
+
+            /*!
+            \brief Calls the given function on each component in the pool in packed order.
+            \param func A callable with the signature void(std::uint32_t entityIndex, T&)
+            */
+            template <typename Func>
+            void forEach(Func&& func)
+            {
+                for (auto p = 0u; p < m_pages.size(); ++p)
+                {
+                    const auto first = p * PageSize;
+                    const auto count = std::min(PageSize, m_size - first);
+                    auto* page = std::launder(reinterpret_cast<T*>(m_pages[p].get()));
+                    for (auto i = 0u; i < count; ++i)
+                    {
+                        func(m_entities[first + i], page[i]);
+                    }
+
+                    if (count < PageSize)
+                    {
+                        break;
+                    }
+                }
+            }
+
+        private:
+            using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+            std::vector<std::unique_ptr<Storage[]>> m_pages;
+            std::vector<std::uint32_t> m_sparse; //indexed by entity ID
+            std::vector<std::uint32_t> m_entities; //entity ID of each packed component
+            std::size_t m_size = 0;
+
+            Storage* slot(std::size_t packedIdx) { return &m_pages[packedIdx / PageSize][packedIdx % PageSize]; }
+            const Storage* slot(std::size_t packedIdx) const { return &m_pages[packedIdx / PageSize][packedIdx % PageSize]; }
+        };
+
+        /*!
+        \brief Selects the pool type used to store a given component type
+        */
+        template <class T>
+        using PoolType = std::conditional_t<std::is_base_of_v<PackedStorage, T>, PackedComponentPool<T>, ComponentPool<T>>;
     }
 }
\ No newline at end of file
@@ -33,6 +33,8 @@ source distribution.
 #include <crogine/detail/Types.hpp>
 #include <crogine/core/MessageBus.hpp>
 
+#include <vector>
+
 namespace cro
 {
     class Message;
@@ -65,9 +67,24 @@ namespace cro
     protected:
         /*!
         \brief Implement to handle system messages
+        \see subscribe()
         */
         virtual void handleMessage(const Message&) = 0;
 
+        /*!
+        \brief Subscribes the Director to messages with the given ID.
+        By default handleMessage() is called for every message. Once
+        a Director has subscribed to an ID handleMessage() is only
+        called for messages with a subscribed ID.
+        */
+        void subscribe(Message::ID id);
+
+        /*!
+        \brief Unsubscribes the Director from messages with the given ID.
+        A Director which unsubscribes from all of its IDs receives no messages.
+        */
+        void unsubscribe(Message::ID id);
+
         /*!
         \brief Implement to handle Events
         */
@@ -102,6 +119,10 @@ namespace cro
         CommandSystem* m_commandSystem;
         Scene* m_scene;
 
+        std::vector<Message::ID> m_subscriptions;
+        bool m_filterMessages;
+        bool receivesMessage(Message::ID) const;
+
         friend class Scene;
     };
 
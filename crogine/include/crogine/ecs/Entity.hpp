@@ -248,6 +248,16 @@ namespace cro
         */
         const ComponentMask& getComponentMask(Entity) const;
 
+        /*!
+        \brief Calls the given function for every component of type T.
+        If T inherits Detail::PackedStorage this is a linear walk over
+        only the existing components, else every entity is tested for
+        the existence of the component.
+        \param func A callable with the signature void(Entity, T&)
+        */
+        template <typename T, typename Func>
+        void forEachComponent(Func&& func);
+
         /*!
         \brief Returns true if this manager owns the given entity
         */
@@ -291,7 +301,7 @@ namespace cro
         ComponentManager& m_componentManager;
 
         template <typename T>
-        Detail::ComponentPool<T>& getPool();
+        Detail::PoolType<T>& getPool();
     };
 
 #include "Entity.inl"
@@ -34,12 +34,7 @@ void EntityManager::addComponent(Entity entity, T component)
     auto entID = entity.getIndex();
 
     auto& pool = getPool<T>();
-    if (entID >= pool.size())
-    {
-        pool.resize(std::min(static_cast<std::uint32_t>(Detail::MinFreeIDs), entID + 128));
-    }
-
-    pool[entID] = std::move(component);
+    pool.insert(entID, std::move(component));
     m_componentMasks[entID].set(componentID);
 }
 
@@ -83,21 +78,44 @@ T& EntityManager::getComponent(Entity entity)
 
 
     CRO_ASSERT(componentID < m_componentPools.size(), "Component index out of range");
-    auto* pool = (dynamic_cast<Detail::ComponentPool<T>*>(m_componentPools[componentID].get()));
-
-    CRO_ASSERT(entityID < pool->size(), "Entity index out of range");
+    //the component ID is unique to T so this is always the correct pool type
+    auto* pool = static_cast<Detail::PoolType<T>*>(m_componentPools[componentID].get());
     return pool->at(entityID);
 }
 
+template <typename T, typename Func>
+void EntityManager::forEachComponent(Func&& func)
+{
+    if constexpr (std::is_base_of_v<Detail::PackedStorage, T>)
+    {
+        getPool<T>().forEach([&](std::uint32_t entityIndex, T& component)
+            {
+                func(getEntity(entityIndex), component);
+            });
+    }
+    else
+    {
+        const auto componentID = m_componentManager.getID<T>();
+        auto& pool = getPool<T>();
+        for (auto i = 0u; i < m_generations.size(); ++i)
+        {
+            if (m_componentMasks[i].test(componentID))
+            {
+                func(getEntity(i), pool[i]);
+            }
+        }
+    }
+}
+
 template <typename T>
-Detail::ComponentPool<T>& EntityManager::getPool()
+Detail::PoolType<T>& EntityManager::getPool()
 {
     const auto componentID = m_componentManager.getID<T>();
 
     if (!m_componentPools[componentID])
     {
-        m_componentPools[componentID] = std::make_unique<Detail::ComponentPool<T>>(m_initialPoolSize);
+        m_componentPools[componentID] = std::make_unique<Detail::PoolType<T>>(m_initialPoolSize);
     }
 
-    return *(dynamic_cast<Detail::ComponentPool<T>*>(m_componentPools[componentID].get()));
+    return *(static_cast<Detail::PoolType<T>*>(m_componentPools[componentID].get()));
 }
\ No newline at end of file
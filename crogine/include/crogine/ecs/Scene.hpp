@@ -30,19 +30,22 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
-#include <crogine/core/App.hpp>
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/ecs/System.hpp>
 #include <crogine/ecs/systems/CommandSystem.hpp>
 #include <crogine/ecs/Director.hpp>
+#include <crogine/ecs/Component.hpp>
+
+#ifndef CRO_HEADLESS
+#include <crogine/core/App.hpp>
 #include <crogine/ecs/Sunlight.hpp>
 #include <crogine/ecs/Renderable.hpp>
-#include <crogine/ecs/Component.hpp>
 #include <crogine/graphics/Shader.hpp>
 #include <crogine/graphics/MaterialData.hpp>
 #include <crogine/graphics/RenderTexture.hpp>
 #include <crogine/graphics/CubemapTexture.hpp>
 #include <crogine/graphics/postprocess/PostProcess.hpp>
+#endif
 
 #include <crogine/detail/glm/mat4x4.hpp>
 #include <crogine/detail/glm/gtx/quaternion.hpp>
@@ -64,6 +67,10 @@ namespace cro
     an ECS - therefore every state which wishes to draw something requires at least a scene,
     right down to menus. All systems should be created before attempting to create any
     entities else existing entities will not be processed by new systems.
+
+    When crogine is built with CRO_HEADLESS defined, such as the crogine-headless
+    library used by dedicated servers, only the ECS parts of the Scene are available.
+    Cameras, lighting, skyboxes, post processes and rendering are all removed.
     */
 
     class CRO_EXPORT_API Scene final
@@ -122,6 +129,17 @@ namespace cro
         */
         std::size_t getEntityCount() const { return m_entityManager.getEntityCount(); }
 
+        /*!
+        \brief Calls the given function for every component of type T in the Scene.
+        Components which inherit Detail::PackedStorage are visited in a single
+        linear walk over their packed pool, making this the preferred way to
+        process sparsely used component types. Note that this includes entities
+        which were created this frame but have not yet been added to any systems.
+        \param func A callable with the signature void(cro::Entity, T&)
+        */
+        template <typename T, typename Func>
+        void forEachComponent(Func&& func) { m_entityManager.forEachComponent<T>(std::forward<Func>(func)); }
+
 
         /*!
         \brief Creates a new system of the given type.
@@ -173,6 +191,7 @@ namespace cro
         T* getDirector();
 
 
+#ifndef CRO_HEADLESS
         /*!
         \brief Adds a post process effect to the scene.
         Any post processes added to the scene are performed on the *entire* output.
@@ -360,6 +379,7 @@ namespace cro
         \brief Returns the entity containing the active AudioListener component
         */
         Entity getActiveListener() const;
+#endif
 
 
         /*!
@@ -374,6 +394,7 @@ namespace cro
         void forwardMessage(const Message&);
 
 
+#ifndef CRO_HEADLESS
         /*!
         \brief Draws any renderable systems in this scene, in the order in which they were added
         using the currently active camera, to the current active RenderTarget
@@ -410,6 +431,7 @@ namespace cro
         \see Camera::drawList
         */
         void updateDrawLists(Entity);
+#endif
 
 
         /*!
@@ -419,10 +441,12 @@ namespace cro
         T* postMessage(Message::ID id);
 
 
+#ifndef CRO_HEADLESS
         /*
         \brief Sets the orientation of the skybox to the given quaternion
         */
         void setSkyboxOrientation(glm::quat);
+#endif
 
 
         /*!
@@ -441,11 +465,6 @@ namespace cro
         MessageBus& m_messageBus;
         std::size_t m_uid;
 
-        Entity m_defaultCamera;
-        Entity m_activeCamera;
-        Entity m_activeListener;
-        Entity m_sunlight;
-
         std::vector<Entity> m_pendingEntities;
         std::vector<Entity> m_destroyedEntities;
         std::vector<Entity> m_destroyedBuffer;
@@ -456,6 +475,12 @@ namespace cro
 
         std::vector<std::unique_ptr<Director>> m_directors;
 
+#ifndef CRO_HEADLESS
+        Entity m_defaultCamera;
+        Entity m_activeCamera;
+        Entity m_activeListener;
+        Entity m_sunlight;
+
         std::vector<Renderable*> m_renderables;
 
         std::array<glm::mat4, 8u> m_projectionMaps;
@@ -520,6 +545,7 @@ namespace cro
         void destroySkybox();
 
         void resizeBuffers(glm::uvec2);
+#endif
     };
 
 #include "Scene.inl"
@@ -32,10 +32,12 @@ T* Scene::addSystem(Args&&... args)
 {
     static_assert(std::is_base_of<System, T>::value, "Must be a system type");
     auto& system = m_systemManager.addSystem<T>(std::forward<Args>(args)...);
+#ifndef CRO_HEADLESS
     if constexpr (std::is_base_of<Renderable, T>::value)
     {
         m_renderables.push_back(static_cast<Renderable*>(&system));
     }
+#endif
     return &system;
 }
 
@@ -92,6 +94,7 @@ T* Scene::getDirector()
     return static_cast<T*>(result->get());
 }
 
+#ifndef CRO_HEADLESS
 template <typename T, typename... Args>
 T& Scene::addPostProcess(Args&&... args)
 {
@@ -127,6 +130,7 @@ T& Scene::addPostProcess(Args&&... args)
 
     return *dynamic_cast<T*>(m_postEffects.back().get());
 }
+#endif
 
 template <typename T>
 T* Scene::postMessage(cro::Message::ID id)
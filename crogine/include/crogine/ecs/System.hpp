@@ -38,11 +38,19 @@ source distribution.
 
 #include <vector>
 #include <typeindex>
+#include <type_traits>
+#include <unordered_map>
 
 namespace cro
 {
     class Time;
     class Scene;
+    class SystemManager;
+
+    namespace Detail
+    {
+        class SystemScheduler;
+    }
 
     using UniqueType = std::type_index;
 
@@ -58,6 +66,24 @@ namespace cro
 
         using Ptr = std::unique_ptr<System>;
 
+        /*!
+        \brief Describes how the SystemManager may schedule the process() function
+        */
+        enum class ExecutionPolicy
+        {
+            Serial, //!< Default. Runs on the main thread with no other systems running at the same time
+            Concurrent, //!< May run on a worker thread alongside other systems whose component access does not conflict
+            MainThread //!< Runs on the main thread but may overlap Concurrent systems, eg for systems which make OpenGL calls
+        };
+
+        /*!
+        \brief Declares how a system accesses a component type
+        */
+        enum class ComponentAccess
+        {
+            Read, ReadWrite
+        };
+
         /*!
         \brief Constructor.
         Pass in a type_index to the concrete implementation to generate
@@ -84,10 +110,19 @@ namespace cro
         void addEntity(Entity);
 
         /*!
-        \brief Removes an entity from the list to process
+        \brief Removes an entity from the list to process.
+        By default this is an O(1) operation which moves the last entity
+        in the list into the removed entity's place. Systems which rely
+        on entities being processed in the order in which they were added
+        should call setPreserveOrder() on construction.
         */
         void removeEntity(Entity);
 
+        /*!
+        \brief Returns true if the given entity is currently in this system's entity list
+        */
+        bool hasEntity(Entity) const;
+
         /*!
         \brief Returns the component mask used to mask entities with corresponding
         components for this system to process
@@ -96,6 +131,7 @@ namespace cro
 
         /*!
         \brief Used to process any incoming system messages
+        \see subscribe()
         */
         virtual void handleMessage(const cro::Message&);
 
@@ -110,14 +146,77 @@ namespace cro
         */
         bool isActive() const { return m_active; }
 
+        /*!
+        \brief Returns the execution policy of this system
+        \see setExecutionPolicy()
+        */
+        ExecutionPolicy getExecutionPolicy() const { return m_executionPolicy; }
+
+        /*!
+        \brief Returns the mask of component types this system has declared it reads
+        */
+        const ComponentMask& getReadMask() const { return m_readMask; }
+
+        /*!
+        \brief Returns the mask of component types this system has declared it writes
+        */
+        const ComponentMask& getWriteMask() const { return m_writeMask; }
+
     protected:
 
         /*!
         \brief Adds a component type to the list of components required by the
         system for it to be interested in a particular entity.
+        \param access Declares whether the system only reads this component or
+        also modifies it. This is only used when scheduling systems whose
+        ExecutionPolicy is not Serial.
         */
         template <typename T>
-        void requireComponent();
+        void requireComponent(ComponentAccess access = ComponentAccess::ReadWrite);
+
+        /*!
+        \brief Declares that the system accesses a component type which is not
+        required, for example the Transform of a parent or attached entity.
+        Systems which are not Serial must declare every component type which
+        they touch so that they can be safely scheduled with other systems.
+        */
+        template <typename T>
+        void accessComponent(ComponentAccess access);
+
+        /*!
+        \brief Sets the execution policy of the system.
+        By default systems are Serial, ie they are run on the main thread in
+        the order in which they were added, and nothing else runs alongside them.
+        Systems which are Concurrent or MainThread may be run at the same time
+        as other non-Serial systems whose declared component access doesn't
+        conflict with their own. These systems must not create or destroy
+        entities, nor access components which they have not declared.
+        \see requireComponent() accessComponent()
+        */
+        void setExecutionPolicy(ExecutionPolicy policy) { m_executionPolicy = policy; }
+
+        /*!
+        \brief Set this to true to preserve the order of the entity list
+        when an entity is removed, at the cost of an O(n) removal.
+        Defaults to false, in which case the last entity in the list is
+        moved into the place of the removed entity.
+        */
+        void setPreserveOrder(bool preserve) { m_preserveOrder = preserve; }
+
+        /*!
+        \brief Subscribes the system to messages with the given ID.
+        By default handleMessage() is called for every message posted
+        on the MessageBus (or for none if the system doesn't override
+        handleMessage()). Once a system has subscribed to an ID,
+        handleMessage() is only called for messages with a subscribed ID.
+        */
+        void subscribe(Message::ID id);
+
+        /*!
+        \brief Unsubscribes the system from messages with the given ID.
+        A system which unsubscribes from all of its IDs receives no messages.
+        */
+        void unsubscribe(Message::ID id);
 
         /*!
         \brief Optional callback performed when an entity is added
@@ -157,26 +256,62 @@ namespace cro
 
         ComponentMask m_componentMask;
         std::vector<Entity> m_entities;
+        mutable std::vector<std::uint32_t> m_entitySlots; //indexed by entity ID, position in m_entities or NullSlot
+        bool m_preserveOrder;
+
+        std::uint32_t findSlot(Entity) const;
+        void rebuildSlots() const;
 
         Scene* m_scene;
+        SystemManager* m_systemManager;
         std::size_t m_updateIndex; //ensures when the system is active that it is updated in the order in which is was added to the manager
 
         bool m_active; //used by system manager to check if it has been added to the active list
 
         friend class SystemManager;
 
+        ExecutionPolicy m_executionPolicy;
+        ComponentMask m_readMask;
+        ComponentMask m_writeMask;
+
         //list of types populated by requireComponent then processed by SystemManager
         //when the system is created
-        std::vector<std::type_index> m_pendingTypes;
+        struct PendingType final
+        {
+            std::type_index type;
+            ComponentAccess access = ComponentAccess::ReadWrite;
+            bool required = true;
+            PendingType(std::type_index t, ComponentAccess a, bool r)
+                : type(t), access(a), required(r) {}
+        };
+        std::vector<PendingType> m_pendingTypes;
         void processTypes(ComponentManager&);
+
+        //if m_filterMessages is true only these IDs are passed to handleMessage()
+        std::vector<Message::ID> m_subscriptions;
+        bool m_filterMessages;
+        bool receivesMessage(Message::ID) const;
     };
 
+    namespace Detail
+    {
+        //true if T does not override System::handleMessage(), in which case
+        //the SystemManager needn't forward it any messages. If T's override
+        //is inaccessible or overloaded this is false, which is safe.
+        template <typename T, typename = void>
+        struct IgnoresMessages : std::false_type {};
+
+        template <typename T>
+        struct IgnoresMessages<T, std::enable_if_t<std::is_same_v<decltype(&T::handleMessage), void(System::*)(const Message&)>>>
+            : std::true_type {};
+    }
+
     class CRO_EXPORT_API SystemManager final : public cro::GuiClient
     {
     public:
         SystemManager(Scene&, ComponentManager&, std::uint32_t infoFlags);
 
-        ~SystemManager() = default;
+        ~SystemManager();
         SystemManager(const SystemManager&) = delete;
         SystemManager(const SystemManager&&) = delete;
         SystemManager& operator = (const SystemManager&) = delete;
@@ -233,12 +368,16 @@ namespace cro
         void removeFromSystems(Entity);
 
         /*!
-        \brief Forwards messages to all systems
+        \brief Forwards messages to all systems which receive them
+        \see System::subscribe()
         */
         void forwardMessage(const cro::Message&);
 
         /*!
-        \brief Runs a simulation step by calling process() on each system
+        \brief Runs a simulation step by calling process() on each system.
+        If parallel processing is enabled and more than one active system
+        has an ExecutionPolicy other than Serial then systems which don't
+        conflict with each other are run in parallel.
         */
         void process(float);
     private:
@@ -255,11 +394,21 @@ namespace cro
         {
             const System* system = nullptr;
             float elapsed = 0.f;
-            SystemSample(const System* s, float e)
-                : system(s), elapsed(e) {}
+            std::uint32_t thread = 0;
+            SystemSample(const System* s, float e, std::uint32_t t = 0)
+                : system(s), elapsed(e), thread(t) {}
         };
         std::vector<SystemSample> m_systemSamples;
 
+        std::unique_ptr<Detail::SystemScheduler> m_scheduler;
+
+        //systems which receive each message ID, in the order in which they
+        //were added. Rebuilt as messages arrive once the list is invalidated
+        std::unordered_map<Message::ID, std::vector<System*>> m_messageRoutes;
+        bool m_messageRoutesDirty;
+        void invalidateMessageRoutes() { m_messageRoutesDirty = true; }
+        friend class System;
+
         template <typename T>
         void removeFromActive();
     };
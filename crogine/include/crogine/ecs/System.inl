@@ -28,9 +28,15 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 template <typename T>
-void System::requireComponent()
+void System::requireComponent(ComponentAccess access)
 {
-	m_pendingTypes.push_back(typeid(T));
+	m_pendingTypes.emplace_back(typeid(T), access, true);
+}
+
+template <typename T>
+void System::accessComponent(ComponentAccess access)
+{
+	m_pendingTypes.emplace_back(typeid(T), access, false);
 }
 
 template <typename T>
@@ -48,6 +48,13 @@ T& SystemManager::addSystem(Args&&... args)
     system->setScene(m_scene);
     system->processTypes(m_componentManager);
 
+    system->m_systemManager = this;
+    if constexpr (Detail::IgnoresMessages<T>::value)
+    {
+        system->m_filterMessages = true;
+    }
+    invalidateMessageRoutes();
+
     system->m_updateIndex = m_activeSystems.size();
     m_activeSystems.push_back(system.get());
     system->m_active = true;
@@ -66,6 +73,7 @@ void SystemManager::removeSystem()
     }), std::end(m_systems));
 
     removeFromActive<T>();
+    invalidateMessageRoutes();
 }
 
 template <typename T>
@@ -30,7 +30,7 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
-#include <crogine/detail/NoResize.hpp>
+#include <crogine/detail/PackedStorage.hpp>
 
 #include <functional>
 #include <any>
@@ -42,9 +42,12 @@ namespace cro
     using CallbackFunction = std::function<void(Entity, float)>;
     /*!
     \brief Allows attaching a callback function to an entity.
+    Callbacks are kept in packed storage, which the CallbackSystem
+    walks linearly, so references to a Callback should not be held
+    across frames.
     \see CallbackSystem
     */
-    struct CRO_EXPORT_API Callback final : public Detail::NonResizeable
+    struct CRO_EXPORT_API Callback final : public Detail::PackedStorage
     {
         bool active = false; //!< disabling callbacks when not in use can avoid unnecessary cache misses looking up callback functions
         CallbackFunction function;
@@ -32,9 +32,15 @@ source distribution.
 #include <crogine/Config.hpp>
 
 #include <cstdint>
+#include <memory>
 
 namespace cro
 {
+    namespace Detail
+    {
+        struct ChangedTargets;
+    }
+
     /*!
     \brief Attaches a command ID bitmask to an Entity.
     ID should be a bit mask of flags representing target IDs.
@@ -49,10 +55,51 @@ namespace cro
 
     The command target system will then apply any given commands to targets
     whose flags match one or more of the flags belonging to the command.
+    Flags added to the ID by a command are matched by any commands
+    executed after it in the same frame.
     \see CommandSystem
     */
     struct CRO_EXPORT_API CommandTarget final
     {
-        std::uint32_t ID = 0;
+        /*!
+        \brief The bit mask of a CommandTarget, which can be used as a std::uint32_t.
+        Changes to the value are reported to the CommandSystem, so that it
+        only has to sort the entities whose IDs have changed.
+        */
+        class CRO_EXPORT_API TargetID final
+        {
+        public:
+            TargetID() = default;
+            TargetID(const TargetID&) = default;
+
+            //only the value is assigned, not the entity to which this belongs
+            TargetID& operator = (const TargetID& other) { return *this = other.m_id; }
+
+            TargetID& operator = (std::uint32_t id)
+            {
+                if (id != m_id)
+                {
+                    setID(id);
+                }
+                return *this;
+            }
+
+            TargetID& operator |= (std::uint32_t id) { return *this = (m_id | id); }
+            TargetID& operator &= (std::uint32_t id) { return *this = (m_id & id); }
+            TargetID& operator ^= (std::uint32_t id) { return *this = (m_id ^ id); }
+
+            operator std::uint32_t() const { return m_id; }
+
+        private:
+            std::uint32_t m_id = 0;
+
+            //set by the CommandSystem while the entity belongs to it
+            std::shared_ptr<Detail::ChangedTargets> m_changedTargets;
+            std::uint32_t m_entityIndex = 0;
+
+            void setID(std::uint32_t);
+
+            friend class CommandSystem;
+        }ID;
     };
-}
\ No newline at end of file
+}
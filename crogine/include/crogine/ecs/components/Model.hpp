@@ -310,6 +310,7 @@ namespace cro
         //used with BalancedTree if active in frustum culling
         std::int32_t m_treeID = -1;
         glm::vec3 m_lastWorldPosition = glm::vec3(0.f);
+        std::uint32_t m_lastWorldUpdate = 0; //< Transform::getWorldUpdateCount() when the tree was last updated
 
         friend class ModelRenderer;
         friend class ShadowMapRenderer;
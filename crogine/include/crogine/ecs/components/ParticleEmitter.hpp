@@ -35,10 +35,12 @@ source distribution.
 #include <crogine/graphics/Colour.hpp>
 #include <crogine/core/Clock.hpp>
 #include <crogine/graphics/Spatial.hpp>
+#include <crogine/util/Random.hpp>
 
 #include <crogine/detail/glm/vec3.hpp>
 
 #include <array>
+#include <vector>
 
 namespace cro
 {
@@ -64,6 +66,48 @@ namespace cro
         float acceleration = 1.f;
     };
 
+    namespace Detail
+    {
+        /*!
+        \brief Particle data stored as a structure of arrays
+        so that particles can be updated in batches.
+        Used internally by the ParticleEmitter and ParticleSystem.
+        */
+        struct CRO_EXPORT_API ParticleData final
+        {
+            std::vector<float> positionX;
+            std::vector<float> positionY;
+            std::vector<float> positionZ;
+            std::vector<float> velocityX;
+            std::vector<float> velocityY;
+            std::vector<float> velocityZ;
+            std::vector<float> gravityX;
+            std::vector<float> gravityY;
+            std::vector<float> gravityZ;
+            std::vector<float> red;
+            std::vector<float> green;
+            std::vector<float> blue;
+            std::vector<float> alpha;
+            std::vector<float> lifetime;
+            std::vector<float> maxLifetime;
+            std::vector<float> frameTime;
+            std::vector<float> rotation;
+            std::vector<float> scale;
+            std::vector<float> acceleration;
+            std::vector<std::uint32_t> frameID;
+            std::vector<std::uint32_t> loopCount;
+
+            void resize(std::size_t count);
+            std::size_t size() const { return lifetime.size(); }
+
+            //writes the given particle to the arrays at the given index
+            void set(std::size_t idx, const Particle&);
+
+            //overwrites the particle at dst with the particle at src
+            void move(std::size_t src, std::size_t dst);
+        };
+    }
+
     /*!
     \brief Encapsulates settings used by an emitter to
     initialise particles it creates
@@ -142,6 +186,11 @@ namespace cro
         */
         const bool stopped() const { return (!m_running && m_nextFreeParticle == 0); }
 
+        /*!
+        \brief Returns the number of particles currently alive
+        */
+        std::size_t getParticleCount() const { return m_nextFreeParticle; }
+
         /*!
         \brief Returns the current bounding sphere of the emitter
         */
@@ -165,13 +214,22 @@ namespace cro
         EmitterSettings settings;
 
     private:
+        //location of this frame's vertex data in the ParticleSystem's streaming buffer
         std::uint32_t m_vbo;
-        std::uint32_t m_vao; //< used on desktop
+        std::size_t m_firstVertex;
         
         //std::array<Particle, MaxParticles> m_particles;
-        std::vector<Particle> m_particles;
+        Detail::ParticleData m_particles;
         std::size_t m_nextFreeParticle;
 
+        //vertex data is written here by the update so that
+        //the main thread only needs to upload it to the VBO
+        std::vector<float> m_vertexData;
+
+        //each emitter has its own generator so that they
+        //can be safely updated in parallel
+        Util::Random::CounterEngine m_random;
+
         bool m_running;
         float m_emissionTime;
         Sphere m_bounds;
@@ -86,6 +86,29 @@ namespace cro
         glm::mat4 worldMatrix = glm::mat4(1.f);
     };
 
+    /*!
+    \brief Joint transforms stored as separate arrays of translation,
+    rotation and scale.
+    Used by the SkeletalAnimator when interpolating and blending
+    animations. Each rotation component is stored in its own array
+    so that rotations can be processed in batches.
+    */
+    struct CRO_EXPORT_API JointPose final
+    {
+        std::vector<glm::vec3> translation;
+        std::vector<glm::vec3> scale;
+        std::vector<float> rotationX;
+        std::vector<float> rotationY;
+        std::vector<float> rotationZ;
+        std::vector<float> rotationW;
+
+        void resize(std::size_t count);
+        std::size_t size() const { return translation.size(); }
+
+        void set(std::size_t idx, const Joint&);
+        glm::quat getRotation(std::size_t idx) const;
+    };
+
     /*!
     \brief Describes an animation made up from a series of
     frames within a skeleton.
@@ -107,7 +130,7 @@ namespace cro
         //holds the current state of interpolation pre-transform
         //so it can be mixed with other animations before creating
         //final output
-        std::vector<Joint> interpolationOutput;
+        JointPose interpolationOutput;
         void resetInterp(const class Skeleton&);
     };
 
@@ -440,11 +463,21 @@ namespace cro
 
         std::vector<cro::Box> m_keyFrameBounds; //calc'd on joining the System for each key frame
 
+        //built from the key frames by the SkeletalAnimator so
+        //that poses can be evaluated without allocating
+        bool m_poseDataDirty = true;
+        JointPose m_keyFramePoses; //same layout as m_frames
+        JointPose m_blendPose;
+        std::vector<std::int32_t> m_jointParents;
+        std::vector<std::uint32_t> m_jointOrder; //parents always appear before their children
+        std::vector<glm::mat4> m_jointTransforms;
+
         friend class SkeletalAnimator;
         friend struct SkeletalAnim;
         friend struct Detail::ModelBinary::SkeletonHeader;
         friend struct Detail::ModelBinary::SkeletonHeaderV2;
 
         void buildKeyframe(std::size_t frame);
+        void updatePoseData();
     };
 }
\ No newline at end of file
@@ -39,10 +39,8 @@ source distribution.
 
 #include <vector>
 #include <functional>
-
-#ifdef USE_PARALLEL_PROCESSING
+#include <atomic>
 #include <mutex>
-#endif
 
 namespace cro
 {
@@ -51,7 +49,11 @@ namespace cro
     struct Attachment;
 
     /*!
-    \brief A three dimensional transform component
+    \brief A three dimensional transform component.
+    Transforms are deliberately kept in the index addressed ComponentPool
+    rather than packed storage: parent and child transforms refer to each
+    other by pointer, and game code holds references to them, neither of
+    which would survive a packed pool moving components on removal.
     */
     class CRO_EXPORT_API Transform final
     {
@@ -243,7 +245,11 @@ namespace cro
 
         /*!
         \brief Returns a matrix representing the world space Transform.
-        This is the local transform multiplied by all parenting transforms
+        This is the local transform multiplied by all parenting transforms.
+        The result is cached until this transform or any of its parents
+        are modified, so repeated calls are cheap regardless of the depth
+        of the hierarchy. The cache is updated by the first call after a
+        modification, and is safe to read from systems running in parallel.
         */
         glm::mat4 getWorldTransform() const;
 
@@ -289,6 +295,13 @@ namespace cro
         */
         bool getDirty() const { return m_dirtyFlags != 0; }
 
+        /*!
+        \brief Returns the number of times the world transform has been recalculated.
+        Along with getDirty() this can be used to find out if the transform has
+        changed since it was last read, without reading it again.
+        */
+        std::uint32_t getWorldUpdateCount() const { return m_worldUpdateCount.load(std::memory_order_relaxed); }
+
         /*!
         \brief Adds a callback which is executed when the transform is updated.
         Specifically this happens on setLocalTransform() or getLocalTransform()
@@ -309,14 +322,16 @@ namespace cro
         glm::vec3 m_scale;
         glm::quat m_rotation;
         mutable glm::mat4 m_transform;
+        mutable glm::mat4 m_worldTransform;
 
         Transform* m_parent;
         std::vector<Transform*> m_children = {};
         void doCallbacks() const; //actually mutable - called from getTransform()
 
-#ifdef USE_PARALLEL_PROCESSING
+        //always present as the cached matrices are lazily
+        //updated by const getters, which may be called from
+        //systems running concurrently on the SystemScheduler
         mutable std::mutex m_mutex;
-#endif
 
         std::size_t m_depth;
         void increaseDepth();
@@ -327,17 +342,25 @@ namespace cro
             Parent = 0x1,
             Child = 0x2,
             Tx = 0x4,
-            All = Parent | Child | Tx
+            World = 0x8,
+            All = Parent | Child | Tx | World
         };
-        mutable std::uint8_t m_dirtyFlags;
+        mutable std::atomic<std::uint8_t> m_dirtyFlags;
+        mutable std::atomic<std::uint32_t> m_worldUpdateCount = 0;
 
         std::vector<std::function<void()>> m_callbacks;
 
         void reset();
 
+        //marks the cached world transform of this and all children as
+        //needing an update. Unless forced this stops at any transform
+        //which is already marked, as its children will be too.
+        void markWorldDirty(bool force = false);
+
         //this is a fudge to allow transforms to read
         //skeletal attachment points
         glm::mat4 m_attachmentTransform;
+        void setAttachmentTransform(const glm::mat4&);
         friend class SkeletalAnimator;
         friend struct Attachment;
     };
@@ -31,10 +31,17 @@ source distribution.
 
 #include <crogine/ecs/System.hpp>
 
+#include <array>
 #include <functional>
+#include <memory>
 
 namespace cro
 {
+    namespace Detail
+    {
+        struct ChangedTargets;
+    }
+
     /*!
     \brief Command struct.
     Each command encapsulates a mask of target IDs
@@ -44,6 +51,14 @@ namespace cro
     {
         std::uint32_t targetFlags = 0;
         std::function<void(Entity, float)> action;
+
+        /*!
+        \brief Set this to true if the action may be executed on multiple
+        targets at the same time, ie it only modifies the target entity
+        and doesn't create or destroy any entities/components.
+        Has no effect if parallel processing is disabled.
+        */
+        bool parallel = false;
     };
 
     /*
@@ -60,6 +75,11 @@ namespace cro
         Each frame the entire queue is processed and cleared,
         executing each command on each entity with a matching
         CommandTarget flag.
+        Entities are grouped by their CommandTarget flags so that
+        a command only visits entities which match. Entities whose
+        CommandTarget ID has changed are moved to their new groups
+        before each command is executed, so flags added by a command's
+        action are matched by the commands after it in the same frame.
         \see CommandTarget
         */
         void sendCommand(const Command&);
@@ -73,5 +93,27 @@ namespace cro
         std::vector<Command> m_commands;
         std::vector<Command> m_commandBuffer;
         std::size_t m_count;
+
+        //entities sorted by each bit of their CommandTarget ID
+        std::array<std::vector<Entity>, 32u> m_buckets;
+
+        //position of each entity in each bucket, indexed by entity
+        //index, so that entities can be swapped out of a bucket
+        std::array<std::vector<std::uint32_t>, 32u> m_bucketSlots;
+
+        //the ID with which each entity was last sorted, indexed by entity index
+        std::vector<std::uint32_t> m_targetIDs;
+        std::vector<Entity> m_targets;
+
+        //indices of entities whose ID has changed, filled by CommandTarget
+        std::shared_ptr<Detail::ChangedTargets> m_changedTargets;
+        std::vector<std::uint32_t> m_changedIndices;
+
+        void addToBuckets(Entity, std::uint32_t);
+        void removeFromBuckets(Entity, std::uint32_t);
+        void sortChangedTargets();
+
+        void onEntityAdded(Entity) override;
+        void onEntityRemoved(Entity) override;
     };
 }
\ No newline at end of file
@@ -33,6 +33,7 @@ source distribution.
 #include <crogine/ecs/System.hpp>
 #include <crogine/ecs/Renderable.hpp>
 #include <crogine/graphics/Shader.hpp>
+#include <crogine/graphics/Spatial.hpp>
 
 #include <vector>
 
@@ -97,6 +98,11 @@ namespace cro
         std::uint32_t m_cameraCount;
         std::vector<std::uint32_t> m_listIndices; //indexed by camera draw list index
 
+        //models to be frustum tested
+        std::vector<Entity> m_candidates;
+        SphereBatch m_spheres;
+        VisibilityMask m_visibility;
+
         std::uint32_t m_deferredVao;
         std::uint32_t m_forwardVao;
         std::uint32_t m_vbo;
@@ -35,6 +35,7 @@ source distribution.
 #include <crogine/graphics/Colour.hpp>
 #include <crogine/graphics/RenderTexture.hpp>
 #include <crogine/graphics/Shader.hpp>
+#include <crogine/graphics/Spatial.hpp>
 #include <crogine/detail/glm/vec2.hpp>
 
 #ifdef CRO_DEBUG_
@@ -163,5 +164,10 @@ namespace cro
         std::array<std::int32_t, UniformID::Count> m_uniformIDs = {};
         std::array<TextureID, BufferID::Count> m_bufferIDs = {};
         std::vector<std::vector<Entity>> m_drawLists;
+
+        //lights to be frustum tested, with their squared distance to the camera
+        std::vector<std::pair<Entity, float>> m_candidates;
+        SphereBatch m_spheres;
+        VisibilityMask m_visibility;
     };
 }
\ No newline at end of file
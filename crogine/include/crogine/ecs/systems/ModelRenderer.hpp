@@ -37,7 +37,10 @@ source distribution.
 #include <crogine/graphics/MaterialData.hpp>
 #include <crogine/detail/BalancedTree.hpp>
 #include <crogine/detail/SDLResource.hpp>
+#include <crogine/detail/Assert.hpp>
 
+#include <array>
+#include <unordered_map>
 #include <vector>
 
 namespace cro
@@ -48,8 +51,32 @@ namespace cro
     //don't export this, used internally.
     struct SortData final
     {
-        std::int64_t flags = 0;
-        std::vector<std::int32_t> matIDs;
+        //packed sort key. Opaque draws are ordered by
+        //shader | material | mesh | depth (front to back) and transparent
+        //draws by depth (back to front) | shader | material | mesh with
+        //the top bit set so that they are always drawn last.
+        std::uint64_t flags = 0;
+
+        //fixed capacity list of submesh indices. Stored inline
+        //so that culling doesn't allocate for every visible entity
+        struct MaterialIDs final
+        {
+            void push_back(std::int32_t id)
+            {
+                CRO_ASSERT(m_size < m_ids.size(), "Material ID list is full");
+                m_ids[m_size++] = static_cast<std::uint8_t>(id);
+            }
+
+            bool empty() const { return m_size == 0; }
+            std::size_t size() const { return m_size; }
+
+            const std::uint8_t* begin() const { return m_ids.data(); }
+            const std::uint8_t* end() const { return m_ids.data() + m_size; }
+
+        private:
+            std::array<std::uint8_t, Mesh::IndexData::MaxBuffers> m_ids = {};
+            std::uint8_t m_size = 0;
+        }matIDs;
     };
 
     using MaterialPair = std::pair<Entity, SortData>;
@@ -61,6 +88,14 @@ namespace cro
     The system frustum-culls then renders any entities with a Model component
     in the scene. Note this only renders Models - Sprite and Text components
     are rendered with RenderSystem2D.
+
+    On desktop platforms opaque Models which share the same mesh data and
+    material are automatically drawn with a single instanced draw call,
+    provided the material's shader was built with instancing enabled (for
+    example with ShaderResource::BuiltInFlags::Instanced) or has an instanced
+    variant (see Shader::setInstancedVariant()). Built-in Unlit, VertexLit
+    and PBR shaders have one by default. Models which have their own instance
+    transforms, or are skinned, are always drawn individually.
     */
     class CRO_EXPORT_API ModelRenderer final : public System, public Renderable
     {
@@ -71,6 +106,8 @@ namespace cro
         */
         explicit ModelRenderer(MessageBus& mb);
 
+        ~ModelRenderer();
+
         /*!
         \brief Performs frustum culling and Material sorting by depth and blend mode
         */
@@ -94,6 +131,41 @@ namespace cro
         */
         std::size_t getVisibleCount(std::size_t cameraIndex, std::int32_t passIndex = 0) const;
 
+        /*!
+        \brief Enables or disables culling with a bounding volume hierarchy.
+        When enabled Models are stored in a dynamic AABB tree which is used
+        to cull every camera pass, as well as the shadow map cascades of any
+        ShadowMapRenderer in the same Scene. This is usually faster for
+        Scenes with many Models, especially when only a few of them are
+        visible at once. Disabled by default.
+        */
+        void setUseTreeQueries(bool useTree);
+
+        /*!
+        \brief Returns true if tree culling is enabled
+        \see setUseTreeQueries()
+        */
+        bool getUseTreeQueries() const { return m_useTreeQueries; }
+
+        /*!
+        \brief Counts of the state changes made by the renderer.
+        These are accumulated over all cameras and passes drawn
+        during the current frame, and reset each time process() is called.
+        */
+        struct DrawStats final
+        {
+            std::size_t programSwitches = 0;
+            std::size_t textureBinds = 0;
+            std::size_t uniformCalls = 0;
+            std::size_t drawCalls = 0;
+            std::size_t instancedDraws = 0; //!< draw calls which were batched from multiple Models
+        };
+
+        /*!
+        \brief Returns the DrawStats for the current frame
+        */
+        const DrawStats& getDrawStats() const { return m_drawStats; }
+
         struct VertexShaderID final
         {
             enum
@@ -135,18 +207,88 @@ namespace cro
         using DrawList = std::array<MaterialList, 2u>;
         std::vector<DrawList> m_drawLists;
 
+        //per-chunk culling data. Each chunk gathers the bounds of its
+        //entities to be frustum tested as a batch, and the output is
+        //merged into the active draw list once all chunks are processed
+        struct CullChunk final
+        {
+            DrawList drawList;
+            std::vector<Entity> entities;
+            SphereBatch spheres;
+            VisibilityMask visibility;
+        };
+        std::vector<CullChunk> m_cullChunks;
+
         Mesh::IndexData::Pass m_pass;
+        DrawStats m_drawStats;
 
-        /*Detail::BalancedTree m_tree;
-        bool m_useTreeQueries;*/
+        //tracks the GL state set by the previous draw so that
+        //redundant bindings and uniform updates can be skipped
+        struct StateCache final
+        {
+            static constexpr std::size_t MaxTextureUnits = 16;
+            std::array<std::pair<std::uint32_t, std::uint32_t>, MaxTextureUnits> textures = {}; //target, ID
+            std::uint32_t activeUnit = 0;
+            std::vector<std::uint32_t> programs; //shaders which have had their global uniforms set
+
+            //set by render() before applying a material
+            bool applyMaterial = true; //material changed since last draw
+            bool applyGlobal = true; //first time this shader is used in this render() call
+
+            DrawStats stats;
+
+            void reset();
+            void bindTexture(std::uint32_t unit, std::uint32_t target, std::uint32_t id);
+        }m_stateCache;
+
+        Detail::BalancedTree m_tree;
+        bool m_useTreeQueries;
+        bool m_treeDirty;
+        std::vector<std::pair<Entity, bool>> m_treeResults;
+        std::vector<Entity> m_treeEntities; //results which intersect the frustum and need a sphere test
+        SphereBatch m_treeSpheres;
+        VisibilityMask m_treeVisibility;
+
+        static Sphere getCullingSphere(Entity);
+        void addToDrawList(Entity, const Sphere&, const Camera&, glm::vec3 cameraPos, std::int32_t pass, MaterialList&);
+        void addToTree(Entity);
+        void refreshTree();
+
+#ifdef PLATFORM_DESKTOP
+        //opaque entries with identical meshes and materials are drawn as a
+        //single instanced draw, if the material's shader supports instancing
+        //or has an instanced variant
+        static constexpr std::size_t MinInstanceCount = 2;
+        struct InstanceBuffers final
+        {
+            std::uint32_t transformBuffer = 0;
+            std::uint32_t normalBuffer = 0;
+            std::uint32_t vao = 0; //used with instanced variants, as their attrib locations may not match the model's VAO
+        }m_instanceBuffers;
+        std::vector<glm::mat4> m_instanceTransforms;
+        std::vector<glm::mat3> m_instanceNormals;
+
+        //materials set up with the instanced variant shaders, keyed by
+        //variant handle, and a copy of the material currently being drawn
+        //with its uniform and attrib locations swapped for the variant's
+        std::unordered_map<std::uint32_t, Material::Data> m_variantMaterials;
+        Material::Data m_instancedMaterial;
+
+        bool canInstance(const MaterialPair&) const;
+        bool canBatch(const MaterialPair& first, const MaterialPair& other) const;
+        void uploadInstanceData(const MaterialList&, std::size_t start, std::size_t count);
+        const Material::Data& getInstancedMaterial(const Material::Data&);
+        void drawInstanced(const Model&, const Material::Data&, std::int32_t submesh, std::size_t count);
+#endif
 
         void updateDrawListDefault(Entity);
+        void cullEntities(const Entity*, const Entity*, Entity, CullChunk&);
         void updateDrawListBalancedTree(Entity);
-        //std::vector<Entity> queryTree(Box) const;
 
         friend class DeferredRenderSystem;
+        friend class ShadowMapRenderer;
         //these funcs are shared with above system - should probably be free funcs somewhere?
-        static void applyProperties(const Material::Data&, const Model&, const Scene&, const Camera&);
+        static void applyProperties(const Material::Data&, const Model&, const Scene&, const Camera&, StateCache* = nullptr);
         static void applyBlendMode(const Material::Data&);
     };
 
@@ -33,6 +33,8 @@ source distribution.
 #include <crogine/ecs/Renderable.hpp>
 
 #include <crogine/graphics/Shader.hpp>
+#include <crogine/graphics/Spatial.hpp>
+#include <crogine/graphics/StreamingBuffer.hpp>
 #include <crogine/graphics/Texture.hpp>
 
 #include <crogine/gui/GuiClient.hpp>
@@ -42,6 +44,9 @@ source distribution.
 
 namespace cro
 {
+    class ParticleEmitter;
+    class Transform;
+
     /*!
     \brief Particle system.
     Updates and renders all particle emitters in the scene.
@@ -71,6 +76,16 @@ namespace cro
 
         void render(Entity, const RenderTarget&) override;
 
+        /*!
+        \brief Spawns, updates and removes the particles of a single emitter,
+        and writes their vertex data, without uploading it.
+        This is the part of process() which needs no graphics context.
+        \param emitter The ParticleEmitter to update
+        \param tx The Transform of the entity the emitter belongs to
+        \param dt Frame time in seconds
+        */
+        static void simulate(ParticleEmitter& emitter, const Transform& tx, float dt);
+
     private:
         //for two passes, normal and reflection
         using DrawList = std::array<std::vector<Entity>, 2u>;
@@ -79,21 +94,24 @@ namespace cro
 
         //std::vector<Entity> m_potentiallyVisible; //entities which are in front of at least one camera
 
+        //emitters to be frustum tested
+        std::vector<Entity> m_candidates;
+        SphereBatch m_bounds;
+        VisibilityMask m_visibility;
+
         void onEntityAdded(Entity) override;
-        void onEntityRemoved(Entity) override;
 
-        std::vector<float> m_dataBuffer;
-        std::vector<std::uint32_t> m_vboIDs;
-        std::vector<std::uint32_t> m_vaoIDs; //< used on desktop
-        std::size_t m_nextBuffer;
-        std::size_t m_bufferCount;
+        //vertex data of all emitters is written here each frame
+        StreamingBuffer m_vertexBuffer;
+        std::uint32_t m_vao; //< used on desktop
+        std::uint32_t m_vaoBuffer; //< the buffer to which the VAO attribs currently point
 
         //this is a fallback texture for untextured systems.
         //probably not less optimal than switching between
         //textured and untextured shaders.
         cro::Texture m_fallbackTexture;
 
-        void allocateBuffer();
+        void bindAttribs(std::uint32_t vbo);
 
         std::vector<std::unique_ptr<Shader>> m_shaders;
 
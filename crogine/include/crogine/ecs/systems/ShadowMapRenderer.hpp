@@ -34,6 +34,7 @@ source distribution.
 #include <crogine/ecs/Renderable.hpp>
 #include <crogine/graphics/RenderTexture.hpp>
 #include <crogine/graphics/DepthTexture.hpp>
+#include <crogine/graphics/Spatial.hpp>
 
 namespace cro
 {
@@ -137,6 +138,12 @@ namespace cro
         };
         //for each camera, for each camera cascade, a vector of entities
         std::vector<std::vector<std::vector<Drawable>>> m_drawLists;
+        std::vector<std::pair<Entity, bool>> m_treeResults;
+
+        //bounds of the active casters, tested against each cascade
+        std::vector<Entity> m_casters;
+        SphereBatch m_casterSpheres;
+        VisibilityMask m_casterVisibility;
 
         void render();
 
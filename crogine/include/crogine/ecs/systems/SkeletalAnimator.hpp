@@ -71,6 +71,9 @@ namespace cro
 
         void blendAnimations(const SkeletalAnim&, const SkeletalAnim&, float time, Skeleton&) const;
 
+        //builds the joint hierarchy from the given pose and writes it to the skeleton's current frame
+        void applyPose(const JointPose&, Skeleton&) const;
+
         void updateBoundsFromCurrentFrame(Skeleton& dest, const Mesh::Data&) const;
     };
 }
\ No newline at end of file
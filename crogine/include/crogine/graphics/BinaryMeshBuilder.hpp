@@ -48,6 +48,14 @@ namespace cro
         std::string m_path;
         std::size_t m_uid;
         mutable Skeleton m_skeleton;
+
+        mutable bool m_prepared = false;
+        mutable Mesh::Data m_meshData;
+        mutable std::vector<float> m_vertexData;
+        mutable std::vector<std::uint8_t> m_indexData; //all index arrays, contiguous
+        mutable std::size_t m_indexOffset = 0; //bytes from the start of m_indexData to the first array
+
         Mesh::Data build() const override;
+        bool prepare() const override;
     };
 }
@@ -315,6 +315,11 @@ namespace cro
             */
             void disableCustomSettings() const;
 
+            /*!
+            \brief Returns true if this material has any custom settings
+            */
+            bool hasCustomSettings() const { return m_customSettingsCount != 0; }
+
             /*!
             \brief Animation data used if material is animated
             Note that this cannot be changed once it is assigned
@@ -365,6 +370,9 @@ namespace cro
             //used internally, and not user-definable
             std::size_t optionalUniformCount = 0;
             std::array<std::int32_t, 10> optionalUniforms{};
+            //used by the ModelRenderer to batch draws if the shader
+            //doesn't support instancing, see Shader::setInstancedVariant()
+            const Shader* instancedShader = nullptr;
 
         private:
             std::unordered_map<std::string, bool> m_warnings;
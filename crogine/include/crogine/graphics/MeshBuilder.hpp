@@ -102,6 +102,7 @@ namespace cro
 
     protected:
         friend class MeshResource;
+        friend class ModelDefinition;
         friend class SpriteSystem3D;
         /*!
         \brief Implement this to create the appropriate VBO / IBO
@@ -110,6 +111,16 @@ namespace cro
         */
         virtual Mesh::Data build() const = 0;
 
+        /*!
+        \brief Optionally implement this to perform any file I/O or decoding
+        which does not require a graphics context. When loading a mesh with
+        MeshResource::loadMeshAsync() this is called on a worker thread, and
+        build() is subsequently called on the main thread, where it should
+        use the prepared data rather than loading it again.
+        \returns false if the mesh data could not be loaded
+        */
+        virtual bool prepare() const { return true; }
+
         static std::size_t getAttributeSize(const std::array<std::size_t, Mesh::Attribute::Total>& attrib);
         static std::size_t getVertexSize(const std::array<std::size_t, Mesh::Attribute::Total>& attrib);
         static void createVBO(Mesh::Data& meshData, const std::vector<float>& vertexData);
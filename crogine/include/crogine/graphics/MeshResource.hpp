@@ -30,6 +30,7 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
+#include <crogine/core/AsyncLoader.hpp>
 #include <crogine/detail/Types.hpp>
 #include <crogine/detail/SDLResource.hpp>
 #include <crogine/graphics/MeshData.hpp>
@@ -37,6 +38,7 @@ source distribution.
 
 #include <unordered_map>
 #include <array>
+#include <memory>
 
 namespace cro
 {    
@@ -83,6 +85,20 @@ namespace cro
         */
         std::size_t loadMesh(const MeshBuilder& mb, bool forceReload = false);
 
+        /*!
+        \brief Loads a mesh asynchronously and maps it to the given ID.
+        MeshBuilder::prepare() is called on a worker thread, after which
+        the mesh is built on the main thread by the AsyncLoader. getMesh()
+        MUST NOT be called with the given ID until the returned handle
+        reports success.
+        \param ID Integer ID to map to the mesh created by the MeshBuilder instance
+        \param mb Shared pointer to a concrete MeshBuilder. The resource keeps
+        a reference to the builder until loading is complete.
+        \returns AsyncHandle used to query whether the mesh was successfully loaded
+        \see AsyncLoader
+        */
+        AsyncHandle loadMeshAsync(std::size_t ID, std::shared_ptr<const MeshBuilder> mb);
+
         /*!
         \brief Returns the mesh data for the given ID.
         */
@@ -109,6 +125,10 @@ namespace cro
         std::unordered_map<std::size_t, Mesh::Data> m_meshData;
         std::unordered_map<std::size_t, Skeleton> m_skeletalData;
 
+        friend class ModelDefinition;
+        std::shared_ptr<MeshResource*> m_asyncOwner;
+        std::unordered_map<std::size_t, AsyncHandle> m_asyncHandles;
+
         void deleteMesh(Mesh::Data);
     };
 }
\ No newline at end of file
@@ -132,6 +132,35 @@ namespace cro
         */
         bool loadFromFile(const std::string& path, bool instanced = false, bool useDeferredShaders = false, bool forceReload = false);
 
+        /*!
+        \brief Preloads the mesh and textures referenced by the definition at the given path.
+        The definition file is parsed, and the binary mesh and textures it uses are decoded,
+        on a worker thread. The mesh and textures are then added to the ResourceCollection on
+        the main thread by the AsyncLoader. Once the returned handle is ready, loadFromFile()
+        with the same path only needs to create the materials, as the mesh and texture data
+        are found in the ResourceCollection. This allows many models to be decoded in parallel:
+        \begincode
+        std::vector<AsyncHandle> handles;
+        for (const auto& path : paths)
+        {
+            handles.push_back(definition.preloadAsync(path));
+        }
+        AsyncLoader::finish();
+
+        for (const auto& path : paths)
+        {
+            definition.loadFromFile(path);
+            //etc...
+        }
+        \endcode
+        This does not modify the ModelDefinition itself, so a single instance can be used to
+        preload any number of files.
+        \param path String containing the path to a model definition file
+        \returns AsyncHandle used to query whether the preload was successful
+        \see AsyncLoader
+        */
+        AsyncHandle preloadAsync(const std::string& path) const;
+
         /*!
         \brief Creates a Model component from the loaded config on the given entity.
         \returns true on success, else false (no model definition has been loaded)
@@ -89,6 +89,8 @@ namespace cro
         NOTE to ensure correct version number for specific platforms (100 for ES2,
         410 for desktop) these are automatically appended here. Therefore #version
         directives should be omitted from any source code.
+        Where supported the linked program is stored in the ShaderCache so
+        that subsequent runs can skip compilation entirely.
         */
         bool loadFromString(const std::string& vertex, const std::string& fragment, const std::string& defines = "");
         bool loadFromString(const std::string& vertex, const std::string& geometry, const std::string& fragment, const std::string& defines);
@@ -115,6 +117,21 @@ namespace cro
         */
         std::int32_t getUniformID(const std::string& uniformName) const;
 
+        /*!
+        \brief Sets a version of this shader compiled with INSTANCING defined.
+        Materials created from this shader use the variant when the ModelRenderer
+        batches Models sharing the same mesh and material into a single instanced
+        draw. It must be set before any Materials are created with this shader,
+        and must outlive them. ShaderResource sets this for built-in shaders.
+        \param variant Pointer to the instanced shader, or nullptr to clear it
+        */
+        void setInstancedVariant(const Shader* variant) { m_instancedVariant = variant; }
+
+        /*!
+        \brief Returns the instanced variant of this shader if it has one, else nullptr
+        \see setInstancedVariant()
+        */
+        const Shader* getInstancedVariant() const { return m_instancedVariant; }
 
     private:
         bool loadFromSource(const char* v, const char* g, const char* f, const char* d);
@@ -127,6 +144,8 @@ namespace cro
         void fillUniformMap();
         void resetUniformMap();
         std::string parseFile(const std::string&);
+
+        const Shader* m_instancedVariant;
     };
 }
 
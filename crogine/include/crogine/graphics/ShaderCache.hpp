@@ -0,0 +1,134 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace cro
+{
+    class Shader;
+
+    /*!
+    \brief Persistent on-disk cache of linked shader program binaries.
+    When enabled, and when the driver reports at least one program binary
+    format, Shader stores the linked binary of every program it creates
+    in the shader_cache directory of the application's preference path.
+    On subsequent runs the binary is loaded with glProgramBinary() instead
+    of compiling the GLSL source, which can dramatically reduce loading
+    times for applications which use many shader permutations.
+
+    Binaries are keyed by a hash of the complete shader source, including
+    any defines and the platform preamble, along with the GL vendor, renderer
+    and version strings. Any change to a shader or to the driver therefore
+    results in a new key. A hash of the driver strings is also stored in
+    the cache directory, and if it doesn't match the current driver the
+    first time the cache is used all existing entries are deleted, so
+    binaries left by previous drivers don't accumulate. If the driver
+    rejects a cached binary the entry is deleted and the shader is
+    compiled from source as normal, so the cache never prevents a shader
+    from loading.
+
+    The cache is not available on mobile platforms, where it is silently
+    disabled.
+    */
+    class CRO_EXPORT_API ShaderCache final
+    {
+    public:
+        /*!
+        \brief Enables or disables the cache. Enabled by default.
+        Disabling the cache does not remove any existing entries,
+        use clear() to do this.
+        */
+        static void setEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if the cache is enabled
+        */
+        static bool getEnabled();
+
+        /*!
+        \brief Returns true if the cache is enabled and the current
+        driver supports at least one program binary format.
+        Requires a valid OpenGL context.
+        */
+        static bool isAvailable();
+
+        /*!
+        \brief Removes all entries from the cache directory
+        */
+        static void clear();
+
+        /*!
+        \brief Returns the directory in which cached binaries are
+        stored, or an empty string if no App instance exists.
+        */
+        static std::string getPath();
+
+        /*!
+        \brief Returns the number of programs loaded from the cache
+        since the application started.
+        */
+        static std::size_t getHitCount();
+
+        /*!
+        \brief Returns the number of programs which had to be compiled
+        from source since the application started, while the cache was
+        available.
+        */
+        static std::size_t getMissCount();
+
+    private:
+        friend class Shader;
+
+        /*!
+        \brief Creates a key from the given array of source strings.
+        nullptr entries are permitted and are hashed distinctly from
+        empty strings.
+        */
+        static std::uint64_t createKey(const char* const* sources, std::size_t count);
+
+        /*!
+        \brief Attempts to load the binary with the given key into the
+        given program. Returns true and a linked program on success.
+        */
+        static bool load(std::uint64_t key, std::uint32_t program);
+
+        /*!
+        \brief Writes the binary of the given linked program to the cache
+        */
+        static void store(std::uint64_t key, std::uint32_t program);
+
+        static void remove(std::uint64_t key);
+    };
+}
@@ -34,8 +34,10 @@ source distribution.
 #include <crogine/detail/SDLResource.hpp>
 #include <crogine/graphics/Shader.hpp>
 
+#include <deque>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace cro
 {    
@@ -224,6 +226,9 @@ namespace cro
         \param flags A combination of BuiltInFlags bitwise ORd together indicating which shader features are requested
         \returns std::int32_t representing the ID of the preloaded shader if it succeeds, else returns -1. The returned ID
         can be used with get() to return an instance of the shader.
+        On desktop platforms Unlit, VertexLit and PBR shaders requested without the Instanced
+        or Skinning flags also load their Instanced variant, which the ModelRenderer uses to
+        batch Models sharing a mesh and material. \see Shader::setInstancedVariant()
         */
         std::int32_t loadBuiltIn(BuiltIn type, std::int32_t flags);
 
@@ -254,11 +259,67 @@ namespace cro
         */
         void addInclude(const std::string& inc, const char* source);
 
+        /*!
+        \brief Describes a shader permutation to be compiled ahead of time
+        \see addPermutations()
+        */
+        struct CRO_EXPORT_API Permutation final
+        {
+            /*!
+            \brief Declares a built-in shader
+            \param type BuiltIn type of the shader
+            \param flags BuiltInFlags to pass to loadBuiltIn()
+            */
+            Permutation(BuiltIn type, std::int32_t flags);
+
+            /*!
+            \brief Declares a custom shader as it would be passed to loadFromString()
+            Source strings are copied so they need not outlive the Permutation.
+            */
+            Permutation(std::int32_t id, const std::string& vertex, const std::string& fragment, const std::string& defines = "");
+            Permutation(std::int32_t id, const std::string& vertex, const std::string& geometry, const std::string& fragment, const std::string& defines);
+
+            bool builtIn = false;
+            BuiltIn type = BuiltIn::Unlit;
+            std::int32_t flags = 0;
+
+            std::int32_t id = -1;
+            std::string vertex;
+            std::string geometry;
+            std::string fragment;
+            std::string defines;
+        };
+
+        /*!
+        \brief Declares a set of shader permutations to be compiled with precompile().
+        Declaring the permutations a State will use up front and compiling them while
+        a loading screen is displayed prevents hitches caused by compiling shaders
+        on first use. Combined with the ShaderCache this usually means only the first
+        ever run of an application pays the cost of compiling from source.
+        Permutations which have already been loaded when they are reached are skipped.
+        */
+        void addPermutations(const std::vector<Permutation>& permutations);
+
+        /*!
+        \brief Compiles pending permutations declared with addPermutations()
+        \param maxCount The maximum number of shaders to compile in this call,
+        or 0 to compile all of them. Setting this to a small value allows a loading
+        screen to remain responsive by spreading compilation over several frames.
+        \returns The number of permutations still pending.
+        */
+        std::size_t precompile(std::size_t maxCount = 0);
+
+        /*!
+        \brief Returns the number of declared permutations not yet compiled
+        */
+        std::size_t getPendingPermutationCount() const;
+
     private:
 
         Shader m_defaultShader;
         std::unordered_map<std::int32_t, Shader> m_shaders;
         std::unordered_map<std::string, const char*> m_includes;
+        std::deque<Permutation> m_pendingPermutations;
 
         std::string parseIncludes(const std::string& src) const;
     };
@@ -34,6 +34,8 @@ source distribution.
 #include <crogine/detail/glm/vec4.hpp>
 
 #include <array>
+#include <vector>
+#include <cstdint>
 
 namespace cro
 {
@@ -57,6 +59,52 @@ namespace cro
         Intersection, Front, Back
     };
 
+    /*!
+    \brief Structure of arrays storage for a batch of Spheres.
+    Used with Spatial::intersects() to test many Spheres against
+    a Frustum at once.
+    */
+    struct CRO_EXPORT_API SphereBatch final
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        void clear();
+        void reserve(std::size_t count);
+        void push_back(const Sphere&);
+        Sphere operator [](std::size_t idx) const;
+        std::size_t size() const { return radius.size(); }
+    };
+
+    /*!
+    \brief Structure of arrays storage for a batch of AABBs.
+    Used with Spatial::intersects() to test many Boxes against
+    a Frustum at once.
+    */
+    struct CRO_EXPORT_API BoxBatch final
+    {
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> minZ;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+        std::vector<float> maxZ;
+
+        void clear();
+        void reserve(std::size_t count);
+        void push_back(const Box&);
+        Box operator [](std::size_t idx) const;
+        std::size_t size() const { return minX.size(); }
+    };
+
+    /*!
+    \brief Visibility results of a batch test, stored as one bit
+    per batch element, 64 elements per word.
+    */
+    using VisibilityMask = std::vector<std::uint64_t>;
+
     namespace Spatial
     {
         /*!
@@ -76,6 +124,34 @@ namespace cro
         */
         Planar CRO_EXPORT_API intersects(Plane plane, Box box);
 
+        /*!
+        \brief Tests a batch of Spheres against a Frustum.
+        A Sphere is visible if it is not behind any of the Frustum's planes,
+        giving the same result as testing intersects(plane, sphere) != Planar::Back
+        for each plane. SSE/AVX or NEON are used where available.
+        \param frustum The Frustum to test against
+        \param spheres The Spheres to test
+        \param output Resized to fit the results. The bit for each visible
+        Sphere is set.
+        \see isVisible()
+        */
+        void CRO_EXPORT_API intersects(const Frustum& frustum, const SphereBatch& spheres, VisibilityMask& output);
+
+        /*!
+        \brief Tests a batch of AABBs against a Frustum.
+        As above but tests Boxes, giving the same result as testing
+        intersects(plane, box) != Planar::Back for each plane.
+        */
+        void CRO_EXPORT_API intersects(const Frustum& frustum, const BoxBatch& boxes, VisibilityMask& output);
+
+        /*!
+        \brief Returns true if the bit for the given index is set in a VisibilityMask
+        */
+        inline bool isVisible(const VisibilityMask& mask, std::size_t idx)
+        {
+            return (mask[idx / 64] & (1ull << (idx % 64))) != 0;
+        }
+
         /*!
         \brief Updates the given frustum based on the given viewProjection matrix
         \param frustum An array of 6 Planes which make up the frustum
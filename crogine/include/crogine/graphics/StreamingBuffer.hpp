@@ -0,0 +1,219 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace cro
+{
+    namespace Detail
+    {
+        /*!
+        \brief Interface to the graphics API used by StreamingBuffer.
+        The default implementation talks to OpenGL, but a custom backend
+        can be supplied to StreamingBuffer, for example to exercise the
+        allocator without a graphics context.
+        */
+        class CRO_EXPORT_API StreamingBackend
+        {
+        public:
+            virtual ~StreamingBackend() = default;
+
+            /*!
+            \brief Returns true if buffers created by this backend are
+            persistently mapped and synchronised with fences, or false if
+            buffers are updated via uploadData() and orphaned each frame.
+            */
+            virtual bool persistentMapping() const = 0;
+
+            /*!
+            \brief Creates a buffer of the given size in bytes.
+            \param mappedData If the backend uses persistent mapping this
+            is set to the mapped address of the buffer storage.
+            \returns Handle to the buffer
+            */
+            virtual std::uint32_t createBuffer(std::size_t size, std::uint8_t** mappedData) = 0;
+
+            /*!
+            \brief Deletes the buffer with the given handle
+            */
+            virtual void deleteBuffer(std::uint32_t buffer) = 0;
+
+            /*!
+            \brief Replaces the storage of the given buffer so that writing
+            to it does not wait on commands still reading the old storage.
+            */
+            virtual void orphanBuffer(std::uint32_t buffer, std::size_t size) = 0;
+
+            /*!
+            \brief Copies size bytes of data into the given buffer at offset.
+            Only used when persistentMapping() returns false.
+            */
+            virtual void uploadData(std::uint32_t buffer, std::size_t offset, const void* data, std::size_t size) = 0;
+
+            /*!
+            \brief Inserts a fence after all currently submitted commands
+            \returns Handle to the fence
+            */
+            virtual std::uintptr_t insertFence() = 0;
+
+            /*!
+            \brief Blocks until the given fence has been signalled
+            */
+            virtual void waitFence(std::uintptr_t fence) = 0;
+
+            /*!
+            \brief Deletes the given fence
+            */
+            virtual void deleteFence(std::uintptr_t fence) = 0;
+        };
+    }
+
+    /*!
+    \brief Ring buffer for vertex data which is regenerated every frame.
+
+    Rather than each producer of dynamic geometry owning a VBO which is
+    re-uploaded every frame (and so synchronising with the driver each
+    time), a StreamingBuffer sub-allocates regions of a single large
+    buffer. On GL 4.4 and above the buffer is persistently mapped and
+    written directly, with fences placed at the end of each frame to
+    prevent overwriting data the GPU may still be reading. On GL 4.1
+    and GLES the buffer is instead orphaned at the beginning of each
+    frame.
+
+    Allocations are only valid until the next call to beginFrame(),
+    so data must be written every frame it is drawn. If a frame requires
+    more space than is available the buffer grows, so the buffer handle
+    of an allocation may change between frames (or even within a frame)
+    and should be checked when binding vertex attributes.
+
+    StreamingBuffers are non-copyable.
+    */
+    class CRO_EXPORT_API StreamingBuffer final
+    {
+    public:
+        /*!
+        \brief Describes a region of the buffer returned by write()
+        */
+        struct Allocation final
+        {
+            std::uint32_t buffer = 0; //!< handle of the buffer containing the data
+            std::size_t offset = 0; //!< offset of the data in bytes from the start of the buffer
+        };
+
+        static constexpr std::size_t DefaultSize = 4 * 1024 * 1024;
+
+        /*!
+        \brief Constructor.
+        \param size Initial size in bytes of the buffer. Storage is not
+        created until the first call to write()
+        */
+        explicit StreamingBuffer(std::size_t size = DefaultSize);
+
+        /*!
+        \brief Constructs a StreamingBuffer using a custom backend
+        \param backend StreamingBackend used to create and update buffers
+        \param size Initial size in bytes of the buffer
+        */
+        StreamingBuffer(std::unique_ptr<Detail::StreamingBackend> backend, std::size_t size = DefaultSize);
+
+        ~StreamingBuffer();
+
+        StreamingBuffer(const StreamingBuffer&) = delete;
+        StreamingBuffer(StreamingBuffer&&) = delete;
+        StreamingBuffer& operator = (const StreamingBuffer&) = delete;
+        StreamingBuffer& operator = (StreamingBuffer&&) = delete;
+
+        /*!
+        \brief Marks the end of the previous frame's data.
+        Call this once per frame before writing any data, and after
+        all draw calls using the previous frame's allocations have
+        been submitted.
+        */
+        void beginFrame();
+
+        /*!
+        \brief Copies data into the buffer.
+        \param data Pointer to the data to copy
+        \param size Size of the data in bytes
+        \param alignment The returned offset will be a multiple of this
+        value. Use the vertex stride so that the offset can be converted
+        to a first vertex index when drawing.
+        \returns Allocation describing where the data was written
+        */
+        Allocation write(const void* data, std::size_t size, std::size_t alignment = 4);
+
+        /*!
+        \brief Returns the current size of the buffer in bytes
+        */
+        std::size_t getSize() const { return m_size; }
+
+        /*!
+        \brief Returns the handle of the buffer currently being written to
+        or 0 if no data has yet been written.
+        */
+        std::uint32_t getBuffer() const { return m_buffer; }
+
+    private:
+        std::unique_ptr<Detail::StreamingBackend> m_backend;
+        bool m_persistent;
+
+        std::size_t m_size;
+        std::uint32_t m_buffer;
+        std::uint8_t* m_mappedData;
+
+        std::size_t m_head;
+        std::size_t m_frameStart;
+        bool m_frameWrapped;
+
+        //regions of previous frames which may still be in use by the GPU
+        struct FrameRegion final
+        {
+            std::size_t start = 0;
+            std::size_t end = 0;
+            bool wrapped = false;
+            std::uintptr_t fence = 0;
+        };
+        std::deque<FrameRegion> m_inFlight;
+
+        //buffers replaced by grow(), deleted at the start of the next frame
+        std::vector<std::uint32_t> m_retiredBuffers;
+
+        void create(std::size_t);
+        void grow(std::size_t);
+        void waitForRegion(std::size_t start, std::size_t end);
+    };
+}
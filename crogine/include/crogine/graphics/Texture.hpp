@@ -42,6 +42,8 @@ namespace cro
 {
     class Image;
     class Colour;
+    template <class T>
+    class ImageArray;
 
     /*!
     \brief Generic texture wrapper for OpenGL RGB or RGBA textures.
@@ -90,6 +92,17 @@ namespace cro
         */
         bool loadFromImage(const Image& image, bool createMipmaps = false);
 
+        /*!
+        \brief Attempts to create the texture from the given ImageArray.
+        This allows decoding image files, which does not require a graphics
+        context, to be performed separately from creating the texture.
+        \param image A reference to a loaded 8 bit image array
+        \param createMipMaps Set true to automatically create mipmap levels for this texture
+        \returns true on success, else false
+        \see ImageArray
+        */
+        bool loadFromImage(const ImageArray<std::uint8_t>& image, bool createMipmaps = false);
+
         /*!
         \brief Updates the pixel data for the texture.
         Ensure the texture is valid by calling create() or successfully calling loadFromFile()
@@ -30,6 +30,7 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
+#include <crogine/core/AsyncLoader.hpp>
 #include <crogine/graphics/Texture.hpp>
 #include <crogine/graphics/Colour.hpp>
 
@@ -63,9 +64,9 @@ namespace cro
         ~TextureResource() = default;
 
         TextureResource(const TextureResource&) = delete;
-        TextureResource(TextureResource&&) noexcept = default;
+        TextureResource(TextureResource&&) noexcept;
         const TextureResource& operator = (const TextureResource&) = delete;
-        TextureResource& operator = (TextureResource&&) noexcept = default;
+        TextureResource& operator = (TextureResource&&) noexcept;
         
         /*!
         \brief Attempts to load the image at the given path
@@ -78,6 +79,21 @@ namespace cro
         */
         bool load(std::uint32_t id, const std::string& path, bool createMipMaps = false);
 
+        /*!
+        \brief Loads the image at the given path asynchronously.
+        The image file is decoded on a worker thread and the texture created
+        on the main thread by the AsyncLoader. Until the returned handle is
+        ready get() returns the fallback texture for the given ID.
+        \param id ID to assign to the loaded texture, if successful.
+        \param path String containing the path of the image to attempt to load
+        \param createMipMaps Attempts to create the default MipMap levels
+        when loading the texture.
+        \returns AsyncHandle which can be used to query whether the texture
+        loaded successfully.
+        \see AsyncLoader
+        */
+        AsyncHandle loadAsync(std::uint32_t id, const std::string& path, bool createMipMaps = false);
+
         /*!
         \brief Returns a reference to the texture currently assigned to the given ID
         If the ID doesn't correspond to a loaded texture then a reference to the fallback
@@ -117,6 +133,15 @@ namespace cro
         std::unordered_map<Colour, std::unique_ptr<Texture>> m_fallbackTextures;
         Colour m_fallbackColour;
 
+        //pending uploads use this to find the resource, which may
+        //have been moved or destroyed since the load was requested
+        std::shared_ptr<TextureResource*> m_asyncOwner;
+        std::unordered_map<std::uint32_t, std::pair<std::string, AsyncHandle>> m_asyncHandles;
+
         Texture& getFallbackTexture();
+
+        friend class ModelDefinition;
+        Texture& insert(const std::string& path, const ImageArray<std::uint8_t>& image, bool createMipMaps);
+        static std::string getFullPath(const std::string& path);
     };
 }
\ No newline at end of file
@@ -44,6 +44,13 @@ struct _ENetHost;
 
 namespace cro
 {
+    namespace Detail
+    {
+        class NetBatch;
+        class NetConditioner;
+        class NetDemux;
+    }
+
     /*!
     \brief Creates a client side host which can be used to create
     a peer connected to a NetHost server.
@@ -146,11 +153,47 @@ namespace cro
         */
         const NetPeer& getPeer() const { return m_peer; }
 
+        /*!
+        \brief Enables or disables batching of outgoing packets.
+        When enabled, packets sent with sendPacket() are gathered per channel
+        and NetFlag, and each group is sent as a single packet the next time
+        pollEvent() is called. Packet ID 255 is reserved for batches.
+        Disabled by default.
+        \see NetHost::setBatchingEnabled()
+        */
+        void setBatchingEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if outgoing packets are batched
+        */
+        bool getBatchingEnabled() const { return m_batchingEnabled; }
+
+        /*!
+        \brief Applies simulated network conditions to everything received
+        by the client once it has connected.
+        In debug builds clients are listed in the console by net_sim_list, as
+        client0, client1 etc, and the conditions can also be set with the
+        net_sim command. These commands don't exist in release builds.
+        \see NetConditions
+        */
+        void setConditions(const NetConditions& conditions);
+
+        /*!
+        \brief Returns the total data sent and received by the client since it was created
+        */
+        NetTrafficStats getTrafficStats() const;
+
     private:
 
         _ENetHost* m_client;
         NetPeer m_peer;
 
+        bool m_batchingEnabled;
+        std::unique_ptr<Detail::NetBatch> m_batch;
+        std::unique_ptr<Detail::NetDemux> m_demux;
+        std::unique_ptr<Detail::NetConditioner> m_conditioner;
+        void flushBatch();
+
         std::unique_ptr<std::thread> m_thread;
         std::mutex m_mutex;
         std::list<std::any> m_evtBuffer;
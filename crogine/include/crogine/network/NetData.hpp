@@ -34,6 +34,7 @@ source distribution.
 #include <crogine/detail/Types.hpp>
 
 #include <cstring>
+#include <functional>
 #include <string>
 
 struct _ENetPacket;
@@ -41,6 +42,11 @@ struct _ENetPeer;
 
 namespace cro
 {
+    namespace Detail
+    {
+        class NetDemux;
+    }
+
     /*!
     \brief A peer represents a single connection made up of multiple
     channels between a client and a host.
@@ -77,6 +83,8 @@ namespace cro
 
         friend class NetClient;
         friend class NetHost;
+        friend class Detail::NetDemux;
+        friend struct std::hash<NetPeer>;
     };
 
     /*!
@@ -135,10 +143,16 @@ namespace cro
         private:
             _ENetPacket* m_packet;
             std::uint8_t m_id;
+            //packets split from a batch share the
+            //ENet packet, so the data is a sub range
+            std::size_t m_offset;
+            std::size_t m_size;
             void setPacketData(_ENetPacket*);
+            void setPacketData(_ENetPacket*, std::uint8_t id, std::size_t offset, std::size_t size);
 
             friend class NetClient;
             friend class NetHost;
+            friend class Detail::NetDemux;
         }packet;
 
         /*!
@@ -159,4 +173,55 @@ namespace cro
         Unsequenced = 0x2, //! <packet will not be sequenced with other packets. Not supported on reliable packets
         Unreliable = 0x4 //! <packet will be fragments and sent unreliably if it exceeds MTU
     };
-}
\ No newline at end of file
+
+    /*!
+    \brief Simulated network conditions.
+    These can be applied to a NetHost or NetClient to test how a connection
+    behaves over a poor network. Conditions are applied to each datagram as
+    it is received, before it is processed by the network layer, so they
+    affect acknowledgements and resends of reliable packets as well as packet
+    data. To simulate a poor connection in both directions apply conditions
+    to both ends of the connection. In debug builds conditions can also be
+    set at run time with the net_sim console command.
+    */
+    struct CRO_EXPORT_API NetConditions final
+    {
+        std::uint32_t latency = 0; //! <milliseconds added to the arrival time of each datagram
+        std::uint32_t jitter = 0; //! <maximum milliseconds randomly added to or removed from the latency
+        float packetLoss = 0.f; //! <probability, from 0 to 1, that a datagram is dropped
+        float reorder = 0.f; //! <probability, from 0 to 1, that a datagram is held back long enough to arrive after later ones
+
+        bool enabled() const { return latency != 0 || jitter != 0 || packetLoss > 0.f || reorder > 0.f; }
+    };
+
+    /*!
+    \brief Raw traffic totals of a NetHost or NetClient, including
+    protocol overhead such as acknowledgements and resends. These
+    are counted from when the host was created and wrap on overflow.
+    */
+    struct CRO_EXPORT_API NetTrafficStats final
+    {
+        std::uint32_t bytesSent = 0;
+        std::uint32_t packetsSent = 0; //! <number of datagrams sent
+        std::uint32_t bytesReceived = 0;
+        std::uint32_t packetsReceived = 0; //! <number of datagrams received
+    };
+}
+
+/*!
+\brief Allows NetPeers to be used as keys in unordered containers.
+Unlike NetPeer::getID() the hash is still valid when the peer is
+received with a ClientDisconnect event, so it can be used to look
+up data belonging to a client which has disconnected.
+*/
+namespace std
+{
+    template <>
+    struct hash<cro::NetPeer>
+    {
+        std::size_t operator()(const cro::NetPeer& peer) const noexcept
+        {
+            return std::hash<const void*>()(peer.m_peer);
+        }
+    };
+}
@@ -33,7 +33,9 @@ source distribution.
 #include <crogine/detail/Types.hpp>
 #include <crogine/network/NetData.hpp>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 struct _ENetHost;
 
@@ -41,6 +43,13 @@ namespace cro
 {
     struct NetEvent;
     struct NetPeer;
+
+    namespace Detail
+    {
+        class NetBatch;
+        class NetConditioner;
+        class NetDemux;
+    }
     
     /*!
     \brief Creates a network host.
@@ -89,6 +98,17 @@ namespace cro
         */
         bool pollEvent(NetEvent&);
 
+        /*!
+        \brief Polls the connection for events, waiting up to the given
+        number of milliseconds for one to arrive.
+        Servers can use this in place of sleeping between updates, so
+        that they wake as soon as data is received rather than at the
+        end of the sleep. Pending data is sent before waiting.
+        \returns true if there is incoming data in the buffer, else false
+        if the timeout expired with no event received.
+        */
+        bool pollEvent(NetEvent&, std::uint32_t timeout);
+
         /*!
         \brief Broadcasts a packet to all connected clients.
         Note that all packets are queued until the next time pollEvent() is called.
@@ -164,9 +184,58 @@ namespace cro
         */
         void disconnectLater(NetPeer& peer);
 
+        /*!
+        \brief Enables or disables batching of outgoing packets.
+        When enabled, packets sent with sendPacket() or broadcastPacket() are
+        gathered per client, channel and NetFlag, and each group is sent as a
+        single packet the next time pollEvent() is called. This saves the
+        overhead of sending many small packets each frame. Receivers split
+        batches back into individual events so they need no changes to handle
+        them, although packets sent on the same channel with different NetFlags
+        may be delivered in a different order than they were sent.
+        Packet ID 255 is reserved for batches. Disabled by default.
+        */
+        void setBatchingEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if outgoing packets are batched
+        \see setBatchingEnabled()
+        */
+        bool getBatchingEnabled() const { return m_batchingEnabled; }
+
+        /*!
+        \brief Applies simulated network conditions to everything received by
+        this host from any peer which has no conditions of its own.
+        In debug builds hosts are listed in the console by net_sim_list, as
+        host0, host1 etc, and the conditions can also be set with the net_sim
+        command. These commands don't exist in release builds.
+        \see NetConditions
+        */
+        void setConditions(const NetConditions& conditions);
+
+        /*!
+        \brief Applies simulated network conditions to everything received by
+        this host from the given peer.
+        \see NetConditions
+        */
+        void setConditions(const NetPeer& peer, const NetConditions& conditions);
+
+        /*!
+        \brief Returns the total data sent and received by the host since it was started
+        */
+        NetTrafficStats getTrafficStats() const;
+
     private:
 
         _ENetHost* m_host;
+
+        bool m_batchingEnabled;
+        mutable std::vector<Detail::NetBatch> m_batches; //indexed by peer
+        std::unique_ptr<Detail::NetDemux> m_demux;
+        std::unique_ptr<Detail::NetConditioner> m_conditioner;
+
+        void queuePacket(_ENetPeer*, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel) const;
+        void flushBatches();
     };
 
 #include "NetHost.inl"
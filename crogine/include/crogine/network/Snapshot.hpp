@@ -0,0 +1,348 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Describes the quantised state of a single replicated entity.
+    Each field added to a schema describes a value, such as a position or
+    rotation, and how many bits it is quantised to when it is sent over the
+    network. The same schema must be used by both the SnapshotEncoder on the
+    server and the SnapshotDecoder on the client, and fields must be added
+    in the same order.
+    \see Snapshot
+    */
+    class CRO_EXPORT_API SnapshotSchema final
+    {
+    public:
+        /*!
+        \brief Adds a floating point value to the schema
+        \param min The smallest expected value. Smaller values are clamped.
+        \param max The largest expected value. Larger values are clamped.
+        \param bits The number of bits, from 1 to 32, with which to quantise
+        the value. The precision of the value is (max - min) / ((1 << bits) - 1)
+        \returns The index of the field, used to read and write its value
+        in a Snapshot
+        */
+        std::size_t addFloat(float min, float max, std::uint8_t bits);
+
+        /*!
+        \brief Adds a 3 component vector to the schema.
+        Each component is quantised individually, with the given number of
+        bits, between the corresponding components of min and max.
+        \returns The index of the field
+        \see addFloat()
+        */
+        std::size_t addVec3(glm::vec3 min, glm::vec3 max, std::uint8_t bits);
+
+        /*!
+        \brief Adds a rotation to the schema.
+        Rotations are sent as the three smallest components of the normalised
+        quaternion, each quantised to the given number of bits, plus the index
+        of the component which was dropped. 12 bits is comparable in precision
+        to Util::Net::compressQuat() in a little over half the space.
+        \returns The index of the field
+        */
+        std::size_t addQuat(std::uint8_t bits = 12);
+
+        /*!
+        \brief Adds an unsigned integer value to the schema.
+        \param bits The number of bits, from 1 to 32, used to send the value.
+        Values which do not fit in the given number of bits are truncated.
+        \returns The index of the field
+        */
+        std::size_t addUInt(std::uint8_t bits);
+
+        /*!
+        \brief Returns the number of fields in the schema
+        */
+        std::size_t getFieldCount() const { return m_fields.size(); }
+
+    private:
+        enum class FieldType
+        {
+            Float, Vec3, Quat, UInt
+        };
+
+        struct Field final
+        {
+            FieldType type = FieldType::UInt;
+            std::uint8_t bits = 0;
+            std::size_t channel = 0;
+            glm::vec3 min = glm::vec3(0.f);
+            glm::vec3 max = glm::vec3(0.f);
+        };
+        std::vector<Field> m_fields;
+
+        //each field is quantised into one or more
+        //channels which are delta encoded individually
+        std::vector<std::uint8_t> m_channelBits;
+
+        std::size_t addField(FieldType, std::uint8_t bits, std::size_t channelCount, glm::vec3 min, glm::vec3 max);
+
+        friend class Snapshot;
+        friend class SnapshotEncoder;
+        friend class SnapshotDecoder;
+    };
+
+    /*!
+    \brief Contains the state of a set of entities at a given point in time.
+    Snapshots are created by a SnapshotEncoder on the server, which fills
+    them with the current state of any replicated entities and delta encodes
+    them for each client against the last snapshot that client acknowledged.
+    Clients decode the data with a SnapshotDecoder to reconstruct the full
+    snapshot, and acknowledge it so that the server can use it as the baseline
+    for the next update.
+
+    Entities are identified by a unique ID, such as the server side entity
+    index, and values are read and written by the field index returned from
+    the SnapshotSchema. Values are quantised as soon as they are written, so
+    reading them back returns the value as the client will see it.
+    */
+    class CRO_EXPORT_API Snapshot final
+    {
+    public:
+        /*!
+        \brief Adds an entity with the given ID to the snapshot.
+        IDs must be unique within a single snapshot. All fields of the new
+        entity are initialised to zero.
+        \returns Index of the entity within the snapshot
+        */
+        std::size_t addEntity(std::uint32_t id);
+
+        /*!
+        \brief Returns the number of entities in the snapshot
+        */
+        std::size_t getEntityCount() const { return m_ids.size(); }
+
+        /*!
+        \brief Returns the ID of the entity at the given index
+        */
+        std::uint32_t getEntityID(std::size_t index) const { return m_ids[index]; }
+
+        /*!
+        \brief Returns the index of the entity with the given ID
+        or getEntityCount() if the entity isn't in the snapshot
+        */
+        std::size_t findEntity(std::uint32_t id) const;
+
+        /*!
+        \brief Sets the value of a field added with SnapshotSchema::addFloat()
+        \param index Index of the entity returned by addEntity()
+        \param field Index of the field returned by the schema
+        \param value The value to quantise
+        */
+        void setFloat(std::size_t index, std::size_t field, float value);
+
+        /*!
+        \brief Sets the value of a field added with SnapshotSchema::addVec3()
+        */
+        void setVec3(std::size_t index, std::size_t field, glm::vec3 value);
+
+        /*!
+        \brief Sets the value of a field added with SnapshotSchema::addQuat()
+        */
+        void setQuat(std::size_t index, std::size_t field, glm::quat value);
+
+        /*!
+        \brief Sets the value of a field added with SnapshotSchema::addUInt()
+        */
+        void setUInt(std::size_t index, std::size_t field, std::uint32_t value);
+
+        /*!
+        \brief Returns the dequantised value of the given float field
+        \param index Index of the entity in the snapshot
+        \param field Index of the field returned by the schema
+        */
+        float getFloat(std::size_t index, std::size_t field) const;
+
+        /*!
+        \brief Returns the dequantised value of the given vec3 field
+        */
+        glm::vec3 getVec3(std::size_t index, std::size_t field) const;
+
+        /*!
+        \brief Returns the dequantised, normalised value of the given quat field
+        */
+        glm::quat getQuat(std::size_t index, std::size_t field) const;
+
+        /*!
+        \brief Returns the value of the given uint field
+        */
+        std::uint32_t getUInt(std::size_t index, std::size_t field) const;
+
+        /*!
+        \brief Returns the timestamp with which the snapshot was created
+        */
+        std::int32_t getTimestamp() const { return m_timestamp; }
+
+        /*!
+        \brief Returns the sequence number of the snapshot.
+        Sequence numbers start at 1 and increase by one for every snapshot
+        committed by the SnapshotEncoder. A value of 0 is never valid.
+        */
+        std::uint32_t getSequence() const { return m_sequence; }
+
+    private:
+        std::shared_ptr<const SnapshotSchema> m_schema;
+        std::uint32_t m_sequence = 0;
+        std::int32_t m_timestamp = 0;
+
+        std::vector<std::uint32_t> m_ids;
+        std::vector<std::uint32_t> m_channels; //channel count * entity count
+
+        void clear();
+        void sort();
+        std::uint32_t* getChannels(std::size_t index, std::size_t field);
+        const std::uint32_t* getChannels(std::size_t index, std::size_t field) const;
+
+        friend class SnapshotEncoder;
+        friend class SnapshotDecoder;
+    };
+
+    /*!
+    \brief Creates and delta encodes snapshots on the server.
+    Each network tick call beginSnapshot(), add the state of all replicated
+    entities to the returned Snapshot, then call commit(). The committed
+    snapshot can then be encoded for each connected client with encode(),
+    passing the sequence number most recently acknowledged by that client.
+    Only values which have changed since the acknowledged snapshot are sent,
+    so the encoded data can be sent unreliably - lost or late snapshots are
+    simply superseded by the next one.
+
+    The encoder keeps a history of recent snapshots. If a client's last
+    acknowledgement is older than the history, or the client has not yet
+    acknowledged any snapshots, the full snapshot is sent instead.
+    */
+    class CRO_EXPORT_API SnapshotEncoder final
+    {
+    public:
+        /*!
+        \brief Constructor
+        \param schema Describes the fields of each entity in the snapshot
+        \param historySize Number of snapshots to keep as potential baselines.
+        This must be the same as the history size of the SnapshotDecoder.
+        */
+        explicit SnapshotEncoder(const SnapshotSchema& schema, std::size_t historySize = DefaultHistorySize);
+
+        /*!
+        \brief Clears the working snapshot and returns it to be filled
+        with the current state of replicated entities.
+        \param timestamp Server time at which this snapshot is taken
+        */
+        Snapshot& beginSnapshot(std::int32_t timestamp);
+
+        /*!
+        \brief Commits the current snapshot to the history, assigning it
+        the next sequence number.
+        \returns The sequence number of the committed snapshot
+        */
+        std::uint32_t commit();
+
+        /*!
+        \brief Encodes the most recently committed snapshot
+        \param ack The most recent sequence number acknowledged by the client
+        for whom the data is encoded, or 0 if the client has acknowledged nothing.
+        \param dst Vector to which the encoded data is written. Any existing
+        contents are replaced.
+        */
+        void encode(std::uint32_t ack, std::vector<std::uint8_t>& dst) const;
+
+        /*!
+        \brief Returns the most recently committed snapshot
+        */
+        const Snapshot& getSnapshot() const;
+
+        static constexpr std::size_t DefaultHistorySize = 32;
+
+    private:
+        std::shared_ptr<const SnapshotSchema> m_schema;
+        std::vector<Snapshot> m_history;
+        Snapshot m_workingSnapshot;
+        std::uint32_t m_sequence;
+    };
+
+    /*!
+    \brief Reconstructs snapshots on the client from data created by a SnapshotEncoder.
+    After successfully decoding a snapshot send the value returned by getSequence()
+    back to the server so that it can be used as the baseline for future updates.
+    */
+    class CRO_EXPORT_API SnapshotDecoder final
+    {
+    public:
+        /*!
+        \brief Constructor
+        \param schema Describes the fields of each entity. This must match
+        the schema used by the SnapshotEncoder.
+        \param historySize Number of snapshots to keep as potential baselines.
+        This must match the history size of the SnapshotEncoder.
+        */
+        explicit SnapshotDecoder(const SnapshotSchema& schema, std::size_t historySize = SnapshotEncoder::DefaultHistorySize);
+
+        /*!
+        \brief Decodes snapshot data received from the server
+        \returns true if a new snapshot was decoded, or false if the data was
+        malformed, refers to an unknown baseline, or is older than the current
+        snapshot. The current snapshot is unchanged if this returns false.
+        */
+        bool decode(const void* data, std::size_t size);
+
+        /*!
+        \brief Returns the most recently decoded snapshot
+        */
+        const Snapshot& getSnapshot() const;
+
+        /*!
+        \brief Returns the sequence number of the most recently decoded
+        snapshot, which should be acknowledged to the server. Returns 0
+        if no snapshots have been decoded yet.
+        */
+        std::uint32_t getSequence() const { return m_sequence; }
+
+        /*!
+        \brief Clears the history of received snapshots
+        */
+        void reset();
+
+    private:
+        std::shared_ptr<const SnapshotSchema> m_schema;
+        std::vector<Snapshot> m_history;
+        std::uint32_t m_sequence;
+    };
+}
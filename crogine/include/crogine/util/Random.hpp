@@ -35,6 +35,10 @@ source distribution.
 
 #include <random>
 #include <ctime>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <thread>
 
 namespace cro
 {
@@ -45,7 +49,79 @@ namespace cro
         */
         namespace Random
         {
-            static std::mt19937 rndEngine(static_cast<unsigned long>(std::time(nullptr)));
+            //each thread has its own engine so that the functions below
+            //can be used by threads running independently of each other,
+            //such as multiple game servers hosted by the same process
+            static thread_local std::mt19937 rndEngine(static_cast<unsigned long>(std::time(nullptr))
+                ^ static_cast<unsigned long>(std::hash<std::thread::id>()(std::this_thread::get_id())));
+
+            /*!
+            \brief Counter based pseudo random number generator.
+            Each value is a hash of the seed and an incrementing counter, so
+            generators are small and cheap to create, and share no state with
+            each other. Each object (or thread) can own its own instance so,
+            unlike the functions below which share one engine per thread, the
+            sequence doesn't depend on which thread the generator is used from.
+            Can also be used as the engine for std distributions.
+            */
+            class CounterEngine final
+            {
+            public:
+                using result_type = std::uint32_t;
+
+                explicit CounterEngine(std::uint64_t seed = 0)
+                    : m_seed(seed), m_counter(0) {}
+
+                /*!
+                \brief Resets the generator with the given seed
+                */
+                void seed(std::uint64_t seed)
+                {
+                    m_seed = seed;
+                    m_counter = 0;
+                }
+
+                /*!
+                \brief Returns the next pseudo random value
+                */
+                result_type operator()()
+                {
+                    //splitmix64 finaliser
+                    std::uint64_t z = m_seed + (++m_counter * 0x9E3779B97F4A7C15ull);
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                    return static_cast<result_type>((z ^ (z >> 31)) >> 32);
+                }
+
+                /*!
+                \brief Returns a pseudo random floating point value
+                in the range begin - end (exclusive)
+                */
+                float value(float begin, float end)
+                {
+                    CRO_ASSERT(begin < end, "first value is not less than last value");
+                    const float normalised = static_cast<float>((*this)() >> 8) * (1.f / 16777216.f);
+                    return begin + ((end - begin) * normalised);
+                }
+
+                /*!
+                \brief Returns a pseudo random integer value
+                in the range begin - end (inclusive)
+                */
+                int value(int begin, int end)
+                {
+                    CRO_ASSERT(begin < end, "first value is not less than last value");
+                    const auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(end) - begin) + 1;
+                    return begin + static_cast<int>((static_cast<std::uint64_t>((*this)()) * range) >> 32);
+                }
+
+                static constexpr result_type min() { return 0; }
+                static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+            private:
+                std::uint64_t m_seed;
+                std::uint64_t m_counter;
+            };
 
             /*!
             \brief Returns a pseudo random floating point value
@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "AudioFile.hpp"
+#include "WavLoader.hpp"
+#include "VorbisLoader.hpp"
+#include "Mp3Loader.hpp"
+
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/core/Log.hpp>
+
+using namespace cro;
+using namespace cro::Detail;
+
+std::unique_ptr<AudioFile> Detail::openAudioFile(const std::string& path)
+{
+    std::unique_ptr<AudioFile> loader;
+
+    auto ext = FileSystem::getFileExtension(path);
+    if (ext == ".wav")
+    {
+        loader = std::make_unique<WavLoader>();
+    }
+    else if (ext == ".ogg")
+    {
+        loader = std::make_unique<VorbisLoader>();
+    }
+    else if (ext == ".mp3")
+    {
+        loader = std::make_unique<Mp3Loader>();
+    }
+    else
+    {
+        Logger::log(ext + ": format not supported", Logger::Type::Error);
+        return nullptr;
+    }
+
+    if (!loader->open(path))
+    {
+        return nullptr;
+    }
+    return loader;
+}
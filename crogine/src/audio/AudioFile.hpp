@@ -33,6 +33,7 @@ source distribution.
 
 #include <crogine/core/Clock.hpp>
 
+#include <memory>
 #include <string>
 
 namespace cro
@@ -87,5 +88,14 @@ namespace cro
             */
             virtual std::uint64_t getSampleCount() const = 0;
         };
+
+        /*!
+        \brief Creates and opens the appropriate AudioFile for the given path,
+        based on the file extension.
+        \param path Absolute path to the file to open
+        \returns Open AudioFile, or nullptr if the format is not supported
+        or the file failed to open.
+        */
+        std::unique_ptr<AudioFile> openAudioFile(const std::string& path);
     }
 }
\ No newline at end of file
@@ -31,8 +31,11 @@ source distribution.
 #include <crogine/audio/AudioBuffer.hpp>
 #include <crogine/audio/AudioStream.hpp>
 #include <crogine/core/Log.hpp>
+#include <crogine/core/FileSystem.hpp>
 #include <crogine/detail/Assert.hpp>
 
+#include "AudioFile.hpp"
+
 #include <vector>
 
 using namespace cro;
@@ -43,12 +46,42 @@ namespace
 }
 
 AudioResource::AudioResource()
+    : m_asyncOwner(std::make_shared<AudioResource*>(this))
 {
     m_fallback = std::make_unique<AudioBuffer>();
     std::vector<std::uint8_t> data(10, 0);
     dynamic_cast<AudioBuffer*>(m_fallback.get())->loadFromMemory(data.data(), 8, 22500, false, 10);
 }
 
+AudioResource::AudioResource(AudioResource&& other) noexcept
+    : m_fallback    (std::move(other.m_fallback)),
+    m_sources       (std::move(other.m_sources)),
+    m_usedPaths     (std::move(other.m_usedPaths)),
+    m_asyncOwner    (std::move(other.m_asyncOwner)),
+    m_asyncHandles  (std::move(other.m_asyncHandles))
+{
+    *m_asyncOwner = this;
+    other.m_asyncOwner = std::make_shared<AudioResource*>(&other);
+}
+
+AudioResource& AudioResource::operator=(AudioResource&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_fallback = std::move(other.m_fallback);
+        m_sources = std::move(other.m_sources);
+        m_usedPaths = std::move(other.m_usedPaths);
+
+        //any uploads pending on this resource are abandoned
+        m_asyncOwner = std::move(other.m_asyncOwner);
+        m_asyncHandles = std::move(other.m_asyncHandles);
+        *m_asyncOwner = this;
+
+        other.m_asyncOwner = std::make_shared<AudioResource*>(&other);
+    }
+    return *this;
+}
+
 //public
 bool AudioResource::load(std::int32_t ID, const std::string& path, bool streaming)
 {
@@ -106,6 +139,73 @@ std::int32_t AudioResource::load(const std::string& path, bool streaming)
     return -1;
 }
 
+AsyncHandle AudioResource::loadAsync(std::int32_t ID, const std::string& path)
+{
+    if (m_sources.count(ID) > 0)
+    {
+        Logger::log("Data Source with ID " + std::to_string(ID) + " alread exists", Logger::Type::Error);
+        return AsyncHandle::fromResult(false);
+    }
+
+    if (m_asyncHandles.count(ID) > 0)
+    {
+        return m_asyncHandles.at(ID);
+    }
+
+    //keeps the decoded data alive until it has been uploaded
+    auto file = std::make_shared<std::unique_ptr<Detail::AudioFile>>();
+    auto data = std::make_shared<Detail::PCMData>();
+    std::weak_ptr<AudioResource*> owner = m_asyncOwner;
+
+    auto handle = AsyncLoader::submit(
+        [file, data, fullPath = FileSystem::getResourcePath() + path]()
+        {
+            *file = Detail::openAudioFile(fullPath);
+            if (*file)
+            {
+                *data = (*file)->getData();
+            }
+            return data->data != nullptr;
+        },
+        [file, data, owner, ID, path](bool decoded)
+        {
+            auto resource = owner.lock();
+            if (!resource)
+            {
+                return false;
+            }
+
+            auto& res = **resource;
+            res.m_asyncHandles.erase(ID);
+
+            if (!decoded
+                || res.m_sources.count(ID) > 0)
+            {
+                LogW << "Audio Resource: Failed loading " << path << std::endl;
+                return false;
+            }
+
+            const bool stereo = data->format == Detail::PCMData::Format::STEREO8
+                || data->format == Detail::PCMData::Format::STEREO16;
+            const std::uint8_t bitDepth = (data->format == Detail::PCMData::Format::MONO8
+                || data->format == Detail::PCMData::Format::STEREO8) ? 8 : 16;
+
+            auto buffer = std::make_unique<AudioBuffer>();
+            if (!buffer->loadFromMemory(data->data, bitDepth, data->frequency, stereo, data->size))
+            {
+                LogW << "Audio Resource: Failed loading " << path << std::endl;
+                return false;
+            }
+
+            res.m_sources.insert(std::make_pair(ID, std::move(buffer)));
+            res.m_usedPaths.insert(std::make_pair(path, ID));
+            return true;
+        });
+
+    m_asyncHandles.insert(std::make_pair(ID, handle));
+    return handle;
+}
+
 const AudioSource& AudioResource::get(std::int32_t id) const
 {
     if (m_sources.count(id) == 0) return *m_fallback;
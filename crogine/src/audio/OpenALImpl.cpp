@@ -192,37 +192,11 @@ std::int32_t OpenALImpl::requestNewBuffer(const std::string& filePath)
 {
     auto path = FileSystem::getResourcePath() + filePath;
 
-    std::unique_ptr<AudioFile> loader;
-    
-    auto ext = FileSystem::getFileExtension(path);
+    auto loader = openAudioFile(path);
     PCMData data;
-    if (ext == ".wav")
-    {      
-        loader = std::make_unique<WavLoader>();
-        if (loader->open(path))
-        {
-            data = loader->getData();
-        }
-    }
-    else if (ext == ".ogg")
-    {
-        loader = std::make_unique<VorbisLoader>();
-        if (loader->open(path))
-        {
-            data = loader->getData();
-        }
-    }
-    else if (ext == ".mp3")
-    {
-        loader = std::make_unique<Mp3Loader>();
-        if (loader->open(path))
-        {
-            data = loader->getData();
-        }
-    }
-    else
+    if (loader)
     {
-        Logger::log(ext + ": format not supported", Logger::Type::Error);
+        data = loader->getData();
     }
 
     if (data.data)
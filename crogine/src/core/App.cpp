@@ -53,6 +53,7 @@ static void winFPE(int)
 #endif
 
 #include <crogine/core/App.hpp>
+#include <crogine/core/AsyncLoader.hpp>
 #include <crogine/core/Log.hpp>
 #include <crogine/core/Window.hpp>
 #include <crogine/core/Console.hpp>
@@ -84,7 +85,6 @@ static void winFPE(int)
 #include "../detail/clipboard/clip.h"
 #endif
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "../detail/stb_image_write.h"
 
 
@@ -415,27 +415,26 @@ void App::run()
         Console::init();
 
         //add any 'built in' convars
-        Console::addConvar("drawDebugWindows",
-            "true",
+        auto drawDebugWindows = Console::registerConvar("drawDebugWindows",
+            true,
             "If true then any GuiClient windows registered with the isDebug flag will be drawn to the UI. Set with r_drawDebugWindows");
 
-        m_drawDebugWindows = Console::getConvarValue<bool>("drawDebugWindows");
+        m_drawDebugWindows = drawDebugWindows.get();
+        m_drawDebugWindowsConnection = drawDebugWindows.addCallback([&](bool b) { m_drawDebugWindows = b; });
 
         //set the drawDebugWindows flag
         Console::addCommand("r_drawDebugWindows",
-            [&](const std::string& param)
+            [drawDebugWindows](const std::string& param)
             {
                 if (param == "0")
                 {
-                    Console::setConvarValue("drawDebugWindows", false);
+                    drawDebugWindows.set(false);
                     Console::print("r_drawDebugWindows set to FALSE");
-                    m_drawDebugWindows = false;
                 }
                 else if (param == "1")
                 {
-                    Console::setConvarValue("drawDebugWindows", true);
+                    drawDebugWindows.set(true);
                     Console::print("r_drawDebugWindows set to TRUE");
-                    m_drawDebugWindows = true;
                 }
                 else
                 {
@@ -490,6 +489,7 @@ void App::run()
             timeSinceLastUpdate -= frameTime;
 
             Console::newFrame();
+            Logger::printConsoleLines();
 
             handleEvents();
             handleMessages();
@@ -501,6 +501,7 @@ void App::run()
 
         if (framesRendered++ < MaxFrames)
         {
+            AsyncLoader::update();
             doImGui();
 
             ImGui::Render();
@@ -513,9 +514,11 @@ void App::run()
 
     saveSettings();
 
+    m_drawDebugWindowsConnection.release();
     Console::finalise();
     m_messageBus.disable(); //prevents spamming a load of quit messages
     finalise();
+    AsyncLoader::shutdown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -0,0 +1,283 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/core/AsyncLoader.hpp>
+#include <crogine/core/ThreadPool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+using namespace cro;
+
+namespace
+{
+    struct Job final
+    {
+        std::promise<bool> promise;
+        AsyncLoader::DecodeFunc decode;
+        AsyncLoader::UploadFunc upload;
+        bool decoded = false;
+    };
+    using JobPtr = std::shared_ptr<Job>;
+
+    struct LoaderState final
+    {
+        std::mutex poolMutex;
+        std::unique_ptr<ThreadPool> pool;
+        std::atomic<bool> cancelled = false;
+
+        std::mutex uploadMutex;
+        std::condition_variable uploadCondition;
+        std::deque<JobPtr> uploads;
+
+        std::atomic<std::size_t> pendingCount = 0;
+        Time budget = milliseconds(4);
+    };
+
+    LoaderState& getState()
+    {
+        static LoaderState state;
+        return state;
+    }
+
+    ThreadPool& getPool()
+    {
+        auto& state = getState();
+        std::scoped_lock l(state.poolMutex);
+        if (!state.pool)
+        {
+            state.pool = std::make_unique<ThreadPool>();
+        }
+        return *state.pool;
+    }
+
+    void complete(Job& job, bool result)
+    {
+        auto& state = getState();
+        job.promise.set_value(result);
+
+        {
+            //under the lock so a waiting thread can't miss the final notification
+            std::scoped_lock l(state.uploadMutex);
+            state.pendingCount--;
+        }
+        state.uploadCondition.notify_all();
+    }
+
+    bool runUpload()
+    {
+        auto& state = getState();
+        JobPtr job;
+        {
+            std::scoped_lock l(state.uploadMutex);
+            if (state.uploads.empty())
+            {
+                return false;
+            }
+            job = std::move(state.uploads.front());
+            state.uploads.pop_front();
+        }
+
+        complete(*job, job->upload(job->decoded));
+        return true;
+    }
+
+    //processes an upload, helps with decoding or, if there is
+    //nothing to do, sleeps until a worker has queued an upload
+    void waitStep()
+    {
+        if (runUpload())
+        {
+            return;
+        }
+
+        auto& state = getState();
+        ThreadPool* pool = nullptr;
+        {
+            //the pool is only destroyed by shutdown() which is also
+            //called from the main thread, so it's safe to use unlocked
+            std::scoped_lock l(state.poolMutex);
+            pool = state.pool.get();
+        }
+        if (pool
+            && pool->runPendingTask())
+        {
+            return;
+        }
+
+        std::unique_lock l(state.uploadMutex);
+        state.uploadCondition.wait_for(l, std::chrono::milliseconds(2),
+            [&state]() { return !state.uploads.empty() || state.pendingCount == 0; });
+    }
+}
+
+bool AsyncHandle::valid() const
+{
+    return m_future.valid();
+}
+
+bool AsyncHandle::isReady() const
+{
+    return m_future.valid()
+        && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool AsyncHandle::succeeded() const
+{
+    return isReady() && m_future.get();
+}
+
+bool AsyncHandle::wait() const
+{
+    if (!m_future.valid())
+    {
+        return false;
+    }
+
+    while (!isReady())
+    {
+        waitStep();
+    }
+    return m_future.get();
+}
+
+AsyncHandle AsyncHandle::fromResult(bool result)
+{
+    std::promise<bool> promise;
+    promise.set_value(result);
+
+    AsyncHandle handle;
+    handle.m_future = promise.get_future().share();
+    return handle;
+}
+
+//public
+AsyncHandle AsyncLoader::submit(DecodeFunc decode, UploadFunc upload)
+{
+    auto job = std::make_shared<Job>();
+    job->decode = std::move(decode);
+    job->upload = std::move(upload);
+
+    AsyncHandle handle;
+    handle.m_future = job->promise.get_future().share();
+
+    getState().pendingCount++;
+    getPool().submit([job]()
+        {
+            auto& state = getState();
+            if (!state.cancelled
+                && job->decode)
+            {
+                job->decoded = job->decode();
+            }
+
+            if (job->upload)
+            {
+                {
+                    std::scoped_lock l(state.uploadMutex);
+                    state.uploads.push_back(job);
+                }
+                state.uploadCondition.notify_all();
+            }
+            else
+            {
+                complete(*job, job->decoded);
+            }
+        });
+
+    return handle;
+}
+
+void AsyncLoader::update()
+{
+    auto& state = getState();
+    const auto budget = std::chrono::milliseconds(state.budget.asMilliseconds());
+    const auto start = std::chrono::steady_clock::now();
+
+    while (runUpload()
+        && std::chrono::steady_clock::now() - start < budget) {}
+}
+
+void AsyncLoader::finish()
+{
+    while (getState().pendingCount != 0)
+    {
+        waitStep();
+    }
+}
+
+void AsyncLoader::setUploadBudget(Time budget)
+{
+    getState().budget = budget;
+}
+
+Time AsyncLoader::getUploadBudget()
+{
+    return getState().budget;
+}
+
+std::size_t AsyncLoader::getPendingCount()
+{
+    return getState().pendingCount;
+}
+
+std::size_t AsyncLoader::getThreadCount()
+{
+    return getPool().getThreadCount();
+}
+
+void AsyncLoader::shutdown()
+{
+    auto& state = getState();
+    state.cancelled = true;
+
+    {
+        //the pool drains its queues before joining, but with the cancel
+        //flag set the remaining jobs skip decoding and complete immediately
+        std::scoped_lock l(state.poolMutex);
+        state.pool.reset();
+    }
+
+    //uploads are dropped as the render context is about to go away
+    std::deque<JobPtr> uploads;
+    {
+        std::scoped_lock l(state.uploadMutex);
+        uploads.swap(state.uploads);
+    }
+    for (auto& job : uploads)
+    {
+        complete(*job, false);
+    }
+
+    state.cancelled = false;
+}
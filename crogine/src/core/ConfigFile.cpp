@@ -39,6 +39,8 @@ source distribution.
 
 #include <sstream>
 #include <algorithm>
+#include <functional>
+#include <string_view>
 
 using namespace cro;
 using json = nlohmann::json;
@@ -46,7 +48,151 @@ using json = nlohmann::json;
 namespace
 {
     const std::string indentBlock("    ");
-    std::size_t currentLine = 0;
+
+    std::size_t hashName(const std::string& name)
+    {
+        return std::hash<std::string>()(name);
+    }
+
+    //splits the loaded file into lines, stripping any carriage
+    //returns and tabs in place so no lines need to be copied
+    class LineReader final
+    {
+    public:
+        explicit LineReader(std::vector<char>& data)
+            : m_current(data.data()), m_end(data.data() + data.size()) {}
+
+        bool nextLine(std::string_view& line)
+        {
+            if (m_current == m_end)
+            {
+                return false;
+            }
+
+            auto* start = m_current;
+            auto* lineEnd = std::find(m_current, m_end, '\n');
+            m_current = (lineEnd == m_end) ? m_end : lineEnd + 1;
+
+            auto* out = start;
+            for (auto* c = start; c != lineEnd; ++c)
+            {
+                if (*c != '\r' && *c != '\t')
+                {
+                    *out++ = *c;
+                }
+            }
+            line = std::string_view(start, out - start);
+            m_lineNumber++;
+
+            return true;
+        }
+
+        std::size_t getLineNumber() const { return m_lineNumber; }
+
+    private:
+        char* m_current = nullptr;
+        char* m_end = nullptr;
+        std::size_t m_lineNumber = 0;
+    };
+
+    std::string_view removeComment(std::string_view line, std::size_t lineNumber)
+    {
+        //only crop comments outside of string literals - note this only
+        //tests the first '/' so unquoted paths don't get truncated
+        auto result = line.find('/');
+        if (result < line.size() - 1 && line[result + 1] == '/')
+        {
+            auto otherResult = line.find_last_of('\"');
+            if (otherResult == std::string_view::npos || result > otherResult)
+            {
+                line = line.substr(0, result);
+            }
+        }
+
+        //and preceding spaces
+        auto start = line.find_first_not_of(' ');
+        if (start != std::string_view::npos)
+        {
+            line = line.substr(start);
+        }
+
+        if (line.find(';') != std::string_view::npos)
+        {
+            LogW << "Line " << lineNumber << " contains semi-colon, is this intentional?" << std::endl;
+        }
+        return line;
+    }
+
+    bool isProperty(std::string_view line)
+    {
+        auto pos = line.find('=');
+        return(pos != std::string_view::npos && pos > 1 && line.length() > 5);
+    }
+
+    ConfigObject::NameValue getObjectName(std::string_view line)
+    {
+        auto result = line.find(' ');
+        if (result != std::string_view::npos)
+        {
+            auto first = line.substr(0, result);
+            auto second = line.substr(result + 1);
+            //make sure id has no spaces by truncating it
+            second = second.substr(0, second.find(' '));
+
+            return std::make_pair(std::string(first), std::string(second));
+        }
+        return std::make_pair(std::string(line), std::string());
+    }
+
+    //copies the view into the string skipping any instances of c
+    void copyWithout(std::string& dst, std::string_view src, char c)
+    {
+        dst.reserve(src.size());
+        for (auto s : src)
+        {
+            if (s != c)
+            {
+                dst.push_back(s);
+            }
+        }
+    }
+
+    ConfigObject::NameValue getPropertyName(std::string_view line)
+    {
+        auto result = line.find('=');
+        assert(result != std::string_view::npos);
+
+        ConfigObject::NameValue retVal;
+        copyWithout(retVal.first, line.substr(0, result), ' ');
+
+        auto second = line.substr(result + 1);
+
+        //check for string literal
+        result = second.find('\"');
+        if (result != std::string_view::npos)
+        {
+            auto otherResult = second.find_last_of('\"');
+            if (otherResult != result)
+            {
+                copyWithout(retVal.second, second.substr(result, otherResult), '\"');
+                if (!retVal.second.empty() && retVal.second[0] == '/')
+                {
+                    retVal.second.erase(0, 1);
+                }
+            }
+            else
+            {
+                Logger::log("String property \'" + retVal.first + "\' has missing \'\"\', value may not be as expected", Logger::Type::Warning);
+                retVal.second = std::string(second);
+            }
+        }
+        else
+        {
+            copyWithout(retVal.second, second, ' ');
+        }
+
+        return retVal;
+    }
 
     template <typename T>
     void addToObject(ConfigObject* dst, const std::string& key, json& value)
@@ -64,66 +210,78 @@ ConfigProperty::ConfigProperty(const std::string& name, const std::string& value
     m_isStringValue = !value.empty()
         && ((value.front() == '\"' && value.back() == '\"')
         || value.find(' ') != std::string::npos);
+
+    parseArray();
 }
 
 void ConfigProperty::setValue(const std::string& value)
 {
     m_value = value;
     m_isStringValue = true;
+    parseArray();
 }
 void ConfigProperty::setValue(const cro::String& value)
 {
     auto utf = value.toUtf8();
     m_value = std::string(utf.begin(), utf.end());
     m_isStringValue = true;
+    parseArray();
 }
 
 void ConfigProperty::setValue(std::int32_t value)
 {
     m_value = std::to_string(value);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(std::uint32_t value)
 {
     m_value = std::to_string(value);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(float value)
 {
     m_value = std::to_string(value);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(bool value)
 {
     m_value = (value) ? "true" : "false";
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(const glm::vec2& v)
 {
     m_value = std::to_string(v.x) + "," + std::to_string(v.y);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(const glm::vec3& v)
 {
     m_value = std::to_string(v.x) + "," + std::to_string(v.y) + "," + std::to_string(v.z);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(const glm::vec4& v)
 {
     m_value = std::to_string(v.x) + "," + std::to_string(v.y) + "," + std::to_string(v.z) + "," + std::to_string(v.w);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(const cro::FloatRect& r)
 {
     m_value = std::to_string(r.left) + "," + std::to_string(r.bottom) + "," + std::to_string(r.width) + "," + std::to_string(r.height);
     m_isStringValue = false;
+    parseArray();
 }
 
 void ConfigProperty::setValue(const cro::Colour& v)
@@ -132,32 +290,33 @@ void ConfigProperty::setValue(const cro::Colour& v)
     m_isStringValue = false;
 }
 
-std::vector<float> ConfigProperty::valueAsArray() const
+void ConfigProperty::parseArray()
 {
-    std::vector<float> retval;
-    std::size_t start = 0u;
-    std::size_t next = m_value.find_first_of(',');
-    std::size_t end = std::min(m_value.length(), std::size_t(200));
-
-    while (next != std::string::npos && start < end)
+    //as before, values are only read if there is at least one
+    //comma, and any missing or invalid values are zero
+    m_array = {};
+    if (m_value.find(',') == std::string::npos)
     {
-        float val;
-        std::istringstream is(m_value.substr(start, next));
-        if (is >> val) retval.push_back(val);
-        else retval.push_back(0.f);
-
-        start = ++next;
-        next = m_value.find_first_of(',', start);
-        if (next > m_value.length()) next = m_value.length();
+        return;
     }
-    
-    //pack out to max supported size
-    while (retval.size() < 4)
+
+    const std::size_t end = std::min(m_value.length(), std::size_t(200));
+    std::size_t start = 0u;
+    std::size_t i = 0u;
+    while (start < end && i < m_array.size())
     {
-        retval.push_back(0.f);
-    }
+        const char* str = m_value.c_str() + start;
+        char* last = nullptr;
+        auto val = std::strtof(str, &last);
+        m_array[i++] = (last == str || !std::isfinite(val)) ? 0.f : val;
 
-    return retval;
+        auto next = m_value.find(',', start);
+        if (next == std::string::npos)
+        {
+            break;
+        }
+        start = next + 1;
+    }
 }
 
 //-------------------------------------
@@ -168,198 +327,41 @@ ConfigObject::ConfigObject(const std::string& name, const std::string& id)
 bool ConfigObject::loadFromFile(const std::string& filePath, bool relative)
 {
     auto path = relative ? FileSystem::getResourcePath() + filePath : filePath;
-    currentLine = 0;
 
     m_id = "";
     setName("");
     m_properties.clear();
     m_objects.clear();
 
-    RaiiRWops rr;
-    rr.file = SDL_RWFromFile(path.c_str(), "r");
-
-    if (!rr.file)
-    {
-        Logger::log(path + " file invalid or not found.", Logger::Type::Warning);
-        return false;
-    }
-    
-    //fetch file size
-    auto fileSize = SDL_RWsize(rr.file);
-    if (fileSize == 0)
-    {
-        LOG(path + ": file empty", Logger::Type::Warning);
-        return false;
-    }
-
-    if (rr.file)
+    std::vector<char> data;
     {
-        if (cro::FileSystem::getFileExtension(path) == ".json")
-        {
-            return parseAsJson(rr.file);
-        }
-
-        //remove any opening comments
-        std::string data;
-        char* temp = nullptr;
-        std::int64_t readTotal = 0;
-        static constexpr std::int32_t DEST_SIZE = 1024;// 256;
-        char dest[DEST_SIZE];
-        while (data.empty() && readTotal < fileSize)
-        {
-            temp = Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal);
-
-            if (temp)
-            {
-                data = std::string(temp);
-                removeComment(data);
-            }
-            else
-            {
-                LogE << path << ": unexpected EOF" << std::endl;
-                return false;
-            }
-        }
-        //check config is not opened with a property
-        if (isProperty(data))
-        {
-            Logger::log(path + ": Cannot start configuration file with a property", Logger::Type::Error);
-            return false;
-        }
-        
-        //make sure next line is a brace to ensure we have an object
-        std::string lastLine = data;
+        RaiiRWops rr;
+        rr.file = SDL_RWFromFile(path.c_str(), "rb");
 
-        temp = Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal);
-        if (temp)
-        {
-            data = std::string(temp);
-            removeComment(data);
-        }
-        else
+        if (!rr.file)
         {
-            LogE << path << ": unexpected EOF" << std::endl;
+            Logger::log(path + " file invalid or not found.", Logger::Type::Warning);
             return false;
         }
 
-        //tracks brace balance
-        std::vector<ConfigObject*> objStack;
-
-        if (data[0] == '{')
+        //fetch file size
+        auto fileSize = SDL_RWsize(rr.file);
+        if (fileSize < 1)
         {
-            //we have our opening object
-            auto objectName = getObjectName(lastLine);
-            setName(objectName.first);
-            m_id = objectName.second;
-            
-            objStack.push_back(this);
-        }
-        else
-        {
-            Logger::log(path + " Invalid configuration header (missing '{' ?)", Logger::Type::Error);
+            LOG(path + ": file empty", Logger::Type::Warning);
             return false;
         }
 
+        //read the whole file in one go - the parser works on this in place
+        data.resize(static_cast<std::size_t>(fileSize));
+        data.resize(SDL_RWread(rr.file, data.data(), 1, data.size()));
+    }
 
-        while (readTotal < fileSize)
-        {
-            temp = Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal);
-            if (temp)
-            {
-                data = std::string(temp);
-                removeComment(data);
-            }
-            else
-            {
-                LogE << path << ": unexpected EOF" << std::endl;
-                return false;
-            }
-
-            if (!data.empty())
-            {
-                if (data[0] == '}')
-                {
-                    //close current object and move to parent
-                    objStack.pop_back();
-                }
-                else if (isProperty(data))
-                {           
-                    //insert name / value property into current object
-                    auto prop = getPropertyName(data);
-                    //TODO need to reinstate this and create a property
-                    //capable of storing arrays
-                    /*if (currentObject->findProperty(prop.first))
-                    {
-                        Logger::log("Property \'" + prop.first + "\' already exists in \'" + currentObject->getName() + "\', skipping entry...", Logger::Type::Warning);
-                        continue;
-                    }*/
-
-                    if (prop.second.empty())
-                    {
-                        Logger::log("\'" + objStack.back()->getName() + "\' property \'" + prop.first + "\' has no valid value", Logger::Type::Warning);
-                        continue;
-                    }
-                    objStack.back()->addProperty(prop.first, prop.second);
-                }
-                else
-                {
-                    //add a new object and make it current
-                    std::string prevLine = data;
-
-                    temp = Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal);
-                    if (temp)
-                    {
-                        data = std::string(temp);
-                        removeComment(data);
-                    }
-                    else
-                    {
-                        LogE << path << ": unexpected EOF" << std::endl;
-                        return false;
-                    }
-
-                    if (data[0] == '{')
-                    {
-                        //TODO we have to allow mutliple objects with the same name in this instance
-                        //as a model may have multiple material defs.
-                        auto name = getObjectName(prevLine);
-                        //if (name.second.empty() || objStack.back()->findObjectWithId(name.second) == nullptr)
-                        //{
-                        //    //safe to add new object as the name doesn't exist
-                        //    objStack.push_back(objStack.back()->addObject(name.first, name.second));
-                        //}
-                        //else
-                        //{
-                        //    Logger::log("Object with ID " + name.second + " has already been added, duplicate is skipped...", Logger::Type::Warning);
-
-                        //    //fast forward to closing brace
-                        //    while (data[0] != '}')
-                        //    {
-                        //        data = std::string(Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal));
-                        //        removeComment(data);
-                        //    }
-                        //}
-
-                        objStack.push_back(objStack.back()->addObject(name.first, name.second));
-                    }
-                    else //last line was probably garbage or nothing but spaces
-                    {
-                        //LogW << filePath << ": Missing line or incorrect syntax at " << currentLine << std::endl;
-                        continue;
-                    }
-                }
-            }       
-        }
-
-        if (!objStack.empty())
-        {
-            Logger::log("Brace count not at 0 after parsing \'" + path + "\'. Config data may not be correct.", Logger::Type::Warning);
-        }
-        return true;
+    if (cro::FileSystem::getFileExtension(path) == ".json")
+    {
+        return parseAsJson(data);
     }
-    
-    Logger::log(filePath + " file invalid or not found.", Logger::Type::Error);
-    return false;
+    return parse(data, path);
 }
 
 const std::string& ConfigObject::getId() const
@@ -369,24 +371,7 @@ const std::string& ConfigObject::getId() const
 
 ConfigProperty* ConfigObject::findProperty(const std::string& name) const
 {
-    auto result = std::find_if(m_properties.begin(), m_properties.end(),
-        [&name](const ConfigProperty& p)
-    {
-        return (p.getName() == name);
-    });
-
-    if (result != m_properties.end())
-    {
-        return const_cast<ConfigProperty*>(&*result);
-    }
-    //recurse
-    for (auto& o : m_objects)
-    {
-        auto p = o.findProperty(name);
-        if (p) return p;
-    }
-
-    return nullptr;
+    return findProperty(name, hashName(name));
 }
 
 ConfigObject* ConfigObject::findObjectWithId(const std::string& id) const
@@ -420,25 +405,7 @@ ConfigObject* ConfigObject::findObjectWithId(const std::string& id) const
 
 ConfigObject* ConfigObject::findObjectWithName(const std::string& name) const
 {
-    auto result = std::find_if(m_objects.begin(), m_objects.end(),
-        [&name](const ConfigObject& p)
-    {
-        return (p.getName() == name);
-    });
-
-    if (result != m_objects.end())
-    {
-        return const_cast<ConfigObject*>(&*result);
-    }
-
-    //recurse
-    for (auto& o : m_objects)
-    {
-        auto p = o.findObjectWithName(name);
-        if (p) return p;
-    }
-
-    return nullptr;
+    return findObjectWithName(name, hashName(name));
 }
 
 const std::vector<ConfigProperty>& ConfigObject::getProperties() const
@@ -511,163 +478,180 @@ ConfigObject ConfigObject::removeObject(const std::string& name)
     return {};
 }
 
-ConfigObject::NameValue ConfigObject::getObjectName(const std::string& line)
-{
-    auto result = line.find_first_of(' ');
-    if (result != std::string::npos)
-    {
-        std::string first = line.substr(0, result);
-        std::string second = line.substr(result + 1);
-        //make sure id has no spaces by truncating it
-        result = second.find_first_of(' ');
-        if (result != std::string::npos)
-            second = second.substr(0, result);
-
-        return std::make_pair(first, second);
-    }
-    return std::make_pair(line, "");
-}
-
-ConfigObject::NameValue ConfigObject::getPropertyName(const std::string& line)
-{
-    //cro::String cLine = cro::String::fromUtf8(line.begin(), line.end());
-    //auto result = cLine.find("=");
-    //auto firstArr = cLine.substr(0, result).toUtf8();
-    //firstArr.erase(std::remove(firstArr.begin(), firstArr.end(), ' '), firstArr.end());
-    //const std::string first = reinterpret_cast<const char*>(firstArr.c_str());
-
-    //auto secondArr = cLine.substr(result + 1).toUtf8();
-    //auto r1 = std::find(secondArr.begin(), secondArr.end(), '\"');
-    //if (r1 != secondArr.end())
-    //{
-    //    auto r2 = std::find(secondArr.rbegin(), secondArr.rend(), '\"');
-    //    if (r2 != secondArr.rend())
-    //    {
-    //        /*auto r2Pos = secondArr.rend() - r2 - 1;
-    //        std::basic_string<std::uint8_t> temp;
-    //        temp.resize(r2Pos - std::distance(secondArr.begin(), r1));
-    //        std::copy(r1, r1 + temp.size(), temp.begin());
-    //        secondArr.swap(temp);*/
-    //        secondArr.erase(std::remove(secondArr.begin(), secondArr.end(), '\"'), secondArr.end());
-
-    //    }
-    //    else
-    //    {
-    //        Logger::log("String property \'" + first + "\' has missing \'\"\', value may not be as expected", Logger::Type::Warning);
-    //    }
-    //}
-    //else
-    //{
-    //    secondArr.erase(std::remove(secondArr.begin(), secondArr.end(), ' '), secondArr.end());
-    //}
-    //std::string second;
-    //if (secondArr[0] == '/')
-    //{
-    //    second = reinterpret_cast<const char*>(&secondArr[1]);
-    //}
-    //else
-    //{
-    //    second = reinterpret_cast<const char*>(secondArr.c_str());
-    //}
-
-
-    auto result = line.find_first_of("=");
-    assert(result != std::string::npos);
-
-    std::string first = line.substr(0, result);
-    Util::String::removeChar(first, ' ');
-
-    std::string second = line.substr(result + 1);
-    
-    //check for string literal
-    result = second.find_first_of("\"");
-    if (result != std::string::npos)
+//private
+ConfigProperty* ConfigObject::findProperty(const std::string& name, std::size_t hash) const
+{
+    auto result = std::find_if(m_properties.begin(), m_properties.end(),
+        [&name, hash](const ConfigProperty& p)
     {
-        auto otherResult = second.find_last_of("\"");
-        if (otherResult != std::string::npos
-            && otherResult != result)
-        {
-            second = second.substr(result, otherResult);
-            Util::String::removeChar(second, '\"');
-            if (second[0] == '/') second = second.substr(1);
-        }
-        else
-        {
-            Logger::log("String property \'" + first + "\' has missing \'\"\', value may not be as expected", Logger::Type::Warning);
-        }
+        return (p.m_nameHash == hash && p.getName() == name);
+    });
+
+    if (result != m_properties.end())
+    {
+        return const_cast<ConfigProperty*>(&*result);
     }
-    else
+    //recurse
+    for (auto& o : m_objects)
     {
-        Util::String::removeChar(second, ' ');
+        auto p = o.findProperty(name, hash);
+        if (p) return p;
     }
 
-    return std::make_pair(first, second);
+    return nullptr;
 }
 
-bool ConfigObject::isProperty(const std::string& line)
+ConfigObject* ConfigObject::findObjectWithName(const std::string& name, std::size_t hash) const
 {
-    auto pos = line.find('=');
-    return(pos != std::string::npos && pos > 1 && line.length() > 5);
+    auto result = std::find_if(m_objects.begin(), m_objects.end(),
+        [&name, hash](const ConfigObject& p)
+    {
+        return (p.m_nameHash == hash && p.getName() == name);
+    });
+
+    if (result != m_objects.end())
+    {
+        return const_cast<ConfigObject*>(&*result);
+    }
+
+    //recurse
+    for (auto& o : m_objects)
+    {
+        auto p = o.findObjectWithName(name, hash);
+        if (p) return p;
+    }
+
+    return nullptr;
 }
 
-void ConfigObject::removeComment(std::string& line)
+bool ConfigObject::parse(std::vector<char>& data, const std::string& path)
 {
-    auto result = line.find_first_of("//");
+    LineReader reader(data);
+    std::string_view line;
 
-    //make sure to only crop comments outside of string literals
-    //for some reason it appears result also matches '/' so unquoted paths get truncated
-    if (result < line.size() - 1 && line[result + 1] == '/')
+    //remove any opening comments
+    std::string_view header;
+    while (header.empty())
     {
-        auto otherResult = line.find_last_of('\"');
-        if (result != std::string::npos && (result > otherResult || otherResult == std::string::npos))
+        if (!reader.nextLine(line))
         {
-            line = line.substr(0, result);
+            LogE << path << ": unexpected EOF" << std::endl;
+            return false;
         }
+        header = removeComment(line, reader.getLineNumber());
     }
 
-    //remove any tabs while we're at it
-    Util::String::removeChar(line, '\t');
-    //Util::String::removeChar(line, ' ');
-
-    //and preceding spaces
-    auto start = line.find_first_not_of(' ');
-    if (start != std::string::npos)
+    //check config is not opened with a property
+    if (isProperty(header))
     {
-        line = line.substr(start);
+        Logger::log(path + ": Cannot start configuration file with a property", Logger::Type::Error);
+        return false;
     }
 
-    if (line.find(';') != std::string::npos)
+    //make sure next line is a brace to ensure we have an object
+    if (!reader.nextLine(line))
     {
-        LogW << "Line " << currentLine << " contains semi-colon, is this intentional?" << std::endl;
+        LogE << path << ": unexpected EOF" << std::endl;
+        return false;
     }
-    currentLine++;
-}
+    line = removeComment(line, reader.getLineNumber());
 
-bool ConfigObject::parseAsJson(SDL_RWops* file)
-{
-    json j;
+    //tracks brace balance
+    std::vector<ConfigObject*> objStack;
 
+    if (!line.empty() && line[0] == '{')
     {
-        auto fileSize = SDL_RWsize(file);
-        std::vector<char> jsonData(fileSize);
-        SDL_RWread(file, jsonData.data(), fileSize, 1);
+        //we have our opening object
+        auto objectName = getObjectName(header);
+        setName(objectName.first);
+        m_id = objectName.second;
 
-        if (jsonData.empty())
+        objStack.push_back(this);
+    }
+    else
+    {
+        Logger::log(path + " Invalid configuration header (missing '{' ?)", Logger::Type::Error);
+        return false;
+    }
+
+    while (reader.nextLine(line))
+    {
+        line = removeComment(line, reader.getLineNumber());
+        if (line.empty())
         {
-            LogE << "no data was read from json file" << std::endl;
-            return false;
+            continue;
+        }
+
+        if (objStack.empty())
+        {
+            LogW << path << ": unexpected data after closing brace at line " << reader.getLineNumber() << ", skipping..." << std::endl;
+            break;
         }
-        jsonData.push_back(0);
 
-        try 
+        if (line[0] == '}')
         {
-            j = json::parse(jsonData.data());
+            //close current object and move to parent
+            objStack.pop_back();
         }
-        catch (...)
+        else if (isProperty(line))
         {
-            LogE << "Failed parsing json string" << std::endl;
-            return false;
+            //insert name / value property into current object
+            auto prop = getPropertyName(line);
+            if (prop.second.empty())
+            {
+                Logger::log("\'" + objStack.back()->getName() + "\' property \'" + prop.first + "\' has no valid value", Logger::Type::Warning);
+                continue;
+            }
+            objStack.back()->addProperty(prop.first, prop.second);
         }
+        else
+        {
+            //add a new object and make it current
+            auto prevLine = line;
+
+            if (!reader.nextLine(line))
+            {
+                LogE << path << ": unexpected EOF" << std::endl;
+                return false;
+            }
+            line = removeComment(line, reader.getLineNumber());
+
+            if (!line.empty() && line[0] == '{')
+            {
+                //multiple objects with the same name are allowed
+                //as a model may have multiple material defs.
+                auto name = getObjectName(prevLine);
+                objStack.push_back(objStack.back()->addObject(name.first, name.second));
+            }
+            //else last line was probably garbage or nothing but spaces
+        }
+    }
+
+    if (!objStack.empty())
+    {
+        Logger::log("Brace count not at 0 after parsing \'" + path + "\'. Config data may not be correct.", Logger::Type::Warning);
+    }
+    return true;
+}
+
+bool ConfigObject::parseAsJson(const std::vector<char>& data)
+{
+    json j;
+
+    if (data.empty())
+    {
+        LogE << "no data was read from json file" << std::endl;
+        return false;
+    }
+
+    try 
+    {
+        j = json::parse(data.begin(), data.end());
+    }
+    catch (...)
+    {
+        LogE << "Failed parsing json string" << std::endl;
+        return false;
     }
 
     std::vector<ConfigObject*> objStack;
@@ -838,7 +822,8 @@ std::size_t ConfigObject::write(SDL_RWops* file, std::uint16_t depth)
 //--------------------//
 ConfigItem::ConfigItem(const std::string& name)
     : m_parent  (nullptr),
-    m_name      (name){}
+    m_name      (name),
+    m_nameHash  (hashName(name)){}
 
 ConfigItem* ConfigItem::getParent() const
 {
@@ -858,4 +843,5 @@ void ConfigItem::setParent(ConfigItem* parent)
 void ConfigItem::setName(const std::string& name)
 {
     m_name = name;
+    m_nameHash = hashName(name);
 }
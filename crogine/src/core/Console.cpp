@@ -70,6 +70,30 @@ namespace
     ConfigFile convars;
     const std::string convarName("convars.cfg");
 
+    //typed convars, mapped by name for lookups from the console
+    std::unordered_map<std::string, std::unique_ptr<Detail::ConvarSlot>> convarSlots;
+
+    //creates the config object for a typed convar if it is missing,
+    //else updates the convar with the existing value
+    void syncConvarSlot(Detail::ConvarSlot& slot)
+    {
+        auto* obj = convars.findObjectWithName(slot.getName());
+        if (!obj)
+        {
+            obj = convars.addObject(slot.getName());
+            slot.write(obj->addProperty("value"));
+            obj->addProperty("help", slot.getHelp());
+        }
+        else if (auto* value = obj->findProperty("value"); value)
+        {
+            slot.read(*value);
+        }
+        else
+        {
+            slot.write(obj->addProperty("value"));
+        }
+    }
+
     const ImVec4 WarningColour(1.f, 0.6f, 0.f, 1.f);
     const ImVec4 ErrorColour(1.f, 0.f, 0.f, 1.f);
     const ImVec4 DefaultColour(1.f, 1.f, 1.f, 1.f);
@@ -164,7 +188,11 @@ void Console::doCommand(const std::string& str)
                 if (auto* value = convar->findProperty("value"); value)
                 {
                     value->setValue(params);
-                    
+                    if (auto slot = convarSlots.find(command); slot != convarSlots.end())
+                    {
+                        slot->second->read(*value);
+                    }
+
                     //raise a message pointing to convar so we can act on it if needed
                     auto* msg = App::getInstance().getMessageBus().post<Message::ConsoleEvent>(Message::ConsoleMessage);
                     msg->type = Message::ConsoleEvent::ConvarSet;
@@ -604,6 +632,13 @@ void Console::init()
 
     //loads any convars which may have been saved
     convars.loadFromFile(App::getPreferencePath() + convarName, false);
+
+    //loading replaces any existing objects, so make sure
+    //typed convars registered before now are restored
+    for (auto& [name, slot] : convarSlots)
+    {
+        syncConvarSlot(*slot);
+    }
     //TODO execute callback for each to make sure values are applied (? can always add a command which executes something while updating value)
 }
 
@@ -620,6 +655,37 @@ ConfigFile& Console::getConvars()
     return convars;
 }
 
+Detail::ConvarSlot* Console::findConvarSlot(const std::string& name)
+{
+    if (auto result = convarSlots.find(name); result != convarSlots.end())
+    {
+        return result->second.get();
+    }
+    return nullptr;
+}
+
+Detail::ConvarSlot* Console::insertConvarSlot(std::unique_ptr<Detail::ConvarSlot> slot)
+{
+    CRO_ASSERT(slot, "");
+    CRO_ASSERT(convarSlots.count(slot->getName()) == 0, "Convar already registered");
+
+    auto* ret = slot.get();
+    syncConvarSlot(*ret);
+    convarSlots.insert(std::make_pair(ret->getName(), std::move(slot)));
+    return ret;
+}
+
+void Console::writeConvarSlot(const Detail::ConvarSlot& slot)
+{
+    if (auto* obj = convars.findObjectWithName(slot.getName()); obj)
+    {
+        if (auto* value = obj->findProperty("value"); value)
+        {
+            slot.write(*value);
+        }
+    }
+}
+
 int textEditCallback(ImGuiInputTextCallbackData* data)
 {
     //use this to scroll up and down through command history
@@ -27,10 +27,12 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
-#ifndef __ANDROID__
+#if !defined(__ANDROID__) && !defined(CRO_HEADLESS)
 #include "tinyfiledialogs.h"
 #endif
+#ifndef CRO_HEADLESS
 #include <crogine/core/App.hpp>
+#endif
 #include <crogine/core/FileSystem.hpp>
 #include <crogine/core/Log.hpp>
 
@@ -77,6 +79,7 @@ source distribution.
 
 #endif //_WIN32
 
+#ifndef CRO_HEADLESS
 namespace
 {
     std::vector<std::string> parseFileFilter(const std::string& filter)
@@ -92,6 +95,7 @@ namespace
         return retVal;
     }
 }
+#endif
 
 using namespace cro;
 
@@ -392,7 +396,13 @@ std::string FileSystem::getRelativePath(std::string path, const std::string& roo
 
 std::string FileSystem::getConfigDirectory(const std::string&/* appName*/)
 {
+#ifdef CRO_HEADLESS
+    //headless builds have no App to create a preference
+    //path so use the working directory instead
+    return getCurrentDirectory() + "/";
+#else
     return cro::App::getPreferencePath();
+#endif
 
     //this is all deprecated.
 //
@@ -504,7 +514,7 @@ std::string FileSystem::getConfigDirectory(const std::string&/* appName*/)
 
 std::string FileSystem::openFileDialogue(const std::string& defaultDir, const std::string& filter, bool selectMultiple)
 {
-#ifdef __ANDROID__
+#if defined(__ANDROID__) || defined(CRO_HEADLESS)
     Logger::log("File Dialogues are not supported", Logger::Type::Error);
     return {};
 #else
@@ -525,7 +535,7 @@ std::string FileSystem::openFileDialogue(const std::string& defaultDir, const st
 
 std::string FileSystem::openFolderDialogue(const std::string& defPath)
 {
-#ifdef __ANDROID__
+#if defined(__ANDROID__) || defined(CRO_HEADLESS)
     Logger::log("File Dialogues are not supported", Logger::Type::Error);
     return {};
 #else
@@ -536,7 +546,7 @@ std::string FileSystem::openFolderDialogue(const std::string& defPath)
 
 std::string FileSystem::saveFileDialogue(const std::string& defaultDir, const std::string& filter)
 {
-#ifdef __ANDROID__
+#if defined(__ANDROID__) || defined(CRO_HEADLESS)
     Logger::log("File Dialogues are not supported", Logger::Type::Error);
     return {};
 #else
@@ -596,6 +606,11 @@ void FileSystem::setResourceDirectory(const std::string& path)
 
 bool FileSystem::showMessageBox(const std::string& title, const std::string& message, ButtonType buttonType, IconType iconType)
 {
+#ifdef CRO_HEADLESS
+    //there's nobody to answer a message box so log it instead
+    LogW << title << ": " << message << std::endl;
+    return false;
+#else
     std::string button;
     switch (buttonType)
     {
@@ -633,10 +648,14 @@ bool FileSystem::showMessageBox(const std::string& title, const std::string& mes
     }
 
     return tinyfd_messageBox(title.c_str(), message.c_str(), button.c_str(), icon.c_str(), 0) != 0;
+#endif
 }
 
 void FileSystem::showNotification(const std::string& title, const std::string& message, IconType iconType)
 {
+#ifdef CRO_HEADLESS
+    LogI << title << ": " << message << std::endl;
+#else
     std::string icon;
     switch (iconType)
     {
@@ -655,6 +674,7 @@ void FileSystem::showNotification(const std::string& title, const std::string& m
     }
 
     tinyfd_notifyPopup(title.c_str(), message.c_str(), icon.c_str());
+#endif
 }
 
 //private
@@ -28,88 +28,430 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/core/Log.hpp>
-#include <crogine/core/App.hpp>
-#include <crogine/core/Console.hpp>
 #include <crogine/core/String.hpp>
 #include <crogine/core/SysTime.hpp>
 #include <crogine/detail/Types.hpp>
 
+#ifndef CRO_HEADLESS
+#include <crogine/core/App.hpp>
+#include <crogine/core/Console.hpp>
+#endif
+
 #include <SDL_log.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 using namespace cro;
 
-std::list<std::string> Logger::m_buffer;
-std::string Logger::m_output;
-
-void Logger::log(const std::string& message, Type type, Output output)
+namespace
 {
-    std::string outstring;
-    switch (type)
-    {
-    case Type::Info:
-    default:
-        outstring = "INFO: " + message;
-        break;
-    case Type::Error:
-        outstring = "ERROR: " + message;
-        output = Output::All;
-        break;
-    case Type::Warning:
-        outstring = "WARNING: " + message;
-        break;
+    std::atomic<Logger::Type> logLevel = Logger::Type::Info;
+
+    const std::string& getPrefix(Logger::Type type)
+    {
+        static const std::array<std::string, 3u> Prefixes =
+        {
+            "INFO: ", "WARNING: ", "ERROR: "
+        };
+        return Prefixes[static_cast<std::size_t>(type)];
     }
-#ifndef __ANDROID__
-    if (output == Output::Console || output == Output::All)
+
+    struct LogLine final
+    {
+        LogLine* next = nullptr;
+
+        Logger::Type type = Logger::Type::Info;
+        Logger::Output output = Logger::Output::Console;
+        bool streamed = false; //streamed lines are written directly to stdout
+        std::string text; //includes the prefix
+        std::string filePath; //set if output includes File
+    };
+
+    //lock-free multiple producer single consumer queue. Producers push
+    //onto the front of a list, and the consumer takes the entire list
+    //at once and reverses it, so there is no ABA problem on pop.
+    class LineQueue final
     {
-        switch (type)
+    public:
+        ~LineQueue()
         {
-        default:
-        case Type::Info:
-            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%s", message.c_str());
-            break;
-        case Type::Warning:
-            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s", message.c_str());
-            break;
-        case Type::Error:
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", message.c_str());
-            break;
+            auto* line = takeAll();
+            while (line)
+            {
+                auto* next = line->next;
+                delete line;
+                line = next;
+            }
         }
 
-        Console::print(outstring);
+        void push(LogLine* line)
+        {
+            line->next = m_head.load(std::memory_order_relaxed);
+            while (!m_head.compare_exchange_weak(line->next, line, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
 
-        const std::size_t maxBuffer = 30;
-        m_buffer.push_back(outstring);
-        if (m_buffer.size() > maxBuffer) m_buffer.pop_front();
-        updateOutString(maxBuffer);
+        //returns the queued lines in the order they were pushed
+        LogLine* takeAll()
+        {
+            auto* line = m_head.exchange(nullptr, std::memory_order_acquire);
+
+            LogLine* reversed = nullptr;
+            while (line)
+            {
+                auto* next = line->next;
+                line->next = reversed;
+                reversed = line;
+                line = next;
+            }
+            return reversed;
+        }
 
-#ifdef _MSC_VER
-        outstring += "\n";
-        OutputDebugStringA(outstring.c_str());
-#endif //_MSC_VER
-    }
-    if (output == Output::File || output == Output::All)
+        bool empty() const { return m_head.load(std::memory_order_relaxed) == nullptr; }
+
+    private:
+        std::atomic<LogLine*> m_head = nullptr;
+    };
+
+    //limits how often each distinct line is written. The first few
+    //occurrences of a line in each window are accepted and any more
+    //are counted, then reported when the window is expired.
+    class RateLimiter final
     {
-        //output to a log file
-        RaiiRWops file;
-        auto logPath = cro::App::getPreferencePath() + "output.log";
-        file.file = SDL_RWFromFile(logPath.c_str(), "a");
-        if (file.file)
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        bool accept(const LogLine& line, Clock::time_point now)
+        {
+            auto& entry = m_entries[std::hash<std::string>()(line.text)];
+            if (entry.count == 0)
+            {
+                entry.line.type = line.type;
+                entry.line.output = line.output;
+                entry.line.streamed = line.streamed;
+                entry.line.text = line.text;
+                entry.line.filePath = line.filePath;
+                entry.windowStart = now;
+            }
+            else if (entry.line.text != line.text)
+            {
+                //hash collision, don't limit either
+                return true;
+            }
+
+            if (entry.count++ < MaxPerWindow)
+            {
+                return true;
+            }
+            entry.suppressed++;
+            return false;
+        }
+
+        //removes lines whose window has passed, calling func with a
+        //summary line for each one which had repeats suppressed
+        template <typename Func>
+        void expire(Clock::time_point now, Func&& func)
         {
-            auto timeStamp = SysTime::timeString();
-            timeStamp += " - ";
-            timeStamp += SysTime::dateString();
-            timeStamp += ": ";
+            for (auto it = m_entries.begin(); it != m_entries.end();)
+            {
+                if (now == Clock::time_point::max()
+                    || now - it->second.windowStart >= Window)
+                {
+                    if (it->second.suppressed)
+                    {
+                        auto& summary = it->second.line;
+                        summary.text += " (repeated " + std::to_string(it->second.suppressed) + " more times)";
+                        func(summary);
+                    }
+                    it = m_entries.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
 
-            SDL_RWwrite(file.file, timeStamp.c_str(), 1, timeStamp.size());
-            SDL_RWwrite(file.file, outstring.c_str(), 1, outstring.size());
+        //reports all suppressed repeats regardless of their window
+        template <typename Func>
+        void expireAll(Func&& func)
+        {
+            expire(Clock::time_point::max(), std::forward<Func>(func));
         }
-        else
+
+    private:
+        static constexpr std::size_t MaxPerWindow = 5;
+        static constexpr Clock::duration Window = std::chrono::seconds(1);
+
+        struct Entry final
+        {
+            LogLine line;
+            Clock::time_point windowStart;
+            std::size_t count = 0;
+            std::size_t suppressed = 0;
+        };
+        std::unordered_map<std::size_t, Entry> m_entries;
+    };
+
+    //writes queued lines to stdout and the log file on a background thread
+    class LogWriter final
+    {
+    public:
+        LogWriter()
+            : m_running(true)
         {
-            log(message, type, Output::Console);
-            log("Above message was intended for log file. Opening file probably failed.", Type::Warning, Output::Console);
+            m_thread = std::thread(&LogWriter::threadFunc, this);
+        }
+
+        ~LogWriter()
+        {
+            m_running = false;
+            m_condition.notify_one();
+            m_thread.join();
+        }
+
+        LogWriter(const LogWriter&) = delete;
+        LogWriter& operator = (const LogWriter&) = delete;
+
+        void push(LogLine* line)
+        {
+            m_fileQueue.push(line);
+            m_condition.notify_one();
+        }
+
+        //writes everything queued so far on the calling thread
+        void flush()
+        {
+            std::scoped_lock lock(m_writeMutex);
+            writeLines();
+
+            //SDL_RWops can't be flushed, but closing it writes any
+            //buffered data. It's reopened by the next line written.
+            m_file.close();
+            std::fflush(stdout);
+        }
+
+#ifndef CRO_HEADLESS
+        void printConsoleLines()
+        {
+            auto* line = m_consoleQueue.takeAll();
+            while (line)
+            {
+                m_consoleCount--;
+                Console::print(line->text);
+
+                auto* next = line->next;
+                delete line;
+                line = next;
+            }
+
+            if (auto dropped = m_droppedConsoleLines.exchange(0); dropped != 0)
+            {
+                Console::print("(" + std::to_string(dropped) + " lines dropped)");
+            }
+        }
+#endif
+
+    private:
+        static constexpr std::size_t MaxConsoleLines = 1024;
+
+        LineQueue m_fileQueue;
+        LineQueue m_consoleQueue;
+        std::atomic<std::size_t> m_consoleCount = 0;
+        std::atomic<std::size_t> m_droppedConsoleLines = 0;
+
+        std::atomic_bool m_running;
+        std::mutex m_mutex;
+        std::mutex m_writeMutex; //held while taking and writing lines, so flush() can write from other threads
+        std::condition_variable m_condition;
+        std::thread m_thread;
+
+        //only accessed by the writer thread
+        RateLimiter m_rateLimiter;
+        RateLimiter::Clock::time_point m_lastExpiry;
+        RaiiRWops m_file;
+        std::string m_filePath;
+
+        void threadFunc()
+        {
+            //producers don't lock the mutex when notifying, so the
+            //timeout catches any notification missed between checking
+            //the queue and waiting on it.
+            while (m_running)
+            {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_condition.wait_for(lock, std::chrono::milliseconds(100),
+                        [&]() { return !m_fileQueue.empty() || !m_running; });
+                }
+
+                std::scoped_lock lock(m_writeMutex);
+                writeLines();
+            }
+
+            std::scoped_lock lock(m_writeMutex);
+            writeLines();
+            m_rateLimiter.expireAll([&](const LogLine& summary) { output(summary); });
+        }
+
+        void writeLines()
+        {
+            //checked periodically rather than per line, so the
+            //number of distinct lines doesn't slow down spam
+            const auto now = RateLimiter::Clock::now();
+            if (now - m_lastExpiry >= std::chrono::milliseconds(100))
+            {
+                m_rateLimiter.expire(now, [&](const LogLine& summary) { output(summary); });
+                m_lastExpiry = now;
+            }
+
+            auto* line = m_fileQueue.takeAll();
+            while (line)
+            {
+                if (m_rateLimiter.accept(*line, now))
+                {
+                    output(*line);
+                }
+
+                auto* next = line->next;
+                delete line;
+                line = next;
+            }
+        }
+
+        void output(const LogLine& line)
+        {
+#ifndef CRO_HEADLESS
+            //the Console isn't thread safe and posts messages
+            //to the App, so these lines are printed by the main thread
+            if (line.output != Logger::Output::File)
+            {
+                //if the App isn't running anything to read these, or too
+                //much is logged in one frame, stop the queue growing
+                if (m_consoleCount < MaxConsoleLines)
+                {
+                    m_consoleCount++;
+
+                    auto* consoleLine = new LogLine();
+                    consoleLine->text = line.text;
+                    m_consoleQueue.push(consoleLine);
+                }
+                else
+                {
+                    m_droppedConsoleLines++;
+                }
+            }
+#endif
+            write(line);
+        }
+
+        void write(const LogLine& line)
+        {
+            if (line.output != Logger::Output::File)
+            {
+                if (line.streamed)
+                {
+                    std::fwrite(line.text.data(), 1, line.text.size(), stdout);
+                    std::fputc('\n', stdout);
+                    std::fflush(stdout);
+                }
+                else
+                {
+                    //SDL adds its own prefix
+                    const char* message = line.text.c_str() + getPrefix(line.type).size();
+                    switch (line.type)
+                    {
+                    default:
+                    case Logger::Type::Info:
+                        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%s", message);
+                        break;
+                    case Logger::Type::Warning:
+                        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s", message);
+                        break;
+                    case Logger::Type::Error:
+                        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", message);
+                        break;
+                    }
+                }
+
+#ifdef _MSC_VER
+                auto outstring = line.text + "\n";
+                OutputDebugStringA(outstring.c_str());
+#endif //_MSC_VER
+            }
+
+            if (line.output != Logger::Output::Console)
+            {
+                //the pref path may change if the App strings are updated
+                if (!m_file.file || line.filePath != m_filePath)
+                {
+                    m_file.close();
+                    m_filePath = line.filePath;
+                    m_file.file = SDL_RWFromFile(m_filePath.c_str(), "a");
+                }
+
+                if (m_file.file)
+                {
+                    auto timeStamp = SysTime::timeString();
+                    timeStamp += " - ";
+                    timeStamp += SysTime::dateString();
+                    timeStamp += ": ";
+
+                    SDL_RWwrite(m_file.file, timeStamp.c_str(), 1, timeStamp.size());
+                    SDL_RWwrite(m_file.file, line.text.c_str(), 1, line.text.size());
+                    SDL_RWwrite(m_file.file, "\n", 1, 1);
+                }
+                else
+                {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s", line.text.c_str());
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Above message was intended for log file. Opening file probably failed.");
+                }
+            }
         }
+    };
+
+    LogWriter& getWriter()
+    {
+        static LogWriter writer;
+        return writer;
+    }
+}
+
+void Logger::log(const std::string& message, Type type, Output output)
+{
+    if (static_cast<std::int32_t>(type) < CRO_LOG_LEVEL
+        || type < logLevel)
+    {
+        return;
+    }
+
+#ifndef __ANDROID__
+    auto* line = new LogLine();
+    line->type = type;
+    line->output = type == Type::Error ? Output::All : output;
+    line->text = getPrefix(type) + message;
+
+    if (line->output != Output::Console)
+    {
+#ifdef CRO_HEADLESS
+        //there's no App to supply a preference path
+        line->filePath = "output.log";
+#else
+        line->filePath = App::getPreferencePath() + "output.log";
+#endif
+    }
+
+    getWriter().push(line);
+
+    if (type == Type::Error)
+    {
+        getWriter().flush();
     }
 #else
     //use logcat - technically SDL will log successfully on android too
@@ -120,36 +462,45 @@ void Logger::log(const std::string& message, Type type, Output output)
 
 std::ostream& Logger::log(Logger::Type type)
 {
-    static cro::Detail::LogStream stream;
-    switch (type)
-    {
-    default:
-    case Type::Info:
-        stream << "INFO: ";
-        break;
-    case Type::Warning:
-        stream << "WARNING: ";
-        break;
-    case Type::Error:
-        stream << "ERROR: ";
-        break;
+    static thread_local cro::Detail::LogStream stream;
+    static thread_local std::ostream nullStream(nullptr);
+
+    if (type < logLevel)
+    {
+        return nullStream;
     }
+
+    //anything written without a new line is
+    //output before starting the next message
+    stream.flushLine();
+    stream.setType(type);
+    stream << getPrefix(type);
     return stream;
 }
 
-//private
-void Logger::updateOutString(std::size_t maxBuffer)
+void Logger::setLogLevel(Type type)
 {
-    static size_t count = 0;
-    m_output.append(m_buffer.back());
-    m_output.append("\n");
-    count++;
+    logLevel = type;
+}
 
-    if (count > maxBuffer)
-    {
-        m_output = m_output.substr(m_output.find_first_of('\n') + 1, m_output.size());
-        count--;
-    }
+Logger::Type Logger::getLogLevel()
+{
+    return logLevel;
+}
+
+void Logger::flush()
+{
+#ifndef __ANDROID__
+    getWriter().flush();
+#endif
+}
+
+//private
+void Logger::printConsoleLines()
+{
+#if !defined(__ANDROID__) && !defined(CRO_HEADLESS)
+    getWriter().printConsoleLines();
+#endif
 }
 
 using namespace Detail;
@@ -163,10 +514,19 @@ LogBuf::LogBuf()
 
 LogBuf::~LogBuf()
 {
-    sync();
+    flushLine();
     delete[] pbase();
 }
 
+void LogBuf::flushLine()
+{
+    sync();
+    if (!m_line.empty())
+    {
+        queueLine();
+    }
+}
+
 //private
 int LogBuf::overflow(int character)
 {
@@ -189,38 +549,43 @@ int LogBuf::overflow(int character)
 
 int LogBuf::sync()
 {
-    if (pbase() != pptr())
+    //append the contents of the write buffer to the
+    //current line, queuing each line as it's completed
+    for (auto* c = pbase(); c != pptr(); ++c)
     {
-        //print the contents of the write buffer into the logger
-        std::size_t size = static_cast<int>(pptr() - pbase());
-
-        std::stringstream ss; //TODO this should be a member to buffer truncated messages between flushes
-        ss.write(pbase(), size);
-
-        std::string outline;
-        while (std::getline(ss, outline))
+        if (*c == '\n')
         {
-            outline += '\n';
-            Console::print(outline);
-            std::fwrite(outline.data(), 1, outline.size(), stdout);
-
-#ifdef __ANDROID__
-            //use logcat
-            __android_log_print(ANDROID_LOG_VERBOSE, "CroApp", outline.c_str(), 1);
-#endif //__ANDROID__
-
-#ifdef _MSC_VER
-            outline += "\n";
-            OutputDebugStringA(outline.c_str());
-#endif //_MSC_VER
+            queueLine();
+        }
+        else
+        {
+            m_line.push_back(*c);
         }
-
-        setp(pbase(), epptr());
     }
+    setp(pbase(), epptr());
 
     return 0;
 }
 
+void LogBuf::queueLine()
+{
+#ifdef __ANDROID__
+    //use logcat
+    __android_log_print(ANDROID_LOG_VERBOSE, "CroApp", m_line.c_str(), 1);
+#else
+    auto* line = new LogLine();
+    line->streamed = true;
+    line->text.swap(m_line);
+    getWriter().push(line);
+
+    if (m_type == Logger::Type::Error)
+    {
+        getWriter().flush();
+    }
+#endif //__ANDROID__
+    m_line.clear();
+}
+
 //output stream
 LogStream::LogStream()
     : m_buffer  (),
@@ -229,6 +594,11 @@ LogStream::LogStream()
 
 }
 
+void LogStream::flushLine()
+{
+    m_buffer.flushLine();
+}
+
 //operator overloads
 //std::ostream& operator << (std::ostream& out, const cro::String& str)
 //{
@@ -29,30 +29,73 @@ source distribution.
 
 #include <crogine/core/MessageBus.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 using namespace cro;
 
 namespace
 {
-    //max msg size is 128 bytes, so 128 messages
-    //maximum per frame is 16384 bytes
-    const std::size_t bufferSize = 16384u;
+    std::atomic<std::uint64_t> busCount = 0;
+
+    constexpr std::size_t alignUp(std::size_t size)
+    {
+        constexpr auto Alignment = alignof(std::max_align_t);
+        return ((size + Alignment - 1) / Alignment) * Alignment;
+    }
+
+    //message data is placed directly after the message header
+    constexpr std::size_t HeaderSize = alignUp(sizeof(Message));
+
+    //caches the lanes this thread last posted to, so that the
+    //lane list only needs to be searched the first time a thread
+    //posts to a bus, or when posting to more than Size buses
+    struct LaneCache final
+    {
+        static constexpr std::size_t Size = 4;
+        struct Entry final
+        {
+            std::uint64_t busID = 0;
+            void* lane = nullptr;
+        };
+        std::array<Entry, Size> entries = {};
+        std::size_t nextEntry = 0;
+    };
+    thread_local LaneCache laneCache;
+
+    //lanes hold a weak reference to this so that buses can tell
+    //when the owning thread has exited. It's kept apart from the
+    //cache, which is trivial, so reading the cache needs no guard
+    thread_local std::shared_ptr<int> laneOwner;
 }
 
 MessageBus::MessageBus()
-    : m_currentBuffer   (bufferSize),
-    m_pendingBuffer     (bufferSize),
-    m_inPointer         (m_pendingBuffer.data()),
-    m_outPointer        (m_currentBuffer.data()),
+    : m_uid             (++busCount),
+    m_readLane          (0),
+    m_readPage          (0),
+    m_readOffset        (0),
     m_currentCount      (0),
-    m_pendingCount      (0),
     m_enabled           (true)
 {}
 
 const Message& MessageBus::poll()
 {
-    static constexpr auto size = sizeof(Message);
-    const Message& m = *reinterpret_cast<Message*>(m_outPointer);
-    m_outPointer += (size + m.m_dataSize);
+    CRO_ASSERT(m_currentCount, "No messages to read");
+
+    //skip to the next page with unread messages
+    while (m_readOffset == m_lanes[m_readLane]->current[m_readPage]->used)
+    {
+        m_readOffset = 0;
+        if (++m_readPage == m_lanes[m_readLane]->current.size())
+        {
+            m_readPage = 0;
+            m_readLane++;
+        }
+    }
+
+    const auto& page = *m_lanes[m_readLane]->current[m_readPage];
+    const Message& m = *reinterpret_cast<const Message*>(page.data.data() + m_readOffset);
+    m_readOffset += HeaderSize + alignUp(m.m_dataSize);
     m_currentCount--;
 
     return m;
@@ -63,13 +106,35 @@ bool MessageBus::empty()
     if (m_currentCount == 0)
     {
 #ifdef USE_PARALLEL_PROCESSING
-        std::scoped_lock l(m_mutex);
+        std::scoped_lock l(m_laneMutex);
+
+        //lanes belonging to threads which have exited can be
+        //removed once everything they posted has been read
+        m_lanes.erase(std::remove_if(m_lanes.begin(), m_lanes.end(),
+            [](const std::unique_ptr<Lane>& lane)
+            {
+                return lane->owner.expired() && lane->pendingCount == 0;
+            }), m_lanes.end());
 #endif
-        m_currentBuffer.swap(m_pendingBuffer);
-        m_inPointer = m_pendingBuffer.data();
-        m_outPointer = m_currentBuffer.data();
-        m_currentCount = m_pendingCount;
-        m_pendingCount = 0;
+        for (auto& lane : m_lanes)
+        {
+#ifdef USE_PARALLEL_PROCESSING
+            std::scoped_lock ll(lane->mutex);
+#endif
+            lane->pending.swap(lane->current);
+            m_currentCount += lane->pendingCount;
+
+            for (auto& page : lane->pending)
+            {
+                page->used = 0;
+            }
+            lane->pendingPage = 0;
+            lane->pendingCount = 0;
+        }
+
+        m_readLane = 0;
+        m_readPage = 0;
+        m_readOffset = 0;
         return true;
     }
     return false;
@@ -77,5 +142,98 @@ bool MessageBus::empty()
 
 std::size_t MessageBus::pendingMessageCount() const
 {
-    return m_pendingCount;
-}
\ No newline at end of file
+    std::size_t count = 0;
+    for (const auto& lane : m_lanes)
+    {
+        count += lane->pendingCount;
+    }
+    return count;
+}
+
+//private
+Message* MessageBus::allocate(Message::ID id, std::size_t dataSize)
+{
+    auto& lane = getLane();
+    const auto size = HeaderSize + alignUp(dataSize);
+
+#ifdef USE_PARALLEL_PROCESSING
+    //the returned message is filled in outside of the lock, but what
+    //we're *really* protecting here is the lane being swapped mid-post
+    std::scoped_lock l(lane.mutex);
+#endif
+
+    auto* page = lane.pending[lane.pendingPage].get();
+    if (page->used + size > Page::Size)
+    {
+        if (++lane.pendingPage == lane.pending.size())
+        {
+            lane.pending.push_back(std::make_unique<Page>());
+        }
+        page = lane.pending[lane.pendingPage].get();
+    }
+
+    auto* ptr = page->data.data() + page->used;
+    page->used += size;
+    lane.pendingCount++;
+
+    Message* msg = new (ptr)Message();
+    msg->id = id;
+    msg->m_dataSize = dataSize;
+    msg->m_data = ptr + HeaderSize;
+    return msg;
+}
+
+MessageBus::Lane& MessageBus::getLane()
+{
+#ifndef USE_PARALLEL_PROCESSING
+    //everything is posted from one lane
+    if (!m_lanes.empty())
+    {
+        return *m_lanes[0];
+    }
+#endif
+
+    for (const auto& entry : laneCache.entries)
+    {
+        if (entry.busID == m_uid)
+        {
+            return *static_cast<Lane*>(entry.lane);
+        }
+    }
+
+    const auto threadID = std::this_thread::get_id();
+
+    std::scoped_lock l(m_laneMutex);
+    auto result = std::find_if(m_lanes.begin(), m_lanes.end(),
+        [threadID](const std::unique_ptr<Lane>& lane)
+        {
+            return lane->thread == threadID;
+        });
+
+    Lane* lane = nullptr;
+    if (result == m_lanes.end())
+    {
+        auto& newLane = m_lanes.emplace_back(std::make_unique<Lane>());
+        newLane->thread = threadID;
+        newLane->pending.push_back(std::make_unique<Page>());
+        newLane->current.push_back(std::make_unique<Page>());
+        lane = newLane.get();
+    }
+    else
+    {
+        lane = result->get();
+    }
+    //thread IDs may be reused, so the lane of an exited
+    //thread may have been found and is now owned by this one
+    if (!laneOwner)
+    {
+        laneOwner = std::make_shared<int>(0);
+    }
+    lane->owner = laneOwner;
+
+    auto& entry = laneCache.entries[laneCache.nextEntry];
+    laneCache.nextEntry = (laneCache.nextEntry + 1) % LaneCache::Size;
+    entry.busID = m_uid;
+    entry.lane = lane;
+    return *lane;
+}
@@ -32,13 +32,16 @@ source distribution.
 
 #include "../detail/GLCheck.hpp"
 
+#include <algorithm>
+
 using namespace cro;
 
 State::State(StateStack& stack, State::Context context)
     : m_stack   (stack),
     m_context   (context),
     m_cached    (false),
-    m_inUse     (false)
+    m_inUse     (false),
+    m_filterMessages(false)
 {
 
 }
@@ -83,4 +86,26 @@ void State::cacheState(StateID id)
     CRO_ASSERT(id != getStateID(), "this won't end well.");
     m_stack.cacheState(id);
     m_cachedIDs.push_back(id);
-}
\ No newline at end of file
+}
+
+void State::subscribe(Message::ID id)
+{
+    m_filterMessages = true;
+    if (std::find(m_subscriptions.begin(), m_subscriptions.end(), id) == m_subscriptions.end())
+    {
+        m_subscriptions.push_back(id);
+    }
+}
+
+void State::unsubscribe(Message::ID id)
+{
+    m_filterMessages = true;
+    m_subscriptions.erase(std::remove(m_subscriptions.begin(), m_subscriptions.end(), id), m_subscriptions.end());
+}
+
+//private
+bool State::receivesMessage(Message::ID id) const
+{
+    return !m_filterMessages
+        || std::find(m_subscriptions.begin(), m_subscriptions.end(), id) != m_subscriptions.end();
+}
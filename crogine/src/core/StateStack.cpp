@@ -64,7 +64,10 @@ void StateStack::handleMessage(const Message& msg)
 {
     for (auto& s : m_stack)
     {
-        s->handleMessage(msg);
+        if (s->receivesMessage(msg.id))
+        {
+            s->handleMessage(msg);
+        }
     }
 
     //cached states need to know if we were resized
@@ -74,7 +77,8 @@ void StateStack::handleMessage(const Message& msg)
         {
             //if the state is in use (ie on the stack)
             //it'll already have this message
-            if (!s->m_inUse)
+            if (!s->m_inUse
+                && s->receivesMessage(msg.id))
             {
                 s->handleMessage(msg);
             }
@@ -0,0 +1,184 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/core/ThreadPool.hpp>
+
+using namespace cro;
+
+namespace
+{
+    //so tasks submitted from a worker go to that worker's queue
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local std::uint32_t currentIndex = 0;
+}
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+    : m_running     (true),
+    m_nextQueue     (0),
+    m_pendingCount  (0)
+{
+    if (threadCount == 0)
+    {
+        const auto hwCount = std::thread::hardware_concurrency();
+        threadCount = hwCount > 1 ? hwCount - 1 : 1;
+    }
+
+    for (auto i = 0u; i < threadCount; ++i)
+    {
+        m_queues.emplace_back(std::make_unique<Queue>());
+    }
+
+    for (auto i = 0u; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::threadFunc, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock l(m_waitMutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    for (auto& t : m_threads)
+    {
+        if (t.joinable())
+        {
+            t.join();
+        }
+    }
+}
+
+//public
+void ThreadPool::submit(Task task)
+{
+    std::size_t index = 0;
+    if (currentPool == this)
+    {
+        index = currentIndex - 1;
+    }
+    else
+    {
+        index = m_nextQueue++ % m_queues.size();
+    }
+
+    {
+        //taking the lock prevents a lost wakeup if a worker
+        //is between checking the count and waiting. The count
+        //is incremented first so it never underflows if the task
+        //is stolen as soon as it is pushed
+        std::scoped_lock l(m_waitMutex);
+        m_pendingCount++;
+    }
+
+    {
+        std::scoped_lock l(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+bool ThreadPool::runPendingTask()
+{
+    Task task;
+    const auto start = m_nextQueue.load() % m_queues.size();
+    if (stealTask(start, task))
+    {
+        task();
+        return true;
+    }
+    return false;
+}
+
+std::uint32_t ThreadPool::getCurrentThreadIndex()
+{
+    return currentIndex;
+}
+
+//private
+bool ThreadPool::popTask(std::size_t queueIndex, Task& task)
+{
+    auto& queue = *m_queues[queueIndex];
+    std::scoped_lock l(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+        //most recent task is most likely to still be in cache
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        m_pendingCount--;
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::stealTask(std::size_t queueIndex, Task& task)
+{
+    for (auto i = 0u; i < m_queues.size(); ++i)
+    {
+        auto& queue = *m_queues[(queueIndex + i) % m_queues.size()];
+        std::scoped_lock l(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            m_pendingCount--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::threadFunc(std::size_t index)
+{
+    currentPool = this;
+    currentIndex = static_cast<std::uint32_t>(index + 1);
+
+    for (;;)
+    {
+        Task task;
+        if (popTask(index, task)
+            || stealTask(index + 1, task))
+        {
+            task();
+        }
+        else
+        {
+            //remaining tasks are drained before quitting
+            std::unique_lock l(m_waitMutex);
+            m_condition.wait(l, [&]() { return m_pendingCount > 0 || !m_running; });
+
+            if (!m_running && m_pendingCount == 0)
+            {
+                break;
+            }
+        }
+    }
+}
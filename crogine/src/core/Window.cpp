@@ -30,6 +30,7 @@ source distribution.
 #include <crogine/core/Window.hpp>
 #include <crogine/core/Log.hpp>
 #include <crogine/core/App.hpp>
+#include <crogine/core/AsyncLoader.hpp>
 #include <crogine/core/Cursor.hpp>
 #include <crogine/core/Message.hpp>
 #include <crogine/detail/SDLResource.hpp>
@@ -409,6 +410,7 @@ void Window::loadResources(const std::function<void()>& loader)
         glCheck(glClear(GL_COLOR_BUFFER_BIT));
         SDL_GL_SwapWindow(m_window);
         loader();
+        AsyncLoader::finish();
     }
 #else
     //else
@@ -424,6 +426,7 @@ void Window::loadResources(const std::function<void()>& loader)
     SDL_Thread* thread = SDL_CreateThread(loadingDisplayFunc, "Loading Thread", static_cast<void*>(&data));
 
     loader();
+    AsyncLoader::finish(); //decoding continues in parallel while the loading screen is shown
     glFinish(); //make sure to wait for gl stuff to finish before continuing
 
     SDL_AtomicIncRef(&data.threadFlag);
@@ -446,6 +449,7 @@ void Window::loadResources(const std::function<void()>& loader)
     SDL_GL_SwapWindow(m_window);
 
     loader();
+    AsyncLoader::finish();
 
 #endif //PLATFORM_DESKTOP
 
@@ -63,13 +63,18 @@ BalancedTree::BalancedTree(float fattenAmount)
 //public
 std::int32_t BalancedTree::addToTree(Entity entity, Box bounds)
 {
-    auto treeID = allocateNode();
-
     const auto& tx = entity.getComponent<Transform>();
 
     bounds += tx.getOrigin();
     bounds = tx.getWorldTransform() * bounds;
 
+    return insert(entity, bounds);
+}
+
+std::int32_t BalancedTree::insert(Entity entity, Box bounds)
+{
+    auto treeID = allocateNode();
+
     //fatten AABB
     bounds[0] -= m_fattenAmount;
     bounds[1] += m_fattenAmount;
@@ -148,6 +153,78 @@ bool BalancedTree::moveNode(std::int32_t treeID, Box worldArea, glm::vec3 displa
     return true;
 }
 
+void BalancedTree::queryFrustum(const Frustum& frustum, std::vector<std::pair<Entity, bool>>& results) const
+{
+    if (m_root == TreeNode::Null)
+    {
+        return;
+    }
+
+    //each entry stores a mask of the planes the node's parent
+    //intersected - planes the parent was in front of need not be tested
+    static constexpr std::uint8_t AllPlanes = (1 << 6) - 1;
+    FixedStack<std::pair<std::int32_t, std::uint8_t>, 256> stack;
+    stack.push(std::make_pair(m_root, AllPlanes));
+
+    while (stack.size() > 0)
+    {
+        auto [treeID, planeMask] = stack.pop();
+        const auto& node = m_nodes[treeID];
+
+        bool outside = false;
+        for (auto i = 0u; i < frustum.size() && !outside; ++i)
+        {
+            if (planeMask & (1 << i))
+            {
+                switch (Spatial::intersects(frustum[i], node.fatBounds))
+                {
+                default: break;
+                case Planar::Back:
+                    outside = true;
+                    break;
+                case Planar::Front:
+                    planeMask &= ~(1 << i);
+                    break;
+                }
+            }
+        }
+
+        if (outside)
+        {
+            continue;
+        }
+
+        if (node.isLeaf())
+        {
+            results.emplace_back(node.entity, planeMask == 0);
+        }
+        else if (planeMask == 0)
+        {
+            //fully contained so accept every leaf in this branch
+            FixedStack<std::int32_t, 256> branch;
+            branch.push(treeID);
+            while (branch.size() > 0)
+            {
+                const auto& child = m_nodes[branch.pop()];
+                if (child.isLeaf())
+                {
+                    results.emplace_back(child.entity, true);
+                }
+                else
+                {
+                    branch.push(child.childA);
+                    branch.push(child.childB);
+                }
+            }
+        }
+        else
+        {
+            stack.push(std::make_pair(node.childA, planeMask));
+            stack.push(std::make_pair(node.childB, planeMask));
+        }
+    }
+}
+
 Box BalancedTree::getFatAABB(std::int32_t treeID) const
 {
     CRO_ASSERT(treeID > -1 && treeID < m_nodeCapacity, "Invalid tree id");
@@ -0,0 +1,234 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "LZ4.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr std::size_t MinMatch = 4;
+    constexpr std::size_t LastLiterals = 5; //the last 5 bytes are always literals
+    constexpr std::size_t MFLimit = 12; //the last match must start at least 12 bytes before the end
+    constexpr std::size_t MaxOffset = 65535;
+
+    constexpr std::uint32_t HashLog = 12;
+
+    std::uint32_t read32(const std::uint8_t* p)
+    {
+        std::uint32_t v = 0;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    std::uint32_t hash(std::uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HashLog);
+    }
+
+    void writeLength(std::vector<std::uint8_t>& dst, std::size_t length)
+    {
+        while (length >= 255)
+        {
+            dst.push_back(255);
+            length -= 255;
+        }
+        dst.push_back(static_cast<std::uint8_t>(length));
+    }
+
+    void writeSequence(std::vector<std::uint8_t>& dst, const std::uint8_t* literals, std::size_t literalCount,
+        std::size_t offset, std::size_t matchLength)
+    {
+        const std::size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+
+        std::uint8_t token = static_cast<std::uint8_t>(std::min(literalCount, std::size_t(15)) << 4);
+        token |= static_cast<std::uint8_t>(std::min(matchCode, std::size_t(15)));
+        dst.push_back(token);
+
+        if (literalCount >= 15)
+        {
+            writeLength(dst, literalCount - 15);
+        }
+        if (literalCount)
+        {
+            dst.insert(dst.end(), literals, literals + literalCount);
+        }
+
+        if (matchLength)
+        {
+            dst.push_back(static_cast<std::uint8_t>(offset & 0xff));
+            dst.push_back(static_cast<std::uint8_t>(offset >> 8));
+
+            if (matchCode >= 15)
+            {
+                writeLength(dst, matchCode - 15);
+            }
+        }
+    }
+
+    bool readLength(const std::uint8_t*& ip, const std::uint8_t* end, std::size_t& length)
+    {
+        std::uint8_t s = 255;
+        while (s == 255)
+        {
+            if (ip == end)
+            {
+                return false;
+            }
+            s = *ip++;
+            length += s;
+        }
+        return true;
+    }
+}
+
+std::vector<std::uint8_t> cro::Detail::LZ4::compress(const std::uint8_t* src, std::size_t srcSize)
+{
+    std::vector<std::uint8_t> dst;
+    dst.reserve(srcSize + (srcSize / 255) + 16);
+
+    std::size_t anchor = 0;
+
+    if (srcSize > MFLimit)
+    {
+        //positions are stored +1 so 0 means empty
+        std::vector<std::uint32_t> table(1u << HashLog);
+
+        const std::size_t matchLimit = srcSize - LastLiterals;
+        std::size_t i = 0;
+
+        while (i + MFLimit <= srcSize)
+        {
+            const auto sequence = read32(src + i);
+            const auto h = hash(sequence);
+            const std::size_t candidate = table[h];
+            table[h] = static_cast<std::uint32_t>(i + 1);
+
+            if (candidate != 0
+                && i - (candidate - 1) <= MaxOffset
+                && read32(src + candidate - 1) == sequence)
+            {
+                const std::size_t ref = candidate - 1;
+                std::size_t length = MinMatch;
+                while (i + length < matchLimit
+                    && src[ref + length] == src[i + length])
+                {
+                    length++;
+                }
+
+                writeSequence(dst, src + anchor, i - anchor, i - ref, length);
+                i += length;
+                anchor = i;
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    //remaining bytes are written as literals
+    writeSequence(dst, src + anchor, srcSize - anchor, 0, 0);
+
+    return dst;
+}
+
+bool cro::Detail::LZ4::decompress(const std::uint8_t* src, std::size_t srcSize, std::uint8_t* dst, std::size_t dstSize)
+{
+    const auto* ip = src;
+    const auto* const ipEnd = src + srcSize;
+    auto* op = dst;
+    auto* const opEnd = dst + dstSize;
+
+    while (ip < ipEnd)
+    {
+        const auto token = *ip++;
+
+        std::size_t literalCount = token >> 4;
+        if (literalCount == 15
+            && !readLength(ip, ipEnd, literalCount))
+        {
+            return false;
+        }
+
+        if (literalCount > static_cast<std::size_t>(ipEnd - ip)
+            || literalCount > static_cast<std::size_t>(opEnd - op))
+        {
+            return false;
+        }
+        if (literalCount)
+        {
+            std::memcpy(op, ip, literalCount);
+        }
+        ip += literalCount;
+        op += literalCount;
+
+        if (ip == ipEnd)
+        {
+            //the last sequence has no match
+            break;
+        }
+
+        if (ipEnd - ip < 2)
+        {
+            return false;
+        }
+        const std::size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (offset == 0
+            || offset > static_cast<std::size_t>(op - dst))
+        {
+            return false;
+        }
+
+        std::size_t matchLength = token & 0x0f;
+        if (matchLength == 15
+            && !readLength(ip, ipEnd, matchLength))
+        {
+            return false;
+        }
+        matchLength += MinMatch;
+
+        if (matchLength > static_cast<std::size_t>(opEnd - op))
+        {
+            return false;
+        }
+
+        //matches may overlap the output so copy byte by byte
+        const auto* match = op - offset;
+        for (auto i = 0u; i < matchLength; ++i)
+        {
+            *op++ = *match++;
+        }
+    }
+
+    return op == opEnd;
+}
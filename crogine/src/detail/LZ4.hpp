@@ -0,0 +1,53 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace cro::Detail::LZ4
+{
+    /*
+    Minimal implementation of the LZ4 block format, so data
+    compressed here can also be read by the reference library
+    (LZ4_decompress_safe()) and vice versa. Only raw blocks are
+    supported - there is no frame header or checksum, the caller
+    is expected to store the uncompressed size.
+    */
+
+    //returns the compressed data. This may be larger than the input
+    //if the data doesn't compress well.
+    std::vector<std::uint8_t> compress(const std::uint8_t* src, std::size_t srcSize);
+
+    //decompresses src into dst, which must be exactly the uncompressed size.
+    //Returns false if the data is malformed or doesn't match dstSize.
+    bool decompress(const std::uint8_t* src, std::size_t srcSize, std::uint8_t* dst, std::size_t dstSize);
+}
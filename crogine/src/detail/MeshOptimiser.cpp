@@ -0,0 +1,402 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "MeshOptimiser.hpp"
+
+#include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    //tuning values from the original article
+    constexpr std::size_t CacheSize = 32;
+    constexpr float CacheDecayPower = 1.5f;
+    constexpr float LastTriScore = 0.75f;
+    constexpr float ValenceBoostScale = 2.f;
+    constexpr float ValenceBoostPower = 0.5f;
+
+    //size of the FIFO used to find cluster boundaries
+    constexpr std::uint32_t ClusterCacheSize = 16;
+
+    constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+    float vertexScore(std::int32_t cachePosition, std::uint32_t activeTriangles)
+    {
+        if (activeTriangles == 0)
+        {
+            //no triangles left to add
+            return -1.f;
+        }
+
+        float score = 0.f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                //used by the last triangle, so fixed score to
+                //prevent the triangle strips becoming too long
+                score = LastTriScore;
+            }
+            else
+            {
+                const float scaler = 1.f / (CacheSize - 3);
+                score = std::pow(1.f - (cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+
+        //boost vertices with few remaining triangles so they get cleared
+        score += ValenceBoostScale * std::pow(static_cast<float>(activeTriangles), -ValenceBoostPower);
+        return score;
+    }
+
+    bool validIndices(const std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+    {
+        return (indices.size() % 3) == 0
+            && std::all_of(indices.begin(), indices.end(), [vertexCount](std::uint32_t i) { return i < vertexCount; });
+    }
+}
+
+void cro::Detail::MeshOptimiser::optimiseVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    const std::size_t triCount = indices.size() / 3;
+    if (triCount < 2
+        || !validIndices(indices, vertexCount))
+    {
+        return;
+    }
+
+    //triangle adjacency for each vertex. The first activeCount
+    //entries for a vertex are the triangles not yet added
+    std::vector<std::uint32_t> activeCount(vertexCount);
+    for (auto i : indices)
+    {
+        activeCount[i]++;
+    }
+
+    std::vector<std::uint32_t> offsets(vertexCount + 1);
+    for (auto i = 0u; i < vertexCount; ++i)
+    {
+        offsets[i + 1] = offsets[i] + activeCount[i];
+    }
+
+    std::vector<std::uint32_t> adjacency(indices.size());
+    {
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (auto i = 0u; i < indices.size(); ++i)
+        {
+            adjacency[fill[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<std::int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vScores(vertexCount);
+    for (auto i = 0u; i < vertexCount; ++i)
+    {
+        vScores[i] = vertexScore(-1, activeCount[i]);
+    }
+
+    std::vector<float> triScores(triCount);
+    std::vector<bool> triAdded(triCount, false);
+
+    std::uint32_t bestTri = 0;
+    for (auto i = 0u; i < triCount; ++i)
+    {
+        triScores[i] = vScores[indices[i * 3]] + vScores[indices[i * 3 + 1]] + vScores[indices[i * 3 + 2]];
+        if (triScores[i] > triScores[bestTri])
+        {
+            bestTri = i;
+        }
+    }
+
+    std::array<std::uint32_t, CacheSize + 3> cache = {};
+    std::array<std::uint32_t, CacheSize + 3> newCache = {};
+    std::size_t cacheCount = 0;
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+
+    std::size_t nextUnadded = 0;
+    for (auto n = 0u; n < triCount; ++n)
+    {
+        if (bestTri == InvalidIndex)
+        {
+            //nothing in the cache has any triangles
+            //left so start again from a new triangle
+            while (triAdded[nextUnadded])
+            {
+                nextUnadded++;
+            }
+            bestTri = static_cast<std::uint32_t>(nextUnadded);
+        }
+
+        triAdded[bestTri] = true;
+        const auto* tri = &indices[bestTri * 3];
+
+        std::size_t newCount = 0;
+        for (auto i = 0u; i < 3; ++i)
+        {
+            const auto v = tri[i];
+            output.push_back(v);
+
+            //remove the triangle from the vertex's active list
+            auto* begin = &adjacency[offsets[v]];
+            auto* end = begin + activeCount[v];
+            auto* t = std::find(begin, end, bestTri);
+            std::swap(*t, *(end - 1));
+            activeCount[v]--;
+
+            if (std::find(newCache.begin(), newCache.begin() + newCount, v) == newCache.begin() + newCount)
+            {
+                newCache[newCount++] = v;
+            }
+        }
+
+        //the rest of the old cache follows the new triangle
+        for (auto i = 0u; i < cacheCount; ++i)
+        {
+            const auto v = cache[i];
+            if (std::find(newCache.begin(), newCache.begin() + newCount, v) == newCache.begin() + newCount)
+            {
+                if (newCount < newCache.size())
+                {
+                    newCache[newCount++] = v;
+                }
+                else
+                {
+                    //pushed out of the cache
+                    cachePosition[v] = -1;
+                    vScores[v] = vertexScore(-1, activeCount[v]);
+                }
+            }
+        }
+
+        for (auto i = 0u; i < newCount; ++i)
+        {
+            const auto v = newCache[i];
+            cachePosition[v] = (i < CacheSize) ? static_cast<std::int32_t>(i) : -1;
+            vScores[v] = vertexScore(cachePosition[v], activeCount[v]);
+        }
+
+        //only triangles using a cached vertex have changed score
+        bestTri = InvalidIndex;
+        float bestScore = -1.f;
+        for (auto i = 0u; i < newCount; ++i)
+        {
+            const auto v = newCache[i];
+            for (auto j = 0u; j < activeCount[v]; ++j)
+            {
+                const auto t = adjacency[offsets[v] + j];
+                const auto score = vScores[indices[t * 3]] + vScores[indices[t * 3 + 1]] + vScores[indices[t * 3 + 2]];
+                triScores[t] = score;
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTri = t;
+                }
+            }
+        }
+
+        std::swap(cache, newCache);
+        cacheCount = std::min(newCount, CacheSize);
+    }
+
+    indices.swap(output);
+}
+
+void cro::Detail::MeshOptimiser::optimiseOverdraw(std::vector<std::uint32_t>& indices, const float* positions, std::size_t positionStride, std::size_t vertexCount)
+{
+    const std::size_t triCount = indices.size() / 3;
+    if (triCount < 2
+        || positionStride < 3
+        || !validIndices(indices, vertexCount))
+    {
+        return;
+    }
+
+    //a cluster starts wherever a triangle misses the cache on all
+    //three vertices - these are already cache boundaries so moving
+    //the clusters around doesn't affect cache efficiency
+    std::vector<std::size_t> clusters;
+    {
+        std::vector<std::uint32_t> timestamps(vertexCount, 0);
+        std::uint32_t time = ClusterCacheSize + 1;
+
+        for (auto i = 0u; i < triCount; ++i)
+        {
+            std::uint32_t misses = 0;
+            for (auto j = 0u; j < 3; ++j)
+            {
+                const auto v = indices[i * 3 + j];
+                if (time - timestamps[v] > ClusterCacheSize)
+                {
+                    timestamps[v] = time++;
+                    misses++;
+                }
+            }
+
+            if (misses == 3 || i == 0)
+            {
+                clusters.push_back(i);
+            }
+        }
+    }
+
+    if (clusters.size() < 2)
+    {
+        return;
+    }
+    clusters.push_back(triCount);
+
+    const auto position = [&](std::uint32_t v)
+    {
+        const auto* p = positions + (v * positionStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    //area weighted centroid and normal for each cluster
+    struct Cluster final
+    {
+        glm::vec3 centroid = glm::vec3(0.f);
+        glm::vec3 normal = glm::vec3(0.f);
+        float area = 0.f;
+        float sortKey = 0.f;
+        std::size_t start = 0;
+        std::size_t end = 0;
+    };
+    std::vector<Cluster> clusterData(clusters.size() - 1);
+
+    glm::vec3 meshCentroid(0.f);
+    float meshArea = 0.f;
+
+    for (auto c = 0u; c < clusterData.size(); ++c)
+    {
+        auto& cluster = clusterData[c];
+        cluster.start = clusters[c];
+        cluster.end = clusters[c + 1];
+
+        for (auto t = cluster.start; t < cluster.end; ++t)
+        {
+            const auto a = position(indices[t * 3]);
+            const auto b = position(indices[t * 3 + 1]);
+            const auto d = position(indices[t * 3 + 2]);
+
+            const auto normal = glm::cross(b - a, d - a);
+            const float area = glm::length(normal);
+
+            cluster.centroid += ((a + b + d) / 3.f) * area;
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+
+        if (cluster.area > 0.f)
+        {
+            cluster.centroid /= cluster.area;
+        }
+    }
+
+    if (meshArea == 0.f)
+    {
+        return;
+    }
+    meshCentroid /= meshArea;
+
+    for (auto& cluster : clusterData)
+    {
+        const float len = glm::length(cluster.normal);
+        if (len > 0.f)
+        {
+            cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal / len);
+        }
+    }
+
+    //outward facing clusters first so that they occlude the rest
+    std::stable_sort(clusterData.begin(), clusterData.end(),
+        [](const Cluster& a, const Cluster& b)
+        {
+            return a.sortKey > b.sortKey;
+        });
+
+    std::vector<std::uint32_t> output;
+    output.reserve(indices.size());
+    for (const auto& cluster : clusterData)
+    {
+        output.insert(output.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+    }
+    indices.swap(output);
+}
+
+std::vector<std::uint32_t> cro::Detail::MeshOptimiser::optimiseVertexFetch(std::vector<std::vector<std::uint32_t>>& indexArrays, std::size_t vertexCount)
+{
+    std::vector<std::uint32_t> remap(vertexCount, InvalidIndex);
+    std::uint32_t next = 0;
+
+    for (const auto& indices : indexArrays)
+    {
+        if (!std::all_of(indices.begin(), indices.end(), [vertexCount](std::uint32_t i) { return i < vertexCount; }))
+        {
+            //leave everything as it is
+            for (auto i = 0u; i < vertexCount; ++i)
+            {
+                remap[i] = i;
+            }
+            return remap;
+        }
+    }
+
+    for (auto& indices : indexArrays)
+    {
+        for (auto& i : indices)
+        {
+            if (remap[i] == InvalidIndex)
+            {
+                remap[i] = next++;
+            }
+            i = remap[i];
+        }
+    }
+
+    for (auto& v : remap)
+    {
+        if (v == InvalidIndex)
+        {
+            v = next++;
+        }
+    }
+
+    return remap;
+}
@@ -0,0 +1,58 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace cro::Detail::MeshOptimiser
+{
+    /*
+    Index buffer optimisations applied when exporting model binaries.
+    All functions expect triangle lists, and leave the indices untouched
+    if they are not.
+    */
+
+    //reorders triangles to make better use of the post-transform vertex
+    //cache, using Tom Forsyth's linear-speed vertex cache optimisation
+    void optimiseVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+
+    //sorts clusters of triangles created by optimiseVertexCache() so that
+    //outward facing clusters are drawn first, reducing overdraw without
+    //noticeably affecting the cache efficiency. positionStride is the
+    //size of a vertex in floats, with the position as the first 3 components.
+    void optimiseOverdraw(std::vector<std::uint32_t>& indices, const float* positions, std::size_t positionStride, std::size_t vertexCount);
+
+    //remaps vertices into the order in which they are first referenced by
+    //the index arrays, which are updated in place. Unreferenced vertices
+    //are moved to the end. Returns the new index for each old vertex.
+    std::vector<std::uint32_t> optimiseVertexFetch(std::vector<std::vector<std::uint32_t>>& indexArrays, std::size_t vertexCount);
+}
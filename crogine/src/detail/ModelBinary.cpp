@@ -28,19 +28,533 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include "GLCheck.hpp"
+#include "LZ4.hpp"
+#include "MeshOptimiser.hpp"
+#include "ModelBinaryV3.hpp"
 
 #include <crogine/detail/ModelBinary.hpp>
 #include <crogine/graphics/MeshBuilder.hpp>
 #include <crogine/ecs/components/Model.hpp>
 #include <crogine/ecs/components/Skeleton.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 using namespace cro;
+using namespace cro::Detail::ModelBinary;
+
+namespace
+{
+    //number of components of each attribute as stored in the file
+    std::size_t componentCount(std::uint32_t attribute)
+    {
+        switch (attribute)
+        {
+        default:
+        case Mesh::Attribute::Bitangent:
+            return 0;
+        case Mesh::Attribute::Position:
+        case Mesh::Attribute::Normal:
+            return 3;
+        case Mesh::Attribute::UV0:
+        case Mesh::Attribute::UV1:
+            return 2;
+        case Mesh::Attribute::Colour:
+        case Mesh::Attribute::Tangent:
+        case Mesh::Attribute::BlendIndices:
+        case Mesh::Attribute::BlendWeights:
+            return 4;
+        }
+    }
+
+    std::size_t formatSize(std::uint8_t format)
+    {
+        switch (format)
+        {
+        default: return 0;
+        case AttributeFormat::Float: return sizeof(float);
+        case AttributeFormat::SNorm16: return sizeof(std::int16_t);
+        case AttributeFormat::UNorm8: return sizeof(std::uint8_t);
+        case AttributeFormat::UInt8: return sizeof(std::uint8_t);
+        case AttributeFormat::UInt16: return sizeof(std::uint16_t);
+        }
+    }
+
+    std::size_t packedVertexSize(const MeshHeaderV3& header)
+    {
+        std::size_t size = 0;
+        for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+        {
+            if (header.flags & (1 << i))
+            {
+                size += componentCount(i) * formatSize(header.attributeFormats[i]);
+            }
+        }
+        return size;
+    }
+
+    constexpr std::size_t align4(std::size_t size)
+    {
+        return (size + 3) & ~std::size_t(3);
+    }
+
+    template <typename T>
+    void put(std::uint8_t*& dst, T value)
+    {
+        std::memcpy(dst, &value, sizeof(T));
+        dst += sizeof(T);
+    }
+
+    template <typename T>
+    T get(const std::uint8_t*& src)
+    {
+        T value;
+        std::memcpy(&value, src, sizeof(T));
+        src += sizeof(T);
+        return value;
+    }
+
+    //returns the largest of count indices, or 0 if count is 0
+    template <typename T>
+    std::uint64_t maxIndex(const std::uint8_t* src, std::uint64_t count)
+    {
+        T result = 0;
+        for (auto i = 0u; i < count; ++i)
+        {
+            T index;
+            std::memcpy(&index, src + (i * sizeof(T)), sizeof(T));
+            result = std::max(result, index);
+        }
+        return result;
+    }
+
+    std::uint8_t toUNorm8(float v)
+    {
+        return static_cast<std::uint8_t>(std::round(std::clamp(v, 0.f, 1.f) * 255.f));
+    }
+
+    std::int16_t toSNorm16(float v)
+    {
+        return static_cast<std::int16_t>(std::round(std::clamp(v, -1.f, 1.f) * 32767.f));
+    }
+}
+
+std::vector<std::uint8_t> cro::Detail::ModelBinary::packMesh(MeshHeaderV3& meshHeader, std::vector<float>& vertexData, std::vector<std::vector<std::uint32_t>>& indexData)
+{
+    std::array<std::size_t, Mesh::Attribute::Total> offsets = {};
+    std::size_t vertStride = 0;
+    for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+    {
+        if (meshHeader.flags & (1 << i))
+        {
+            offsets[i] = vertStride;
+            vertStride += componentCount(i);
+        }
+    }
+
+    if (vertStride == 0)
+    {
+        return {};
+    }
+    const std::size_t vertexCount = vertexData.size() / vertStride;
+
+    //reorder the triangles then vertices for the GPU caches
+    if (!indexData.empty())
+    {
+        for (auto& indices : indexData)
+        {
+            Detail::MeshOptimiser::optimiseVertexCache(indices, vertexCount);
+            if (meshHeader.flags & VertexProperty::Position)
+            {
+                Detail::MeshOptimiser::optimiseOverdraw(indices, vertexData.data(), vertStride, vertexCount);
+            }
+        }
+
+        const auto remap = Detail::MeshOptimiser::optimiseVertexFetch(indexData, vertexCount);
+        std::vector<float> sorted(vertexData.size());
+        for (auto i = 0u; i < vertexCount; ++i)
+        {
+            std::copy(vertexData.begin() + (i * vertStride), vertexData.begin() + ((i + 1) * vertStride), sorted.begin() + (remap[i] * vertStride));
+        }
+        vertexData.swap(sorted);
+    }
+
+    //choose the smallest format which doesn't visibly lose precision
+    for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+    {
+        if ((meshHeader.flags & (1 << i)) == 0)
+        {
+            continue;
+        }
+
+        auto& format = meshHeader.attributeFormats[i];
+        switch (i)
+        {
+        default:
+            format = AttributeFormat::Float;
+            break;
+        case Mesh::Attribute::Normal:
+        case Mesh::Attribute::Tangent:
+            format = AttributeFormat::SNorm16;
+            break;
+        case Mesh::Attribute::BlendWeights:
+            format = AttributeFormat::UNorm8;
+            break;
+        case Mesh::Attribute::Colour:
+            //colours are sometimes used to store data, eg terrain types in
+            //collision meshes, so only quantise them if it's lossless
+            format = AttributeFormat::UNorm8;
+            for (auto v = 0u; v < vertexCount && format == AttributeFormat::UNorm8; ++v)
+            {
+                for (auto c = 0u; c < 4; ++c)
+                {
+                    const auto value = vertexData[(v * vertStride) + offsets[i] + c];
+                    if (static_cast<float>(toUNorm8(value)) / 255.f != value)
+                    {
+                        format = AttributeFormat::Float;
+                        break;
+                    }
+                }
+            }
+            break;
+        case Mesh::Attribute::BlendIndices:
+        {
+            float maxIndex = 0.f;
+            for (auto v = 0u; v < vertexCount; ++v)
+            {
+                for (auto c = 0u; c < 4; ++c)
+                {
+                    maxIndex = std::max(maxIndex, vertexData[(v * vertStride) + offsets[i] + c]);
+                }
+            }
+            format = maxIndex > std::numeric_limits<std::uint8_t>::max() ? AttributeFormat::UInt16 : AttributeFormat::UInt8;
+        }
+            break;
+        }
+    }
+
+    std::uint32_t indexCount = 0;
+    for (const auto& indices : indexData)
+    {
+        indexCount += static_cast<std::uint32_t>(indices.size());
+    }
+
+    meshHeader.vertexCount = static_cast<std::uint32_t>(vertexCount);
+    meshHeader.indexArrayCount = static_cast<std::uint16_t>(indexData.size());
+    meshHeader.indexSize = vertexCount <= (std::numeric_limits<std::uint16_t>::max() + 1) ? 2 : 4;
+
+    const auto vertexOffset = indexData.size() * sizeof(std::uint32_t);
+    const auto indexOffset = align4(vertexOffset + (vertexCount * packedVertexSize(meshHeader)));
+
+    std::vector<std::uint8_t> payload(indexOffset + (indexCount * meshHeader.indexSize));
+    auto* dst = payload.data();
+
+    for (const auto& indices : indexData)
+    {
+        put(dst, static_cast<std::uint32_t>(indices.size()));
+    }
+
+    for (auto v = 0u; v < vertexCount; ++v)
+    {
+        const auto* vert = vertexData.data() + (v * vertStride);
+        for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+        {
+            if ((meshHeader.flags & (1 << i)) == 0)
+            {
+                continue;
+            }
+
+            const auto* attrib = vert + offsets[i];
+            const auto count = componentCount(i);
+            switch (meshHeader.attributeFormats[i])
+            {
+            default:
+            case AttributeFormat::Float:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    put(dst, attrib[c]);
+                }
+                break;
+            case AttributeFormat::SNorm16:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    put(dst, toSNorm16(attrib[c]));
+                }
+                break;
+            case AttributeFormat::UInt8:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    put(dst, static_cast<std::uint8_t>(std::max(0.f, attrib[c])));
+                }
+                break;
+            case AttributeFormat::UInt16:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    put(dst, static_cast<std::uint16_t>(std::clamp(attrib[c], 0.f, 65535.f)));
+                }
+                break;
+            case AttributeFormat::UNorm8:
+                if (i == Mesh::Attribute::BlendWeights)
+                {
+                    //renormalise so the quantised weights still sum to 1
+                    std::array<float, 4> weights = {};
+                    float sum = 0.f;
+                    for (auto c = 0u; c < 4; ++c)
+                    {
+                        weights[c] = std::max(0.f, attrib[c]);
+                        sum += weights[c];
+                    }
+
+                    std::array<std::int32_t, 4> quantised = {};
+                    if (sum > 0.f)
+                    {
+                        std::int32_t total = 0;
+                        std::size_t largest = 0;
+                        for (auto c = 0u; c < 4; ++c)
+                        {
+                            quantised[c] = toUNorm8(weights[c] / sum);
+                            total += quantised[c];
+                            if (quantised[c] > quantised[largest])
+                            {
+                                largest = c;
+                            }
+                        }
+                        quantised[largest] += 255 - total;
+                    }
+
+                    for (auto q : quantised)
+                    {
+                        put(dst, static_cast<std::uint8_t>(q));
+                    }
+                }
+                else
+                {
+                    for (auto c = 0u; c < count; ++c)
+                    {
+                        put(dst, toUNorm8(attrib[c]));
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    dst = payload.data() + indexOffset;
+    for (const auto& indices : indexData)
+    {
+        if (meshHeader.indexSize == 2)
+        {
+            for (auto i : indices)
+            {
+                put(dst, static_cast<std::uint16_t>(i));
+            }
+        }
+        else
+        {
+            std::memcpy(dst, indices.data(), indices.size() * sizeof(std::uint32_t));
+            dst += indices.size() * sizeof(std::uint32_t);
+        }
+    }
+
+    meshHeader.payloadSize = static_cast<std::uint32_t>(payload.size());
+    meshHeader.compression = Compression::None;
+
+    auto compressed = Detail::LZ4::compress(payload.data(), payload.size());
+    if (!compressed.empty()
+        && compressed.size() < payload.size())
+    {
+        meshHeader.compression = Compression::LZ4;
+        payload.swap(compressed);
+    }
+    meshHeader.storedSize = static_cast<std::uint32_t>(payload.size());
+
+    return payload;
+}
 
-bool cro::Detail::ModelBinary::write(cro::Entity entity, const std::string& path, bool includeSkeleton)
+bool cro::Detail::ModelBinary::readPayload(SDL_RWops* file, const MeshHeaderV3& header, PayloadV3& dst)
 {
+    dst = {};
+
+    if ((header.flags & VertexProperty::Position) == 0
+        || (header.indexSize != 2 && header.indexSize != 4)
+        || header.compression > Compression::LZ4)
+    {
+        return false;
+    }
+
+    for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+    {
+        if ((header.flags & (1 << i))
+            && formatSize(header.attributeFormats[i]) == 0)
+        {
+            return false;
+        }
+    }
+
+    //don't let a corrupt header cause a huge allocation. A byte
+    //of LZ4 data can't decompress to more than 255 bytes
+    const auto remaining = SDL_RWsize(file) - SDL_RWtell(file);
+    if (remaining < 0
+        || header.storedSize > static_cast<std::uint64_t>(remaining)
+        || header.payloadSize > static_cast<std::uint64_t>(header.storedSize) * 255)
+    {
+        return false;
+    }
+
+    std::vector<std::uint8_t> stored(header.storedSize);
+    if (!stored.empty()
+        && SDL_RWread(file, stored.data(), stored.size(), 1) != 1)
+    {
+        return false;
+    }
+
+    if (header.compression == Compression::LZ4)
+    {
+        dst.data.resize(header.payloadSize);
+        if (!Detail::LZ4::decompress(stored.data(), stored.size(), dst.data.data(), dst.data.size()))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        if (header.storedSize != header.payloadSize)
+        {
+            return false;
+        }
+        dst.data.swap(stored);
+    }
+
+    dst.vertexOffset = header.indexArrayCount * sizeof(std::uint32_t);
+    if (dst.data.size() < dst.vertexOffset)
+    {
+        return false;
+    }
+    dst.arraySizes.resize(header.indexArrayCount);
+    if (dst.vertexOffset)
+    {
+        std::memcpy(dst.arraySizes.data(), dst.data.data(), dst.vertexOffset);
+    }
+
+    std::uint64_t indexCount = 0;
+    for (auto size : dst.arraySizes)
+    {
+        indexCount += size;
+    }
+
+    dst.indexOffset = align4(dst.vertexOffset + (static_cast<std::size_t>(header.vertexCount) * packedVertexSize(header)));
+    if (dst.indexOffset + (indexCount * header.indexSize) != dst.data.size())
+    {
+        return false;
+    }
+
+    //out of range indices are at best undefined behaviour on the GPU
+    const auto* indices = dst.data.data() + dst.indexOffset;
+    return header.indexSize == 2
+        ? maxIndex<std::uint16_t>(indices, indexCount) < header.vertexCount
+        : maxIndex<std::uint32_t>(indices, indexCount) < header.vertexCount;
+}
+
+void cro::Detail::ModelBinary::unpackVertices(const MeshHeaderV3& header, const PayloadV3& payload, std::vector<float>& dst, bool expandTangents)
+{
+    std::size_t vertStride = 0;
+    for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+    {
+        if (header.flags & (1 << i))
+        {
+            vertStride += componentCount(i);
+            if (i == Mesh::Attribute::Tangent
+                && expandTangents)
+            {
+                vertStride += 2;
+            }
+        }
+    }
+
+    dst.resize(vertStride * header.vertexCount);
+
+    const auto* src = payload.data.data() + payload.vertexOffset;
+    auto* out = dst.data();
+    for (auto v = 0u; v < header.vertexCount; ++v)
+    {
+        glm::vec3 normal = glm::vec3(0.f);
+        for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+        {
+            if ((header.flags & (1 << i)) == 0)
+            {
+                continue;
+            }
+
+            auto* start = out;
+            const auto count = componentCount(i);
+            switch (header.attributeFormats[i])
+            {
+            default:
+            case AttributeFormat::Float:
+                std::memcpy(out, src, count * sizeof(float));
+                src += count * sizeof(float);
+                out += count;
+                break;
+            case AttributeFormat::SNorm16:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    *out++ = std::max(static_cast<float>(get<std::int16_t>(src)) / 32767.f, -1.f);
+                }
+                break;
+            case AttributeFormat::UNorm8:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    *out++ = static_cast<float>(*src++) / 255.f;
+                }
+                break;
+            case AttributeFormat::UInt8:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    *out++ = static_cast<float>(*src++);
+                }
+                break;
+            case AttributeFormat::UInt16:
+                for (auto c = 0u; c < count; ++c)
+                {
+                    *out++ = static_cast<float>(get<std::uint16_t>(src));
+                }
+                break;
+            }
+
+            if (i == Mesh::Attribute::Normal)
+            {
+                normal = { start[0], start[1], start[2] };
+            }
+            else if (i == Mesh::Attribute::Tangent
+                && expandTangents)
+            {
+                const glm::vec3 tan = { start[0], start[1], start[2] };
+                const auto bitan = glm::cross(normal, tan) * start[3];
+                start[3] = bitan.x;
+                *out++ = bitan.y;
+                *out++ = bitan.z;
+            }
+        }
+    }
+}
+
+bool cro::Detail::ModelBinary::write(cro::Entity entity, const std::string& path, bool includeSkeleton, bool compress)
+{
+#ifdef CRO_HEADLESS
+    //mesh data is read back from the GPU, which doesn't exist in headless builds
+    LogE << "Cannot write " << path << ": model binaries can't be written by headless builds" << std::endl;
+    return false;
+#else
     bool retVal = false;
 
-    Detail::ModelBinary::HeaderV2 header;
+    Detail::ModelBinary::Header header = Detail::ModelBinary::HeaderV2();
+    if (compress)
+    {
+        header = Detail::ModelBinary::HeaderV3();
+    }
     std::uint32_t skelOffset = sizeof(header);
 
     //if these are not empty after processing
@@ -50,6 +564,10 @@ bool cro::Detail::ModelBinary::write(cro::Entity entity, const std::string& path
     std::vector<float> outVertexData;
     std::vector<std::uint32_t> outIndexData;
 
+    //used in place of the above when compressing
+    Detail::ModelBinary::MeshHeaderV3 meshHeaderV3;
+    std::vector<std::uint8_t> outPayload;
+
     if (entity.hasComponent<Model>())
     {
         header.meshOffset = sizeof(header);
@@ -232,27 +750,38 @@ bool cro::Detail::ModelBinary::write(cro::Entity entity, const std::string& path
                 return v.empty();
             }), indexData.end());
 
-        //copy index data
-        for (const auto& data : indexData)
+        if (compress)
         {
-            outIndexSizes.push_back(static_cast<std::uint32_t>(data.size()));
-            for (auto d : data)
+            meshHeaderV3.flags = meshHeader.flags;
+            outPayload = packMesh(meshHeaderV3, outVertexData, indexData);
+
+            skelOffset = header.meshOffset
+                + static_cast<std::uint32_t>(sizeof(meshHeaderV3) + outPayload.size());
+        }
+        else
+        {
+            //copy index data
+            for (const auto& data : indexData)
             {
-                outIndexData.push_back(d);
+                outIndexSizes.push_back(static_cast<std::uint32_t>(data.size()));
+                for (auto d : data)
+                {
+                    outIndexData.push_back(d);
+                }
             }
-        }
 
 
-        //update the header with relevant detail
-        meshHeader.indexArrayCount = static_cast<std::uint16_t>(indexData.size());
-        meshHeader.indexArrayOffset = header.meshOffset
-            + static_cast<std::uint32_t>(sizeof(meshHeader)
-            + (outIndexSizes.size() * sizeof(std::uint32_t))
-            + (outVertexData.size() * sizeof(float)));
+            //update the header with relevant detail
+            meshHeader.indexArrayCount = static_cast<std::uint16_t>(indexData.size());
+            meshHeader.indexArrayOffset = header.meshOffset
+                + static_cast<std::uint32_t>(sizeof(meshHeader)
+                + (outIndexSizes.size() * sizeof(std::uint32_t))
+                + (outVertexData.size() * sizeof(float)));
 
-        //update the skeleton offset with the size of the mesh data
-        skelOffset = meshHeader.indexArrayOffset
-            + static_cast<std::uint32_t>(outIndexData.size() * sizeof(std::uint32_t));
+            //update the skeleton offset with the size of the mesh data
+            skelOffset = meshHeader.indexArrayOffset
+                + static_cast<std::uint32_t>(outIndexData.size() * sizeof(std::uint32_t));
+        }
 
         retVal = true;
     }
@@ -325,10 +854,18 @@ bool cro::Detail::ModelBinary::write(cro::Entity entity, const std::string& path
             if (header.meshOffset)
             {
                 //write mesh data
-                SDL_RWwrite(file, &meshHeader, sizeof(meshHeader), 1);
-                SDL_RWwrite(file, outIndexSizes.data(), sizeof(std::uint32_t), outIndexSizes.size());
-                SDL_RWwrite(file, outVertexData.data(), sizeof(float), outVertexData.size());
-                SDL_RWwrite(file, outIndexData.data(), sizeof(std::uint32_t), outIndexData.size());
+                if (compress)
+                {
+                    SDL_RWwrite(file, &meshHeaderV3, sizeof(meshHeaderV3), 1);
+                    SDL_RWwrite(file, outPayload.data(), 1, outPayload.size());
+                }
+                else
+                {
+                    SDL_RWwrite(file, &meshHeader, sizeof(meshHeader), 1);
+                    SDL_RWwrite(file, outIndexSizes.data(), sizeof(std::uint32_t), outIndexSizes.size());
+                    SDL_RWwrite(file, outVertexData.data(), sizeof(float), outVertexData.size());
+                    SDL_RWwrite(file, outIndexData.data(), sizeof(std::uint32_t), outIndexData.size());
+                }
             }
 
             if (header.skeletonOffset)
@@ -352,6 +889,7 @@ bool cro::Detail::ModelBinary::write(cro::Entity entity, const std::string& path
     }
 
     return retVal;
+#endif
 }
 
 cro::Mesh::Data cro::Detail::ModelBinary::read(const std::string& binPath, std::vector<float>& dstVert, std::vector<std::vector<std::uint32_t>>& dstIdx)
@@ -384,7 +922,66 @@ cro::Mesh::Data cro::Detail::ModelBinary::read(const std::string& binPath, std::
             return {};
         }
 
-        if (header.meshOffset)
+        if (header.meshOffset
+            && header.version > 2)
+        {
+            cro::Detail::ModelBinary::MeshHeaderV3 meshHeader;
+            SDL_RWread(file.file, &meshHeader, sizeof(meshHeader), 1);
+
+            PayloadV3 payload;
+            if (!readPayload(file.file, meshHeader, payload))
+            {
+                LogE << "Invalid mesh data in " << binPath << std::endl;
+                return {};
+            }
+            unpackVertices(meshHeader, payload, dstVert, false);
+
+            const auto* src = payload.data.data() + payload.indexOffset;
+            dstIdx.resize(meshHeader.indexArrayCount);
+            for (auto i = 0u; i < meshHeader.indexArrayCount; ++i)
+            {
+                dstIdx[i].resize(payload.arraySizes[i]);
+                if (meshHeader.indexSize == 2)
+                {
+                    std::vector<std::uint16_t> temp(dstIdx[i].size());
+                    std::memcpy(temp.data(), src, temp.size() * sizeof(std::uint16_t));
+                    src += temp.size() * sizeof(std::uint16_t);
+                    std::copy(temp.begin(), temp.end(), dstIdx[i].begin());
+                }
+                else
+                {
+                    std::memcpy(dstIdx[i].data(), src, dstIdx[i].size() * sizeof(std::uint32_t));
+                    src += dstIdx[i].size() * sizeof(std::uint32_t);
+                }
+            }
+
+            for (auto i = 0u; i < cro::Mesh::Attribute::Total; ++i)
+            {
+                if (meshHeader.flags & (1 << i))
+                {
+                    meshData.attributes[i] = componentCount(i);
+                }
+            }
+
+            meshData.attributeFlags = meshHeader.flags;
+            meshData.primitiveType = GL_TRIANGLES;
+
+            for (const auto& a : meshData.attributes)
+            {
+                meshData.vertexSize += a;
+            }
+            meshData.vertexSize *= sizeof(float);
+            meshData.vertexCount = meshHeader.vertexCount;
+
+            meshData.submeshCount = meshHeader.indexArrayCount;
+            for (auto i = 0u; i < meshData.submeshCount; ++i)
+            {
+                meshData.indexData[i].format = GL_UNSIGNED_INT;
+                meshData.indexData[i].primitiveType = meshData.primitiveType;
+                meshData.indexData[i].indexCount = static_cast<std::uint32_t>(dstIdx[i].size());
+            }
+        }
+        else if (header.meshOffset)
         {
             cro::Detail::ModelBinary::MeshHeader meshHeader;
             SDL_RWread(file.file, &meshHeader, sizeof(meshHeader), 1);
@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/detail/ModelBinary.hpp>
+
+#include <SDL_rwops.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace cro::Detail::ModelBinary
+{
+    /*
+    Shared between the reader and writer of version 3 model binaries.
+    The implementation lives in ModelBinary.cpp
+    */
+
+    //mesh payload of a version 3 file once decompressed
+    struct PayloadV3 final
+    {
+        std::vector<std::uint8_t> data;
+        std::vector<std::uint32_t> arraySizes;
+        std::size_t vertexOffset = 0; //bytes from the start of data to the packed vertices
+        std::size_t indexOffset = 0; //bytes from the start of data to the index arrays
+    };
+
+    //optimises and packs the vertex and index data into a payload, which is
+    //compressed if that makes it smaller. Flags must already be set in the header,
+    //the rest of which is filled in. The vertices and indices are reordered in place.
+    std::vector<std::uint8_t> packMesh(MeshHeaderV3&, std::vector<float>& vertexData, std::vector<std::vector<std::uint32_t>>& indexData);
+
+    //reads the payload following the given header from the current
+    //position of the file, decompressing it if necessary. Returns false
+    //if the payload is invalid or indices are out of range.
+    bool readPayload(SDL_RWops*, const MeshHeaderV3&, PayloadV3& dst);
+
+    //unpacks the vertices of the payload to floats in dst. If expandTangents
+    //is true the tangent sign is replaced with a bitangent, as used by
+    //BinaryMeshBuilder, else the layout matches that of a version 2 file.
+    void unpackVertices(const MeshHeaderV3&, const PayloadV3&, std::vector<float>& dst, bool expandTangents);
+}
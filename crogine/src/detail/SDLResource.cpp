@@ -28,10 +28,26 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/detail/SDLResource.hpp>
+
+#ifndef CRO_HEADLESS
 #include <crogine/core/App.hpp>
+#endif
 
 using namespace cro::Detail;
 
+#ifdef CRO_HEADLESS
+//headless builds only use the SDL subsystems which
+//don't require initialising by the App, such as timers
+SDLResource::SDLResource()
+{
+
+}
+
+bool SDLResource::valid()
+{
+    return true;
+}
+#else
 SDLResource::SDLResource()
 {
     CRO_ASSERT(App::m_instance, "A single instance of cro::App must exist!");
@@ -40,4 +56,5 @@ SDLResource::SDLResource()
 bool SDLResource::valid()
 {
     return App::m_instance != nullptr;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+
+//4 wide float vector helpers used by batch processing functions.
+//CRO_SIMD is defined when SSE2 (x86/x64) or NEON (arm64) are available,
+//else callers should fall back to scalar code.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CRO_SIMD
+#define CRO_SIMD_SSE
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define CRO_SIMD
+#define CRO_SIMD_NEON
+#endif
+
+#ifdef CRO_SIMD
+namespace cro::Detail::SIMD
+{
+    static constexpr std::size_t Width = 4;
+
+#ifdef CRO_SIMD_SSE
+    using Float4 = __m128;
+
+    inline Float4 load(const float* f) { return _mm_loadu_ps(f); }
+    inline void store(float* f, Float4 v) { _mm_storeu_ps(f, v); }
+    inline Float4 splat(float f) { return _mm_set1_ps(f); }
+    inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+    inline Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+    inline Float4 abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+    inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+    inline Float4 lessThan(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+    inline Float4 greaterThan(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+
+    //returns a where mask is set, else b
+    inline Float4 select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+    //returns true if any lane of the mask is set
+    inline bool any(Float4 mask) { return _mm_movemask_ps(mask) != 0; }
+#else
+    using Float4 = float32x4_t;
+
+    inline Float4 load(const float* f) { return vld1q_f32(f); }
+    inline void store(float* f, Float4 v) { vst1q_f32(f, v); }
+    inline Float4 splat(float f) { return vdupq_n_f32(f); }
+    inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+    inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+    inline Float4 div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+    inline Float4 sqrt(Float4 a) { return vsqrtq_f32(a); }
+    inline Float4 abs(Float4 a) { return vabsq_f32(a); }
+    inline Float4 min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+    inline Float4 max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+    inline Float4 lessThan(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    inline Float4 greaterThan(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+
+    inline Float4 select(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+    inline bool any(Float4 mask) { return vmaxvq_u32(vreinterpretq_u32_f32(mask)) != 0; }
+#endif
+}
+#endif //CRO_SIMD
@@ -30,12 +30,15 @@ source distribution.
 #include <crogine/ecs/Director.hpp>
 #include <crogine/ecs/systems/CommandSystem.hpp>
 
+#include <algorithm>
+
 using namespace cro;
 
 Director::Director()
     : m_messageBus(nullptr),
     m_commandSystem(nullptr),
-    m_scene(nullptr){}
+    m_scene(nullptr),
+    m_filterMessages(false){}
 
 void Director::sendCommand(const Command& cmd)
 {
@@ -53,4 +56,26 @@ const Scene& Director::getScene() const
 {
     CRO_ASSERT(m_scene, "Missing scene - are you using this correctly?");
     return *m_scene;
+}
+
+void Director::subscribe(Message::ID id)
+{
+    m_filterMessages = true;
+    if (std::find(m_subscriptions.begin(), m_subscriptions.end(), id) == m_subscriptions.end())
+    {
+        m_subscriptions.push_back(id);
+    }
+}
+
+void Director::unsubscribe(Message::ID id)
+{
+    m_filterMessages = true;
+    m_subscriptions.erase(std::remove(m_subscriptions.begin(), m_subscriptions.end(), id), m_subscriptions.end());
+}
+
+//private
+bool Director::receivesMessage(Message::ID id) const
+{
+    return !m_filterMessages
+        || std::find(m_subscriptions.begin(), m_subscriptions.end(), id) != m_subscriptions.end();
 }
\ No newline at end of file
@@ -27,27 +27,30 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
-#include "../detail/GLCheck.hpp"
-
 #include <crogine/ecs/Scene.hpp>
-#include <crogine/ecs/components/Camera.hpp>
 #include <crogine/ecs/components/Transform.hpp>
-#include <crogine/ecs/components/AudioListener.hpp>
-#include <crogine/ecs/Renderable.hpp>
 
 #include <crogine/core/Clock.hpp>
-#include <crogine/core/App.hpp>
 #include <crogine/core/ConfigFile.hpp>
 
-#include <crogine/graphics/Image.hpp>
-#include <crogine/graphics/EnvironmentMap.hpp>
 #include <crogine/util/Constants.hpp>
 #include <crogine/detail/glm/gtc/matrix_transform.hpp>
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
 
+#ifndef CRO_HEADLESS
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/AudioListener.hpp>
+#include <crogine/ecs/Renderable.hpp>
+
+#include <crogine/core/App.hpp>
+
+#include <crogine/graphics/Image.hpp>
+#include <crogine/graphics/EnvironmentMap.hpp>
+
 #include <crogine/gui/Gui.hpp>
 
 #include "../detail/GLCheck.hpp"
+#endif
 
 using namespace cro;
 
@@ -55,6 +58,7 @@ namespace
 {
     std::size_t uid = 0;
 
+#ifndef CRO_HEADLESS
     //same order as GL_TEXTURE_CUBE_MAP_XXXX_YYYY
     enum CubemapDirection
     {
@@ -169,7 +173,7 @@ namespace
 
     void updateView(cro::Camera& camera)
     {
-        glm::vec2 size(cro::App::getWindow().getSize());
+        glm::vec2 size = cro::App::isValid() ? glm::vec2(cro::App::getWindow().getSize()) : glm::vec2(1920.f, 1080.f);
         if (camera.isOrthographic())
         {
             camera.setOrthographic(0.f, size.x, 0.f, size.y, 0.f, 10.f);
@@ -186,19 +190,23 @@ namespace
         }
         LOG("Default camera resize callback used: are you missing a callback assignment?", cro::Logger::Type::Warning);
     }
+#endif
 }
 
 Scene::Scene(MessageBus& mb, std::size_t initialPoolSize, std::uint32_t infoFlags)
     : m_messageBus          (mb),
     m_uid                   (++uid),
     m_entityManager         (mb, m_componentManager, initialPoolSize),
-    m_systemManager         (*this, m_componentManager, infoFlags),
-    m_projectionMapCount    (0),
+    m_systemManager         (*this, m_componentManager, infoFlags)
+#ifndef CRO_HEADLESS
+    ,m_projectionMapCount   (0),
     m_waterLevel            (0.f),
     m_activeSkyboxTexture   (0),
     m_starsUniform          (-1),
     m_shaderIndex           (0)
+#endif
 {
+#ifndef CRO_HEADLESS
     auto defaultCamera = createEntity();
     defaultCamera.addComponent<Transform>();
     defaultCamera.addComponent<Camera>().resizeCallback = std::bind(&updateView, std::placeholders::_1);
@@ -217,19 +225,24 @@ Scene::Scene(MessageBus& mb, std::size_t initialPoolSize, std::uint32_t infoFlag
     currentRenderPath = std::bind(&Scene::defaultRenderPath, this, _1, _2, _3);
 
     std::fill(m_skyColourUniforms.begin(), m_skyColourUniforms.end(), -1);
+#endif
 }
 
 Scene::~Scene()
 {
+#ifndef CRO_HEADLESS
     destroySkybox();
+#endif
 }
 
 //public
 void Scene::simulate(float dt)
 {
+#ifndef CRO_HEADLESS
     //update the sun entity to make sure the direction is correctly rotated
     auto& sun = m_sunlight.getComponent<Sunlight>();
     sun.m_directionRotated = glm::quat_cast(m_sunlight.getComponent<Transform>().getWorldTransform()) * sun.m_direction;
+#endif
 
     //update directors first as they'll be working on data from the last frame
     for (auto& d : m_directors)
@@ -257,10 +270,12 @@ void Scene::simulate(float dt)
     m_destroyedEntities.clear();
 
     m_systemManager.process(dt);
+#ifndef CRO_HEADLESS
     for (auto& p : m_postEffects)
     {
         p->process(dt);
     }
+#endif
 }
 
 Entity Scene::createEntity()
@@ -280,6 +295,7 @@ Entity Scene::getEntity(Entity::ID id) const
     return m_entityManager.getEntity(id);
 }
 
+#ifndef CRO_HEADLESS
 void Scene::setPostEnabled(bool enabled)
 {
     using namespace std::placeholders;
@@ -518,6 +534,7 @@ Entity Scene::getActiveCamera() const
 {
     return m_activeCamera;
 }
+#endif
 
 void Scene::forwardEvent(const Event& evt)
 {
@@ -532,9 +549,13 @@ void Scene::forwardMessage(const Message& msg)
     m_systemManager.forwardMessage(msg);
     for (auto& d : m_directors)
     {
-        d->handleMessage(msg);
+        if (d->receivesMessage(msg.id))
+        {
+            d->handleMessage(msg);
+        }
     }
 
+#ifndef CRO_HEADLESS
     if (msg.id == Message::WindowMessage)
     {
         const auto& data = msg.getData<Message::WindowEvent>();
@@ -544,8 +565,10 @@ void Scene::forwardMessage(const Message& msg)
             resizeBuffers({ data.data0, data.data1 });
         }
     }
+#endif
 }
 
+#ifndef CRO_HEADLESS
 void Scene::render(bool doPost)
 {
     if (doPost)
@@ -770,3 +793,4 @@ void Scene::resizeBuffers(glm::uvec2 size)
         }
     }
 }
+#endif
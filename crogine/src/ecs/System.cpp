@@ -30,14 +30,26 @@ source distribution.
 #include <crogine/ecs/System.hpp>
 #include <crogine/core/Clock.hpp>
 
+#include <algorithm>
+#include <limits>
+
 using namespace cro;
 
+namespace
+{
+    constexpr std::uint32_t NullSlot = std::numeric_limits<std::uint32_t>::max();
+}
+
 System::System(MessageBus& mb, UniqueType t)
-    : m_messageBus  (mb),
-    m_type          (t),
-    m_scene         (nullptr),
-    m_updateIndex   (0),
-    m_active        (false)
+    : m_messageBus      (mb),
+    m_type              (t),
+    m_preserveOrder     (false),
+    m_scene             (nullptr),
+    m_systemManager     (nullptr),
+    m_updateIndex       (0),
+    m_active            (false),
+    m_executionPolicy   (ExecutionPolicy::Serial),
+    m_filterMessages    (false)
 {}
 
 //public
@@ -53,22 +65,58 @@ const std::vector<Entity>& System::getEntities() const
 
 void System::addEntity(Entity entity)
 {
+    const auto idx = entity.getIndex();
+    if (idx >= m_entitySlots.size())
+    {
+        m_entitySlots.resize(idx + 1, NullSlot);
+    }
+    m_entitySlots[idx] = static_cast<std::uint32_t>(m_entities.size());
+
     m_entities.push_back(entity);
     onEntityAdded(entity);
 }
 
 void System::removeEntity(Entity entity)
 {
-    m_entities.erase(std::remove_if(std::begin(m_entities), std::end(m_entities),
-        [&entity, this](const Entity& e)
+    const auto slot = findSlot(entity);
+    if (slot == NullSlot)
+    {
+        return;
+    }
+
+    onEntityRemoved(entity);
+
+    //onEntityRemoved() may have modified the list
+    const auto current = findSlot(entity);
+    if (current == NullSlot)
+    {
+        return;
+    }
+
+    m_entitySlots[entity.getIndex()] = NullSlot;
+
+    if (m_preserveOrder)
+    {
+        m_entities.erase(m_entities.begin() + current);
+        for (auto i = current; i < m_entities.size(); ++i)
+        {
+            m_entitySlots[m_entities[i].getIndex()] = i;
+        }
+    }
+    else
     {
-        if (entity == e)
+        if (current != m_entities.size() - 1)
         {
-            onEntityRemoved(e);
-            return true;
+            m_entities[current] = m_entities.back();
+            m_entitySlots[m_entities[current].getIndex()] = current;
         }
-        return false;
-    }), std::end(m_entities));
+        m_entities.pop_back();
+    }
+}
+
+bool System::hasEntity(Entity entity) const
+{
+    return findSlot(entity) != NullSlot;
 }
 
 const ComponentMask& System::getComponentMask() const
@@ -92,12 +140,95 @@ Scene* System::getScene()
     return m_scene;
 }
 
+void System::subscribe(Message::ID id)
+{
+    m_filterMessages = true;
+    if (std::find(m_subscriptions.begin(), m_subscriptions.end(), id) == m_subscriptions.end())
+    {
+        m_subscriptions.push_back(id);
+    }
+
+    if (m_systemManager)
+    {
+        m_systemManager->invalidateMessageRoutes();
+    }
+}
+
+void System::unsubscribe(Message::ID id)
+{
+    m_filterMessages = true;
+    m_subscriptions.erase(std::remove(m_subscriptions.begin(), m_subscriptions.end(), id), m_subscriptions.end());
+
+    if (m_systemManager)
+    {
+        m_systemManager->invalidateMessageRoutes();
+    }
+}
+
 //private
+bool System::receivesMessage(Message::ID id) const
+{
+    return !m_filterMessages
+        || std::find(m_subscriptions.begin(), m_subscriptions.end(), id) != m_subscriptions.end();
+}
+
+std::uint32_t System::findSlot(Entity entity) const
+{
+    const auto idx = entity.getIndex();
+    if (idx >= m_entitySlots.size()
+        || m_entitySlots[idx] == NullSlot)
+    {
+        return NullSlot;
+    }
+
+    const auto slot = m_entitySlots[idx];
+    if (slot < m_entities.size()
+        && m_entities[slot] == entity)
+    {
+        return slot;
+    }
+
+    //derived systems are free to sort or otherwise modify the
+    //entity list, so if the slot is stale fall back to a search
+    auto result = std::find(m_entities.begin(), m_entities.end(), entity);
+    if (result != m_entities.end())
+    {
+        rebuildSlots();
+        return static_cast<std::uint32_t>(std::distance(m_entities.begin(), result));
+    }
+
+    return NullSlot;
+}
+
+void System::rebuildSlots() const
+{
+    std::fill(m_entitySlots.begin(), m_entitySlots.end(), NullSlot);
+    for (auto i = 0u; i < m_entities.size(); ++i)
+    {
+        const auto idx = m_entities[i].getIndex();
+        if (idx >= m_entitySlots.size())
+        {
+            m_entitySlots.resize(idx + 1, NullSlot);
+        }
+        m_entitySlots[idx] = i;
+    }
+}
+
 void System::processTypes(ComponentManager& cm)
 {
-    for (const auto& componentType : m_pendingTypes)
+    for (const auto& [componentType, access, required] : m_pendingTypes)
     {
-        m_componentMask.set(cm.getFromTypeID(componentType));
+        const auto id = cm.getFromTypeID(componentType);
+        if (required)
+        {
+            m_componentMask.set(id);
+        }
+
+        m_readMask.set(id);
+        if (access == ComponentAccess::ReadWrite)
+        {
+            m_writeMask.set(id);
+        }
     }
     m_pendingTypes.clear();
 }
\ No newline at end of file
@@ -32,7 +32,12 @@ source distribution.
 #include <crogine/ecs/InfoFlags.hpp>
 #include <crogine/ecs/Scene.hpp>
 #include <crogine/ecs/System.hpp>
+
+#ifndef CRO_HEADLESS
 #include <crogine/gui/Gui.hpp>
+#endif
+
+#include "SystemScheduler.hpp"
 
 #include <sstream>
 
@@ -47,8 +52,11 @@ SystemManager::SystemManager(Scene& scene, ComponentManager& cm, std::uint32_t i
     : m_scene                   (scene),
     m_componentManager          (cm),
     m_infoFlags                 (infoFlags),
-    m_systemUpdateAccumulator   (0.f)
+    m_systemUpdateAccumulator   (0.f),
+    m_scheduler                 (std::make_unique<Detail::SystemScheduler>()),
+    m_messageRoutesDirty        (false)
 {
+#ifndef CRO_HEADLESS
     //TODO refactor this into a single window with panes for each flag
     if (infoFlags & INFO_FLAG_SYSTEMS_ACTIVE)
     {
@@ -110,14 +118,43 @@ SystemManager::SystemManager(Scene& scene, ComponentManager& cm, std::uint32_t i
                         return a.elapsed > b.elapsed;
                 });
 
-                for (const auto& [system, elapsed] : m_systemSamples)
+                std::vector<float> threadTimes;
+                for (const auto& [system, elapsed, thread] : m_systemSamples)
+                {
+                    if (thread >= threadTimes.size())
+                    {
+                        threadTimes.resize(thread + 1, 0.f);
+                    }
+                    threadTimes[thread] += elapsed;
+                }
+
+                for (auto i = 0u; i < threadTimes.size(); ++i)
+                {
+                    if (i == 0)
+                    {
+                        ImGui::Text("Main Thread: %2.4fms", threadTimes[i]);
+                    }
+                    else if (threadTimes[i] > 0.f)
+                    {
+                        ImGui::Text("Worker %u: %2.4fms", i, threadTimes[i]);
+                    }
+                }
+                ImGui::Separator();
+
+                for (const auto& [system, elapsed, thread] : m_systemSamples)
                 {
-                    ImGui::Text("%s: %2.4fms", system->getType().name(), elapsed);
+                    ImGui::Text("%s: %2.4fms (%u)", system->getType().name(), elapsed, thread);
                 }
             }
             ImGui::End();
         });
     }
+#endif
+}
+
+SystemManager::~SystemManager()
+{
+
 }
 
 void SystemManager::addToSystems(Entity entity)
@@ -135,15 +172,42 @@ void SystemManager::addToSystems(Entity entity)
 
 void SystemManager::removeFromSystems(Entity entity)
 {
+    //components can't be removed from an entity, so if the
+    //mask doesn't match now it never matched when it was added
+    const auto& entMask = entity.getComponentMask();
     for (auto& sys : m_systems)
     {
-        sys->removeEntity(entity);
+        const auto& sysMask = sys->getComponentMask();
+        if ((entMask & sysMask) == sysMask)
+        {
+            sys->removeEntity(entity);
+        }
     }
 }
 
 void SystemManager::forwardMessage(const Message& msg)
 {
-    for (auto& sys : m_systems)
+    if (m_messageRoutesDirty)
+    {
+        m_messageRoutes.clear();
+        m_messageRoutesDirty = false;
+    }
+
+    auto result = m_messageRoutes.find(msg.id);
+    if (result == m_messageRoutes.end())
+    {
+        std::vector<System*> route;
+        for (auto& sys : m_systems)
+        {
+            if (sys->receivesMessage(msg.id))
+            {
+                route.push_back(sys.get());
+            }
+        }
+        result = m_messageRoutes.emplace(msg.id, std::move(route)).first;
+    }
+
+    for (auto* sys : result->second)
     {
         sys->handleMessage(msg);
     }
@@ -151,6 +215,8 @@ void SystemManager::forwardMessage(const Message& msg)
 
 void SystemManager::process(float dt)
 {
+    bool takeSample = false;
+
     //hmm I wish this could be conditionally compiled...
     if (m_infoFlags)
     {        
@@ -160,20 +226,33 @@ void SystemManager::process(float dt)
         {
             m_systemUpdateAccumulator -= SystemTimeUpdateRate;
             m_systemSamples.clear();
-        
-            for (auto& system : m_activeSystems)
-            {
-                system->process(dt);
-                m_systemSamples.emplace_back(system, m_systemTimer.restart() * 1000.f);
-            }
+            takeSample = true;
         }
-        else
+    }
+
+#ifdef USE_PARALLEL_PROCESSING
+    if (m_scheduler->canSchedule(m_activeSystems))
+    {
+        m_scheduler->process(m_activeSystems, dt);
+
+        if (takeSample)
         {
-            for (auto& system : m_activeSystems)
+            for (const auto& [system, elapsed, thread] : m_scheduler->getTimings())
             {
-                system->process(dt);
+                m_systemSamples.emplace_back(system, elapsed, thread);
             }
         }
+        return;
+    }
+#endif
+
+    if (takeSample)
+    {
+        for (auto& system : m_activeSystems)
+        {
+            system->process(dt);
+            m_systemSamples.emplace_back(system, m_systemTimer.restart() * 1000.f);
+        }
     }
     else
     {
@@ -0,0 +1,206 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "SystemScheduler.hpp"
+
+#include <crogine/core/ThreadPool.hpp>
+#include <crogine/core/HiResTimer.hpp>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    ThreadPool& getThreadPool()
+    {
+        //shared by all scenes so that we don't end up
+        //with more threads than there are cores
+        static ThreadPool pool;
+        return pool;
+    }
+
+    bool conflicts(const System& a, const System& b)
+    {
+        if (a.getExecutionPolicy() == System::ExecutionPolicy::Serial
+            || b.getExecutionPolicy() == System::ExecutionPolicy::Serial)
+        {
+            return true;
+        }
+
+        return (a.getWriteMask() & (b.getReadMask() | b.getWriteMask())).any()
+            || (b.getWriteMask() & a.getReadMask()).any();
+    }
+}
+
+SystemScheduler::SystemScheduler()
+    : m_threadPool  (nullptr),
+    m_pendingSize   (0),
+    m_remaining     (0)
+{
+
+}
+
+//public
+bool SystemScheduler::canSchedule(const std::vector<System*>& systems) const
+{
+    std::size_t count = 0;
+    for (const auto* system : systems)
+    {
+        if (system->getExecutionPolicy() != System::ExecutionPolicy::Serial)
+        {
+            if (++count == 2)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void SystemScheduler::process(const std::vector<System*>& systems, float dt)
+{
+    if (!m_threadPool)
+    {
+        m_threadPool = &getThreadPool();
+    }
+
+    buildGraph(systems);
+
+    m_remaining = m_nodes.size();
+    for (auto i = 0u; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i].dependencyCount == 0)
+        {
+            dispatch(i, dt);
+        }
+    }
+
+    for (;;)
+    {
+        std::size_t next = 0;
+        {
+            std::unique_lock l(m_mainMutex);
+            if (m_remaining == 0)
+            {
+                break;
+            }
+
+            if (m_mainQueue.empty())
+            {
+                //help out the workers while we wait
+                l.unlock();
+                if (!m_threadPool->runPendingTask())
+                {
+                    l.lock();
+                    m_mainCondition.wait(l, [&]() { return !m_mainQueue.empty() || m_remaining == 0; });
+                }
+                continue;
+            }
+
+            next = m_mainQueue.back();
+            m_mainQueue.pop_back();
+        }
+        run(next, dt);
+    }
+}
+
+//private
+void SystemScheduler::buildGraph(const std::vector<System*>& systems)
+{
+    m_nodes.resize(systems.size());
+    m_timings.resize(systems.size());
+
+    if (m_pendingSize < systems.size())
+    {
+        m_pendingSize = systems.size();
+        m_pendingCounts = std::make_unique<std::atomic<std::int32_t>[]>(m_pendingSize);
+    }
+
+    for (auto i = 0u; i < systems.size(); ++i)
+    {
+        auto& node = m_nodes[i];
+        node.system = systems[i];
+        node.dependents.clear();
+        node.dependencyCount = 0;
+        node.mainThread = systems[i]->getExecutionPolicy() != System::ExecutionPolicy::Concurrent;
+
+        //update order is preserved between any two systems which conflict
+        for (auto j = 0u; j < i; ++j)
+        {
+            if (conflicts(*systems[j], *systems[i]))
+            {
+                m_nodes[j].dependents.push_back(i);
+                node.dependencyCount++;
+            }
+        }
+        m_pendingCounts[i] = node.dependencyCount;
+
+        m_timings[i].system = systems[i];
+        m_timings[i].elapsed = 0.f;
+        m_timings[i].thread = 0;
+    }
+}
+
+void SystemScheduler::dispatch(std::size_t index, float dt)
+{
+    if (m_nodes[index].mainThread)
+    {
+        std::scoped_lock l(m_mainMutex);
+        m_mainQueue.push_back(index);
+        m_mainCondition.notify_one();
+    }
+    else
+    {
+        m_threadPool->submit([&, index, dt]() { run(index, dt); });
+    }
+}
+
+void SystemScheduler::run(std::size_t index, float dt)
+{
+    HiResTimer timer;
+    m_nodes[index].system->process(dt);
+
+    auto& timing = m_timings[index];
+    timing.elapsed = timer.restart() * 1000.f;
+    timing.thread = ThreadPool::getCurrentThreadIndex();
+
+    for (auto dependent : m_nodes[index].dependents)
+    {
+        if (--m_pendingCounts[dependent] == 0)
+        {
+            dispatch(dependent, dt);
+        }
+    }
+
+    //notify while the lock is held, else the main thread may see the
+    //final count and return before the notification is complete
+    std::scoped_lock l(m_mainMutex);
+    m_remaining--;
+    m_mainCondition.notify_one();
+}
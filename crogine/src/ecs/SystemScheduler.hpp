@@ -0,0 +1,109 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/ecs/System.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cro
+{
+    class ThreadPool;
+
+    namespace Detail
+    {
+        /*!
+        \brief Runs the active systems of a SystemManager on a shared thread pool.
+        Each frame a dependency graph is built from the active systems in update order.
+        A system depends on an earlier system if either is Serial, or if one writes a
+        component type which the other reads or writes. Systems with no outstanding
+        dependencies are then run as soon as possible, Concurrent systems on the
+        pool's worker threads and Serial or MainThread systems on the calling thread.
+        */
+        class SystemScheduler final
+        {
+        public:
+            SystemScheduler();
+
+            struct Timing final
+            {
+                const System* system = nullptr;
+                float elapsed = 0.f;
+                std::uint32_t thread = 0; //0 is the thread which called process()
+            };
+
+            /*!
+            \brief Returns true if the given list contains enough non-Serial
+            systems that scheduling them may run some in parallel
+            */
+            bool canSchedule(const std::vector<System*>&) const;
+
+            /*!
+            \brief Processes the given systems, blocking until they have all completed
+            */
+            void process(const std::vector<System*>&, float dt);
+
+            /*!
+            \brief Returns the timing of each system from the last call to process()
+            */
+            const std::vector<Timing>& getTimings() const { return m_timings; }
+
+        private:
+            ThreadPool* m_threadPool;
+
+            struct Node final
+            {
+                System* system = nullptr;
+                std::vector<std::size_t> dependents;
+                std::int32_t dependencyCount = 0;
+                bool mainThread = true;
+            };
+            std::vector<Node> m_nodes;
+            std::vector<Timing> m_timings;
+
+            std::unique_ptr<std::atomic<std::int32_t>[]> m_pendingCounts;
+            std::size_t m_pendingSize;
+
+            std::mutex m_mainMutex;
+            std::condition_variable m_mainCondition;
+            std::vector<std::size_t> m_mainQueue;
+            std::size_t m_remaining;
+
+            void buildGraph(const std::vector<System*>&);
+            void dispatch(std::size_t, float);
+            void run(std::size_t, float);
+        };
+    }
+}
@@ -45,8 +45,13 @@ Camera::Camera()
     m_shadowExpansion   (0.f),
     m_dirtyTx           (true)
 {
-    glm::vec2 windowSize(App::getWindow().getSize());
-    m_aspectRatio = windowSize.x / windowSize.y;
+    //cameras may be created without a window, for example
+    //when culling draw lists in the benchmarks
+    if (App::isValid())
+    {
+        glm::vec2 windowSize(App::getWindow().getSize());
+        m_aspectRatio = windowSize.x / windowSize.y;
+    }
     m_projectionMatrix = glm::perspective(m_verticalFOV, m_aspectRatio, m_nearPlane, m_farPlane);
 
     m_passes[Pass::Final].m_cullFace = GL_BACK;
@@ -151,6 +151,10 @@ Model::Model(Model&& other) noexcept
     std::swap(m_skeleton, other.m_skeleton);
     std::swap(m_jointCount, other.m_jointCount);
 
+    std::swap(m_treeID, other.m_treeID);
+    std::swap(m_lastWorldPosition, other.m_lastWorldPosition);
+    std::swap(m_lastWorldUpdate, other.m_lastWorldUpdate);
+
     std::swap(m_instanceBuffers, other.m_instanceBuffers);
 
     //check the other property to see which draw func we need
@@ -206,6 +210,12 @@ Model& Model::operator=(Model&& other) noexcept
         m_jointCount = other.m_jointCount;
         other.m_jointCount = 0;
 
+        //the renderer's tree refers to the component by ID
+        m_treeID = other.m_treeID;
+        other.m_treeID = -1;
+        m_lastWorldPosition = other.m_lastWorldPosition;
+        m_lastWorldUpdate = other.m_lastWorldUpdate;
+
         if (m_instanceBuffers.instanceCount != 0)
         {
             glCheck(glDeleteBuffers(1, &m_instanceBuffers.normalBuffer));
@@ -530,6 +540,13 @@ void Model::updateBounds()
 #ifdef PLATFORM_DESKTOP
 void Model::updateVAO(std::size_t idx, std::int32_t passIndex)
 {
+    //mesh data without a vertex buffer has nothing to bind, and is
+    //used for culling draw lists without a graphics context
+    if (m_meshData.vbo == 0)
+    {
+        return;
+    }
+
     auto& submesh = m_meshData.indexData[idx];
     auto& vaoPair = m_vaos[idx];
 
@@ -32,13 +32,21 @@ source distribution.
 #include <crogine/graphics/TextureResource.hpp>
 #include <crogine/core/ConfigFile.hpp>
 
+#include <atomic>
+#include <ctime>
+
 using namespace cro;
 
+namespace
+{
+    std::atomic<std::uint64_t> emitterCount = 0;
+}
+
 ParticleEmitter::ParticleEmitter()
     : m_vbo                 (0),
-    m_vao                   (0),
-    m_particles             (MaxParticles),
+    m_firstVertex           (0),
     m_nextFreeParticle      (0),
+    m_random                (static_cast<std::uint64_t>(std::time(nullptr)) + (emitterCount++ << 32)),
     m_running               (false),
     m_emissionTime          (0.f),
     m_previousPosition      (0.f),
@@ -49,7 +57,7 @@ ParticleEmitter::ParticleEmitter()
     m_renderFlags           (std::numeric_limits<std::uint64_t>::max()),
     m_releaseCount          (-1)
 {
-
+    m_particles.resize(MaxParticles);
 }
 
 //void ParticleEmitter::applySettings(const EmitterSettings& es)
@@ -78,6 +86,83 @@ void ParticleEmitter::stop()
     m_releaseCount = -1;
 }
 
+void Detail::ParticleData::resize(std::size_t count)
+{
+    positionX.resize(count);
+    positionY.resize(count);
+    positionZ.resize(count);
+    velocityX.resize(count);
+    velocityY.resize(count);
+    velocityZ.resize(count);
+    gravityX.resize(count);
+    gravityY.resize(count);
+    gravityZ.resize(count);
+    red.resize(count);
+    green.resize(count);
+    blue.resize(count);
+    alpha.resize(count);
+    lifetime.resize(count);
+    maxLifetime.resize(count);
+    frameTime.resize(count);
+    rotation.resize(count);
+    scale.resize(count);
+    acceleration.resize(count);
+    frameID.resize(count);
+    loopCount.resize(count);
+}
+
+void Detail::ParticleData::set(std::size_t idx, const Particle& p)
+{
+    CRO_ASSERT(idx < size(), "Index out of range");
+    positionX[idx] = p.position.x;
+    positionY[idx] = p.position.y;
+    positionZ[idx] = p.position.z;
+    velocityX[idx] = p.velocity.x;
+    velocityY[idx] = p.velocity.y;
+    velocityZ[idx] = p.velocity.z;
+    gravityX[idx] = p.gravity.x;
+    gravityY[idx] = p.gravity.y;
+    gravityZ[idx] = p.gravity.z;
+    red[idx] = p.colour.getRed();
+    green[idx] = p.colour.getGreen();
+    blue[idx] = p.colour.getBlue();
+    alpha[idx] = p.colour.getAlpha();
+    lifetime[idx] = p.lifetime;
+    maxLifetime[idx] = p.maxLifeTime;
+    frameTime[idx] = p.frameTime;
+    rotation[idx] = p.rotation;
+    scale[idx] = p.scale;
+    acceleration[idx] = p.acceleration;
+    frameID[idx] = p.frameID;
+    loopCount[idx] = p.loopCount;
+}
+
+void Detail::ParticleData::move(std::size_t src, std::size_t dst)
+{
+    CRO_ASSERT(src < size() && dst < size(), "Index out of range");
+    positionX[dst] = positionX[src];
+    positionY[dst] = positionY[src];
+    positionZ[dst] = positionZ[src];
+    velocityX[dst] = velocityX[src];
+    velocityY[dst] = velocityY[src];
+    velocityZ[dst] = velocityZ[src];
+    gravityX[dst] = gravityX[src];
+    gravityY[dst] = gravityY[src];
+    gravityZ[dst] = gravityZ[src];
+    red[dst] = red[src];
+    green[dst] = green[src];
+    blue[dst] = blue[src];
+    alpha[dst] = alpha[src];
+    lifetime[dst] = lifetime[src];
+    maxLifetime[dst] = maxLifetime[src];
+    frameTime[dst] = frameTime[src];
+    rotation[dst] = rotation[src];
+    scale[dst] = scale[src];
+    acceleration[dst] = acceleration[src];
+    frameID[dst] = frameID[src];
+    loopCount[dst] = loopCount[src];
+}
+
 bool EmitterSettings::loadFromFile(const std::string& path, cro::TextureResource& textures)
 {
     ConfigFile cfg;
@@ -32,6 +32,9 @@ source distribution.
 #include <crogine/ecs/components/Skeleton.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 using namespace cro;
 
 void SkeletalAnim::resetInterp(const Skeleton& skel)
@@ -40,10 +43,36 @@ void SkeletalAnim::resetInterp(const Skeleton& skel)
     auto startIndex = currentFrame * skel.m_frameSize;
     for (auto i = 0u; i < skel.m_frameSize; ++i)
     {
-        interpolationOutput[i] = skel.m_frames[startIndex + i];
+        interpolationOutput.set(i, skel.m_frames[startIndex + i]);
     }
 }
 
+void JointPose::resize(std::size_t count)
+{
+    translation.resize(count);
+    scale.resize(count);
+    rotationX.resize(count);
+    rotationY.resize(count);
+    rotationZ.resize(count);
+    rotationW.resize(count);
+}
+
+void JointPose::set(std::size_t idx, const Joint& joint)
+{
+    CRO_ASSERT(idx < size(), "Index out of range");
+    translation[idx] = joint.translation;
+    scale[idx] = joint.scale;
+    rotationX[idx] = joint.rotation.x;
+    rotationY[idx] = joint.rotation.y;
+    rotationZ[idx] = joint.rotation.z;
+    rotationW[idx] = joint.rotation.w;
+}
+
+glm::quat JointPose::getRotation(std::size_t idx) const
+{
+    CRO_ASSERT(idx < size(), "Index out of range");
+    return glm::quat(rotationW[idx], rotationX[idx], rotationY[idx], rotationZ[idx]);
+}
 
 Skeleton::Skeleton()
     : m_playbackRate        (1.f),
@@ -220,6 +249,7 @@ bool Skeleton::addAnimation(const Skeleton& source, std::size_t idx)
         source.m_notifications.begin() + srcAnim.startFrame, source.m_notifications.begin() + srcAnim.startFrame + srcAnim.frameCount);
 
     m_frameCount += srcAnim.frameCount;
+    m_poseDataDirty = true;
     addAnimation(dstAnim);
 
     return true;
@@ -237,6 +267,7 @@ void Skeleton::addFrame(const std::vector<Joint>& frame)
     m_frames.insert(m_frames.end(), frame.begin(), frame.end());
     m_notifications.emplace_back();
     m_frameCount++;
+    m_poseDataDirty = true;
 }
 
 bool Skeleton::removeAnimation(std::size_t idx)
@@ -267,6 +298,7 @@ bool Skeleton::removeAnimation(std::size_t idx)
         }
     }
     m_frameCount -= frameCount;
+    m_poseDataDirty = true;
 
     return true;
 }
@@ -358,6 +390,46 @@ void Skeleton::buildKeyframe(std::size_t frame)
     }
 }
 
+void Skeleton::updatePoseData()
+{
+    m_keyFramePoses.resize(m_frames.size());
+    for (auto i = 0u; i < m_frames.size(); ++i)
+    {
+        m_keyFramePoses.set(i, m_frames[i]);
+    }
+
+    m_blendPose.resize(m_frameSize);
+    m_jointTransforms.resize(m_frameSize);
+
+    //the hierarchy is the same for every frame, so sort the joints
+    //by depth once, allowing a pose to be evaluated in a single pass
+    m_jointParents.resize(m_frameSize);
+    std::vector<std::uint32_t> depths(m_frameSize);
+    for (auto i = 0u; i < m_frameSize; ++i)
+    {
+        m_jointParents[i] = m_frames[i].parent;
+
+        auto parent = m_frames[i].parent;
+        while (parent != -1)
+        {
+            CRO_ASSERT(parent < static_cast<std::int32_t>(m_frameSize), "Parent index out of range");
+            CRO_ASSERT(depths[i] < m_frameSize, "Joint hierarchy contains a cycle");
+            depths[i]++;
+            parent = m_frames[parent].parent;
+        }
+    }
+
+    m_jointOrder.resize(m_frameSize);
+    std::iota(m_jointOrder.begin(), m_jointOrder.end(), 0);
+    std::stable_sort(m_jointOrder.begin(), m_jointOrder.end(),
+        [&depths](std::uint32_t a, std::uint32_t b)
+        {
+            return depths[a] < depths[b];
+        });
+
+    m_poseDataDirty = false;
+}
+
 //----attachment struct-----//
 void Attachment::setParent(std::int32_t parent)
 {
@@ -371,7 +443,7 @@ void Attachment::setModel(cro::Entity model)
         m_model.isValid() &&
         m_model.hasComponent<cro::Transform>())
     {
-        m_model.getComponent<cro::Transform>().m_attachmentTransform = glm::mat4(1.f);
+        m_model.getComponent<cro::Transform>().setAttachmentTransform(glm::mat4(1.f));
     }
 
     m_model = model;
@@ -44,9 +44,10 @@ Transform::Transform()
     m_scale                 (1.f, 1.f, 1.f),
     m_rotation              (1.f, 0.f, 0.f, 0.f),
     m_transform             (1.f),
+    m_worldTransform        (1.f),
     m_parent                (nullptr),
     m_depth                 (0),
-    m_dirtyFlags            (Flags::Tx),
+    m_dirtyFlags            (Flags::Tx | Flags::World),
     m_attachmentTransform   (1.f)
 {
 
@@ -58,9 +59,10 @@ Transform::Transform(Transform&& other) noexcept
     m_scale                 (1.f, 1.f, 1.f),
     m_rotation              (1.f, 0.f, 0.f, 0.f),
     m_transform             (1.f),
+    m_worldTransform        (1.f),
     m_parent                (nullptr),
     m_depth                 (0),
-    m_dirtyFlags            (Flags::Tx),
+    m_dirtyFlags            (Flags::Tx | Flags::World),
     m_attachmentTransform   (1.f)
 {
     CRO_ASSERT(other.m_parent != this, "Invalid assignment");
@@ -124,8 +126,9 @@ Transform::Transform(Transform&& other) noexcept
         setRotation(other.getRotation());
         setScale(other.getScale());
         setOrigin(other.getOrigin());
-        m_dirtyFlags = Flags::Tx;
         m_attachmentTransform = other.m_attachmentTransform;
+        m_dirtyFlags |= Flags::Tx;
+        markWorldDirty(true);
         m_callbacks.swap(other.m_callbacks);
 
         other.reset();
@@ -158,6 +161,7 @@ Transform& Transform::operator=(Transform&& other) noexcept
             {
                 c->decreaseDepth();
             }
+            c->markWorldDirty(true);
         }
 
         m_parent = other.m_parent;
@@ -203,8 +207,9 @@ Transform& Transform::operator=(Transform&& other) noexcept
         setRotation(other.getRotation());
         setScale(other.getScale());
         setOrigin(other.getOrigin());
-        m_dirtyFlags = Flags::Tx;
         m_attachmentTransform = other.m_attachmentTransform;
+        m_dirtyFlags |= Flags::Tx;
+        markWorldDirty(true);
         m_callbacks.swap(other.m_callbacks);
 
         other.reset();
@@ -229,6 +234,7 @@ Transform::~Transform()
         {
             c->decreaseDepth();
         }
+        c->markWorldDirty(true);
     }
 }
 
@@ -241,6 +247,7 @@ void Transform::setOrigin(glm::vec3 o)
 
     m_origin = o;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setOrigin(glm::vec2 o)
@@ -256,6 +263,7 @@ void Transform::setPosition(glm::vec3 position)
 
     m_position = position;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setPosition(glm::vec2 position)
@@ -267,6 +275,7 @@ void Transform::setPosition(glm::vec2 position)
     m_position.x = position.x;
     m_position.y = position.t;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setRotation(glm::vec3 axis, float angle)
@@ -278,6 +287,7 @@ void Transform::setRotation(glm::vec3 axis, float angle)
     glm::quat q = glm::quat(1.f, 0.f, 0.f, 0.f);
     m_rotation = glm::rotate(q, angle, axis);
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setRotation(float radians)
@@ -293,6 +303,7 @@ void Transform::setRotation(glm::quat rotation)
 
     m_rotation = rotation;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setRotation(glm::mat4 rotation)
@@ -302,6 +313,7 @@ void Transform::setRotation(glm::mat4 rotation)
 #endif
     m_rotation = glm::quat_cast(rotation);
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setScale(glm::vec3 scale)
@@ -311,6 +323,7 @@ void Transform::setScale(glm::vec3 scale)
 #endif
     m_scale = scale;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::setScale(glm::vec2 scale)
@@ -325,6 +338,7 @@ void Transform::move(glm::vec3 distance)
 #endif
     m_position += distance;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::move(glm::vec2 distance)
@@ -339,6 +353,7 @@ void Transform::rotate(glm::vec3 axis, float rotation)
 #endif
     m_rotation = glm::rotate(m_rotation, rotation, glm::normalize(axis));
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::rotate(float amount)
@@ -353,6 +368,7 @@ void Transform::rotate(glm::quat rotation)
 #endif
     m_rotation = rotation * m_rotation;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::rotate(glm::mat4 rotation)
@@ -362,6 +378,7 @@ void Transform::rotate(glm::mat4 rotation)
 #endif
     m_rotation = glm::quat_cast(rotation) * m_rotation;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::scale(glm::vec3 scale)
@@ -371,6 +388,7 @@ void Transform::scale(glm::vec3 scale)
 #endif
     m_scale *= scale;
     m_dirtyFlags |= Tx;
+    markWorldDirty();
 }
 
 void Transform::scale(glm::vec2 amount)
@@ -429,20 +447,30 @@ glm::vec3 Transform::getWorldScale() const
 
 glm::mat4 Transform::getLocalTransform() const
 {
-   
-    if (m_dirtyFlags & Tx)
+    if (m_dirtyFlags.load(std::memory_order_acquire) & Tx)
     {
-#ifdef USE_PARALLEL_PROCESSING
-        std::scoped_lock l(m_mutex);
-#endif 
-        m_transform = glm::translate(glm::mat4(1.f), m_position);
-        m_transform *= glm::toMat4(m_rotation);
-        m_transform = glm::scale(m_transform, m_scale);
-        m_transform = glm::translate(m_transform, -m_origin);
+        bool updated = false;
+        {
+            //another thread may have updated the matrix
+            //while we were waiting for the lock
+            std::scoped_lock l(m_mutex);
+            if (m_dirtyFlags.load(std::memory_order_relaxed) & Tx)
+            {
+                m_transform = glm::translate(glm::mat4(1.f), m_position);
+                m_transform *= glm::toMat4(m_rotation);
+                m_transform = glm::scale(m_transform, m_scale);
+                m_transform = glm::translate(m_transform, -m_origin);
 
-        m_dirtyFlags &= ~Tx;
+                m_dirtyFlags.fetch_and(~Tx, std::memory_order_release);
+                updated = true;
+            }
+        }
 
-        doCallbacks();
+        //outside the lock in case a callback reads this transform
+        if (updated)
+        {
+            doCallbacks();
+        }
     }
 
     return m_attachmentTransform * m_transform;
@@ -481,17 +509,31 @@ void Transform::setLocalTransform(glm::mat4 transform)
     //m_dirtyFlags |= Tx;
     m_transform = glm::translate(transform, -m_origin);
     m_dirtyFlags &= ~Tx;
+    markWorldDirty();
 
     doCallbacks();
 }
 
 glm::mat4 Transform::getWorldTransform() const
 {
-    if (m_parent)
+    //the parent's world transform is cached too, so this
+    //is only ever one multiplication, regardless of depth
+    if (m_dirtyFlags.load(std::memory_order_acquire) & World)
     {
-        return m_parent->getWorldTransform() * getLocalTransform();
+        //these take their own locks
+        const auto worldTransform = m_parent ?
+            m_parent->getWorldTransform() * getLocalTransform() :
+            getLocalTransform();
+
+        std::scoped_lock l(m_mutex);
+        if (m_dirtyFlags.load(std::memory_order_relaxed) & World)
+        {
+            m_worldTransform = worldTransform;
+            m_worldUpdateCount.fetch_add(1, std::memory_order_relaxed);
+            m_dirtyFlags.fetch_and(~World, std::memory_order_release);
+        }
     }
-    return getLocalTransform();
+    return m_worldTransform;
 }
 
 glm::vec3 Transform::getForwardVector() const
@@ -556,6 +598,7 @@ bool Transform::addChild(Transform& child)
         {
             child.decreaseDepth();
         }
+        child.markWorldDirty(true);
 
 
         {
@@ -587,6 +630,7 @@ void Transform::removeChild(Transform& tx)
     {
         tx.decreaseDepth();
     }
+    tx.markWorldDirty(true);
 
 #ifdef USE_PARALLEL_PROCESSING
     std::scoped_lock l(m_mutex);
@@ -617,6 +661,7 @@ void Transform::reset()
     m_scale = glm::vec3(1.f, 1.f, 1.f);
     m_rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
     m_transform = glm::mat4(1.f);
+    m_worldTransform = glm::mat4(1.f);
     m_parent = nullptr;
     m_dirtyFlags = 0;
     m_depth = 0;
@@ -626,6 +671,26 @@ void Transform::reset()
     m_children.clear();
 }
 
+void Transform::markWorldDirty(bool force)
+{
+    //if we're already dirty then so are all our children
+    if ((m_dirtyFlags.fetch_or(World) & World) && !force)
+    {
+        return;
+    }
+
+    for (auto c : m_children)
+    {
+        c->markWorldDirty(force);
+    }
+}
+
+void Transform::setAttachmentTransform(const glm::mat4& transform)
+{
+    m_attachmentTransform = transform;
+    markWorldDirty();
+}
+
 void Transform::doCallbacks() const
 {
     for (auto& c : m_callbacks)
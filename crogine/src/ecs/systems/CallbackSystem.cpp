@@ -30,6 +30,7 @@ source distribution.
 #include <crogine/ecs/systems/CallbackSystem.hpp>
 #include <crogine/ecs/components/Callback.hpp>
 #include <crogine/core/Clock.hpp>
+#include <crogine/ecs/Scene.hpp>
 
 using namespace cro;
 
@@ -41,13 +42,15 @@ CallbackSystem::CallbackSystem(MessageBus& mb)
 
 void CallbackSystem::process(float dt)
 {
-    auto& entities = getEntities();
-    for (auto& entity : entities)
-    {
-        auto& cb = entity.getComponent<Callback>();
-        if (cb.active)
+    //callbacks are packed, so walking the pool is linear. Entities
+    //which were created this frame aren't in the system yet, so are
+    //skipped, just as if the entity list were being used.
+    getScene()->forEachComponent<Callback>([&](Entity entity, Callback& cb)
         {
-            cb.function(entity, dt);
-        }
-    }
+            if (cb.active
+                && hasEntity(entity))
+            {
+                cb.function(entity, dt);
+            }
+        });
 }
\ No newline at end of file
@@ -43,6 +43,8 @@ CameraSystem::CameraSystem(cro::MessageBus& mb)
 {
     requireComponent<Camera>();
     requireComponent<Transform>();
+
+    subscribe(Message::WindowMessage);
 }
 
 //public
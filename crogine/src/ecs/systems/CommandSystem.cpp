@@ -30,9 +30,34 @@ source distribution.
 #include <crogine/ecs/components/CommandTarget.hpp>
 #include <crogine/ecs/systems/CommandSystem.hpp>
 #include <crogine/core/Clock.hpp>
+#include <crogine/detail/Assert.hpp>
+
+//#define PARALLEL_DISABLE
+#ifdef PARALLEL_DISABLE
+#undef USE_PARALLEL_PROCESSING
+#endif
+
+#ifdef USE_PARALLEL_PROCESSING
+#include <execution>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 
 using namespace cro;
 
+namespace cro::Detail
+{
+    struct ChangedTargets final
+    {
+        //IDs may be changed by commands executed in parallel
+        std::mutex mutex;
+        std::vector<std::uint32_t> entityIndices;
+        std::atomic<bool> pending{ false };
+    };
+}
+
 namespace
 {
     //this can be made larger if necessary, is only used to prevent continual reallocation of heap memory
@@ -45,7 +70,8 @@ CommandSystem::CommandSystem(MessageBus& mb)
     : System        (mb, typeid(CommandSystem)),
     m_commands      (MaxCommands),
     m_commandBuffer (MaxCommands),
-    m_count         (0)
+    m_count         (0),
+    m_changedTargets(std::make_shared<Detail::ChangedTargets>())
 {
     requireComponent<CommandTarget>();
 }
@@ -61,20 +87,175 @@ void CommandSystem::sendCommand(const Command& cmd)
 
 void CommandSystem::process(float dt)
 {
+    //IDs may also have been changed outside of commands since the last update
+    sortChangedTargets();
+
     auto count = m_count;
     m_count = 0;
     m_commands.swap(m_commandBuffer);
 
-    auto& entities = getEntities();
+    if (count == 0)
+    {
+        return;
+    }
 
     for (auto i = 0u; i < count; ++i)
     {
-        for (auto& e : entities)
+        const auto& cmd = m_commands[i];
+
+        for (auto bit = 0u; bit < m_buckets.size() && (cmd.targetFlags >> bit) != 0; ++bit)
+        {
+            const auto flag = (1u << bit);
+            if ((cmd.targetFlags & flag) == 0)
+            {
+                continue;
+            }
+
+            //entities matching more than one flag are only
+            //visited from the bucket of the lowest matching flag
+            const auto lowerFlags = cmd.targetFlags & (flag - 1);
+            const auto execute = [&, lowerFlags](Entity e)
+            {
+                if ((m_targetIDs[e.getIndex()] & lowerFlags) == 0
+                    && (e.getComponent<CommandTarget>().ID & cmd.targetFlags))
+                {
+                    cmd.action(e, dt);
+                }
+            };
+
+            const auto& bucket = m_buckets[bit];
+#ifdef USE_PARALLEL_PROCESSING
+            if (cmd.parallel)
+            {
+                std::for_each(std::execution::par, bucket.begin(), bucket.end(), execute);
+            }
+            else
+#endif
+            {
+                std::for_each(bucket.begin(), bucket.end(), execute);
+            }
+        }
+
+        //so that flags added by this command are matched by the next
+        sortChangedTargets();
+    }
+}
+
+//private
+void CommandSystem::addToBuckets(Entity entity, std::uint32_t id)
+{
+    for (auto bit = 0u; bit < m_buckets.size() && (id >> bit) != 0; ++bit)
+    {
+        if (id & (1u << bit))
+        {
+            auto& slots = m_bucketSlots[bit];
+            if (slots.size() <= entity.getIndex())
+            {
+                slots.resize(entity.getIndex() + 1, 0);
+            }
+
+            auto& bucket = m_buckets[bit];
+            slots[entity.getIndex()] = static_cast<std::uint32_t>(bucket.size());
+            bucket.push_back(entity);
+        }
+    }
+}
+
+void CommandSystem::removeFromBuckets(Entity entity, std::uint32_t id)
+{
+    for (auto bit = 0u; bit < m_buckets.size() && (id >> bit) != 0; ++bit)
+    {
+        if (id & (1u << bit))
+        {
+            auto& bucket = m_buckets[bit];
+            auto& slots = m_bucketSlots[bit];
+
+            const auto slot = slots[entity.getIndex()];
+            CRO_ASSERT(slot < bucket.size() && bucket[slot] == entity, "");
+
+            const auto last = bucket.back();
+            bucket[slot] = last;
+            slots[last.getIndex()] = slot;
+            bucket.pop_back();
+        }
+    }
+}
+
+void CommandSystem::sortChangedTargets()
+{
+    if (!m_changedTargets->pending)
+    {
+        return;
+    }
+
+    {
+        std::scoped_lock lock(m_changedTargets->mutex);
+        m_changedIndices.swap(m_changedTargets->entityIndices);
+        m_changedTargets->pending = false;
+    }
+
+    for (auto index : m_changedIndices)
+    {
+        //components copied from another entity may report the
+        //other entity's index until they're added to the system
+        if (index < m_targets.size()
+            && m_targets[index].getIndex() == index)
         {
-            if (e.getComponent<CommandTarget>().ID & m_commands[i].targetFlags)
+            const auto entity = m_targets[index];
+            const std::uint32_t id = entity.getComponent<CommandTarget>().ID;
+            auto& sortedID = m_targetIDs[index];
+            if (id != sortedID)
             {
-                m_commands[i].action(e, dt);
+                removeFromBuckets(entity, sortedID);
+                addToBuckets(entity, id);
+                sortedID = id;
             }
         }
     }
-}
\ No newline at end of file
+    m_changedIndices.clear();
+}
+
+void CommandSystem::onEntityAdded(Entity entity)
+{
+    if (m_targetIDs.size() <= entity.getIndex())
+    {
+        m_targetIDs.resize(entity.getIndex() + 1, 0);
+        m_targets.resize(entity.getIndex() + 1);
+    }
+
+    auto& target = entity.getComponent<CommandTarget>();
+    target.ID.m_changedTargets = m_changedTargets;
+    target.ID.m_entityIndex = entity.getIndex();
+
+    const std::uint32_t id = target.ID;
+    addToBuckets(entity, id);
+    m_targetIDs[entity.getIndex()] = id;
+    m_targets[entity.getIndex()] = entity;
+}
+
+void CommandSystem::onEntityRemoved(Entity entity)
+{
+    entity.getComponent<CommandTarget>().ID.m_changedTargets.reset();
+
+    removeFromBuckets(entity, m_targetIDs[entity.getIndex()]);
+    m_targetIDs[entity.getIndex()] = 0;
+    m_targets[entity.getIndex()] = Entity();
+}
+
+void CommandTarget::TargetID::setID(std::uint32_t id)
+{
+    m_id = id;
+
+    if (m_changedTargets)
+    {
+        std::scoped_lock lock(m_changedTargets->mutex);
+        m_changedTargets->entityIndices.push_back(m_entityIndex);
+        m_changedTargets->pending = true;
+    }
+}
+
+#ifdef PARALLEL_DISABLE
+#ifndef PARALLEL_GLOBAL_DISABLE
+#define USE_PARALLEL_PROCESSING
+#endif
+#endif
\ No newline at end of file
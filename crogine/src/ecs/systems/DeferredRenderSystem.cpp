@@ -163,9 +163,18 @@ void DeferredRenderSystem::updateDrawList(Entity camera)
     deferred.clear(); //TODO if we had a dirty flag on the cam transform we could only update this if the camera moved...
     forward.clear();
 
+    //TODO we *could* do every camera pass - but for now we're
+    //expecting screen space reflections rather than using camera reflection mapping
+    const auto& frustum = cam.getPass(Camera::Pass::Final).getFrustum();
+    auto forwardVector = cro::Util::Matrix::getForwardVector(cam.getPass(Camera::Pass::Final).viewMatrix);
+
+    //gather the bounds of the models to test them as a batch
+    m_candidates.clear();
+    m_spheres.clear();
+
     for (auto& entity : entities)
     {
-        auto& model = entity.getComponent<Model>();
+        const auto& model = entity.getComponent<Model>();
         if (model.isHidden())
         {
             continue;
@@ -180,65 +189,63 @@ void DeferredRenderSystem::updateDrawList(Entity camera)
         auto scale = tx.getScale();
         sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
 
-        //TODO we *could* do every camera pass - but for now we're
-        //expecting screen space reflections rather than using camera reflection mapping
+        m_candidates.push_back(entity);
+        m_spheres.push_back(sphere);
+    }
+
+    Spatial::intersects(frustum, m_spheres, m_visibility);
+
+    for (auto j = 0u; j < m_candidates.size(); ++j)
+    {
+        if (!Spatial::isVisible(m_visibility, j))
+        {
+            continue;
+        }
+
+        auto entity = m_candidates[j];
+        const auto& model = entity.getComponent<Model>();
+        const auto sphere = m_spheres[j];
+
+        auto direction = (sphere.centre - cameraPos);
+        float distance = glm::dot(forwardVector, direction);
+
+        SortData d;
+        d.entity = entity;
+        d.distanceFromCamera = distance;
+
+        SortData f;
+        f.entity = entity;
+        d.distanceFromCamera = distance;
 
-        //for(pass in cam.passes)
-        //{
-            const auto& frustum = cam.getPass(Camera::Pass::Final).getFrustum();
-            auto forwardVector = cro::Util::Matrix::getForwardVector(cam.getPass(Camera::Pass::Final).viewMatrix);
+        //TODO a large model with a centre behind the camera
+        //might still intersect the view but register as being
+        //further away than smaller objects in front
 
-            bool visible = true;
-            std::size_t i = 0;
-            while (visible && i < frustum.size())
+        //foreach material
+        //add ent/index pair to deferred or forward list
+        for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
+        {
+            if (!model.m_materials[Mesh::IndexData::Final][i].deferred)
             {
-                visible = (Spatial::intersects(frustum[i++], sphere) != Planar::Back);
+                f.materialIDs.push_back(static_cast<std::int32_t>(i));
             }
-
-            if (visible)
+            else
             {
-                auto direction = (sphere.centre - cameraPos);
-                float distance = glm::dot(forwardVector, direction);
-
-                SortData d;
-                d.entity = entity;
-                d.distanceFromCamera = distance;
-
-                SortData f;
-                f.entity = entity;
-                d.distanceFromCamera = distance;
-
-                //TODO a large model with a centre behind the camera
-                //might still intersect the view but register as being
-                //further away than smaller objects in front
-
-                //foreach material
-                //add ent/index pair to deferred or forward list
-                for (i = 0u; i < model.m_meshData.submeshCount; ++i)
-                {
-                    if (!model.m_materials[Mesh::IndexData::Final][i].deferred)
-                    {
-                        f.materialIDs.push_back(static_cast<std::int32_t>(i));
-                    }
-                    else
-                    {
-                        d.materialIDs.push_back(static_cast<std::int32_t>(i));
-                    }
-                }
-
-                //store the entity in the appropriate list
-                //if it has any materials associated with it
-                if (!d.materialIDs.empty())
-                {
-                    deferred.push_back(d);
-                }
-
-                if (!f.materialIDs.empty())
-                {
-                    forward.push_back(f);
-                }
+                d.materialIDs.push_back(static_cast<std::int32_t>(i));
             }
-        //}
+        }
+
+        //store the entity in the appropriate list
+        //if it has any materials associated with it
+        if (!d.materialIDs.empty())
+        {
+            deferred.push_back(d);
+        }
+
+        if (!f.materialIDs.empty())
+        {
+            forward.push_back(f);
+        }
     }
     
     //sort deferred list by distance to Camera.
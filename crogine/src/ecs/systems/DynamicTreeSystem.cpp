@@ -39,7 +39,9 @@ DynamicTreeSystem::DynamicTreeSystem(MessageBus& mb, float unitsPerMetre)
     m_tree  (unitsPerMetre)
 {
     requireComponent<DynamicTreeComponent>();
-    requireComponent<Transform>();
+    requireComponent<Transform>(ComponentAccess::Read);
+
+    setExecutionPolicy(ExecutionPolicy::Concurrent);
 }
 
 //public
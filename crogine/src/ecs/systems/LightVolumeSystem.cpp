@@ -55,7 +55,6 @@ source distribution.
 
 #ifdef USE_PARALLEL_PROCESSING
 #include <execution>
-#include <mutex>
 #endif
 
 #ifdef CRO_DEBUG_
@@ -236,69 +235,60 @@ void LightVolumeSystem::updateDrawList(Entity cameraEnt)
     //TODO this only does lighting on the output pass, not the reflection
     //though this is probably enough for our case
 
-    //TODO - and this goes for all culling functions
-    //the world space transform of the sphere could be cached for a frame
-    //instead of being recalculated for every active camera
-#ifdef USE_PARALLEL_PROCESSING
-    std::mutex mutex;
-    std::for_each(std::execution::par, entities.cbegin(), entities.cend(), 
-        [&](Entity entity)
-#else
+    //lights which pass the distance checks are gathered
+    //first so their bounds can be frustum tested as a batch
+    m_candidates.clear();
+    m_spheres.clear();
+
     for (auto entity : entities)
-#endif
+    {
+        const auto& model = entity.getComponent<Model>();
+        auto sphere = model.getBoundingSphere();
+        const auto& tx = entity.getComponent<Transform>();
+
+        sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
+        auto scale = tx.getWorldScale();
 
+        if (scale.x * scale.y * scale.z == 0)
         {
-            const auto& model = entity.getComponent<Model>();
-            auto sphere = model.getBoundingSphere();
-            const auto& tx = entity.getComponent<Transform>();
+            continue;
+        }
 
-            sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
-            auto scale = tx.getWorldScale();
+        //average for non-uniform scale
+        sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
 
-            if (scale.x * scale.y * scale.z == 0)
-            {
-                EARLY_OUT;
-            }
+        const auto direction = (sphere.centre - cameraPos);
+        const float distance = glm::dot(camComponent.getPass(Camera::Pass::Final).forwardVector, direction);
 
-            //average for non-uniform scale
-            sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+        if (distance < -sphere.radius)
+        {
+            //model is behind the camera
+            continue;
+        }
 
-            const auto direction = (sphere.centre - cameraPos);
-            const float distance = glm::dot(camComponent.getPass(Camera::Pass::Final).forwardVector, direction);
+        const auto& light = entity.getComponent<LightVolume>();
+        const auto l2 = glm::length2(direction);
+        if (l2 > light.maxVisibilityDistance)
+        {
+            //model is out of bounds
+            continue;
+        }
 
-            if (distance < -sphere.radius)
-            {
-                //model is behind the camera
-                EARLY_OUT;
-            }
+        m_candidates.emplace_back(entity, l2);
+        m_spheres.push_back(sphere);
+    }
 
+    Spatial::intersects(frustum, m_spheres, m_visibility);
+    for (auto i = 0u; i < m_candidates.size(); ++i)
+    {
+        if (Spatial::isVisible(m_visibility, i))
+        {
+            auto [entity, l2] = m_candidates[i];
             auto& light = entity.getComponent<LightVolume>();
-            const auto l2 = glm::length2(direction);
-            if (l2 > light.maxVisibilityDistance)
-            {
-                //model is out of bounds
-                EARLY_OUT;
-            }
-
-            bool visible = true;
-            std::size_t j = 0;
-            while (visible && j < frustum.size())
-            {
-                visible = (Spatial::intersects(frustum[j++], sphere) != Planar::Back);
-            }
-
-            if (visible)
-            {
-                light.cullAttenuation = 1.f - smoothstep(light.maxVisibilityDistance - (light.maxVisibilityDistance * 0.33f), light.maxVisibilityDistance, l2);
-#ifdef USE_PARALLEL_PROCESSING
-                std::scoped_lock l(mutex);
-#endif
-                drawList.push_back(entity);
-            }
+            light.cullAttenuation = 1.f - smoothstep(light.maxVisibilityDistance - (light.maxVisibilityDistance * 0.33f), light.maxVisibilityDistance, l2);
+            drawList.push_back(entity);
         }
-#ifdef USE_PARALLEL_PROCESSING
-    );
-#endif
+    }
 }
 
 void LightVolumeSystem::updateTarget(Entity camera, RenderTexture& target)
@@ -44,6 +44,7 @@ source distribution.
 #include <crogine/util/Frustum.hpp>
 
 #include <crogine/detail/Assert.hpp>
+#include <crogine/detail/SortKey.hpp>
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
 #include <crogine/detail/glm/gtc/matrix_transform.hpp>
 #include <crogine/detail/glm/gtc/matrix_inverse.hpp>
@@ -56,27 +57,151 @@ source distribution.
 
 #ifdef USE_PARALLEL_PROCESSING
 #include <execution>
-#include <mutex>
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 using namespace cro;
 
 namespace
 {
+    //materials are copied by value into Models so there's no persistent
+    //ID - instead use the first texture to group draws sharing textures
+    std::uint32_t materialKey(const Material::Data& material)
+    {
+        for (const auto& [name, prop] : material.properties)
+        {
+            switch (prop.second.type)
+            {
+            default: break;
+            case Material::Property::Texture:
+            case Material::Property::TextureArray:
+            case Material::Property::Cubemap:
+            case Material::Property::CubemapArray:
+                return prop.second.textureID;
+            }
+        }
+        return 0;
+    }
+
+    bool sameProperty(const Material::Property& a, const Material::Property& b)
+    {
+        if (a.type != b.type)
+        {
+            return false;
+        }
+
+        switch (a.type)
+        {
+        default: return true;
+        case Material::Property::Number:
+            return a.numberValue == b.numberValue;
+        case Material::Property::Vec2:
+            return std::memcmp(a.vecValue, b.vecValue, sizeof(float) * 2) == 0;
+        case Material::Property::Vec3:
+            return std::memcmp(a.vecValue, b.vecValue, sizeof(float) * 3) == 0;
+        case Material::Property::Vec4:
+            return std::memcmp(a.vecValue, b.vecValue, sizeof(float) * 4) == 0;
+        case Material::Property::Mat4:
+            return a.matrixValue == b.matrixValue;
+        case Material::Property::Texture:
+        case Material::Property::TextureArray:
+        case Material::Property::Cubemap:
+        case Material::Property::CubemapArray:
+            return a.textureID == b.textureID;
+        }
+    }
+
+    //materials are copies so compare by value
+    bool sameMaterial(const Material::Data& a, const Material::Data& b)
+    {
+        if (&a == &b)
+        {
+            return true;
+        }
+
+        if (a.shader != b.shader
+            || a.blendMode != b.blendMode
+            || a.doubleSided != b.doubleSided
+            || a.enableDepthTest != b.enableDepthTest
+            || a.properties.size() != b.properties.size())
+        {
+            return false;
+        }
+
+        for (const auto& [name, prop] : a.properties)
+        {
+            const auto result = b.properties.find(name);
+            if (result == b.properties.end()
+                || !sameProperty(prop.second, result->second.second))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //shaders compiled with INSTANCING read the world transform from
+    //per-instance attributes, which are only arrays when actually instanced.
+    //When drawing singly the attributes are set to identity instead.
+    void setInstanceDefaults(const Material::Data& material)
+    {
+        const auto transformAttrib = material.attribs[Shader::AttributeID::InstanceTransform][Material::Data::Index];
+        if (transformAttrib == -1)
+        {
+            return;
+        }
 
+        for (auto j = 0u; j < 4u; ++j)
+        {
+            glCheck(glVertexAttrib4f(transformAttrib + j, j == 0 ? 1.f : 0.f, j == 1 ? 1.f : 0.f, j == 2 ? 1.f : 0.f, j == 3 ? 1.f : 0.f));
+        }
+
+        const auto normalAttrib = material.attribs[Shader::AttributeID::InstanceNormal][Material::Data::Index];
+        if (normalAttrib != -1)
+        {
+            for (auto j = 0u; j < 3u; ++j)
+            {
+                glCheck(glVertexAttrib3f(normalAttrib + j, j == 0 ? 1.f : 0.f, j == 1 ? 1.f : 0.f, j == 2 ? 1.f : 0.f));
+            }
+        }
+    }
 }
 
 ModelRenderer::ModelRenderer(MessageBus& mb)
     : System        (mb, typeid(ModelRenderer)),
     m_drawLists     (1),
-    m_pass          (Mesh::IndexData::Final)/*,
+    m_pass          (Mesh::IndexData::Final),
     m_tree          (1.f),
-    m_useTreeQueries(false)*/
+    m_useTreeQueries(false),
+    m_treeDirty     (true)
 {
     requireComponent<Transform>();
     requireComponent<Model>();
 }
 
+ModelRenderer::~ModelRenderer()
+{
+#ifdef PLATFORM_DESKTOP
+    if (m_instanceBuffers.transformBuffer)
+    {
+        glCheck(glDeleteBuffers(1, &m_instanceBuffers.transformBuffer));
+    }
+
+    if (m_instanceBuffers.normalBuffer)
+    {
+        glCheck(glDeleteBuffers(1, &m_instanceBuffers.normalBuffer));
+    }
+
+    if (m_instanceBuffers.vao)
+    {
+        glCheck(glDeleteVertexArrays(1, &m_instanceBuffers.vao));
+    }
+#endif
+}
+
 //public
 void ModelRenderer::updateDrawList(Entity cameraEnt)
 {
@@ -86,11 +211,11 @@ void ModelRenderer::updateDrawList(Entity cameraEnt)
         m_drawLists.resize(camComponent.getDrawListIndex() + 1);
     }
 
-    /*if (m_useTreeQueries)
+    if (m_useTreeQueries)
     {
         updateDrawListBalancedTree(cameraEnt);
     }
-    else*/
+    else
     {
         updateDrawListDefault(cameraEnt);
     }
@@ -136,29 +261,18 @@ void ModelRenderer::updateDrawList(Entity cameraEnt)
 
 void ModelRenderer::process(float dt)
 {
+    m_drawStats = {};
+
     auto& entities = getEntities();
     for (auto entity : entities)
     {
         auto& model = entity.getComponent<Model>();
         model.updateMaterialAnimations(dt);
-
-        /*if (m_useTreeQueries)
-        {
-            if (!entity.destroyed())
-            {
-                const auto& tx = entity.getComponent<Transform>();
-                auto worldPosition = tx.getWorldPosition();
-                auto worldBounds = model.getAABB();
-
-                worldBounds += tx.getOrigin();
-                worldBounds = tx.getWorldTransform() * worldBounds;
-
-                m_tree.moveNode(model.m_treeID, worldBounds, worldPosition - model.m_lastWorldPosition);
-
-                model.m_lastWorldPosition = worldPosition;
-            }
-        }*/
     }
+
+    //the tree is updated on demand by the first query each frame
+    //as cameras may be updated before or after this system
+    m_treeDirty = true;
 }
 
 void ModelRenderer::render(Entity camera, const RenderTarget& rt)
@@ -178,8 +292,23 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
 
         //DPRINT("Render count", std::to_string(m_visibleEntities.size()));
         const auto& visibleEntities = m_drawLists[camComponent.getDrawListIndex()][camComponent.getActivePassIndex()];
-        for (const auto& [entity, sortData] : visibleEntities)
+
+        //the draw list is sorted by state so track what the
+        //previous draw set and only update what changed
+        auto& state = m_stateCache;
+        state.reset();
+
+        std::uint32_t currentProgram = 0;
+        std::uint32_t currentFacing = 0;
+        const Material::Data* currentMaterial = nullptr;
+        std::int32_t currentBlendMode = -1;
+        std::int32_t currentDoubleSided = -1;
+        std::int32_t currentDepthTest = -1;
+
+        for (auto e = 0u; e < visibleEntities.size(); ++e)
         {
+            const auto& [entity, sortData] = visibleEntities[e];
+
             //may have been marked for deletion - OK to draw but will trigger assert
 #ifdef CRO_DEBUG_
             if (!entity.isValid())
@@ -190,11 +319,39 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
 
             //foreach submesh / material:
             const auto& model = entity.getComponent<Model>();
-            glCheck(glFrontFace(model.m_facing));
+            if (model.m_facing != currentFacing)
+            {
+                glCheck(glFrontFace(model.m_facing));
+                currentFacing = model.m_facing;
+            }
+
+            //look for a run of entries with identical meshes and materials
+            //which can be submitted as a single instanced draw
+            std::size_t instanceCount = 1;
+#ifdef PLATFORM_DESKTOP
+            if (canInstance(visibleEntities[e]))
+            {
+                while (e + instanceCount < visibleEntities.size()
+                    && canBatch(visibleEntities[e], visibleEntities[e + instanceCount]))
+                {
+                    instanceCount++;
+                }
+
+                if (instanceCount < MinInstanceCount)
+                {
+                    instanceCount = 1;
+                }
+                else
+                {
+                    uploadInstanceData(visibleEntities, e, instanceCount);
+                }
+            }
+#endif
 
-            //calc entity transform
+            //calc entity transform - instanced draws have their world
+            //transforms in the instance buffer, and are drawn with identity
             const auto& tx = entity.getComponent<Transform>();
-            const glm::mat4 worldMat = tx.getWorldTransform();
+            const glm::mat4 worldMat = instanceCount == 1 ? tx.getWorldTransform() : glm::mat4(1.f);
             const glm::mat4 worldView = pass.viewMatrix * worldMat;
             const glm::mat3 normalMat = glm::inverseTranspose(glm::mat3(worldMat));
 
@@ -202,41 +359,113 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
             glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.m_meshData.vbo));
 #endif //PLATFORM
 
+            //all submeshes in an entry share a shader, so
+            //the entity uniforms only need setting once
+            bool applyEntity = true;
+
             for (auto i : sortData.matIDs)
             {
+#ifdef PLATFORM_DESKTOP
+                //batches of materials without instancing support are drawn with the shader's instanced variant
+                const auto& modelMaterial = model.m_materials[Mesh::IndexData::Final][i];
+                const auto& material = (instanceCount > 1 && modelMaterial.attribs[Shader::AttributeID::InstanceTransform][Material::Data::Index] == -1)
+                    ? getInstancedMaterial(modelMaterial) : modelMaterial;
+#else
+                const auto& material = model.m_materials[Mesh::IndexData::Final][i];
+#endif
+
                 //bind shader
-                glCheck(glUseProgram(model.m_materials[Mesh::IndexData::Final][i].shader));
+                state.applyGlobal = false;
+                if (material.shader != currentProgram)
+                {
+                    glCheck(glUseProgram(material.shader));
+                    currentProgram = material.shader;
+                    state.stats.programSwitches++;
 
-                //apply shader uniforms from material
-                glCheck(glUniformMatrix4fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::WorldView], 1, GL_FALSE, glm::value_ptr(worldView)));
-                applyProperties(model.m_materials[Mesh::IndexData::Final][i], model, *getScene(), camComponent);
+                    if (std::find(state.programs.begin(), state.programs.end(), currentProgram) == state.programs.end())
+                    {
+                        state.programs.push_back(currentProgram);
+                        state.applyGlobal = true;
+                    }
+                    applyEntity = true;
+                }
+                state.applyMaterial = (&material != currentMaterial) || state.applyGlobal;
+#ifdef PLATFORM_DESKTOP
+                //the instanced material is reused for every batch, so its address says nothing
+                currentMaterial = (&material == &m_instancedMaterial) ? nullptr : &material;
+#else
+                currentMaterial = &material;
+#endif
+
+                //apply standard uniforms - uniform values are stored per program
+                //so these only need setting the first time a shader is used
+                if (state.applyGlobal)
+                {
+                    glCheck(glUniform3f(material.uniforms[Material::Camera], cameraPosition.x, cameraPosition.y, cameraPosition.z));
+                    glCheck(glUniform2f(material.uniforms[Material::ScreenSize], screenSize.x, screenSize.y));
+                    glCheck(glUniform4f(material.uniforms[Material::ClipPlane], clipPlane[0], clipPlane[1], clipPlane[2], clipPlane[3]));
+                    glCheck(glUniformMatrix4fv(material.uniforms[Material::View], 1, GL_FALSE, glm::value_ptr(pass.viewMatrix)));
+                    glCheck(glUniformMatrix4fv(material.uniforms[Material::ViewProjection], 1, GL_FALSE, glm::value_ptr(pass.viewProjectionMatrix)));
+                    glCheck(glUniformMatrix4fv(material.uniforms[Material::Projection], 1, GL_FALSE, glm::value_ptr(camComponent.getProjectionMatrix())));
+                    state.stats.uniformCalls += 6;
+                }
+
+                if (applyEntity)
+                {
+                    glCheck(glUniformMatrix4fv(material.uniforms[Material::WorldView], 1, GL_FALSE, glm::value_ptr(worldView)));
+                    glCheck(glUniformMatrix4fv(material.uniforms[Material::World], 1, GL_FALSE, glm::value_ptr(worldMat)));
+                    glCheck(glUniformMatrix3fv(material.uniforms[Material::Normal], 1, GL_FALSE, glm::value_ptr(normalMat)));
+                    state.stats.uniformCalls += 3;
+                    applyEntity = false;
+                }
 
-                //apply standard uniforms
-                glCheck(glUniform3f(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::Camera], cameraPosition.x, cameraPosition.y, cameraPosition.z));
-                glCheck(glUniform2f(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::ScreenSize], screenSize.x, screenSize.y));
-                glCheck(glUniform4f(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::ClipPlane], clipPlane[0], clipPlane[1], clipPlane[2], clipPlane[3]));
-                glCheck(glUniformMatrix4fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::View], 1, GL_FALSE, glm::value_ptr(pass.viewMatrix)));
-                glCheck(glUniformMatrix4fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::ViewProjection], 1, GL_FALSE, glm::value_ptr(pass.viewProjectionMatrix)));
-                glCheck(glUniformMatrix4fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::Projection], 1, GL_FALSE, glm::value_ptr(camComponent.getProjectionMatrix())));
-                glCheck(glUniformMatrix4fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::World], 1, GL_FALSE, glm::value_ptr(worldMat)));
-                glCheck(glUniformMatrix3fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::Normal], 1, GL_FALSE, glm::value_ptr(normalMat)));
+                //apply shader uniforms from material
+                applyProperties(material, model, *getScene(), camComponent, &state);
 
-                applyBlendMode(model.m_materials[Mesh::IndexData::Final][i]/*.blendMode*/);
+                if (material.blendMode == Material::BlendMode::Custom
+                    || static_cast<std::int32_t>(material.blendMode) != currentBlendMode)
+                {
+                    applyBlendMode(material);
+                    currentBlendMode = static_cast<std::int32_t>(material.blendMode);
+                    currentDepthTest = -1; //blend modes may enable depth testing
+                }
 
                 //TODO move these to custom settings list
-                glCheck(model.m_materials[Mesh::IndexData::Final][i].doubleSided ? glDisable(GL_CULL_FACE) : glEnable(GL_CULL_FACE));
-                glCheck(model.m_materials[Mesh::IndexData::Final][i].enableDepthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST));
+                if (static_cast<std::int32_t>(material.doubleSided) != currentDoubleSided)
+                {
+                    glCheck(material.doubleSided ? glDisable(GL_CULL_FACE) : glEnable(GL_CULL_FACE));
+                    currentDoubleSided = static_cast<std::int32_t>(material.doubleSided);
+                }
+                if (static_cast<std::int32_t>(material.enableDepthTest) != currentDepthTest)
+                {
+                    glCheck(material.enableDepthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST));
+                    currentDepthTest = static_cast<std::int32_t>(material.enableDepthTest);
+                }
 
-                model.m_materials[Mesh::IndexData::Final][i].enableCustomSettings();
+                material.enableCustomSettings();
 
 #ifdef PLATFORM_DESKTOP
-                model.draw(i, Mesh::IndexData::Final);
+                if (instanceCount > 1)
+                {
+                    drawInstanced(model, material, i, instanceCount);
+                    state.stats.instancedDraws++;
+                }
+                else
+                {
+                    if (model.m_instanceBuffers.instanceCount == 0)
+                    {
+                        setInstanceDefaults(material);
+                    }
+                    model.draw(i, Mesh::IndexData::Final);
+                }
 
 #else //GLES 2 doesn't have VAO support without extensions
 
+                setInstanceDefaults(material);
+
                 //bind attribs
-                const auto& attribs = model.m_materials[Mesh::IndexData::Final][i].attribs;
-                for (auto j = 0u; j < model.m_materials[Mesh::IndexData::Final][i].attribCount; ++j)
+                const auto& attribs = material.attribs;
+                for (auto j = 0u; j < material.attribCount; ++j)
                 {
                     glCheck(glEnableVertexAttribArray(attribs[j][Material::Data::Index]));
                     glCheck(glVertexAttribPointer(attribs[j][Material::Data::Index], attribs[j][Material::Data::Size],
@@ -254,15 +483,33 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
                 glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
                 //unbind attribs
-                for (auto j = 0u; j < model.m_materials[Mesh::IndexData::Final][i].attribCount; ++j)
+                for (auto j = 0u; j < material.attribCount; ++j)
                 {
                     glCheck(glDisableVertexAttribArray(attribs[j][Material::Data::Index]));
                 }
 #endif //PLATFORM 
-                model.m_materials[Mesh::IndexData::Final][i].disableCustomSettings();
+                state.stats.drawCalls++;
+
+                material.disableCustomSettings();
+                if (material.hasCustomSettings())
+                {
+                    //custom settings may have changed any of these
+                    currentBlendMode = -1;
+                    currentDoubleSided = -1;
+                    currentDepthTest = -1;
+                }
             }
+
+            //skip the rest of the batch
+            e += static_cast<std::uint32_t>(instanceCount - 1);
         }
 
+        m_drawStats.programSwitches += state.stats.programSwitches;
+        m_drawStats.textureBinds += state.stats.textureBinds;
+        m_drawStats.uniformCalls += state.stats.uniformCalls;
+        m_drawStats.drawCalls += state.stats.drawCalls;
+        m_drawStats.instancedDraws += state.stats.instancedDraws;
+
 #ifdef PLATFORM_DESKTOP
         glCheck(glBindVertexArray(0));
 #else
@@ -279,6 +526,29 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
     }
 }
 
+void ModelRenderer::setUseTreeQueries(bool useTree)
+{
+    if (useTree == m_useTreeQueries)
+    {
+        return;
+    }
+
+    m_useTreeQueries = useTree;
+    for (auto entity : getEntities())
+    {
+        auto& model = entity.getComponent<Model>();
+        if (useTree)
+        {
+            addToTree(entity);
+        }
+        else if (model.m_treeID != Detail::TreeNode::Null)
+        {
+            m_tree.removeFromTree(model.m_treeID);
+            model.m_treeID = Detail::TreeNode::Null;
+        }
+    }
+}
+
 std::size_t ModelRenderer::getVisibleCount(std::size_t cameraIndex, std::int32_t passIndex) const
 {
     CRO_ASSERT(cameraIndex < m_drawLists.size(), "");
@@ -335,44 +605,100 @@ void ModelRenderer::onEntityAdded(Entity entity)
     auto& model = entity.getComponent<Model>();
     model.updateBounds();
 
-    //model.m_treeID = m_tree.addToTree(entity, model.getAABB());
+    if (m_useTreeQueries)
+    {
+        addToTree(entity);
+    }
 }
 
 void ModelRenderer::onEntityRemoved(Entity entity)
 {
-    //m_tree.removeFromTree(entity.getComponent<Model>().m_treeID);
+    auto& model = entity.getComponent<Model>();
+    if (model.m_treeID != Detail::TreeNode::Null)
+    {
+        m_tree.removeFromTree(model.m_treeID);
+        model.m_treeID = Detail::TreeNode::Null;
+    }
 }
 
 //private
 void ModelRenderer::updateDrawListDefault(Entity cameraEnt)
 {
     const auto& camComponent = cameraEnt.getComponent<Camera>();
-    const auto cameraPos = cameraEnt.getComponent<Transform>().getWorldPosition();
-    //assume if there's no reflection buffer there's no need to sort the
-    //entities for the second pass...
-    const auto passCount = camComponent.reflectionBuffer.available() ? 2 : 1;
-
     const auto& entities = getEntities();
     auto& drawList = m_drawLists[camComponent.getDrawListIndex()];
 
-    //cull entities by viewable into draw lists by pass
     for (auto& list : drawList)
     {
         list.clear();
     }
-#ifdef USE_PARALLEL_PROCESSING
-    std::mutex mutex;
 
-    std::for_each(std::execution::par, entities.cbegin(), entities.cend(), 
-        [&](Entity entity)
+    //entities are culled in fixed size chunks, each of which writes to its
+    //own output list. These are then merged into the draw list once all the
+    //chunks are done, so the parallel pass doesn't need to lock anything.
+    static constexpr std::size_t ChunkSize = 256;
+    const auto chunkCount = (entities.size() + (ChunkSize - 1)) / ChunkSize;
+    if (m_cullChunks.size() < chunkCount)
+    {
+        m_cullChunks.resize(chunkCount);
+    }
+
+    const auto cullChunk = 
+        [&](CullChunk& chunk)
+    {
+        const std::size_t idx = std::distance(m_cullChunks.data(), &chunk);
+        const auto start = idx * ChunkSize;
+        const auto end = std::min(start + ChunkSize, entities.size());
+
+        for (auto& list : chunk.drawList)
+        {
+            list.clear();
+        }
+        cullEntities(entities.data() + start, entities.data() + end, cameraEnt, chunk);
+    };
+
+#ifdef USE_PARALLEL_PROCESSING
+    std::for_each(std::execution::par, m_cullChunks.begin(), m_cullChunks.begin() + chunkCount, cullChunk);
 #else
-    for (auto entity : entities)
+    std::for_each(m_cullChunks.begin(), m_cullChunks.begin() + chunkCount, cullChunk);
 #endif
+
+    for (auto p = 0u; p < drawList.size(); ++p)
     {
+        std::size_t total = 0;
+        for (auto i = 0u; i < chunkCount; ++i)
+        {
+            total += m_cullChunks[i].drawList[p].size();
+        }
+        drawList[p].reserve(total);
+
+        for (auto i = 0u; i < chunkCount; ++i)
+        {
+            const auto& src = m_cullChunks[i].drawList[p];
+            drawList[p].insert(drawList[p].end(), src.begin(), src.end());
+        }
+    }
+}
+
+void ModelRenderer::cullEntities(const Entity* first, const Entity* last, Entity cameraEnt, CullChunk& chunk)
+{
+    const auto& camComponent = cameraEnt.getComponent<Camera>();
+    const auto cameraPos = cameraEnt.getComponent<Transform>().getWorldPosition();
+    //assume if there's no reflection buffer there's no need to sort the
+    //entities for the second pass...
+    const auto passCount = camComponent.reflectionBuffer.available() ? 2 : 1;
+
+    chunk.entities.clear();
+    chunk.spheres.clear();
+
+    for (auto it = first; it != last; ++it)
+    {
+        auto entity = *it;
+
         auto& model = entity.getComponent<Model>();
         if (model.isHidden())
         {
-            EARLY_OUT;
+            continue;
         }
 
         if (model.m_meshBox != model.m_meshData.boundingBox)
@@ -381,252 +707,239 @@ void ModelRenderer::updateDrawListDefault(Entity cameraEnt)
         }
 
         //use the bounding sphere for depth testing
-        auto sphere = model.getBoundingSphere();
-        const auto& tx = entity.getComponent<Transform>();
+        chunk.entities.push_back(entity);
+        chunk.spheres.push_back(getCullingSphere(entity));
+    }
 
-        sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
-        auto scale = tx.getWorldScale();
+    //for each pass in the list (different passes may use different projections, eg reflections)
+    for (auto p = 0; p < passCount; ++p)
+    {
+        Spatial::intersects(camComponent.getPass(p).getFrustum(), chunk.spheres, chunk.visibility);
 
-        /*if (scale.x * scale.y * scale.z == 0)
+        for (auto i = 0u; i < chunk.entities.size(); ++i)
         {
-            continue;
-        }*/
+            if (Spatial::isVisible(chunk.visibility, i))
+            {
+                addToDrawList(chunk.entities[i], chunk.spheres[i], camComponent, cameraPos, p, chunk.drawList[p]);
+            }
+        }
+    }
+}
+
+void ModelRenderer::updateDrawListBalancedTree(Entity cameraEnt)
+{
+    const auto& camComponent = cameraEnt.getComponent<Camera>();
+    const auto cameraPos = cameraEnt.getComponent<Transform>().getWorldPosition();
+    const auto passCount = camComponent.reflectionBuffer.available() ? 2 : 1;
 
-        sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+    refreshTree();
 
-        //for some reason the tighter fitting Spheres cause incorrect culling
-        //so this is a hack to mitigate it somewhat
-        sphere.radius *= 1.2f;
+    auto& drawList = m_drawLists[camComponent.getDrawListIndex()];
+    for (auto& list : drawList)
+    {
+        list.clear();
+    }
+
+    for (auto p = 0; p < passCount; ++p)
+    {
+        m_treeResults.clear();
+        m_tree.queryFrustum(camComponent.getPass(p).getFrustum(), m_treeResults);
 
-        //for each pass in the list (different passes may use different projections, eg reflections)
-        for (auto p = 0; p < passCount; ++p)
+        //if the tree query found the bounds completely inside the frustum
+        //there's no need to test again, else test the spheres as a batch
+        m_treeEntities.clear();
+        m_treeSpheres.clear();
+
+        for (auto [entity, contained] : m_treeResults)
         {
-            if ((model.m_renderFlags & camComponent.getPass(p).renderFlags) == 0)
-            {
-                continue;
-            }
-            
-            //this is a good approximation of distance based on the centre
-            //of the model (large models might suffer without face sorting...)
-            //assuming the forward vector is normalised - though WHY would you
-            //scale the view matrix???
-            auto direction = (sphere.centre - cameraPos);
-            float distance = glm::dot(camComponent.getPass(p).forwardVector, direction);
-
-            if (distance < -sphere.radius)
+            const auto& model = entity.getComponent<Model>();
+            if (model.isHidden())
             {
-                //model is behind the camera
                 continue;
             }
 
-
-            bool visible = true;
-            //if (camComponent.isOrthographic())
+            if (contained)
             {
-                const auto& frustum = camComponent.getPass(p).getFrustum();
-
-                std::size_t j = 0;
-                while (visible && j < frustum.size())
-                {
-                    visible = (Spatial::intersects(frustum[j++], sphere) != Planar::Back);
-                }
+                addToDrawList(entity, getCullingSphere(entity), camComponent, cameraPos, p, drawList[p]);
             }
-            /*else
+            else
             {
-                //well measuring this says it's nearly twice as slow...
-                model.m_visible = cro::Util::Frustum::visible(camComponent.getFrustumData(), camComponent.getPass(p).viewMatrix * tx.getWorldTransform(), model.getAABB());
-            }*/
+                m_treeEntities.push_back(entity);
+                m_treeSpheres.push_back(getCullingSphere(entity));
+            }
+        }
 
-            if (visible)
+        Spatial::intersects(camComponent.getPass(p).getFrustum(), m_treeSpheres, m_treeVisibility);
+        for (auto i = 0u; i < m_treeEntities.size(); ++i)
+        {
+            if (Spatial::isVisible(m_treeVisibility, i))
             {
-                auto opaque = std::make_pair(entity, SortData());
-                auto transparent = std::make_pair(entity, SortData());
+                addToDrawList(m_treeEntities[i], m_treeSpheres[i], camComponent, cameraPos, p, drawList[p]);
+            }
+        }
+    }
+}
 
-                //foreach material
-                //add ent/index pair to alpha or opaque list
-                for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
-                {
-                    if (model.m_materials[Mesh::IndexData::Final][i].blendMode != Material::BlendMode::None)
-                    {
-                        transparent.second.matIDs.push_back(static_cast<std::int32_t>(i));
-                        transparent.second.flags = static_cast<std::int64_t>(-distance * 1000000.f); //suitably large number to shift decimal point
-                        transparent.second.flags += 0x0FFF000000000000; //gaurentees embiggenment so that sorting places transparent last
-                    }
-                    else
-                    {
-                        opaque.second.matIDs.push_back(static_cast<std::int32_t>(i));
-                        opaque.second.flags = static_cast<std::int64_t>(distance * 1000000.f);
-                    }
-                }
+Sphere ModelRenderer::getCullingSphere(Entity entity)
+{
+    const auto& model = entity.getComponent<Model>();
+    const auto& tx = entity.getComponent<Transform>();
 
-                if (!opaque.second.matIDs.empty())
-                {
-#ifdef USE_PARALLEL_PROCESSING
-                    std::scoped_lock l(mutex);
-#endif
-                    drawList[p].push_back(opaque);
-                }
+    auto sphere = model.getBoundingSphere();
+    sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
+    auto scale = tx.getWorldScale();
 
-                if (!transparent.second.matIDs.empty())
-                {
-#ifdef USE_PARALLEL_PROCESSING
-                    std::scoped_lock l(mutex);
-#endif
-                    drawList[p].push_back(transparent);
-                }
-            }
+    /*if (scale.x * scale.y * scale.z == 0)
+    {
+        continue;
+    }*/
+
+    sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+
+    //for some reason the tighter fitting Spheres cause incorrect culling
+    //so this is a hack to mitigate it somewhat
+    sphere.radius *= 1.2f;
+
+    return sphere;
+}
+
+void ModelRenderer::addToDrawList(Entity entity, const Sphere& sphere, const Camera& camComponent, glm::vec3 cameraPos, std::int32_t p, MaterialList& dst)
+{
+    const auto& model = entity.getComponent<Model>();
+    if ((model.m_renderFlags & camComponent.getPass(p).renderFlags) == 0)
+    {
+        return;
+    }
+
+    //this is a good approximation of distance based on the centre
+    //of the model (large models might suffer without face sorting...)
+    //assuming the forward vector is normalised - though WHY would you
+    //scale the view matrix???
+    auto direction = (sphere.centre - cameraPos);
+    float distance = glm::dot(camComponent.getPass(p).forwardVector, direction);
+
+    if (distance < -sphere.radius)
+    {
+        //model is behind the camera
+        return;
+    }
+
+    //submeshes which share a shader and blend class are grouped
+    //into a single entry so the program never changes mid-entry
+    std::array<SortData, Mesh::IndexData::MaxBuffers> groups = {};
+    std::array<std::pair<std::uint32_t, bool>, Mesh::IndexData::MaxBuffers> groupIDs = {};
+    std::size_t groupCount = 0;
+
+    for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
+    {
+        const auto& material = model.m_materials[Mesh::IndexData::Final][i];
+        const bool transparent = material.blendMode != Material::BlendMode::None;
+        const auto groupID = std::make_pair(material.shader, transparent);
+
+        auto g = 0u;
+        while (g < groupCount && groupIDs[g] != groupID)
+        {
+            g++;
         }
+
+        if (g == groupCount)
+        {
+            //use the mesh rather than the VAO so that models sharing
+            //mesh data are sorted together and can be instanced
+            const auto mesh = model.m_meshData.vbo;
+            groupIDs[g] = groupID;
+            groups[g].flags = transparent ?
+                Detail::SortKey::transparent(material.shader, materialKey(material), mesh, distance) :
+                Detail::SortKey::opaque(material.shader, materialKey(material), mesh, distance);
+            groupCount++;
+        }
+        groups[g].matIDs.push_back(static_cast<std::int32_t>(i));
+    }
+
+    for (auto g = 0u; g < groupCount; ++g)
+    {
+        dst.emplace_back(entity, groups[g]);
     }
-#ifdef USE_PARALLEL_PROCESSING    
-    );
-#endif
 }
 
-void ModelRenderer::updateDrawListBalancedTree(Entity cameraEnt)
+void ModelRenderer::addToTree(Entity entity)
 {
-    //const auto& camComponent = cameraEnt.getComponent<Camera>();
-    //auto cameraPos = cameraEnt.getComponent<Transform>().getWorldPosition();
-
-    //auto& drawList = m_drawLists[camComponent.getDrawListIndex()];
-
-    //for (auto& list : drawList)
-    //{
-    //    list.clear();
-    //}
-
-    //auto passCount = camComponent.reflectionBuffer.available() ? 2 : 1;
-
-    //for (auto p = 0; p < passCount; ++p)
-    //{
-    //    const auto& frustumBounds = camComponent.getPass(p).getAABB();
-    //    auto entities = queryTree(frustumBounds);
-
-    //    for (auto entity : entities)
-    //    {
-    //        auto& model = entity.getComponent<Model>();
-    //        if (model.isHidden())
-    //        {
-    //            continue;
-    //        }
-
-    //        if ((model.m_renderFlags & camComponent.getPass(p).renderFlags) == 0)
-    //        {
-    //            continue;
-    //        }
-
-    //        if (model.m_meshBox != model.m_meshData.boundingBox)
-    //        {
-    //            model.updateBounds();
-    //        }
-
-    //        //use the bounding sphere for depth testing
-    //        auto sphere = model.getBoundingSphere();
-    //        const auto& tx = entity.getComponent<Transform>();
-
-    //        sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
-    //        auto scale = tx.getScale();
-    //        sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
-
-    //        auto direction = (sphere.centre - cameraPos);
-    //        float distance = glm::dot(camComponent.getPass(p).forwardVector, direction);
-
-    //        if (distance < -sphere.radius)
-    //        {
-    //            //model is behind the camera
-    //            continue;
-    //        }
-
-    //        //frustum test
-    //        bool visible = true;
-    //        //if (camComponent.isOrthographic())
-    //        {
-    //            const auto& frustum = camComponent.getPass(p).getFrustum();
-
-    //            visible = true;
-    //            std::size_t j = 0;
-    //            while (visible && j < frustum.size())
-    //            {
-    //                visible = (Spatial::intersects(frustum[j++], sphere) != Planar::Back);
-    //            }
-    //        }
-    //        /*else
-    //        {
-    //            model.m_visible = cro::Util::Frustum::visible(camComponent.getFrustumData(), camComponent.getPass(p).viewMatrix * tx.getWorldTransform(), model.getAABB());
-    //        }*/
-
-    //        //add visible ents to lists for depth sorting
-    //        if (visible)
-    //        {
-    //            auto opaque = std::make_pair(entity, SortData());
-    //            auto transparent = std::make_pair(entity, SortData());
-
-    //            //foreach material
-    //            //add ent/index pair to alpha or opaque list
-    //            for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
-    //            {
-    //                if (model.m_materials[Mesh::IndexData::Final][i].blendMode != Material::BlendMode::None)
-    //                {
-    //                    transparent.second.matIDs.push_back(static_cast<std::int32_t>(i));
-    //                    transparent.second.flags = static_cast<std::int64_t>(-distance * 1000000.f); //suitably large number to shift decimal point
-    //                    transparent.second.flags += 0x0FFF000000000000; //gaurentees embiggenment so that sorting places transparent last
-    //                }
-    //                else
-    //                {
-    //                    opaque.second.matIDs.push_back(static_cast<std::int32_t>(i));
-    //                    opaque.second.flags = static_cast<std::int64_t>(distance * 1000000.f);
-    //                }
-    //            }
-
-    //            if (!opaque.second.matIDs.empty())
-    //            {
-    //                drawList[p].push_back(opaque);
-    //            }
-
-    //            if (!transparent.second.matIDs.empty())
-    //            {
-    //                drawList[p].push_back(transparent);
-    //            }
-    //        }
-    //    }
-    //}
+    auto& model = entity.getComponent<Model>();
+    CRO_ASSERT(model.m_treeID == Detail::TreeNode::Null, "Already in tree");
+
+    const auto sphere = getCullingSphere(entity);
+    model.m_treeID = m_tree.insert(entity, Box(sphere.centre - sphere.radius, sphere.centre + sphere.radius));
+    model.m_lastWorldPosition = sphere.centre;
+    model.m_lastWorldUpdate = entity.getComponent<Transform>().getWorldUpdateCount();
+}
+
+void ModelRenderer::refreshTree()
+{
+    if (!m_treeDirty)
+    {
+        return;
+    }
+
+    //the tree stores the AABB of the culling sphere so that branches
+    //are only rejected when the sphere test would also reject them
+    for (auto entity : getEntities())
+    {
+        auto& model = entity.getComponent<Model>();
+        const auto& tx = entity.getComponent<Transform>();
+
+        //static models are skipped without reading their world transform
+        const bool boundsChanged = model.m_meshBox != model.m_meshData.boundingBox;
+        if (!boundsChanged
+            && !tx.getDirty()
+            && tx.getWorldUpdateCount() == model.m_lastWorldUpdate)
+        {
+            continue;
+        }
+
+        if (boundsChanged)
+        {
+            model.updateBounds();
+        }
+
+        const auto sphere = getCullingSphere(entity);
+        m_tree.moveNode(model.m_treeID, Box(sphere.centre - sphere.radius, sphere.centre + sphere.radius), sphere.centre - model.m_lastWorldPosition);
+        model.m_lastWorldPosition = sphere.centre;
+        model.m_lastWorldUpdate = tx.getWorldUpdateCount();
+    }
+    m_treeDirty = false;
 }
 
-//std::vector<Entity> ModelRenderer::queryTree(Box area) const
-//{
-//    Detail::FixedStack<std::int32_t, 256> stack;
-//    stack.push(m_tree.getRoot());
-//
-//    std::vector<Entity> retVal;
-//    retVal.reserve(256);
-//
-//    while (stack.size() > 0)
-//    {
-//        auto treeID = stack.pop();
-//        if (treeID == Detail::TreeNode::Null)
-//        {
-//            continue;
-//        }
-//
-//        const auto& node = m_tree.getNodes()[treeID];
-//        if (area.intersects(node.fatBounds))
-//        {
-//            if (node.isLeaf() && node.entity.isValid())
-//            {
-//                //we have a candidate, stash
-//                retVal.push_back(node.entity);
-//            }
-//            else
-//            {
-//                stack.push(node.childA);
-//                stack.push(node.childB);
-//            }
-//        }
-//    }
-//    return retVal;
-//}
-
-void ModelRenderer::applyProperties(const Material::Data& material, const Model& model, const Scene& scene, const Camera& camera)
+void ModelRenderer::applyProperties(const Material::Data& material, const Model& model, const Scene& scene, const Camera& camera, StateCache* state)
 {
+    //without a state cache everything is applied unconditionally
+    const bool applyMaterial = state ? state->applyMaterial : true;
+    const bool applyGlobal = state ? state->applyGlobal : true;
+    std::size_t uniformCalls = 0;
+
+    const auto bindTexture = [state](std::uint32_t unit, std::uint32_t target, std::uint32_t textureID)
+    {
+        if (state)
+        {
+            state->bindTexture(unit, target, textureID);
+        }
+        else
+        {
+            glCheck(glActiveTexture(GL_TEXTURE0 + unit));
+            glCheck(glBindTexture(target, textureID));
+        }
+    };
+
+    //sampler units only need updating when the material or program
+    //changes, as the layout of the units is the same for both
+    const auto setSampler = [&](std::int32_t location, std::uint32_t unit)
+    {
+        if (applyMaterial)
+        {
+            glCheck(glUniform1i(location, unit));
+            uniformCalls++;
+        }
+    };
+
     std::uint32_t currentTextureUnit = 0;
     for (const auto& prop : material.properties)
     {
@@ -634,119 +947,158 @@ void ModelRenderer::applyProperties(const Material::Data& material, const Model&
         {
         default: break;
         case Material::Property::TextureArray:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, prop.second.second.textureID));
-            glCheck(glUniform1i(prop.second.first, currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_2D_ARRAY, prop.second.second.textureID);
+            setSampler(prop.second.first, currentTextureUnit++);
             break;        
         case Material::Property::Texture:
             //TODO textures need to track which unit they're currently bound
             //to so that they don't get bound to multiple units
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_2D, prop.second.second.textureID));
-            glCheck(glUniform1i(prop.second.first, currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_2D, prop.second.second.textureID);
+            setSampler(prop.second.first, currentTextureUnit++);
             break;
         case Material::Property::Cubemap:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, prop.second.second.textureID));
-            glCheck(glUniform1i(prop.second.first, currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_CUBE_MAP, prop.second.second.textureID);
+            setSampler(prop.second.first, currentTextureUnit++);
             break;
         case Material::Property::CubemapArray:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, prop.second.second.textureID));
-            glCheck(glUniform1i(prop.second.first, currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_CUBE_MAP_ARRAY, prop.second.second.textureID);
+            setSampler(prop.second.first, currentTextureUnit++);
             break;
         case Material::Property::Number:
-            glCheck(glUniform1f(prop.second.first,
-                prop.second.second.numberValue));
+            if (applyMaterial)
+            {
+                glCheck(glUniform1f(prop.second.first,
+                    prop.second.second.numberValue));
+                uniformCalls++;
+            }
             break;
         case Material::Property::Vec2:
-            glCheck(glUniform2f(prop.second.first, 
-                prop.second.second.vecValue[0],
-                prop.second.second.vecValue[1]));
+            if (applyMaterial)
+            {
+                glCheck(glUniform2f(prop.second.first,
+                    prop.second.second.vecValue[0],
+                    prop.second.second.vecValue[1]));
+                uniformCalls++;
+            }
             break;
         case Material::Property::Vec3:
-            glCheck(glUniform3f(prop.second.first, prop.second.second.vecValue[0],
-                prop.second.second.vecValue[1], prop.second.second.vecValue[2]));
+            if (applyMaterial)
+            {
+                glCheck(glUniform3f(prop.second.first, prop.second.second.vecValue[0],
+                    prop.second.second.vecValue[1], prop.second.second.vecValue[2]));
+                uniformCalls++;
+            }
             break;
         case Material::Property::Vec4:
-            glCheck(glUniform4f(prop.second.first, prop.second.second.vecValue[0],
-                prop.second.second.vecValue[1], prop.second.second.vecValue[2], prop.second.second.vecValue[3]));
+            if (applyMaterial)
+            {
+                glCheck(glUniform4f(prop.second.first, prop.second.second.vecValue[0],
+                    prop.second.second.vecValue[1], prop.second.second.vecValue[2], prop.second.second.vecValue[3]));
+                uniformCalls++;
+            }
             break;
         case Material::Property::Mat4:
-            glCheck(glUniformMatrix4fv(prop.second.first, 1, GL_FALSE, &prop.second.second.matrixValue[0].x));
+            if (applyMaterial)
+            {
+                glCheck(glUniformMatrix4fv(prop.second.first, 1, GL_FALSE, &prop.second.second.matrixValue[0].x));
+                uniformCalls++;
+            }
             break;
         }
     }
 
-    //apply 'optional' uniforms
+    //apply 'optional' uniforms. Apart from skinning these are all
+    //scene or camera values, so only need setting once per program
     for (auto i = 0u; i < material.optionalUniformCount; ++i)
     {
         switch (material.optionalUniforms[i])
         {
         default: break;
         case Material::SkyBox:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, scene.getCubemap().textureID));
-            glCheck(glUniform1i(material.uniforms[Material::SkyBox], currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_CUBE_MAP, scene.getCubemap().textureID);
+            setSampler(material.uniforms[Material::SkyBox], currentTextureUnit++);
             break;
         case Material::Skinning:
             glCheck(glUniformMatrix4fv(material.uniforms[Material::Skinning], static_cast<GLsizei>(model.m_jointCount), GL_FALSE, &model.m_skeleton[0][0].x));
+            uniformCalls++;
             break;
         case Material::ProjectionMap:
-        {
-            const auto p = scene.getActiveProjectionMaps();
-            glCheck(glUniformMatrix4fv(material.uniforms[Material::ProjectionMap], static_cast<GLsizei>(p.second), GL_FALSE, p.first));
-            glCheck(glUniform1i(material.uniforms[Material::ProjectionMapCount], static_cast<GLint>(p.second)));
-        }
+            if (applyGlobal)
+            {
+                const auto p = scene.getActiveProjectionMaps();
+                glCheck(glUniformMatrix4fv(material.uniforms[Material::ProjectionMap], static_cast<GLsizei>(p.second), GL_FALSE, p.first));
+                glCheck(glUniform1i(material.uniforms[Material::ProjectionMapCount], static_cast<GLint>(p.second)));
+                uniformCalls += 2;
+            }
             break;
         case Material::ShadowMapProjection:
-            glCheck(glUniformMatrix4fv(material.uniforms[Material::ShadowMapProjection], static_cast<GLsizei>(camera.getCascadeCount()), GL_FALSE, &camera.m_shadowViewProjectionMatrices[0][0][0]));
+            if (applyGlobal)
+            {
+                glCheck(glUniformMatrix4fv(material.uniforms[Material::ShadowMapProjection], static_cast<GLsizei>(camera.getCascadeCount()), GL_FALSE, &camera.m_shadowViewProjectionMatrices[0][0][0]));
+                uniformCalls++;
+            }
             break;
         case Material::ShadowMapSampler:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
 #ifdef PLATFORM_DESKTOP
-            glCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, camera.shadowMapBuffer.getTexture().textureID));
+            bindTexture(currentTextureUnit, GL_TEXTURE_2D_ARRAY, camera.shadowMapBuffer.getTexture().textureID);
 #else
-            glCheck(glBindTexture(GL_TEXTURE_2D, camera.shadowMapBuffer.getTexture().textureID));
+            bindTexture(currentTextureUnit, GL_TEXTURE_2D, camera.shadowMapBuffer.getTexture().textureID);
 #endif
-            glCheck(glUniform1i(material.uniforms[Material::ShadowMapSampler], currentTextureUnit++));
+            setSampler(material.uniforms[Material::ShadowMapSampler], currentTextureUnit++);
             break;
         case Material::CascadeCount:
-            glCheck(glUniform1i(material.uniforms[Material::CascadeCount], static_cast<std::int32_t>(camera.getCascadeCount())));
+            if (applyGlobal)
+            {
+                glCheck(glUniform1i(material.uniforms[Material::CascadeCount], static_cast<std::int32_t>(camera.getCascadeCount())));
+                uniformCalls++;
+            }
             break;
         case Material::CascadeSplits:
-            glCheck(glUniform1fv(material.uniforms[Material::CascadeSplits], static_cast<GLsizei>(camera.getCascadeCount()), camera.getSplitDistances().data()));
+            if (applyGlobal)
+            {
+                glCheck(glUniform1fv(material.uniforms[Material::CascadeSplits], static_cast<GLsizei>(camera.getCascadeCount()), camera.getSplitDistances().data()));
+                uniformCalls++;
+            }
             break;
         case Material::SunlightColour:
-        {
-            auto colour = scene.getSunlight().getComponent<Sunlight>().getColour();
-            glCheck(glUniform4f(material.uniforms[Material::SunlightColour], colour.getRed(), colour.getGreen(), colour.getBlue(), colour.getAlpha()));
-        }
+            if (applyGlobal)
+            {
+                auto colour = scene.getSunlight().getComponent<Sunlight>().getColour();
+                glCheck(glUniform4f(material.uniforms[Material::SunlightColour], colour.getRed(), colour.getGreen(), colour.getBlue(), colour.getAlpha()));
+                uniformCalls++;
+            }
             break;
         case Material::SunlightDirection:
-        {
-            auto dir = scene.getSunlight().getComponent<Sunlight>().getDirection();
-            glCheck(glUniform3f(material.uniforms[Material::SunlightDirection], dir.x, dir.y, dir.z));
-        }
+            if (applyGlobal)
+            {
+                auto dir = scene.getSunlight().getComponent<Sunlight>().getDirection();
+                glCheck(glUniform3f(material.uniforms[Material::SunlightDirection], dir.x, dir.y, dir.z));
+                uniformCalls++;
+            }
             break;
         case Material::ReflectionMap:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_2D, camera.reflectionBuffer.getTexture().getGLHandle()));
-            glCheck(glUniform1i(material.uniforms[Material::ReflectionMap], currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_2D, camera.reflectionBuffer.getTexture().getGLHandle());
+            setSampler(material.uniforms[Material::ReflectionMap], currentTextureUnit++);
             break;
         case Material::RefractionMap:
-            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-            glCheck(glBindTexture(GL_TEXTURE_2D, camera.refractionBuffer.getTexture().getGLHandle()));
-            glCheck(glUniform1i(material.uniforms[Material::RefractionMap], currentTextureUnit++));
+            bindTexture(currentTextureUnit, GL_TEXTURE_2D, camera.refractionBuffer.getTexture().getGLHandle());
+            setSampler(material.uniforms[Material::RefractionMap], currentTextureUnit++);
             break;
         case Material::ReflectionMatrix:
-        {
-            //OK this must be a symptom of some obscure bug... we should be setting the vp from REFLECTION here... but that breaks mapping :S
-            glCheck(glUniformMatrix4fv(material.uniforms[Material::ReflectionMatrix], 1, GL_FALSE, &camera.getPass(Camera::Pass::Refraction).viewProjectionMatrix[0][0]));
-        }
+            if (applyGlobal)
+            {
+                //OK this must be a symptom of some obscure bug... we should be setting the vp from REFLECTION here... but that breaks mapping :S
+                glCheck(glUniformMatrix4fv(material.uniforms[Material::ReflectionMatrix], 1, GL_FALSE, &camera.getPass(Camera::Pass::Refraction).viewProjectionMatrix[0][0]));
+                uniformCalls++;
+            }
         break;
         }
     }
+
+    if (state)
+    {
+        state->stats.uniformCalls += uniformCalls;
+    }
 }
 
 void ModelRenderer::applyBlendMode(const Material::Data& material)
@@ -797,6 +1149,262 @@ void ModelRenderer::applyBlendMode(const Material::Data& material)
     }
 }
 
+#ifdef PLATFORM_DESKTOP
+bool ModelRenderer::canInstance(const MaterialPair& entry) const
+{
+    //transparent draws have to stay in depth order
+    if (entry.second.flags & Detail::SortKey::TransparentBit)
+    {
+        return false;
+    }
+
+    //models with their own instance data or skeletons can't be batched
+    const auto& model = entry.first.getComponent<Model>();
+    if (model.m_instanceBuffers.instanceCount != 0
+        || model.m_jointCount != 0)
+    {
+        return false;
+    }
+
+    for (auto i : entry.second.matIDs)
+    {
+        const auto& material = model.m_materials[Mesh::IndexData::Final][i];
+        if ((material.attribs[Shader::AttributeID::InstanceTransform][Material::Data::Index] == -1 && material.instancedShader == nullptr)
+            || material.hasCustomSettings())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModelRenderer::canBatch(const MaterialPair& first, const MaterialPair& other) const
+{
+    //keys match everything except depth
+    if ((first.second.flags >> 24) != (other.second.flags >> 24)
+        || first.second.matIDs.size() != other.second.matIDs.size())
+    {
+        return false;
+    }
+
+    const auto& a = first.first.getComponent<Model>();
+    const auto& b = other.first.getComponent<Model>();
+
+    if (a.m_meshData.vbo != b.m_meshData.vbo
+        || a.m_facing != b.m_facing
+        || b.m_instanceBuffers.instanceCount != 0
+        || b.m_jointCount != 0)
+    {
+        return false;
+    }
+
+    auto j = other.second.matIDs.begin();
+    for (auto i : first.second.matIDs)
+    {
+        if (i != *j
+            || a.m_meshData.indexData[i].ibo != b.m_meshData.indexData[i].ibo
+            || !sameMaterial(a.m_materials[Mesh::IndexData::Final][i], b.m_materials[Mesh::IndexData::Final][i]))
+        {
+            return false;
+        }
+        j++;
+    }
+    return true;
+}
+
+void ModelRenderer::uploadInstanceData(const MaterialList& list, std::size_t start, std::size_t count)
+{
+    if (m_instanceBuffers.transformBuffer == 0)
+    {
+        glCheck(glGenBuffers(1, &m_instanceBuffers.transformBuffer));
+        glCheck(glGenBuffers(1, &m_instanceBuffers.normalBuffer));
+    }
+
+    m_instanceTransforms.resize(count);
+    m_instanceNormals.resize(count);
+    for (auto i = 0u; i < count; ++i)
+    {
+        m_instanceTransforms[i] = list[start + i].first.getComponent<Transform>().getWorldTransform();
+        m_instanceNormals[i] = glm::inverseTranspose(glm::mat3(m_instanceTransforms[i]));
+    }
+
+    //orphan the previous contents so we don't stall waiting for earlier draws
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffers.transformBuffer));
+    glCheck(glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW));
+    glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4), m_instanceTransforms.data()));
+
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffers.normalBuffer));
+    glCheck(glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::mat3), nullptr, GL_STREAM_DRAW));
+    glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat3), m_instanceNormals.data()));
+
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+const Material::Data& ModelRenderer::getInstancedMaterial(const Material::Data& material)
+{
+    const auto* variant = material.instancedShader;
+    CRO_ASSERT(variant, "");
+
+    auto result = m_variantMaterials.find(variant->getGLHandle());
+    if (result == m_variantMaterials.end())
+    {
+        Material::Data data;
+        data.setShader(*variant);
+        result = m_variantMaterials.emplace(variant->getGLHandle(), std::move(data)).first;
+    }
+    const auto& variantMaterial = result->second;
+
+    //copy the material so the property values are current, then
+    //use the locations from the variant. The attribs are left
+    //unsorted and are mapped to the mesh by drawInstanced()
+    m_instancedMaterial = material;
+    m_instancedMaterial.shader = variantMaterial.shader;
+    m_instancedMaterial.attribs = variantMaterial.attribs;
+    m_instancedMaterial.uniforms = variantMaterial.uniforms;
+    m_instancedMaterial.optionalUniforms = variantMaterial.optionalUniforms;
+    m_instancedMaterial.optionalUniformCount = variantMaterial.optionalUniformCount;
+
+    for (auto& [name, prop] : m_instancedMaterial.properties)
+    {
+        const auto p = variantMaterial.properties.find(name);
+        prop.first = p == variantMaterial.properties.end() ? -1 : p->second.first;
+    }
+
+    return m_instancedMaterial;
+}
+
+void ModelRenderer::drawInstanced(const Model& model, const Material::Data& material, std::int32_t submesh, std::size_t count)
+{
+    const auto& indexData = model.m_meshData.indexData[submesh];
+    const bool useVariant = &material == &m_instancedMaterial;
+
+    if (useVariant)
+    {
+        //the variant's attrib locations may differ from those
+        //the model's VAO was built with, so map the mesh to them
+        if (m_instanceBuffers.vao == 0)
+        {
+            glCheck(glGenVertexArrays(1, &m_instanceBuffers.vao));
+        }
+        glCheck(glBindVertexArray(m_instanceBuffers.vao));
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.m_meshData.vbo));
+        glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexData.ibo));
+
+        std::size_t pointerOffset = 0;
+        for (auto j = 0u; j < Mesh::Attribute::Total; ++j)
+        {
+            const auto location = material.attribs[j][Material::Data::Index];
+            const auto size = static_cast<std::int32_t>(model.m_meshData.attributes[j]);
+            if (location != -1 && size != 0)
+            {
+                glCheck(glEnableVertexAttribArray(location));
+                glCheck(glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(model.m_meshData.vertexSize),
+                    reinterpret_cast<void*>(static_cast<intptr_t>(pointerOffset * sizeof(float)))));
+            }
+            pointerOffset += model.m_meshData.attributes[j];
+        }
+    }
+    else
+    {
+        //the model's VAO has no instance arrays, so temporarily add ours.
+        glCheck(glBindVertexArray(model.m_vaos[submesh][Mesh::IndexData::Final]));
+    }
+
+    //attribs are labelled as mat3/4 in shader but are actually 3*vec3 and 4*vec4
+
+    const auto transformAttrib = material.attribs[Shader::AttributeID::InstanceTransform][Material::Data::Index];
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffers.transformBuffer));
+    for (auto j = 0u; j < 4u; ++j)
+    {
+        glCheck(glEnableVertexAttribArray(transformAttrib + j));
+        glCheck(glVertexAttribPointer(transformAttrib + j, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(glm::vec4), reinterpret_cast<void*>(static_cast<intptr_t>(j * sizeof(glm::vec4)))));
+        glCheck(glVertexAttribDivisor(transformAttrib + j, 1));
+    }
+
+    const auto normalAttrib = material.attribs[Shader::AttributeID::InstanceNormal][Material::Data::Index];
+    if (normalAttrib != -1)
+    {
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffers.normalBuffer));
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            glCheck(glEnableVertexAttribArray(normalAttrib + j));
+            glCheck(glVertexAttribPointer(normalAttrib + j, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(glm::vec3), reinterpret_cast<void*>(static_cast<intptr_t>(j * sizeof(glm::vec3)))));
+            glCheck(glVertexAttribDivisor(normalAttrib + j, 1));
+        }
+    }
+
+    glCheck(glDrawElementsInstanced(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), NULL, static_cast<GLsizei>(count)));
+
+    //and restore the VAO for single draws
+    for (auto j = 0u; j < 4u; ++j)
+    {
+        glCheck(glDisableVertexAttribArray(transformAttrib + j));
+        glCheck(glVertexAttribDivisor(transformAttrib + j, 0));
+    }
+
+    if (normalAttrib != -1)
+    {
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            glCheck(glDisableVertexAttribArray(normalAttrib + j));
+            glCheck(glVertexAttribDivisor(normalAttrib + j, 0));
+        }
+    }
+
+    if (useVariant)
+    {
+        //the next batch may use a mesh with a different layout
+        for (auto j = 0u; j < Mesh::Attribute::Total; ++j)
+        {
+            if (material.attribs[j][Material::Data::Index] != -1)
+            {
+                glCheck(glDisableVertexAttribArray(material.attribs[j][Material::Data::Index]));
+            }
+        }
+        glCheck(glBindVertexArray(0));
+    }
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+#endif
+
+void ModelRenderer::StateCache::reset()
+{
+    //we don't know what anything else bound since the last render
+    textures.fill(std::make_pair(0u, std::numeric_limits<std::uint32_t>::max()));
+    activeUnit = std::numeric_limits<std::uint32_t>::max();
+    programs.clear();
+
+    applyMaterial = true;
+    applyGlobal = true;
+    stats = {};
+}
+
+void ModelRenderer::StateCache::bindTexture(std::uint32_t unit, std::uint32_t target, std::uint32_t id)
+{
+    if (unit >= MaxTextureUnits)
+    {
+        //not tracked, so always bind
+        glCheck(glActiveTexture(GL_TEXTURE0 + unit));
+        glCheck(glBindTexture(target, id));
+        activeUnit = unit;
+        stats.textureBinds++;
+        return;
+    }
+
+    if (textures[unit].first != target
+        || textures[unit].second != id)
+    {
+        if (activeUnit != unit)
+        {
+            glCheck(glActiveTexture(GL_TEXTURE0 + unit));
+            activeUnit = unit;
+        }
+        glCheck(glBindTexture(target, id));
+        textures[unit] = std::make_pair(target, id);
+        stats.textureBinds++;
+    }
+}
+
 #ifdef PARALLEL_DISABLE
 #ifndef PARALLEL_GLOBAL_DISABLE
 #define USE_PARALLEL_PROCESSING
@@ -42,6 +42,7 @@ source distribution.
 #include <crogine/util/Matrix.hpp>
 
 #include "../../detail/GLCheck.hpp"
+#include "../../detail/SIMD.hpp"
 
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
 #include <crogine/detail/glm/gtx/norm.hpp>
@@ -53,7 +54,6 @@ source distribution.
 
 #ifdef USE_PARALLEL_PROCESSING
 #include <execution>
-#include <mutex>
 #endif
 
 #ifdef CRO_DEBUG_
@@ -200,48 +200,242 @@ LIGHT_OUT = vec4(vec3(0.0), 1.0);
         }
     )";
 
-    constexpr std::size_t MaxVertData = ParticleEmitter::MaxParticles * (3 + 4 + 3); //pos, colour, rotation/scale vert attribs
-    const std::size_t MaxParticleSystems = 128; //max number of VBOs - must be divisible by min count
-    const std::size_t MinParticleSystems = 4; //min amount before resizing - this many added on resize (so don't make too large!!)
     const std::size_t VertexSize = 10 * sizeof(float); //pos, colour, rotation/scale vert attribs
 
+    //particle update kernels. These process 4 particles at a time where
+    //SIMD is available, with any remaining particles updated individually
+    struct UpdateContext final
+    {
+        float dt = 0.f;
+        glm::vec3 forces = glm::vec3(0.f); //sum of emitter forces * dt
+        float rotation = 0.f; //rotation speed * dt
+        float scale = 0.f; //scale modifier * dt
+    };
 
-    bool inFrustum(const Frustum& frustum, const ParticleEmitter& emitter)
+    //applies velocity and updates the age of each particle
+    void integrate(Detail::ParticleData& p, std::size_t count, const UpdateContext& ctx)
     {
-        bool visible = true;
         std::size_t i = 0;
-        while (visible && i < frustum.size())
+#ifdef CRO_SIMD
         {
-            visible = (Spatial::intersects(frustum[i++], emitter.getBounds()) != Planar::Back);
+            using namespace Detail::SIMD;
+            const auto dt = splat(ctx.dt);
+            const auto forceX = splat(ctx.forces.x);
+            const auto forceY = splat(ctx.forces.y);
+            const auto forceZ = splat(ctx.forces.z);
+            const auto rotation = splat(ctx.rotation);
+            const auto scaleMod = splat(ctx.scale);
+            const auto zero = splat(0.f);
+            const auto one = splat(1.f);
+
+            for (; i + Width <= count; i += Width)
+            {
+                const auto acceleration = load(&p.acceleration[i]);
+
+                const auto vx = add(add(mul(load(&p.velocityX[i]), acceleration), mul(load(&p.gravityX[i]), dt)), forceX);
+                const auto vy = add(add(mul(load(&p.velocityY[i]), acceleration), mul(load(&p.gravityY[i]), dt)), forceY);
+                const auto vz = add(add(mul(load(&p.velocityZ[i]), acceleration), mul(load(&p.gravityZ[i]), dt)), forceZ);
+                store(&p.velocityX[i], vx);
+                store(&p.velocityY[i], vy);
+                store(&p.velocityZ[i], vz);
+
+                store(&p.positionX[i], add(load(&p.positionX[i]), mul(vx, dt)));
+                store(&p.positionY[i], add(load(&p.positionY[i]), mul(vy, dt)));
+                store(&p.positionZ[i], add(load(&p.positionZ[i]), mul(vz, dt)));
+
+                const auto lifetime = sub(load(&p.lifetime[i]), dt);
+                store(&p.lifetime[i], lifetime);
+                store(&p.alpha[i], min(one, max(div(lifetime, load(&p.maxLifetime[i])), zero)));
+
+                store(&p.rotation[i], add(load(&p.rotation[i]), rotation));
+
+                const auto scale = load(&p.scale[i]);
+                store(&p.scale[i], add(scale, mul(scale, scaleMod)));
+            }
         }
+#endif
+        for (; i < count; ++i)
+        {
+            p.velocityX[i] = (p.velocityX[i] * p.acceleration[i]) + (p.gravityX[i] * ctx.dt) + ctx.forces.x;
+            p.velocityY[i] = (p.velocityY[i] * p.acceleration[i]) + (p.gravityY[i] * ctx.dt) + ctx.forces.y;
+            p.velocityZ[i] = (p.velocityZ[i] * p.acceleration[i]) + (p.gravityZ[i] * ctx.dt) + ctx.forces.z;
+
+            p.positionX[i] += p.velocityX[i] * ctx.dt;
+            p.positionY[i] += p.velocityY[i] * ctx.dt;
+            p.positionZ[i] += p.velocityZ[i] * ctx.dt;
+
+            p.lifetime[i] -= ctx.dt;
+            p.alpha[i] = std::min(1.f, std::max(p.lifetime[i] / p.maxLifetime[i], 0.f));
 
-        return visible;
+            p.rotation[i] += ctx.rotation;
+            p.scale[i] += p.scale[i] * ctx.scale;
+        }
     }
-}
 
-ParticleSystem::ParticleSystem(MessageBus& mb)
-    : System            (mb, typeid(ParticleSystem)),
-    m_drawLists         (1),
-    m_dataBuffer        (MaxVertData),
-    m_vboIDs            (MaxParticleSystems),
-    m_vaoIDs            (MaxParticleSystems),
-    m_nextBuffer        (0),
-    m_bufferCount       (0)
-{
-    for (auto& vbo : m_vboIDs)
+    void animate(Detail::ParticleData& p, std::size_t count, const EmitterSettings& settings, float dt)
+    {
+        const float framerate = 1.f / settings.framerate;
+        for (auto i = 0u; i < count; ++i)
+        {
+            p.frameTime[i] += dt;
+            if (p.frameTime[i] > framerate)
+            {
+                p.frameID[i]++;
+                if (p.frameID[i] == settings.frameCount
+                    && p.loopCount[i])
+                {
+                    p.loopCount[i]--;
+                    p.frameID[i] = 0;
+                }
+                p.frameTime[i] -= framerate;
+            }
+        }
+    }
+
+    //returns the bounding sphere of the particle positions
+    Sphere calcBounds(const Detail::ParticleData& p, std::size_t count)
+    {
+        glm::vec3 minBounds(std::numeric_limits<float>::max());
+        glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+
+        std::size_t i = 0;
+#ifdef CRO_SIMD
+        if (count >= Detail::SIMD::Width)
+        {
+            using namespace Detail::SIMD;
+            auto minX = load(&p.positionX[0]);
+            auto minY = load(&p.positionY[0]);
+            auto minZ = load(&p.positionZ[0]);
+            auto maxX = minX;
+            auto maxY = minY;
+            auto maxZ = minZ;
+
+            for (i = Width; i + Width <= count; i += Width)
+            {
+                const auto x = load(&p.positionX[i]);
+                const auto y = load(&p.positionY[i]);
+                const auto z = load(&p.positionZ[i]);
+                minX = Detail::SIMD::min(minX, x);
+                minY = Detail::SIMD::min(minY, y);
+                minZ = Detail::SIMD::min(minZ, z);
+                maxX = Detail::SIMD::max(maxX, x);
+                maxY = Detail::SIMD::max(maxY, y);
+                maxZ = Detail::SIMD::max(maxZ, z);
+            }
+
+            std::array<float, Width> lanes = {};
+            const auto reduce = [&lanes](Float4 v, float& dst, const auto& op)
+            {
+                store(lanes.data(), v);
+                for (auto l : lanes)
+                {
+                    dst = op(dst, l);
+                }
+            };
+            const auto minOp = [](float a, float b) { return std::min(a, b); };
+            const auto maxOp = [](float a, float b) { return std::max(a, b); };
+            reduce(minX, minBounds.x, minOp);
+            reduce(minY, minBounds.y, minOp);
+            reduce(minZ, minBounds.z, minOp);
+            reduce(maxX, maxBounds.x, maxOp);
+            reduce(maxY, maxBounds.y, maxOp);
+            reduce(maxZ, maxBounds.z, maxOp);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            minBounds.x = std::min(minBounds.x, p.positionX[i]);
+            minBounds.y = std::min(minBounds.y, p.positionY[i]);
+            minBounds.z = std::min(minBounds.z, p.positionZ[i]);
+
+            maxBounds.x = std::max(maxBounds.x, p.positionX[i]);
+            maxBounds.y = std::max(maxBounds.y, p.positionY[i]);
+            maxBounds.z = std::max(maxBounds.z, p.positionZ[i]);
+        }
+
+        const auto dist = (maxBounds - minBounds) / 2.f;
+        return Sphere(glm::length(dist), dist + minBounds);
+    }
+
+    //removes dead particles by moving the last live particle into their
+    //place, and returns the new particle count
+    std::size_t removeDead(Detail::ParticleData& p, std::size_t count, const EmitterSettings& settings)
     {
-        vbo = 0;
+        //particles only reach the final frame if they're animated
+        const auto isDead = [&](std::size_t i)
+        {
+            return p.lifetime[i] < 0
+                || ((p.frameID[i] == settings.frameCount) && (p.loopCount[i] == 0));
+        };
+
+        std::size_t i = 0;
+        while (i < count)
+        {
+#ifdef CRO_SIMD
+            //skip blocks with no expired particles
+            if (!settings.animate
+                && i + Detail::SIMD::Width <= count
+                && !Detail::SIMD::any(Detail::SIMD::lessThan(Detail::SIMD::load(&p.lifetime[i]), Detail::SIMD::splat(0.f))))
+            {
+                i += Detail::SIMD::Width;
+                continue;
+            }
+#endif
+            if (isDead(i))
+            {
+                count--;
+                p.move(count, i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+        return count;
     }
 
-    //required for core profile on desktop
-    for (auto& vao : m_vaoIDs)
+    void writeVertices(const Detail::ParticleData& p, std::size_t count, std::vector<float>& dst)
     {
-        vao = 0;
+        if (dst.size() < count * (VertexSize / sizeof(float)))
+        {
+            dst.resize(count * (VertexSize / sizeof(float)));
+        }
+
+        std::size_t idx = 0;
+        for (auto i = 0u; i < count; ++i)
+        {
+            //position
+            dst[idx++] = p.positionX[i];
+            dst[idx++] = p.positionY[i];
+            dst[idx++] = p.positionZ[i];
+
+            //colour
+            dst[idx++] = p.red[i];
+            dst[idx++] = p.green[i];
+            dst[idx++] = p.blue[i];
+            dst[idx++] = p.alpha[i];
+
+            //rotation/size/animation
+            dst[idx++] = p.rotation[i] * Util::Const::degToRad;
+            dst[idx++] = p.scale[i];
+            dst[idx++] = static_cast<float>(p.frameID[i]);
+        }
     }
 
-    requireComponent<Transform>();
+}
+
+ParticleSystem::ParticleSystem(MessageBus& mb)
+    : System            (mb, typeid(ParticleSystem)),
+    m_drawLists         (1),
+    m_vao               (0),
+    m_vaoBuffer         (0)
+{
+    requireComponent<Transform>(ComponentAccess::Read);
     requireComponent<ParticleEmitter>();
 
+    //vertex data is uploaded directly to the GPU
+    setExecutionPolicy(ExecutionPolicy::MainThread);
+
     const std::array<std::string, ShaderID::Count> Defines =
     {
         "#define SUNLIGHT\n", "#define BLEND_ADD\n", "#define BLEND_MULTIPLY\n"
@@ -303,24 +497,21 @@ ParticleSystem::ParticleSystem(MessageBus& mb)
     cro::Image img;
     img.create(2, 2, cro::Colour::White);
     m_fallbackTexture.loadFromImage(img);
+
+#ifdef PLATFORM_DESKTOP
+    //required for core profile on desktop. Attribs are pointed
+    //at the streaming buffer when it's first drawn from
+    glCheck(glGenVertexArrays(1, &m_vao));
+#endif
 }
 
 ParticleSystem::~ParticleSystem()
 {
-    //delete VBOs
-    for (auto vbo : m_vboIDs)
-    {
-        if (vbo)
-        {
-            glCheck(glDeleteBuffers(1, &vbo));
-        }
-    }
 #ifdef PLATFORM_DESKTOP
-    for (auto vao : m_vaoIDs)
+    if (m_vao)
     {
-        glCheck(glDeleteVertexArrays(1, &vao));
+        glCheck(glDeleteVertexArrays(1, &m_vao));
     }
-
 #endif
 }
 
@@ -345,47 +536,44 @@ void ParticleSystem::updateDrawList(Entity cameraEnt)
 
     const auto& entities = getEntities();
 
-#ifdef USE_PARALLEL_PROCESSING
-    std::mutex mutex;
+    //emitters in front of the camera are gathered first
+    //so their bounds can be frustum tested as a batch
+    m_candidates.clear();
+    m_bounds.clear();
 
-    for_each(std::execution::par, entities.cbegin(), entities.cend(), 
-        [&](Entity entity)
-#else
     for (auto entity : entities)
-#endif
+    {
+        const auto& emitter = entity.getComponent<ParticleEmitter>();
+        const auto emitterDirection = entity.getComponent<cro::Transform>().getWorldPosition() - camPos;
+
+        /*if (!emitter.m_pendingUpdate)
         {
-            auto& emitter = entity.getComponent<ParticleEmitter>();
-            const auto emitterDirection = entity.getComponent<cro::Transform>().getWorldPosition() - camPos;
+            emitter.m_pendingUpdate = true;
+            m_potentiallyVisible.push_back(entity);
+        }*/
 
-            for (auto i = 0; i < passCount; ++i)
-            {
-                if ((emitter.m_renderFlags & cam.getPass(i).renderFlags) == 0)
-                {
-                    continue;
-                }
+        if (emitter.m_nextFreeParticle > 0
+            && glm::dot(forwardVec, emitterDirection) > 0)
+        {
+            m_candidates.push_back(entity);
+            m_bounds.push_back(emitter.getBounds());
+        }
+    }
 
-                if (glm::dot(forwardVec, emitterDirection) > 0)
-                {
-                    /*if (!emitter.m_pendingUpdate)
-                    {
-                        emitter.m_pendingUpdate = true;
-                        m_potentiallyVisible.push_back(entity);
-                    }*/
+    for (auto i = 0; i < passCount; ++i)
+    {
+        Spatial::intersects(cam.getPass(i).getFrustum(), m_bounds, m_visibility);
 
-                    const auto& frustum = cam.getPass(i).getFrustum();
-                    if (emitter.m_nextFreeParticle > 0 && inFrustum(frustum, emitter))
-                    {
-#ifdef USE_PARALLEL_PROCESSING
-                        std::scoped_lock l(mutex);
-#endif
-                        drawlist[i].push_back(entity);
-                    }
-                }
+        for (auto j = 0u; j < m_candidates.size(); ++j)
+        {
+            const auto& emitter = m_candidates[j].getComponent<ParticleEmitter>();
+            if ((emitter.m_renderFlags & cam.getPass(i).renderFlags) != 0
+                && Spatial::isVisible(m_visibility, j))
+            {
+                drawlist[i].push_back(m_candidates[j]);
             }
         }
-#ifdef USE_PARALLEL_PROCESSING
-    );
-#endif
+    }
 
     DPRINT("Visible particle Systems", std::to_string(drawlist[0].size()));
 }
@@ -397,6 +585,9 @@ void ParticleSystem::process(float dt)
         handle.boundThisFrame = false;
     }*/
 
+    //all draw calls using last frame's vertex data have been submitted
+    m_vertexBuffer.beginFrame();
+
     const auto& entities = getEntities();
     const auto fallbackTextureID = m_fallbackTexture.getGLHandle();
 #ifdef USE_PARALLEL_PROCESSING
@@ -405,220 +596,173 @@ void ParticleSystem::process(float dt)
     for (auto e : entities/*m_potentiallyVisible*/)
 #endif
     {
-        //check each emitter to see if it should spawn a new particle
         auto& emitter = e.getComponent<ParticleEmitter>();
 
-        emitter.m_prevTimestamp = emitter.m_currentTimestamp;
-        emitter.m_currentTimestamp += dt;
-
-        const float rate = (1.f / emitter.settings.emitRate); //TODO this ought to be const when rate itself is set...
-
-        if (/*emitter.m_pendingUpdate &&*/
-            emitter.m_running)
+        //apply fallback texture if one doesn't exist
+        //this would be speedier to do once when adding the emitter to the system
+        //but the texture may change at runtime.
+        if (emitter.settings.textureID == 0)
         {
-            auto& tx = e.getComponent<Transform>();
-            glm::quat rotation = glm::quat_cast(tx.getLocalTransform());
-            auto worldPos = tx.getWorldPosition();
+            emitter.settings.textureID = fallbackTextureID;
+        }
 
-            emitter.m_emissionTime += dt;
+        simulate(emitter, e.getComponent<Transform>(), dt);
 
-            while (emitter.m_emissionTime > rate)
-            {
-                //make sure not to update this again unless it gets marked as visible next frame
-                //emitter.m_pendingUpdate = false;
+#ifdef USE_PARALLEL_PROCESSING
+    });
 
-                //apply fallback texture if one doesn't exist
-                //this would be speedier to do once when adding the emitter to the system
-                //but the texture may change at runtime.
-                if (emitter.settings.textureID == 0)
-                {
-                    emitter.settings.textureID = fallbackTextureID;
-                }
 
-                emitter.m_emissionTime -= rate;
+    //this still has to be done in the main thread cos OpenGL
+    for(auto e : entities)
+    {
+        auto& emitter = e.getComponent<ParticleEmitter>();
+#endif
+
+        //copy to the streaming buffer - aligning to the vertex
+        //size means we can draw from the offset as the first vertex
+        if (emitter.m_nextFreeParticle != 0)
+        {
+            const auto vertexDataSize = emitter.m_nextFreeParticle * VertexSize;
+            auto allocation = m_vertexBuffer.write(emitter.m_vertexData.data(), vertexDataSize, VertexSize);
+            emitter.m_vbo = allocation.buffer;
+            emitter.m_firstVertex = allocation.offset / VertexSize;
+        }
+    }
 
-                //interpolate position
-                emitter.m_emissionTimestamp += rate;
+    //m_potentiallyVisible.clear();
+}
 
-                const float t = (emitter.m_emissionTimestamp - emitter.m_prevTimestamp) / (emitter.m_currentTimestamp - emitter.m_prevTimestamp);
-                auto basePosition = glm::mix(emitter.m_previousPosition, worldPos, t);
+void ParticleSystem::simulate(ParticleEmitter& emitter, const Transform& tx, float dt)
+{
+    emitter.m_prevTimestamp = emitter.m_currentTimestamp;
+    emitter.m_currentTimestamp += dt;
 
-                static const float epsilon = 0.0001f;
-                auto emitCount = emitter.settings.emitCount;
-                while (emitCount--)
-                {
-                    if (emitter.m_nextFreeParticle < emitter.m_particles.size() - 1)
-                    {
-                        //TODO a lot of this only needs to be calc'd ONCE for every particle in emitCount
-                        const auto& settings = emitter.settings;
-                        CRO_ASSERT(settings.emitRate > 0, "Emit rate must be grater than 0");
-                        CRO_ASSERT(settings.lifetime > 0, "Lifetime must be greater than 0");
-                        auto& p = emitter.m_particles[emitter.m_nextFreeParticle];
-                        p.colour = settings.colour;
-                        p.gravity = settings.gravity;
-                        p.lifetime = settings.lifetime + cro::Util::Random::value(-settings.lifetimeVariance, settings.lifetimeVariance + epsilon);
-                        //p.lifetime -= (emitter.m_currentTimestamp - emitter.m_emissionTimestamp);
-                        p.maxLifeTime = p.lifetime;
-                        //p.lifetime *= 1.f - t;
-
-                        auto randRot = glm::rotate(rotation, Util::Random::value(-settings.spread, (settings.spread + epsilon)) * Util::Const::degToRad, Transform::X_AXIS);
-                        randRot = glm::rotate(randRot, Util::Random::value(-settings.spread, (settings.spread + epsilon)) * Util::Const::degToRad, Transform::Z_AXIS);
-
-                        auto worldScale = tx.getWorldScale();
-
-                        p.velocity = randRot * settings.initialVelocity;
-                        p.rotation = (settings.randomInitialRotation) ? Util::Random::value(-Util::Const::PI, Util::Const::PI) : 0.f;
-                        p.scale = std::abs((worldScale.x + worldScale.y) / 2.f);// 1.f;
-                        p.acceleration = settings.acceleration;
-                        p.frameID = (settings.useRandomFrame && settings.frameCount > 1) ? cro::Util::Random::value(0, static_cast<std::int32_t>(settings.frameCount) - 1) : 0;
-                        p.frameTime = 0.f;
-                        p.loopCount = settings.loopCount;
-
-                        //spawn particle in world position
-                        //auto basePosition = worldPos + interpolation;// tx.getWorldPosition();
-                        p.position = basePosition + (settings.initialVelocity * cro::Util::Random::value(0.001f, 0.007f));
-
-                        //add random radius placement - TODO how to do with a position table? CAN'T HAVE +- 0!!
-                        p.position.x += Util::Random::value(-settings.spawnRadius, settings.spawnRadius + epsilon);
-                        p.position.y += Util::Random::value(-settings.spawnRadius, settings.spawnRadius + epsilon);
-                        p.position.z += Util::Random::value(-settings.spawnRadius, settings.spawnRadius + epsilon);
-
-                        if (emitter.settings.inheritRotation)
-                        {
-                            /*p.position -= basePosition;
-                            p.position = rotation * glm::vec4(p.position, 1.f);
-                            p.position += basePosition;*/
-                            p.velocity = glm::vec3(tx.getWorldTransform() * glm::vec4(p.velocity, 0.0));
-                        }
-
-                        auto offset = settings.spawnOffset;
-                        offset *= worldScale;
-                        p.position += offset;
-
-
-                        emitter.m_nextFreeParticle++;
-                        if (emitter.m_releaseCount > 0)
-                        {
-                            emitter.m_releaseCount--;
-                        }
-                    }
-                }
-            }
-        }
+    const float rate = (1.f / emitter.settings.emitRate); //TODO this ought to be const when rate itself is set...
 
-        if (emitter.m_releaseCount == 0)
-        {
-            emitter.stop();
-        }
+    //check the emitter to see if it should spawn new particles
+    if (/*emitter.m_pendingUpdate &&*/
+        emitter.m_running)
+    {
+        glm::quat rotation = glm::quat_cast(tx.getLocalTransform());
+        auto worldPos = tx.getWorldPosition();
 
-        //update each particle
-        glm::vec3 minBounds(std::numeric_limits<float>::max());
-        glm::vec3 maxBounds(0.f);
+        emitter.m_emissionTime += dt;
 
-        float framerate = 1.f / emitter.settings.framerate;
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
+        while (emitter.m_emissionTime > rate)
         {
-            auto& p = emitter.m_particles[i];
+            //make sure not to update this again unless it gets marked as visible next frame
+            //emitter.m_pendingUpdate = false;
 
-            p.velocity *= p.acceleration;
-            p.velocity += p.gravity * dt;
-            for (auto f : emitter.settings.forces)
-            {
-                p.velocity += f * dt;
-            }
-            p.position += p.velocity * dt;
+            emitter.m_emissionTime -= rate;
 
-            p.lifetime -= dt;
-            p.colour.setAlpha(std::min(1.f, std::max(p.lifetime / p.maxLifeTime, 0.f)));
+            //interpolate position
+            emitter.m_emissionTimestamp += rate;
 
-            p.rotation += emitter.settings.rotationSpeed * dt;
-            p.scale += ((p.scale * emitter.settings.scaleModifier) * dt);
+            const float t = (emitter.m_emissionTimestamp - emitter.m_prevTimestamp) / (emitter.m_currentTimestamp - emitter.m_prevTimestamp);
+            auto basePosition = glm::mix(emitter.m_previousPosition, worldPos, t);
 
-            if (emitter.settings.animate)
+            static const float epsilon = 0.0001f;
+            auto emitCount = emitter.settings.emitCount;
+            while (emitCount--)
             {
-                p.frameTime += dt;
-                if (p.frameTime > framerate)
+                if (emitter.m_nextFreeParticle < emitter.m_particles.size() - 1)
                 {
-                    p.frameID++;
-                    if (p.frameID == emitter.settings.frameCount
-                        && p.loopCount)
+                    //TODO a lot of this only needs to be calc'd ONCE for every particle in emitCount
+                    const auto& settings = emitter.settings;
+                    CRO_ASSERT(settings.emitRate > 0, "Emit rate must be grater than 0");
+                    CRO_ASSERT(settings.lifetime > 0, "Lifetime must be greater than 0");
+                    auto& rand = emitter.m_random;
+
+                    Particle p;
+                    p.colour = settings.colour;
+                    p.gravity = settings.gravity;
+                    p.lifetime = settings.lifetime + rand.value(-settings.lifetimeVariance, settings.lifetimeVariance + epsilon);
+                    //p.lifetime -= (emitter.m_currentTimestamp - emitter.m_emissionTimestamp);
+                    p.maxLifeTime = p.lifetime;
+                    //p.lifetime *= 1.f - t;
+
+                    auto randRot = glm::rotate(rotation, rand.value(-settings.spread, (settings.spread + epsilon)) * Util::Const::degToRad, Transform::X_AXIS);
+                    randRot = glm::rotate(randRot, rand.value(-settings.spread, (settings.spread + epsilon)) * Util::Const::degToRad, Transform::Z_AXIS);
+
+                    auto worldScale = tx.getWorldScale();
+
+                    p.velocity = randRot * settings.initialVelocity;
+                    p.rotation = (settings.randomInitialRotation) ? rand.value(-Util::Const::PI, Util::Const::PI) : 0.f;
+                    p.scale = std::abs((worldScale.x + worldScale.y) / 2.f);// 1.f;
+                    p.acceleration = settings.acceleration;
+                    p.frameID = (settings.useRandomFrame && settings.frameCount > 1) ? rand.value(0, static_cast<std::int32_t>(settings.frameCount) - 1) : 0;
+                    p.frameTime = 0.f;
+                    p.loopCount = settings.loopCount;
+
+                    //spawn particle in world position
+                    //auto basePosition = worldPos + interpolation;// tx.getWorldPosition();
+                    p.position = basePosition + (settings.initialVelocity * rand.value(0.001f, 0.007f));
+
+                    //add random radius placement - TODO how to do with a position table? CAN'T HAVE +- 0!!
+                    p.position.x += rand.value(-settings.spawnRadius, settings.spawnRadius + epsilon);
+                    p.position.y += rand.value(-settings.spawnRadius, settings.spawnRadius + epsilon);
+                    p.position.z += rand.value(-settings.spawnRadius, settings.spawnRadius + epsilon);
+
+                    if (emitter.settings.inheritRotation)
                     {
-                        p.loopCount--;
-                        p.frameID = 0;
+                        /*p.position -= basePosition;
+                        p.position = rotation * glm::vec4(p.position, 1.f);
+                        p.position += basePosition;*/
+                        p.velocity = glm::vec3(tx.getWorldTransform() * glm::vec4(p.velocity, 0.0));
                     }
-                    p.frameTime -= framerate;
-                }
-            }
 
-            //update bounds for culling
-            if (p.position.x < minBounds.x) minBounds.x = p.position.x;
-            if (p.position.y < minBounds.y) minBounds.y = p.position.y;
-            if (p.position.z < minBounds.z) minBounds.z = p.position.z;
+                    auto offset = settings.spawnOffset;
+                    offset *= worldScale;
+                    p.position += offset;
 
-            if (p.position.x > maxBounds.x) maxBounds.x = p.position.x;
-            if (p.position.y > maxBounds.y) maxBounds.y = p.position.y;
-            if (p.position.z > maxBounds.z) maxBounds.z = p.position.z;
-        }
-        auto dist = (maxBounds - minBounds) / 2.f;
-        emitter.m_bounds.centre = dist + minBounds;
-        emitter.m_bounds.radius = glm::length(dist);
+                    emitter.m_particles.set(emitter.m_nextFreeParticle, p);
 
-        //go over again and remove dead particles with pop/swap
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
-        {
-            if (emitter.m_particles[i].lifetime < 0
-                || ((emitter.m_particles[i].frameID == emitter.settings.frameCount)
-                    && (emitter.m_particles[i].loopCount == 0)))
-            {
-                emitter.m_nextFreeParticle--;
-                std::swap(emitter.m_particles[i], emitter.m_particles[emitter.m_nextFreeParticle]);
+                    emitter.m_nextFreeParticle++;
+                    if (emitter.m_releaseCount > 0)
+                    {
+                        emitter.m_releaseCount--;
+                    }
+                }
             }
         }
-        //DPRINT("Next free Particle", std::to_string(emitter.m_nextFreeParticle));
-
-        //TODO sort verts by depth? should be drawing back to front for transparency really.
-
-        emitter.m_previousPosition = e.getComponent<cro::Transform>().getWorldPosition();
-
-#ifdef USE_PARALLEL_PROCESSING
-    });
-
+    }
 
-    //this still has to be done in the main thread cos OpenGL
-    for(auto e : entities)
+    if (emitter.m_releaseCount == 0)
     {
-        auto& emitter = e.getComponent<ParticleEmitter>();
-#endif
+        emitter.stop();
+    }
 
-        //update VBO
-        std::size_t idx = 0;
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
-        {
-            const auto& p = emitter.m_particles[i];
+    //update each particle
+    UpdateContext ctx;
+    ctx.dt = dt;
+    for (auto f : emitter.settings.forces)
+    {
+        ctx.forces += f;
+    }
+    ctx.forces *= dt;
+    ctx.rotation = emitter.settings.rotationSpeed * dt;
+    ctx.scale = emitter.settings.scaleModifier * dt;
 
-            //position
-            m_dataBuffer[idx++] = p.position.x;
-            m_dataBuffer[idx++] = p.position.y;
-            m_dataBuffer[idx++] = p.position.z;
+    integrate(emitter.m_particles, emitter.m_nextFreeParticle, ctx);
 
-            //colour
-            m_dataBuffer[idx++] = p.colour.getRed();
-            m_dataBuffer[idx++] = p.colour.getGreen();
-            m_dataBuffer[idx++] = p.colour.getBlue();
-            m_dataBuffer[idx++] = p.colour.getAlpha();
+    if (emitter.settings.animate)
+    {
+        animate(emitter.m_particles, emitter.m_nextFreeParticle, emitter.settings, dt);
+    }
 
-            //rotation/size/animation
-            m_dataBuffer[idx++] = p.rotation * Util::Const::degToRad;
-            m_dataBuffer[idx++] = p.scale;
-            m_dataBuffer[idx++] = static_cast<float>(p.frameID);
-        }
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, emitter.m_vbo));
-        glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, idx * sizeof(float), m_dataBuffer.data()));
+    //update bounds for culling
+    if (emitter.m_nextFreeParticle != 0)
+    {
+        emitter.m_bounds = calcBounds(emitter.m_particles, emitter.m_nextFreeParticle);
     }
 
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    emitter.m_nextFreeParticle = removeDead(emitter.m_particles, emitter.m_nextFreeParticle, emitter.settings);
+    writeVertices(emitter.m_particles, emitter.m_nextFreeParticle, emitter.m_vertexData);
+    //DPRINT("Next free Particle", std::to_string(emitter.m_nextFreeParticle));
 
-    //m_potentiallyVisible.clear();
+    //TODO sort verts by depth? should be drawing back to front for transparency really.
+
+    emitter.m_previousPosition = tx.getWorldPosition();
 }
 
 void ParticleSystem::render(Entity camera, const RenderTarget& rt)
@@ -670,7 +814,9 @@ void ParticleSystem::render(Entity camera, const RenderTarget& rt)
         };
         glCheck(glActiveTexture(GL_TEXTURE0));
 
-
+#ifdef PLATFORM_DESKTOP
+        glCheck(glBindVertexArray(m_vao));
+#endif
 
         const auto& entities = m_drawLists[cam.getDrawListIndex()][cam.getActivePassIndex()];
         for (auto entity : entities)
@@ -683,6 +829,10 @@ void ParticleSystem::render(Entity camera, const RenderTarget& rt)
             }
 
             const auto& emitter = entity.getComponent<ParticleEmitter>();
+            if (emitter.m_nextFreeParticle == 0)
+            {
+                continue;
+            }
 
             //apply blend mode - this also binds the appropriate shader for current mode
             switch (emitter.settings.blendmode)
@@ -708,23 +858,18 @@ void ParticleSystem::render(Entity camera, const RenderTarget& rt)
 
 
 #ifdef PLATFORM_DESKTOP
-            glCheck(glBindVertexArray(emitter.m_vao));
-            glCheck(glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(emitter.m_nextFreeParticle)));
-#else
-            //bind emitter vbo
-            glCheck(glBindBuffer(GL_ARRAY_BUFFER, emitter.m_vbo));
-
-            //bind vertex attribs
-            for (auto [index, attribSize, offset] : m_shaderHandles[0].attribData)
+            //the streaming buffer may have been resized
+            if (emitter.m_vbo != m_vaoBuffer)
             {
-                glCheck(glEnableVertexAttribArray(index));
-                glCheck(glVertexAttribPointer(index, attribSize,
-                    GL_FLOAT, GL_FALSE, VertexSize,
-                    reinterpret_cast<void*>(static_cast<intptr_t>(offset))));
+                bindAttribs(emitter.m_vbo);
             }
+            glCheck(glDrawArrays(GL_POINTS, static_cast<GLint>(emitter.m_firstVertex), static_cast<GLsizei>(emitter.m_nextFreeParticle)));
+#else
+            //bind emitter vbo and vertex attribs
+            bindAttribs(emitter.m_vbo);
 
             //draw
-            glCheck(glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(emitter.m_nextFreeParticle)));
+            glCheck(glDrawArrays(GL_POINTS, static_cast<GLint>(emitter.m_firstVertex), static_cast<GLsizei>(emitter.m_nextFreeParticle)));
 
             //unbind attribs
             for (auto j = 0u; j < m_shaderHandles[0].attribData.size(); ++j)
@@ -757,57 +902,14 @@ void ParticleSystem::render(Entity camera, const RenderTarget& rt)
 //private
 void ParticleSystem::onEntityAdded(Entity entity)
 {    
-    //check VBO count and increase if needed
-    if (m_nextBuffer == m_bufferCount)
-    {
-        for (auto i = 0u; i < MinParticleSystems; ++i)
-        {
-            allocateBuffer();
-        }
-    }
-
     auto pos = entity.getComponent<cro::Transform>().getWorldPosition();
     entity.getComponent<cro::ParticleEmitter>().m_previousPosition = pos;
-
-    entity.getComponent<ParticleEmitter>().m_vbo = m_vboIDs[m_nextBuffer];
-    entity.getComponent<ParticleEmitter>().m_vao = m_vaoIDs[m_nextBuffer];
-    m_nextBuffer++;
 }
 
-void ParticleSystem::onEntityRemoved(Entity entity)
+void ParticleSystem::bindAttribs(std::uint32_t vbo)
 {
-    auto vboID = entity.getComponent<ParticleEmitter>().m_vbo;
-    auto vaoID = entity.getComponent<ParticleEmitter>().m_vao;
-    
-    //update available VBOs
-    std::size_t idx = 0;
-    while (m_vboIDs[idx] != vboID) { idx++; }
-
-    std::swap(m_vboIDs[idx], m_vboIDs[m_nextBuffer]);
-
-    //and vaos
-    idx = 0;
-    while (m_vaoIDs[idx] != vaoID) { idx++; }
-
-    std::swap(m_vaoIDs[idx], m_vaoIDs[m_nextBuffer]);
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, vbo));
 
-    m_nextBuffer--;
-}
-
-void ParticleSystem::allocateBuffer()
-{
-    CRO_ASSERT(m_bufferCount < m_vboIDs.size(), "Max Buffers Reached!");
-    glCheck(glGenBuffers(1, &m_vboIDs[m_bufferCount]));
-
-#ifdef PLATFORM_DESKTOP
-    glCheck(glGenVertexArrays(1, &m_vaoIDs[m_bufferCount]));
-    glCheck(glBindVertexArray(m_vaoIDs[m_bufferCount]));
-#endif //PLATFORM
-
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vboIDs[m_bufferCount]));
-    glCheck(glBufferData(GL_ARRAY_BUFFER, MaxVertData * sizeof(float), nullptr, GL_DYNAMIC_DRAW));
-
-#ifdef PLATFORM_DESKTOP
     //HMMMMMMM this only works because all the shaders use the same vertex shader
     for(auto [index, attribSize, offset] : m_shaderHandles[0].attribData)
     {
@@ -817,12 +919,7 @@ void ParticleSystem::allocateBuffer()
             reinterpret_cast<void*>(static_cast<intptr_t>(offset))));
     }
 
-    glCheck(glBindVertexArray(0));
-#endif //PLATFORM
-
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-
-    m_bufferCount++;
+    m_vaoBuffer = vbo;
 }
 
 #ifdef PARALLEL_DISABLE
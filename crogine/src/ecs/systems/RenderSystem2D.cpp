@@ -74,7 +74,10 @@ RenderSystem2D::RenderSystem2D(MessageBus& mb)
     m_drawLists     (1)
 {
     requireComponent<Drawable2D>();
-    requireComponent<Transform>();
+    requireComponent<Transform>(ComponentAccess::Read);
+
+    //vertex data is uploaded directly to the GPU
+    setExecutionPolicy(ExecutionPolicy::MainThread);
 
     //load default shaders
     m_colouredShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Coloured);
@@ -28,6 +28,7 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/ecs/systems/ShadowMapRenderer.hpp>
+#include <crogine/ecs/systems/ModelRenderer.hpp>
 
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/Camera.hpp>
@@ -55,6 +56,21 @@ namespace
     std::uint32_t intervalCounter = 0;
 
     constexpr float CascadeOverlap = 0.5f;
+
+    //converts a light space AABB to world space planes
+    cro::Frustum getWorldPlanes(const cro::Box& lightBox, const glm::mat4& lightView)
+    {
+        const auto toWorld = glm::transpose(lightView);
+        return
+        {
+            toWorld * cro::Plane(1.f, 0.f, 0.f, -lightBox[0].x),
+            toWorld * cro::Plane(-1.f, 0.f, 0.f, lightBox[1].x),
+            toWorld * cro::Plane(0.f, 1.f, 0.f, -lightBox[0].y),
+            toWorld * cro::Plane(0.f, -1.f, 0.f, lightBox[1].y),
+            toWorld * cro::Plane(0.f, 0.f, 1.f, -lightBox[0].z),
+            toWorld * cro::Plane(0.f, 0.f, -1.f, lightBox[1].z)
+        };
+    }
 }
 
 ShadowMapRenderer::ShadowMapRenderer(cro::MessageBus& mb)
@@ -210,28 +226,28 @@ void ShadowMapRenderer::updateDrawList(Entity camEnt)
         std::int32_t visibleCount = 0;
 #endif
 
-        //use depth frusta to cull entities
-        auto& entities = getEntities();
-        for (auto& entity : entities)
+        //gathers the bounds of active casters so that they can be
+        //tested against each cascade as a batch
+        const auto getCasterSphere = [&](Entity entity, Sphere& sphere)
         {
             if (!entity.getComponent<ShadowCaster>().active)
             {
-                continue;
+                return false;
             }
 
-            auto& model = entity.getComponent<Model>();
+            const auto& model = entity.getComponent<Model>();
             if (model.isHidden())
             {
-                continue;
+                return false;
             }
 
             if ((model.m_renderFlags & camera.getPass(Camera::Pass::Final).renderFlags) == 0)
             {
-                continue;
+                return false;
             }
 
             const auto& tx = entity.getComponent<Transform>();
-            auto sphere = model.getBoundingSphere();
+            sphere = model.getBoundingSphere();
 
             sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
             auto scale = tx.getWorldScale();
@@ -239,34 +255,99 @@ void ShadowMapRenderer::updateDrawList(Entity camEnt)
             //if it's approaching zero scale then don't cast shadow
             /*if (scale.x * scale.y * scale.z < 0.01f)
             {
-                continue;
+                return false;
             }*/
 
             sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+            return true;
+        };
 
-            std::vector<std::pair<std::size_t, std::size_t>> drawListOffsets;
-
-            for (auto i = 0u; i < camera.getCascadeCount(); ++i)
-            {
-                float distance = glm::dot(-lightDir, sphere.centre - lightPositions[i]);
-
-                //put sphere into lightspace and do an AABB test on the ortho projection
-                auto lightSphere = sphere;
-                lightSphere.centre = glm::vec3(camera.m_shadowViewMatrices[i] * glm::vec4(lightSphere.centre, 1.f));
-                
-                if (frustums[i].intersects(lightSphere))
-                {
+        const auto addCaster = [&](Entity entity, const Sphere& sphere, std::uint32_t cascade)
+        {
+            float distance = glm::dot(-lightDir, sphere.centre - lightPositions[cascade]);
 #ifdef PLATFORM_DESKTOP
-                    drawList[i].emplace_back(entity, distance);
+            drawList[cascade].emplace_back(entity, distance);
 #else
-                    //just place them all in the same draw list
-                    drawList[0].emplace_back(entity, distance);
+            //just place them all in the same draw list
+            drawList[0].emplace_back(entity, distance);
 #endif
 #ifdef CRO_DEBUG_
-                    visibleCount++;
+            visibleCount++;
 #endif
+        };
+
+        //the depth frusta are tested as world space planes, which is
+        //slightly more conservative than testing the light space AABB
+        //directly, but allows testing all the casters in one go
+        const auto cullCasters = [&](std::uint32_t cascade)
+        {
+            Spatial::intersects(getWorldPlanes(frustums[cascade], camera.m_shadowViewMatrices[cascade]), m_casterSpheres, m_casterVisibility);
+            for (auto j = 0u; j < m_casters.size(); ++j)
+            {
+                if (Spatial::isVisible(m_casterVisibility, j))
+                {
+                    addCaster(m_casters[j], m_casterSpheres[j], cascade);
                 }
             }
+        };
+
+        //if the ModelRenderer is maintaining a tree use it to query
+        //each cascade, else test every entity against every cascade
+        auto* modelRenderer = getScene()->getSystem<ModelRenderer>();
+        if (modelRenderer && modelRenderer->getUseTreeQueries())
+        {
+            modelRenderer->refreshTree();
+
+            for (auto i = 0u; i < camera.getCascadeCount(); ++i)
+            {
+                m_treeResults.clear();
+                modelRenderer->m_tree.queryFrustum(getWorldPlanes(frustums[i], camera.m_shadowViewMatrices[i]), m_treeResults);
+
+                m_casters.clear();
+                m_casterSpheres.clear();
+
+                for (auto [entity, contained] : m_treeResults)
+                {
+                    //the tree contains all models, not just shadow casters
+                    Sphere sphere;
+                    if (entity.hasComponent<ShadowCaster>()
+                        && getCasterSphere(entity, sphere))
+                    {
+                        //completely inside the cascade so needs no further testing
+                        if (contained)
+                        {
+                            addCaster(entity, sphere, i);
+                        }
+                        else
+                        {
+                            m_casters.push_back(entity);
+                            m_casterSpheres.push_back(sphere);
+                        }
+                    }
+                }
+                cullCasters(i);
+            }
+        }
+        else
+        {
+            m_casters.clear();
+            m_casterSpheres.clear();
+
+            const auto& entities = getEntities();
+            for (auto entity : entities)
+            {
+                Sphere sphere;
+                if (getCasterSphere(entity, sphere))
+                {
+                    m_casters.push_back(entity);
+                    m_casterSpheres.push_back(sphere);
+                }
+            }
+
+            for (auto i = 0u; i < camera.getCascadeCount(); ++i)
+            {
+                cullCasters(i);
+            }
         }
 
         //sort back to front
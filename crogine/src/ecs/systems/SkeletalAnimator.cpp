@@ -42,6 +42,10 @@ source distribution.
 
 #include <crogine/detail/glm/gtx/quaternion.hpp>
 
+#include "../../detail/SIMD.hpp"
+
+#include <limits>
+
 //#define PARALLEL_DISABLE
 #ifdef PARALLEL_DISABLE
 #undef USE_PARALLEL_PROCESSING
@@ -55,20 +59,106 @@ using namespace cro;
 
 namespace
 {
-    //interp tx and rot separately
-    //TODO convert to 4x3 to free up some uniform space
-    glm::mat4 mixJoint(const Joint& a, const Joint& b, float time, Joint& output)
+#ifdef CRO_SIMD
+    //sin() for 0 <= x <= pi/2 (taylor series, error < 1e-7)
+    Detail::SIMD::Float4 sinQuarter(Detail::SIMD::Float4 x)
     {
-        output.translation = glm::mix(a.translation, b.translation, time);
-        output.rotation = glm::slerp(a.rotation, b.rotation, time);
-        output.scale = glm::mix(a.scale, b.scale, time);
+        using namespace Detail::SIMD;
+        const auto x2 = mul(x, x);
+        auto result = splat(-1.f / 39916800.f);
+        result = add(mul(result, x2), splat(1.f / 362880.f));
+        result = add(mul(result, x2), splat(-1.f / 5040.f));
+        result = add(mul(result, x2), splat(1.f / 120.f));
+        result = add(mul(result, x2), splat(-1.f / 6.f));
+        result = add(mul(result, x2), splat(1.f));
+        return mul(result, x);
+    }
 
-        CRO_ASSERT(a.parent == b.parent, "");
-        output.parent = a.parent; //if a and b's parents differ then something is very wrong
+    //acos() for 0 <= x <= 1 (Abramowitz & Stegun 4.4.46, error < 2e-8)
+    Detail::SIMD::Float4 acosPositive(Detail::SIMD::Float4 x)
+    {
+        using namespace Detail::SIMD;
+        auto result = splat(-0.0012624911f);
+        result = add(mul(result, x), splat(0.0066700901f));
+        result = add(mul(result, x), splat(-0.0170881256f));
+        result = add(mul(result, x), splat(0.0308918810f));
+        result = add(mul(result, x), splat(-0.0501743046f));
+        result = add(mul(result, x), splat(0.0889789874f));
+        result = add(mul(result, x), splat(-0.2145988016f));
+        result = add(mul(result, x), splat(1.5707963050f));
+        return mul(result, sqrt(max(sub(splat(1.f), x), splat(0.f))));
+    }
+#endif
+
+    //slerps count rotations, starting at the given offsets. This follows
+    //glm::slerp() - taking the shortest path and falling back to lerp for
+    //(nearly) identical rotations - processing 4 joints at a time.
+    void slerp(const JointPose& a, std::size_t offsetA, const JointPose& b, std::size_t offsetB, float time, JointPose& output, std::size_t count)
+    {
+        std::size_t i = 0;
+#ifdef CRO_SIMD
+        using namespace Detail::SIMD;
 
-        glm::mat4 result = glm::translate(glm::mat4(1.f), output.translation);
-        result *= glm::toMat4(output.rotation);
-        return glm::scale(result, output.scale);
+        const auto t = splat(time);
+        const auto invT = splat(1.f - time);
+        const auto zero = splat(0.f);
+        const auto lerpThreshold = splat(1.f - std::numeric_limits<float>::epsilon());
+
+        for (; i + Width <= count; i += Width)
+        {
+            const auto ax = load(&a.rotationX[offsetA + i]);
+            const auto ay = load(&a.rotationY[offsetA + i]);
+            const auto az = load(&a.rotationZ[offsetA + i]);
+            const auto aw = load(&a.rotationW[offsetA + i]);
+
+            const auto bx = load(&b.rotationX[offsetB + i]);
+            const auto by = load(&b.rotationY[offsetB + i]);
+            const auto bz = load(&b.rotationZ[offsetB + i]);
+            const auto bw = load(&b.rotationW[offsetB + i]);
+
+            const auto cosTheta = add(add(mul(ax, bx), mul(ay, by)), add(mul(az, bz), mul(aw, bw)));
+            const auto negative = lessThan(cosTheta, zero);
+            const auto absCos = abs(cosTheta);
+
+            const auto theta = acosPositive(min(absCos, splat(1.f)));
+            const auto sinTheta = sinQuarter(theta);
+
+            auto weightA = div(sinQuarter(mul(invT, theta)), sinTheta);
+            auto weightB = div(sinQuarter(mul(t, theta)), sinTheta);
+
+            const auto useLerp = greaterThan(absCos, lerpThreshold);
+            weightA = select(useLerp, invT, weightA);
+            weightB = select(useLerp, t, weightB);
+            weightB = select(negative, sub(zero, weightB), weightB);
+
+            store(&output.rotationX[i], add(mul(ax, weightA), mul(bx, weightB)));
+            store(&output.rotationY[i], add(mul(ay, weightA), mul(by, weightB)));
+            store(&output.rotationZ[i], add(mul(az, weightA), mul(bz, weightB)));
+            store(&output.rotationW[i], add(mul(aw, weightA), mul(bw, weightB)));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const auto rotation = glm::slerp(a.getRotation(offsetA + i), b.getRotation(offsetB + i), time);
+            output.rotationX[i] = rotation.x;
+            output.rotationY[i] = rotation.y;
+            output.rotationZ[i] = rotation.z;
+            output.rotationW[i] = rotation.w;
+        }
+    }
+
+    //interp tx and rot separately
+    void mixPoses(const JointPose& a, std::size_t offsetA, const JointPose& b, std::size_t offsetB, float time, JointPose& output, std::size_t count)
+    {
+        CRO_ASSERT(output.size() >= count, "");
+
+        for (auto i = 0u; i < count; ++i)
+        {
+            output.translation[i] = glm::mix(a.translation[offsetA + i], b.translation[offsetB + i], time);
+            output.scale[i] = glm::mix(a.scale[offsetA + i], b.scale[offsetB + i], time);
+        }
+        slerp(a, offsetA, b, offsetB, time, output, count);
     }
 
     float playbackRate = 1.f;
@@ -79,6 +169,10 @@ SkeletalAnimator::SkeletalAnimator(MessageBus& mb)
 {
     requireComponent<Model>();
     requireComponent<Skeleton>();
+
+    //attachments write to the transform of other entities
+    accessComponent<Transform>(ComponentAccess::ReadWrite);
+    setExecutionPolicy(ExecutionPolicy::Concurrent);
 }
 
 //public
@@ -103,6 +197,12 @@ void SkeletalAnimator::process(float dt)
         {
             auto& skel = entity.getComponent<Skeleton>();
 
+            //animations may have been added or removed since the last update
+            if (skel.m_poseDataDirty)
+            {
+                skel.updatePoseData();
+            }
+
             //check the model is roughly in front of the camera and within interp distance
             const auto direction = entity.getComponent<cro::Transform>().getWorldPosition() - camPos;
             bool useInterpolation = (glm::dot(direction, camDir) > 0 //could squeeze a bit more out of this if we take FOV into account...
@@ -157,7 +257,7 @@ void SkeletalAnimator::process(float dt)
                 auto& ap = skel.m_attachments[i];
                 if (ap.getModel().isValid())
                 {
-                    ap.getModel().getComponent<cro::Transform>().m_attachmentTransform = ctx.worldTransform * skel.getAttachmentTransform(i);
+                    ap.getModel().getComponent<cro::Transform>().setAttachmentTransform(ctx.worldTransform * skel.getAttachmentTransform(i));
                 }
             }
         }
@@ -232,6 +332,8 @@ void SkeletalAnimator::onEntityAdded(Entity entity)
         skeleton.m_invBindPose.resize(skeleton.m_frameSize);
     }
 
+    skeleton.updatePoseData();
+
     //update the bounds for each key frame
     for (auto i = 0u; i < skeleton.m_frameCount; ++i)
     {
@@ -327,58 +429,45 @@ void SkeletalAnimator::interpolateAnimation(SkeletalAnim& source, std::size_t ta
     std::size_t startB = targetFrame * skeleton.m_frameSize;
 
     //stores interpolated output in source so we can use it to blend.
-    //we mix all the joints first to prevent it happening multiple times
-    //when we create the world transforms.
-
-    std::vector<glm::mat4> mixBuffer(skeleton.m_frameSize);
-    for (auto i = 0u; i < skeleton.m_frameSize; ++i)
-    {
-        mixBuffer[i] = mixJoint(skeleton.m_frames[startA + i], skeleton.m_frames[startB + i], time, source.interpolationOutput[i]);
-    }
+    mixPoses(skeleton.m_keyFramePoses, startA, skeleton.m_keyFramePoses, startB, time, source.interpolationOutput, skeleton.m_frameSize);
 
-    for (auto i = 0u; i < skeleton.m_frameSize; ++i)
+    //note this gets overwritten if blending animations - might be
+    //useful to prevent it happening in those cases?
+    if (output)
     {
-        glm::mat4 worldMatrix = mixBuffer[i];
-
-        std::int32_t parent = skeleton.m_frames[startA + i].parent;
-        while (parent != -1)
-        {
-            worldMatrix = mixBuffer[parent] * worldMatrix;
-            parent = skeleton.m_frames[startA + parent].parent;
-        }
-
-        //note this gets overwritten if blending animations - might be
-        //useful to prevent it happening in those cases?
-        if (output)
-        {
-            skeleton.m_currentFrame[i] = skeleton.m_rootTransform * worldMatrix * skeleton.m_invBindPose[i];
-        }
-        
+        applyPose(source.interpolationOutput, skeleton);
     }
 }
 
 void SkeletalAnimator::blendAnimations(const SkeletalAnim& a, const SkeletalAnim& b, float time, Skeleton& skeleton) const
 {
-    Joint temp; //we need something to pass as a func param
-    std::vector<glm::mat4> mixBuffer(skeleton.m_frameSize);
+    mixPoses(a.interpolationOutput, 0, b.interpolationOutput, 0, time, skeleton.m_blendPose, skeleton.m_frameSize);
+    applyPose(skeleton.m_blendPose, skeleton);
+}
 
-    for (auto i = 0u; i < skeleton.m_frameSize; ++i)
+void SkeletalAnimator::applyPose(const JointPose& pose, Skeleton& skeleton) const
+{
+    //TODO convert to 4x3 to free up some uniform space
+    auto& transforms = skeleton.m_jointTransforms;
+
+    //joints are ordered so that parent transforms are always
+    //complete before any of their children are visited
+    for (auto i : skeleton.m_jointOrder)
     {
-        mixBuffer[i] = mixJoint(a.interpolationOutput[i], b.interpolationOutput[i], time, temp);
+        const auto& scale = pose.scale[i];
+        glm::mat4 localMatrix = glm::toMat4(pose.getRotation(i));
+        localMatrix[0] *= scale.x;
+        localMatrix[1] *= scale.y;
+        localMatrix[2] *= scale.z;
+        localMatrix[3] = glm::vec4(pose.translation[i], 1.f);
+
+        const auto parent = skeleton.m_jointParents[i];
+        transforms[i] = parent == -1 ? localMatrix : transforms[parent] * localMatrix;
     }
 
     for (auto i = 0u; i < skeleton.m_frameSize; ++i)
     {
-        auto worldMat = mixBuffer[i];
-
-        auto parent = a.interpolationOutput[i].parent;
-        while (parent != -1)
-        {
-            worldMat = mixBuffer[parent] * worldMat;
-            parent = a.interpolationOutput[parent].parent;
-        }
-
-        skeleton.m_currentFrame[i] = skeleton.m_rootTransform * worldMat * skeleton.m_invBindPose[i];
+        skeleton.m_currentFrame[i] = skeleton.m_rootTransform * transforms[i] * skeleton.m_invBindPose[i];
     }
 }
 
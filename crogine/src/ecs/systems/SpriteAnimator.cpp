@@ -57,6 +57,8 @@ SpriteAnimator::SpriteAnimator(MessageBus& mb)
     requireComponent<Sprite>();
     requireComponent<SpriteAnimation>();
 
+    setExecutionPolicy(ExecutionPolicy::Concurrent);
+
     m_animationEvents.reserve(MaxEvents);
 }
 
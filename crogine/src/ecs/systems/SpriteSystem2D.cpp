@@ -39,6 +39,9 @@ SpriteSystem2D::SpriteSystem2D(MessageBus& mb)
 {
     requireComponent<Sprite>();
     requireComponent<Drawable2D>();
+
+    //updating the texture may recreate the drawable's VAO
+    setExecutionPolicy(ExecutionPolicy::MainThread);
 }
 
 //public
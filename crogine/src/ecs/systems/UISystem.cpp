@@ -67,6 +67,8 @@ UISystem::UISystem(MessageBus& mb)
     requireComponent<UIInput>();
     requireComponent<Transform>();
 
+    subscribe(Message::WindowMessage);
+
     //default callback for components which don't have one assigned
     m_buttonCallbacks.push_back([](Entity, ButtonEvent) {});
     m_movementCallbacks.push_back([](Entity, glm::vec2, MotionEvent) {});
@@ -33,6 +33,7 @@ source distribution.
 #include <crogine/core/FileSystem.hpp>
 
 #include "../detail/GLCheck.hpp"
+#include "../detail/ModelBinaryV3.hpp"
 
 using namespace cro;
 
@@ -75,6 +76,41 @@ Skeleton BinaryMeshBuilder::getSkeleton() const
 
 Mesh::Data BinaryMeshBuilder::build() const
 {
+    if (!m_prepared
+        && !prepare())
+    {
+        return {};
+    }
+
+    auto meshData = m_meshData;
+    if (meshData.vertexSize != 0)
+    {
+        createVBO(meshData, m_vertexData);
+
+        //version 3 indices are uploaded straight from the file payload
+        auto offset = m_indexOffset;
+        for (auto i = 0u; i < meshData.submeshCount; ++i)
+        {
+            const std::int32_t indexSize = meshData.indexData[i].format == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+            createIBO(meshData, m_indexData.data() + offset, i, indexSize);
+            offset += meshData.indexData[i].indexCount * indexSize;
+        }
+    }
+
+    //the data is now on the GPU, so there's no need to keep a copy
+    m_meshData = {};
+    m_vertexData = {};
+    m_indexData = {};
+    m_indexOffset = 0;
+    m_prepared = false;
+
+    return meshData;
+}
+
+//private
+bool BinaryMeshBuilder::prepare() const
+{
+    m_prepared = false;
     Mesh::Data meshData;
 
     RaiiRWops file;
@@ -86,7 +122,7 @@ Mesh::Data BinaryMeshBuilder::build() const
         if (len < sizeof(header))
         {
             LogE << "Unable to open " << m_path << ": invalid file size" << std::endl;
-            return {};
+            return false;
         }
 
         SDL_RWseek(file.file, 0, RW_SEEK_SET);
@@ -96,182 +132,250 @@ Mesh::Data BinaryMeshBuilder::build() const
             && header.magic != Detail::ModelBinary::MAGIC_V1)
         {
             LogE << "Invalid header found" << std::endl;
-            return {};
+            return false;
         }
 
         if (header.meshOffset)
         {
-            Detail::ModelBinary::MeshHeader meshHeader;
-            SDL_RWread(file.file, &meshHeader, sizeof(meshHeader), 1);
+            std::vector<float> vertData;
+            std::vector<std::uint8_t> indexData;
+            std::size_t indexOffset = 0;
 
-            if ((meshHeader.flags & VertexProperty::Position) == 0)
+            if (header.version > 2)
             {
-                LogE << "No position data in mesh" << std::endl;
-                return {};
-            }
-
-            std::vector<float> tempVerts;
-            std::vector<std::uint32_t> sizes(meshHeader.indexArrayCount);
-            std::vector<std::vector<std::uint32_t>> indexData(meshHeader.indexArrayCount);
+                Detail::ModelBinary::MeshHeaderV3 meshHeader;
+                SDL_RWread(file.file, &meshHeader, sizeof(meshHeader), 1);
 
-            SDL_RWread(file.file, sizes.data(), meshHeader.indexArrayCount * sizeof(std::uint32_t), 1);
+                Detail::ModelBinary::PayloadV3 payload;
+                if (!Detail::ModelBinary::readPayload(file.file, meshHeader, payload))
+                {
+                    LogE << "Invalid mesh data in " << m_path << std::endl;
+                    return false;
+                }
+                Detail::ModelBinary::unpackVertices(meshHeader, payload, vertData, true);
 
-            std::uint32_t vertStride = 0;
-            for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
-            {
-                if (meshHeader.flags & (1 << i))
+                for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
                 {
-                    switch (i)
+                    if (meshHeader.flags & (1 << i))
                     {
-                    default:
-                    case Mesh::Attribute::Bitangent:
-                        break;
-                    case Mesh::Attribute::Position:
-                        vertStride += 3;
-                        meshData.attributes[i] = 3;
-                        break;
-                    case Mesh::Attribute::Colour:
-                        vertStride += 4;
-                        meshData.attributes[i] = 4;
-                        break;
-                    case Mesh::Attribute::Normal:
-                        vertStride += 3;
-                        meshData.attributes[i] = 3;
-                        break;
-                    case Mesh::Attribute::Tangent:
-                        meshData.attributes[i] = 3;
-                        meshData.attributes[Mesh::Attribute::Bitangent] = 3;
-                        vertStride += 4; //we'll be decoding tangents
-                        break;
-                    case Mesh::Attribute::UV0:
-                    case Mesh::Attribute::UV1:
-                        vertStride += 2;
-                        meshData.attributes[i] = 2;
-                        break;
-                    case Mesh::Attribute::BlendIndices:
-                    case Mesh::Attribute::BlendWeights:
-                        vertStride += 4;
-                        meshData.attributes[i] = 4;
-                        break;
+                        switch (i)
+                        {
+                        default:
+                        case Mesh::Attribute::Bitangent:
+                            break;
+                        case Mesh::Attribute::Position:
+                        case Mesh::Attribute::Normal:
+                            meshData.attributes[i] = 3;
+                            break;
+                        case Mesh::Attribute::Tangent:
+                            meshData.attributes[i] = 3;
+                            meshData.attributes[Mesh::Attribute::Bitangent] = 3;
+                            break;
+                        case Mesh::Attribute::UV0:
+                        case Mesh::Attribute::UV1:
+                            meshData.attributes[i] = 2;
+                            break;
+                        case Mesh::Attribute::Colour:
+                        case Mesh::Attribute::BlendIndices:
+                        case Mesh::Attribute::BlendWeights:
+                            meshData.attributes[i] = 4;
+                            break;
+                        }
                     }
                 }
-            }
 
-            auto pos = SDL_RWtell(file.file);
-            auto vertSize = meshHeader.indexArrayOffset - pos;
-            tempVerts.resize(vertSize / sizeof(float));
-            SDL_RWread(file.file, tempVerts.data(), vertSize, 1);
-            CRO_ASSERT(tempVerts.size() % vertStride == 0, "");
-            
-            for (auto i = 0u; i < meshHeader.indexArrayCount; ++i)
-            {
-                indexData[i].resize(sizes[i]);
-                SDL_RWread(file.file, indexData[i].data(), sizes[i] * sizeof(std::uint32_t), 1);
-            }
+                meshData.attributeFlags = meshHeader.flags;
+                meshData.submeshCount = meshHeader.indexArrayCount;
+                for (auto i = 0u; i < meshData.submeshCount; ++i)
+                {
+                    meshData.indexData[i].format = meshHeader.indexSize == sizeof(std::uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+                    meshData.indexData[i].indexCount = payload.arraySizes[i];
+                }
 
-            //process vertex data
-            std::vector<float> vertData;
-            for (auto i = 0u; i < tempVerts.size(); i += vertStride)
+                //keep the payload rather than copying the indices out of it
+                indexOffset = payload.indexOffset;
+                indexData.swap(payload.data);
+            }
+            else
             {
-                std::uint32_t offset = 0;
-                glm::vec3 normal = glm::vec3(0.f);
-                for (auto j = 0u; j < Mesh::Attribute::Total; ++j)
+                Detail::ModelBinary::MeshHeader meshHeader;
+                SDL_RWread(file.file, &meshHeader, sizeof(meshHeader), 1);
+
+                if ((meshHeader.flags & VertexProperty::Position) == 0)
+                {
+                    LogE << "No position data in mesh" << std::endl;
+                    return false;
+                }
+
+                std::vector<float> tempVerts;
+                std::vector<std::uint32_t> sizes(meshHeader.indexArrayCount);
+
+                SDL_RWread(file.file, sizes.data(), meshHeader.indexArrayCount * sizeof(std::uint32_t), 1);
+
+                std::uint32_t vertStride = 0;
+                for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
                 {
-                    if (meshHeader.flags & (1 << j))
+                    if (meshHeader.flags & (1 << i))
                     {
-                        switch (j)
+                        switch (i)
                         {
                         default:
                         case Mesh::Attribute::Bitangent:
                             break;
                         case Mesh::Attribute::Position:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-
-                            offset += 3;
+                            vertStride += 3;
+                            meshData.attributes[i] = 3;
                             break;
                         case Mesh::Attribute::Colour:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-                            vertData.push_back(tempVerts[i + offset + 3]);
-
-                            offset += 4;
+                            vertStride += 4;
+                            meshData.attributes[i] = 4;
                             break;
                         case Mesh::Attribute::Normal:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-
-                            normal =
-                            {
-                                tempVerts[i + offset],
-                                tempVerts[i + offset + 1],
-                                tempVerts[i + offset + 2],
-                            };
-
-                            offset += 3;
+                            vertStride += 3;
+                            meshData.attributes[i] = 3;
                             break;
                         case Mesh::Attribute::Tangent:
-                        {
-                            glm::vec3 tan =
-                            {
-                                (tempVerts[i + offset]),
-                                (tempVerts[i + offset + 1]),
-                                (tempVerts[i + offset + 2])
-                            };
-
-                            auto sign = (tempVerts[i + offset + 3]);
-                            CRO_ASSERT(glm::length2(normal) != 0, "");
-
-                            auto bitan = glm::cross(normal, tan) * sign;
-
-                            vertData.push_back(tan.x);
-                            vertData.push_back(tan.y);
-                            vertData.push_back(tan.z);
-                            
-                            vertData.push_back(bitan.x);
-                            vertData.push_back(bitan.y);
-                            vertData.push_back(bitan.z);
-                        }
-                            offset += 4;
+                            meshData.attributes[i] = 3;
+                            meshData.attributes[Mesh::Attribute::Bitangent] = 3;
+                            vertStride += 4; //we'll be decoding tangents
                             break;
                         case Mesh::Attribute::UV0:
                         case Mesh::Attribute::UV1:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-
-                            offset += 2;
+                            vertStride += 2;
+                            meshData.attributes[i] = 2;
                             break;
                         case Mesh::Attribute::BlendIndices:
                         case Mesh::Attribute::BlendWeights:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-                            vertData.push_back(tempVerts[i + offset + 3]);
-
-                            offset += 4;
+                            vertStride += 4;
+                            meshData.attributes[i] = 4;
                             break;
                         }
                     }
                 }
+
+                auto pos = SDL_RWtell(file.file);
+                auto vertSize = meshHeader.indexArrayOffset - pos;
+                tempVerts.resize(vertSize / sizeof(float));
+                SDL_RWread(file.file, tempVerts.data(), vertSize, 1);
+                CRO_ASSERT(tempVerts.size() % vertStride == 0, "");
+            
+                //index arrays are contiguous so read them in one go
+                std::size_t indexCount = 0;
+                for (auto size : sizes)
+                {
+                    indexCount += size;
+                }
+                indexData.resize(indexCount * sizeof(std::uint32_t));
+                if (!indexData.empty())
+                {
+                    SDL_RWread(file.file, indexData.data(), indexData.size(), 1);
+                }
+
+                //process vertex data
+                vertData.reserve((tempVerts.size() / vertStride) * (vertStride + (meshData.attributes[Mesh::Attribute::Tangent] ? 2 : 0)));
+                for (auto i = 0u; i < tempVerts.size(); i += vertStride)
+                {
+                    std::uint32_t offset = 0;
+                    glm::vec3 normal = glm::vec3(0.f);
+                    for (auto j = 0u; j < Mesh::Attribute::Total; ++j)
+                    {
+                        if (meshHeader.flags & (1 << j))
+                        {
+                            switch (j)
+                            {
+                            default:
+                            case Mesh::Attribute::Bitangent:
+                                break;
+                            case Mesh::Attribute::Position:
+                                vertData.push_back(tempVerts[i + offset]);
+                                vertData.push_back(tempVerts[i + offset + 1]);
+                                vertData.push_back(tempVerts[i + offset + 2]);
+
+                                offset += 3;
+                                break;
+                            case Mesh::Attribute::Colour:
+                                vertData.push_back(tempVerts[i + offset]);
+                                vertData.push_back(tempVerts[i + offset + 1]);
+                                vertData.push_back(tempVerts[i + offset + 2]);
+                                vertData.push_back(tempVerts[i + offset + 3]);
+
+                                offset += 4;
+                                break;
+                            case Mesh::Attribute::Normal:
+                                vertData.push_back(tempVerts[i + offset]);
+                                vertData.push_back(tempVerts[i + offset + 1]);
+                                vertData.push_back(tempVerts[i + offset + 2]);
+
+                                normal =
+                                {
+                                    tempVerts[i + offset],
+                                    tempVerts[i + offset + 1],
+                                    tempVerts[i + offset + 2],
+                                };
+
+                                offset += 3;
+                                break;
+                            case Mesh::Attribute::Tangent:
+                            {
+                                glm::vec3 tan =
+                                {
+                                    (tempVerts[i + offset]),
+                                    (tempVerts[i + offset + 1]),
+                                    (tempVerts[i + offset + 2])
+                                };
+
+                                auto sign = (tempVerts[i + offset + 3]);
+                                CRO_ASSERT(glm::length2(normal) != 0, "");
+
+                                auto bitan = glm::cross(normal, tan) * sign;
+
+                                vertData.push_back(tan.x);
+                                vertData.push_back(tan.y);
+                                vertData.push_back(tan.z);
+                            
+                                vertData.push_back(bitan.x);
+                                vertData.push_back(bitan.y);
+                                vertData.push_back(bitan.z);
+                            }
+                                offset += 4;
+                                break;
+                            case Mesh::Attribute::UV0:
+                            case Mesh::Attribute::UV1:
+                                vertData.push_back(tempVerts[i + offset]);
+                                vertData.push_back(tempVerts[i + offset + 1]);
+
+                                offset += 2;
+                                break;
+                            case Mesh::Attribute::BlendIndices:
+                            case Mesh::Attribute::BlendWeights:
+                                vertData.push_back(tempVerts[i + offset]);
+                                vertData.push_back(tempVerts[i + offset + 1]);
+                                vertData.push_back(tempVerts[i + offset + 2]);
+                                vertData.push_back(tempVerts[i + offset + 3]);
+
+                                offset += 4;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                meshData.attributeFlags = meshHeader.flags;
+                meshData.submeshCount = meshHeader.indexArrayCount;
+                for (auto i = 0u; i < meshData.submeshCount; ++i)
+                {
+                    meshData.indexData[i].format = GL_UNSIGNED_INT;
+                    meshData.indexData[i].indexCount = sizes[i];
+                }
             }
 
-            meshData.attributeFlags = meshHeader.flags;
             meshData.primitiveType = GL_TRIANGLES;
             meshData.vertexSize = getVertexSize(meshData.attributes);
             meshData.vertexCount = vertData.size() / (meshData.vertexSize / sizeof(float));
-            createVBO(meshData, vertData);
 
-            meshData.submeshCount = meshHeader.indexArrayCount;
             for (auto i = 0u; i < meshData.submeshCount; ++i)
             {
-                meshData.indexData[i].format = GL_UNSIGNED_INT;
                 meshData.indexData[i].primitiveType = meshData.primitiveType;
-                meshData.indexData[i].indexCount = static_cast<std::uint32_t>(indexData[i].size());
-
-                createIBO(meshData, indexData[i].data(), i, sizeof(std::uint32_t));
             }
 
             //boundingbox / sphere
@@ -318,6 +422,11 @@ Mesh::Data BinaryMeshBuilder::build() const
                     meshData.boundingSphere.radius = l;
                 }
             }
+
+            //keep the decoded data until build() is called
+            m_vertexData.swap(vertData);
+            m_indexData.swap(indexData);
+            m_indexOffset = indexOffset;
         }
 
         m_skeleton = {};
@@ -404,7 +513,10 @@ Mesh::Data BinaryMeshBuilder::build() const
     else
     {
         LogE << m_path << ": " << SDL_GetError() << std::endl;
+        return false;
     }
 
-    return meshData;
+    m_meshData = meshData;
+    m_prepared = true;
+    return true;
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ source distribution.
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 
 #include "../detail/stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "../detail/stb_image_write.h"
 #include "../detail/stb_image_resize2.h"
 #include "../detail/SDLImageRead.hpp"
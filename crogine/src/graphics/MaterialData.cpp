@@ -251,6 +251,7 @@ void Data::setShader(const Shader& s)
     optionalUniformCount = 0;
 
     shader = s.getGLHandle();
+    instancedShader = s.getInstancedVariant();
 
     //get the available attribs. This is sorted and culled
     //when added to a model according to the requirements of
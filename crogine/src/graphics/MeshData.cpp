@@ -31,6 +31,7 @@ source distribution.
 
 #include "../detail/GLCheck.hpp"
 
+#include <algorithm>
 #include <type_traits>
 
 /*
@@ -42,6 +43,23 @@ using namespace cro::Mesh;
 
 namespace
 {
+    //reads the currently bound index buffer, converting
+    //from the buffer format to the requested type if necessary
+    template <typename Src, typename T>
+    void readIndices(std::vector<T>& dst)
+    {
+        if constexpr (std::is_same<Src, T>::value)
+        {
+            glCheck(glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, dst.size() * sizeof(T), dst.data()));
+        }
+        else
+        {
+            std::vector<Src> temp(dst.size());
+            glCheck(glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, temp.size() * sizeof(Src), temp.data()));
+            std::transform(temp.begin(), temp.end(), dst.begin(), [](Src i) { return static_cast<T>(i); });
+        }
+    }
+
     template <typename T>
     void read(const Data& meshData, std::vector<float>& destVerts, std::vector<std::vector<T>>& destIndices)
     {
@@ -62,7 +80,20 @@ namespace
         {
             destIndices[i].resize(meshData.indexData[i].indexCount);
             glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshData.indexData[i].ibo));
-            glCheck(glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, meshData.indexData[i].indexCount * sizeof(T), destIndices[i].data()));
+
+            switch (meshData.indexData[i].format)
+            {
+            default:
+            case GL_UNSIGNED_INT:
+                readIndices<std::uint32_t>(destIndices[i]);
+                break;
+            case GL_UNSIGNED_SHORT:
+                readIndices<std::uint16_t>(destIndices[i]);
+                break;
+            case GL_UNSIGNED_BYTE:
+                readIndices<std::uint8_t>(destIndices[i]);
+                break;
+            }
         }
         glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
     }
@@ -43,6 +43,7 @@ namespace
 }
 
 MeshResource::MeshResource()
+    : m_asyncOwner(std::make_shared<MeshResource*>(this))
 {
 
 }
@@ -112,6 +113,43 @@ std::size_t MeshResource::loadMesh(const MeshBuilder& mb, bool forceReload)
     return 0;
 }
 
+AsyncHandle MeshResource::loadMeshAsync(std::size_t ID, std::shared_ptr<const MeshBuilder> mb)
+{
+    CRO_ASSERT(mb, "");
+
+    if (m_meshData.count(ID) != 0)
+    {
+        Logger::log("Mesh with this ID already exists!", Logger::Type::Error);
+        return AsyncHandle::fromResult(false);
+    }
+
+    if (m_asyncHandles.count(ID) != 0)
+    {
+        return m_asyncHandles.at(ID);
+    }
+
+    std::weak_ptr<MeshResource*> owner = m_asyncOwner;
+    auto handle = AsyncLoader::submit(
+        [mb]()
+        {
+            return mb->prepare();
+        },
+        [mb, owner, ID](bool decoded)
+        {
+            auto resource = owner.lock();
+            if (!resource)
+            {
+                return false;
+            }
+
+            (*resource)->m_asyncHandles.erase(ID);
+            return decoded && (*resource)->loadMesh(ID, *mb);
+        });
+
+    m_asyncHandles.insert(std::make_pair(ID, handle));
+    return handle;
+}
+
 const Mesh::Data& MeshResource::getMesh(std::size_t id) const
 {
     CRO_ASSERT(m_meshData.count(id) != 0, "Mesh not found");
@@ -37,6 +37,7 @@ source distribution.
 #include <crogine/graphics/CircleMeshBuilder.hpp>
 #include <crogine/graphics/DynamicMeshBuilder.hpp>
 #include <crogine/graphics/EnvironmentMap.hpp>
+#include <crogine/graphics/ImageArray.hpp>
 
 #include <crogine/core/ConfigFile.hpp>
 #include <crogine/detail/OpenGL.hpp>
@@ -62,6 +63,48 @@ namespace
 #ifdef CRO_DEBUG_
     bool billboardsWarned = false;
 #endif
+
+    //if there's an empty working path this checks to see if we have a model file
+    //in the same dir as the definition without a full path
+    void resolveLocalPath(std::string& filePath, const std::string& definitionPath, const std::string& workingDir)
+    {
+        auto pos = filePath.find_last_of('/');
+        if (pos == std::string::npos)
+        {
+            pos = definitionPath.find_last_of('/');
+            if (pos != std::string::npos)
+            {
+                filePath = definitionPath.substr(0, pos) + "/" + filePath;
+            }
+            else
+            {
+                filePath = workingDir + filePath;
+            }
+        }
+        else
+        {
+            filePath = workingDir + filePath;
+        }
+    }
+
+    const std::array<std::string, 4u> TextureProperties =
+    {
+        "diffuse", "mask", "normal", "lightmap"
+    };
+
+    struct PreloadData final
+    {
+        std::shared_ptr<BinaryMeshBuilder> mesh;
+
+        struct Image final
+        {
+            std::string path;
+            bool createMipmaps = false;
+            bool loaded = false;
+            ImageArray<std::uint8_t> data;
+        };
+        std::vector<Image> images;
+    };
 }
 
 ModelDefinition::ModelDefinition(ResourceCollection& rc, EnvironmentMap* envMap, const std::string& workingDir)
@@ -134,27 +177,9 @@ bool ModelDefinition::loadFromFile(const std::string& inPath, bool instanced, bo
     bool lockRotation = false;
     bool lockScale = false;
 
-    //if there's an empty working path this checks to see if we have a model file
-    //in the same dir as the definition without a full path
     auto updateLocalPath = [&](std::string& filePath) 
     {
-        auto pos = filePath.find_last_of('/');
-        if (pos == std::string::npos)
-        {
-            pos = path.find_last_of('/');
-            if (pos != std::string::npos)
-            {
-                filePath = path.substr(0, path.find_last_of('/')) + "/" + filePath;
-            }
-            else
-            {
-                filePath = m_workingDir + filePath;
-            }
-        }
-        else
-        {
-            filePath = m_workingDir + filePath;
-        }
+        resolveLocalPath(filePath, path, m_workingDir);
     };
 
     if (ext == ".cmf")
@@ -751,6 +776,108 @@ bool ModelDefinition::loadFromFile(const std::string& inPath, bool instanced, bo
     return true;
 }
 
+AsyncHandle ModelDefinition::preloadAsync(const std::string& inPath) const
+{
+    auto path = inPath;
+    std::replace(path.begin(), path.end(), '\\', '/');
+    const bool relative = std::filesystem::path(inPath).is_relative();
+
+    auto data = std::make_shared<PreloadData>();
+    std::weak_ptr<TextureResource*> textureOwner = m_resources.textures.m_asyncOwner;
+    std::weak_ptr<MeshResource*> meshOwner = m_resources.meshes.m_asyncOwner;
+
+    return AsyncLoader::submit(
+        [data, path, relative, workingDir = m_workingDir]()
+        {
+            ConfigFile cfg;
+            if (!cfg.loadFromFile(path, relative)
+                || Util::String::toLower(cfg.getName()) != "model")
+            {
+                Logger::log("Failed preloading ModelDefinition " + path, Logger::Type::Error);
+                return false;
+            }
+
+            //only binary meshes can currently be decoded separately from being built
+            if (auto* meshProp = cfg.findProperty("mesh"); meshProp)
+            {
+                auto meshValue = meshProp->getValue<std::string>();
+                std::replace(meshValue.begin(), meshValue.end(), '\\', '/');
+                if (FileSystem::getFileExtension(meshValue) == ".cmb")
+                {
+                    resolveLocalPath(meshValue, path, workingDir);
+                    data->mesh = std::make_shared<BinaryMeshBuilder>(meshValue);
+
+                    const MeshBuilder& mb = *data->mesh;
+                    if (!mb.prepare())
+                    {
+                        data->mesh.reset();
+                    }
+                }
+            }
+
+            for (const auto& obj : cfg.getObjects())
+            {
+                if (Util::String::toLower(obj.getName()) != "material")
+                {
+                    continue;
+                }
+
+                bool createMipmaps = false;
+                if (auto* prop = obj.findProperty("use_mipmaps"); prop)
+                {
+                    createMipmaps = prop->getValue<bool>();
+                }
+
+                for (const auto& p : obj.getProperties())
+                {
+                    const auto name = Util::String::toLower(p.getName());
+                    if (std::find(TextureProperties.begin(), TextureProperties.end(), name) == TextureProperties.end()
+                        || p.getValue<std::string>().empty())
+                    {
+                        continue;
+                    }
+
+                    auto filePath = p.getValue<std::string>();
+                    resolveLocalPath(filePath, path, workingDir);
+
+                    if (std::find_if(data->images.begin(), data->images.end(),
+                        [&filePath](const PreloadData::Image& img) { return img.path == filePath; }) == data->images.end())
+                    {
+                        auto& img = data->images.emplace_back();
+                        img.path = filePath;
+                        img.createMipmaps = createMipmaps;
+                        img.loaded = img.data.loadFromFile(TextureResource::getFullPath(filePath), true);
+                    }
+                }
+            }
+            return true;
+        },
+        [data, textureOwner, meshOwner](bool decoded)
+        {
+            if (!decoded)
+            {
+                return false;
+            }
+
+            if (auto textures = textureOwner.lock(); textures)
+            {
+                for (const auto& img : data->images)
+                {
+                    if (img.loaded)
+                    {
+                        (*textures)->insert(img.path, img.data, img.createMipmaps);
+                    }
+                }
+            }
+
+            if (auto meshes = meshOwner.lock(); meshes && data->mesh)
+            {
+                return (*meshes)->loadMesh(*data->mesh) != 0;
+            }
+            return true;
+        });
+}
+
 bool ModelDefinition::createModel(Entity entity)
 {
     CRO_ASSERT(entity.isValid(), "Invalid Entity");
@@ -28,6 +28,7 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/graphics/Shader.hpp>
+#include <crogine/graphics/ShaderCache.hpp>
 #include <crogine/core/FileSystem.hpp>
 
 #include <crogine/detail/Types.hpp>
@@ -77,40 +78,46 @@ namespace
 
     std::string vendorDef;
     std::string vendorInfo;
-}
 
-Shader::Shader()
-    : m_handle  (0),
-    m_attribMap ({})
-{
-    if (vendorDef.empty())
+    //queried when the first shader is compiled rather than constructed
+    //so that Shaders, and therefore Scenes, can be created without a context
+    void queryVendor()
     {
-        //crude but covers most cases
-        std::string vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
-        vendor += " - ";
-        vendor += reinterpret_cast<const char*>(glGetString(GL_RENDERER));
-        vendorInfo = vendor;
-        
-        vendor = Util::String::toLower(vendor);
-        if (vendor.find("amd") != std::string::npos)
-        {
-            vendorDef = "#define GPU_AMD\n";
-        }
-        else if (vendor.find("nvidia") != std::string::npos)
-        {
-            vendorDef = "#define GPU_NVIDIA\n";
-        }
-        else if (vendor.find("intel") != std::string::npos)
-        {
-            vendorDef = "#define GPU_INTEL\n";
-        }
-        else
+        if (vendorDef.empty())
         {
-            vendorDef = "#define GPU_UNKNOWN\n";
+            //crude but covers most cases
+            std::string vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+            vendor += " - ";
+            vendor += reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+            vendorInfo = vendor;
+        
+            vendor = Util::String::toLower(vendor);
+            if (vendor.find("amd") != std::string::npos)
+            {
+                vendorDef = "#define GPU_AMD\n";
+            }
+            else if (vendor.find("nvidia") != std::string::npos)
+            {
+                vendorDef = "#define GPU_NVIDIA\n";
+            }
+            else if (vendor.find("intel") != std::string::npos)
+            {
+                vendorDef = "#define GPU_INTEL\n";
+            }
+            else
+            {
+                vendorDef = "#define GPU_UNKNOWN\n";
+            }
+            LOG("Shader " + vendorDef, Logger::Type::Info);
         }
-        LOG("Shader " + vendorDef, Logger::Type::Info);
     }
+}
 
+Shader::Shader()
+    : m_handle  (0),
+    m_attribMap ({}),
+    m_instancedVariant(nullptr)
+{
     resetAttribMap();
 }
 
@@ -119,10 +126,12 @@ Shader::Shader(Shader&& other) noexcept
     m_handle = other.m_handle;
     m_attribMap = other.m_attribMap;
     m_uniformMap = other.m_uniformMap;
+    m_instancedVariant = other.m_instancedVariant;
 
     other.m_handle = 0;
     other.m_attribMap = {};
     other.m_uniformMap.clear();
+    other.m_instancedVariant = nullptr;
 }
 
 Shader& Shader::operator=(Shader&& other) noexcept
@@ -137,10 +146,12 @@ Shader& Shader::operator=(Shader&& other) noexcept
         m_handle = other.m_handle;
         m_attribMap = other.m_attribMap;
         m_uniformMap = other.m_uniformMap;
+        m_instancedVariant = other.m_instancedVariant;
 
         other.m_handle = 0;
         other.m_attribMap = {};
         other.m_uniformMap.clear();
+        other.m_instancedVariant = nullptr;
     }
 
     return *this;
@@ -251,8 +262,7 @@ bool Shader::loadFromSource(const char* vertex, const char* geometry, const char
         resetUniformMap();
     }
 
-    //compile vert shader
-    GLuint vertID = glCreateShader(GL_VERTEX_SHADER);
+    queryVendor();
 
 #ifdef __ANDROID__
     std::string version = "#version 100\n#define MOBILE\n" + vendorDef;
@@ -262,6 +272,34 @@ bool Shader::loadFromSource(const char* vertex, const char* geometry, const char
     const char* src[] = { version.c_str(), precision.c_str(), defines, vertex};
 #endif //__ANDROID__
 
+    //try loading a previously linked binary before compiling anything
+    const bool useCache = ShaderCache::isAvailable();
+    std::uint64_t cacheKey = 0;
+    if (useCache)
+    {
+        const char* keySrc[] = { version.c_str(), precision.c_str(), defines, vertex, geometry, fragment };
+        cacheKey = ShaderCache::createKey(keySrc, 6);
+
+        m_handle = glCreateProgram();
+        if (m_handle)
+        {
+            if (ShaderCache::load(cacheKey, m_handle)
+                && fillAttribMap())
+            {
+                fillUniformMap();
+                return true;
+            }
+
+            //fall back to compiling from source
+            glCheck(glDeleteProgram(m_handle));
+            m_handle = 0;
+            resetAttribMap();
+        }
+    }
+
+    //compile vert shader
+    GLuint vertID = glCreateShader(GL_VERTEX_SHADER);
+
     glCheck(glShaderSource(vertID, 4, src, nullptr));
     glCheck(glCompileShader(vertID));
 
@@ -353,6 +391,12 @@ bool Shader::loadFromSource(const char* vertex, const char* geometry, const char
             glCheck(glAttachShader(m_handle, geomID));
         }
         glCheck(glAttachShader(m_handle, fragID));
+#ifdef PLATFORM_DESKTOP
+        if (useCache)
+        {
+            glCheck(glProgramParameteri(m_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
+#endif
         glCheck(glLinkProgram(m_handle));
 
         result = GL_FALSE;
@@ -411,6 +455,11 @@ bool Shader::loadFromSource(const char* vertex, const char* geometry, const char
 
             fillUniformMap();
 
+            if (useCache)
+            {
+                ShaderCache::store(cacheKey, m_handle);
+            }
+
             return true;
         }
     }
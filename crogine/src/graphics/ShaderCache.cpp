@@ -0,0 +1,403 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/graphics/ShaderCache.hpp>
+#include <crogine/core/App.hpp>
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include "../detail/GLCheck.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace cro;
+
+namespace
+{
+    constexpr std::uint32_t CacheMagic = 0x42535243; //'CRSB'
+    //bump this if the file layout changes
+    constexpr std::uint32_t CacheVersion = 1;
+    const std::string CacheExtension(".bin");
+    const std::string DriverFile("driver");
+
+    constexpr std::uint64_t FNVOffset = 0xcbf29ce484222325ull;
+    constexpr std::uint64_t FNVPrime = 0x100000001b3ull;
+
+    struct CacheHeader final
+    {
+        std::uint32_t magic = CacheMagic;
+        std::uint32_t version = CacheVersion;
+        std::uint64_t key = 0;
+        std::uint64_t checksum = 0;
+        std::uint32_t format = 0;
+        std::uint32_t size = 0;
+    };
+    static_assert(sizeof(CacheHeader) == 32, "unexpected padding in CacheHeader");
+
+    //written alongside the binaries to record which driver created them
+    struct DriverHeader final
+    {
+        std::uint32_t magic = CacheMagic;
+        std::uint32_t version = CacheVersion;
+        std::uint64_t driverHash = 0;
+    };
+    static_assert(sizeof(DriverHeader) == 16, "unexpected padding in DriverHeader");
+
+    bool enabled = true;
+    bool driverQueried = false;
+    bool driverChecked = false;
+    std::vector<GLint> binaryFormats;
+    std::uint64_t driverHash = FNVOffset;
+
+    std::size_t hitCount = 0;
+    std::size_t missCount = 0;
+
+    std::uint64_t hash(const void* data, std::size_t size, std::uint64_t h)
+    {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        for (auto i = 0u; i < size; ++i)
+        {
+            h ^= bytes[i];
+            h *= FNVPrime;
+        }
+        return h;
+    }
+
+    void queryDriver()
+    {
+        if (driverQueried)
+        {
+            return;
+        }
+        driverQueried = true;
+
+#ifdef PLATFORM_DESKTOP
+        GLint formatCount = 0;
+        glCheck(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+        if (formatCount > 0)
+        {
+            binaryFormats.resize(formatCount);
+            glCheck(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, binaryFormats.data()));
+        }
+
+        //binaries are only valid for the driver which created them, so
+        //make sure any change in the driver also changes every key
+        const std::array<GLenum, 4u> strings = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+        for (auto s : strings)
+        {
+            const auto* str = reinterpret_cast<const char*>(glGetString(s));
+            if (str)
+            {
+                driverHash = hash(str, std::strlen(str) + 1, driverHash);
+            }
+        }
+#endif
+    }
+
+#ifdef PLATFORM_DESKTOP
+    //binaries from a previous driver, or cache version, are never
+    //loaded as their keys differ, so remove them rather than letting
+    //them accumulate each time the driver is updated.
+    void checkDriver()
+    {
+        if (driverChecked)
+        {
+            return;
+        }
+        driverChecked = true;
+
+        const auto dir = ShaderCache::getPath();
+        const auto path = dir + DriverFile;
+
+        DriverHeader stored;
+        stored.magic = 0;
+        {
+            RaiiRWops file;
+            file.file = SDL_RWFromFile(path.c_str(), "rb");
+            if (file.file
+                && SDL_RWread(file.file, &stored, sizeof(stored), 1) != 1)
+            {
+                stored.magic = 0;
+            }
+        }
+
+        DriverHeader current;
+        current.driverHash = driverHash;
+        if (stored.magic == current.magic
+            && stored.version == current.version
+            && stored.driverHash == current.driverHash)
+        {
+            return;
+        }
+
+        if (FileSystem::directoryExists(dir))
+        {
+            LogI << "Graphics driver changed since shader cache was created" << std::endl;
+            ShaderCache::clear();
+        }
+        else if (!FileSystem::createDirectory(dir))
+        {
+            //store() will report this
+            return;
+        }
+
+        RaiiRWops file;
+        file.file = SDL_RWFromFile(path.c_str(), "wb");
+        if (!file.file
+            || SDL_RWwrite(file.file, &current, sizeof(current), 1) != 1)
+        {
+            LogW << "Unable to write shader cache file " << path << std::endl;
+        }
+    }
+#endif
+
+    std::string getFilePath(std::uint64_t key)
+    {
+        static constexpr char Hex[] = "0123456789abcdef";
+        std::string name(16, '0');
+        for (auto i = 0; i < 16; ++i)
+        {
+            name[15 - i] = Hex[(key >> (i * 4)) & 0xf];
+        }
+        return ShaderCache::getPath() + name + CacheExtension;
+    }
+}
+
+void ShaderCache::setEnabled(bool e)
+{
+    enabled = e;
+}
+
+bool ShaderCache::getEnabled()
+{
+    return enabled;
+}
+
+bool ShaderCache::isAvailable()
+{
+#ifdef PLATFORM_DESKTOP
+    if (!enabled
+        || getPath().empty())
+    {
+        return false;
+    }
+
+    queryDriver();
+    if (binaryFormats.empty())
+    {
+        return false;
+    }
+
+    checkDriver();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShaderCache::clear()
+{
+    const auto path = getPath();
+    if (path.empty()
+        || !FileSystem::directoryExists(path))
+    {
+        return;
+    }
+
+    const auto files = FileSystem::listFiles(path);
+    for (const auto& file : files)
+    {
+        if (FileSystem::getFileExtension(file) == CacheExtension)
+        {
+            std::remove((path + file).c_str());
+        }
+    }
+    LOG("Cleared shader cache", Logger::Type::Info);
+}
+
+std::string ShaderCache::getPath()
+{
+    if (!App::isValid())
+    {
+        return {};
+    }
+    return App::getPreferencePath() + "shader_cache/";
+}
+
+std::size_t ShaderCache::getHitCount()
+{
+    return hitCount;
+}
+
+std::size_t ShaderCache::getMissCount()
+{
+    return missCount;
+}
+
+//private
+std::uint64_t ShaderCache::createKey(const char* const* sources, std::size_t count)
+{
+    queryDriver();
+
+    auto key = hash(&CacheVersion, sizeof(CacheVersion), driverHash);
+    for (auto i = 0u; i < count; ++i)
+    {
+        if (sources[i])
+        {
+            //include the terminator so that moving text between
+            //adjacent strings changes the key
+            key = hash(sources[i], std::strlen(sources[i]) + 1, key);
+        }
+        else
+        {
+            static constexpr std::uint8_t Missing = 0xff;
+            key = hash(&Missing, 1, key);
+        }
+    }
+    return key;
+}
+
+bool ShaderCache::load(std::uint64_t key, std::uint32_t program)
+{
+#ifdef PLATFORM_DESKTOP
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(getFilePath(key).c_str(), "rb");
+    if (!file.file)
+    {
+        missCount++;
+        return false;
+    }
+
+    CacheHeader header;
+    if (SDL_RWread(file.file, &header, sizeof(header), 1) != 1
+        || header.magic != CacheMagic
+        || header.version != CacheVersion
+        || header.key != key
+        || header.size == 0
+        || std::find(binaryFormats.begin(), binaryFormats.end(), static_cast<GLint>(header.format)) == binaryFormats.end())
+    {
+        file.close();
+        remove(key);
+        missCount++;
+        return false;
+    }
+
+    std::vector<std::uint8_t> data(header.size);
+    if (SDL_RWread(file.file, data.data(), header.size, 1) != 1
+        || hash(data.data(), data.size(), FNVOffset) != header.checksum)
+    {
+        file.close();
+        remove(key);
+        missCount++;
+        return false;
+    }
+    file.close();
+
+    glCheck(glProgramBinary(program, header.format, data.data(), header.size));
+
+    GLint result = GL_FALSE;
+    glCheck(glGetProgramiv(program, GL_LINK_STATUS, &result));
+    if (result == GL_FALSE)
+    {
+        //usually the driver was updated without changing its version string
+        LogI << "Cached shader binary was rejected by the driver, recompiling..." << std::endl;
+        remove(key);
+        missCount++;
+        return false;
+    }
+
+    hitCount++;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShaderCache::store(std::uint64_t key, std::uint32_t program)
+{
+#ifdef PLATFORM_DESKTOP
+    GLint length = 0;
+    glCheck(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length < 1)
+    {
+        return;
+    }
+
+    std::vector<std::uint8_t> data(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glCheck(glGetProgramBinary(program, length, &written, &format, data.data()));
+    if (written < 1)
+    {
+        return;
+    }
+    data.resize(written);
+
+    const auto dir = getPath();
+    if (!FileSystem::directoryExists(dir)
+        && !FileSystem::createDirectory(dir))
+    {
+        LogW << "Unable to create shader cache directory " << dir << std::endl;
+        return;
+    }
+
+    CacheHeader header;
+    header.key = key;
+    header.checksum = hash(data.data(), data.size(), FNVOffset);
+    header.format = format;
+    header.size = static_cast<std::uint32_t>(data.size());
+
+    const auto path = getFilePath(key);
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(path.c_str(), "wb");
+    if (!file.file)
+    {
+        LogW << "Unable to write shader cache file " << path << std::endl;
+        return;
+    }
+
+    if (SDL_RWwrite(file.file, &header, sizeof(header), 1) != 1
+        || SDL_RWwrite(file.file, data.data(), data.size(), 1) != 1)
+    {
+        //a partial file would fail the checksum but we may as well not leave it lying around
+        file.close();
+        std::remove(path.c_str());
+        LogW << "Failed writing shader cache file " << path << std::endl;
+    }
+#endif
+}
+
+void ShaderCache::remove(std::uint64_t key)
+{
+    std::remove(getFilePath(key).c_str());
+}
@@ -303,6 +303,18 @@ std::int32_t ShaderResource::loadBuiltIn(BuiltIn type, std::int32_t flags)
 
     if (success)
     {
+#ifdef PLATFORM_DESKTOP
+        //the model renderer uses this to batch models
+        //drawn with the shader into instanced draws
+        if ((flags & (BuiltInFlags::Instanced | BuiltInFlags::Skinning)) == 0
+            && (type == BuiltIn::Unlit || type == BuiltIn::VertexLit || type == BuiltIn::PBR))
+        {
+            if (auto variantID = loadBuiltIn(type, flags | BuiltInFlags::Instanced); variantID != -1)
+            {
+                m_shaders.at(id).setInstancedVariant(&m_shaders.at(variantID));
+            }
+        }
+#endif
         return id;
     }
     return -1;
@@ -332,6 +344,76 @@ void ShaderResource::addInclude(const std::string& include, const char* src)
     m_includes.insert(std::make_pair(include, src));
 }
 
+void ShaderResource::addPermutations(const std::vector<Permutation>& permutations)
+{
+    m_pendingPermutations.insert(m_pendingPermutations.end(), permutations.begin(), permutations.end());
+}
+
+std::size_t ShaderResource::precompile(std::size_t maxCount)
+{
+    std::size_t compiled = 0;
+    while (!m_pendingPermutations.empty()
+        && (maxCount == 0 || compiled < maxCount))
+    {
+        const auto& p = m_pendingPermutations.front();
+        if (p.builtIn)
+        {
+            if (!hasShader(p.type | p.flags))
+            {
+                loadBuiltIn(p.type, p.flags);
+                compiled++;
+            }
+        }
+        else if (!hasShader(p.id))
+        {
+            if (p.geometry.empty())
+            {
+                loadFromString(p.id, p.vertex, p.fragment, p.defines);
+            }
+            else
+            {
+                loadFromString(p.id, p.vertex, p.geometry, p.fragment, p.defines);
+            }
+            compiled++;
+        }
+        m_pendingPermutations.pop_front();
+    }
+
+    return m_pendingPermutations.size();
+}
+
+std::size_t ShaderResource::getPendingPermutationCount() const
+{
+    return m_pendingPermutations.size();
+}
+
+ShaderResource::Permutation::Permutation(BuiltIn t, std::int32_t f)
+    : builtIn   (true),
+    type        (t),
+    flags       (f)
+{
+
+}
+
+ShaderResource::Permutation::Permutation(std::int32_t i, const std::string& v, const std::string& f, const std::string& d)
+    : id    (i),
+    vertex  (v),
+    fragment(f),
+    defines (d)
+{
+
+}
+
+ShaderResource::Permutation::Permutation(std::int32_t i, const std::string& v, const std::string& g, const std::string& f, const std::string& d)
+    : id    (i),
+    vertex  (v),
+    geometry(g),
+    fragment(f),
+    defines (d)
+{
+
+}
+
 //private
 std::string ShaderResource::parseIncludes(const std::string& src) const
 {
@@ -35,6 +35,17 @@ source distribution.
 #include <crogine/detail/glm/geometric.hpp>
 #include <crogine/detail/glm/gtx/norm.hpp>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SPATIAL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPATIAL_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SPATIAL_NEON
+#endif
+
 using namespace cro;
 
 Sphere::Sphere()
@@ -89,6 +100,70 @@ bool Sphere::contains(glm::vec3 point) const
     return pointLen < (radius * radius);
 }
 
+void SphereBatch::clear()
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+void SphereBatch::reserve(std::size_t count)
+{
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+    radius.reserve(count);
+}
+
+void SphereBatch::push_back(const Sphere& sphere)
+{
+    x.push_back(sphere.centre.x);
+    y.push_back(sphere.centre.y);
+    z.push_back(sphere.centre.z);
+    radius.push_back(sphere.radius);
+}
+
+Sphere SphereBatch::operator[](std::size_t idx) const
+{
+    return Sphere(radius[idx], glm::vec3(x[idx], y[idx], z[idx]));
+}
+
+void BoxBatch::clear()
+{
+    minX.clear();
+    minY.clear();
+    minZ.clear();
+    maxX.clear();
+    maxY.clear();
+    maxZ.clear();
+}
+
+void BoxBatch::reserve(std::size_t count)
+{
+    minX.reserve(count);
+    minY.reserve(count);
+    minZ.reserve(count);
+    maxX.reserve(count);
+    maxY.reserve(count);
+    maxZ.reserve(count);
+}
+
+void BoxBatch::push_back(const Box& box)
+{
+    minX.push_back(box[0].x);
+    minY.push_back(box[0].y);
+    minZ.push_back(box[0].z);
+    maxX.push_back(box[1].x);
+    maxY.push_back(box[1].y);
+    maxZ.push_back(box[1].z);
+}
+
+Box BoxBatch::operator[](std::size_t idx) const
+{
+    return Box(glm::vec3(minX[idx], minY[idx], minZ[idx]), glm::vec3(maxX[idx], maxY[idx], maxZ[idx]));
+}
+
 namespace
 {
     //used to calculate the AABB for a frustum.
@@ -142,6 +217,188 @@ Planar Spatial::intersects(Plane plane, Box box)
     return (dist > 0) ? Planar::Front : Planar::Back;
 }
 
+namespace
+{
+    //the vector paths evaluate the same expressions in the same order
+    //as the scalar functions so that the results are identical
+#if defined(SPATIAL_AVX)
+    constexpr std::size_t LaneCount = 8;
+    using Lane = __m256;
+
+    inline Lane load(const float* f) { return _mm256_loadu_ps(f); }
+    inline Lane splat(float f) { return _mm256_set1_ps(f); }
+    inline Lane add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+    inline Lane sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+    inline Lane mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+    inline Lane abs(Lane a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    inline Lane lessEqual(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    inline Lane greater(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    inline Lane bitOr(Lane a, Lane b) { return _mm256_or_ps(a, b); }
+    inline Lane bitAnd(Lane a, Lane b) { return _mm256_and_ps(a, b); }
+    inline Lane allSet() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+    inline std::uint64_t toBits(Lane a) { return static_cast<std::uint64_t>(_mm256_movemask_ps(a)); }
+
+#elif defined(SPATIAL_SSE)
+    constexpr std::size_t LaneCount = 4;
+    using Lane = __m128;
+
+    inline Lane load(const float* f) { return _mm_loadu_ps(f); }
+    inline Lane splat(float f) { return _mm_set1_ps(f); }
+    inline Lane add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+    inline Lane sub(Lane a, Lane b) { return _mm_sub_ps(a, b); }
+    inline Lane mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+    inline Lane abs(Lane a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    inline Lane lessEqual(Lane a, Lane b) { return _mm_cmple_ps(a, b); }
+    inline Lane greater(Lane a, Lane b) { return _mm_cmpgt_ps(a, b); }
+    inline Lane bitOr(Lane a, Lane b) { return _mm_or_ps(a, b); }
+    inline Lane bitAnd(Lane a, Lane b) { return _mm_and_ps(a, b); }
+    inline Lane allSet() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+    inline std::uint64_t toBits(Lane a) { return static_cast<std::uint64_t>(_mm_movemask_ps(a)); }
+
+#elif defined(SPATIAL_NEON)
+    constexpr std::size_t LaneCount = 4;
+    using Lane = float32x4_t;
+
+    inline Lane load(const float* f) { return vld1q_f32(f); }
+    inline Lane splat(float f) { return vdupq_n_f32(f); }
+    inline Lane add(Lane a, Lane b) { return vaddq_f32(a, b); }
+    inline Lane sub(Lane a, Lane b) { return vsubq_f32(a, b); }
+    inline Lane mul(Lane a, Lane b) { return vmulq_f32(a, b); }
+    inline Lane abs(Lane a) { return vabsq_f32(a); }
+    inline Lane lessEqual(Lane a, Lane b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+    inline Lane greater(Lane a, Lane b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    inline Lane bitOr(Lane a, Lane b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    inline Lane bitAnd(Lane a, Lane b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+    inline Lane allSet() { return vreinterpretq_f32_u32(vdupq_n_u32(0xffffffff)); }
+    inline std::uint64_t toBits(Lane a)
+    {
+        static const std::uint32_t laneBits[] = { 1, 2, 4, 8 };
+        const auto bits = vandq_u32(vreinterpretq_u32_f32(a), vld1q_u32(laneBits));
+        auto sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        sum = vpadd_u32(sum, sum);
+        return static_cast<std::uint64_t>(vget_lane_u32(sum, 0));
+    }
+#else
+    constexpr std::size_t LaneCount = 0;
+#endif
+
+    //returns the index of the first element not processed by the vector path
+    std::size_t testSpheres(const Frustum& frustum, const SphereBatch& spheres, VisibilityMask& output)
+    {
+#if defined(SPATIAL_AVX) || defined(SPATIAL_SSE) || defined(SPATIAL_NEON)
+        const auto count = spheres.size() - (spheres.size() % LaneCount);
+        const auto zero = splat(0.f);
+
+        for (auto i = 0u; i < count; i += LaneCount)
+        {
+            const auto x = load(&spheres.x[i]);
+            const auto y = load(&spheres.y[i]);
+            const auto z = load(&spheres.z[i]);
+            const auto r = load(&spheres.radius[i]);
+
+            auto visible = allSet();
+            for (const auto& plane : frustum)
+            {
+                const auto dist = add(add(add(mul(splat(plane.x), x), mul(splat(plane.y), y)), mul(splat(plane.z), z)), splat(plane.w));
+                visible = bitAnd(visible, bitOr(lessEqual(abs(dist), r), greater(dist, zero)));
+            }
+
+            //lane count is a factor of 64 so never spans two words
+            output[i / 64] |= toBits(visible) << (i % 64);
+        }
+        return count;
+#else
+        return 0;
+#endif
+    }
+
+    std::size_t testBoxes(const Frustum& frustum, const BoxBatch& boxes, VisibilityMask& output)
+    {
+#if defined(SPATIAL_AVX) || defined(SPATIAL_SSE) || defined(SPATIAL_NEON)
+        const auto count = boxes.size() - (boxes.size() % LaneCount);
+        const auto zero = splat(0.f);
+        const auto half = splat(0.5f);
+
+        for (auto i = 0u; i < count; i += LaneCount)
+        {
+            const auto minX = load(&boxes.minX[i]);
+            const auto minY = load(&boxes.minY[i]);
+            const auto minZ = load(&boxes.minZ[i]);
+
+            const auto extentX = mul(sub(load(&boxes.maxX[i]), minX), half);
+            const auto extentY = mul(sub(load(&boxes.maxY[i]), minY), half);
+            const auto extentZ = mul(sub(load(&boxes.maxZ[i]), minZ), half);
+
+            const auto centreX = add(minX, extentX);
+            const auto centreY = add(minY, extentY);
+            const auto centreZ = add(minZ, extentZ);
+
+            auto visible = allSet();
+            for (const auto& plane : frustum)
+            {
+                const auto px = splat(plane.x);
+                const auto py = splat(plane.y);
+                const auto pz = splat(plane.z);
+
+                const auto dist = add(add(add(mul(px, centreX), mul(py, centreY)), mul(pz, centreZ)), splat(plane.w));
+                const auto radius = add(add(abs(mul(extentX, px)), abs(mul(extentY, py))), abs(mul(extentZ, pz)));
+                visible = bitAnd(visible, bitOr(lessEqual(abs(dist), radius), greater(dist, zero)));
+            }
+
+            output[i / 64] |= toBits(visible) << (i % 64);
+        }
+        return count;
+#else
+        return 0;
+#endif
+    }
+}
+
+void Spatial::intersects(const Frustum& frustum, const SphereBatch& spheres, VisibilityMask& output)
+{
+    output.assign((spheres.size() + 63) / 64, 0);
+
+    //any remainder is done with the scalar test
+    for (auto i = testSpheres(frustum, spheres, output); i < spheres.size(); ++i)
+    {
+        const auto sphere = spheres[i];
+
+        bool visible = true;
+        std::size_t j = 0;
+        while (visible && j < frustum.size())
+        {
+            visible = (intersects(frustum[j++], sphere) != Planar::Back);
+        }
+
+        if (visible)
+        {
+            output[i / 64] |= (1ull << (i % 64));
+        }
+    }
+}
+
+void Spatial::intersects(const Frustum& frustum, const BoxBatch& boxes, VisibilityMask& output)
+{
+    output.assign((boxes.size() + 63) / 64, 0);
+
+    for (auto i = testBoxes(frustum, boxes, output); i < boxes.size(); ++i)
+    {
+        const auto box = boxes[i];
+
+        bool visible = true;
+        std::size_t j = 0;
+        while (visible && j < frustum.size())
+        {
+            visible = (intersects(frustum[j++], box) != Planar::Back);
+        }
+
+        if (visible)
+        {
+            output[i / 64] |= (1ull << (i % 64));
+        }
+    }
+}
+
 Box Spatial::updateFrustum(std::array<Plane, 6u>& frustum, glm::mat4 viewProj)
 {
     frustum =
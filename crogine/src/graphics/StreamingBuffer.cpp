@@ -0,0 +1,364 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "../detail/GLCheck.hpp"
+#include <crogine/graphics/StreamingBuffer.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+//persistent mapping requires GL 4.4 which isn't available on mobile or macOS
+#if defined(PLATFORM_DESKTOP) && !defined(GL41)
+#define CRO_PERSISTENT_MAPPING
+#endif
+
+using namespace cro;
+
+namespace
+{
+    //after this many frames we assume the GPU has caught up
+    //and waiting on the oldest fence won't block
+    constexpr std::size_t MaxFramesInFlight = 4;
+
+    constexpr std::size_t alignUp(std::size_t value, std::size_t alignment)
+    {
+        return ((value + alignment - 1) / alignment) * alignment;
+    }
+
+    constexpr bool overlaps(std::size_t startA, std::size_t endA, std::size_t startB, std::size_t endB)
+    {
+        return startA < endB && startB < endA;
+    }
+
+    class GLStreamingBackend final : public Detail::StreamingBackend
+    {
+    public:
+        GLStreamingBackend()
+            : m_persistent(false)
+        {
+#ifdef CRO_PERSISTENT_MAPPING
+            m_persistent = GLAD_GL_VERSION_4_4 != 0;
+#endif
+        }
+
+        bool persistentMapping() const override { return m_persistent; }
+
+        std::uint32_t createBuffer(std::size_t size, std::uint8_t** mappedData) override
+        {
+            std::uint32_t vbo = 0;
+            glCheck(glGenBuffers(1, &vbo));
+            glCheck(glBindBuffer(GL_ARRAY_BUFFER, vbo));
+
+#ifdef CRO_PERSISTENT_MAPPING
+            if (m_persistent)
+            {
+                const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                glCheck(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+                glCheck(*mappedData = static_cast<std::uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags)));
+            }
+            else
+#endif
+            {
+                glCheck(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+            }
+            glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+            return vbo;
+        }
+
+        void deleteBuffer(std::uint32_t buffer) override
+        {
+            //deleting a mapped buffer implicitly unmaps it
+            glCheck(glDeleteBuffers(1, &buffer));
+        }
+
+        void orphanBuffer(std::uint32_t buffer, std::size_t size) override
+        {
+            glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+            glCheck(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+            glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        }
+
+        void uploadData(std::uint32_t buffer, std::size_t offset, const void* data, std::size_t size) override
+        {
+            glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+            glCheck(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+            glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        }
+
+        std::uintptr_t insertFence() override
+        {
+#ifdef CRO_PERSISTENT_MAPPING
+            GLsync sync = nullptr;
+            glCheck(sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+            return reinterpret_cast<std::uintptr_t>(sync);
+#else
+            return 0;
+#endif
+        }
+
+        void waitFence(std::uintptr_t fence) override
+        {
+#ifdef CRO_PERSISTENT_MAPPING
+            auto sync = reinterpret_cast<GLsync>(fence);
+            
+            //1ms timeout, flushing the first time round so the fence is guaranteed to signal
+            GLenum result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            while (result == GL_TIMEOUT_EXPIRED)
+            {
+                result = glClientWaitSync(sync, 0, 1000000);
+            }
+
+            if (result == GL_WAIT_FAILED)
+            {
+                LogE << "Failed waiting on streaming buffer fence" << std::endl;
+            }
+#endif
+        }
+
+        void deleteFence(std::uintptr_t fence) override
+        {
+#ifdef CRO_PERSISTENT_MAPPING
+            glCheck(glDeleteSync(reinterpret_cast<GLsync>(fence)));
+#endif
+        }
+
+    private:
+        bool m_persistent;
+    };
+}
+
+StreamingBuffer::StreamingBuffer(std::size_t size)
+    : StreamingBuffer(std::make_unique<GLStreamingBackend>(), size)
+{
+
+}
+
+StreamingBuffer::StreamingBuffer(std::unique_ptr<Detail::StreamingBackend> backend, std::size_t size)
+    : m_backend     (std::move(backend)),
+    m_persistent    (false),
+    m_size          (size),
+    m_buffer        (0),
+    m_mappedData    (nullptr),
+    m_head          (0),
+    m_frameStart    (0),
+    m_frameWrapped  (false)
+{
+    CRO_ASSERT(m_backend, "");
+    CRO_ASSERT(size, "");
+    m_persistent = m_backend->persistentMapping();
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    for (const auto& region : m_inFlight)
+    {
+        m_backend->deleteFence(region.fence);
+    }
+
+    for (auto buffer : m_retiredBuffers)
+    {
+        m_backend->deleteBuffer(buffer);
+    }
+
+    if (m_buffer)
+    {
+        m_backend->deleteBuffer(m_buffer);
+    }
+}
+
+//public
+void StreamingBuffer::beginFrame()
+{
+    //any draw calls using these have been submitted by now,
+    //and GL won't release the storage until they complete
+    for (auto buffer : m_retiredBuffers)
+    {
+        m_backend->deleteBuffer(buffer);
+    }
+    m_retiredBuffers.clear();
+
+    if (m_buffer == 0)
+    {
+        return;
+    }
+
+    if (m_persistent)
+    {
+        if (m_head != m_frameStart || m_frameWrapped)
+        {
+            auto& region = m_inFlight.emplace_back();
+            region.start = m_frameStart;
+            region.end = m_head;
+            region.wrapped = m_frameWrapped;
+            region.fence = m_backend->insertFence();
+
+            //stops fences accumulating when the buffer is much
+            //larger than the amount of data written per frame
+            while (m_inFlight.size() > MaxFramesInFlight)
+            {
+                m_backend->waitFence(m_inFlight.front().fence);
+                m_backend->deleteFence(m_inFlight.front().fence);
+                m_inFlight.pop_front();
+            }
+        }
+        m_frameStart = m_head;
+    }
+    else
+    {
+        if (m_head != 0)
+        {
+            m_backend->orphanBuffer(m_buffer, m_size);
+        }
+        m_head = 0;
+        m_frameStart = 0;
+    }
+    m_frameWrapped = false;
+}
+
+StreamingBuffer::Allocation StreamingBuffer::write(const void* data, std::size_t size, std::size_t alignment)
+{
+    CRO_ASSERT(data, "");
+    CRO_ASSERT(size, "");
+    CRO_ASSERT(alignment, "");
+
+    if (m_buffer == 0)
+    {
+        create(std::max(m_size, size));
+    }
+
+    //the data written so far this frame must remain intact, so
+    //we may only wrap around if there's space before the start
+    //of this frame, else the buffer is grown.
+    auto offset = alignUp(m_head, alignment);
+    if (!m_frameWrapped)
+    {
+        if (offset + size > m_size)
+        {
+            if (size <= m_frameStart)
+            {
+                offset = 0;
+                m_frameWrapped = true;
+            }
+            else
+            {
+                grow(size);
+                offset = 0;
+            }
+        }
+    }
+    else if (offset + size > m_frameStart)
+    {
+        grow(size);
+        offset = 0;
+    }
+
+    if (m_persistent)
+    {
+        waitForRegion(offset, offset + size);
+        std::memcpy(m_mappedData + offset, data, size);
+    }
+    else
+    {
+        m_backend->uploadData(m_buffer, offset, data, size);
+    }
+    m_head = offset + size;
+
+    Allocation retVal;
+    retVal.buffer = m_buffer;
+    retVal.offset = offset;
+    return retVal;
+}
+
+//private
+void StreamingBuffer::create(std::size_t size)
+{
+    m_size = size;
+    m_mappedData = nullptr;
+    m_buffer = m_backend->createBuffer(size, &m_mappedData);
+    CRO_ASSERT(!m_persistent || m_mappedData, "Failed mapping streaming buffer");
+
+    m_head = 0;
+    m_frameStart = 0;
+    m_frameWrapped = false;
+}
+
+void StreamingBuffer::grow(std::size_t minSize)
+{
+    auto newSize = m_size * 2;
+    while (newSize < minSize)
+    {
+        newSize *= 2;
+    }
+
+    //the old buffer is still referenced by allocations
+    //made this frame so defer deleting it
+    m_retiredBuffers.push_back(m_buffer);
+
+    for (const auto& region : m_inFlight)
+    {
+        m_backend->deleteFence(region.fence);
+    }
+    m_inFlight.clear();
+
+    create(newSize);
+}
+
+void StreamingBuffer::waitForRegion(std::size_t start, std::size_t end)
+{
+    //fences signal in order, so find the newest region which
+    //overlaps, and once it's complete all older regions are too.
+    auto last = m_inFlight.rend();
+    for (auto it = m_inFlight.rbegin(); it != m_inFlight.rend(); ++it)
+    {
+        bool overlap = it->wrapped ?
+            overlaps(it->start, m_size, start, end) || overlaps(0, it->end, start, end)
+            : overlaps(it->start, it->end, start, end);
+
+        if (overlap)
+        {
+            last = it;
+            break;
+        }
+    }
+
+    if (last != m_inFlight.rend())
+    {
+        m_backend->waitFence(last->fence);
+
+        auto count = std::distance(last, m_inFlight.rend());
+        for (auto i = 0; i < count; ++i)
+        {
+            m_backend->deleteFence(m_inFlight.front().fence);
+            m_inFlight.pop_front();
+        }
+    }
+}
@@ -200,17 +200,28 @@ bool Texture::loadFromFile(const std::string& filePath, bool createMipMaps)
     ImageArray<std::uint8_t> arr;
     if (arr.loadFromFile(path, true))
     {
-        m_type = GL_UNSIGNED_BYTE;
-
-        auto size = arr.getDimensions();
-        CRO_ASSERT(size.x * size.y * arr.getChannels() == arr.size(), "");
-        create(size.x, size.y, arr.getFormat());
-        return update(arr.data(), createMipMaps);
+        return loadFromImage(arr, createMipMaps);
     }
 
     return false;
 }
 
+bool Texture::loadFromImage(const ImageArray<std::uint8_t>& arr, bool createMipMaps)
+{
+    if (arr.empty())
+    {
+        LogE << "Failed creating texture from image array: array is empty." << std::endl;
+        return false;
+    }
+
+    m_type = GL_UNSIGNED_BYTE;
+
+    auto size = arr.getDimensions();
+    CRO_ASSERT(size.x * size.y * arr.getChannels() == arr.size(), "");
+    create(size.x, size.y, arr.getFormat());
+    return update(arr.data(), createMipMaps);
+}
+
 bool Texture::loadFromImage(const Image& image, bool createMipMaps)
 {
     if (image.getPixelData() == nullptr)
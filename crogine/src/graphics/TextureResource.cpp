@@ -29,6 +29,10 @@ source distribution.
 
 #include <crogine/graphics/TextureResource.hpp>
 #include <crogine/graphics/Image.hpp>
+#include <crogine/graphics/ImageArray.hpp>
+#include <crogine/core/FileSystem.hpp>
+
+#include <filesystem>
 
 using namespace cro;
 
@@ -38,11 +42,41 @@ namespace
 }
 
 TextureResource::TextureResource()
-    : m_fallbackColour(Colour::Magenta)
+    : m_fallbackColour  (Colour::Magenta),
+    m_asyncOwner        (std::make_shared<TextureResource*>(this))
 {
 
 }
 
+TextureResource::TextureResource(TextureResource&& other) noexcept
+    : m_textures        (std::move(other.m_textures)),
+    m_fallbackTextures  (std::move(other.m_fallbackTextures)),
+    m_fallbackColour    (other.m_fallbackColour),
+    m_asyncOwner        (std::move(other.m_asyncOwner)),
+    m_asyncHandles      (std::move(other.m_asyncHandles))
+{
+    *m_asyncOwner = this;
+    other.m_asyncOwner = std::make_shared<TextureResource*>(&other);
+}
+
+TextureResource& TextureResource::operator=(TextureResource&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_textures = std::move(other.m_textures);
+        m_fallbackTextures = std::move(other.m_fallbackTextures);
+        m_fallbackColour = other.m_fallbackColour;
+
+        //any uploads pending on this resource are abandoned
+        m_asyncOwner = std::move(other.m_asyncOwner);
+        m_asyncHandles = std::move(other.m_asyncHandles);
+        *m_asyncOwner = this;
+
+        other.m_asyncOwner = std::make_shared<TextureResource*>(&other);
+    }
+    return *this;
+}
+
 //public
 bool TextureResource::load(std::uint32_t id, const std::string& path, bool createMipMaps)
 {
@@ -68,6 +102,69 @@ bool TextureResource::load(std::uint32_t id, const std::string& path, bool creat
     return false;
 }
 
+AsyncHandle TextureResource::loadAsync(std::uint32_t id, const std::string& path, bool createMipMaps)
+{
+    if (m_textures.count(id) != 0)
+    {
+        const auto& currentPath = m_textures.at(id).first;
+        LogI << "Texture ID " << id << " already assigned to " << currentPath << std::endl;
+        return AsyncHandle::fromResult(path == currentPath);
+    }
+
+    if (m_asyncHandles.count(id) != 0)
+    {
+        const auto& [currentPath, handle] = m_asyncHandles.at(id);
+        if (path == currentPath)
+        {
+            return handle;
+        }
+        LogI << "Texture ID " << id << " already assigned to " << currentPath << std::endl;
+        return AsyncHandle::fromResult(false);
+    }
+
+    auto image = std::make_shared<ImageArray<std::uint8_t>>();
+    std::weak_ptr<TextureResource*> owner = m_asyncOwner;
+
+    auto handle = AsyncLoader::submit(
+        [image, fullPath = getFullPath(path)]()
+        {
+            return image->loadFromFile(fullPath, true);
+        },
+        [image, owner, id, path, createMipMaps](bool decoded)
+        {
+            auto resource = owner.lock();
+            if (!resource)
+            {
+                return false;
+            }
+
+            auto& textures = (*resource)->m_textures;
+            (*resource)->m_asyncHandles.erase(id);
+
+            if (!decoded)
+            {
+                return false;
+            }
+
+            if (textures.count(id) != 0)
+            {
+                //loaded synchronously while we were waiting
+                return textures.at(id).first == path;
+            }
+
+            auto tex = std::make_unique<Texture>();
+            if (!tex->loadFromImage(*image, createMipMaps))
+            {
+                return false;
+            }
+            textures.insert(std::make_pair(id, std::make_pair(path, std::move(tex))));
+            return true;
+        });
+
+    m_asyncHandles.insert(std::make_pair(id, std::make_pair(path, handle)));
+    return handle;
+}
+
 Texture& TextureResource::get(std::uint32_t id)
 {
     if (m_textures.count(id) == 0)
@@ -127,6 +224,41 @@ Colour TextureResource::getFallbackColour() const
 }
 
 //provate
+Texture& TextureResource::insert(const std::string& path, const ImageArray<std::uint8_t>& image, bool createMipMaps)
+{
+    auto result = std::find_if(m_textures.begin(), m_textures.end(),
+        [&path](const auto& pair)
+        {
+            return pair.second.first == path;
+        });
+
+    if (result == m_textures.end())
+    {
+        auto tex = std::make_unique<Texture>();
+        if (!tex->loadFromImage(image, createMipMaps))
+        {
+            return getFallbackTexture();
+        }
+
+        auto id = fallbackID--;
+        m_textures.insert(std::make_pair(id, std::make_pair(path, std::move(tex))));
+        return *m_textures.at(id).second;
+    }
+    return *result->second.second;
+}
+
+std::string TextureResource::getFullPath(const std::string& filePath)
+{
+    //matches the path resolution in Texture::loadFromFile()
+    auto path = FileSystem::getResourcePath();
+    if (!std::filesystem::path(filePath).is_absolute()
+        && filePath.find(path) == std::string::npos)
+    {
+        return path + filePath;
+    }
+    return filePath;
+}
+
 Texture& TextureResource::getFallbackTexture()
 {
     if (m_fallbackTextures.count(m_fallbackColour) == 0)
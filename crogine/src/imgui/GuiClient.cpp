@@ -28,12 +28,35 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/gui/GuiClient.hpp>
+
+#ifndef CRO_HEADLESS
 #include <crogine/core/App.hpp>
+#endif
 
 using namespace cro;
 
+//there's no App to draw the GUI in headless builds so
+//registering windows and tabs does nothing
+#ifdef CRO_HEADLESS
+GuiClient::~GuiClient() {}
+
+void GuiClient::registerConsoleTab(const std::string&, const std::function<void()>&) const {}
+
+void GuiClient::registerWindow(const std::function<void()>&, bool) const {}
+
+void GuiClient::unregisterWindows() const {}
+
+void GuiClient::unregisterConsoleTabs() const {}
+#else
+
 GuiClient::~GuiClient()
 {
+    //clients such as Scenes may outlive, or be used without, an App
+    if (!App::isValid())
+    {
+        return;
+    }
+
     if (m_wantsTabsRemoving)
     {
         App::removeConsoleTab(this);
@@ -73,4 +96,5 @@ void GuiClient::unregisterConsoleTabs() const
 {
     App::removeConsoleTab(this);
     m_wantsTabsRemoving = false;
-}
\ No newline at end of file
+}
+#endif
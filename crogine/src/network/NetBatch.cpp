@@ -0,0 +1,303 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "NetBatch.hpp"
+
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    //keeps unreliable batches inside a single datagram
+    //so one lost fragment doesn't drop the whole batch
+    constexpr std::size_t MaxBatchSize = 1200;
+
+    std::uint32_t getPacketFlags(NetFlag flags)
+    {
+        std::uint32_t packetFlags = 0;
+        if (flags == NetFlag::Reliable)
+        {
+            packetFlags |= ENET_PACKET_FLAG_RELIABLE;
+        }
+        else if (flags == NetFlag::Unreliable)
+        {
+            packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+        }
+        else if (flags == NetFlag::Unsequenced)
+        {
+            packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT | ENET_PACKET_FLAG_UNSEQUENCED;
+        }
+        return packetFlags;
+    }
+
+    std::size_t getSizeLength(std::size_t size)
+    {
+        std::size_t length = 1;
+        while (size > 0x7f)
+        {
+            size >>= 7;
+            length++;
+        }
+        return length;
+    }
+}
+
+ENetPacket* cro::Detail::createNetPacket(std::uint8_t id, const void* data, std::size_t size, NetFlag flags)
+{
+    ENetPacket* packet = enet_packet_create(nullptr, sizeof(std::uint8_t) + size, getPacketFlags(flags));
+    packet->data[0] = id;
+    if (size)
+    {
+        std::memcpy(&packet->data[sizeof(std::uint8_t)], data, size);
+    }
+
+    return packet;
+}
+
+void cro::Detail::releaseNetPacket(ENetPacket* packet)
+{
+    //received packets are no longer referenced by ENet, so
+    //the count is used to share packets split from a batch
+    if (packet->referenceCount > 1)
+    {
+        packet->referenceCount--;
+    }
+    else
+    {
+        enet_packet_destroy(packet);
+    }
+}
+
+void cro::Detail::sendNetPacket(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet)
+{
+    if (enet_peer_send(peer, channel, packet) != 0
+        && packet->referenceCount == 0)
+    {
+        enet_packet_destroy(packet);
+    }
+}
+
+//NetBatch
+bool NetBatch::add(std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel, const SendFunc& sendFunc)
+{
+    CRO_ASSERT(id != NetBatchID, "Packet ID 255 is reserved");
+
+    auto batch = std::find_if(m_batches.begin(), m_batches.end(),
+        [flags, channel](const Batch& b)
+        {
+            return b.flags == flags && b.channel == channel;
+        });
+
+    if (batch == m_batches.end())
+    {
+        batch = m_batches.insert(m_batches.end(), Batch());
+        batch->flags = flags;
+        batch->channel = channel;
+        batch->data.reserve(MaxBatchSize);
+    }
+
+    const auto frameSize = sizeof(id) + getSizeLength(size) + size;
+    if (frameSize + sizeof(NetBatchID) > MaxBatchSize)
+    {
+        //flush what we have so the caller can send this on its own in order
+        send(*batch, sendFunc);
+        return false;
+    }
+
+    if (batch->data.size() + frameSize > MaxBatchSize)
+    {
+        send(*batch, sendFunc);
+    }
+
+    if (batch->data.empty())
+    {
+        batch->data.push_back(NetBatchID);
+    }
+
+    batch->data.push_back(id);
+    auto length = size;
+    while (length > 0x7f)
+    {
+        batch->data.push_back(static_cast<std::uint8_t>((length & 0x7f) | 0x80));
+        length >>= 7;
+    }
+    batch->data.push_back(static_cast<std::uint8_t>(length));
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    batch->data.insert(batch->data.end(), bytes, bytes + size);
+
+    batch->packetCount++;
+    m_queuedCount++;
+    return true;
+}
+
+void NetBatch::flush(const SendFunc& sendFunc)
+{
+    if (m_queuedCount)
+    {
+        for (auto& batch : m_batches)
+        {
+            send(batch, sendFunc);
+        }
+    }
+}
+
+void NetBatch::clear()
+{
+    for (auto& batch : m_batches)
+    {
+        batch.data.clear();
+        batch.packetCount = 0;
+    }
+    m_queuedCount = 0;
+}
+
+//private
+void NetBatch::send(Batch& batch, const SendFunc& sendFunc)
+{
+    if (batch.packetCount == 1)
+    {
+        //no point paying for the batch header, so send it as it was
+        const auto id = batch.data[1];
+        std::size_t offset = 2;
+        while (batch.data[offset] & 0x80)
+        {
+            offset++;
+        }
+        offset++;
+
+        sendFunc(batch.channel, createNetPacket(id, batch.data.data() + offset, batch.data.size() - offset, batch.flags));
+    }
+    else if (batch.packetCount != 0)
+    {
+        sendFunc(batch.channel, enet_packet_create(batch.data.data(), batch.data.size(), getPacketFlags(batch.flags)));
+    }
+
+    m_queuedCount -= batch.packetCount;
+    batch.packetCount = 0;
+    batch.data.clear();
+}
+
+
+//NetDemux
+bool NetDemux::push(ENetPacket* packet, ENetPeer* peer, std::uint8_t channel)
+{
+    if (packet->dataLength == 0
+        || packet->data[0] != NetBatchID)
+    {
+        return false;
+    }
+
+    const auto firstFrame = m_frames.size();
+    std::size_t position = sizeof(NetBatchID);
+    bool valid = true;
+
+    while (position < packet->dataLength)
+    {
+        Frame frame;
+        frame.packet = packet;
+        frame.peer = peer;
+        frame.channel = channel;
+        frame.id = packet->data[position++];
+
+        std::uint32_t shift = 0;
+        std::uint8_t byte = 0x80;
+        while ((byte & 0x80) && valid)
+        {
+            if (position == packet->dataLength
+                || shift > 28)
+            {
+                valid = false;
+                break;
+            }
+
+            byte = packet->data[position++];
+            frame.size |= static_cast<std::size_t>(byte & 0x7f) << shift;
+            shift += 7;
+        }
+
+        if (!valid
+            || frame.size > packet->dataLength - position)
+        {
+            valid = false;
+            break;
+        }
+
+        frame.offset = position;
+        position += frame.size;
+        m_frames.push_back(frame);
+    }
+
+    const auto frameCount = m_frames.size() - firstFrame;
+    if (!valid
+        || frameCount == 0)
+    {
+        LogW << "Dropped malformed packet batch" << std::endl;
+        m_frames.resize(firstFrame);
+        enet_packet_destroy(packet);
+    }
+    else
+    {
+        packet->referenceCount = frameCount;
+    }
+
+    return true;
+}
+
+bool NetDemux::pop(NetEvent& evt)
+{
+    if (m_frames.empty())
+    {
+        return false;
+    }
+
+    const auto& frame = m_frames.front();
+    evt.type = NetEvent::PacketReceived;
+    evt.channel = frame.channel;
+    evt.peer.m_peer = frame.peer;
+    evt.packet.setPacketData(frame.packet, frame.id, frame.offset, frame.size);
+
+    m_frames.pop_front();
+    return true;
+}
+
+void NetDemux::clear()
+{
+    for (const auto& frame : m_frames)
+    {
+        releaseNetPacket(frame.packet);
+    }
+    m_frames.clear();
+}
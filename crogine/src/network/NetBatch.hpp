@@ -0,0 +1,134 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+//enet.h must always be included first on windows
+#include "../detail/enet/enet/enet.h"
+
+#include <crogine/network/NetData.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*
+    When batching is enabled on a NetHost or NetClient outgoing packets
+    are gathered per peer, channel and reliability then sent as a single
+    ENet packet the next time the host is polled. Batched packets start
+    with NetBatchID, followed by each of the original packets:
+        std::uint8_t id
+        packet size, 7 bits per byte, least significant first, with the high bit set if more bytes follow
+        std::uint8_t data[size]
+
+    Receiving hosts always split batches back into individual events,
+    whether or not they have batching enabled themselves.
+    */
+    static constexpr std::uint8_t NetBatchID = 0xff;
+
+    //creates an ENet packet tagged with the given id
+    ENetPacket* createNetPacket(std::uint8_t id, const void* data, std::size_t size, NetFlag flags);
+
+    //destroys a received packet, once it is no longer
+    //referenced by any other events split from the same batch
+    void releaseNetPacket(ENetPacket*);
+
+    //sends the packet, destroying it if it could not be queued
+    void sendNetPacket(ENetPeer*, std::uint8_t channel, ENetPacket*);
+
+    class NetBatch final
+    {
+    public:
+        using SendFunc = std::function<void(std::uint8_t, ENetPacket*)>;
+
+        /*
+        Queues the packet in the batch for the given flags and channel. If
+        the batch becomes full it is passed to send() first. Returns false
+        if the packet is too large to be batched, in which case any queued
+        packets with the same flags and channel are sent so that the caller
+        can send the packet itself without breaking the order of delivery.
+        */
+        bool add(std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel, const SendFunc& send);
+
+        //passes all queued batches to send()
+        void flush(const SendFunc& send);
+
+        //discards all queued packets
+        void clear();
+
+        bool empty() const { return m_queuedCount == 0; }
+
+    private:
+        struct Batch final
+        {
+            NetFlag flags = NetFlag::Reliable;
+            std::uint8_t channel = 0;
+            std::size_t packetCount = 0;
+            std::vector<std::uint8_t> data;
+        };
+        //buffers are kept between flushes to save reallocating them
+        std::vector<Batch> m_batches;
+        std::size_t m_queuedCount = 0;
+
+        void send(Batch&, const SendFunc&);
+    };
+
+    class NetDemux final
+    {
+    public:
+        /*
+        If the packet is a batch the packets it contains are queued and
+        ownership of the packet is taken, returning true. Malformed batches
+        are dropped. Returns false if the packet is not a batch.
+        */
+        bool push(ENetPacket*, ENetPeer*, std::uint8_t channel);
+
+        //pops the next queued packet into the given event,
+        //returning false if the queue is empty
+        bool pop(NetEvent&);
+
+        //releases any queued packets
+        void clear();
+
+    private:
+        struct Frame final
+        {
+            ENetPacket* packet = nullptr;
+            ENetPeer* peer = nullptr;
+            std::size_t offset = 0;
+            std::size_t size = 0;
+            std::uint8_t id = 0;
+            std::uint8_t channel = 0;
+        };
+        std::deque<Frame> m_frames;
+    };
+}
@@ -27,21 +27,34 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
-#include "../detail/enet/enet/enet.h"
-
+#include "NetBatch.hpp"
+#include "NetConditioner.hpp"
 #include "NetConf.hpp"
 
 #include <crogine/network/NetClient.hpp>
 #include <crogine/core/Log.hpp>
 #include <crogine/detail/Assert.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 using namespace cro;
 
+namespace
+{
+    //enet_host_service() only resends when it's called, so the
+    //connection is serviced at this interval rather than for the
+    //whole timeout in case the connection request gets lost
+    constexpr std::uint32_t ConnectServiceTime = 50;
+}
+
 NetClient::NetClient()
-    : m_client      (nullptr),
-    m_threadRunning (false)
+    : m_client          (nullptr),
+    m_batchingEnabled   (false),
+    m_batch             (std::make_unique<Detail::NetBatch>()),
+    m_demux             (std::make_unique<Detail::NetDemux>()),
+    m_conditioner       (std::make_unique<Detail::NetConditioner>("client")),
+    m_threadRunning     (false)
 {
     if (!NetConf::instance)
     {
@@ -56,6 +69,9 @@ NetClient::~NetClient()
         disconnect();
     }
     
+    m_demux->clear();
+    m_conditioner->detach();
+
     if (m_client)
     {
         enet_host_destroy(m_client);
@@ -69,6 +85,7 @@ bool NetClient::create(std::size_t maxChannels, std::size_t maxClients, std::uin
     if (m_client)
     {
         disconnect();
+        m_conditioner->detach();
         enet_host_destroy(m_client);
     }
 
@@ -89,6 +106,7 @@ bool NetClient::create(std::size_t maxChannels, std::size_t maxClients, std::uin
     }
 
     enet_host_compress_with_range_coder(m_client);
+    m_conditioner->attach(m_client);
 
     LOG("Created client host", Logger::Type::Info);
     return true;
@@ -112,6 +130,10 @@ bool NetClient::connect(const std::string& address, std::uint16_t port, std::uin
         return false;
     }
 
+    //the connection is serviced below without updating the conditioner
+    //so make sure it's not holding on to any datagrams
+    m_conditioner->reset();
+
     ENetAddress add;
     if (enet_address_set_host(&add, address.c_str()) != 0)
     {
@@ -129,7 +151,12 @@ bool NetClient::connect(const std::string& address, std::uint16_t port, std::uin
 
     //wait for a success event from server - this part is blocking
     ENetEvent evt;
-    if (enet_host_service(m_client, &evt, timeout) > 0 && evt.type == ENET_EVENT_TYPE_CONNECT)
+    std::int32_t result = 0;
+    const auto start = enet_time_get();
+    while ((result = enet_host_service(m_client, &evt, std::min(ConnectServiceTime, timeout))) == 0
+        && enet_time_get() - start < timeout) {}
+
+    if (result > 0 && evt.type == ENET_EVENT_TYPE_CONNECT)
     {
         //this is a hack to allow for long(er) loading times when the main
         //thread is unable to poll a connection to keep it alive
@@ -156,6 +183,10 @@ void NetClient::disconnect()
     m_thread->join();
     m_thread.reset();*/
 
+    m_batch->clear();
+    m_demux->clear();
+    m_conditioner->reset();
+
     if (m_peer.m_peer)
     {
         ENetEvent evt;
@@ -189,6 +220,15 @@ bool NetClient::pollEvent(NetEvent& evt)
 {
     if (!m_client) return false;
 
+    //return any remaining packets split from a batch first
+    if (m_demux->pop(evt))
+    {
+        return true;
+    }
+
+    flushBatch();
+    m_conditioner->update();
+
     ENetEvent hostEvt;
     if (enet_host_service(m_client, &hostEvt, 0) > 0)
     //if (!m_activeBuffer.empty())
@@ -208,7 +248,19 @@ bool NetClient::pollEvent(NetEvent& evt)
             evt.type = NetEvent::ClientDisconnect;            
             break;
         case ENET_EVENT_TYPE_RECEIVE:
+            if (m_demux->push(hostEvt.packet, hostEvt.peer, hostEvt.channelID))
+            {
+                if (m_demux->pop(evt))
+                {
+                    return true;
+                }
+                //the batch was malformed
+                evt.type = NetEvent::None;
+                break;
+            }
+
             evt.type = NetEvent::PacketReceived;
+            evt.channel = hostEvt.channelID;
             evt.packet.setPacketData(hostEvt.packet);
             //our event takes ownership
             //enet_packet_destroy(hostEvt.packet);
@@ -229,29 +281,58 @@ void NetClient::sendPacket(std::uint8_t id, const void* data, std::size_t size,
 {
     if (m_peer.m_peer)
     {
-        std::int32_t packetFlags = 0;
-        if (flags == NetFlag::Reliable)
+        auto* peer = m_peer.m_peer;
+        const auto send = [peer](std::uint8_t c, ENetPacket* packet)
         {
-            packetFlags |= ENET_PACKET_FLAG_RELIABLE;
-        }
-        else if (flags == NetFlag::Unreliable)
-        {
-            packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
-        }
-        else if (flags == NetFlag::Unsequenced)
+            Detail::sendNetPacket(peer, c, packet);
+        };
+
+        if (!m_batchingEnabled
+            || !m_batch->add(id, data, size, flags, channel, send))
         {
-            packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT | ENET_PACKET_FLAG_UNSEQUENCED;
+            send(channel, Detail::createNetPacket(id, data, size, flags));
         }
-        
-        ENetPacket* packet = enet_packet_create(&id, sizeof(std::uint8_t), packetFlags);
-        enet_packet_resize(packet, sizeof(std::uint8_t) + size);
-        std::memcpy(&packet->data[sizeof(std::uint8_t)], data, size);
+    }
+}
 
-        enet_peer_send(m_peer.m_peer, channel, packet);
+void NetClient::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        flushBatch();
     }
+    m_batchingEnabled = enabled;
+}
+
+void NetClient::setConditions(const NetConditions& conditions)
+{
+    m_conditioner->setConditions(conditions);
+}
+
+NetTrafficStats NetClient::getTrafficStats() const
+{
+    NetTrafficStats stats;
+    if (m_client)
+    {
+        stats.bytesSent = m_client->totalSentData;
+        stats.packetsSent = m_client->totalSentPackets;
+        stats.bytesReceived = m_client->totalReceivedData;
+        stats.packetsReceived = m_client->totalReceivedPackets;
+    }
+    return stats;
 }
 
 //private
+void NetClient::flushBatch()
+{
+    if (m_peer.m_peer
+        && !m_batch->empty())
+    {
+        auto* peer = m_peer.m_peer;
+        m_batch->flush([peer](std::uint8_t channel, ENetPacket* packet) { Detail::sendNetPacket(peer, channel, packet); });
+    }
+}
+
 void NetClient::threadFunc()
 {
     while (m_threadRunning)
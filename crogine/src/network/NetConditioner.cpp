@@ -0,0 +1,569 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "NetConditioner.hpp"
+
+#include <crogine/detail/Assert.hpp>
+
+#ifdef CRO_HEADLESS
+#include <crogine/core/Log.hpp>
+#else
+#include <crogine/core/Console.hpp>
+#include <crogine/core/ConsoleClient.hpp>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    //guards the registry and the conditions of every conditioner, as
+    //these are modified by console commands on the main thread
+    std::mutex registryMutex;
+    std::vector<NetConditioner*> registry;
+
+#if !defined(CRO_HEADLESS) && defined(CRO_DEBUG_)
+    //owns the net_sim console commands, which exist while there is
+    //at least one host or client. These are only available in debug
+    //builds, else players could use them as a lag switch.
+    std::unique_ptr<ConsoleClient> commandClient;
+#endif
+
+    constexpr std::array<enet_uint8, 4u> WakeID = { 'c', 'r', 'o', 'w' };
+
+    //wakes should never be lost over loopback, but if the socket buffer
+    //is full they might be, in which case we send them again after this
+    constexpr std::uint32_t WakeTimeout = 100;
+
+    //extra delay added to datagrams picked to be reordered
+    constexpr std::uint32_t ReorderDelay = 25;
+
+    constexpr std::uint32_t PeerRefreshTime = 1000;
+
+    std::uint32_t timeNow()
+    {
+        return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    //there's no console in headless builds so output is logged instead
+    void print(const std::string& str)
+    {
+#ifdef CRO_HEADLESS
+        LogI << str << std::endl;
+#else
+        Console::print(str);
+#endif
+    }
+
+    std::string addressToString(const ENetAddress& address)
+    {
+        std::array<char, 32u> buffer = {};
+        if (enet_address_get_host_ip(&address, buffer.data(), buffer.size()) != 0)
+        {
+            return "unknown";
+        }
+        return std::string(buffer.data()) + ":" + std::to_string(address.port);
+    }
+
+    std::string conditionsToString(const NetConditions& conditions)
+    {
+        if (!conditions.enabled())
+        {
+            return "off";
+        }
+
+        std::stringstream ss;
+        ss << conditions.latency << "ms +/-" << conditions.jitter << "ms, "
+            << conditions.packetLoss * 100.f << "% loss, "
+            << conditions.reorder * 100.f << "% reorder";
+        return ss.str();
+    }
+}
+
+NetConditioner::NetConditioner(const std::string& type)
+    : m_host        (nullptr),
+    m_active        (false),
+    m_lastPeerRefresh(0),
+    m_wakeAddress   (),
+    m_pendingWakes  (0),
+    m_lastWakeTime  (0),
+    m_random        (std::random_device()()),
+    m_droppedCount  (0),
+    m_delayedCount  (0)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    //use the lowest free index for the name so that
+    //it's predictable when typing console commands
+    for (auto i = 0u; m_name.empty(); ++i)
+    {
+        auto name = type + std::to_string(i);
+        if (std::none_of(registry.begin(), registry.end(), [&name](const NetConditioner* c) { return c->m_name == name; }))
+        {
+            m_name = name;
+        }
+    }
+    registry.push_back(this);
+
+#if !defined(CRO_HEADLESS) && defined(CRO_DEBUG_)
+    if (!commandClient)
+    {
+        commandClient = std::make_unique<ConsoleClient>();
+        commandClient->registerCommand("net_sim",
+            [](const std::string& params)
+            {
+                setConditions(params);
+            });
+
+        commandClient->registerCommand("net_sim_list",
+            [](const std::string&)
+            {
+                listConditioners();
+            });
+
+        commandClient->registerCommand("net_sim_off",
+            [](const std::string&)
+            {
+                clearAll();
+                print("Cleared all network conditions");
+            });
+    }
+#endif
+}
+
+NetConditioner::~NetConditioner()
+{
+    detach();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+
+#if !defined(CRO_HEADLESS) && defined(CRO_DEBUG_)
+    if (registry.empty())
+    {
+        commandClient.reset();
+    }
+#endif
+}
+
+//public
+void NetConditioner::attach(ENetHost* host)
+{
+    CRO_ASSERT(host, "");
+
+    detach();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    m_host = host;
+    m_wakeAddress = {};
+}
+
+void NetConditioner::detach()
+{
+    if (m_host)
+    {
+        reset();
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        m_host = nullptr;
+        m_peers.clear();
+    }
+}
+
+void NetConditioner::reset()
+{
+    if (m_host)
+    {
+        m_host->intercept = nullptr;
+    }
+    m_queue.clear();
+    m_pendingWakes = 0;
+}
+
+void NetConditioner::setConditions(const NetConditions& conditions)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    m_defaultConditions = conditions;
+    updateActive();
+}
+
+void NetConditioner::setConditions(std::size_t peerIndex, const NetConditions& conditions)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    m_peerConditions[peerIndex] = conditions;
+    updateActive();
+}
+
+void NetConditioner::clearConditions(std::size_t peerIndex)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    m_peerConditions.erase(peerIndex);
+    updateActive();
+}
+
+void NetConditioner::update()
+{
+    if (!m_host)
+    {
+        return;
+    }
+
+    const auto now = timeNow();
+    if (now - m_lastPeerRefresh > PeerRefreshTime)
+    {
+        refreshPeers();
+        m_lastPeerRefresh = now;
+    }
+
+    if (!m_active && m_queue.empty())
+    {
+        m_host->intercept = nullptr;
+        return;
+    }
+    m_host->intercept = &NetConditioner::intercept;
+
+    if (m_pendingWakes != 0
+        && now - m_lastWakeTime > WakeTimeout)
+    {
+        m_pendingWakes = 0;
+    }
+
+    //each wake releases one datagram
+    const auto due = static_cast<std::size_t>(std::distance(m_queue.begin(), m_queue.upper_bound(now)));
+    while (m_pendingWakes < due
+        && sendWake())
+    {
+        m_pendingWakes++;
+        m_lastWakeTime = now;
+    }
+}
+
+std::uint32_t NetConditioner::getWaitTime(std::uint32_t timeout) const
+{
+    if (m_queue.empty())
+    {
+        return timeout;
+    }
+
+    const auto now = timeNow();
+    const auto release = m_queue.begin()->first;
+    return release > now ? std::min(timeout, release - now) : 0;
+}
+
+//private
+void NetConditioner::updateActive()
+{
+    m_active = m_defaultConditions.enabled()
+        || std::any_of(m_peerConditions.begin(), m_peerConditions.end(), [](const auto& p) { return p.second.enabled(); });
+}
+
+const NetConditions& NetConditioner::getConditions(const ENetAddress& address) const
+{
+    if (!m_peerConditions.empty())
+    {
+        for (auto i = 0u; i < m_host->peerCount; ++i)
+        {
+            const auto& peer = m_host->peers[i];
+            if (peer.state != ENET_PEER_STATE_DISCONNECTED
+                && peer.address.host == address.host
+                && peer.address.port == address.port)
+            {
+                if (auto result = m_peerConditions.find(i); result != m_peerConditions.end())
+                {
+                    return result->second;
+                }
+                break;
+            }
+        }
+    }
+    return m_defaultConditions;
+}
+
+void NetConditioner::refreshPeers()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    m_peers.clear();
+
+    for (auto i = 0u; i < m_host->peerCount; ++i)
+    {
+        const auto& peer = m_host->peers[i];
+        if (peer.state == ENET_PEER_STATE_CONNECTED)
+        {
+            m_peers.push_back({ i, addressToString(peer.address), peer.roundTripTime });
+        }
+    }
+}
+
+bool NetConditioner::isWake() const
+{
+    return m_wakeAddress.port != 0
+        && m_host->receivedAddress.port == m_wakeAddress.port
+        && m_host->receivedDataLength == WakeID.size()
+        && std::memcmp(m_host->receivedData, WakeID.data(), WakeID.size()) == 0;
+}
+
+bool NetConditioner::sendWake()
+{
+    if (m_wakeAddress.port == 0)
+    {
+        //clients aren't bound to a port until they first send something
+        ENetAddress address;
+        if (enet_socket_get_address(m_host->socket, &address) != 0
+            || address.port == 0)
+        {
+            return false;
+        }
+
+        if (address.host == ENET_HOST_ANY)
+        {
+            enet_address_set_host_ip(&address, "127.0.0.1");
+        }
+        m_wakeAddress = address;
+    }
+
+    ENetBuffer buffer;
+    buffer.data = const_cast<enet_uint8*>(WakeID.data());
+    buffer.dataLength = WakeID.size();
+
+    return enet_socket_send(m_host->socket, &m_wakeAddress, &buffer, 1) > 0;
+}
+
+int NetConditioner::receive()
+{
+    const auto now = timeNow();
+
+    if (isWake())
+    {
+        //wakes aren't real traffic
+        m_host->totalReceivedData -= static_cast<enet_uint32>(m_host->receivedDataLength);
+        m_host->totalReceivedPackets--;
+
+        if (m_pendingWakes != 0)
+        {
+            m_pendingWakes--;
+        }
+
+        if (!m_queue.empty()
+            && m_queue.begin()->first <= now)
+        {
+            auto first = m_queue.begin();
+            m_released = std::move(first->second);
+            m_queue.erase(first);
+
+            m_host->receivedAddress = m_released.address;
+            m_host->receivedData = m_released.data.data();
+            m_host->receivedDataLength = m_released.data.size();
+            return 0;
+        }
+        return 1;
+    }
+
+    const auto& conditions = getConditions(m_host->receivedAddress);
+    if (!conditions.enabled())
+    {
+        return 0;
+    }
+
+    std::uniform_real_distribution<float> chance(0.f, 1.f);
+    if (chance(m_random) < conditions.packetLoss)
+    {
+        m_droppedCount++;
+        return 1;
+    }
+
+    //large jitter may also reorder datagrams
+    std::int64_t delay = conditions.latency;
+    if (conditions.jitter != 0)
+    {
+        const auto jitter = static_cast<std::int32_t>(conditions.jitter);
+        delay += std::uniform_int_distribution<std::int32_t>(-jitter, jitter)(m_random);
+    }
+
+    if (chance(m_random) < conditions.reorder)
+    {
+        delay += ReorderDelay + conditions.jitter;
+    }
+
+    if (delay <= 0)
+    {
+        return 0;
+    }
+
+    Datagram datagram;
+    datagram.address = m_host->receivedAddress;
+    datagram.data.assign(m_host->receivedData, m_host->receivedData + m_host->receivedDataLength);
+    m_queue.emplace(now + static_cast<std::uint32_t>(delay), std::move(datagram));
+    m_delayedCount++;
+
+    return 1;
+}
+
+int ENET_CALLBACK NetConditioner::intercept(ENetHost* host, ENetEvent*)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto* conditioner : registry)
+    {
+        if (conditioner->m_host == host)
+        {
+            return conditioner->receive();
+        }
+    }
+    return 0;
+}
+
+void NetConditioner::listConditioners()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (registry.empty())
+    {
+        print("No active hosts or clients");
+        return;
+    }
+
+    for (const auto* conditioner : registry)
+    {
+        print(conditioner->m_name + ": " + conditionsToString(conditioner->m_defaultConditions)
+            + (conditioner->m_host ? "" : " (not running)")
+            + ", delayed " + std::to_string(conditioner->m_delayedCount)
+            + ", dropped " + std::to_string(conditioner->m_droppedCount));
+
+        for (const auto& peer : conditioner->m_peers)
+        {
+            std::string str = "    " + conditioner->m_name + ":" + std::to_string(peer.index) + " " + peer.address
+                + ", rtt " + std::to_string(peer.roundTripTime) + "ms";
+            if (auto result = conditioner->m_peerConditions.find(peer.index); result != conditioner->m_peerConditions.end())
+            {
+                str += ", " + conditionsToString(result->second);
+            }
+            print(str);
+        }
+    }
+}
+
+void NetConditioner::setConditions(const std::string& params)
+{
+    static const std::string Usage = "Usage: net_sim <name[:peer]|all> <latency ms> [jitter ms] [loss %] [reorder %]. See net_sim_list for names.";
+
+    std::istringstream ss(params);
+    std::string target;
+    NetConditions conditions;
+    float loss = 0.f;
+    float reorder = 0.f;
+
+    ss >> target >> conditions.latency;
+    if (ss.fail())
+    {
+        print(Usage);
+        return;
+    }
+
+    //optional values
+    ss >> conditions.jitter >> loss >> reorder;
+    conditions.packetLoss = std::clamp(loss / 100.f, 0.f, 1.f);
+    conditions.reorder = std::clamp(reorder / 100.f, 0.f, 1.f);
+
+    std::string name = target;
+    std::int32_t peer = -1;
+    if (auto pos = target.find(':'); pos != std::string::npos)
+    {
+        name = target.substr(0, pos);
+        try
+        {
+            peer = std::stoi(target.substr(pos + 1));
+        }
+        catch (...)
+        {
+            peer = -1;
+        }
+
+        if (peer < 0)
+        {
+            print(Usage);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    bool found = false;
+    for (auto* conditioner : registry)
+    {
+        if (target == "all")
+        {
+            conditioner->m_defaultConditions = conditions;
+            conditioner->m_peerConditions.clear();
+        }
+        else if (conditioner->m_name == name)
+        {
+            if (peer < 0)
+            {
+                conditioner->m_defaultConditions = conditions;
+            }
+            else
+            {
+                conditioner->m_peerConditions[peer] = conditions;
+            }
+        }
+        else
+        {
+            continue;
+        }
+
+        conditioner->updateActive();
+        found = true;
+    }
+
+    if (found)
+    {
+        print(target + ": " + conditionsToString(conditions));
+    }
+    else
+    {
+        print(name + ": not found. See net_sim_list.");
+    }
+}
+
+void NetConditioner::clearAll()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto* conditioner : registry)
+    {
+        conditioner->m_defaultConditions = {};
+        conditioner->m_peerConditions.clear();
+        conditioner->updateActive();
+    }
+}
@@ -0,0 +1,156 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+//enet.h must always be included first on windows
+#include "../detail/enet/enet/enet.h"
+
+#include <crogine/network/NetData.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*
+    Applies simulated NetConditions to datagrams received by an ENet host.
+    ENet passes every received datagram to the host's intercept callback,
+    which drops it, lets ENet process it immediately, or copies it to a
+    queue and tells ENet to ignore it.
+
+    Queued datagrams are released by sending a small wake datagram from
+    the host's socket to itself. When the wake is intercepted the oldest
+    due datagram is swapped into the host's receive buffer in its place,
+    so ENet processes it as if it had just arrived from the original
+    sender. This means conditioning needs no changes to ENet itself.
+
+    update() must be called from the thread which services the host,
+    before each call to enet_host_service(). Conditions may be changed
+    from any thread.
+
+    In debug builds, while any conditioners exist, they can be controlled
+    with the console commands net_sim, net_sim_list and net_sim_off. As the
+    console is not thread safe conditioners should be created on the main
+    thread. Release builds only have setConditions().
+    */
+    class NetConditioner final
+    {
+    public:
+        //type is used to name the conditioner in the console, eg host0
+        explicit NetConditioner(const std::string& type);
+        ~NetConditioner();
+
+        NetConditioner(const NetConditioner&) = delete;
+        NetConditioner(NetConditioner&&) = delete;
+        NetConditioner& operator = (const NetConditioner&) = delete;
+        NetConditioner& operator = (NetConditioner&&) = delete;
+
+        //the host must outlive the attachment
+        void attach(ENetHost*);
+
+        //discards queued datagrams and stops intercepting
+        void detach();
+
+        //clears queued datagrams, eg when a client disconnects,
+        //but keeps the current conditions
+        void reset();
+
+        //sets the conditions for all peers without their own
+        void setConditions(const NetConditions&);
+
+        //sets the conditions for datagrams received from
+        //the peer at the given index in the host's peer array
+        void setConditions(std::size_t peerIndex, const NetConditions&);
+
+        //removes conditions set for the given peer, so that it uses the default
+        void clearConditions(std::size_t peerIndex);
+
+        void update();
+
+        //clamps a service timeout so that the host wakes
+        //in time to release the next queued datagram
+        std::uint32_t getWaitTime(std::uint32_t timeout) const;
+
+    private:
+        std::string m_name;
+        ENetHost* m_host;
+
+        //guarded by the registry mutex
+        NetConditions m_defaultConditions;
+        std::map<std::size_t, NetConditions> m_peerConditions;
+        std::atomic<bool> m_active;
+
+        //copied from the host periodically so that
+        //the console can list peers from another thread
+        struct PeerInfo final
+        {
+            std::size_t index = 0;
+            std::string address;
+            std::uint32_t roundTripTime = 0;
+        };
+        std::vector<PeerInfo> m_peers;
+        std::uint32_t m_lastPeerRefresh;
+
+        struct Datagram final
+        {
+            ENetAddress address = {};
+            std::vector<enet_uint8> data;
+        };
+        std::multimap<std::uint32_t, Datagram> m_queue; //sorted by release time
+        Datagram m_released; //ENet processes this in place so it must outlive the intercept
+
+        ENetAddress m_wakeAddress;
+        std::size_t m_pendingWakes;
+        std::uint32_t m_lastWakeTime;
+
+        std::minstd_rand m_random;
+        std::uint32_t m_droppedCount;
+        std::uint32_t m_delayedCount;
+
+        void updateActive();
+        const NetConditions& getConditions(const ENetAddress&) const;
+        void refreshPeers();
+        bool isWake() const;
+        bool sendWake();
+
+        //called from the intercept with the registry mutex locked
+        int receive();
+
+        static int ENET_CALLBACK intercept(ENetHost*, ENetEvent*);
+
+        static void listConditioners();
+        static void setConditions(const std::string&);
+        static void clearAll();
+    };
+}
@@ -27,7 +27,7 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
-#include "../detail/enet/enet/enet.h"
+#include "NetBatch.hpp"
 
 #include <crogine/network/NetData.hpp>
 
@@ -35,7 +35,9 @@ using namespace cro;
 
 NetEvent::Packet::Packet()
     : m_packet(nullptr),
-    m_id(0)
+    m_id    (0),
+    m_offset(0),
+    m_size  (0)
 {
 
 }
@@ -44,31 +46,38 @@ NetEvent::Packet::~Packet()
 {
     if (m_packet)
     {
-        enet_packet_destroy(m_packet);
+        Detail::releaseNetPacket(m_packet);
     }
 }
 
 NetEvent::Packet::Packet(Packet&& other) noexcept
     : m_packet(other.m_packet),
-    m_id(other.m_id)
+    m_id    (other.m_id),
+    m_offset(other.m_offset),
+    m_size  (other.m_size)
 {
     other.m_packet = nullptr;
     other.m_id = 0;
+    other.m_offset = 0;
+    other.m_size = 0;
 }
 
 NetEvent::Packet& NetEvent::Packet::operator=(NetEvent::Packet&& other) noexcept
 {
     if (m_packet)
     {
-        enet_packet_destroy(m_packet);
+        Detail::releaseNetPacket(m_packet);
     }
 
     m_packet = other.m_packet;
     m_id = other.m_id;
-
+    m_offset = other.m_offset;
+    m_size = other.m_size;
 
     other.m_packet = nullptr;
     other.m_id = 0;
+    other.m_offset = 0;
+    other.m_size = 0;
 
     return *this;
 }
@@ -83,13 +92,13 @@ std::uint8_t NetEvent::Packet::getID() const
 const void* NetEvent::Packet::getData() const
 {
     CRO_ASSERT(m_packet, "Not a valid packet instance");
-    return &m_packet->data[sizeof(std::uint8_t)];
+    return &m_packet->data[m_offset];
 }
 
 std::size_t NetEvent::Packet::getSize() const
 {
     CRO_ASSERT(m_packet, "Not a valid packet instance");
-    return m_packet->dataLength - sizeof(std::uint8_t);
+    return m_size;
 }
 
 //private
@@ -97,7 +106,7 @@ void NetEvent::Packet::setPacketData(ENetPacket* packet)
 {
     if (m_packet)
     {
-        enet_packet_destroy(m_packet);
+        Detail::releaseNetPacket(m_packet);
     }
 
     m_packet = packet;
@@ -105,5 +114,20 @@ void NetEvent::Packet::setPacketData(ENetPacket* packet)
     if (m_packet)
     {
         std::memcpy(&m_id, m_packet->data, sizeof(std::uint8_t));
+        m_offset = sizeof(std::uint8_t);
+        m_size = m_packet->dataLength - sizeof(std::uint8_t);
     }
+}
+
+void NetEvent::Packet::setPacketData(ENetPacket* packet, std::uint8_t id, std::size_t offset, std::size_t size)
+{
+    if (m_packet)
+    {
+        Detail::releaseNetPacket(m_packet);
+    }
+
+    m_packet = packet;
+    m_id = id;
+    m_offset = offset;
+    m_size = size;
 }
\ No newline at end of file
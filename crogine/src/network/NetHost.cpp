@@ -29,8 +29,9 @@ source distribution.
 
 //this should always be included first on windows, to ensure it is
 //included before windows.h (in this case by Log.hpp)
-#include "../detail/enet/enet/enet.h"
+#include "NetBatch.hpp"
 
+#include "NetConditioner.hpp"
 #include "NetConf.hpp"
 #include <crogine/network/NetHost.hpp>
 #include <crogine/core/Log.hpp>
@@ -38,34 +39,11 @@ source distribution.
 
 using namespace cro;
 
-namespace
-{
-    ENetPacket* createPacket(std::uint8_t id, const void* data, std::size_t size, NetFlag flags)
-    {
-        std::int32_t packetFlags = 0;
-        if (flags == NetFlag::Reliable)
-        {
-            packetFlags |= ENET_PACKET_FLAG_RELIABLE;
-        }
-        else if (flags == NetFlag::Unreliable)
-        {
-            packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
-        }
-        else if (flags == NetFlag::Unsequenced)
-        {
-            packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT | ENET_PACKET_FLAG_UNSEQUENCED;
-        }
-
-        ENetPacket* packet = enet_packet_create(&id, sizeof(std::uint8_t), packetFlags);
-        enet_packet_resize(packet, sizeof(std::uint8_t) + size);
-        std::memcpy(&packet->data[sizeof(std::uint8_t)], data, size);
-
-        return packet;
-    }
-}
-
 NetHost::NetHost()
-    : m_host    (nullptr)
+    : m_host            (nullptr),
+    m_batchingEnabled   (false),
+    m_demux             (std::make_unique<Detail::NetDemux>()),
+    m_conditioner       (std::make_unique<Detail::NetConditioner>("host"))
 {
     if (!NetConf::instance)
     {
@@ -121,6 +99,11 @@ bool NetHost::start(const std::string& address, std::uint16_t port, std::size_t
 
     enet_host_compress_with_range_coder(m_host);
 
+    m_batches.clear();
+    m_batches.resize(m_host->peerCount);
+
+    m_conditioner->attach(m_host);
+
     LOG("Created server host on port " + std::to_string(port), Logger::Type::Info);
     return true;
 }
@@ -129,6 +112,10 @@ void NetHost::stop()
 {
     if (m_host)
     {
+        //make sure anything queued goes out before the disconnection
+        flushBatches();
+        m_conditioner->detach();
+
         if (m_host->connectedPeers > 0)
         {
             for (auto i = 0u; i < m_host->connectedPeers; ++i)
@@ -164,15 +151,32 @@ void NetHost::stop()
         enet_host_flush(m_host);
         enet_host_destroy(m_host);
         m_host = nullptr;
+
+        m_batches.clear();
+        m_demux->clear();
     }
 }
 
 bool NetHost::pollEvent(NetEvent& evt)
+{
+    return pollEvent(evt, 0);
+}
+
+bool NetHost::pollEvent(NetEvent& evt, std::uint32_t timeout)
 {
     if (!m_host) return false;
 
+    //return any remaining packets split from a batch first
+    if (m_demux->pop(evt))
+    {
+        return true;
+    }
+
+    flushBatches();
+    m_conditioner->update();
+
     ENetEvent hostEvt;
-    if (enet_host_service(m_host, &hostEvt, 0) > 0)
+    if (enet_host_service(m_host, &hostEvt, m_conditioner->getWaitTime(timeout)) > 0)
     {
         switch (hostEvt.type)
         {
@@ -181,12 +185,32 @@ bool NetHost::pollEvent(NetEvent& evt)
             break;
         case ENET_EVENT_TYPE_CONNECT:
             evt.type = NetEvent::ClientConnect;
+            if (m_batchingEnabled)
+            {
+                m_batches[hostEvt.peer - m_host->peers].clear();
+            }
             break;
         case ENET_EVENT_TYPE_DISCONNECT:
             evt.type = NetEvent::ClientDisconnect;
+            if (m_batchingEnabled)
+            {
+                m_batches[hostEvt.peer - m_host->peers].clear();
+            }
             break;
         case ENET_EVENT_TYPE_RECEIVE:
+            if (m_demux->push(hostEvt.packet, hostEvt.peer, hostEvt.channelID))
+            {
+                if (m_demux->pop(evt))
+                {
+                    return true;
+                }
+                //the batch was malformed
+                evt.type = NetEvent::None;
+                break;
+            }
+
             evt.type = NetEvent::PacketReceived;
+            evt.channel = hostEvt.channelID;
             evt.packet.setPacketData(hostEvt.packet);
             //our event takes ownership and promises to clean up the packet
             //enet_packet_destroy(hostEvt.packet);
@@ -202,7 +226,23 @@ void NetHost::broadcastPacket(std::uint8_t id, const void* data, std::size_t siz
 {
     if (m_host)
     {
-        enet_host_broadcast(m_host, channel, createPacket(id, data, size, flags));
+        if (m_batchingEnabled)
+        {
+            //add to each peer's batch so the order relative
+            //to packets sent with sendPacket() is preserved
+            for (auto i = 0u; i < m_host->peerCount; ++i)
+            {
+                auto* peer = &m_host->peers[i];
+                if (peer->state == ENET_PEER_STATE_CONNECTED)
+                {
+                    queuePacket(peer, id, data, size, flags, channel);
+                }
+            }
+        }
+        else
+        {
+            enet_host_broadcast(m_host, channel, Detail::createNetPacket(id, data, size, flags));
+        }
     }
 }
 
@@ -210,7 +250,14 @@ void NetHost::sendPacket(const NetPeer& peer, std::uint8_t id, const void* data,
 {
     if (peer.m_peer)
     {
-        enet_peer_send(peer.m_peer, channel, createPacket(id, data, size, flags));
+        if (m_batchingEnabled)
+        {
+            queuePacket(peer.m_peer, id, data, size, flags, channel);
+        }
+        else
+        {
+            Detail::sendNetPacket(peer.m_peer, channel, Detail::createNetPacket(id, data, size, flags));
+        }
     }
 }
 
@@ -218,6 +265,10 @@ void NetHost::disconnect(NetPeer& peer)
 {
     if (m_host && peer.m_peer)
     {
+        if (m_batchingEnabled)
+        {
+            m_batches[peer.m_peer - m_host->peers].clear();
+        }
         enet_peer_disconnect(peer.m_peer, 0);
         peer.m_peer = nullptr;
     }
@@ -227,7 +278,74 @@ void NetHost::disconnectLater(NetPeer& peer)
 {
     if (m_host && peer.m_peer)
     {
+        //disconnection waits for queued packets, so include any batched ones
+        if (m_batchingEnabled)
+        {
+            auto* p = peer.m_peer;
+            m_batches[p - m_host->peers].flush([p](std::uint8_t channel, ENetPacket* packet) { Detail::sendNetPacket(p, channel, packet); });
+        }
         enet_peer_disconnect_later(peer.m_peer, 0);
         peer.m_peer = nullptr;
     }
+}
+
+void NetHost::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        flushBatches();
+    }
+    m_batchingEnabled = enabled;
+}
+
+void NetHost::setConditions(const NetConditions& conditions)
+{
+    m_conditioner->setConditions(conditions);
+}
+
+void NetHost::setConditions(const NetPeer& peer, const NetConditions& conditions)
+{
+    if (m_host && peer.m_peer)
+    {
+        m_conditioner->setConditions(peer.m_peer - m_host->peers, conditions);
+    }
+}
+
+NetTrafficStats NetHost::getTrafficStats() const
+{
+    NetTrafficStats stats;
+    if (m_host)
+    {
+        stats.bytesSent = m_host->totalSentData;
+        stats.packetsSent = m_host->totalSentPackets;
+        stats.bytesReceived = m_host->totalReceivedData;
+        stats.packetsReceived = m_host->totalReceivedPackets;
+    }
+    return stats;
+}
+
+//private
+void NetHost::queuePacket(ENetPeer* peer, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel) const
+{
+    const auto send = [peer](std::uint8_t c, ENetPacket* packet)
+    {
+        Detail::sendNetPacket(peer, c, packet);
+    };
+
+    if (!m_batches[peer - m_host->peers].add(id, data, size, flags, channel, send))
+    {
+        send(channel, Detail::createNetPacket(id, data, size, flags));
+    }
+}
+
+void NetHost::flushBatches()
+{
+    for (auto i = 0u; i < m_batches.size(); ++i)
+    {
+        if (!m_batches[i].empty())
+        {
+            auto* peer = &m_host->peers[i];
+            m_batches[i].flush([peer](std::uint8_t channel, ENetPacket* packet) { Detail::sendNetPacket(peer, channel, packet); });
+        }
+    }
 }
\ No newline at end of file
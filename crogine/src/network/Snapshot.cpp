@@ -0,0 +1,737 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/network/Snapshot.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace cro;
+
+namespace
+{
+    /*
+    Encoded snapshot layout, packed least significant bit first:
+        32 bits sequence
+        8 bits distance back to the baseline sequence, or 0 if there is no baseline
+        32 bits timestamp
+        entity count + 1 (see writeCount())
+
+    Followed by each entity in ascending ID order:
+        difference from the previous ID (the first is relative to -1)
+        1 bit set if the entity changed, only if the entity exists in the baseline
+
+    Followed by each channel of changed or new entities, compared to the
+    baseline value, or 0 for new entities:
+        1 bit set if the value changed. If it did and the channel is wider than
+        SmallChannelBits, 2 bits select the width of the value which follows:
+        0 - 2: the zigzag encoded difference in a quarter, half or three
+        quarters of the channel width, 3: the new value at full width.
+        Narrow channels always write the new value at full width.
+    */
+    constexpr std::uint32_t MaxHistorySize = 0xff;
+    constexpr std::uint8_t SmallChannelBits = 4;
+    constexpr std::uint8_t QuatIndexBits = 2;
+    constexpr float QuatRange = 0.70710678f; //1/sqrt(2)
+
+    constexpr std::uint32_t bitMask(std::uint32_t bits)
+    {
+        return bits == 32 ? 0xffffffffu : (1u << bits) - 1;
+    }
+
+    std::uint32_t quantise(float value, float min, float max, std::uint8_t bits)
+    {
+        const auto range = static_cast<double>(max) - min;
+        const auto t = range > 0.0 ? std::clamp((static_cast<double>(value) - min) / range, 0.0, 1.0) : 0.0;
+        return static_cast<std::uint32_t>(std::round(t * bitMask(bits)));
+    }
+
+    float dequantise(std::uint32_t value, float min, float max, std::uint8_t bits)
+    {
+        const auto t = static_cast<double>(value) / bitMask(bits);
+        return static_cast<float>(min + (static_cast<double>(max) - min) * t);
+    }
+
+    class BitWriter final
+    {
+    public:
+        explicit BitWriter(std::vector<std::uint8_t>& dst)
+            : m_dst(dst) {}
+
+        void write(std::uint32_t value, std::uint32_t bits)
+        {
+            m_scratch |= static_cast<std::uint64_t>(value & bitMask(bits)) << m_bitCount;
+            m_bitCount += bits;
+
+            while (m_bitCount >= 8)
+            {
+                m_dst.push_back(static_cast<std::uint8_t>(m_scratch));
+                m_scratch >>= 8;
+                m_bitCount -= 8;
+            }
+        }
+
+        //writes values >= 1 as the bit length in unary followed
+        //by the value minus its most significant bit, so that
+        //small values such as sequential entity IDs use few bits
+        void writeCount(std::uint64_t value)
+        {
+            CRO_ASSERT(value != 0, "");
+
+            std::uint32_t length = 0;
+            while ((value >> (length + 1)) != 0)
+            {
+                length++;
+            }
+
+            if (length > 31)
+            {
+                write(0, 31);
+                write(1u << (length - 31), length - 30);
+            }
+            else
+            {
+                write(1u << length, length + 1);
+            }
+
+            const auto remainder = value & ((std::uint64_t(1) << length) - 1);
+            if (length > 32)
+            {
+                write(static_cast<std::uint32_t>(remainder), 32);
+                write(static_cast<std::uint32_t>(remainder >> 32), length - 32);
+            }
+            else
+            {
+                write(static_cast<std::uint32_t>(remainder), length);
+            }
+        }
+
+        void flush()
+        {
+            if (m_bitCount != 0)
+            {
+                m_dst.push_back(static_cast<std::uint8_t>(m_scratch));
+                m_scratch = 0;
+                m_bitCount = 0;
+            }
+        }
+
+    private:
+        std::vector<std::uint8_t>& m_dst;
+        std::uint64_t m_scratch = 0;
+        std::uint32_t m_bitCount = 0;
+    };
+
+    class BitReader final
+    {
+    public:
+        BitReader(const std::uint8_t* data, std::size_t size)
+            : m_data(data), m_size(size) {}
+
+        std::uint32_t read(std::uint32_t bits)
+        {
+            while (m_bitCount < bits)
+            {
+                if (m_position == m_size)
+                {
+                    m_error = true;
+                    return 0;
+                }
+                m_scratch |= static_cast<std::uint64_t>(m_data[m_position++]) << m_bitCount;
+                m_bitCount += 8;
+            }
+
+            const auto value = static_cast<std::uint32_t>(m_scratch & bitMask(bits));
+            m_scratch = bits == 32 ? m_scratch >> 32 : m_scratch >> bits;
+            m_bitCount -= bits;
+            return value;
+        }
+
+        std::uint64_t readCount()
+        {
+            std::uint32_t length = 0;
+            while (read(1) == 0)
+            {
+                if (m_error || ++length > 32)
+                {
+                    m_error = true;
+                    return 0;
+                }
+            }
+
+            std::uint64_t remainder = 0;
+            if (length > 32)
+            {
+                remainder = read(32);
+                remainder |= static_cast<std::uint64_t>(read(length - 32)) << 32;
+            }
+            else
+            {
+                remainder = read(length);
+            }
+            return (std::uint64_t(1) << length) | remainder;
+        }
+
+        bool error() const { return m_error; }
+
+    private:
+        const std::uint8_t* m_data = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_position = 0;
+        std::uint64_t m_scratch = 0;
+        std::uint32_t m_bitCount = 0;
+        bool m_error = false;
+    };
+
+    std::array<std::uint32_t, 3u> deltaWidths(std::uint8_t bits)
+    {
+        return { std::max(1u, bits / 4u), bits / 2u, (bits * 3u) / 4u };
+    }
+
+    void writeChannel(BitWriter& writer, std::uint32_t value, std::uint32_t base, std::uint8_t bits)
+    {
+        if (value == base)
+        {
+            writer.write(0, 1);
+            return;
+        }
+        writer.write(1, 1);
+
+        if (bits > SmallChannelBits)
+        {
+            const auto diff = static_cast<std::int64_t>(value) - static_cast<std::int64_t>(base);
+            const auto zigzag = static_cast<std::uint64_t>(diff < 0 ? (-diff * 2) - 1 : diff * 2);
+
+            const auto widths = deltaWidths(bits);
+            for (auto i = 0u; i < widths.size(); ++i)
+            {
+                if ((zigzag >> widths[i]) == 0)
+                {
+                    writer.write(i, 2);
+                    writer.write(static_cast<std::uint32_t>(zigzag), widths[i]);
+                    return;
+                }
+            }
+            writer.write(3, 2);
+        }
+        writer.write(value, bits);
+    }
+
+    std::uint32_t readChannel(BitReader& reader, std::uint32_t base, std::uint8_t bits)
+    {
+        if (reader.read(1) == 0)
+        {
+            return base;
+        }
+
+        if (bits > SmallChannelBits)
+        {
+            const auto width = reader.read(2);
+            if (width < 3)
+            {
+                const auto zigzag = reader.read(deltaWidths(bits)[width]);
+                const auto diff = (zigzag & 1) ? -static_cast<std::int64_t>(zigzag >> 1) - 1 : static_cast<std::int64_t>(zigzag >> 1);
+                const auto value = static_cast<std::int64_t>(base) + diff;
+                return static_cast<std::uint32_t>(value) & bitMask(bits);
+            }
+        }
+        return reader.read(bits);
+    }
+}
+
+//schema
+std::size_t SnapshotSchema::addFloat(float min, float max, std::uint8_t bits)
+{
+    return addField(FieldType::Float, bits, 1, glm::vec3(min), glm::vec3(max));
+}
+
+std::size_t SnapshotSchema::addVec3(glm::vec3 min, glm::vec3 max, std::uint8_t bits)
+{
+    return addField(FieldType::Vec3, bits, 3, min, max);
+}
+
+std::size_t SnapshotSchema::addQuat(std::uint8_t bits)
+{
+    return addField(FieldType::Quat, bits, 4, glm::vec3(-QuatRange), glm::vec3(QuatRange));
+}
+
+std::size_t SnapshotSchema::addUInt(std::uint8_t bits)
+{
+    return addField(FieldType::UInt, bits, 1, glm::vec3(0.f), glm::vec3(0.f));
+}
+
+std::size_t SnapshotSchema::addField(FieldType type, std::uint8_t bits, std::size_t channelCount, glm::vec3 min, glm::vec3 max)
+{
+    CRO_ASSERT(bits > 0 && bits <= 32, "Field must be between 1 and 32 bits");
+    bits = std::clamp(bits, std::uint8_t(1), std::uint8_t(32));
+
+    Field field;
+    field.type = type;
+    field.bits = bits;
+    field.channel = m_channelBits.size();
+    field.min = min;
+    field.max = max;
+    m_fields.push_back(field);
+
+    for (auto i = 0u; i < channelCount; ++i)
+    {
+        m_channelBits.push_back(bits);
+    }
+
+    if (type == FieldType::Quat)
+    {
+        m_channelBits[field.channel] = QuatIndexBits;
+    }
+
+    return m_fields.size() - 1;
+}
+
+//snapshot
+std::size_t Snapshot::addEntity(std::uint32_t id)
+{
+    CRO_ASSERT(m_schema, "Snapshot was not created by a SnapshotEncoder");
+    CRO_ASSERT(findEntity(id) == m_ids.size(), "Entity ID already exists in snapshot");
+
+    m_ids.push_back(id);
+    m_channels.resize(m_channels.size() + m_schema->m_channelBits.size(), 0);
+    return m_ids.size() - 1;
+}
+
+std::size_t Snapshot::findEntity(std::uint32_t id) const
+{
+    return std::distance(m_ids.begin(), std::find(m_ids.begin(), m_ids.end(), id));
+}
+
+void Snapshot::setFloat(std::size_t index, std::size_t field, float value)
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::Float, "Field is not a float");
+
+    *getChannels(index, field) = quantise(value, f.min.x, f.max.x, f.bits);
+}
+
+void Snapshot::setVec3(std::size_t index, std::size_t field, glm::vec3 value)
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::Vec3, "Field is not a vec3");
+
+    auto* channels = getChannels(index, field);
+    for (auto i = 0; i < 3; ++i)
+    {
+        channels[i] = quantise(value[i], f.min[i], f.max[i], f.bits);
+    }
+}
+
+void Snapshot::setQuat(std::size_t index, std::size_t field, glm::quat value)
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::Quat, "Field is not a quat");
+
+    //send the smallest three components and recreate
+    //the largest from the fact that the quat is normalised
+    value = glm::normalize(value);
+    std::array<float, 4u> components = { value.w, value.x, value.y, value.z };
+
+    std::uint32_t largest = 0;
+    for (auto i = 1u; i < components.size(); ++i)
+    {
+        if (std::abs(components[i]) > std::abs(components[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    //q and -q are the same rotation so make sure
+    //the dropped component is always positive
+    const float sign = components[largest] < 0.f ? -1.f : 1.f;
+
+    auto* channels = getChannels(index, field);
+    channels[0] = largest;
+
+    auto channel = 1;
+    for (auto i = 0u; i < components.size(); ++i)
+    {
+        if (i != largest)
+        {
+            channels[channel++] = quantise(components[i] * sign, -QuatRange, QuatRange, f.bits);
+        }
+    }
+}
+
+void Snapshot::setUInt(std::size_t index, std::size_t field, std::uint32_t value)
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::UInt, "Field is not a uint");
+
+    *getChannels(index, field) = value & bitMask(f.bits);
+}
+
+float Snapshot::getFloat(std::size_t index, std::size_t field) const
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::Float, "Field is not a float");
+
+    return dequantise(*getChannels(index, field), f.min.x, f.max.x, f.bits);
+}
+
+glm::vec3 Snapshot::getVec3(std::size_t index, std::size_t field) const
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::Vec3, "Field is not a vec3");
+
+    const auto* channels = getChannels(index, field);
+    glm::vec3 ret(0.f);
+    for (auto i = 0; i < 3; ++i)
+    {
+        ret[i] = dequantise(channels[i], f.min[i], f.max[i], f.bits);
+    }
+    return ret;
+}
+
+glm::quat Snapshot::getQuat(std::size_t index, std::size_t field) const
+{
+    const auto& f = m_schema->m_fields[field];
+    CRO_ASSERT(f.type == SnapshotSchema::FieldType::Quat, "Field is not a quat");
+
+    const auto* channels = getChannels(index, field);
+    const auto largest = std::min(channels[0], 3u);
+
+    std::array<float, 4u> components = {};
+    float sum = 0.f;
+    auto channel = 1;
+    for (auto i = 0u; i < components.size(); ++i)
+    {
+        if (i != largest)
+        {
+            components[i] = dequantise(channels[channel++], -QuatRange, QuatRange, f.bits);
+            sum += components[i] * components[i];
+        }
+    }
+    components[largest] = std::sqrt(std::max(0.f, 1.f - sum));
+
+    return glm::normalize(glm::quat(components[0], components[1], components[2], components[3]));
+}
+
+std::uint32_t Snapshot::getUInt(std::size_t index, std::size_t field) const
+{
+    CRO_ASSERT(m_schema->m_fields[field].type == SnapshotSchema::FieldType::UInt, "Field is not a uint");
+    return *getChannels(index, field);
+}
+
+//private
+void Snapshot::clear()
+{
+    m_sequence = 0;
+    m_timestamp = 0;
+    m_ids.clear();
+    m_channels.clear();
+}
+
+void Snapshot::sort()
+{
+    if (std::is_sorted(m_ids.begin(), m_ids.end()))
+    {
+        return;
+    }
+
+    std::vector<std::size_t> order(m_ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {return m_ids[a] < m_ids[b]; });
+
+    const auto channelCount = m_schema->m_channelBits.size();
+    std::vector<std::uint32_t> ids(m_ids.size());
+    std::vector<std::uint32_t> channels(m_channels.size());
+    for (auto i = 0u; i < order.size(); ++i)
+    {
+        ids[i] = m_ids[order[i]];
+        std::copy_n(m_channels.begin() + (order[i] * channelCount), channelCount, channels.begin() + (i * channelCount));
+    }
+    m_ids.swap(ids);
+    m_channels.swap(channels);
+}
+
+std::uint32_t* Snapshot::getChannels(std::size_t index, std::size_t field)
+{
+    CRO_ASSERT(index < m_ids.size(), "Index out of range");
+    CRO_ASSERT(field < m_schema->m_fields.size(), "Field out of range");
+    return &m_channels[(index * m_schema->m_channelBits.size()) + m_schema->m_fields[field].channel];
+}
+
+const std::uint32_t* Snapshot::getChannels(std::size_t index, std::size_t field) const
+{
+    CRO_ASSERT(index < m_ids.size(), "Index out of range");
+    CRO_ASSERT(field < m_schema->m_fields.size(), "Field out of range");
+    return &m_channels[(index * m_schema->m_channelBits.size()) + m_schema->m_fields[field].channel];
+}
+
+//encoder
+SnapshotEncoder::SnapshotEncoder(const SnapshotSchema& schema, std::size_t historySize)
+    : m_schema  (std::make_shared<SnapshotSchema>(schema)),
+    m_sequence  (0)
+{
+    CRO_ASSERT(historySize > 1 && historySize <= MaxHistorySize, "History size must be between 2 and 255");
+    m_history.resize(std::clamp(historySize, std::size_t(2), std::size_t(MaxHistorySize)));
+    for (auto& snapshot : m_history)
+    {
+        snapshot.m_schema = m_schema;
+    }
+    m_workingSnapshot.m_schema = m_schema;
+}
+
+Snapshot& SnapshotEncoder::beginSnapshot(std::int32_t timestamp)
+{
+    m_workingSnapshot.clear();
+    m_workingSnapshot.m_timestamp = timestamp;
+    return m_workingSnapshot;
+}
+
+std::uint32_t SnapshotEncoder::commit()
+{
+    //wrapping to 0 would make the snapshot look unacknowledged
+    m_sequence = std::max(m_sequence + 1, 1u);
+
+    m_workingSnapshot.sort();
+    m_workingSnapshot.m_sequence = m_sequence;
+    m_history[m_sequence % m_history.size()] = m_workingSnapshot;
+
+    return m_sequence;
+}
+
+void SnapshotEncoder::encode(std::uint32_t ack, std::vector<std::uint8_t>& dst) const
+{
+    dst.clear();
+
+    const auto& snapshot = getSnapshot();
+    if (snapshot.m_sequence == 0)
+    {
+        return;
+    }
+
+    const Snapshot* baseline = nullptr;
+    if (ack != 0
+        && ack < m_sequence
+        && (m_sequence - ack) < m_history.size()
+        && m_history[ack % m_history.size()].m_sequence == ack)
+    {
+        baseline = &m_history[ack % m_history.size()];
+    }
+
+    const auto& channelBits = m_schema->m_channelBits;
+    const auto channelCount = channelBits.size();
+    const std::vector<std::uint32_t> zero(channelCount, 0);
+
+    BitWriter writer(dst);
+    writer.write(snapshot.m_sequence, 32);
+    writer.write(baseline ? m_sequence - ack : 0, 8);
+    writer.write(static_cast<std::uint32_t>(snapshot.m_timestamp), 32);
+    writer.writeCount(std::uint64_t(snapshot.m_ids.size()) + 1);
+
+    std::size_t baseIndex = 0;
+    std::int64_t prevID = -1;
+    for (auto i = 0u; i < snapshot.m_ids.size(); ++i)
+    {
+        const auto id = snapshot.m_ids[i];
+        writer.writeCount(static_cast<std::uint64_t>(id - prevID));
+        prevID = id;
+
+        const auto* current = &snapshot.m_channels[i * channelCount];
+        const auto* base = zero.data();
+
+        //both lists are sorted so we can walk them together
+        if (baseline)
+        {
+            while (baseIndex < baseline->m_ids.size()
+                && baseline->m_ids[baseIndex] < id)
+            {
+                baseIndex++;
+            }
+
+            if (baseIndex < baseline->m_ids.size()
+                && baseline->m_ids[baseIndex] == id)
+            {
+                base = &baseline->m_channels[baseIndex * channelCount];
+                if (std::equal(current, current + channelCount, base))
+                {
+                    writer.write(0, 1);
+                    continue;
+                }
+                writer.write(1, 1);
+            }
+        }
+
+        for (auto j = 0u; j < channelCount; ++j)
+        {
+            writeChannel(writer, current[j], base[j], channelBits[j]);
+        }
+    }
+    writer.flush();
+}
+
+const Snapshot& SnapshotEncoder::getSnapshot() const
+{
+    return m_history[m_sequence % m_history.size()];
+}
+
+//decoder
+SnapshotDecoder::SnapshotDecoder(const SnapshotSchema& schema, std::size_t historySize)
+    : m_schema  (std::make_shared<SnapshotSchema>(schema)),
+    m_sequence  (0)
+{
+    CRO_ASSERT(historySize > 1 && historySize <= MaxHistorySize, "History size must be between 2 and 255");
+
+    //the extra snapshot is used as a scratch buffer
+    //so failed decodes never overwrite a baseline
+    m_history.resize(std::clamp(historySize, std::size_t(2), std::size_t(MaxHistorySize)) + 1);
+    for (auto& snapshot : m_history)
+    {
+        snapshot.m_schema = m_schema;
+    }
+}
+
+bool SnapshotDecoder::decode(const void* data, std::size_t size)
+{
+    if (!data || size == 0)
+    {
+        return false;
+    }
+
+    const auto historySize = m_history.size() - 1;
+
+    BitReader reader(static_cast<const std::uint8_t*>(data), size);
+    const auto sequence = reader.read(32);
+    const auto distance = reader.read(8);
+    const auto timestamp = static_cast<std::int32_t>(reader.read(32));
+
+    if (reader.error()
+        || sequence == 0
+        || sequence <= m_sequence
+        || distance >= historySize)
+    {
+        return false;
+    }
+
+    const Snapshot* baseline = nullptr;
+    if (distance != 0)
+    {
+        const auto baseSequence = sequence - distance;
+        baseline = &m_history[baseSequence % historySize];
+        if (baseline->m_sequence != baseSequence)
+        {
+            return false;
+        }
+    }
+
+    const auto& channelBits = m_schema->m_channelBits;
+    const auto channelCount = channelBits.size();
+
+    const auto entityCount = reader.readCount() - 1;
+    //every entity uses at least one bit
+    if (reader.error()
+        || entityCount > size * 8)
+    {
+        return false;
+    }
+
+    auto& snapshot = m_history.back();
+    snapshot.clear();
+    snapshot.m_ids.resize(entityCount);
+    snapshot.m_channels.resize(entityCount * channelCount);
+
+    std::size_t baseIndex = 0;
+    std::int64_t prevID = -1;
+    for (auto i = 0u; i < entityCount; ++i)
+    {
+        const auto id = prevID + static_cast<std::int64_t>(reader.readCount());
+        if (reader.error()
+            || id > std::numeric_limits<std::uint32_t>::max())
+        {
+            return false;
+        }
+        snapshot.m_ids[i] = static_cast<std::uint32_t>(id);
+        prevID = id;
+
+        auto* current = &snapshot.m_channels[i * channelCount];
+        const std::uint32_t* base = nullptr;
+
+        if (baseline)
+        {
+            while (baseIndex < baseline->m_ids.size()
+                && baseline->m_ids[baseIndex] < id)
+            {
+                baseIndex++;
+            }
+
+            if (baseIndex < baseline->m_ids.size()
+                && baseline->m_ids[baseIndex] == id)
+            {
+                base = &baseline->m_channels[baseIndex * channelCount];
+                if (reader.read(1) == 0)
+                {
+                    std::copy_n(base, channelCount, current);
+                    continue;
+                }
+            }
+        }
+
+        for (auto j = 0u; j < channelCount; ++j)
+        {
+            current[j] = readChannel(reader, base ? base[j] : 0, channelBits[j]);
+        }
+    }
+
+    if (reader.error())
+    {
+        return false;
+    }
+
+    snapshot.m_sequence = sequence;
+    snapshot.m_timestamp = timestamp;
+    std::swap(snapshot, m_history[sequence % historySize]);
+    m_sequence = sequence;
+
+    return true;
+}
+
+const Snapshot& SnapshotDecoder::getSnapshot() const
+{
+    return m_history[m_sequence % (m_history.size() - 1)];
+}
+
+void SnapshotDecoder::reset()
+{
+    for (auto& snapshot : m_history)
+    {
+        snapshot.clear();
+    }
+    m_sequence = 0;
+}
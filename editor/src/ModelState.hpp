@@ -162,6 +162,7 @@ private:
         float scale = 1.f;
     }m_importedTransform;
     bool m_exportAnimation;
+    bool m_exportCompressed;
     std::size_t m_skeletonMeshID;
 
     void importModel();
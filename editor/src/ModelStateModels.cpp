@@ -477,7 +477,7 @@ void ModelState::saveModel(const std::string& path)
         {
             //write the binary in case attachments or notifications
             //were updated.
-            cro::Detail::ModelBinary::write(m_entities[EntityID::ActiveModel], meshPath, true);
+            cro::Detail::ModelBinary::write(m_entities[EntityID::ActiveModel], meshPath, true, m_exportCompressed);
         }
     }
     else
@@ -1022,7 +1022,7 @@ void ModelState::exportModel(bool modelOnly, bool openOnSave)
 
         //write binary file
         bool animated = m_exportAnimation && m_importedHeader.animated;
-        if (cro::Detail::ModelBinary::write(m_entities[EntityID::ActiveModel], path, animated))
+        if (cro::Detail::ModelBinary::write(m_entities[EntityID::ActiveModel], path, animated, m_exportCompressed))
         {
             //create config file and save as cmt
             auto modelName = cro::FileSystem::getFileName(path);
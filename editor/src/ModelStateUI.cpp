@@ -854,6 +854,9 @@ void ModelState::drawInspector()
                     {
                         ImGui::Checkbox("Export Animations", &m_exportAnimation);
                     }
+                    ImGui::Checkbox("Compress Mesh Data", &m_exportCompressed);
+                    ImGui::SameLine();
+                    helpMarker("Optimises and compresses the vertex data, creating smaller files which load faster.\nUncheck this if the model needs to be loaded by older versions of crogine.");
                     if (ImGui::Button("Convert##01"))
                     {
                         exportModel(modelOnly);
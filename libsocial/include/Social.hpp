@@ -32,7 +32,6 @@ source distribution.
 #include "MonthlyChallenge.hpp"
 
 #include <crogine/graphics/Image.hpp>
-#include <crogine/core/App.hpp>
 #include <crogine/core/String.hpp>
 
 #include <array>
@@ -51,11 +50,12 @@ source distribution.
 //(player avatar data format changed 1153 -> 1160)
 //(player avatar data format changed 1170 -> 1180)
 //(course data changed 1180 -> 1181)
-static constexpr std::uint16_t CURRENT_VER = 1182;
+//(ball updates sent as delta compressed snapshots 1182 -> 1183)
+static constexpr std::uint16_t CURRENT_VER = 1183;
 #ifdef __APPLE__
-static const std::string StringVer("1.18.2 (macOS beta)");
+static const std::string StringVer("1.18.3 (macOS beta)");
 #else
-static const std::string StringVer("1.18.2");
+static const std::string StringVer("1.18.3");
 #endif
 
 struct HallEntry final
@@ -0,0 +1,89 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+Shared helpers for the benchmarks. Each benchmark is its own
+executable, which prints a table of results to stdout.
+*/
+
+//returns the median time in microseconds taken by func, which is
+//called the given number of times after a single warm up call.
+//setup is called before each call to func, outside of the timing.
+template <typename Setup, typename Func>
+double measure(std::size_t runs, Setup&& setup, Func&& func)
+{
+    setup();
+    func();
+
+    std::vector<double> times;
+    times.reserve(runs);
+    for (auto i = 0u; i < runs; ++i)
+    {
+        setup();
+
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    return times.empty() ? 0.0 : times[times.size() / 2];
+}
+
+template <typename Func>
+double measure(std::size_t runs, Func&& func)
+{
+    return measure(runs, []() {}, std::forward<Func>(func));
+}
+
+inline void printHeader(const char* title)
+{
+    std::printf("\n%s\n", title);
+}
+
+inline void printResult(const std::string& name, double value, const char* unit)
+{
+    std::printf("  %-44s %12.2f %s\n", name.c_str(), value, unit);
+}
+
+//prints two measurements of the same work side by side
+inline void printComparison(const std::string& name, double a, double b, const char* unit)
+{
+    std::printf("  %-44s %12.2f %-4s %12.2f %-4s %6.2fx\n", name.c_str(), a, unit, b, unit, b > 0.0 ? a / b : 0.0);
+}
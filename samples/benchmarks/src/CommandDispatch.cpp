@@ -0,0 +1,176 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Measures a frame of the CommandSystem with 5000 command targets and
+500 commands, each targeting one of 16 flags. The targets are left
+unchanged, have the flags of some of them changed before each frame,
+which moves them between the system's buckets, or are partly destroyed
+and replaced each frame. For comparison the same commands are also
+dispatched by testing every target against every command, as the
+CommandSystem did before it grouped targets by flag.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/components/CommandTarget.hpp>
+#include <crogine/ecs/systems/CommandSystem.hpp>
+
+#include <atomic>
+#include <random>
+
+namespace
+{
+    constexpr std::size_t Runs = 100;
+    constexpr std::size_t TargetCount = 5000;
+    constexpr std::size_t CommandCount = 500;
+    constexpr std::uint32_t FlagCount = 16;
+    constexpr std::size_t ChangeCount = 500; //per frame
+
+    std::mt19937 rng(1234);
+
+    //one flag in most cases, with some targets having two
+    std::uint32_t randomID()
+    {
+        std::uniform_int_distribution<std::uint32_t> dist(0, FlagCount - 1);
+        auto id = 1u << dist(rng);
+        if (dist(rng) < 4)
+        {
+            id |= 1u << dist(rng);
+        }
+        return id;
+    }
+
+    std::vector<std::uint32_t> randomFlags()
+    {
+        std::uniform_int_distribution<std::uint32_t> dist(0, FlagCount - 1);
+        std::vector<std::uint32_t> flags;
+        for (auto i = 0u; i < CommandCount; ++i)
+        {
+            flags.push_back(1u << dist(rng));
+        }
+        return flags;
+    }
+
+    cro::Entity createTarget(cro::Scene& scene)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::CommandTarget>().ID = randomID();
+        return entity;
+    }
+}
+
+int main()
+{
+    std::printf("CommandSystem, %zu targets with %u flags, %zu commands per frame, median of %zu runs\n", TargetCount, FlagCount, CommandCount, Runs);
+
+    const auto flags = randomFlags();
+    std::atomic<std::uint32_t> result = 0;
+
+    cro::MessageBus mb;
+    cro::Scene scene(mb);
+    auto& commandSystem = *scene.addSystem<cro::CommandSystem>(mb);
+
+    std::vector<cro::Entity> targets;
+    for (auto i = 0u; i < TargetCount; ++i)
+    {
+        targets.push_back(createTarget(scene));
+    }
+    scene.simulate(0.f);
+
+    //the action is trivial so that dispatch dominates
+    const auto sendCommands = [&]()
+    {
+        for (auto flag : flags)
+        {
+            cro::Command cmd;
+            cmd.targetFlags = flag;
+            cmd.action = [&](cro::Entity e, float)
+            {
+                result = result + e.getIndex();
+            };
+            commandSystem.sendCommand(cmd);
+        }
+    };
+
+    printHeader("Scene::simulate() with only a CommandSystem");
+    {
+        const auto unchanged = measure(Runs, sendCommands, [&]() { scene.simulate(0.016f); });
+        printResult("targets unchanged", unchanged, "us");
+
+        std::uniform_int_distribution<std::size_t> dist(0, TargetCount - 1);
+        const auto changed = measure(Runs,
+            [&]()
+            {
+                for (auto i = 0u; i < ChangeCount; ++i)
+                {
+                    targets[dist(rng)].getComponent<cro::CommandTarget>().ID = randomID();
+                }
+                sendCommands();
+            },
+            [&]() { scene.simulate(0.016f); });
+        printResult(std::to_string(ChangeCount) + " targets change flags", changed, "us");
+
+        const auto churn = measure(Runs,
+            [&]()
+            {
+                for (auto i = 0u; i < ChangeCount; ++i)
+                {
+                    auto& target = targets[dist(rng)];
+                    scene.destroyEntity(target);
+                    target = createTarget(scene);
+                }
+                sendCommands();
+            },
+            [&]() { scene.simulate(0.016f); });
+        printResult(std::to_string(ChangeCount) + " targets replaced", churn, "us");
+    }
+
+    printHeader("Every command tested against every target");
+    {
+        const auto linear = measure(Runs, [&]()
+            {
+                for (auto flag : flags)
+                {
+                    for (auto e : targets)
+                    {
+                        if (e.getComponent<cro::CommandTarget>().ID & flag)
+                        {
+                            result = result + e.getIndex();
+                        }
+                    }
+                }
+            });
+        printResult("targets unchanged", linear, "us");
+    }
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Compares index-addressed ComponentPool storage with PackedComponentPool
+storage, for components which inherit Detail::PackedStorage. The same
+component data is stored both ways, and each is measured iterating via
+EntityManager::forEachComponent() at several densities, and under add
+and remove churn, where entities are destroyed and replaced each frame.
+Callbacks use packed storage, so the cost of updating the CallbackSystem
+via Scene::simulate() is also measured at several densities.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/ecs/Component.hpp>
+#include <crogine/ecs/Entity.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/components/Callback.hpp>
+#include <crogine/ecs/systems/CallbackSystem.hpp>
+#include <crogine/detail/glm/vec3.hpp>
+
+#include <random>
+
+namespace
+{
+    //the largest number of entities an EntityManager can hold
+    constexpr std::size_t EntityCount = 8000;
+    constexpr std::size_t Runs = 200;
+    constexpr std::size_t ChurnCount = 500;
+
+    struct Body final
+    {
+        glm::vec3 position = glm::vec3(0.f);
+        glm::vec3 velocity = glm::vec3(1.f);
+        float age = 0.f;
+    };
+
+    struct PackedBody final : public cro::Detail::PackedStorage
+    {
+        glm::vec3 position = glm::vec3(0.f);
+        glm::vec3 velocity = glm::vec3(1.f);
+        float age = 0.f;
+    };
+
+    template <typename T>
+    void integrate(cro::EntityManager& em)
+    {
+        em.forEachComponent<T>([](cro::Entity, T& body)
+            {
+                body.position += body.velocity * 0.016f;
+                body.age += 0.016f;
+            });
+    }
+
+    //creates EntityCount entities, of which every nth has a T
+    template <typename T>
+    std::vector<cro::Entity> populate(cro::EntityManager& em, std::size_t stride)
+    {
+        std::vector<cro::Entity> entities;
+        for (auto i = 0u; i < EntityCount; ++i)
+        {
+            auto entity = em.createEntity();
+            if (i % stride == 0)
+            {
+                em.addComponent<T>(entity, T());
+                entities.push_back(entity);
+            }
+        }
+        return entities;
+    }
+
+    template <typename T>
+    double measureIteration(std::size_t stride)
+    {
+        cro::MessageBus mb;
+        cro::ComponentManager cm;
+        cro::EntityManager em(mb, cm);
+        populate<T>(em, stride);
+
+        return measure(Runs, [&]() { integrate<T>(em); });
+    }
+
+    //destroys ChurnCount random entities with a T and replaces them,
+    //then iterates the remaining components as a frame would
+    template <typename T>
+    double measureChurn()
+    {
+        cro::MessageBus mb;
+        cro::ComponentManager cm;
+        cro::EntityManager em(mb, cm);
+
+        //leave room for the replacement entities
+        std::vector<cro::Entity> entities;
+        for (auto i = 0u; i < EntityCount - ChurnCount; ++i)
+        {
+            auto entity = em.createEntity();
+            em.addComponent<T>(entity, T());
+            entities.push_back(entity);
+        }
+
+        std::mt19937 rng(1234);
+        return measure(Runs, [&]()
+            {
+                for (auto i = 0u; i < ChurnCount; ++i)
+                {
+                    const auto idx = std::uniform_int_distribution<std::size_t>(0, entities.size() - 1)(rng);
+                    em.destroyEntity(entities[idx]);
+
+                    auto entity = em.createEntity();
+                    em.addComponent<T>(entity, T());
+                    entities[idx] = entity;
+                }
+                integrate<T>(em);
+            });
+    }
+
+    //every nth entity in the scene has an active callback
+    double measureCallbacks(std::size_t stride)
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        scene.addSystem<cro::CallbackSystem>(mb);
+
+        std::size_t count = 0;
+        for (auto i = 0u; i < EntityCount - 10; ++i)
+        {
+            auto entity = scene.createEntity();
+            if (i % stride == 0)
+            {
+                entity.addComponent<cro::Callback>().active = true;
+                entity.getComponent<cro::Callback>().function = [&count](cro::Entity, float) { count++; };
+            }
+        }
+
+        return measure(Runs, [&]() { scene.simulate(0.016f); });
+    }
+}
+
+int main()
+{
+    std::printf("Component storage, %zu entities, median of %zu runs\n", EntityCount, Runs);
+    std::printf("  %-44s %17s %17s %7s\n", "", "indexed", "packed", "ratio");
+
+    printHeader("Iterate with forEachComponent()");
+    for (auto stride : { 1u, 4u, 20u, 100u })
+    {
+        const auto indexed = measureIteration<Body>(stride);
+        const auto packed = measureIteration<PackedBody>(stride);
+        printComparison(std::to_string(EntityCount / stride) + " components", indexed, packed, "us");
+    }
+
+    printHeader("Add / remove churn");
+    const auto indexed = measureChurn<Body>();
+    const auto packed = measureChurn<PackedBody>();
+    printComparison("replace " + std::to_string(ChurnCount) + " then iterate", indexed, packed, "us");
+
+    printHeader("Scene::simulate() with a CallbackSystem");
+    for (auto stride : { 1u, 4u, 20u })
+    {
+        printResult(std::to_string((EntityCount - 10) / stride) + " callbacks", measureCallbacks(stride), "us");
+    }
+
+    return 0;
+}
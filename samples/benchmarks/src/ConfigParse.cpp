@@ -0,0 +1,218 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Measures ConfigFile parsing over the config files in the samples
+directory: model definitions, sprite sheets, particle settings and
+so on. Every file is loaded each run, after which the values in
+the loaded trees are read as strings, floats and vec4s, and every
+property is looked up by name. The samples directory is taken from
+the build, or can be passed as the first argument.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/ConfigFile.hpp>
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <array>
+#include <atomic>
+
+namespace
+{
+    constexpr std::size_t Runs = 50;
+    const std::array<std::string, 5u> Extensions = { ".cmt", ".spt", ".xyp", ".mdf", ".cfg" };
+
+    void findFiles(const std::string& dir, std::vector<std::string>& output, std::size_t& byteCount)
+    {
+        for (const auto& file : cro::FileSystem::listFiles(dir))
+        {
+            const auto ext = cro::FileSystem::getFileExtension(file);
+            if (std::find(Extensions.begin(), Extensions.end(), ext) != Extensions.end())
+            {
+                const auto path = dir + "/" + file;
+                if (auto* f = std::fopen(path.c_str(), "rb"); f)
+                {
+                    std::fseek(f, 0, SEEK_END);
+                    byteCount += std::ftell(f);
+                    std::fclose(f);
+                }
+                output.push_back(path);
+            }
+        }
+
+        for (const auto& subDir : cro::FileSystem::listDirectories(dir))
+        {
+            findFiles(dir + "/" + subDir, output, byteCount);
+        }
+    }
+
+    template <typename Func>
+    void forEachObject(const cro::ConfigObject& obj, Func&& func)
+    {
+        func(obj);
+        for (const auto& child : obj.getObjects())
+        {
+            forEachObject(child, func);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef SAMPLE_DIR
+    std::string dir = SAMPLE_DIR;
+#else
+    std::string dir = "samples";
+#endif
+    if (argc > 1)
+    {
+        dir = argv[1];
+    }
+
+    //some of the samples have properties with missing values,
+    //which would otherwise log a warning on every run
+    cro::Logger::setLogLevel(cro::Logger::Type::Error);
+
+    std::vector<std::string> paths;
+    std::size_t byteCount = 0;
+    findFiles(dir, paths, byteCount);
+
+    std::vector<cro::ConfigFile> files;
+    for (const auto& path : paths)
+    {
+        if (cro::ConfigFile cfg; cfg.loadFromFile(path, false))
+        {
+            files.push_back(std::move(cfg));
+        }
+    }
+
+    if (files.empty())
+    {
+        std::printf("No config files found in %s\n", dir.c_str());
+        return 1;
+    }
+
+    std::size_t propertyCount = 0;
+    for (const auto& file : files)
+    {
+        forEachObject(file, [&](const cro::ConfigObject& obj) { propertyCount += obj.getProperties().size(); });
+    }
+
+    std::printf("ConfigFile, %zu files (%zu loaded) of %zu KB with %zu properties in %s, median of %zu runs\n",
+        paths.size(), files.size(), byteCount / 1024, propertyCount, dir.c_str(), Runs);
+
+    std::atomic<std::size_t> result = 0;
+
+    printHeader("Loading every file");
+    {
+        const auto load = measure(Runs, [&]()
+            {
+                for (const auto& path : paths)
+                {
+                    cro::ConfigFile cfg;
+                    result = result + cfg.loadFromFile(path, false);
+                }
+            });
+        printResult("all files", load, "us");
+        printResult("per file", load / static_cast<double>(paths.size()), "us");
+        printResult("throughput", (static_cast<double>(byteCount) / (1024.0 * 1024.0)) / (load / 1000000.0), "MB/s");
+    }
+
+    printHeader("Reading every property of the loaded files");
+    {
+        const auto perProperty = [&](double time)
+        {
+            return (time * 1000.0) / static_cast<double>(propertyCount);
+        };
+
+        const auto strings = measure(Runs, [&]()
+            {
+                for (const auto& file : files)
+                {
+                    forEachObject(file, [&](const cro::ConfigObject& obj)
+                        {
+                            for (const auto& prop : obj.getProperties())
+                            {
+                                result = result + prop.getValue<std::string>().size();
+                            }
+                        });
+                }
+            });
+        printResult("as std::string", perProperty(strings), "ns");
+
+        const auto floats = measure(Runs, [&]()
+            {
+                for (const auto& file : files)
+                {
+                    forEachObject(file, [&](const cro::ConfigObject& obj)
+                        {
+                            for (const auto& prop : obj.getProperties())
+                            {
+                                result = result + static_cast<std::size_t>(prop.getValue<float>());
+                            }
+                        });
+                }
+            });
+        printResult("as float", perProperty(floats), "ns");
+
+        const auto vectors = measure(Runs, [&]()
+            {
+                for (const auto& file : files)
+                {
+                    forEachObject(file, [&](const cro::ConfigObject& obj)
+                        {
+                            for (const auto& prop : obj.getProperties())
+                            {
+                                result = result + static_cast<std::size_t>(prop.getValue<glm::vec4>().w);
+                            }
+                        });
+                }
+            });
+        printResult("as glm::vec4", perProperty(vectors), "ns");
+
+        const auto lookups = measure(Runs, [&]()
+            {
+                for (const auto& file : files)
+                {
+                    forEachObject(file, [&](const cro::ConfigObject& obj)
+                        {
+                            for (const auto& prop : obj.getProperties())
+                            {
+                                result = result + (obj.findProperty(prop.getName()) != nullptr);
+                            }
+                        });
+                }
+            });
+        printResult("findProperty() by name", perProperty(lookups), "ns");
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Measures Scene::simulate() when large numbers of entities are destroyed
+and created each frame, for example projectiles or particles. A number
+of static entities are spread over several systems which projectiles are
+never added to, and a churn of projectiles is destroyed and replaced
+before each simulate() call.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/System.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+
+#include <random>
+
+namespace
+{
+    constexpr std::size_t Runs = 50;
+    constexpr std::size_t StaticCount = 2000;
+    constexpr std::size_t ProjectileCount = 4000;
+
+    struct Projectile final
+    {
+        glm::vec3 velocity = glm::vec3(0.f, 0.f, -10.f);
+    };
+
+    //components which are never added to projectiles
+    template <std::size_t N>
+    struct Tag final
+    {
+        float value = 0.f;
+    };
+
+    class ProjectileSystem final : public cro::System
+    {
+    public:
+        explicit ProjectileSystem(cro::MessageBus& mb)
+            : cro::System(mb, typeid(ProjectileSystem))
+        {
+            requireComponent<cro::Transform>();
+            requireComponent<Projectile>();
+        }
+
+        void process(float dt) override
+        {
+            for (auto entity : getEntities())
+            {
+                entity.getComponent<cro::Transform>().move(entity.getComponent<Projectile>().velocity * dt);
+            }
+        }
+    };
+
+    template <std::size_t N>
+    class TagSystem final : public cro::System
+    {
+    public:
+        explicit TagSystem(cro::MessageBus& mb)
+            : cro::System(mb, typeid(TagSystem<N>))
+        {
+            requireComponent<cro::Transform>();
+            requireComponent<Tag<N>>();
+        }
+
+        void process(float dt) override
+        {
+            for (auto entity : getEntities())
+            {
+                entity.getComponent<Tag<N>>().value += dt;
+            }
+        }
+    };
+
+    template <std::size_t... N>
+    void addTagSystems(cro::Scene& scene, cro::MessageBus& mb, std::index_sequence<N...>)
+    {
+        (scene.addSystem<TagSystem<N>>(mb), ...);
+    }
+
+    template <std::size_t... N>
+    void addTag(cro::Entity entity, std::size_t idx, std::index_sequence<N...>)
+    {
+        ((idx == N ? (void)entity.addComponent<Tag<N>>() : (void)0), ...);
+    }
+
+    constexpr auto TagCount = std::make_index_sequence<8>();
+
+    //destroyed entities post a message each, so they're read
+    //back every frame in the same way as the App would
+    void drainMessages(cro::MessageBus& mb)
+    {
+        while (!mb.empty())
+        {
+            mb.poll();
+        }
+    }
+
+    cro::Entity createProjectile(cro::Scene& scene)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Transform>();
+        entity.addComponent<Projectile>();
+        return entity;
+    }
+
+    double measureChurn(std::size_t churnCount)
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        scene.addSystem<ProjectileSystem>(mb);
+        addTagSystems(scene, mb, TagCount);
+
+        for (auto i = 0u; i < StaticCount; ++i)
+        {
+            auto entity = scene.createEntity();
+            entity.addComponent<cro::Transform>();
+            addTag(entity, i % TagCount.size(), TagCount);
+        }
+
+        std::vector<cro::Entity> projectiles;
+        for (auto i = 0u; i < ProjectileCount; ++i)
+        {
+            projectiles.push_back(createProjectile(scene));
+        }
+        scene.simulate(0.016f);
+        drainMessages(mb);
+
+        std::mt19937 rng(1234);
+        return measure(Runs, [&]()
+            {
+                for (auto i = 0u; i < churnCount; ++i)
+                {
+                    const auto idx = std::uniform_int_distribution<std::size_t>(0, projectiles.size() - 1)(rng);
+                    scene.destroyEntity(projectiles[idx]);
+                    projectiles[idx] = createProjectile(scene);
+                }
+                scene.simulate(0.016f);
+                drainMessages(mb);
+            });
+    }
+}
+
+int main()
+{
+    std::printf("Entity churn, %zu static entities over %zu systems, %zu projectiles, median of %zu runs\n",
+        StaticCount, TagCount.size(), ProjectileCount, Runs);
+
+    printHeader("Destroy and replace projectiles, then Scene::simulate()");
+    for (auto churn : { 0u, 100u, 1000u, 2000u })
+    {
+        printResult(std::to_string(churn) + " per frame", measureChurn(churn), "us");
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Compares testing bounds against a camera frustum one at a time, with
+the scalar per-plane tests, to testing them as a batch with
+Spatial::intersects(), which uses SSE/AVX or NEON where available.
+The bounds are scattered all around the camera so most of them are
+culled, as when culling the props of a golf course.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/graphics/Spatial.hpp>
+#include <crogine/graphics/BoundingBox.hpp>
+#include <crogine/detail/glm/gtc/matrix_transform.hpp>
+
+#include <atomic>
+#include <bitset>
+#include <random>
+
+namespace
+{
+    constexpr std::size_t Runs = 100;
+
+    cro::Frustum createFrustum()
+    {
+        const auto view = glm::lookAt(glm::vec3(0.f, 2.f, 0.f), glm::vec3(0.f, 0.f, -10.f), glm::vec3(0.f, 1.f, 0.f));
+        const auto projection = glm::perspective(0.6f, 16.f / 9.f, 0.1f, 280.f);
+
+        cro::Frustum frustum;
+        cro::Spatial::updateFrustum(frustum, projection * view);
+        return frustum;
+    }
+
+    template <typename T>
+    std::size_t scalarTest(const cro::Frustum& frustum, const std::vector<T>& bounds)
+    {
+        std::size_t visible = 0;
+        for (const auto& b : bounds)
+        {
+            bool inside = true;
+            std::size_t j = 0;
+            while (inside && j < frustum.size())
+            {
+                inside = (cro::Spatial::intersects(frustum[j++], b) != cro::Planar::Back);
+            }
+            visible += inside ? 1 : 0;
+        }
+        return visible;
+    }
+
+    template <typename Batch>
+    std::size_t batchTest(const cro::Frustum& frustum, const Batch& batch, cro::VisibilityMask& mask)
+    {
+        cro::Spatial::intersects(frustum, batch, mask);
+
+        std::size_t visible = 0;
+        for (auto word : mask)
+        {
+            visible += std::bitset<64>(word).count();
+        }
+        return visible;
+    }
+}
+
+int main()
+{
+    std::printf("Frustum culling, median of %zu runs\n", Runs);
+
+    const auto frustum = createFrustum();
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(-300.f, 300.f);
+    std::uniform_real_distribution<float> size(0.5f, 5.f);
+
+    std::atomic<std::size_t> result = 0;
+    cro::VisibilityMask mask;
+
+    printHeader("Spheres");
+    std::printf("  %-44s %12s %4s %12s %4s\n", "", "scalar", "", "batch", "");
+    for (auto count : { 256u, 4096u, 65536u })
+    {
+        std::vector<cro::Sphere> spheres;
+        cro::SphereBatch batch;
+        for (auto i = 0u; i < count; ++i)
+        {
+            spheres.emplace_back(size(rng), glm::vec3(pos(rng), 0.f, pos(rng)));
+            batch.push_back(spheres.back());
+        }
+
+        const auto scalar = measure(Runs, [&]() { result = result + scalarTest(frustum, spheres); });
+        const auto batched = measure(Runs, [&]() { result = result + batchTest(frustum, batch, mask); });
+        printComparison(std::to_string(count) + " spheres", scalar, batched, "us");
+    }
+
+    printHeader("Boxes");
+    std::printf("  %-44s %12s %4s %12s %4s\n", "", "scalar", "", "batch", "");
+    for (auto count : { 256u, 4096u, 65536u })
+    {
+        std::vector<cro::Box> boxes;
+        cro::BoxBatch batch;
+        for (auto i = 0u; i < count; ++i)
+        {
+            const glm::vec3 min(pos(rng), 0.f, pos(rng));
+            boxes.emplace_back(min, min + glm::vec3(size(rng), size(rng), size(rng)));
+            batch.push_back(boxes.back());
+        }
+
+        const auto scalar = measure(Runs, [&]() { result = result + scalarTest(frustum, boxes); });
+        const auto batched = measure(Runs, [&]() { result = result + batchTest(frustum, batch, mask); });
+        printComparison(std::to_string(count) + " boxes", scalar, batched, "us");
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Measures the cost of posting messages to the MessageBus and reading
+them back, as App does each frame. Messages are posted from a single
+thread, from a single thread alternating between two buses (as a
+server hosting several matches does), from several threads at once,
+and from a new thread each frame, which shows whether the lanes of
+threads which have exited are cleaned up.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    constexpr std::size_t Runs = 100;
+    constexpr std::size_t MessageCount = 2000; //per frame
+    constexpr std::size_t ThreadCount = 4;
+    constexpr std::size_t ThreadFrames = 400;
+
+    struct TestMessage final
+    {
+        float position[3] = {};
+        std::int32_t value = 0;
+    };
+
+    void post(cro::MessageBus& mb, std::size_t count)
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            auto* msg = mb.post<TestMessage>(cro::Message::Count);
+            msg->value = static_cast<std::int32_t>(i);
+        }
+    }
+
+    std::int32_t drain(cro::MessageBus& mb)
+    {
+        std::int32_t sum = 0;
+        while (!mb.empty())
+        {
+            sum += mb.poll().getData<TestMessage>().value;
+        }
+        return sum;
+    }
+
+    //returns the time per message in nanoseconds
+    double perMessage(double frameTime, std::size_t messageCount)
+    {
+        return (frameTime * 1000.0) / static_cast<double>(messageCount);
+    }
+}
+
+int main()
+{
+    std::printf("MessageBus, %zu messages of %zu bytes per frame, median of %zu runs\n", MessageCount, sizeof(TestMessage), Runs);
+
+    std::atomic<std::int32_t> result = 0;
+
+    printHeader("Post then read");
+    {
+        cro::MessageBus mb;
+        const auto single = measure(Runs, [&]()
+            {
+                post(mb, MessageCount);
+                result = result + drain(mb);
+            });
+        printResult("one thread, one bus", perMessage(single, MessageCount), "ns/msg");
+
+        cro::MessageBus mb2;
+        const auto alternating = measure(Runs, [&]()
+            {
+                for (auto i = 0u; i < MessageCount / 2; ++i)
+                {
+                    post(mb, 1);
+                    post(mb2, 1);
+                }
+                result = result + drain(mb) + drain(mb2);
+            });
+        printResult("one thread, alternating two buses", perMessage(alternating, MessageCount), "ns/msg");
+
+        const auto threaded = measure(Runs, [&]()
+            {
+                std::vector<std::thread> threads;
+                for (auto i = 0u; i < ThreadCount; ++i)
+                {
+                    threads.emplace_back([&]() { post(mb, MessageCount / ThreadCount); });
+                }
+
+                for (auto& t : threads)
+                {
+                    t.join();
+                }
+                result = result + drain(mb);
+            });
+        printResult(std::to_string(ThreadCount) + " new threads each frame, including spawn", perMessage(threaded, MessageCount), "ns/msg");
+    }
+
+    printHeader("A new posting thread each frame, including spawn");
+    {
+        //if lanes of exited threads are never removed each frame
+        //has one more lane to search and swap than the last
+        cro::MessageBus mb;
+        std::vector<double> times;
+        for (auto i = 0u; i < ThreadFrames; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            std::thread t([&]() { post(mb, MessageCount); });
+            t.join();
+            result = result + drain(mb);
+
+            const auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+
+        const auto median = [](std::vector<double>::const_iterator begin, std::vector<double>::const_iterator end)
+        {
+            std::vector<double> t(begin, end);
+            std::sort(t.begin(), t.end());
+            return t[t.size() / 2];
+        };
+        const auto quarter = ThreadFrames / 4;
+        printResult("first " + std::to_string(quarter) + " frames", perMessage(median(times.cbegin(), times.cbegin() + quarter), MessageCount), "ns/msg");
+        printResult("last " + std::to_string(quarter) + " frames", perMessage(median(times.cend() - quarter, times.cend()), MessageCount), "ns/msg");
+    }
+
+    return 0;
+}
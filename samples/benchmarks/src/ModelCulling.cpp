@@ -0,0 +1,152 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Measures the cost of building the ModelRenderer draw list for a camera
+as the number of models in the scene grows, culling either each model's
+bounding sphere in parallel chunks or with the balanced tree. The models
+are scattered over an area much larger than the camera's view, and use
+mesh data with no vertex buffer so that no graphics context is needed.
+The scenes are measured with all models static, and with some of them
+moved each frame so that the tree has to be refreshed, as it would be
+when vehicles or balls are in play.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/CameraSystem.hpp>
+#include <crogine/ecs/systems/ModelRenderer.hpp>
+
+#include <random>
+
+namespace
+{
+    constexpr std::size_t Runs = 50;
+    constexpr std::size_t MaterialCount = 8;
+    constexpr std::size_t MoveStride = 50; //1 in this many models move each frame, when moving
+    constexpr float WorldSize = 1200.f;
+
+    struct Result final
+    {
+        double time = 0.0;
+        std::size_t visible = 0;
+    };
+
+    Result measureCulling(std::size_t modelCount, bool useTree, bool moving)
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        scene.addSystem<cro::CameraSystem>(mb);
+        auto* renderer = scene.addSystem<cro::ModelRenderer>(mb);
+        renderer->setUseTreeQueries(useTree);
+
+        cro::Mesh::Data meshData;
+        meshData.submeshCount = 1;
+        meshData.boundingBox = { glm::vec3(-1.f), glm::vec3(1.f) };
+        meshData.boundingSphere = meshData.boundingBox;
+
+        std::array<cro::Material::Data, MaterialCount> materials;
+        for (auto i = 0u; i < materials.size(); ++i)
+        {
+            //shaders are only compared when sorting, so need not be valid
+            materials[i].shader = i + 1;
+        }
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> dist(-WorldSize / 2.f, WorldSize / 2.f);
+        std::vector<cro::Entity> movers;
+
+        for (auto i = 0u; i < modelCount; ++i)
+        {
+            auto entity = scene.createEntity();
+            entity.addComponent<cro::Transform>().setPosition(glm::vec3(dist(rng), 0.f, dist(rng)));
+            entity.addComponent<cro::Model>(meshData, materials[i % materials.size()]);
+
+            if (moving && (i % MoveStride) == 0)
+            {
+                movers.push_back(entity);
+            }
+        }
+
+        auto camera = scene.getActiveCamera();
+        scene.simulate(0.016f);
+        renderer->updateDrawList(camera);
+
+        Result result;
+        result.visible = renderer->getVisibleCount(camera.getComponent<cro::Camera>().getDrawListIndex());
+
+        float direction = 1.f;
+        result.time = measure(Runs, [&]()
+            {
+                direction = -direction;
+                for (auto e : movers)
+                {
+                    e.getComponent<cro::Transform>().move(glm::vec3(direction, 0.f, 0.f));
+                }
+                scene.simulate(0.016f);
+            },
+            [&]()
+            {
+                renderer->updateDrawList(camera);
+            });
+        return result;
+    }
+}
+
+int main()
+{
+    std::printf("ModelRenderer::updateDrawList(), models scattered over %.0fm square, 1 in %zu moving when moving, median of %zu runs\n", WorldSize, MoveStride, Runs);
+
+    for (auto moving : { false, true })
+    {
+        printHeader(moving ? "Cull and sort the draw list of one camera, some models moving" : "Cull and sort the draw list of one camera, no models moving");
+        std::printf("  %-24s %10s %17s %17s\n", "", "visible", "sphere chunks", "balanced tree");
+
+        //a Scene holds at most Detail::MinFreeIDs entities, including its default camera and sunlight
+        for (auto count : { 500u, 1000u, 2000u, 4000u, 8000u })
+        {
+            const auto chunked = measureCulling(count, false, moving);
+            const auto tree = measureCulling(count, true, moving);
+            std::printf("  %-24s %10zu %12.2f us %12.2f us\n", (std::to_string(count) + " models").c_str(), chunked.visible, chunked.time, tree.time);
+
+            if (chunked.visible != tree.visible)
+            {
+                std::printf("  warning: the tree found %zu visible models\n", tree.visible);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Measures a frame of particle simulation for 100 emitters, each kept
+close to its limit of ParticleEmitter::MaxParticles, using
+ParticleSystem::simulate(). This spawns, integrates, animates and
+removes particles and writes their vertex data, which is everything
+ParticleSystem::process() does apart from the upload, so it needs no
+graphics context. The emitters are updated from one thread, and split
+across the thread pool as process() does with parallel processing.
+
+Build this in Release: ParticleEmitter asserts that an App exists in
+debug builds.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/ThreadPool.hpp>
+#include <crogine/ecs/components/ParticleEmitter.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/ParticleSystem.hpp>
+
+#include <atomic>
+
+namespace
+{
+    constexpr std::size_t Runs = 50;
+    constexpr std::size_t EmitterCount = 100;
+    constexpr std::size_t Tasks = 8;
+    constexpr float FrameTime = 1.f / 60.f;
+    constexpr float WarmUpTime = 3.f;
+
+    struct Emitters final
+    {
+        std::vector<cro::ParticleEmitter> emitters;
+        std::vector<cro::Transform> transforms;
+
+        Emitters()
+            : emitters(EmitterCount), transforms(EmitterCount)
+        {
+            for (auto i = 0u; i < EmitterCount; ++i)
+            {
+                auto& settings = emitters[i].settings;
+                settings.lifetime = 2.f;
+                settings.lifetimeVariance = 0.2f;
+                settings.emitRate = 100.f;
+                settings.emitCount = 50; //10k particles alive after the lifetime
+                settings.initialVelocity = glm::vec3(0.f, 5.f, 0.f);
+                settings.gravity = glm::vec3(0.f, -9.f, 0.f);
+                settings.forces[0] = glm::vec3(0.5f, 0.f, 0.f);
+                settings.spread = 20.f;
+                settings.spawnRadius = 0.5f;
+                settings.rotationSpeed = 1.f;
+                settings.scaleModifier = -0.1f;
+                settings.frameCount = 4;
+                settings.framerate = 2.f; //so animated particles live as long as the others
+                settings.animate = (i % 2) == 0;
+                settings.textureID = 1;
+                emitters[i].start();
+
+                transforms[i].setPosition(glm::vec3(static_cast<float>(i % 10) * 10.f, 0.f, static_cast<float>(i / 10) * -10.f));
+            }
+        }
+
+        void update(std::size_t start, std::size_t end)
+        {
+            for (auto i = start; i < end; ++i)
+            {
+                cro::ParticleSystem::simulate(emitters[i], transforms[i], FrameTime);
+            }
+        }
+
+        std::size_t particleCount() const
+        {
+            std::size_t count = 0;
+            for (const auto& e : emitters)
+            {
+                count += e.getParticleCount();
+            }
+            return count;
+        }
+    };
+}
+
+int main()
+{
+    std::printf("Particle simulation, %zu emitters of up to %u particles, median of %zu runs\n", EmitterCount, cro::ParticleEmitter::MaxParticles, Runs);
+
+    cro::ThreadPool pool;
+
+    Emitters single;
+    Emitters pooled;
+    for (auto t = 0.f; t < WarmUpTime; t += FrameTime)
+    {
+        single.update(0, EmitterCount);
+        pooled.update(0, EmitterCount);
+    }
+
+    const auto singleTime = measure(Runs, [&]() { single.update(0, EmitterCount); });
+    const auto pooledTime = measure(Runs, [&]()
+        {
+            std::atomic<std::size_t> remaining = Tasks;
+            const auto taskSize = (EmitterCount + Tasks - 1) / Tasks;
+            for (auto i = 0u; i < Tasks; ++i)
+            {
+                pool.submit([&, i]()
+                    {
+                        const auto start = i * taskSize;
+                        pooled.update(start, std::min(start + taskSize, EmitterCount));
+                        remaining--;
+                    });
+            }
+
+            while (remaining)
+            {
+                pool.runPendingTask();
+            }
+        });
+
+    const auto particles = single.particleCount();
+    printHeader("ParticleSystem::simulate() for every emitter");
+    std::printf("  %-44s %12zu\n", "particles alive", particles);
+    printResult("1 thread", singleTime, "us");
+    printResult("1 thread, per particle", (singleTime * 1000.0) / static_cast<double>(particles), "ns");
+    printResult("thread pool", pooledTime, "us");
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Measures a frame of the SkeletalAnimator for a crowd of skinned
+characters, each with a 39 joint skeleton playing one of two looped
+animations, and switching between them with a blend every so often.
+The characters are placed either near the camera, where their frames
+are interpolated, or far from it, where they're not. The number of
+heap allocations made each frame is counted by replacing the global
+operator new, which also catches those made by the engine on
+platforms where the library shares the executable's allocator.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Skeleton.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/CameraSystem.hpp>
+#include <crogine/ecs/systems/SkeletalAnimator.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace
+{
+    std::atomic<std::size_t> allocationCount = 0;
+
+    constexpr std::size_t Runs = 100;
+    constexpr std::size_t CharacterCount = 500;
+    constexpr std::size_t FrameCount = 30; //per animation
+    constexpr std::size_t BlendInterval = 20; //each character starts a blend every this many frames
+    constexpr float FrameTime = 1.f / 60.f;
+
+    //a spine of 7 joints with 4 limbs of 8 joints,
+    //ordered so that parents come before their children
+    std::vector<std::int32_t> createHierarchy()
+    {
+        std::vector<std::int32_t> parents;
+        for (auto i = 0; i < 7; ++i)
+        {
+            parents.push_back(i - 1);
+        }
+
+        for (auto limb = 0; limb < 4; ++limb)
+        {
+            //arms from the top of the spine, legs from the hips
+            parents.push_back(limb < 2 ? 6 : 0);
+            for (auto i = 1; i < 8; ++i)
+            {
+                parents.push_back(static_cast<std::int32_t>(parents.size()) - 1);
+            }
+        }
+        return parents;
+    }
+
+    cro::Skeleton createSkeleton(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> angle(-0.4f, 0.4f);
+        const auto parents = createHierarchy();
+
+        cro::Skeleton skeleton;
+        for (auto anim = 0u; anim < 2; ++anim)
+        {
+            for (auto f = 0u; f < FrameCount; ++f)
+            {
+                std::vector<cro::Joint> frame;
+                for (auto parent : parents)
+                {
+                    const auto rotation = glm::quat(glm::vec3(angle(rng), angle(rng), angle(rng)));
+                    frame.emplace_back(glm::vec3(0.f, 0.2f, 0.f), rotation, glm::vec3(1.f));
+                    frame.back().parent = parent;
+                }
+                skeleton.addFrame(frame);
+            }
+
+            cro::SkeletalAnim animation;
+            animation.name = anim == 0 ? "idle" : "walk";
+            animation.startFrame = static_cast<std::uint32_t>(anim * FrameCount);
+            animation.frameCount = static_cast<std::uint32_t>(FrameCount);
+            animation.frameRate = 30.f;
+            animation.looped = true;
+            skeleton.addAnimation(animation);
+        }
+        skeleton.setInverseBindPose(std::vector<glm::mat4>(parents.size(), glm::mat4(1.f)));
+        skeleton.play(0);
+
+        return skeleton;
+    }
+
+    struct Result final
+    {
+        double time = 0.0;
+        double allocations = 0.0;
+    };
+
+    Result measureCrowd(bool nearCamera)
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        scene.addSystem<cro::CameraSystem>(mb);
+        scene.addSystem<cro::SkeletalAnimator>(mb);
+
+        //the animator doesn't need any mesh data, so no graphics context is needed
+        cro::Mesh::Data meshData;
+        meshData.submeshCount = 1;
+        meshData.boundingBox = { glm::vec3(-1.f), glm::vec3(1.f) };
+        meshData.boundingSphere = meshData.boundingBox;
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> offset(-20.f, 20.f);
+
+        //the default camera looks along -Z, and interpolates within 50 units
+        const float distance = nearCamera ? -30.f : -500.f;
+
+        std::vector<cro::Entity> characters;
+        for (auto i = 0u; i < CharacterCount; ++i)
+        {
+            auto entity = scene.createEntity();
+            entity.addComponent<cro::Transform>().setPosition(glm::vec3(offset(rng), 0.f, distance + offset(rng) / 2.f));
+            entity.addComponent<cro::Model>(meshData, cro::Material::Data());
+            entity.addComponent<cro::Skeleton>() = createSkeleton(rng);
+            characters.push_back(entity);
+        }
+        scene.simulate(FrameTime);
+
+        std::size_t frame = 0;
+        const auto update = [&]()
+        {
+            //stagger the blends so a few characters are blending every frame
+            for (auto i = frame % BlendInterval; i < characters.size(); i += BlendInterval)
+            {
+                auto& skeleton = characters[i].getComponent<cro::Skeleton>();
+                skeleton.play(skeleton.getCurrentAnimation() == 0 ? 1 : 0, 1.f, 0.2f);
+            }
+            frame++;
+
+            scene.simulate(FrameTime);
+        };
+
+        Result result;
+        result.time = measure(Runs, update);
+
+        const auto start = allocationCount.load();
+        for (auto i = 0u; i < Runs; ++i)
+        {
+            update();
+        }
+        result.allocations = static_cast<double>(allocationCount.load() - start) / Runs;
+
+        return result;
+    }
+}
+
+//gcc warns about the free() in the replaced operator delete where
+//it's inlined after a new expression, although they're matched
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    allocationCount++;
+    if (auto* ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main()
+{
+    std::printf("SkeletalAnimator, %zu characters with %zu joints, median of %zu runs\n", CharacterCount, createHierarchy().size(), Runs);
+
+    printHeader("Scene::simulate()");
+    std::printf("  %-44s %15s %15s\n", "", "time", "allocations");
+    for (auto nearCamera : { true, false })
+    {
+        const auto result = measureCrowd(nearCamera);
+        std::printf("  %-44s %12.2f us %15.1f\n", nearCamera ? "near the camera, interpolated" : "far from the camera", result.time, result.allocations);
+    }
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Measures the CPU cost of writing a frame of vertex data through a
+StreamingBuffer, compared with copying the same data into one
+preallocated block, for a few large writes as the ParticleSystem
+makes and for many small writes, such as a quad per sprite. The
+buffer uses a backend which maps system memory and whose fences
+are signalled immediately, so no graphics context is needed and
+only the allocator's bookkeeping is measured, not the driver.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/graphics/StreamingBuffer.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <map>
+
+namespace
+{
+    constexpr std::size_t Runs = 200;
+
+    struct Workload final
+    {
+        const char* name = nullptr;
+        std::size_t writeCount = 0;
+        std::size_t writeSize = 0;
+        std::size_t alignment = 0;
+    };
+
+    constexpr Workload Workloads[] =
+    {
+        { "100 writes of 40 KB", 100, 40 * 1024, 48 },
+        { "10000 writes of 128 bytes", 10000, 128, 32 }
+    };
+
+    class MemoryBackend final : public cro::Detail::StreamingBackend
+    {
+    public:
+        explicit MemoryBackend(bool persistent) : m_persistent(persistent) {}
+
+        bool persistentMapping() const override { return m_persistent; }
+
+        std::uint32_t createBuffer(std::size_t size, std::uint8_t** mappedData) override
+        {
+            auto handle = m_nextBuffer++;
+            auto& storage = m_buffers[handle];
+            storage.resize(size);
+            if (m_persistent)
+            {
+                *mappedData = storage.data();
+            }
+            return handle;
+        }
+
+        void deleteBuffer(std::uint32_t buffer) override { m_buffers.erase(buffer); }
+
+        void orphanBuffer(std::uint32_t, std::size_t) override {}
+
+        void uploadData(std::uint32_t buffer, std::size_t offset, const void* data, std::size_t size) override
+        {
+            std::memcpy(m_buffers[buffer].data() + offset, data, size);
+        }
+
+        std::uintptr_t insertFence() override { return ++m_nextFence; }
+        void waitFence(std::uintptr_t) override {}
+        void deleteFence(std::uintptr_t) override {}
+
+    private:
+        bool m_persistent;
+        std::map<std::uint32_t, std::vector<std::uint8_t>> m_buffers;
+        std::uint32_t m_nextBuffer = 1;
+        std::uintptr_t m_nextFence = 0;
+    };
+}
+
+int main()
+{
+    std::printf("StreamingBuffer, one frame of writes, median of %zu runs\n", Runs);
+
+    std::atomic<std::size_t> result = 0;
+    for (const auto& workload : Workloads)
+    {
+        printHeader(workload.name);
+
+        const std::vector<std::uint8_t> data(workload.writeSize, 0xcd);
+        const auto frameSize = workload.writeCount * workload.writeSize;
+
+        //the same data copied end to end into memory allocated up front
+        std::vector<std::uint8_t> block(frameSize);
+        const auto copy = measure(Runs, [&]()
+            {
+                for (auto i = 0u; i < workload.writeCount; ++i)
+                {
+                    std::memcpy(block.data() + (i * workload.writeSize), data.data(), workload.writeSize);
+                }
+                result = result + block[frameSize / 2];
+            });
+        printResult("memcpy into one block", copy, "us");
+
+        for (auto persistent : { true, false })
+        {
+            //sized for a few frames, as the renderers would, so
+            //that it wraps around rather than grows
+            cro::StreamingBuffer buffer(std::make_unique<MemoryBackend>(persistent), frameSize * 3);
+            const auto streamed = measure(Runs, [&]()
+                {
+                    buffer.beginFrame();
+                    for (auto i = 0u; i < workload.writeCount; ++i)
+                    {
+                        result = result + buffer.write(data.data(), data.size(), workload.alignment).offset;
+                    }
+                });
+            printComparison(persistent ? "StreamingBuffer, persistently mapped" : "StreamingBuffer, orphaned each frame",
+                streamed, copy, "us");
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Measures a frame of world transform updates for prop hierarchies, such
+as those on a golf course. Each prop is a root with two levels of
+children, and a number of deeper chains are added alongside them. Some
+fraction of the roots are moved by a system during Scene::simulate(),
+after which every world transform in the scene is read, as renderers
+do when building their draw lists, either from one thread or split
+over the thread pool.
+*/
+
+#include "Benchmark.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/core/ThreadPool.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/System.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+
+#include <atomic>
+
+namespace
+{
+    constexpr std::size_t Runs = 100;
+    constexpr std::size_t PropCount = 300;
+    constexpr std::size_t ChildCount = 4; //per node, over two levels
+    constexpr std::size_t ChainCount = 100;
+    constexpr std::size_t ChainDepth = 12;
+    constexpr std::size_t ReadTasks = 4;
+
+    struct Mover final
+    {
+        bool active = false;
+    };
+
+    class MoverSystem final : public cro::System
+    {
+    public:
+        explicit MoverSystem(cro::MessageBus& mb)
+            : cro::System(mb, typeid(MoverSystem))
+        {
+            requireComponent<cro::Transform>();
+            requireComponent<Mover>();
+        }
+
+        void process(float dt) override
+        {
+            for (auto entity : getEntities())
+            {
+                if (entity.getComponent<Mover>().active)
+                {
+                    auto& tx = entity.getComponent<cro::Transform>();
+                    tx.rotate(cro::Transform::Y_AXIS, dt);
+                    tx.move(glm::vec3(dt, 0.f, 0.f));
+                }
+            }
+        }
+    };
+
+    cro::Entity createNode(cro::Scene& scene, std::vector<cro::Entity>& nodes, cro::Entity parent)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Transform>().setPosition(glm::vec3(1.f, 0.5f, 0.f));
+        if (parent.isValid())
+        {
+            parent.getComponent<cro::Transform>().addChild(entity.getComponent<cro::Transform>());
+        }
+        nodes.push_back(entity);
+        return entity;
+    }
+
+    float readRange(const std::vector<cro::Entity>& nodes, std::size_t start, std::size_t end)
+    {
+        float sum = 0.f;
+        for (auto i = start; i < end; ++i)
+        {
+            sum += nodes[i].getComponent<cro::Transform>().getWorldTransform()[3].x;
+        }
+        return sum;
+    }
+
+    double measureFrame(std::size_t moveStride, cro::ThreadPool* pool)
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        scene.addSystem<MoverSystem>(mb);
+
+        std::vector<cro::Entity> nodes;
+        for (auto i = 0u; i < PropCount; ++i)
+        {
+            auto root = createNode(scene, nodes, {});
+            root.addComponent<Mover>().active = moveStride != 0 && (i % moveStride) == 0;
+
+            for (auto j = 0u; j < ChildCount; ++j)
+            {
+                auto child = createNode(scene, nodes, root);
+                for (auto k = 0u; k < ChildCount; ++k)
+                {
+                    createNode(scene, nodes, child);
+                }
+            }
+        }
+
+        for (auto i = 0u; i < ChainCount; ++i)
+        {
+            auto node = createNode(scene, nodes, {});
+            node.addComponent<Mover>().active = moveStride != 0 && (i % moveStride) == 0;
+
+            for (auto j = 1u; j < ChainDepth; ++j)
+            {
+                node = createNode(scene, nodes, node);
+            }
+        }
+        scene.simulate(0.016f);
+        readRange(nodes, 0, nodes.size());
+
+        std::atomic<float> result = 0.f;
+        return measure(Runs, [&]()
+            {
+                scene.simulate(0.016f);
+
+                if (pool)
+                {
+                    std::atomic<std::size_t> remaining = ReadTasks;
+                    const auto taskSize = (nodes.size() + ReadTasks - 1) / ReadTasks;
+                    for (auto i = 0u; i < ReadTasks; ++i)
+                    {
+                        pool->submit([&, i]()
+                            {
+                                const auto start = i * taskSize;
+                                const auto end = std::min(start + taskSize, nodes.size());
+                                result = result + readRange(nodes, start, end);
+                                remaining--;
+                            });
+                    }
+
+                    while (remaining)
+                    {
+                        pool->runPendingTask();
+                    }
+                }
+                else
+                {
+                    result = result + readRange(nodes, 0, nodes.size());
+                }
+            });
+    }
+}
+
+int main()
+{
+    const auto transformCount = PropCount * (1 + ChildCount + (ChildCount * ChildCount)) + (ChainCount * ChainDepth);
+    std::printf("Transform hierarchy, %zu transforms (%zu props, %zu chains of depth %zu), median of %zu runs\n",
+        transformCount, PropCount, ChainCount, ChainDepth, Runs);
+
+    cro::ThreadPool pool;
+
+    printHeader("Scene::simulate() then read every world transform");
+    std::printf("  %-44s %17s %17s\n", "", "1 thread", "thread pool");
+    for (auto stride : { 0u, 10u, 1u })
+    {
+        const std::string name = stride == 0 ? "no roots moved"
+            : stride == 1 ? "all roots moved" : "1 in " + std::to_string(stride) + " roots moved";
+
+        const auto single = measureFrame(stride, nullptr);
+        const auto pooled = measureFrame(stride, &pool);
+        std::printf("  %-44s %12.2f us %12.2f us\n", name.c_str(), single, pooled);
+    }
+
+    return 0;
+}
@@ -0,0 +1,267 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Entry point for the dedicated golf server, which hosts many lobbies and
+matches in a single process with no window, graphics or audio. Clients
+connecting to the server are placed in the first lobby with room for
+them, and a new lobby is opened when the others are full or in play.
+*/
+
+#include "golf/server/ShardServer.hpp"
+#include "golf/server/ServerState.hpp"
+#include "golf/CommonConsts.hpp"
+
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::atomic_bool quit = false;
+
+    void onSignal(int)
+    {
+        quit = true;
+    }
+
+    struct Settings final
+    {
+        ShardServer::Settings server;
+        std::string resourcePath;
+        std::uint32_t reportInterval = 10; //seconds
+    };
+
+    //the most expensive matches listed in each report
+    constexpr std::size_t MaxReportedMatches = 10;
+
+    void printUsage()
+    {
+        std::printf(
+            "Usage: golf-server [options]\n"
+            "  --port <port>        port to listen on (default %u)\n"
+            "  --mode <mode>        golf or billiards (default golf)\n"
+            "  --clients <n>        maximum connections to each match (default %u)\n"
+            "  --matches <n>        maximum number of matches (default 64)\n"
+            "  --workers <n>        threads used to update matches (default all)\n"
+            "  --report <s>         seconds between tick cost reports, 0 to disable (default 10)\n"
+            "  --resources <path>   directory containing the assets directory\n"
+            "  --fast-cpu           CPU players take their turns without waiting\n",
+            ConstVal::GamePort, ConstVal::MaxClients);
+    }
+
+    bool parseArgs(int argc, char** argv, Settings& settings)
+    {
+        for (auto i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--fast-cpu")
+            {
+                settings.server.fastCPU = true;
+                continue;
+            }
+
+            if (i + 1 == argc)
+            {
+                std::printf("Missing value for %s\n", arg.c_str());
+                return false;
+            }
+
+            const std::string value = argv[++i];
+            if (arg == "--mode")
+            {
+                if (value == "golf")
+                {
+                    settings.server.gameMode = Match::GameMode::Golf;
+                }
+                else if (value == "billiards")
+                {
+                    settings.server.gameMode = Match::GameMode::Billiards;
+                }
+                else
+                {
+                    std::printf("Unknown game mode %s\n", value.c_str());
+                    return false;
+                }
+            }
+            else if (arg == "--resources")
+            {
+                settings.resourcePath = value;
+            }
+            else if (arg == "--port" || arg == "--clients" || arg == "--matches"
+                || arg == "--workers" || arg == "--report")
+            {
+                char* end = nullptr;
+                const auto number = std::strtoul(value.c_str(), &end, 10);
+                if (value.empty() || *end != 0)
+                {
+                    std::printf("Invalid value %s for %s\n", value.c_str(), arg.c_str());
+                    return false;
+                }
+
+                if (arg == "--port")
+                {
+                    if (number == 0 || number > 0xffff)
+                    {
+                        std::printf("Port must be between 1 and 65535\n");
+                        return false;
+                    }
+                    settings.server.port = static_cast<std::uint16_t>(number);
+                }
+                else if (arg == "--clients")
+                {
+                    if (number == 0 || number > ConstVal::MaxClients)
+                    {
+                        std::printf("Clients must be between 1 and %u\n", ConstVal::MaxClients);
+                        return false;
+                    }
+                    settings.server.maxConnections = number;
+                }
+                else if (arg == "--matches")
+                {
+                    if (number == 0)
+                    {
+                        std::printf("Matches must be at least 1\n");
+                        return false;
+                    }
+                    settings.server.maxMatches = number;
+                }
+                else if (arg == "--workers")
+                {
+                    settings.server.workerCount = number;
+                }
+                else
+                {
+                    settings.reportInterval = static_cast<std::uint32_t>(number);
+                }
+            }
+            else
+            {
+                std::printf("Unknown option %s\n", arg.c_str());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char* stateName(std::int32_t stateID)
+    {
+        switch (stateID)
+        {
+        default: return "none";
+        case sv::StateID::Lobby: return "lobby";
+        case sv::StateID::Golf: return "golf";
+        case sv::StateID::Billiards: return "billiards";
+        }
+    }
+
+    void report(const ShardServer::Stats& stats)
+    {
+        auto matches = stats.matches;
+        std::sort(matches.begin(), matches.end(),
+            [](const ShardServer::MatchStats& a, const ShardServer::MatchStats& b)
+            {
+                return a.load > b.load;
+            });
+
+        std::string shardLoad;
+        for (auto load : stats.shardLoad)
+        {
+            shardLoad += " " + std::to_string(static_cast<std::int32_t>(load));
+        }
+
+        LogI << matches.size() << " matches, " << stats.connectionCount << " connections, "
+            << stats.refusedCount << " refused, " << stats.lateFrames << " late frames. Shard load (ms/s):" << shardLoad << std::endl;
+
+        for (auto i = 0u; i < std::min(matches.size(), MaxReportedMatches); ++i)
+        {
+            const auto& m = matches[i];
+            char line[160];
+            std::snprintf(line, sizeof(line), "  match %u (shard %zu, %s, %zu clients): %u ticks, mean %.3f ms, max %.3f ms, load %.2f ms/s",
+                m.matchID, m.shard, stateName(m.stateID), m.clientCount, m.tickCount, m.meanTickTime, m.maxTickTime, m.load);
+            LogI << line << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+    if (!parseArgs(argc, argv, settings))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (!settings.resourcePath.empty())
+    {
+        cro::FileSystem::setResourceDirectory(settings.resourcePath);
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    ShardServer server;
+    if (!server.launch(settings.server))
+    {
+        return 1;
+    }
+
+    //the server runs on its own thread, and
+    //stops itself if the host fails to start
+    auto lastReport = std::chrono::steady_clock::now();
+    while (!quit && server.running())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        const auto now = std::chrono::steady_clock::now();
+        if (settings.reportInterval != 0
+            && now - lastReport > std::chrono::seconds(settings.reportInterval))
+        {
+            lastReport = now;
+            report(server.getStats());
+        }
+    }
+
+    if (quit)
+    {
+        LogI << "Shutting down server" << std::endl;
+    }
+    server.stop();
+
+    return 0;
+}
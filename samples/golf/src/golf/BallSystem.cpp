@@ -30,11 +30,11 @@ source distribution.
 #include "BallSystem.hpp"
 #include "Terrain.hpp"
 #include "HoleData.hpp"
-#include "GameConsts.hpp"
+#include "GameplayConsts.hpp"
 #include "MessageIDs.hpp"
-#include "../ErrorCheck.hpp"
 #include "server/ServerMessages.hpp"
 
+#include <crogine/core/Log.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 
 #include <crogine/graphics/Image.hpp>
@@ -124,9 +124,6 @@ namespace
         return SlopeData();
     }
 
-    //used when predicting outcome of swing
-    GolfBallEvent predictionEvent;
-
     //these are multipliers
     constexpr std::array SpinDecay =
     {
@@ -322,11 +319,11 @@ void BallSystem::fastForward(cro::Entity entity)
 
     //still have to raise the final event...
     auto* msg = postMessage<GolfBallEvent>(sv::MessageID::GolfMessage);
-    *msg = predictionEvent;
+    *msg = m_predictionEvent;
     msg->client = entity.getComponent<Ball>().client;
 }
 
-#ifdef CRO_DEBUG_
+#if defined(CRO_DEBUG_) && !defined(CRO_HEADLESS)
 void BallSystem::renderDebug(const glm::mat4& mat, glm::uvec2 targetSize)
 {
     CRO_ASSERT(m_debugDraw, "");
@@ -345,11 +342,11 @@ void BallSystem::setDebugFlags(std::int32_t flags)
 void BallSystem::fastProcess(cro::Entity entity, float dt)
 {
     std::int32_t maxTries = 600;
-    predictionEvent = {};
+    m_predictionEvent = {};
     do
     {
         processEntity(entity, dt);
-    } while (predictionEvent.type == GolfBallEvent::None && --maxTries);
+    } while (m_predictionEvent.type == GolfBallEvent::None && --maxTries);
 }
 
 GolfBallEvent* BallSystem::postEvent() const
@@ -358,8 +355,8 @@ GolfBallEvent* BallSystem::postEvent() const
     {
         //TODO we might actually need to queue this if there
         //are more than one per prediction frame...
-        predictionEvent = {};
-        return &predictionEvent;
+        m_predictionEvent = {};
+        return &m_predictionEvent;
     }
     return postMessage<GolfBallEvent>(sv::MessageID::GolfMessage);
 }
@@ -1385,7 +1382,7 @@ void BallSystem::initCollisionWorld(bool drawDebug)
     m_broadphaseInterface = std::make_unique<btDbvtBroadphase>();
     m_collisionWorld = std::make_unique<btCollisionWorld>(m_collisionDispatcher.get(), m_broadphaseInterface.get(), m_collisionCfg.get());
 
-#ifdef CRO_DEBUG_
+#if defined(CRO_DEBUG_) && !defined(CRO_HEADLESS)
     if (drawDebug)
     {
         m_debugDraw = std::make_unique<BulletDebug>();
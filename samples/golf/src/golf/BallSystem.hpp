@@ -30,8 +30,12 @@ source distribution.
 #pragma once
 
 #include "Terrain.hpp"
-#include "DebugDraw.hpp"
 #include "RayResultCallback.hpp"
+#include "server/ServerMessages.hpp"
+
+#ifndef CRO_HEADLESS
+#include "DebugDraw.hpp"
+#endif
 
 #include <crogine/ecs/System.hpp>
 #include <crogine/core/Clock.hpp>
@@ -41,7 +45,6 @@ source distribution.
 
 #include <memory>
 
-struct GolfBallEvent;
 namespace cro
 {
     class Image;
@@ -142,7 +145,7 @@ public:
 
     void fastForward(cro::Entity);
 
-#ifdef CRO_DEBUG_
+#if defined(CRO_DEBUG_) && !defined(CRO_HEADLESS)
     void setDebugFlags(std::int32_t);
     void renderDebug(const glm::mat4&, glm::uvec2);
 #endif
@@ -192,7 +195,7 @@ private:
     std::vector<float> m_vertexData;
     std::vector<std::vector<std::uint32_t>> m_indexData;
 
-#ifdef CRO_DEBUG_
+#if defined(CRO_DEBUG_) && !defined(CRO_HEADLESS)
     std::unique_ptr<BulletDebug> m_debugDraw;
 #endif
 
@@ -205,6 +208,9 @@ private:
         };
     };
     std::uint32_t m_processFlags;
+
+    //used when predicting outcome of swing
+    mutable GolfBallEvent m_predictionEvent;
     void fastProcess(cro::Entity, float);
     GolfBallEvent* postEvent() const;
 
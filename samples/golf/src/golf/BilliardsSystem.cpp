@@ -28,10 +28,13 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include "BilliardsSystem.hpp"
-#include "DebugDraw.hpp"
-#include "GameConsts.hpp"
+#include "GameplayConsts.hpp"
 #include "server/ServerMessages.hpp"
 
+#ifndef CRO_HEADLESS
+#include "DebugDraw.hpp"
+#endif
+
 #include <crogine/core/ConfigFile.hpp>
 #include <crogine/detail/ModelBinary.hpp>
 #include <crogine/ecs/Scene.hpp>
@@ -63,7 +66,7 @@ void BilliardBall::getWorldTransform(btTransform& dest) const
 
 void BilliardBall::setWorldTransform(const btTransform& src)
 {
-    static std::array<float, 16> matrixBuffer = {};
+    std::array<float, 16> matrixBuffer = {};
 
     src.getOpenGLMatrix(matrixBuffer.data());
     auto mat = glm::make_mat4(matrixBuffer.data());
@@ -108,7 +111,7 @@ BilliardsSystem::BilliardsSystem(cro::MessageBus& mb)
 BilliardsSystem::BilliardsSystem(cro::MessageBus& mb, BulletDebug& dd)
     : BilliardsSystem(mb)
 {
-#ifdef CRO_DEBUG_
+#if defined(CRO_DEBUG_) && !defined(CRO_HEADLESS)
     m_collisionWorld->setDebugDrawer(&dd);
 #endif
 
@@ -32,6 +32,7 @@ source distribution.
 #include "MessageIDs.hpp"
 #include "Clubs.hpp"
 #include "CollisionMesh.hpp"
+#include "SharedStateData.hpp"
 #include "server/ServerPacketData.hpp"
 #include "server/CPUStats.hpp"
 
@@ -29,7 +29,6 @@ source distribution.
 
 #include "Clubs.hpp"
 #include "ClubModifiers.hpp"
-#include <Social.hpp>
 
 #include <crogine/detail/Assert.hpp>
 
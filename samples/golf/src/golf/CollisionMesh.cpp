@@ -29,7 +29,7 @@ source distribution.
 
 #include "CollisionMesh.hpp"
 #include "RayResultCallback.hpp"
-#include "GameConsts.hpp"
+#include "GameplayConsts.hpp"
 
 #include <crogine/detail/glm/mat4x4.hpp>
 
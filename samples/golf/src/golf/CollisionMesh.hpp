@@ -36,7 +36,7 @@ deals specifically with golf terrain collision.
 */
 
 #include "DebugDraw.hpp"
-#include "GameConsts.hpp"
+#include "GameplayConsts.hpp"
 #include "Terrain.hpp"
 
 #include <crogine/graphics/MeshData.hpp>
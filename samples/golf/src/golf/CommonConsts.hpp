@@ -29,7 +29,6 @@ source distribution.
 
 #pragma once
 
-#include <crogine/core/App.hpp>
 #include <crogine/detail/glm/gtc/quaternion.hpp>
 
 #include <cstdint>
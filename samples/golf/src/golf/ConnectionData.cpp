@@ -27,8 +27,9 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
-#include "SharedStateData.hpp"
-#include "CommonConsts.hpp"
+#include "ConnectionData.hpp"
+
+#include <cstring>
 
 struct PacketHeader final
 {
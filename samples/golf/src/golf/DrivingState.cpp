@@ -2143,7 +2143,7 @@ void DrivingState::createFoliage(cro::Entity terrainEnt)
     for (auto i = 0u; i < vaos.size(); ++i)
     {
         glCheck(glBindVertexArray(vaos[i]));
-        glCheck(glDrawElements(GL_TRIANGLES, meshData.indexData[i].indexCount, GL_UNSIGNED_INT, 0));
+        glCheck(glDrawElements(GL_TRIANGLES, meshData.indexData[i].indexCount, meshData.indexData[i].format, 0));
     }
     normalMap.display();
 
@@ -29,6 +29,7 @@ source distribution.
 
 #pragma once
 
+#include "GameplayConsts.hpp"
 #include "Terrain.hpp"
 #include "MenuConsts.hpp"
 #include "SharedStateData.hpp"
@@ -63,15 +64,6 @@ source distribution.
 #include <iomanip>
 #include <array>
 
-static inline constexpr float ToYards = 1.09361f;
-
-static inline constexpr std::int32_t CrowdDensityCount = 4;
-//decreased for each additional player to a minimum of 2
-//so max is actually 4 because we always have at least 2 players
-static inline constexpr std::uint8_t StartLives = 6;
-static inline constexpr std::uint8_t MaxNTPStrokes = 2; //nearest the pin
-static inline constexpr std::int32_t CareerLeagueThreshold = 6; //placing higher than this unlocks next league
-
 static constexpr float MaxBallRadius = 0.07f;
 static constexpr float GreenCamRadiusLarge = 45.f;
 static constexpr float GreenCamRadiusMedium = 10.f;
@@ -87,9 +79,6 @@ static constexpr glm::vec3 FlightCamOffset = glm::vec3(0.f, 0.098f, 0.f);
 static constexpr float MinFlightCamDistance = 0.132f;
 static constexpr float FlightCamRotation = -0.158f;
 
-//static constexpr glm::uvec2 MapSize(320u, 200u);//320,200
-static constexpr glm::uvec2 MapSize(560u, 320u);
-static constexpr glm::vec2 MapSizeFloat(MapSize);
 static constexpr glm::vec2 RangeSize(200.f, 250.f);
 static constexpr float MaxSubTarget = (MapSize.x * 2.f) * (MapSize.x * 2.f); //used to validate the sub-target property of a hole
 static constexpr glm::uvec2 MiniMapSize(320u, 200u);
@@ -125,12 +114,6 @@ static constexpr float MaxHook = -0.25f;
 static constexpr float KnotsPerMetre = 1.94384f;
 static constexpr float MPHPerMetre = 2.23694f;
 static constexpr float KPHPerMetre = 3.6f;
-static constexpr float HoleRadius = 0.058f;
-
-static constexpr float WaterLevel = -0.02f;
-static constexpr float TerrainLevel = WaterLevel - 0.48f;// 0.03f;
-static constexpr float MaxTerrainHeight = 5.f;// 4.5f;
-
 static constexpr float FlagRaiseDistance = 3.f * 3.f;
 static constexpr float PlayerShadowOffset = 0.04f;
 
@@ -168,27 +151,6 @@ static constexpr glm::vec3 PreviewHairOffset(0.f, -0.29f, -0.008f);
 
 static constexpr float MinMusicVolume = 0.001f;
 
-class btVector3;
-glm::vec3 btToGlm(btVector3 v);
-btVector3 glmToBt(glm::vec3 v);
-
-struct WeatherType final
-{
-    enum
-    {
-        Clear, Rain, Showers, Mist,
-        Random,
-        Count,
-        Snow
-    };
-};
-static inline const std::array<cro::String, WeatherType::Count> WeatherStrings =
-{
-    "Clear", "Rain",
-    "Showers", "Mist",
-    "Random"
-};
-
 struct MRTIndex final
 {
     enum
@@ -321,19 +283,6 @@ struct ShaderID final
     };
 };
 
-struct AnimationID final
-{
-    enum
-    {
-        Idle, Swing, Chip, Putt,
-        Celebrate, Disappoint,
-        Impatient, IdleStand,
-        Count,
-
-    };
-    static constexpr std::size_t Invalid = std::numeric_limits<std::size_t>::max();
-};
-
 struct SkipState final
 {
     std::int32_t state = -1;
@@ -360,20 +309,6 @@ static inline std::int32_t courseOfTheMonth()
     return 9 + (cro::SysTime::now().months() % 3);
 }
 
-static inline float getWindMultiplier(float ballHeight, float distanceToPin)
-{
-    //this is the distance to the pin before the wind stops affecting the ball
-    static constexpr float MinWind = 10.f;
-    static constexpr float MaxWind = 32.f;
-
-    static constexpr float MinHeight = 26.f;// 40.f;
-    static constexpr float MaxHeight = 40.f;// 50.f;
-    const float HeightMultiplier = std::clamp((ballHeight - MinHeight) / (MaxHeight - MinHeight), 0.f, 1.f);
-    
-    float multiplier = std::clamp((distanceToPin - MinWind) / (MaxWind - MinWind), 0.f, 1.f);
-    return cro::Util::Easing::easeInCubic(multiplier) * (0.5f + (0.5f * HeightMultiplier));
-}
-
 static inline std::int32_t activeControllerID(std::int32_t bestMatch)
 {
     /*
@@ -403,31 +338,6 @@ static inline std::int32_t activeControllerID(std::int32_t bestMatch)
 
 bool hasPSLayout(std::int32_t controllerID);
 
-template <typename T>
-constexpr T interpolate(T a, T b, float t)
-{
-    auto diff = b - a;
-    return a + (diff * t);
-}
-
-template <typename T>
-constexpr T step(T s, T v)
-{
-    return v < s ? static_cast<T>(0) : static_cast<T>(1);
-}
-
-//WHY do I keep defining this? (It's also in Util::Maths) - the std library has this
-static inline constexpr float clamp(float t)
-{
-    return std::min(1.f, std::max(0.f, t));
-}
-
-static inline constexpr float smoothstep(float edge0, float edge1, float x)
-{
-    float t = clamp((x - edge0) / (edge1 - edge0));
-    return t * t * (3.f - 2.f * t);
-}
-
 static inline cro::FloatRect getAvatarBounds(std::uint8_t player)
 {
     cro::FloatRect bounds = { 0.f, LabelTextureSize.y - (LabelIconSize.x * 4.f), LabelIconSize.x, LabelIconSize.y };
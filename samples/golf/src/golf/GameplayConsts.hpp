@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/core/String.hpp>
+#include <crogine/util/Easings.hpp>
+#include <crogine/detail/glm/vec2.hpp>
+#include <crogine/detail/glm/vec3.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/*
+Gameplay and physics constants shared by the client and the server.
+This should only include headers available to headless builds
+so that it can be used by the dedicated server. Anything which
+requires graphics, audio or input belongs in GameConsts.hpp
+*/
+
+static inline constexpr float ToYards = 1.09361f;
+
+static inline constexpr std::int32_t CrowdDensityCount = 4;
+//decreased for each additional player to a minimum of 2
+//so max is actually 4 because we always have at least 2 players
+static inline constexpr std::uint8_t StartLives = 6;
+static inline constexpr std::uint8_t MaxNTPStrokes = 2; //nearest the pin
+static inline constexpr std::int32_t CareerLeagueThreshold = 6; //placing higher than this unlocks next league
+
+//static constexpr glm::uvec2 MapSize(320u, 200u);//320,200
+static constexpr glm::uvec2 MapSize(560u, 320u);
+static constexpr glm::vec2 MapSizeFloat(MapSize);
+
+static constexpr float HoleRadius = 0.058f;
+
+static constexpr float WaterLevel = -0.02f;
+static constexpr float TerrainLevel = WaterLevel - 0.48f;// 0.03f;
+static constexpr float MaxTerrainHeight = 5.f;// 4.5f;
+
+class btVector3;
+glm::vec3 btToGlm(btVector3 v);
+btVector3 glmToBt(glm::vec3 v);
+
+struct WeatherType final
+{
+    enum
+    {
+        Clear, Rain, Showers, Mist,
+        Random,
+        Count,
+        Snow
+    };
+};
+static inline const std::array<cro::String, WeatherType::Count> WeatherStrings =
+{
+    "Clear", "Rain",
+    "Showers", "Mist",
+    "Random"
+};
+
+struct AnimationID final
+{
+    enum
+    {
+        Idle, Swing, Chip, Putt,
+        Celebrate, Disappoint,
+        Impatient, IdleStand,
+        Count,
+
+    };
+    static constexpr std::size_t Invalid = std::numeric_limits<std::size_t>::max();
+};
+
+static inline float getWindMultiplier(float ballHeight, float distanceToPin)
+{
+    //this is the distance to the pin before the wind stops affecting the ball
+    static constexpr float MinWind = 10.f;
+    static constexpr float MaxWind = 32.f;
+
+    static constexpr float MinHeight = 26.f;// 40.f;
+    static constexpr float MaxHeight = 40.f;// 50.f;
+    const float HeightMultiplier = std::clamp((ballHeight - MinHeight) / (MaxHeight - MinHeight), 0.f, 1.f);
+    
+    float multiplier = std::clamp((distanceToPin - MinWind) / (MaxWind - MinWind), 0.f, 1.f);
+    return cro::Util::Easing::easeInCubic(multiplier) * (0.5f + (0.5f * HeightMultiplier));
+}
+
+template <typename T>
+constexpr T interpolate(T a, T b, float t)
+{
+    auto diff = b - a;
+    return a + (diff * t);
+}
+
+template <typename T>
+constexpr T step(T s, T v)
+{
+    return v < s ? static_cast<T>(0) : static_cast<T>(1);
+}
+
+//WHY do I keep defining this? (It's also in Util::Maths) - the std library has this
+static inline constexpr float clamp(float t)
+{
+    return std::min(1.f, std::max(0.f, t));
+}
+
+static inline constexpr float smoothstep(float edge0, float edge1, float x)
+{
+    float t = clamp((x - edge0) / (edge1 - edge0));
+    return t * t * (3.f - 2.f * t);
+}
@@ -206,7 +206,8 @@ GolfState::GolfState(cro::StateStack& stack, cro::State::Context context, Shared
     m_scoreColumnCount      (2),
     m_readyQuitFlags        (0),
     m_courseIndex           (getCourseIndex(sd.mapDirectory.toAnsiString())),
-    m_emoteWheel            (sd, m_currentPlayer, m_textChat)
+    m_emoteWheel            (sd, m_currentPlayer, m_textChat),
+    m_actorSnapshots        (ActorSnapshot::createSchema())
 {
     if (sd.weatherType == WeatherType::Random)
     {
@@ -4928,6 +4929,9 @@ void GolfState::handleNetEvent(const net::NetEvent& evt)
         case PacketID::ActorUpdate:
             updateActor(evt.packet.as<ActorInfo>());
             break;
+        case PacketID::ActorSnapshot:
+            updateActors(evt.packet);
+            break;
         case PacketID::ActorAnimation:
         {
             if (m_activeAvatar)
@@ -6717,6 +6721,23 @@ void GolfState::hitBall()
     }
 }
 
+void GolfState::updateActors(const net::NetEvent::Packet& packet)
+{
+    //returns false for late or corrupt packets, in which
+    //case we wait for the next one to arrive
+    if (m_actorSnapshots.decode(packet.getData(), packet.getSize()))
+    {
+        //let the server know it can send the next update as a delta of this one
+        m_sharedData.clientConnection.netClient.sendPacket(PacketID::SnapshotAck, m_actorSnapshots.getSequence(), net::NetFlag::Unreliable);
+
+        const auto& snapshot = m_actorSnapshots.getSnapshot();
+        for (auto i = 0u; i < snapshot.getEntityCount(); ++i)
+        {
+            updateActor(ActorSnapshot::read(snapshot, i));
+        }
+    }
+}
+
 void GolfState::updateActor(const ActorInfo& update)
 {
     cro::Command cmd;
@@ -357,6 +357,7 @@ private:
     void predictBall(float);
     void hitBall();
     void updateActor(const ActorInfo&);
+    void updateActors(const net::NetEvent::Packet&);
     void remoteRotation(std::uint32_t); //rotates the avatar based on remote player input
     std::int32_t getClub() const;
 
@@ -615,6 +616,10 @@ private:
     }m_emoteWheel;
     void showEmote(std::uint32_t);
 
+    //ball updates from the server, delta compressed
+    //against the last snapshot we acknowledged
+    cro::SnapshotDecoder m_actorSnapshots;
+
     //-----------
 
     cro::Entity m_mapCam;
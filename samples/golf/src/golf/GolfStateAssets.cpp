@@ -37,6 +37,8 @@ source distribution.
 #include "Career.hpp"
 #include "AvatarRotationSystem.hpp"
 
+#include <crogine/core/AsyncLoader.hpp>
+
 #include <crogine/ecs/components/CommandTarget.hpp>
 #include <crogine/ecs/components/ParticleEmitter.hpp>
 
@@ -467,6 +469,28 @@ void GolfState::loadMap()
     cro::AudioScape propAudio;
     propAudio.loadFromFile("assets/golf/sound/props.xas", m_resources.audio);
 
+    //decode all the hole models in parallel up front, so that
+    //loading them below only has to create the materials
+    {
+        std::vector<std::string> preloadPaths;
+        for (const auto& hole : holeStrings)
+        {
+            if (holeCfg.loadFromFile(hole))
+            {
+                if (const auto* prop = holeCfg.findProperty("model"); prop)
+                {
+                    auto path = prop->getValue<std::string>();
+                    if (std::find(preloadPaths.begin(), preloadPaths.end(), path) == preloadPaths.end())
+                    {
+                        modelDef.preloadAsync(path);
+                        preloadPaths.push_back(path);
+                    }
+                }
+            }
+        }
+        cro::AsyncLoader::finish();
+    }
+
     for (const auto& hole : holeStrings)
     {
         if (!cro::FileSystem::fileExists(cro::FileSystem::getResourcePath() + hole))
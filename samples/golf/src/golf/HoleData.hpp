@@ -30,7 +30,7 @@ source distribution.
 #pragma once
 
 #include "Path.hpp"
-#include "GameConsts.hpp"
+#include "GameplayConsts.hpp"
 
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/util/Spline.hpp>
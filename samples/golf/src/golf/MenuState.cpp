@@ -2457,6 +2457,14 @@ void MenuState::handleNetEvent(const net::NetEvent& evt)
             m_readyState[idx] = (data & 0x00ff) ? true : false;
         }
             break;
+        case PacketID::HostChanged:
+            //only sent by dedicated servers, where the lobby
+            //is run by one of the connected clients
+            if (!m_sharedData.serverInstance.running())
+            {
+                m_sharedData.hosting = evt.packet.as<std::uint8_t>() == m_sharedData.clientConnection.connectionID;
+            }
+            break;
         case PacketID::MapInfo:
         {
             //check we have the local data (or at least something with the same name)
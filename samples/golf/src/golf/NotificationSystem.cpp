@@ -44,6 +44,9 @@ NotificationSystem::NotificationSystem(cro::MessageBus& mb)
 {
     requireComponent<cro::Text>();
     requireComponent<Notification>();
+
+    //notifications are displayed in the order they were posted
+    setPreserveOrder(true);
 }
 
 //public
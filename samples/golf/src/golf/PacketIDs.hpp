@@ -237,7 +237,12 @@ namespace PacketID
         ChatMessage, //TextMessage struct
         DronePosition, //< compressed vec3 from host rebroadcast to clients
         ClubChanged, //< updates putt cam on remote clients: uint8 club | uint8 client
-        AvatarRotation //uin32_t client | player | finalRotation compressed as int16
+        AvatarRotation, //uin32_t client | player | finalRotation compressed as int16
+
+        //appended so that existing IDs keep their values
+        ActorSnapshot, //< FROM server, delta compressed cro::Snapshot of ActorInfo for all active balls, see ActorSnapshot
+        SnapshotAck, //< FROM client, uint32 sequence of the last ActorSnapshot received
+        HostChanged //< FROM dedicated server, uint8 ID of the client which now runs the lobby
     };
 }
 
@@ -31,7 +31,6 @@ source distribution.
 #include "PlayerColours.hpp"
 #include "GameConsts.hpp"
 #include "spooky2.hpp"
-#include "server/ServerState.hpp"
 
 #include <Social.hpp>
 #include <crogine/core/SysTime.hpp>
@@ -39,28 +38,6 @@ source distribution.
 
 #include <crogine/graphics/ImageArray.hpp>
 
-PlayerData& PlayerData::operator=(const sv::PlayerInfo& pi)
-{
-    name = pi.name;
-    avatarFlags = pi.avatarFlags;
-    ballColourIndex = pi.ballColourIndex;
-    ballID = pi.ballID;
-    hairID = pi.hairID;
-    hatID = pi.hatID;
-    skinID = pi.skinID;
-    flipped = pi.flipped;
-    isCPU = pi.isCPU;
-
-    headwearOffsets = pi.headwearOffsets;
-
-    if (hatID == hairID)
-    {
-        hatID = 0;
-    }
-
-    return *this;
-}
-
 bool PlayerData::saveProfile() const
 {   
     cro::ConfigFile cfg("avatar");
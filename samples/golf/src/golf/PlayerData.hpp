@@ -35,12 +35,15 @@ source distribution.
 #include <crogine/graphics/Colour.hpp>
 #include <crogine/graphics/Image.hpp>
 #include <crogine/graphics/ImageArray.hpp>
-#include <crogine/graphics/Texture.hpp>
-#include <crogine/graphics/MaterialData.hpp>
 #include <crogine/detail/glm/vec3.hpp>
 
 #include <crogine/util/Random.hpp>
 
+#ifndef CRO_HEADLESS
+#include <crogine/graphics/Texture.hpp>
+#include <crogine/graphics/MaterialData.hpp>
+#endif
+
 #include <array>
 #include <memory>
 
@@ -121,6 +124,7 @@ struct PlayerData final
     }
 };
 
+#ifndef CRO_HEADLESS
 struct ProfileTexture
 {
     explicit ProfileTexture(const std::string&);
@@ -145,4 +149,5 @@ private:
     std::array<std::vector<std::uint32_t>, pc::ColourKey::Count> m_keyIndices;
 
     std::array<cro::Colour, pc::ColourKey::Count> m_colours;
-};
\ No newline at end of file
+};
+#endif
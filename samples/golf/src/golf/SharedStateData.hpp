@@ -29,6 +29,7 @@ source distribution.
 
 #pragma once
 
+#include "ConnectionData.hpp"
 #include "InputBinding.hpp"
 #include "Networking.hpp"
 #include "CommonConsts.hpp"
@@ -60,22 +61,6 @@ struct ChatFonts final
     float buttonHeight = 26.f;
 };
 
-struct ConnectionData final
-{
-    std::uint64_t peerID = 0;
-
-    std::uint8_t connectionID = ConstVal::NullValue;
-
-    std::uint8_t playerCount = 1;
-    std::array<PlayerData, ConstVal::MaxPlayers> playerData = {};
-
-    std::uint32_t pingTime = 0;
-    std::uint8_t level = 0;
-
-    std::vector<std::uint8_t> serialise() const;
-    bool deserialise(const net::NetEvent::Packet&);
-};
-
 static constexpr float MinFOV = 60.f;
 static constexpr float MaxFOV = 90.f;
 
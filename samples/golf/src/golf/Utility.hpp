@@ -32,9 +32,13 @@ source distribution.
 #include "CommonConsts.hpp"
 
 #include <crogine/core/String.hpp>
-#include <crogine/core/Keyboard.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/network/NetData.hpp>
+#include <crogine/detail/glm/gtx/norm.hpp>
+
+#ifndef CRO_HEADLESS
+#include <crogine/core/Keyboard.hpp>
+#endif
 
 #include <vector>
 #include <cstring>
@@ -101,6 +105,7 @@ static inline glm::mat4 lookFrom(const glm::vec3& eye, const glm::vec3 centre, c
     return Result;
 }
 
+#ifndef CRO_HEADLESS
 //some stuff for quick debugging cameras / lights etc
 struct KeyID final
 {
@@ -165,4 +170,5 @@ static inline bool rotateEntity(cro::Entity entity, std::int32_t keysetID, float
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+#endif
@@ -32,17 +32,12 @@ source distribution.
 
 #include <crogine/util/Random.hpp>
 
-namespace
-{
-    std::array<cro::Time, 10> Times = { };
-}
-
-WeatherDirector::WeatherDirector(net::NetHost& host)
+WeatherDirector::WeatherDirector(Host& host)
     : m_host        (host),
     m_weatherState  (0),
-    m_timeIndex     (cro::Util::Random::value(0u, Times.size() - 1))
+    m_timeIndex     (cro::Util::Random::value(0u, m_times.size() - 1))
 {
-    for (auto& t : Times)
+    for (auto& t : m_times)
     {
         t = cro::seconds(static_cast<float>(cro::Util::Random::value(50, 120)));
         //t = cro::seconds(static_cast<float>(cro::Util::Random::value(5, 12)));
@@ -57,10 +52,10 @@ void WeatherDirector::handleMessage(const cro::Message&)
 
 void WeatherDirector::process(float)
 {
-    if (m_timer.elapsed() > Times[m_timeIndex])
+    if (m_timer.elapsed() > m_times[m_timeIndex])
     {
         m_timer.restart();
-        m_timeIndex = (m_timeIndex + 1) % Times.size();
+        m_timeIndex = (m_timeIndex + 1) % m_times.size();
         m_weatherState = ~m_weatherState;
 
         m_host.broadcastPacket(PacketID::WeatherChange, m_weatherState, net::NetFlag::Reliable);
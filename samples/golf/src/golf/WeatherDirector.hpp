@@ -31,21 +31,33 @@ source distribution.
 
 #include "server/Networking.hpp"
 
+#ifdef CRO_HEADLESS
+#include "server/MatchHost.hpp"
+#endif
+
 #include <crogine/ecs/Director.hpp>
 #include <crogine/core/Clock.hpp>
 
+#include <array>
+
 class WeatherDirector final : public cro::Director
 {
 public:
-    explicit WeatherDirector(net::NetHost&);
+#ifdef CRO_HEADLESS
+    using Host = MatchHost;
+#else
+    using Host = net::NetHost;
+#endif
+    explicit WeatherDirector(Host&);
 
     void handleMessage(const cro::Message&) override;
 
     void process(float) override;
 
 private:
-    net::NetHost& m_host;
+    Host& m_host;
     std::uint8_t m_weatherState;
+    std::array<cro::Time, 10> m_times = {};
     std::size_t m_timeIndex;
 
     cro::Clock m_timer;
@@ -0,0 +1,148 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include "../Networking.hpp"
+#include "ServerState.hpp"
+
+#include <crogine/core/Clock.hpp>
+#include <crogine/core/HiResTimer.hpp>
+
+#include <memory>
+#include <vector>
+
+/*
+A single lobby and the games played by the clients which joined it.
+The Server runs one match on a host of its own, and dedicated servers
+run many matches which share a host with the ShardServer. A match is
+not thread safe, but different matches may be updated from different
+threads at the same time.
+*/
+class Match final
+{
+public:
+    struct GameMode final
+    {
+        enum
+        {
+            Golf, Billiards, None
+        };
+    };
+
+    Match();
+
+    Match(const Match&) = delete;
+    Match(Match&&) = delete;
+    Match& operator = (const Match&) = delete;
+    Match& operator = (Match&&) = delete;
+
+    //clears any previous match data and sets up a new match,
+    //returning false if the game mode is not valid
+    bool init(std::size_t maxConnections, std::int32_t gameMode, bool fastCPU);
+
+    //opens the lobby. The host in the shared data should be
+    //ready to send packets before this is called
+    void start();
+
+    //handles any event received from a client of this match
+    void netEvent(const net::NetEvent&);
+
+    //handles pending messages and runs any broadcasts or
+    //updates which are due. Returns false once the match has ended
+    bool update();
+
+    //returns the time in seconds from the last update()
+    //until the next broadcast or update is due
+    float getNextUpdate() const { return m_nextUpdate; }
+
+    //disconnects any clients and destroys the current state
+    void end();
+
+    //returns true if the match is in the lobby and has space for
+    //a client which is connecting with at least one player
+    bool acceptingClients() const;
+
+    std::size_t getMaxConnections() const { return m_maxConnections; }
+    std::int32_t getStateID() const;
+    std::int32_t getPlayerCount() const { return m_playerCount; }
+    std::size_t getClientCount() const { return m_clientCount; }
+
+    sv::SharedData& getSharedData() { return m_sharedData; }
+    const sv::SharedData& getSharedData() const { return m_sharedData; }
+
+private:
+    std::size_t m_maxConnections;
+    std::unique_ptr<sv::State> m_currentState;
+    std::int32_t m_gameMode;
+    //depending on the game mode we ask the client for how many players
+    //it has and reject or accept the client based on there being enough room
+    std::int32_t m_maxPlayers;
+    std::int32_t m_playerCount;
+
+    sv::SharedData m_sharedData;
+
+    struct PendingConnection final
+    {
+        net::NetPeer peer;
+        cro::Clock connectionTime;
+        static constexpr float Timeout = 15.f;
+    };
+    std::vector<PendingConnection> m_pendingConnections;
+
+    std::size_t m_clientCount;
+
+    //network broadcasts are called less regularly
+    //than logic updates to the scene
+    cro::Clock m_netFrameClock;
+    cro::Time m_netAccumulatedTime;
+
+    cro::HiResTimer m_updateClock;
+    float m_updateAccumulator;
+
+    cro::Clock m_pingClock;
+    cro::Time m_pingAccumulator;
+
+    float m_nextUpdate;
+
+    void checkPending();
+    void validatePeer(const net::NetPeer&, std::uint8_t playerCount);
+
+    //returns slot index, or >= MaxClients if full
+    std::uint8_t addClient(const net::NetPeer&, std::uint8_t playerCount);
+    void removeClient(const net::NetEvent&);
+    void removeClient(std::size_t);
+    void kickClient(std::size_t);
+
+#ifdef CRO_HEADLESS
+    //makes the first connected client the lobby host and
+    //tells all clients, or clears the host if none remain
+    void updateHost();
+#endif
+};
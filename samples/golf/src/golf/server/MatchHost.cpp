@@ -0,0 +1,135 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "MatchHost.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+//public
+void MatchHost::broadcastPacket(std::uint8_t id, const void* data, std::size_t size, cro::NetFlag flags, std::uint8_t channel) const
+{
+    queue({}, id, data, size, flags, channel, true);
+}
+
+void MatchHost::sendPacket(const cro::NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, cro::NetFlag flags, std::uint8_t channel) const
+{
+    if (peer)
+    {
+        queue(peer, id, data, size, flags, channel, false);
+    }
+}
+
+void MatchHost::disconnect(cro::NetPeer& peer)
+{
+    if (peer)
+    {
+        auto& cmd = m_commands.emplace_back();
+        cmd.type = Command::Disconnect;
+        cmd.peer = peer;
+        peer = {};
+    }
+}
+
+void MatchHost::disconnectLater(cro::NetPeer& peer)
+{
+    if (peer)
+    {
+        auto& cmd = m_commands.emplace_back();
+        cmd.type = Command::DisconnectLater;
+        cmd.peer = peer;
+        peer = {};
+    }
+}
+
+void MatchHost::addPeer(const cro::NetPeer& peer)
+{
+    if (std::find(m_peers.begin(), m_peers.end(), peer) == m_peers.end())
+    {
+        m_peers.push_back(peer);
+    }
+}
+
+void MatchHost::removePeer(const cro::NetPeer& peer)
+{
+    m_peers.erase(std::remove(m_peers.begin(), m_peers.end(), peer), m_peers.end());
+}
+
+void MatchHost::flush(cro::NetHost& host)
+{
+    for (auto& cmd : m_commands)
+    {
+        const auto* data = m_data.data() + cmd.offset;
+        switch (cmd.type)
+        {
+        default: break;
+        case Command::Send:
+            host.sendPacket(cmd.peer, cmd.id, data, cmd.size, cmd.flags, cmd.channel);
+            break;
+        case Command::Broadcast:
+            //a NetHost only broadcasts to connected peers, so skip
+            //any which were disconnected by an earlier command
+            for (const auto& peer : m_peers)
+            {
+                if (peer.getState() == cro::NetPeer::State::Connected)
+                {
+                    host.sendPacket(peer, cmd.id, data, cmd.size, cmd.flags, cmd.channel);
+                }
+            }
+            break;
+        case Command::Disconnect:
+            host.disconnect(cmd.peer);
+            break;
+        case Command::DisconnectLater:
+            host.disconnectLater(cmd.peer);
+            break;
+        }
+    }
+    m_commands.clear();
+    m_data.clear();
+}
+
+//private
+void MatchHost::queue(const cro::NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, cro::NetFlag flags, std::uint8_t channel, bool broadcast) const
+{
+    auto& cmd = m_commands.emplace_back();
+    cmd.type = broadcast ? Command::Broadcast : Command::Send;
+    cmd.peer = peer;
+    cmd.flags = flags;
+    cmd.id = id;
+    cmd.channel = channel;
+    cmd.offset = m_data.size();
+    cmd.size = size;
+
+    if (size != 0)
+    {
+        m_data.resize(m_data.size() + size);
+        std::memcpy(m_data.data() + cmd.offset, data, size);
+    }
+}
@@ -0,0 +1,96 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/network/NetData.hpp>
+#include <crogine/network/NetHost.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/*
+Used in place of a NetHost by each of the matches run by the ShardServer.
+Matches are updated in parallel so rather than sending packets directly
+they are queued, then sent on the thread which owns the shared NetHost
+once all the matches have been updated. Broadcasts are only sent to the
+peers which have been routed to this match.
+*/
+class MatchHost final
+{
+public:
+    template <typename T>
+    void broadcastPacket(std::uint8_t id, const T& data, cro::NetFlag flags, std::uint8_t channel = 0) const
+    {
+        broadcastPacket(id, &data, sizeof(T), flags, channel);
+    }
+
+    void broadcastPacket(std::uint8_t id, const void* data, std::size_t size, cro::NetFlag flags, std::uint8_t channel = 0) const;
+
+    template <typename T>
+    void sendPacket(const cro::NetPeer& peer, std::uint8_t id, const T& data, cro::NetFlag flags, std::uint8_t channel = 0) const
+    {
+        sendPacket(peer, id, &data, sizeof(T), flags, channel);
+    }
+
+    void sendPacket(const cro::NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, cro::NetFlag flags, std::uint8_t channel = 0) const;
+
+    void disconnect(cro::NetPeer& peer);
+    void disconnectLater(cro::NetPeer& peer);
+
+    //adds or removes a peer which will receive this match's broadcasts
+    void addPeer(const cro::NetPeer& peer);
+    void removePeer(const cro::NetPeer& peer);
+    const std::vector<cro::NetPeer>& getPeers() const { return m_peers; }
+
+    //sends everything queued since the last flush via the given host
+    void flush(cro::NetHost& host);
+
+private:
+    std::vector<cro::NetPeer> m_peers;
+
+    struct Command final
+    {
+        enum
+        {
+            Send, Broadcast, Disconnect, DisconnectLater
+        }type = Send;
+
+        cro::NetPeer peer;
+        cro::NetFlag flags = cro::NetFlag::Reliable;
+        std::uint8_t id = 0;
+        std::uint8_t channel = 0;
+        std::size_t offset = 0; //into m_data
+        std::size_t size = 0;
+    };
+    mutable std::vector<Command> m_commands;
+    mutable std::vector<std::uint8_t> m_data;
+
+    void queue(const cro::NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, cro::NetFlag flags, std::uint8_t channel, bool broadcast) const;
+};
@@ -27,35 +27,15 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
-#include "../PacketIDs.hpp"
-
 #include "Server.hpp"
-#include "ServerGolfState.hpp"
-#include "ServerLobbyState.hpp"
-#include "ServerBilliardsState.hpp"
-#include "ServerMessages.hpp"
 
 #include <crogine/core/Log.hpp>
-#include <crogine/core/Clock.hpp>
-#include <crogine/core/HiResTimer.hpp>
-
-#include <Social.hpp>
 
-#include <functional>
-
-namespace
-{
-    constexpr std::int32_t MaxGolfPlayers = 16;
-    constexpr std::int32_t MaxBilliardsPlayers = 2;
-}
+#include <chrono>
 
 Server::Server()
-    : m_maxConnections  (ConstVal::MaxClients),
-    m_running           (false),
-    m_gameMode          (GameMode::None),
-    m_maxPlayers        (MaxGolfPlayers),
-    m_playerCount       (0),
-    m_clientCount       (0)
+    : m_port    (ConstVal::GamePort),
+    m_running   (false)
 {
 
 }
@@ -69,35 +49,18 @@ Server::~Server()
 }
 
 //public
-void Server::launch(std::size_t maxConnections, std::int32_t gameMode, bool fastCPU)
+void Server::launch(std::size_t maxConnections, std::int32_t gameMode, bool fastCPU, std::uint16_t port)
 {
     //stop any existing instance first
     stop();
 
-    //clear out any old messages
-    while (!m_sharedData.messageBus.empty())
+    if (!m_match.init(maxConnections, gameMode, fastCPU))
     {
-        m_sharedData.messageBus.poll();
-    }
-
-    m_maxConnections = std::max(std::size_t(1u), std::min(std::size_t(ConstVal::MaxClients), maxConnections));
-    m_gameMode = gameMode;
-
-    switch (gameMode)
-    {
-    default: 
-        stop();
         LogE << "Invalid Game Mode: Quitting Server" << std::endl;
         return;
-    case GameMode::Golf:
-        m_maxPlayers = MaxGolfPlayers;
-        break;
-    case GameMode::Billiards:
-        m_maxPlayers = MaxBilliardsPlayers;
-        break;
     }
 
-    m_sharedData.fastCPU = fastCPU;
+    m_port = port;
     m_running = true;
     m_thread = std::make_unique<std::thread>(&Server::run, this);
 }
@@ -111,8 +74,6 @@ void Server::stop()
 
         m_thread.reset();
     }
-    m_gameMode = GameMode::None;
-    m_playerCount = 0;
 }
 
 bool Server::addLocalConnection(net::NetClient& client)
@@ -123,7 +84,7 @@ bool Server::addLocalConnection(net::NetClient& client)
         LOG("Server not running", cro::Logger::Type::Error);
         return false;
     }
-    return m_sharedData.host.addLocalConnection(client);
+    return m_match.getSharedData().host.addLocalConnection(client);
 #else
     return false;
 #endif
@@ -145,349 +106,79 @@ bool Server::addLocalVoiceConnection(net::NetClient& client)
 
 void Server::setHostID(std::uint64_t id)
 {
-    m_sharedData.hostID = id;
+    m_match.getSharedData().hostID = id;
 }
 
 void Server::setLeagueID(std::int32_t id)
 {
-    m_sharedData.leagueID = id;
+    m_match.getSharedData().leagueID = id;
 }
 
 //private
 void Server::run()
 {
-    if (!m_sharedData.host.start("", ConstVal::GamePort, m_maxConnections, 4))
+    auto& host = m_match.getSharedData().host;
+    if (!host.start("", m_port, m_match.getMaxConnections(), 4))
     {
         m_running = false;
         cro::Logger::log("Failed to start host service", cro::Logger::Type::Error);
         return;
     }    
     
-    if (!m_voiceHost.start(ConstVal::VoicePort))
+#ifndef USE_GNS
+    //each net frame sends many small packets to
+    //every client, so send them as a single packet
+    host.setBatchingEnabled(true);
+#endif
+
+    if (!m_voiceHost.start(m_port + (ConstVal::VoicePort - ConstVal::GamePort)))
     {
         LogW << "Unable to start voice channel server" << std::endl;
     }
 
     LOG("Server launched", cro::Logger::Type::Info);
 
-    m_currentState = std::make_unique<sv::LobbyState>(m_sharedData);
-    std::int32_t nextState = m_currentState->stateID();
-
-    //network broadcasts are called less regularly
-    //than logic updates to the scene
-    const cro::Time netFrameTime = cro::milliseconds(50);
-    cro::Clock netFrameClock;
-    cro::Time netAccumulatedTime;
-
-    cro::HiResTimer updateClock;
-    float updateAccumulator = 0.f;
-
-    const cro::Time pingTime = cro::seconds(1.f);
-    cro::Clock pingClock;
-    cro::Time pingAccumulator;
+    m_match.start();
 
     while (m_running)
     {
         m_voiceHost.update();
 
-        while (!m_sharedData.messageBus.empty())
-        {
-            const auto& msg = m_sharedData.messageBus.poll();
-            m_currentState->handleMessage(msg);
-
-            if (msg.id == sv::MessageID::ConnectionMessage)
-            {
-                const auto& data = msg.getData<ConnectionEvent>();
-                if (data.type == ConnectionEvent::Kicked
-                    && data.clientID < ConstVal::MaxClients)
-                {
-                    kickClient(data.clientID);
-                }
-            }
-        }
-
         net::NetEvent evt;
-        while(m_sharedData.host.pollEvent(evt))
-        {
-            m_currentState->netEvent(evt);
-        
-            //handle connects / disconnects
-            if (evt.type == net::NetEvent::ClientConnect)
-            {
-                //refuse if not in lobby state
-                //else add to pending list and await version confirmation
-                if (m_currentState->stateID() == sv::StateID::Lobby)
-                {
-                    m_pendingConnections.emplace_back().peer = evt.peer;
-                    m_sharedData.host.sendPacket(evt.peer, PacketID::ClientVersion, std::uint16_t(m_gameMode), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-                }
-                else
-                {
-                    //send rejection packet
-                    m_sharedData.host.sendPacket(evt.peer, PacketID::ConnectionRefused, std::uint8_t(MessageType::NotInLobby), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-                    m_sharedData.host.disconnectLater(evt.peer);
-                }
-            }
-            else if (evt.type == net::NetEvent::ClientDisconnect)
-            {
-                //remove from client list
-                removeClient(evt);
-            }
-            else if(evt.type == net::NetEvent::PacketReceived)
-            {
-                switch (evt.packet.getID())
-                {
-                default: break;
-                case PacketID::AchievementGet:
-                    //re-broadcast to all clients
-                    m_sharedData.host.broadcastPacket(PacketID::AchievementGet, evt.packet.as<std::array<std::uint8_t, 2u>>(), net::NetFlag::Reliable);
-                    break;
-                case PacketID::ClientVersion:
-                {
-                    auto clientVer = evt.packet.as<std::uint16_t>();
-                    if (clientVer != CURRENT_VER)
-                    {
-                        m_sharedData.host.sendPacket(evt.peer, PacketID::ConnectionRefused, std::uint8_t(MessageType::VersionMismatch), net::NetFlag::Reliable);
-                        LogE << "Client responded with version " << clientVer << ", server is " << CURRENT_VER << std::endl;
-                    }
-                    else
-                    {
-                        m_sharedData.host.sendPacket(evt.peer, PacketID::ClientPlayerCount, std::uint8_t(0), net::NetFlag::Reliable);
-                    }
-                }
-                    break;
-                case PacketID::ClientPlayerCount:
-                    validatePeer(evt.peer, evt.packet.as<std::uint8_t>());
-                    break;
-                case PacketID::PlayerXP:
-                    m_sharedData.host.broadcastPacket(PacketID::PlayerXP, evt.packet.as<std::uint16_t>(), net::NetFlag::Reliable);
-                    break;
-                case PacketID::CAT:
-                    m_sharedData.host.broadcastPacket(PacketID::CAT, std::uint8_t(0), net::NetFlag::Reliable);
-                    break;
-                case PacketID::ChatMessage:
-                {
-                    //TODO there ought to be an overload for perfect forwarding a packet...
-                    m_sharedData.host.broadcastPacket(PacketID::ChatMessage, evt.packet.as<TextMessage>(), net::NetFlag::Reliable, ConstVal::NetChannelStrings);
-                }
-                    break;
-                }
-            }
-        }
-
-        checkPending();
-
-        //TODO fix this - we have to wait for at least
-        //one connection to happen first
-        
-        //m_running = m_clientCount != 0;
-
-        //network broadcasts
-        netAccumulatedTime += netFrameClock.restart();
-        while (netAccumulatedTime > netFrameTime)
+        while (host.pollEvent(evt))
         {
-            netAccumulatedTime -= netFrameTime;
-            m_currentState->netBroadcast();
+            m_match.netEvent(evt);
         }
 
-        //logic updates
-        updateAccumulator += updateClock.restart();
-        while (updateAccumulator > ConstVal::FixedGameUpdate)
+        if (!m_match.update())
         {
-            updateAccumulator -= ConstVal::FixedGameUpdate;
-            nextState = m_currentState->process(ConstVal::FixedGameUpdate);
+            m_running = false;
+            break;
         }
 
-        //broadcast connection quality
-        pingAccumulator += pingClock.restart();
-        while (pingAccumulator > pingTime)
+        if (const auto nextUpdate = m_match.getNextUpdate(); nextUpdate > 0.f)
         {
-            pingAccumulator -= pingTime;
-            for (auto i = 0u; i < m_sharedData.clients.size(); ++i)
-            {
-                if (m_sharedData.clients[i].connected)
-                {
-                    std::uint16_t client = i;
-                    std::uint16_t ping = m_sharedData.clients[i].peer.getRoundTripTime();
-                    std::uint32_t data = (client << 16) | ping;
-                    m_sharedData.host.broadcastPacket(PacketID::PingTime, data, net::NetFlag::Unreliable);
-                }
-            }
-        }
-
-        //switch state if last update returned a new state ID
-        if (nextState != m_currentState->stateID())
-        {
-            switch (nextState)
+#ifdef USE_GNS
+            //sleep until the next update is due rather than spinning - anything
+            //received in the meantime is queued and handled before the update
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<std::int64_t>(nextUpdate * 1000000.f)));
+#else
+            //wait in the host service until the next update is due, so that
+            //anything received in the meantime is handled as soon as it
+            //arrives instead of at the end of a sleep. Match::update() only
+            //steps the simulation when a tick is due so waking early is fine.
+            if (host.pollEvent(evt, static_cast<std::uint32_t>(nextUpdate * 1000.f)))
             {
-            default: m_running = false; break;
-            case sv::StateID::Golf:
-                m_currentState = std::make_unique<sv::GolfState>(m_sharedData);
-                break;
-            case sv::StateID::Lobby:
-                m_currentState = std::make_unique<sv::LobbyState>(m_sharedData);
-                break;
-            case sv::StateID::Billiards:
-                m_currentState = std::make_unique<sv::BilliardsState>(m_sharedData);
-                break;
+                m_match.netEvent(evt);
             }
-
-            m_sharedData.host.broadcastPacket(PacketID::StateChange, std::uint8_t(nextState), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-            
-            //mitigate large DT which may have built up while new state was loading.
-            netFrameClock.restart();
+#endif
         }
     }
 
-    m_currentState.reset();
-
-    //clear client data
-    for (auto& c : m_sharedData.clients)
-    {
-        m_sharedData.host.disconnect(c.peer);
-        c = {};
-    }
+    m_match.end();
 
     m_voiceHost.stop();
-    m_sharedData.host.stop();
+    host.stop();
 
     LOG("Server quit", cro::Logger::Type::Info);
 }
-
-void Server::checkPending()
-{
-    for (auto& [peer, t] : m_pendingConnections)
-    {
-        if (t.elapsed().asSeconds() > PendingConnection::Timeout)
-        {
-            m_sharedData.host.sendPacket(peer, PacketID::ConnectionRefused, std::uint8_t(MessageType::VersionMismatch), net::NetFlag::Reliable);
-            m_sharedData.host.disconnectLater(peer);
-        }
-
-        //TODO regularly send another version request in case a packet was lost?
-    }
-
-    m_pendingConnections.erase(std::remove_if(m_pendingConnections.begin(), m_pendingConnections.end(), 
-        [](const PendingConnection& pc)
-        {
-            return pc.connectionTime.elapsed().asSeconds() > PendingConnection::Timeout;        
-        }), m_pendingConnections.end());
-}
-
-void Server::validatePeer(net::NetPeer& peer, std::uint8_t playerCount)
-{
-    auto result = std::find_if(m_pendingConnections.begin(), m_pendingConnections.end(),
-        [&peer](const PendingConnection& pc)
-        {
-            return pc.peer == peer;
-        });
-
-    if (result != m_pendingConnections.end())
-    {
-        if (auto i = addClient(peer, playerCount); i >= m_maxConnections)
-        {
-            //tell client server is full
-            m_sharedData.host.sendPacket(peer, PacketID::ConnectionRefused, std::uint8_t(MessageType::ServerFull), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-            m_sharedData.host.disconnectLater(peer);
-        }
-        else
-        {
-            //tell the client which player they are
-            m_sharedData.host.sendPacket(peer, PacketID::ConnectionAccepted, i, net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-        }
-
-        m_pendingConnections.erase(result);
-    }
-    else
-    {
-        //stray connection so boot it?
-    }
-}
-
-std::uint8_t Server::addClient(const net::NetPeer& peer, std::uint8_t playerCount)
-{
-    if (m_playerCount + playerCount <= m_maxPlayers)
-    {
-        std::uint8_t i = 0;
-        for (; i < m_sharedData.clients.size(); ++i)
-        {
-            if (!m_sharedData.clients[i].connected)
-            {
-                LOG("Added client to server with id " + std::to_string(peer.getID()), cro::Logger::Type::Info);
-
-                m_sharedData.clients[i].connected = true;
-                m_sharedData.clients[i].peer = peer;
-
-                //broadcast to all connected clients
-                //so they can update lobby view.
-                m_sharedData.host.broadcastPacket(PacketID::ClientConnected, i, net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-
-                auto* msg = m_sharedData.messageBus.post<ConnectionEvent>(sv::MessageID::ConnectionMessage);
-                msg->clientID = i;
-                msg->playerCount = playerCount;
-                msg->type = ConnectionEvent::Connected;
-
-                m_clientCount++;
-                m_playerCount += playerCount;
-
-                break;
-            }
-        }
-        return i;
-    }
-
-    return ConstVal::NullValue;
-}
-
-void Server::removeClient(const net::NetEvent& evt)
-{
-    //remove from pending connection in case client is quitting due to game mode mismatch
-    m_pendingConnections.erase(std::remove_if(m_pendingConnections.begin(), m_pendingConnections.end(),
-        [&evt](const PendingConnection& pc)
-        {
-            return pc.peer == evt.peer;
-        }), m_pendingConnections.end());
-
-    auto result = std::find_if(m_sharedData.clients.begin(), m_sharedData.clients.end(), 
-        [&evt](const sv::ClientConnection& c) 
-        {
-            return c.peer == evt.peer;
-        });
-
-    if (result != m_sharedData.clients.end())
-    {
-        removeClient(std::distance(m_sharedData.clients.begin(), result));
-    }
-}
-
-void Server::removeClient(std::size_t clientID)
-{
-    m_playerCount -= m_sharedData.clients[clientID].playerCount;
-
-    auto* msg = m_sharedData.messageBus.post<ConnectionEvent>(sv::MessageID::ConnectionMessage);
-    msg->clientID = static_cast<std::uint8_t>(clientID);
-    msg->playerCount = m_sharedData.clients[clientID].playerCount;
-    msg->type = ConnectionEvent::Disconnected;
-
-    m_sharedData.clients[clientID] = sv::ClientConnection(); //resets the data, setting 'connected' to false etc
-    m_sharedData.clubLevels[clientID] = 2; //reset this if quitting, else we might clamp to the level of a quit player
-
-    //broadcast to all connected clients
-    m_sharedData.host.broadcastPacket(PacketID::ClientDisconnected, static_cast<std::uint8_t>(clientID), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-    LOG("Client disconnected", cro::Logger::Type::Info);
-
-    m_clientCount--;
-}
-
-void Server::kickClient(std::size_t clientID)
-{
-    if (m_sharedData.clients[clientID].connected)
-    {
-        //we assume host is always 0...
-        auto& peer = m_sharedData.clients[clientID].peer;
-        m_sharedData.host.sendPacket(peer, PacketID::ConnectionRefused, std::uint8_t(MessageType::Kicked), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
-        m_sharedData.host.disconnectLater(peer);
-
-        removeClient(clientID);
-    }
-}
\ No newline at end of file
@@ -30,7 +30,7 @@ source distribution.
 #pragma once
 
 #include "../Networking.hpp"
-#include "ServerState.hpp"
+#include "Match.hpp"
 #include "ServerVoice.hpp"
 
 #include <atomic>
@@ -40,13 +40,7 @@ source distribution.
 class Server final
 {
 public:
-    struct GameMode final
-    {
-        enum
-        {
-            Golf, Billiards, None
-        };
-    };
+    using GameMode = Match::GameMode;
 
     Server();
     ~Server();
@@ -58,8 +52,9 @@ public:
 
     //max connections are not game mode dependent as the
     //tutorial shares a game mode with golf, but must be
-    //limited to a single connection.
-    void launch(std::size_t maxConnections, std::int32_t gameMode, bool fastCPU);
+    //limited to a single connection. The voice server is
+    //started on port + (VoicePort - GamePort)
+    void launch(std::size_t maxConnections, std::int32_t gameMode, bool fastCPU, std::uint16_t port = ConstVal::GamePort);
     bool running() const { return m_running; }
     void stop();
 
@@ -74,39 +69,13 @@ public:
 
 
 private:
-    std::size_t m_maxConnections;
+    std::uint16_t m_port;
     std::string m_preferredIP;
     std::atomic_bool m_running;
     std::unique_ptr<std::thread> m_thread;
 
-    std::unique_ptr<sv::State> m_currentState;
-    std::int32_t m_gameMode;
-    //depending on the game mode we ask the client for how many players
-    //it has and reject or accept the client based on there being enough room
-    std::int32_t m_maxPlayers;
-    std::int32_t m_playerCount;
-
-    sv::SharedData m_sharedData;
+    Match m_match;
     VoiceHost m_voiceHost;
 
-    struct PendingConnection final
-    {
-        net::NetPeer peer;
-        cro::Clock connectionTime;
-        static constexpr float Timeout = 15.f;
-    };
-    std::vector<PendingConnection> m_pendingConnections;
-
-    std::size_t m_clientCount;
-
     void run();
-
-    void checkPending();
-    void validatePeer(net::NetPeer&, std::uint8_t playerCount);
-
-    //returns slot index, or >= MaxClients if full
-    std::uint8_t addClient(const net::NetPeer&, std::uint8_t playerCount);
-    void removeClient(const net::NetEvent&);
-    void removeClient(std::size_t);
-    void kickClient(std::size_t);
 };
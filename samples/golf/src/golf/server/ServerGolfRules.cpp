@@ -30,7 +30,7 @@ source distribution.
 #include "../PacketIDs.hpp"
 #include "../BallSystem.hpp"
 #include "../Clubs.hpp"
-#include "../GameConsts.hpp"
+#include "../GameplayConsts.hpp"
 
 #include "CPUStats.hpp"
 #include "ServerMessages.hpp"
@@ -29,7 +29,7 @@ source distribution.
 
 #include "../PacketIDs.hpp"
 #include "../CommonConsts.hpp"
-#include "../GameConsts.hpp"
+#include "../GameplayConsts.hpp"
 #include "../ClientPacketData.hpp"
 #include "../BallSystem.hpp"
 #include "../Clubs.hpp"
@@ -45,6 +45,7 @@ source distribution.
 
 #include <crogine/core/Log.hpp>
 #include <crogine/core/ConfigFile.hpp>
+#include <crogine/core/FileSystem.hpp>
 
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/Callback.hpp>
@@ -68,9 +69,6 @@ namespace
     const cro::Time TurnTime = cro::seconds(90.f);
     const cro::Time WarnTime = cro::seconds(10.f);
 
-    bool hadTennisBounce = false;
-    bool hadWallBounce = false;
-
     //glm::vec3 randomOffset3()
     //{
     //    auto x = cro::Util::Random::value(0, 1) * 2;
@@ -102,7 +100,10 @@ GolfState::GolfState(SharedData& sd)
     m_currentHole           (0),
     m_skinsPot              (1),
     m_currentBest           (MaxStrokes),
-    m_randomTargetCount     (0)
+    m_randomTargetCount     (0),
+    m_hadTennisBounce       (false),
+    m_hadWallBounce         (false),
+    m_actorSnapshots        (ActorSnapshot::createSchema())
 {
     if (m_mapDataValid = validateMap(); m_mapDataValid)
     {
@@ -132,6 +133,8 @@ void GolfState::handleMessage(const cro::Message& msg)
         if (data.type == ConnectionEvent::Disconnected)
         {
             //disconnect notification packet is sent in Server
+            m_snapshotAcks[data.clientID] = 0;
+
             std::int32_t setNewPlayer = -1;
             auto& group = m_playerInfo[m_groupAssignments[data.clientID]];
             auto& playerInfo = group.playerInfo;
@@ -340,13 +343,13 @@ void GolfState::handleMessage(const cro::Message& msg)
                     sendAchievement(AchievementID::IntoOrbit, playerInfo[0].client, playerInfo[0].player);
                 }
 
-                if (hadTennisBounce && data.terrain == TerrainID::Fairway)
+                if (m_hadTennisBounce && data.terrain == TerrainID::Fairway)
                 {
                     //send tennis achievement
                     sendAchievement(AchievementID::CauseARacket, playerInfo[0].client, playerInfo[0].player);
                 }
 
-                if (hadWallBounce && (data.terrain == TerrainID::Rough || data.terrain == TerrainID::Green || data.terrain == TerrainID::Fairway))
+                if (m_hadWallBounce && (data.terrain == TerrainID::Rough || data.terrain == TerrainID::Green || data.terrain == TerrainID::Fairway))
                 {
                     sendAchievement(AchievementID::OffTheWall, playerInfo[0].client, playerInfo[0].player);
                 }
@@ -381,11 +384,11 @@ void GolfState::handleMessage(const cro::Message& msg)
             break;
         case TriggerID::TennisCourt:
             LogI << "Deuce!" << std::endl;
-            hadTennisBounce = true;
+            m_hadTennisBounce = true;
             break;
         case TriggerID::BackWall:
             LogI << "FORE" << std::endl;
-            hadWallBounce = true;
+            m_hadWallBounce = true;
             break;
         }
     }
@@ -492,6 +495,20 @@ void GolfState::netEvent(const net::NetEvent& evt)
         case PacketID::ServerCommand:
             doServerCommand(evt);
             break;
+        case PacketID::SnapshotAck:
+        {
+            //acks are unreliable so may arrive out of order
+            const auto ack = evt.packet.as<std::uint32_t>();
+            for (auto i = 0u; i < m_sharedData.clients.size(); ++i)
+            {
+                if (m_sharedData.clients[i].peer == evt.peer)
+                {
+                    m_snapshotAcks[i] = std::max(m_snapshotAcks[i], ack);
+                    break;
+                }
+            }
+        }
+            break;
         case PacketID::TransitionComplete:
         {
             auto clientID = evt.packet.as<std::uint8_t>();
@@ -523,37 +540,49 @@ void GolfState::netBroadcast()
     }
 
     //fetch ball ents and send updates to client
+    auto& snapshot = m_actorSnapshots.beginSnapshot(m_serverTime.elapsed().asMilliseconds());
     for (const auto& group : m_playerInfo)
     {
         for (const auto& player : group.playerInfo)
         {
             //only send active player's ball
             auto ball = player.ballEntity;
+            const auto serverID = static_cast<std::uint32_t>(ball.getIndex());
 
             //ideally we want to send only non-idle balls but without
             //sending a few pre-movement frames first we get visible pops
-            //in the client side interpolation.
+            //in the client side interpolation. Idle balls cost a couple of
+            //bits in the snapshot though, as they haven't changed.
             if (ball == group.playerInfo[0].ballEntity/* ||
-                ball.getComponent<Ball>().state != Ball::State::Idle*/)
+                ball.getComponent<Ball>().state != Ball::State::Idle*/
+                && snapshot.findEntity(serverID) == snapshot.getEntityCount())
             {
-                auto timestamp = m_serverTime.elapsed().asMilliseconds();
-                const auto ballC = ball.getComponent<Ball>();
-
-                ActorInfo info;
-                info.serverID = static_cast<std::uint32_t>(ball.getIndex());
-                info.position = ball.getComponent<cro::Transform>().getPosition();
-                info.rotation = cro::Util::Net::compressQuat(ball.getComponent<cro::Transform>().getRotation());
-                info.windEffect = ballC.windEffect;
-                info.timestamp = timestamp;
-                info.clientID = player.client;
-                info.playerID = player.player;
-                info.state = static_cast<std::uint8_t>(ballC.state);
-                info.lie = ballC.lie;
-                info.groupID = m_groupAssignments[player.client];
-                m_sharedData.host.broadcastPacket(PacketID::ActorUpdate, info, net::NetFlag::Unreliable);
+                const auto& ballC = ball.getComponent<Ball>();
+                const auto& tx = ball.getComponent<cro::Transform>();
+
+                auto i = snapshot.addEntity(serverID);
+                snapshot.setVec3(i, ActorSnapshot::Position, tx.getPosition());
+                snapshot.setQuat(i, ActorSnapshot::Rotation, tx.getRotation());
+                snapshot.setFloat(i, ActorSnapshot::WindEffect, ballC.windEffect);
+                snapshot.setUInt(i, ActorSnapshot::ClientID, player.client);
+                snapshot.setUInt(i, ActorSnapshot::PlayerID, player.player);
+                snapshot.setUInt(i, ActorSnapshot::State, static_cast<std::uint8_t>(ballC.state));
+                snapshot.setUInt(i, ActorSnapshot::Lie, ballC.lie);
+                snapshot.setUInt(i, ActorSnapshot::GroupID, m_groupAssignments[player.client]);
             }
         }
     }
+    m_actorSnapshots.commit();
+
+    for (auto i = 0u; i < m_sharedData.clients.size(); ++i)
+    {
+        if (m_sharedData.clients[i].connected)
+        {
+            m_actorSnapshots.encode(m_snapshotAcks[i], m_snapshotBuffer);
+            m_sharedData.host.sendPacket(m_sharedData.clients[i].peer, PacketID::ActorSnapshot, m_snapshotBuffer.data(), m_snapshotBuffer.size(), net::NetFlag::Unreliable);
+        }
+    }
+
     auto wind = cro::Util::Net::compressVec3(m_scene.getSystem<BallSystem>()->getWindDirection());
     m_sharedData.host.broadcastPacket(PacketID::WindDirection, wind, net::NetFlag::Unreliable);
 }
@@ -636,6 +665,11 @@ std::int32_t GolfState::process(float dt)
                         return true;
                     }
 
+#ifdef CRO_HEADLESS
+                    //the challenge progress belongs to the hosting
+                    //player, and dedicated servers have no local profile
+                    return false;
+#else
                     const auto& progress = Social::getMonthlyChallenge().getProgress();
 
                     if (Social::getMonth() == 2
@@ -649,6 +683,7 @@ std::int32_t GolfState::process(float dt)
                     }
 
                     return false;
+#endif
                 };
 
                 //if the game mode requires or challenge requires
@@ -943,8 +978,8 @@ void GolfState::setNextPlayer(std::int32_t groupID, bool newHole)
             //: a.totalScore < b.totalScore;
     };
 
-    hadTennisBounce = false;
-    hadWallBounce = false;
+    m_hadTennisBounce = false;
+    m_hadWallBounce = false;
 
     auto& playerInfo = m_playerInfo[groupID].playerInfo;
 
@@ -1486,7 +1521,13 @@ bool GolfState::validateMap()
         //creates the path first to prevent filesystem exception... as
         //this runs in its own thread trying to create it here too is probably not a good idea
 
+#ifdef CRO_HEADLESS
+        //dedicated servers have no preference path so
+        //user courses are read from the working directory
+        mapPath = cro::FileSystem::getCurrentDirectory() + "/" + ConstVal::UserMapPath + mapDir + "/course.data";
+#else
         mapPath = cro::App::getPreferencePath() + ConstVal::UserMapPath + mapDir + "/course.data";
+#endif
         isUser = true;
 
         if (!cro::FileSystem::fileExists(mapPath))
@@ -1845,6 +1886,7 @@ void GolfState::buildWorld()
         }
     }
 
+#ifndef CRO_HEADLESS //career leagues are only played locally
     //if this is a career league look for a progress file
     //TODO what are the chances of this overlapping with the client?
     if (m_sharedData.leagueID != 0)
@@ -1876,6 +1918,7 @@ void GolfState::buildWorld()
             player.ballEntity.getComponent<Ball>().terrain = player.terrain;
         }
     }
+#endif
 }
 
 void GolfState::doServerCommand(const net::NetEvent& evt)
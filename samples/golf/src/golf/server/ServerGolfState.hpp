@@ -74,6 +74,10 @@ namespace sv
         std::uint8_t m_currentBest; //current best score for hole, non-stroke games end if no-one can beat it
         std::uint8_t m_randomTargetCount;
 
+        //used to award achievements for the shot in progress
+        bool m_hadTennisBounce;
+        bool m_hadWallBounce;
+
         std::array<std::uint8_t, 2u> m_honour = { 0, 0 };
 
         struct PlayerGroup final
@@ -93,6 +97,11 @@ namespace sv
         //this is the group IDs indexed by client ID so we can look up a group for a given client
         std::array<std::int32_t, ConstVal::MaxClients> m_groupAssignments = {};
 
+        //ball updates are delta compressed against the last snapshot each client acknowledged
+        cro::SnapshotEncoder m_actorSnapshots;
+        std::array<std::uint32_t, ConstVal::MaxClients> m_snapshotAcks = {};
+        std::vector<std::uint8_t> m_snapshotBuffer;
+
         void sendInitialGameState(std::uint8_t);
         void handlePlayerInput(const net::NetEvent::Packet&, bool predict);
         void checkReadyQuit(std::uint8_t);
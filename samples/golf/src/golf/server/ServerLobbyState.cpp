@@ -29,7 +29,7 @@ source distribution.
 
 #include "../PacketIDs.hpp"
 #include "../CommonConsts.hpp"
-#include "../SharedStateData.hpp"
+#include "../ConnectionData.hpp"
 #include "../Utility.hpp"
 
 #include "ServerLobbyState.hpp"
@@ -60,6 +60,28 @@ PlayerInfo& PlayerInfo::operator=(const PlayerData& pd)
     return *this;
 }
 
+PlayerData& PlayerData::operator=(const sv::PlayerInfo& pi)
+{
+    name = pi.name;
+    avatarFlags = pi.avatarFlags;
+    ballColourIndex = pi.ballColourIndex;
+    ballID = pi.ballID;
+    hairID = pi.hairID;
+    hatID = pi.hatID;
+    skinID = pi.skinID;
+    flipped = pi.flipped;
+    isCPU = pi.isCPU;
+
+    headwearOffsets = pi.headwearOffsets;
+
+    if (hatID == hairID)
+    {
+        hatID = 0;
+    }
+
+    return *this;
+}
+
 LobbyState::LobbyState(SharedData& sd)
     : m_returnValue (StateID::Lobby),
     m_sharedData    (sd)
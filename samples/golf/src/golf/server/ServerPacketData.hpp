@@ -33,6 +33,8 @@ source distribution.
 #include "../Terrain.hpp"
 
 #include <crogine/ecs/Entity.hpp>
+#include <crogine/network/Snapshot.hpp>
+#include <crogine/util/Network.hpp>
 #include <crogine/detail/glm/vec3.hpp>
 
 struct ActivePlayer
@@ -96,6 +98,54 @@ static inline bool operator == (const ActorInfo& actor, const ActivePlayer& play
     return (player.player == actor.playerID && player.client == actor.clientID);
 }
 
+//active balls are sent each net frame as a snapshot, delta compressed
+//against the last one acknowledged by the client. One-off reliable
+//updates, such as ball resets, are still sent as a full ActorInfo
+namespace ActorSnapshot
+{
+    //fields are added to the schema in this order
+    enum Field : std::size_t
+    {
+        Position, Rotation, WindEffect,
+        ClientID, PlayerID, State, Lie, GroupID
+    };
+
+    //the map is 560x320 - leave some room for balls which go OOB
+    static constexpr glm::vec3 MinPosition = glm::vec3(-64.f, -64.f, -384.f);
+    static constexpr glm::vec3 MaxPosition = glm::vec3(624.f, 192.f, 64.f);
+
+    static inline cro::SnapshotSchema createSchema()
+    {
+        cro::SnapshotSchema schema;
+        schema.addVec3(MinPosition, MaxPosition, 20); //~0.7mm precision
+        schema.addQuat();
+        schema.addFloat(0.f, 8.f, 10);
+        schema.addUInt(8); //client
+        schema.addUInt(8); //player
+        schema.addUInt(8); //state
+        schema.addUInt(8); //lie
+        schema.addUInt(8); //group
+        return schema;
+    }
+
+    //reconstructs the ActorInfo at the given index so it can be used with existing ActorUpdate handlers
+    static inline ActorInfo read(const cro::Snapshot& snapshot, std::size_t index)
+    {
+        ActorInfo info;
+        info.position = snapshot.getVec3(index, Position);
+        info.rotation = cro::Util::Net::compressQuat(snapshot.getQuat(index, Rotation));
+        info.windEffect = snapshot.getFloat(index, WindEffect);
+        info.serverID = snapshot.getEntityID(index);
+        info.timestamp = snapshot.getTimestamp();
+        info.clientID = static_cast<std::uint8_t>(snapshot.getUInt(index, ClientID));
+        info.playerID = static_cast<std::uint8_t>(snapshot.getUInt(index, PlayerID));
+        info.state = static_cast<std::uint8_t>(snapshot.getUInt(index, State));
+        info.lie = static_cast<std::uint8_t>(snapshot.getUInt(index, Lie));
+        info.groupID = static_cast<std::uint8_t>(snapshot.getUInt(index, GroupID));
+        return info;
+    }
+}
+
 struct ScoreUpdate final
 {
     float strokeDistance = 0.f;
@@ -33,6 +33,10 @@ source distribution.
 #include "../PlayerColours.hpp"
 #include "Networking.hpp"
 
+#ifdef CRO_HEADLESS
+#include "MatchHost.hpp"
+#endif
+
 #include <crogine/core/MessageBus.hpp>
 #include <crogine/core/String.hpp>
 
@@ -84,7 +88,13 @@ namespace sv
 
     struct SharedData final
     {
+#ifdef CRO_HEADLESS
+        //dedicated servers run many matches on a single
+        //NetHost, see ShardServer
+        MatchHost host;
+#else
         net::NetHost host;
+#endif
         std::array<sv::ClientConnection, ConstVal::MaxClients> clients;
         cro::MessageBus messageBus;
         cro::String mapDir;
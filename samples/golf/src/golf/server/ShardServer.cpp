@@ -0,0 +1,519 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "../PacketIDs.hpp"
+
+#include "ShardServer.hpp"
+
+#include <crogine/core/Clock.hpp>
+#include <crogine/core/HiResTimer.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    //the most peers ENet allows a host to have
+    constexpr std::size_t MaxPeers = 4095;
+
+    //extra peers so that clients connecting to a full
+    //server can be told so, rather than timing out
+    constexpr std::size_t SparePeers = 8;
+
+    //a match is only moved to another shard if it
+    //reduces the difference by at least this much
+    constexpr float MinRebalanceLoad = 1.f; //ms per second
+}
+
+ShardServer::ShardServer()
+    : m_running         (false),
+    m_nextMatchID       (0),
+    m_remainingShards   (0),
+    m_refusedCount      (0),
+    m_lateFrames        (0)
+{
+
+}
+
+ShardServer::~ShardServer()
+{
+    stop();
+}
+
+//public
+bool ShardServer::launch(const Settings& settings)
+{
+    stop();
+
+    if (settings.gameMode != Match::GameMode::Golf
+        && settings.gameMode != Match::GameMode::Billiards)
+    {
+        LogE << "Invalid Game Mode: Quitting Server" << std::endl;
+        return false;
+    }
+
+    if (settings.maxMatches == 0)
+    {
+        LogE << "Shard server must allow at least one match" << std::endl;
+        return false;
+    }
+
+    m_settings = settings;
+    m_settings.maxConnections = std::max(std::size_t(1u), std::min(std::size_t(ConstVal::MaxClients), settings.maxConnections));
+
+    if (m_settings.workerCount == 0)
+    {
+        m_settings.workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_running = true;
+    m_thread = std::make_unique<std::thread>(&ShardServer::run, this);
+    return true;
+}
+
+void ShardServer::stop()
+{
+    if (m_thread)
+    {
+        m_running = false;
+        m_thread->join();
+
+        m_thread.reset();
+    }
+}
+
+ShardServer::Stats ShardServer::getStats() const
+{
+    std::scoped_lock l(m_statsMutex);
+    return m_stats;
+}
+
+//private
+void ShardServer::run()
+{
+    const auto peerCount = std::min((m_settings.maxMatches * m_settings.maxConnections) + SparePeers, MaxPeers);
+    if (!m_host.start("", m_settings.port, peerCount, 4))
+    {
+        m_running = false;
+        cro::Logger::log("Failed to start host service", cro::Logger::Type::Error);
+        return;
+    }
+
+    //each net frame sends many small packets to
+    //every client, so send them as a single packet
+    m_host.setBatchingEnabled(true);
+
+    m_shards.resize(m_settings.workerCount);
+    if (m_settings.workerCount > 1)
+    {
+        //this thread also updates shards while waiting for the pool
+        m_threadPool = std::make_unique<cro::ThreadPool>(m_settings.workerCount - 1);
+    }
+
+    LogI << "Shard server launched on port " << m_settings.port << " with " << m_settings.workerCount
+        << " shards, hosting up to " << m_settings.maxMatches << " matches" << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    const auto frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(ConstVal::FixedGameUpdate));
+    auto nextFrame = Clock::now();
+
+    cro::Clock statsClock;
+
+    while (m_running)
+    {
+        //matches are ticked at the rate of their logic updates, and
+        //track their own time so a late frame is caught up next tick
+        tickShards();
+
+        //packets are sent by pollNetwork() so flush the
+        //matches first to send them as soon as possible
+        flushMatches();
+        pollNetwork();
+
+        if (statsClock.elapsed().asSeconds() > StatsPeriod)
+        {
+            updateStats(statsClock.restart().asSeconds());
+            rebalance();
+        }
+
+        nextFrame += frameTime;
+        const auto now = Clock::now();
+        if (nextFrame < now)
+        {
+            //don't try to catch up, else the following
+            //frames are run back to back
+            nextFrame = now;
+            m_lateFrames++;
+        }
+        else
+        {
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+
+    for (auto& m : m_matches)
+    {
+        m->match.end();
+        m->match.getSharedData().host.flush(m_host);
+    }
+    m_matches.clear();
+    m_routes.clear();
+    m_shards.clear();
+
+    m_threadPool.reset();
+    m_host.stop();
+
+    LOG("Shard server quit", cro::Logger::Type::Info);
+}
+
+void ShardServer::pollNetwork()
+{
+    for (;;)
+    {
+        net::NetEvent evt;
+        if (!m_host.pollEvent(evt))
+        {
+            break;
+        }
+
+        switch (evt.type)
+        {
+        default: break;
+        case net::NetEvent::ClientConnect:
+        {
+            auto* match = findMatch();
+            if (!match)
+            {
+                match = createMatch();
+            }
+
+            if (match)
+            {
+                match->match.getSharedData().host.addPeer(evt.peer);
+                match->hadClients = true;
+                m_routes[evt.peer] = match;
+                match->events.push_back(std::move(evt));
+            }
+            else
+            {
+                //already hosting as many matches as we're allowed
+                m_host.sendPacket(evt.peer, PacketID::ConnectionRefused, std::uint8_t(MessageType::ServerFull), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
+                m_host.disconnectLater(evt.peer);
+                m_refusedCount++;
+            }
+        }
+            break;
+        case net::NetEvent::ClientDisconnect:
+            //note that the peer ID is no longer valid, but the peer itself is
+            if (auto result = m_routes.find(evt.peer); result != m_routes.end())
+            {
+                auto* match = result->second;
+                match->match.getSharedData().host.removePeer(evt.peer);
+                match->events.push_back(std::move(evt));
+                m_routes.erase(result);
+            }
+            break;
+        case net::NetEvent::PacketReceived:
+            if (auto result = m_routes.find(evt.peer); result != m_routes.end())
+            {
+                result->second->events.push_back(std::move(evt));
+            }
+            break;
+        }
+    }
+}
+
+ShardServer::ActiveMatch* ShardServer::findMatch()
+{
+    //fill the oldest lobby first so that clients aren't
+    //spread out between lobbies which never fill up
+    for (auto& m : m_matches)
+    {
+        const auto& sharedData = m->match.getSharedData();
+        const auto& peers = sharedData.host.getPeers();
+
+        //if the host has left the match hands the lobby to another
+        //client when it next ticks - until then nobody can start it
+        const std::uint64_t hostID = sharedData.hostID;
+        const bool hostLeft = hostID != 0
+            && std::none_of(peers.begin(), peers.end(), [hostID](const cro::NetPeer& p) { return p.getID() == hostID; });
+
+        if (!m->ended
+            && !hostLeft
+            && m->match.acceptingClients()
+            && peers.size() < m->match.getMaxConnections())
+        {
+            return m.get();
+        }
+    }
+    return nullptr;
+}
+
+ShardServer::ActiveMatch* ShardServer::createMatch()
+{
+    if (m_matches.size() == m_settings.maxMatches)
+    {
+        return nullptr;
+    }
+
+    auto& m = m_matches.emplace_back(std::make_unique<ActiveMatch>());
+    m->id = m_nextMatchID++;
+    m->match.init(m_settings.maxConnections, m_settings.gameMode, m_settings.fastCPU);
+    m->match.start();
+
+    auto shard = std::min_element(m_shards.begin(), m_shards.end(),
+        [](const Shard& a, const Shard& b)
+        {
+            return std::make_pair(a.load, a.matches.size()) < std::make_pair(b.load, b.matches.size());
+        });
+    m->shard = std::distance(m_shards.begin(), shard);
+    shard->matches.push_back(m.get());
+
+    LOG("Created match " + std::to_string(m->id) + " on shard " + std::to_string(m->shard), cro::Logger::Type::Info);
+
+    return m.get();
+}
+
+void ShardServer::tickShards()
+{
+    if (!m_threadPool)
+    {
+        for (auto& shard : m_shards)
+        {
+            tickShard(shard);
+        }
+        return;
+    }
+
+    m_remainingShards = std::count_if(m_shards.begin(), m_shards.end(), [](const Shard& s) { return !s.matches.empty(); });
+    if (m_remainingShards == 0)
+    {
+        return;
+    }
+
+    for (auto& shard : m_shards)
+    {
+        if (!shard.matches.empty())
+        {
+            m_threadPool->submit([this, &shard]()
+                {
+                    tickShard(shard);
+
+                    std::scoped_lock l(m_tickMutex);
+                    if (--m_remainingShards == 0)
+                    {
+                        m_tickCondition.notify_one();
+                    }
+                });
+        }
+    }
+
+    //help out the workers while we wait
+    while (m_threadPool->runPendingTask()) {}
+
+    std::unique_lock l(m_tickMutex);
+    m_tickCondition.wait(l, [&]() { return m_remainingShards == 0; });
+}
+
+void ShardServer::tickShard(Shard& shard)
+{
+    for (auto* match : shard.matches)
+    {
+        tickMatch(*match);
+    }
+}
+
+void ShardServer::tickMatch(ActiveMatch& m)
+{
+    if (m.ended)
+    {
+        return;
+    }
+
+    cro::HiResTimer timer;
+
+    for (const auto& evt : m.events)
+    {
+        m.match.netEvent(evt);
+    }
+    m.events.clear();
+
+    if (!m.match.update())
+    {
+        m.ended = true;
+    }
+
+    const auto elapsed = timer.restart() * 1000.f;
+    m.tickTime += elapsed;
+    m.maxTickTime = std::max(m.maxTickTime, elapsed);
+    m.tickCount++;
+}
+
+void ShardServer::flushMatches()
+{
+    for (auto& m : m_matches)
+    {
+        //the lobby is run by the first client to join, so
+        //once everyone has left there's no one to start it
+        if (m->hadClients
+            && m->match.getSharedData().host.getPeers().empty())
+        {
+            m->ended = true;
+        }
+
+        if (m->ended)
+        {
+            m->match.end();
+        }
+        m->match.getSharedData().host.flush(m_host);
+    }
+
+    for (auto& m : m_matches)
+    {
+        if (m->ended)
+        {
+            removeMatch(*m);
+        }
+    }
+
+    m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(),
+        [](const std::unique_ptr<ActiveMatch>& m)
+        {
+            return m->ended;
+        }), m_matches.end());
+}
+
+void ShardServer::removeMatch(ActiveMatch& m)
+{
+    //disconnect anyone still waiting to join
+    for (auto peer : m.match.getSharedData().host.getPeers())
+    {
+        m_routes.erase(peer);
+        m_host.disconnectLater(peer);
+    }
+
+    auto& matches = m_shards[m.shard].matches;
+    matches.erase(std::remove(matches.begin(), matches.end(), &m), matches.end());
+
+    LOG("Removed match " + std::to_string(m.id), cro::Logger::Type::Info);
+}
+
+void ShardServer::updateStats(float period)
+{
+    Stats stats;
+    stats.period = period;
+    stats.connectionCount = m_routes.size();
+    stats.refusedCount = m_refusedCount;
+    stats.lateFrames = m_lateFrames;
+
+    m_refusedCount = 0;
+    m_lateFrames = 0;
+
+    for (auto& shard : m_shards)
+    {
+        shard.load = 0.f;
+    }
+
+    for (auto& m : m_matches)
+    {
+        m->load = m->tickTime / period;
+        m_shards[m->shard].load += m->load;
+
+        auto& matchStats = stats.matches.emplace_back();
+        matchStats.matchID = m->id;
+        matchStats.shard = m->shard;
+        matchStats.stateID = m->match.getStateID();
+        matchStats.clientCount = m->match.getClientCount();
+        matchStats.playerCount = m->match.getPlayerCount();
+        matchStats.tickCount = m->tickCount;
+        matchStats.meanTickTime = m->tickCount == 0 ? 0.f : m->tickTime / static_cast<float>(m->tickCount);
+        matchStats.maxTickTime = m->maxTickTime;
+        matchStats.load = m->load;
+
+        m->tickTime = 0.f;
+        m->maxTickTime = 0.f;
+        m->tickCount = 0;
+    }
+
+    for (const auto& shard : m_shards)
+    {
+        stats.shardLoad.push_back(shard.load);
+    }
+
+    std::scoped_lock l(m_statsMutex);
+    m_stats = std::move(stats);
+}
+
+void ShardServer::rebalance()
+{
+    if (m_shards.size() < 2)
+    {
+        return;
+    }
+
+    auto [least, most] = std::minmax_element(m_shards.begin(), m_shards.end(),
+        [](const Shard& a, const Shard& b)
+        {
+            return a.load < b.load;
+        });
+
+    const auto difference = most->load - least->load;
+    if (difference < MinRebalanceLoad)
+    {
+        return;
+    }
+
+    //moving a match with half the difference evens out the two shards.
+    //Matches with more than the difference would only swap which is busiest
+    ActiveMatch* target = nullptr;
+    float bestError = difference / 2.f;
+    for (auto* m : most->matches)
+    {
+        if (const auto error = std::abs(m->load - (difference / 2.f)); error < bestError)
+        {
+            bestError = error;
+            target = m;
+        }
+    }
+
+    if (target
+        && (difference / 2.f) - bestError >= MinRebalanceLoad / 2.f)
+    {
+        most->matches.erase(std::remove(most->matches.begin(), most->matches.end(), target), most->matches.end());
+        most->load -= target->load;
+
+        least->matches.push_back(target);
+        least->load += target->load;
+        target->shard = std::distance(m_shards.begin(), least);
+
+        LOG("Moved match " + std::to_string(target->id) + " to shard " + std::to_string(target->shard), cro::Logger::Type::Info);
+    }
+}
@@ -0,0 +1,177 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#ifndef CRO_HEADLESS
+#error ShardServer is only part of the dedicated server, which is built with CRO_HEADLESS
+#endif
+
+#include "Match.hpp"
+
+#include <crogine/core/ThreadPool.hpp>
+#include <crogine/network/NetHost.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+Hosts many independent matches in a single dedicated server process.
+
+All the matches share one NetHost, and each connecting client is routed
+to a match which is still in the lobby and has room for it, creating a
+new match if there are none. The first client routed to a match hosts
+its lobby, and a match is removed once all of its clients have left.
+
+Matches are divided between a fixed number of shards, each of which is
+updated as a single task by a worker pool. Network events are routed and
+outgoing packets sent on the server thread between updates, so matches
+never use the NetHost directly (see MatchHost). New matches are added to
+the shard with the lowest tick cost, and matches are moved from the
+busiest shard to the least busy when the difference grows large enough.
+*/
+class ShardServer final
+{
+public:
+    ShardServer();
+    ~ShardServer();
+
+    ShardServer(const ShardServer&) = delete;
+    ShardServer(ShardServer&&) = delete;
+    ShardServer& operator = (const ShardServer&) = delete;
+    ShardServer& operator = (ShardServer&&) = delete;
+
+    struct Settings final
+    {
+        std::size_t maxMatches = 64;
+        std::size_t maxConnections = ConstVal::MaxClients; //per match
+        std::int32_t gameMode = Match::GameMode::Golf;
+        bool fastCPU = false;
+        std::uint16_t port = ConstVal::GamePort;
+        std::size_t workerCount = 0; //0 uses all hardware threads
+    };
+
+    //starts the server on its own thread, returning false if the settings are invalid
+    bool launch(const Settings&);
+    bool running() const { return m_running; }
+    void stop();
+
+    struct MatchStats final
+    {
+        std::uint32_t matchID = 0;
+        std::size_t shard = 0;
+        std::int32_t stateID = 0;
+        std::size_t clientCount = 0;
+        std::int32_t playerCount = 0;
+
+        std::uint32_t tickCount = 0;
+        float meanTickTime = 0.f; //ms
+        float maxTickTime = 0.f; //ms
+        float load = 0.f; //ms of tick time per second
+    };
+
+    struct Stats final
+    {
+        float period = 0.f; //seconds measured
+        std::size_t connectionCount = 0;
+        std::uint32_t refusedCount = 0; //connections refused because the server was full
+        std::uint32_t lateFrames = 0; //frames which started after they were due
+        std::vector<float> shardLoad; //ms of tick time per second
+        std::vector<MatchStats> matches;
+    };
+
+    //returns the stats for the most recently measured period,
+    //which are updated every StatsPeriod seconds. Thread safe.
+    Stats getStats() const;
+
+    static constexpr float StatsPeriod = 1.f;
+
+private:
+    Settings m_settings;
+    std::atomic_bool m_running;
+    std::unique_ptr<std::thread> m_thread;
+
+    cro::NetHost m_host;
+    std::unique_ptr<cro::ThreadPool> m_threadPool;
+
+    struct ActiveMatch final
+    {
+        std::uint32_t id = 0;
+        std::size_t shard = 0;
+        Match match;
+        std::vector<net::NetEvent> events; //received since the last tick
+        bool ended = false;
+        bool hadClients = false;
+
+        std::uint32_t tickCount = 0;
+        float tickTime = 0.f; //ms, since the last stats period
+        float maxTickTime = 0.f;
+        float load = 0.f;
+    };
+    std::vector<std::unique_ptr<ActiveMatch>> m_matches;
+    std::unordered_map<net::NetPeer, ActiveMatch*> m_routes;
+    std::uint32_t m_nextMatchID;
+
+    struct Shard final
+    {
+        std::vector<ActiveMatch*> matches;
+        float load = 0.f; //sum of the match loads
+    };
+    std::vector<Shard> m_shards;
+
+    std::mutex m_tickMutex;
+    std::condition_variable m_tickCondition;
+    std::size_t m_remainingShards;
+
+    mutable std::mutex m_statsMutex;
+    Stats m_stats;
+    std::uint32_t m_refusedCount;
+    std::uint32_t m_lateFrames;
+
+    void run();
+
+    void pollNetwork();
+    ActiveMatch* findMatch();
+    ActiveMatch* createMatch();
+
+    void tickShards();
+    void tickShard(Shard&);
+    void tickMatch(ActiveMatch&);
+
+    void flushMatches();
+    void removeMatch(ActiveMatch&);
+
+    void updateStats(float period);
+    void rebalance();
+};
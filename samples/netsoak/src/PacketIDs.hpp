@@ -0,0 +1,96 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace PacketID
+{
+    enum : std::uint8_t
+    {
+        //from server
+        WorldState, //< WorldState followed by actorCount ActorState, unreliable
+        ServerEvent, //< SequencedEvent, reliable
+        Pong, //< Ping returned to the client which sent it, unreliable
+
+        //from client
+        Input, //< InputState, unreliable
+        ClientEvent, //< SequencedEvent, reliable
+        Ping //< Ping, unreliable
+    };
+}
+
+namespace Channel
+{
+    enum : std::uint8_t
+    {
+        Unreliable,
+        Reliable,
+
+        Count
+    };
+}
+
+struct WorldState final
+{
+    std::uint32_t tick = 0;
+    std::uint32_t actorCount = 0;
+};
+
+//roughly the size of a golf ActorInfo
+struct ActorState final
+{
+    std::uint32_t id = 0;
+    std::array<float, 3u> position = {};
+    std::array<std::int16_t, 4u> rotation = {};
+    std::int32_t timestamp = 0;
+};
+
+//reliable messages are numbered per sender so the receiver
+//can check that none were lost or delivered out of order
+struct SequencedEvent final
+{
+    std::uint32_t sequence = 0;
+    std::uint64_t sendTime = 0; //microseconds, see Stats.hpp
+    std::array<std::uint8_t, 20u> payload = {};
+};
+
+struct InputState final
+{
+    std::uint32_t frame = 0;
+    std::array<float, 2u> move = {};
+    std::uint16_t buttons = 0;
+};
+
+struct Ping final
+{
+    std::uint64_t sendTime = 0;
+};
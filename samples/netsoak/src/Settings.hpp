@@ -0,0 +1,57 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/network/NetData.hpp>
+
+#include <cstdint>
+#include <string>
+
+struct Settings final
+{
+    std::string address = "127.0.0.1";
+    std::uint16_t port = 27860;
+    std::size_t clientCount = 8;
+    std::uint32_t duration = 10; //seconds, not including connection and warm up
+    std::uint32_t tickRate = 20; //server broadcasts per second
+    std::uint32_t frameRate = 60; //client updates per second
+    std::size_t actorCount = 16; //actors in each world state
+    bool batching = false;
+
+    //applied to the server and every client
+    cro::NetConditions conditions;
+
+    //if non-zero the run fails when these are exceeded, in milliseconds
+    float maxRoundTrip = 0.f; //99th percentile
+    float maxTickTime = 0.f; //99th percentile
+
+    static constexpr std::uint32_t PingInterval = 100; //ms
+    static constexpr std::uint32_t ClientEventInterval = 100; //ms
+};
@@ -0,0 +1,218 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "SoakClient.hpp"
+#include "PacketIDs.hpp"
+
+#include <crogine/core/Log.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+SoakClient::SoakClient(const Settings& settings)
+    : m_settings        (settings),
+    m_connected         (false),
+    m_frame             (0),
+    m_frameTime         (1000000 / std::max(1u, settings.frameRate)),
+    m_nextFrame         (0),
+    m_nextPing          (0),
+    m_nextEvent         (0),
+    m_sendSequence      (0),
+    m_receiveSequence   (0),
+    m_measuring         (false),
+    m_stallThreshold    (0.0),
+    m_firstTick         (0),
+    m_lastTick          (0)
+{
+    //anything slower than the worst simulated latency, plus a little
+    //for the time spent waiting between polls, is counted as a stall
+    m_stallThreshold = static_cast<double>(settings.conditions.latency + settings.conditions.jitter) + 5.0;
+}
+
+//public
+bool SoakClient::connect()
+{
+    if (!m_client.create(Channel::Count))
+    {
+        return false;
+    }
+    m_client.setBatchingEnabled(m_settings.batching);
+
+    if (!m_client.connect(m_settings.address, m_settings.port))
+    {
+        return false;
+    }
+    m_client.setConditions(m_settings.conditions);
+
+    m_connected = true;
+    return true;
+}
+
+void SoakClient::update(std::uint64_t now)
+{
+    if (!m_connected)
+    {
+        return;
+    }
+
+    cro::NetEvent evt;
+    while (m_client.pollEvent(evt))
+    {
+        if (evt.type == cro::NetEvent::PacketReceived)
+        {
+            handlePacket(evt.packet, now);
+        }
+        else if (evt.type == cro::NetEvent::ClientDisconnect)
+        {
+            m_connected = false;
+            m_report.disconnected = true;
+            LogW << "Soak client was disconnected" << std::endl;
+            return;
+        }
+    }
+
+    if (now >= m_nextFrame)
+    {
+        sendFrame(now);
+
+        m_nextFrame += m_frameTime;
+        if (m_nextFrame < now)
+        {
+            m_nextFrame = now + m_frameTime;
+        }
+    }
+}
+
+void SoakClient::beginMeasurement()
+{
+    m_measuring = true;
+    m_firstTick = 0;
+    m_lastTick = 0;
+    m_trafficStart = m_client.getTrafficStats();
+}
+
+void SoakClient::endMeasurement()
+{
+    m_measuring = false;
+    if (m_firstTick != 0)
+    {
+        m_report.statesExpected = (m_lastTick - m_firstTick) + 1;
+    }
+
+    //the totals wrap, so unsigned subtraction still gives the difference
+    const auto traffic = m_client.getTrafficStats();
+    m_report.traffic.bytesSent = traffic.bytesSent - m_trafficStart.bytesSent;
+    m_report.traffic.packetsSent = traffic.packetsSent - m_trafficStart.packetsSent;
+    m_report.traffic.bytesReceived = traffic.bytesReceived - m_trafficStart.bytesReceived;
+    m_report.traffic.packetsReceived = traffic.packetsReceived - m_trafficStart.packetsReceived;
+}
+
+//private
+void SoakClient::handlePacket(const cro::NetEvent::Packet& packet, std::uint64_t now)
+{
+    switch (packet.getID())
+    {
+    default: break;
+    case PacketID::WorldState:
+        if (m_measuring
+            && packet.getSize() >= sizeof(WorldState))
+        {
+            WorldState state;
+            std::memcpy(&state, packet.getData(), sizeof(state));
+
+            if (m_firstTick == 0)
+            {
+                m_firstTick = state.tick;
+            }
+            m_lastTick = std::max(m_lastTick, state.tick);
+            m_report.statesReceived++;
+        }
+        break;
+    case PacketID::Pong:
+        if (m_measuring)
+        {
+            const auto ping = packet.as<Ping>();
+            m_report.roundTrip.add(static_cast<double>(now - ping.sendTime) / 1000.0);
+        }
+        break;
+    case PacketID::ServerEvent:
+    {
+        const auto data = packet.as<SequencedEvent>();
+        if (data.sequence != m_receiveSequence + 1)
+        {
+            m_report.orderErrors++;
+        }
+        m_receiveSequence = data.sequence;
+
+        if (m_measuring)
+        {
+            const auto delay = static_cast<double>(now - data.sendTime) / 1000.0;
+            m_report.eventDelay.add(delay);
+
+            if (delay > m_stallThreshold)
+            {
+                m_report.stallTime += delay - m_stallThreshold;
+                m_report.stallCount++;
+            }
+        }
+    }
+        break;
+    }
+}
+
+void SoakClient::sendFrame(std::uint64_t now)
+{
+    InputState input;
+    input.frame = ++m_frame;
+    input.move = { static_cast<float>(m_frame % 100) / 100.f, 1.f };
+    input.buttons = static_cast<std::uint16_t>(m_frame % 3);
+    m_client.sendPacket(PacketID::Input, input, cro::NetFlag::Unreliable, Channel::Unreliable);
+
+    if (now >= m_nextPing)
+    {
+        Ping ping;
+        ping.sendTime = now;
+        m_client.sendPacket(PacketID::Ping, ping, cro::NetFlag::Unreliable, Channel::Unreliable);
+        m_nextPing = now + (Settings::PingInterval * 1000);
+    }
+
+    if (now >= m_nextEvent)
+    {
+        SequencedEvent data;
+        data.sequence = ++m_sendSequence;
+        data.sendTime = now;
+        m_client.sendPacket(PacketID::ClientEvent, data, cro::NetFlag::Reliable, Channel::Reliable);
+        m_nextEvent = now + (Settings::ClientEventInterval * 1000);
+
+        if (m_measuring)
+        {
+            m_report.eventsSent++;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include "Settings.hpp"
+#include "Stats.hpp"
+
+#include <crogine/network/NetClient.hpp>
+
+#include <cstdint>
+
+//a bot which sends input and pings at the client frame rate
+//and measures what it receives from the server
+class SoakClient final
+{
+public:
+    explicit SoakClient(const Settings&);
+
+    bool connect();
+
+    //polls for events, and sends input and any due
+    //messages if a client frame is due. Call this often
+    //so that packets are sent and received promptly.
+    void update(std::uint64_t now);
+
+    void beginMeasurement();
+    void endMeasurement();
+
+    bool isConnected() const { return m_connected; }
+
+    struct Report final
+    {
+        Samples roundTrip; //ms, from unreliable ping / pong
+        Samples eventDelay; //ms from a reliable message being sent by the server until it was received
+
+        //total time reliable messages spent waiting longer than the
+        //simulated latency would explain, eg for resends or for
+        //an earlier message to arrive
+        double stallTime = 0.0; //ms
+        std::uint32_t stallCount = 0;
+
+        std::uint32_t statesReceived = 0;
+        std::uint32_t statesExpected = 0;
+        std::uint32_t eventsSent = 0;
+        std::uint32_t orderErrors = 0;
+        bool disconnected = false;
+
+        cro::NetTrafficStats traffic;
+    };
+    const Report& getReport() const { return m_report; }
+
+private:
+    const Settings& m_settings;
+    cro::NetClient m_client;
+    bool m_connected;
+
+    std::uint32_t m_frame;
+    std::uint64_t m_frameTime;
+    std::uint64_t m_nextFrame;
+    std::uint64_t m_nextPing;
+    std::uint64_t m_nextEvent;
+    std::uint32_t m_sendSequence;
+    std::uint32_t m_receiveSequence;
+
+    bool m_measuring;
+    double m_stallThreshold;
+    std::uint32_t m_firstTick;
+    std::uint32_t m_lastTick;
+    cro::NetTrafficStats m_trafficStart;
+
+    Report m_report;
+
+    void handlePacket(const cro::NetEvent::Packet&, std::uint64_t now);
+    void sendFrame(std::uint64_t now);
+};
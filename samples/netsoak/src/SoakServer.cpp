@@ -0,0 +1,265 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "SoakServer.hpp"
+#include "PacketIDs.hpp"
+
+#include <crogine/core/Log.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    cro::NetTrafficStats operator - (const cro::NetTrafficStats& a, const cro::NetTrafficStats& b)
+    {
+        //the totals wrap, so unsigned subtraction still gives the difference
+        cro::NetTrafficStats retVal;
+        retVal.bytesSent = a.bytesSent - b.bytesSent;
+        retVal.packetsSent = a.packetsSent - b.packetsSent;
+        retVal.bytesReceived = a.bytesReceived - b.bytesReceived;
+        retVal.packetsReceived = a.packetsReceived - b.packetsReceived;
+        return retVal;
+    }
+}
+
+SoakServer::SoakServer(const Settings& settings)
+    : m_settings    (settings),
+    m_running       (false),
+    m_measuring     (false),
+    m_tick          (0)
+{
+
+}
+
+SoakServer::~SoakServer()
+{
+    stop();
+}
+
+//public
+bool SoakServer::start()
+{
+    if (!m_host.start("", m_settings.port, m_settings.clientCount, Channel::Count))
+    {
+        return false;
+    }
+    m_host.setBatchingEnabled(m_settings.batching);
+    m_host.setConditions(m_settings.conditions);
+
+    m_stateBuffer.resize(sizeof(WorldState) + (sizeof(ActorState) * m_settings.actorCount));
+
+    m_running = true;
+    m_thread = std::thread(&SoakServer::run, this);
+    return true;
+}
+
+void SoakServer::stop()
+{
+    if (m_running)
+    {
+        m_running = false;
+        m_thread.join();
+        m_host.stop();
+    }
+}
+
+//private
+void SoakServer::run()
+{
+    const std::uint64_t tickDuration = 1000000 / std::max(1u, m_settings.tickRate);
+    std::uint64_t nextTick = microseconds() + tickDuration;
+    std::uint64_t busyTime = 0;
+
+    bool measuring = false;
+    std::uint64_t measureStart = 0;
+    cro::NetTrafficStats trafficStart;
+
+    while (m_running)
+    {
+        const auto frameStart = microseconds();
+
+        if (measuring && !m_measuring)
+        {
+            finishMeasurement(measureStart, trafficStart);
+            measuring = false;
+        }
+
+        cro::NetEvent evt;
+        while (m_host.pollEvent(evt))
+        {
+            handleEvent(evt);
+        }
+
+        const auto now = microseconds();
+        if (now >= nextTick)
+        {
+            broadcast();
+
+            if (!measuring && m_measuring)
+            {
+                measuring = true;
+                measureStart = now;
+                trafficStart = m_host.getTrafficStats();
+            }
+            else if (measuring)
+            {
+                busyTime += microseconds() - frameStart;
+                m_report.tickTime.add(static_cast<double>(busyTime) / 1000.0);
+            }
+            busyTime = 0;
+
+            nextTick += tickDuration;
+            if (nextTick < now)
+            {
+                //we fell behind, so don't try to catch up
+                nextTick = now + tickDuration;
+            }
+        }
+        else
+        {
+            busyTime += now - frameStart;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    if (measuring)
+    {
+        finishMeasurement(measureStart, trafficStart);
+    }
+}
+
+void SoakServer::finishMeasurement(std::uint64_t start, const cro::NetTrafficStats& trafficStart)
+{
+    m_report.duration = static_cast<double>(microseconds() - start) / 1000000.0;
+    m_report.traffic = m_host.getTrafficStats() - trafficStart;
+}
+
+void SoakServer::handleEvent(const cro::NetEvent& evt)
+{
+    switch (evt.type)
+    {
+    default: break;
+    case cro::NetEvent::ClientConnect:
+        m_clients.emplace_back().peer = evt.peer;
+        m_report.connections++;
+        break;
+    case cro::NetEvent::ClientDisconnect:
+        m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+            [&evt](const Client& c)
+            {
+                return c.peer == evt.peer;
+            }), m_clients.end());
+        if (m_measuring)
+        {
+            m_report.disconnections++;
+            LogW << "Client disconnected from soak server" << std::endl;
+        }
+        break;
+    case cro::NetEvent::PacketReceived:
+        handlePacket(evt);
+        break;
+    }
+}
+
+void SoakServer::handlePacket(const cro::NetEvent& evt)
+{
+    switch (evt.packet.getID())
+    {
+    default: break;
+    case PacketID::Ping:
+        //send the client's timestamp straight back
+        m_host.sendPacket(evt.peer, PacketID::Pong, evt.packet.as<Ping>(), cro::NetFlag::Unreliable, Channel::Unreliable);
+        break;
+    case PacketID::ClientEvent:
+    {
+        auto client = std::find_if(m_clients.begin(), m_clients.end(),
+            [&evt](const Client& c)
+            {
+                return c.peer == evt.peer;
+            });
+
+        if (client != m_clients.end())
+        {
+            const auto data = evt.packet.as<SequencedEvent>();
+            if (data.sequence != client->receiveSequence + 1)
+            {
+                m_report.orderErrors++;
+            }
+            client->receiveSequence = data.sequence;
+
+            if (m_measuring)
+            {
+                m_report.eventsReceived++;
+            }
+        }
+    }
+        break;
+    case PacketID::Input:
+        //nothing to simulate, this is just for the traffic
+        break;
+    }
+}
+
+void SoakServer::broadcast()
+{
+    m_tick++;
+
+    //move the actors in a circle so the state changes every tick
+    WorldState state;
+    state.tick = m_tick;
+    state.actorCount = static_cast<std::uint32_t>(m_settings.actorCount);
+    std::memcpy(m_stateBuffer.data(), &state, sizeof(state));
+
+    const float t = static_cast<float>(m_tick) / static_cast<float>(m_settings.tickRate);
+    for (auto i = 0u; i < m_settings.actorCount; ++i)
+    {
+        const float angle = t + static_cast<float>(i);
+
+        ActorState actor;
+        actor.id = i;
+        actor.position = { std::cos(angle) * 10.f, 0.f, std::sin(angle) * 10.f };
+        actor.rotation = { 0, static_cast<std::int16_t>(std::sin(angle / 2.f) * 32767.f), 0, static_cast<std::int16_t>(std::cos(angle / 2.f) * 32767.f) };
+        actor.timestamp = static_cast<std::int32_t>(t * 1000.f);
+        std::memcpy(m_stateBuffer.data() + sizeof(WorldState) + (sizeof(ActorState) * i), &actor, sizeof(actor));
+    }
+    m_host.broadcastPacket(PacketID::WorldState, m_stateBuffer.data(), m_stateBuffer.size(), cro::NetFlag::Unreliable, Channel::Unreliable);
+
+    //and a reliable message for each client
+    const auto now = microseconds();
+    for (auto& client : m_clients)
+    {
+        SequencedEvent data;
+        data.sequence = ++client.sendSequence;
+        data.sendTime = now;
+        m_host.sendPacket(client.peer, PacketID::ServerEvent, data, cro::NetFlag::Reliable, Channel::Reliable);
+    }
+}
@@ -0,0 +1,104 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include "Settings.hpp"
+#include "Stats.hpp"
+
+#include <crogine/network/NetHost.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+//runs a NetHost on its own thread, broadcasting world state
+//at a fixed tick rate and answering pings from each client
+class SoakServer final
+{
+public:
+    explicit SoakServer(const Settings&);
+    ~SoakServer();
+
+    SoakServer(const SoakServer&) = delete;
+    SoakServer(SoakServer&&) = delete;
+    SoakServer& operator = (const SoakServer&) = delete;
+    SoakServer& operator = (SoakServer&&) = delete;
+
+    bool start();
+    void stop();
+
+    //starts recording the report from the next tick
+    void beginMeasurement() { m_measuring = true; }
+
+    //stops recording the report, which is complete once the server is stopped
+    void endMeasurement() { m_measuring = false; }
+
+    struct Report final
+    {
+        Samples tickTime; //ms spent processing each tick
+        cro::NetTrafficStats traffic; //during measurement
+        double duration = 0.0; //seconds measured
+        std::uint32_t connections = 0;
+        std::uint32_t disconnections = 0;
+        std::uint32_t eventsReceived = 0;
+        std::uint32_t orderErrors = 0;
+    };
+
+    //only valid once stopped
+    const Report& getReport() const { return m_report; }
+
+private:
+    const Settings& m_settings;
+    cro::NetHost m_host;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_measuring;
+
+    struct Client final
+    {
+        cro::NetPeer peer;
+        std::uint32_t sendSequence = 0;
+        std::uint32_t receiveSequence = 0;
+    };
+    std::vector<Client> m_clients;
+
+    std::uint32_t m_tick;
+    std::vector<std::uint8_t> m_stateBuffer;
+
+    Report m_report;
+
+    void run();
+    void finishMeasurement(std::uint64_t start, const cro::NetTrafficStats& trafficStart);
+    void handleEvent(const cro::NetEvent&);
+    void handlePacket(const cro::NetEvent&);
+    void broadcast();
+};
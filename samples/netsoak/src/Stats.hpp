@@ -0,0 +1,108 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//all the threads in the harness share the same clock
+//so one way delivery times can be measured directly
+inline std::uint64_t microseconds()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//collects a set of measurements to report their distribution
+class Samples final
+{
+public:
+    void add(double value) { m_values.push_back(value); m_sorted = false; }
+
+    void append(const Samples& other)
+    {
+        m_values.insert(m_values.end(), other.m_values.begin(), other.m_values.end());
+        m_sorted = false;
+    }
+
+    void clear() { m_values.clear(); }
+
+    std::size_t size() const { return m_values.size(); }
+
+    //p is 0 - 1, using the nearest rank
+    double percentile(double p) const
+    {
+        if (m_values.empty())
+        {
+            return 0.0;
+        }
+        sort();
+
+        auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(m_values.size())));
+        rank = std::clamp(rank, std::size_t(1), m_values.size());
+        return m_values[rank - 1];
+    }
+
+    double max() const
+    {
+        return m_values.empty() ? 0.0 : *std::max_element(m_values.begin(), m_values.end());
+    }
+
+    double mean() const
+    {
+        if (m_values.empty())
+        {
+            return 0.0;
+        }
+
+        double sum = 0.0;
+        for (auto v : m_values)
+        {
+            sum += v;
+        }
+        return sum / static_cast<double>(m_values.size());
+    }
+
+private:
+    mutable std::vector<double> m_values;
+    mutable bool m_sorted = false;
+
+    void sort() const
+    {
+        if (!m_sorted)
+        {
+            std::sort(m_values.begin(), m_values.end());
+            m_sorted = true;
+        }
+    }
+};
@@ -0,0 +1,367 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Headless soak test for NetHost and NetClient.
+
+A server is run on its own thread and a number of bot clients connect
+to it over the loopback interface, optionally with simulated latency,
+jitter, packet loss and reordering applied to both ends. Once connected
+the bots and server exchange traffic similar to a game for the given
+duration, after which a report of round trip times, reliable delivery,
+bandwidth and server tick times is printed.
+
+The exit code is 0 if the run succeeded, 1 if it failed - eg clients
+failed to connect, reliable messages were lost or reordered, or one of
+the optional limits was exceeded - and 2 if the arguments were invalid,
+so it can be used to catch regressions in networking performance.
+*/
+
+#include "Settings.hpp"
+#include "SoakClient.hpp"
+#include "SoakServer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void printUsage()
+    {
+        std::printf(
+            "Usage: netsoak [options]\n"
+            "  --clients <n>        number of bot clients (default 8)\n"
+            "  --duration <s>       seconds to measure for (default 10)\n"
+            "  --tick <hz>          server broadcast rate (default 20)\n"
+            "  --frame <hz>         client update rate (default 60)\n"
+            "  --actors <n>         actors in each world state (default 16)\n"
+            "  --port <port>        server port (default 27860)\n"
+            "  --batch              enable packet batching\n"
+            "  --latency <ms>       simulated latency at each end\n"
+            "  --jitter <ms>        simulated jitter at each end\n"
+            "  --loss <percent>     simulated packet loss at each end\n"
+            "  --reorder <percent>  simulated reordering at each end\n"
+            "  --max-rtt <ms>       fail if the 99th percentile round trip time is higher\n"
+            "  --max-tick <ms>      fail if the 99th percentile server tick time is higher\n");
+    }
+
+    bool parseArgs(int argc, char** argv, Settings& settings)
+    {
+        for (auto i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--batch")
+            {
+                settings.batching = true;
+                continue;
+            }
+
+            if (i + 1 == argc)
+            {
+                std::printf("Missing value for %s\n", arg.c_str());
+                return false;
+            }
+
+            char* end = nullptr;
+            const char* value = argv[++i];
+            const double number = std::strtod(value, &end);
+            if (end == value || *end != 0 || number < 0.0)
+            {
+                std::printf("Invalid value %s for %s\n", value, arg.c_str());
+                return false;
+            }
+
+            if (arg == "--clients")
+            {
+                settings.clientCount = static_cast<std::size_t>(number);
+            }
+            else if (arg == "--duration")
+            {
+                settings.duration = static_cast<std::uint32_t>(number);
+            }
+            else if (arg == "--tick")
+            {
+                settings.tickRate = static_cast<std::uint32_t>(number);
+            }
+            else if (arg == "--frame")
+            {
+                settings.frameRate = static_cast<std::uint32_t>(number);
+            }
+            else if (arg == "--actors")
+            {
+                settings.actorCount = static_cast<std::size_t>(number);
+            }
+            else if (arg == "--port")
+            {
+                settings.port = static_cast<std::uint16_t>(number);
+            }
+            else if (arg == "--latency")
+            {
+                settings.conditions.latency = static_cast<std::uint32_t>(number);
+            }
+            else if (arg == "--jitter")
+            {
+                settings.conditions.jitter = static_cast<std::uint32_t>(number);
+            }
+            else if (arg == "--loss")
+            {
+                settings.conditions.packetLoss = static_cast<float>(number) / 100.f;
+            }
+            else if (arg == "--reorder")
+            {
+                settings.conditions.reorder = static_cast<float>(number) / 100.f;
+            }
+            else if (arg == "--max-rtt")
+            {
+                settings.maxRoundTrip = static_cast<float>(number);
+            }
+            else if (arg == "--max-tick")
+            {
+                settings.maxTickTime = static_cast<float>(number);
+            }
+            else
+            {
+                std::printf("Unknown option %s\n", arg.c_str());
+                return false;
+            }
+        }
+
+        if (settings.clientCount == 0 || settings.tickRate == 0 || settings.frameRate == 0
+            || settings.duration == 0 || settings.conditions.packetLoss > 1.f || settings.conditions.reorder > 1.f)
+        {
+            std::printf("Out of range value\n");
+            return false;
+        }
+        return true;
+    }
+
+    void printSamples(const char* name, const Samples& samples)
+    {
+        std::printf("  %-22s p50 %8.2f  p90 %8.2f  p99 %8.2f  max %8.2f ms (%zu samples)\n", name,
+            samples.percentile(0.5), samples.percentile(0.9), samples.percentile(0.99), samples.max(), samples.size());
+    }
+
+    void printTraffic(const char* name, const cro::NetTrafficStats& traffic, double duration, double divisor)
+    {
+        const auto rate = [&](std::uint32_t v) { return static_cast<double>(v) / duration / divisor; };
+        std::printf("  %-22s sent %8.1f pkt/s %10.1f KiB/s   received %8.1f pkt/s %10.1f KiB/s\n", name,
+            rate(traffic.packetsSent), rate(traffic.bytesSent) / 1024.0,
+            rate(traffic.packetsReceived), rate(traffic.bytesReceived) / 1024.0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1
+        && (std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Settings settings;
+    if (!parseArgs(argc, argv, settings))
+    {
+        printUsage();
+        return 2;
+    }
+
+    SoakServer server(settings);
+    if (!server.start())
+    {
+        std::printf("Failed to start server on port %u\n", settings.port);
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<SoakClient>> clients;
+    std::size_t connectFailures = 0;
+    for (auto i = 0u; i < settings.clientCount; ++i)
+    {
+        auto& client = clients.emplace_back(std::make_unique<SoakClient>(settings));
+        if (!client->connect())
+        {
+            connectFailures++;
+        }
+    }
+
+    //the clients are polled every millisecond, rather than once a frame,
+    //so that the time spent waiting to be polled doesn't hide the latency
+    //being measured. Each client only sends at the frame rate.
+    const auto run = [&](std::uint64_t duration)
+    {
+        const auto start = microseconds();
+        while (microseconds() - start < duration)
+        {
+            for (auto& client : clients)
+            {
+                client->update(microseconds());
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    //warm up so that the round trip estimates used
+    //for resend timeouts have settled before measuring
+    run(1000000);
+
+    server.beginMeasurement();
+    for (auto& client : clients)
+    {
+        client->beginMeasurement();
+    }
+
+    run(static_cast<std::uint64_t>(settings.duration) * 1000000);
+
+    for (auto& client : clients)
+    {
+        client->endMeasurement();
+    }
+    server.endMeasurement();
+
+    //collate the results
+    Samples roundTrip;
+    Samples eventDelay;
+    double stallTime = 0.0;
+    std::uint32_t stallCount = 0;
+    std::uint32_t statesReceived = 0;
+    std::uint32_t statesExpected = 0;
+    std::uint32_t eventsSent = 0;
+    std::uint32_t orderErrors = 0;
+    std::uint32_t disconnections = 0;
+    cro::NetTrafficStats clientTraffic;
+
+    for (const auto& client : clients)
+    {
+        if (!client->isConnected() && !client->getReport().disconnected)
+        {
+            continue;
+        }
+
+        const auto& report = client->getReport();
+        roundTrip.append(report.roundTrip);
+        eventDelay.append(report.eventDelay);
+        stallTime += report.stallTime;
+        stallCount += report.stallCount;
+        statesReceived += report.statesReceived;
+        statesExpected += report.statesExpected;
+        eventsSent += report.eventsSent;
+        orderErrors += report.orderErrors;
+        disconnections += report.disconnected ? 1 : 0;
+
+        clientTraffic.bytesSent += report.traffic.bytesSent;
+        clientTraffic.packetsSent += report.traffic.packetsSent;
+        clientTraffic.bytesReceived += report.traffic.bytesReceived;
+        clientTraffic.packetsReceived += report.traffic.packetsReceived;
+    }
+
+    //disconnect the clients while the server is still
+    //running so they don't have to wait for a timeout
+    clients.clear();
+    server.stop();
+
+    const auto& serverReport = server.getReport();
+    orderErrors += serverReport.orderErrors;
+
+    const auto connectedCount = settings.clientCount - connectFailures;
+    const auto duration = std::max(serverReport.duration, 0.001);
+
+    std::printf("\nNetwork soak: %zu clients, %u seconds, %u Hz tick, %zu actors%s\n",
+        settings.clientCount, settings.duration, settings.tickRate, settings.actorCount, settings.batching ? ", batched" : "");
+    std::printf("Conditions at each end: %u ms latency, %u ms jitter, %.1f%% loss, %.1f%% reorder\n\n",
+        settings.conditions.latency, settings.conditions.jitter,
+        settings.conditions.packetLoss * 100.f, settings.conditions.reorder * 100.f);
+
+    std::printf("Connections\n");
+    std::printf("  connected %zu / %zu, disconnected %u\n\n", connectedCount, settings.clientCount, disconnections);
+
+    std::printf("Latency\n");
+    printSamples("round trip (unreliable)", roundTrip);
+    printSamples("reliable delivery", eventDelay);
+    std::printf("  reliable stalls        %u of %zu messages (%.2f%%), %.2f ms mean over expected\n\n",
+        stallCount, eventDelay.size(), eventDelay.size() == 0 ? 0.0 : static_cast<double>(stallCount) / static_cast<double>(eventDelay.size()) * 100.0,
+        stallCount == 0 ? 0.0 : stallTime / static_cast<double>(stallCount));
+
+    std::printf("Delivery\n");
+    std::printf("  world states           %u / %u (%.2f%%)\n", statesReceived, statesExpected,
+        statesExpected == 0 ? 0.0 : static_cast<double>(statesReceived) / static_cast<double>(statesExpected) * 100.0);
+    std::printf("  client reliable        sent %u, received %u\n", eventsSent, serverReport.eventsReceived);
+    std::printf("  ordering errors        %u\n\n", orderErrors);
+
+    std::printf("Throughput\n");
+    printTraffic("server", serverReport.traffic, duration, 1.0);
+    printTraffic("per client", clientTraffic, duration, static_cast<double>(std::max(connectedCount, std::size_t(1))));
+    std::printf("\n");
+
+    std::printf("Server tick\n");
+    std::printf("  mean %.3f ms  p99 %.3f ms  max %.3f ms (%zu ticks)\n\n",
+        serverReport.tickTime.mean(), serverReport.tickTime.percentile(0.99), serverReport.tickTime.max(), serverReport.tickTime.size());
+
+    bool passed = true;
+    const auto fail = [&passed](const char* reason)
+    {
+        std::printf("FAILED: %s\n", reason);
+        passed = false;
+    };
+
+    if (connectFailures != 0)
+    {
+        fail("not all clients connected");
+    }
+    if (disconnections != 0 || serverReport.disconnections != 0)
+    {
+        fail("clients were disconnected");
+    }
+    if (orderErrors != 0)
+    {
+        fail("reliable messages were lost or reordered");
+    }
+    if (settings.maxRoundTrip != 0.f
+        && roundTrip.percentile(0.99) > settings.maxRoundTrip)
+    {
+        fail("round trip time exceeded --max-rtt");
+    }
+    if (settings.maxTickTime != 0.f
+        && serverReport.tickTime.percentile(0.99) > settings.maxTickTime)
+    {
+        fail("server tick time exceeded --max-tick");
+    }
+
+    if (passed)
+    {
+        std::printf("PASSED\n");
+    }
+
+    return passed ? 0 : 1;
+}
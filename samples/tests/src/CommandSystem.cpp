@@ -0,0 +1,266 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Checks that the CommandSystem runs each command on exactly the entities
+whose CommandTarget ID matches when the command is executed. Commands
+change the IDs of the entities they visit, so flags added or removed by
+one command must be seen by the commands after it in the same frame.
+IDs are also changed between frames and entities are destroyed and
+replaced, and the results are compared with testing every entity
+against every command.
+*/
+
+#include "Test.hpp"
+
+#include <crogine/core/MessageBus.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/components/CommandTarget.hpp>
+#include <crogine/ecs/systems/CommandSystem.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t TargetCount = 500;
+    constexpr std::size_t FrameCount = 50;
+    constexpr std::size_t CommandCount = 40; //per frame
+    constexpr std::size_t ChangeCount = 20; //per frame, outside of commands
+
+    std::mt19937 rng(1234);
+
+    std::uint32_t randomID()
+    {
+        std::uniform_int_distribution<std::uint32_t> dist(0, 31);
+        auto id = 1u << dist(rng);
+        if (dist(rng) < 16)
+        {
+            id |= 1u << dist(rng);
+        }
+        return dist(rng) == 0 ? 0 : id;
+    }
+
+    //the new ID given to an entity when visited by a command, if any
+    bool changeID(std::size_t command, std::uint32_t entity, std::uint32_t& id)
+    {
+        const auto hash = static_cast<std::uint32_t>((command * 2654435761u) ^ (entity * 40503u));
+        if (hash % 5 != 0)
+        {
+            return false;
+        }
+
+        switch ((hash >> 8) % 3)
+        {
+        default:
+        case 0: id |= 1u << ((hash >> 12) % 32); break;
+        case 1: id &= ~(1u << ((hash >> 12) % 32)); break;
+        case 2: id = hash >> 16; break;
+        }
+        return true;
+    }
+
+    void testSameFrame()
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        auto& system = *scene.addSystem<cro::CommandSystem>(mb);
+
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::CommandTarget>().ID = 0x1;
+        scene.simulate(0.f);
+
+        std::vector<int> visits;
+        const auto send = [&](std::uint32_t flags, int visit, std::uint32_t newID)
+        {
+            cro::Command cmd;
+            cmd.targetFlags = flags;
+            cmd.action = [&, visit, newID](cro::Entity e, float)
+            {
+                visits.push_back(visit);
+                e.getComponent<cro::CommandTarget>().ID = newID;
+            };
+            system.sendCommand(cmd);
+        };
+
+        //a flag added by a command is matched by the next one, and
+        //one removed isn't, without visiting the entity twice
+        send(0x1, 1, 0x3);
+        send(0x2, 2, 0x4);
+        send(0x2, 3, 0x4);
+        send(0x4 | 0x8, 4, 0x8 | 0x10);
+        send(0x10, 5, 0);
+        send(0xffffffff, 6, 0);
+        scene.simulate(0.f);
+        CHECK(visits == std::vector<int>({ 1, 2, 4, 5 }));
+
+        //changes outside of commands are seen by the next frame
+        visits.clear();
+        entity.getComponent<cro::CommandTarget>().ID |= 0x20;
+        send(0x20, 1, 0x20);
+        scene.simulate(0.f);
+        CHECK(visits == std::vector<int>({ 1 }));
+
+        //assigning the ID of another target only copies the value
+        auto other = scene.createEntity();
+        other.addComponent<cro::CommandTarget>().ID = 0x40;
+        scene.simulate(0.f);
+
+        visits.clear();
+        entity.getComponent<cro::CommandTarget>().ID = other.getComponent<cro::CommandTarget>().ID;
+        other.getComponent<cro::CommandTarget>().ID = 0;
+        send(0x40, 1, 0x40);
+        scene.simulate(0.f);
+        CHECK(visits == std::vector<int>({ 1 }));
+        CHECK(entity.getComponent<cro::CommandTarget>().ID == 0x40);
+    }
+
+    void testRandom(bool parallel)
+    {
+        cro::MessageBus mb;
+        cro::Scene scene(mb);
+        auto& system = *scene.addSystem<cro::CommandSystem>(mb);
+
+        //the expected IDs, indexed by entity index
+        std::vector<std::uint32_t> ids;
+        std::vector<cro::Entity> targets;
+        const auto createTarget = [&]()
+        {
+            auto entity = scene.createEntity();
+            entity.addComponent<cro::CommandTarget>().ID = randomID();
+            if (ids.size() <= entity.getIndex())
+            {
+                ids.resize(entity.getIndex() + 1);
+            }
+            ids[entity.getIndex()] = entity.getComponent<cro::CommandTarget>().ID;
+            return entity;
+        };
+
+        for (auto i = 0u; i < TargetCount; ++i)
+        {
+            targets.push_back(createTarget());
+        }
+        scene.simulate(0.f);
+
+        std::mutex mutex;
+        std::vector<std::vector<std::uint32_t>> visits(CommandCount);
+        bool matched = true;
+        bool reached = true;
+
+        std::uniform_int_distribution<std::size_t> targetDist(0, TargetCount - 1);
+        std::uniform_int_distribution<std::uint32_t> flagDist(0, 31);
+
+        for (auto frame = 0u; frame < FrameCount; ++frame)
+        {
+            std::vector<std::uint32_t> flags;
+            for (auto i = 0u; i < CommandCount; ++i)
+            {
+                auto flag = 1u << flagDist(rng);
+                if (i % 4 == 0)
+                {
+                    flag |= 1u << flagDist(rng);
+                }
+                flags.push_back(flag);
+
+                cro::Command cmd;
+                cmd.targetFlags = flag;
+                cmd.parallel = parallel;
+                cmd.action = [&, i, frame](cro::Entity e, float)
+                {
+                    auto& target = e.getComponent<cro::CommandTarget>();
+                    std::uint32_t id = target.ID;
+                    if (changeID((frame * CommandCount) + i, e.getIndex(), id))
+                    {
+                        target.ID = id;
+                    }
+
+                    std::scoped_lock lock(mutex);
+                    visits[i].push_back(e.getIndex());
+                };
+                system.sendCommand(cmd);
+            }
+
+            scene.simulate(0.f);
+
+            //each command must have visited exactly the entities
+            //which matched it after the previous command ran
+            for (auto i = 0u; i < CommandCount; ++i)
+            {
+                std::vector<std::uint32_t> expected;
+                for (const auto& target : targets)
+                {
+                    if (ids[target.getIndex()] & flags[i])
+                    {
+                        expected.push_back(target.getIndex());
+                    }
+                }
+
+                for (auto index : expected)
+                {
+                    changeID((frame * CommandCount) + i, index, ids[index]);
+                }
+
+                std::sort(visits[i].begin(), visits[i].end());
+                std::sort(expected.begin(), expected.end());
+                matched = matched && visits[i] == expected;
+                visits[i].clear();
+            }
+
+            for (const auto& target : targets)
+            {
+                reached = reached && target.getComponent<cro::CommandTarget>().ID == ids[target.getIndex()];
+            }
+
+            //change some IDs and replace some entities before the next frame
+            for (auto i = 0u; i < ChangeCount; ++i)
+            {
+                auto& target = targets[targetDist(rng)];
+                target.getComponent<cro::CommandTarget>().ID = ids[target.getIndex()] = randomID();
+
+                auto& replaced = targets[targetDist(rng)];
+                scene.destroyEntity(replaced);
+                replaced = createTarget();
+            }
+        }
+
+        CHECK(matched);
+        CHECK(reached);
+    }
+}
+
+int main()
+{
+    testSameFrame();
+    testRandom(false);
+    testRandom(true);
+
+    return finish("CommandSystem");
+}
@@ -0,0 +1,242 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Checks that data compressed with the LZ4 block codec used by version 3
+model binaries decompresses to exactly the original, for empty, tiny,
+incompressible and highly repetitive data and sizes either side of the
+points where literal and match lengths need extra bytes. A block made
+by hand from the format description must also be read correctly, so
+that files remain readable by the reference library. Finally blocks
+are corrupted by flipping bits and truncating them, and decompressing
+them must never write outside the destination buffer.
+*/
+
+#include "../../../crogine/src/detail/LZ4.hpp"
+
+#include "Test.hpp"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t CorruptionCount = 20000;
+
+    //bytes either side of the destination which must not be written
+    constexpr std::size_t GuardSize = 64;
+    constexpr std::uint8_t GuardValue = 0xcd;
+
+    std::mt19937 rng(1234);
+
+    using LZ4Data = std::vector<std::uint8_t>;
+
+    //decompresses into the middle of a guarded buffer and checks the
+    //guard bytes are untouched. Returns the result of decompress()
+    bool decompress(const LZ4Data& src, std::size_t dstSize, LZ4Data& dst)
+    {
+        std::vector<std::uint8_t> buffer(dstSize + (GuardSize * 2), GuardValue);
+        const auto result = cro::Detail::LZ4::decompress(src.data(), src.size(), buffer.data() + GuardSize, dstSize);
+
+        bool guarded = true;
+        for (auto i = 0u; i < GuardSize; ++i)
+        {
+            guarded = guarded
+                && buffer[i] == GuardValue
+                && buffer[buffer.size() - i - 1] == GuardValue;
+        }
+        CHECK(guarded);
+
+        dst.assign(buffer.begin() + GuardSize, buffer.end() - GuardSize);
+        return result;
+    }
+
+    LZ4Data createRandom(std::size_t size)
+    {
+        std::uniform_int_distribution<int> dist(0, 255);
+        LZ4Data data(size);
+        for (auto& b : data)
+        {
+            b = static_cast<std::uint8_t>(dist(rng));
+        }
+        return data;
+    }
+
+    //short random runs repeated at random distances, similar to mesh data
+    LZ4Data createMixed(std::size_t size)
+    {
+        std::uniform_int_distribution<int> byteDist(0, 255);
+        std::uniform_int_distribution<std::size_t> runDist(1, 40);
+
+        LZ4Data data;
+        while (data.size() < size)
+        {
+            const auto run = runDist(rng);
+            if (data.size() > run
+                && byteDist(rng) < 160)
+            {
+                std::uniform_int_distribution<std::size_t> offsetDist(run, std::min<std::size_t>(data.size(), 70000));
+                const auto start = data.size() - offsetDist(rng);
+                for (auto i = 0u; i < run; ++i)
+                {
+                    data.push_back(data[start + i]);
+                }
+            }
+            else
+            {
+                for (auto i = 0u; i < run; ++i)
+                {
+                    data.push_back(static_cast<std::uint8_t>(byteDist(rng)));
+                }
+            }
+        }
+        data.resize(size);
+        return data;
+    }
+
+    void checkRoundTrip(const LZ4Data& src)
+    {
+        const auto compressed = cro::Detail::LZ4::compress(src.data(), src.size());
+
+        LZ4Data result;
+        CHECK(decompress(compressed, src.size(), result));
+        CHECK(result == src);
+
+        //the destination must be exactly the right size
+        CHECK(!decompress(compressed, src.size() + 1, result));
+        if (!src.empty())
+        {
+            CHECK(!decompress(compressed, src.size() - 1, result));
+        }
+    }
+
+    void testRoundTrip()
+    {
+        checkRoundTrip({});
+
+        //around the minimum size which is searched for matches, and the
+        //lengths at which literal and match lengths need extra bytes
+        const std::vector<std::size_t> sizes =
+        {
+            1, 4, 5, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+            255 + 14, 255 + 15, 255 + 16, 255 + 19, 255 + 20,
+            510 + 14, 510 + 15, 510 + 16, 510 + 19, 510 + 20
+        };
+
+        for (auto size : sizes)
+        {
+            checkRoundTrip(createRandom(size));
+            checkRoundTrip(LZ4Data(size, 0xaa));
+            checkRoundTrip(createMixed(size));
+        }
+
+        //large enough that matches are further than the maximum offset
+        const auto incompressible = createRandom(200000);
+        checkRoundTrip(incompressible);
+
+        const LZ4Data repeated(200000, 0);
+        checkRoundTrip(repeated);
+        CHECK(cro::Detail::LZ4::compress(repeated.data(), repeated.size()).size() < 1000);
+
+        const auto mixed = createMixed(200000);
+        checkRoundTrip(mixed);
+        CHECK(cro::Detail::LZ4::compress(mixed.data(), mixed.size()).size() < mixed.size());
+    }
+
+    void testReference()
+    {
+        //one literal 'a', a match of 15 + 0 + 4 at offset 1 then five literals
+        const LZ4Data block = { 0x1f, 'a', 0x01, 0x00, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f' };
+
+        LZ4Data expected(20, 'a');
+        expected.insert(expected.end(), { 'b', 'c', 'd', 'e', 'f' });
+
+        LZ4Data result;
+        CHECK(decompress(block, expected.size(), result));
+        CHECK(result == expected);
+
+        //literal lengths of 15 or more need an extra byte, even if it's 0
+        LZ4Data literals = { 0xf0, 0x00 };
+        for (auto i = 0u; i < 15; ++i)
+        {
+            literals.push_back(static_cast<std::uint8_t>(i));
+        }
+        CHECK(decompress(literals, 15, result));
+        CHECK(result.size() == 15 && result[14] == 14);
+
+        //matches mustn't reference data before the start of the output
+        const LZ4Data before = { 0x10, 'a', 0x02, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f' };
+        CHECK(!decompress(before, 10, result));
+
+        //nor have an offset of 0
+        const LZ4Data zero = { 0x10, 'a', 0x00, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f' };
+        CHECK(!decompress(zero, 10, result));
+    }
+
+    void testCorruption()
+    {
+        const auto src = createMixed(20000);
+        const auto compressed = cro::Detail::LZ4::compress(src.data(), src.size());
+
+        std::uniform_int_distribution<std::size_t> byteDist(0, compressed.size() - 1);
+        std::uniform_int_distribution<int> bitDist(0, 7);
+        std::uniform_int_distribution<int> countDist(1, 4);
+
+        LZ4Data result;
+        for (auto i = 0u; i < CorruptionCount; ++i)
+        {
+            auto corrupt = compressed;
+            if (i % 4 == 0)
+            {
+                //truncated data is always missing some of the output
+                corrupt.resize(byteDist(rng));
+                CHECK(!decompress(corrupt, src.size(), result));
+            }
+            else
+            {
+                //flipped bits may still decode, but only within the buffer
+                const auto count = countDist(rng);
+                for (auto j = 0; j < count; ++j)
+                {
+                    corrupt[byteDist(rng)] ^= static_cast<std::uint8_t>(1 << bitDist(rng));
+                }
+                decompress(corrupt, src.size(), result);
+            }
+        }
+    }
+}
+
+int main()
+{
+    testRoundTrip();
+    testReference();
+    testCorruption();
+
+    return finish("LZ4");
+}
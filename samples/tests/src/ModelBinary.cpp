@@ -0,0 +1,517 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Checks version 3 model binaries by packing meshes with every vertex
+attribute and decoding them again. Positions, UVs, blend indices and
+colours which are whole multiples of 1/255 must be unchanged, normals
+and tangents must be within the precision of snorm16 and blend weights
+must still sum to 1. The reordered triangles must be the same as the
+originals, with vertices in the order they're first used, and index
+arrays use 16 or 32 bit indices depending on the vertex count. Files are
+also read back with ModelBinary::read(). Finally payloads and headers
+are corrupted, and any which are accepted must be internally consistent
+with every index in range.
+*/
+
+#include "../../../crogine/src/detail/LZ4.hpp"
+#include "../../../crogine/src/detail/ModelBinaryV3.hpp"
+
+#include "Test.hpp"
+
+#include <crogine/detail/glm/geometric.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace cro;
+    using namespace cro::Detail::ModelBinary;
+
+    constexpr std::size_t CorruptionCount = 20000;
+    //half a step, plus rounding when converting back to float
+    constexpr float SNormPrecision = (0.5f / 32767.f) + 1e-7f;
+
+    //all attributes which are stored in the file, and their offsets
+    constexpr std::uint16_t VertexFlags = ((1 << Mesh::Attribute::Total) - 1) & ~(1 << Mesh::Attribute::Bitangent);
+    constexpr std::size_t PositionOffset = 0;
+    constexpr std::size_t ColourOffset = 3;
+    constexpr std::size_t NormalOffset = 7;
+    constexpr std::size_t TangentOffset = 10;
+    constexpr std::size_t UV0Offset = 14;
+    constexpr std::size_t UV1Offset = 16;
+    constexpr std::size_t BlendIndexOffset = 18;
+    constexpr std::size_t BlendWeightOffset = 22;
+    constexpr std::size_t VertexStride = 26;
+
+    std::mt19937 rng(1234);
+
+    struct TestMesh final
+    {
+        std::vector<float> vertexData;
+        std::vector<std::vector<std::uint32_t>> indexData;
+    };
+
+    //a grid with random attributes split into two submeshes, with the triangles shuffled
+    TestMesh createMesh(std::size_t width, bool exactColour, std::uint32_t jointCount)
+    {
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        std::uniform_real_distribution<float> weightDist(0.f, 1.f);
+        std::uniform_int_distribution<std::uint32_t> colourDist(0, 255);
+        std::uniform_int_distribution<std::uint32_t> jointDist(0, jointCount - 1);
+
+        TestMesh mesh;
+        for (auto z = 0u; z < width; ++z)
+        {
+            for (auto x = 0u; x < width; ++x)
+            {
+                //positions are unique so they identify the vertex once reordered
+                mesh.vertexData.insert(mesh.vertexData.end(), { static_cast<float>(x), dist(rng) * 0.1f, static_cast<float>(z) });
+
+                for (auto c = 0; c < 4; ++c)
+                {
+                    mesh.vertexData.push_back(exactColour ? static_cast<float>(colourDist(rng)) / 255.f : weightDist(rng));
+                }
+
+                glm::vec3 normal = glm::normalize(glm::vec3(dist(rng), 2.f, dist(rng)));
+                glm::vec3 tangent = glm::normalize(glm::cross(normal, glm::vec3(dist(rng), dist(rng), 1.f)));
+                mesh.vertexData.insert(mesh.vertexData.end(), { normal.x, normal.y, normal.z });
+                mesh.vertexData.insert(mesh.vertexData.end(), { tangent.x, tangent.y, tangent.z, dist(rng) < 0.f ? -1.f : 1.f });
+
+                for (auto c = 0; c < 4; ++c)
+                {
+                    mesh.vertexData.push_back(dist(rng) * 4.f);
+                }
+
+                for (auto c = 0; c < 4; ++c)
+                {
+                    mesh.vertexData.push_back(static_cast<float>(jointDist(rng)));
+                }
+
+                std::array<float, 4> weights = {};
+                float sum = 0.f;
+                for (auto& w : weights)
+                {
+                    w = weightDist(rng);
+                    sum += w;
+                }
+                for (auto w : weights)
+                {
+                    mesh.vertexData.push_back(w / sum);
+                }
+            }
+        }
+
+        mesh.indexData.resize(2);
+        for (auto z = 0u; z < width - 1; ++z)
+        {
+            auto& indices = mesh.indexData[z % 2];
+            for (auto x = 0u; x < width - 1; ++x)
+            {
+                const auto i = static_cast<std::uint32_t>((z * width) + x);
+                const auto w = static_cast<std::uint32_t>(width);
+                indices.insert(indices.end(), { i, i + w, i + 1, i + 1, i + w, i + w + 1 });
+            }
+        }
+
+        for (auto& indices : mesh.indexData)
+        {
+            const auto triangleCount = indices.size() / 3;
+            for (auto i = triangleCount - 1; i > 0; --i)
+            {
+                const auto j = std::uniform_int_distribution<std::size_t>(0, i)(rng);
+                std::swap_ranges(indices.begin() + (i * 3), indices.begin() + (i * 3) + 3, indices.begin() + (j * 3));
+            }
+        }
+
+        return mesh;
+    }
+
+    //triangles of each submesh identified by vertex position, rotated
+    //to start with the smallest so that the winding is kept, and sorted
+    using Triangle = std::array<std::array<float, 3>, 3>;
+    std::vector<std::vector<Triangle>> getTriangles(const std::vector<float>& vertexData, std::size_t stride, const std::vector<std::vector<std::uint32_t>>& indexData)
+    {
+        std::vector<std::vector<Triangle>> result;
+        for (const auto& indices : indexData)
+        {
+            auto& triangles = result.emplace_back();
+            for (auto i = 0u; i + 2 < indices.size(); i += 3)
+            {
+                Triangle triangle = {};
+                for (auto j = 0u; j < 3; ++j)
+                {
+                    const auto* pos = &vertexData[indices[i + j] * stride];
+                    triangle[j] = { pos[0], pos[1], pos[2] };
+                }
+                std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+                triangles.push_back(triangle);
+            }
+            std::sort(triangles.begin(), triangles.end());
+        }
+        return result;
+    }
+
+    std::vector<std::vector<std::uint32_t>> getIndices(const MeshHeaderV3& header, const PayloadV3& payload)
+    {
+        std::vector<std::vector<std::uint32_t>> result;
+        const auto* src = payload.data.data() + payload.indexOffset;
+        for (auto size : payload.arraySizes)
+        {
+            auto& indices = result.emplace_back(size);
+            for (auto& index : indices)
+            {
+                if (header.indexSize == 2)
+                {
+                    std::uint16_t value = 0;
+                    std::memcpy(&value, src, sizeof(value));
+                    index = value;
+                }
+                else
+                {
+                    std::memcpy(&index, src, sizeof(index));
+                }
+                src += header.indexSize;
+            }
+        }
+        return result;
+    }
+
+    bool readPayload(const MeshHeaderV3& header, const std::vector<std::uint8_t>& stored, PayloadV3& dst)
+    {
+        auto* file = SDL_RWFromConstMem(stored.data(), static_cast<int>(stored.size()));
+        const auto result = cro::Detail::ModelBinary::readPayload(file, header, dst);
+        SDL_RWclose(file);
+        return result;
+    }
+
+    bool writeFile(const std::string& path, const MeshHeaderV3& meshHeader, const std::vector<std::uint8_t>& payload)
+    {
+        HeaderV3 header;
+        header.meshOffset = sizeof(header);
+
+        auto* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fwrite(&meshHeader, sizeof(meshHeader), 1, file);
+        std::fwrite(payload.data(), payload.size(), 1, file);
+        std::fclose(file);
+        return true;
+    }
+
+    void testRoundTrip(std::size_t width, bool exactColour, std::uint32_t jointCount)
+    {
+        const auto original = createMesh(width, exactColour, jointCount);
+        auto mesh = original;
+
+        MeshHeaderV3 header;
+        header.flags = VertexFlags;
+        const auto stored = packMesh(header, mesh.vertexData, mesh.indexData);
+        const auto vertexCount = width * width;
+
+        CHECK(header.vertexCount == vertexCount);
+        CHECK(header.indexArrayCount == 2);
+        CHECK(header.indexSize == (vertexCount > 65536 ? 4 : 2));
+        CHECK(header.storedSize == stored.size());
+        CHECK(header.compression == Compression::LZ4 || header.storedSize == header.payloadSize);
+        CHECK(header.attributeFormats[Mesh::Attribute::Position] == AttributeFormat::Float);
+        CHECK(header.attributeFormats[Mesh::Attribute::Colour] == (exactColour ? AttributeFormat::UNorm8 : AttributeFormat::Float));
+        CHECK(header.attributeFormats[Mesh::Attribute::Normal] == AttributeFormat::SNorm16);
+        CHECK(header.attributeFormats[Mesh::Attribute::Tangent] == AttributeFormat::SNorm16);
+        CHECK(header.attributeFormats[Mesh::Attribute::UV0] == AttributeFormat::Float);
+        CHECK(header.attributeFormats[Mesh::Attribute::UV1] == AttributeFormat::Float);
+        CHECK(header.attributeFormats[Mesh::Attribute::BlendIndices] == (jointCount > 256 ? AttributeFormat::UInt16 : AttributeFormat::UInt8));
+        CHECK(header.attributeFormats[Mesh::Attribute::BlendWeights] == AttributeFormat::UNorm8);
+
+        //the mesh is reordered but the triangles are unchanged
+        CHECK(mesh.vertexData.size() == original.vertexData.size());
+        CHECK(getTriangles(mesh.vertexData, VertexStride, mesh.indexData) == getTriangles(original.vertexData, VertexStride, original.indexData));
+
+        PayloadV3 payload;
+        CHECK(readPayload(header, stored, payload));
+        CHECK(payload.data.size() == header.payloadSize);
+        CHECK(getIndices(header, payload) == mesh.indexData);
+
+        //vertices are in the order they're first used
+        std::uint32_t nextVertex = 0;
+        bool ordered = true;
+        for (const auto& indices : mesh.indexData)
+        {
+            for (auto index : indices)
+            {
+                ordered = ordered && index <= nextVertex;
+                if (index == nextVertex)
+                {
+                    nextVertex++;
+                }
+            }
+        }
+        CHECK(ordered);
+
+        std::vector<float> vertexData;
+        unpackVertices(header, payload, vertexData, false);
+        CHECK(vertexData.size() == mesh.vertexData.size());
+        if (vertexData.size() != mesh.vertexData.size())
+        {
+            return;
+        }
+
+        bool exact = true;
+        bool quantised = true;
+        bool weighted = true;
+        for (auto v = 0u; v < vertexCount; ++v)
+        {
+            const auto* expected = &mesh.vertexData[v * VertexStride];
+            const auto* actual = &vertexData[v * VertexStride];
+
+            for (auto offset : { PositionOffset, PositionOffset + 1, PositionOffset + 2,
+                ColourOffset, ColourOffset + 1, ColourOffset + 2, ColourOffset + 3,
+                UV0Offset, UV0Offset + 1, UV1Offset, UV1Offset + 1,
+                BlendIndexOffset, BlendIndexOffset + 1, BlendIndexOffset + 2, BlendIndexOffset + 3 })
+            {
+                exact = exact && actual[offset] == expected[offset];
+            }
+
+            for (auto offset = NormalOffset; offset < UV0Offset; ++offset)
+            {
+                quantised = quantised && std::abs(actual[offset] - expected[offset]) <= SNormPrecision;
+            }
+
+            float sum = 0.f;
+            for (auto offset = BlendWeightOffset; offset < VertexStride; ++offset)
+            {
+                //renormalising may move the largest weight by a few steps
+                weighted = weighted && std::abs(actual[offset] - expected[offset]) <= 3.f / 255.f;
+                sum += actual[offset];
+            }
+            weighted = weighted && std::abs(sum - 1.f) < 1e-5f;
+        }
+        CHECK(exact);
+        CHECK(quantised);
+        CHECK(weighted);
+
+        //BinaryMeshBuilder replaces the tangent sign with a bitangent
+        std::vector<float> expanded;
+        unpackVertices(header, payload, expanded, true);
+        CHECK(expanded.size() == vertexCount * (VertexStride + 2));
+        if (expanded.size() == vertexCount * (VertexStride + 2))
+        {
+            bool bitangents = true;
+            for (auto v = 0u; v < vertexCount; ++v)
+            {
+                const auto* vert = &expanded[v * (VertexStride + 2)];
+                const auto* source = &vertexData[v * VertexStride];
+                const glm::vec3 normal(vert[NormalOffset], vert[NormalOffset + 1], vert[NormalOffset + 2]);
+                const glm::vec3 tangent(vert[TangentOffset], vert[TangentOffset + 1], vert[TangentOffset + 2]);
+                const auto bitangent = glm::cross(normal, tangent) * source[TangentOffset + 3];
+
+                bitangents = bitangents
+                    && std::abs(vert[TangentOffset + 3] - bitangent.x) < 1e-6f
+                    && std::abs(vert[TangentOffset + 4] - bitangent.y) < 1e-6f
+                    && std::abs(vert[TangentOffset + 5] - bitangent.z) < 1e-6f
+                    && vert[UV0Offset + 2] == source[UV0Offset];
+            }
+            CHECK(bitangents);
+        }
+
+        //and the whole file, with indices widened to 32 bit
+        const std::string path = "test_ModelBinary.cmb";
+        CHECK(writeFile(path, header, stored));
+
+        std::vector<float> fileVerts;
+        std::vector<std::vector<std::uint32_t>> fileIndices;
+        const auto meshData = read(path, fileVerts, fileIndices);
+        std::remove(path.c_str());
+
+        CHECK(meshData.vertexCount == vertexCount);
+        CHECK(meshData.vertexSize == VertexStride * sizeof(float));
+        CHECK(meshData.submeshCount == 2);
+        CHECK(meshData.attributeFlags == VertexFlags);
+        CHECK(fileVerts == vertexData);
+        CHECK(fileIndices == mesh.indexData);
+    }
+
+    bool isConsistent(const MeshHeaderV3& header, const PayloadV3& payload)
+    {
+        std::uint64_t indexCount = 0;
+        for (auto size : payload.arraySizes)
+        {
+            indexCount += size;
+        }
+
+        if (payload.arraySizes.size() != header.indexArrayCount
+            || payload.vertexOffset != header.indexArrayCount * sizeof(std::uint32_t)
+            || payload.indexOffset < payload.vertexOffset
+            || payload.indexOffset + (indexCount * header.indexSize) != payload.data.size())
+        {
+            return false;
+        }
+
+        for (const auto& indices : getIndices(header, payload))
+        {
+            for (auto index : indices)
+            {
+                if (index >= header.vertexCount)
+                {
+                    return false;
+                }
+            }
+        }
+
+        //all the vertices can be unpacked
+        std::size_t vertexStride = 0;
+        for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+        {
+            if (header.flags & (1 << i))
+            {
+                vertexStride += (i == Mesh::Attribute::Position || i == Mesh::Attribute::Normal) ? 3
+                    : (i == Mesh::Attribute::UV0 || i == Mesh::Attribute::UV1) ? 2
+                    : (i == Mesh::Attribute::Bitangent) ? 0 : 4;
+            }
+        }
+
+        std::vector<float> vertexData;
+        unpackVertices(header, payload, vertexData, false);
+        return vertexData.size() == vertexStride * header.vertexCount;
+    }
+
+    void testCorruption()
+    {
+        auto mesh = createMesh(20, true, 20);
+        MeshHeaderV3 compressedHeader;
+        compressedHeader.flags = VertexFlags;
+        const auto compressed = packMesh(compressedHeader, mesh.vertexData, mesh.indexData);
+        CHECK(compressedHeader.compression == Compression::LZ4);
+
+        //the same payload stored uncompressed
+        auto uncompressedHeader = compressedHeader;
+        std::vector<std::uint8_t> uncompressed(uncompressedHeader.payloadSize);
+        CHECK(Detail::LZ4::decompress(compressed.data(), compressed.size(), uncompressed.data(), uncompressed.size()));
+        uncompressedHeader.compression = Compression::None;
+        uncompressedHeader.storedSize = uncompressedHeader.payloadSize;
+
+        std::uniform_int_distribution<int> bitDist(0, 31);
+        std::uniform_int_distribution<int> countDist(1, 4);
+        std::uniform_int_distribution<int> fieldDist(0, 7);
+
+        bool rejected = true;
+        bool consistent = true;
+        for (auto i = 0u; i < CorruptionCount; ++i)
+        {
+            auto header = (i % 2) ? compressedHeader : uncompressedHeader;
+            auto stored = (i % 2) ? compressed : uncompressed;
+
+            //sizes which don't match the data are always rejected
+            bool invalidSize = false;
+
+            const auto flip = [&](auto& value)
+            {
+                value ^= static_cast<std::remove_reference_t<decltype(value)>>(1ull << (bitDist(rng) % (sizeof(value) * 8)));
+            };
+
+            switch (i % 5)
+            {
+            default:
+            {
+                std::uniform_int_distribution<std::size_t> byteDist(0, stored.size() - 1);
+                const auto count = countDist(rng);
+                for (auto j = 0; j < count; ++j)
+                {
+                    stored[byteDist(rng)] ^= static_cast<std::uint8_t>(1 << (bitDist(rng) % 8));
+                }
+            }
+                break;
+            case 3:
+                //truncated file
+                stored.resize(std::uniform_int_distribution<std::size_t>(0, stored.size() - 1)(rng));
+                invalidSize = true;
+                break;
+            case 4:
+                switch (fieldDist(rng))
+                {
+                default:
+                case 0: flip(header.vertexCount); break;
+                case 1: flip(header.flags); break;
+                case 2: flip(header.indexArrayCount); break;
+                case 3: flip(header.attributeFormats[std::uniform_int_distribution<std::size_t>(0, Mesh::Attribute::Total - 1)(rng)]); break;
+                case 4: flip(header.indexSize); invalidSize = true; break;
+                case 5: flip(header.compression); break;
+                case 6: flip(header.payloadSize); invalidSize = true; break;
+                case 7: flip(header.storedSize); invalidSize = true; break;
+                }
+                break;
+            }
+
+            PayloadV3 payload;
+            if (readPayload(header, stored, payload))
+            {
+                rejected = rejected && !invalidSize;
+                consistent = consistent && isConsistent(header, payload);
+            }
+        }
+        CHECK(rejected);
+        CHECK(consistent);
+
+        //and files which fail are read as empty
+        const std::string path = "test_ModelBinary.cmb";
+        auto header = compressedHeader;
+        header.indexSize = 3;
+        CHECK(writeFile(path, header, compressed));
+
+        //this logs an error, which is expected
+        std::vector<float> fileVerts = { 1.f };
+        std::vector<std::vector<std::uint32_t>> fileIndices(1);
+        const auto meshData = read(path, fileVerts, fileIndices);
+        std::remove(path.c_str());
+
+        CHECK(meshData.vertexCount == 0);
+        CHECK(fileVerts.empty());
+        CHECK(fileIndices.empty());
+    }
+}
+
+int main()
+{
+    testRoundTrip(40, true, 20);
+    testRoundTrip(40, false, 300);
+    testRoundTrip(260, true, 256);
+    testCorruption();
+
+    return finish("ModelBinary");
+}
@@ -0,0 +1,401 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+/*
+Checks the frame format used by NetBatch to combine packets and by
+NetDemux to split them again. Packet sizes either side of each varint
+boundary must survive the round trip, a batch holding a single packet
+must be sent as a plain packet, and a packet too large to be batched
+must cause the packets queued before it to be sent first so that the
+order of delivery is kept. Malformed batches must be dropped without
+queuing any of their packets, and packets split from a batch must share
+it until the last of their events is destroyed.
+*/
+
+//enet.h must always be included first on windows
+#include "../../../crogine/src/network/NetBatch.hpp"
+
+#include "Test.hpp"
+
+#include <crogine/core/Log.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using namespace cro;
+    using namespace cro::Detail;
+
+    struct SentPacket final
+    {
+        std::uint8_t channel = 0;
+        ENetPacket* packet = nullptr;
+    };
+
+    std::vector<SentPacket> sentPackets;
+    const NetBatch::SendFunc sendFunc =
+        [](std::uint8_t channel, ENetPacket* packet)
+    {
+        sentPackets.push_back({ channel, packet });
+    };
+
+    void clearSentPackets()
+    {
+        for (auto& sent : sentPackets)
+        {
+            enet_packet_destroy(sent.packet);
+        }
+        sentPackets.clear();
+    }
+
+    std::size_t destroyedCount = 0;
+    void onDestroy(ENetPacket*)
+    {
+        destroyedCount++;
+    }
+
+    //creates a received packet which counts its destruction
+    ENetPacket* createReceived(const std::vector<std::uint8_t>& data)
+    {
+        auto* packet = enet_packet_create(data.data(), data.size(), 0);
+        packet->freeCallback = onDestroy;
+        return packet;
+    }
+
+    std::vector<std::uint8_t> createData(std::size_t size, std::uint8_t seed)
+    {
+        std::vector<std::uint8_t> data(size);
+        for (auto i = 0u; i < size; ++i)
+        {
+            data[i] = static_cast<std::uint8_t>(seed + i * 7);
+        }
+        return data;
+    }
+
+    bool matches(const NetEvent& evt, std::uint8_t id, const std::vector<std::uint8_t>& data)
+    {
+        return evt.type == NetEvent::PacketReceived
+            && evt.packet.getID() == id
+            && evt.packet.getSize() == data.size()
+            && (data.empty() || std::memcmp(evt.packet.getData(), data.data(), data.size()) == 0);
+    }
+
+    void testVarintSizes()
+    {
+        //sizes which need 1, 2 and 3 bytes to encode
+        const std::vector<std::size_t> sizes = { 0, 1, 127, 128, 129, 16383, 16384 };
+
+        for (auto size : sizes)
+        {
+            //large sizes won't fit in a batch made by NetBatch,
+            //but must still be read by NetDemux
+            const auto data = createData(size, static_cast<std::uint8_t>(size));
+            std::vector<std::uint8_t> batch = { NetBatchID, 1 };
+            auto length = size;
+            while (length > 0x7f)
+            {
+                batch.push_back(static_cast<std::uint8_t>((length & 0x7f) | 0x80));
+                length >>= 7;
+            }
+            batch.push_back(static_cast<std::uint8_t>(length));
+            CHECK(batch.size() == 2 + (size < 128 ? 1 : size < 16384 ? 2 : 3));
+
+            batch.insert(batch.end(), data.begin(), data.end());
+            batch.insert(batch.end(), { 2, 1, 0xaa });
+
+            NetDemux demux;
+            destroyedCount = 0;
+            CHECK(demux.push(createReceived(batch), nullptr, 0));
+            {
+                NetEvent first;
+                NetEvent second;
+                NetEvent none;
+                CHECK(demux.pop(first));
+                CHECK(demux.pop(second));
+                CHECK(!demux.pop(none));
+
+                CHECK(matches(first, 1, data));
+                CHECK(matches(second, 2, { 0xaa }));
+            }
+            CHECK(destroyedCount == 1);
+        }
+
+        //packets either side of the first boundary written by NetBatch
+        NetBatch batch;
+        const auto small = createData(127, 1);
+        const auto large = createData(128, 2);
+        CHECK(batch.add(1, small.data(), small.size(), NetFlag::Reliable, 0, sendFunc));
+        CHECK(batch.add(2, large.data(), large.size(), NetFlag::Reliable, 0, sendFunc));
+        CHECK(sentPackets.empty());
+        batch.flush(sendFunc);
+        CHECK(batch.empty());
+
+        CHECK(sentPackets.size() == 1);
+        if (sentPackets.size() == 1)
+        {
+            const auto* packet = sentPackets[0].packet;
+            CHECK(packet->dataLength == 1 + (1 + 1 + 127) + (1 + 2 + 128));
+            CHECK(packet->flags & ENET_PACKET_FLAG_RELIABLE);
+            CHECK(packet->data[0] == NetBatchID);
+            CHECK(packet->data[1] == 1);
+            CHECK(packet->data[2] == 0x7f);
+            CHECK(packet->data[3 + 127] == 2);
+            CHECK(packet->data[4 + 127] == 0x80);
+            CHECK(packet->data[5 + 127] == 0x01);
+
+            NetDemux demux;
+            CHECK(demux.push(createReceived({ packet->data, packet->data + packet->dataLength }), nullptr, 0));
+
+            NetEvent first;
+            NetEvent second;
+            CHECK(demux.pop(first));
+            CHECK(demux.pop(second));
+            CHECK(matches(first, 1, small));
+            CHECK(matches(second, 2, large));
+        }
+        clearSentPackets();
+    }
+
+    void testSinglePacket()
+    {
+        NetBatch batch;
+        const auto data = createData(200, 3);
+        CHECK(batch.add(7, data.data(), data.size(), NetFlag::Unreliable, 2, sendFunc));
+        batch.flush(sendFunc);
+
+        //sent exactly as createNetPacket() would have made it
+        CHECK(sentPackets.size() == 1);
+        if (sentPackets.size() == 1)
+        {
+            const auto* packet = sentPackets[0].packet;
+            CHECK(sentPackets[0].channel == 2);
+            CHECK(packet->flags & ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT);
+            CHECK(packet->dataLength == data.size() + 1);
+            CHECK(packet->data[0] == 7);
+            CHECK(std::memcmp(&packet->data[1], data.data(), data.size()) == 0);
+
+            //which isn't mistaken for a batch when received
+            NetDemux demux;
+            CHECK(!demux.push(sentPackets[0].packet, nullptr, 0));
+        }
+        clearSentPackets();
+
+        //flushing again sends nothing
+        batch.flush(sendFunc);
+        CHECK(sentPackets.empty());
+    }
+
+    void testOrder()
+    {
+        NetBatch batch;
+        const auto small = createData(10, 4);
+        const auto oversize = createData(1200, 5);
+
+        CHECK(batch.add(1, small.data(), small.size(), NetFlag::Reliable, 0, sendFunc));
+        CHECK(batch.add(2, small.data(), small.size(), NetFlag::Reliable, 0, sendFunc));
+        CHECK(batch.add(3, small.data(), small.size(), NetFlag::Reliable, 1, sendFunc));
+        CHECK(batch.add(4, small.data(), small.size(), NetFlag::Unreliable, 0, sendFunc));
+
+        //only the batch for the same flags and channel is sent
+        CHECK(!batch.add(5, oversize.data(), oversize.size(), NetFlag::Reliable, 0, sendFunc));
+        CHECK(sentPackets.size() == 1);
+        CHECK(!batch.empty());
+        if (sentPackets.size() == 1)
+        {
+            CHECK(sentPackets[0].channel == 0);
+            CHECK(sentPackets[0].packet->flags & ENET_PACKET_FLAG_RELIABLE);
+            CHECK(sentPackets[0].packet->data[0] == NetBatchID);
+            CHECK(sentPackets[0].packet->data[1] == 1);
+        }
+        batch.flush(sendFunc);
+        CHECK(batch.empty());
+        CHECK(sentPackets.size() == 3);
+        clearSentPackets();
+
+        //filling a batch sends it before the packet which doesn't fit
+        std::vector<std::uint8_t> ids;
+        const auto medium = createData(300, 6);
+        for (std::uint8_t i = 0; i < 20; ++i)
+        {
+            CHECK(batch.add(i, medium.data(), medium.size(), NetFlag::Reliable, 0, sendFunc));
+            ids.push_back(i);
+        }
+        CHECK(!batch.add(20, oversize.data(), oversize.size(), NetFlag::Reliable, 0, sendFunc));
+        CHECK(batch.empty());
+
+        //each batch stays under the size of a datagram
+        NetDemux demux;
+        for (auto& sent : sentPackets)
+        {
+            CHECK(sent.packet->dataLength <= 1200);
+            CHECK(demux.push(sent.packet, nullptr, 0));
+        }
+        sentPackets.clear();
+
+        std::size_t count = 0;
+        auto evt = std::make_unique<NetEvent>();
+        while (demux.pop(*evt))
+        {
+            CHECK(count < ids.size() && evt->packet.getID() == ids[count]);
+            CHECK(matches(*evt, evt->packet.getID(), medium));
+            count++;
+            evt = std::make_unique<NetEvent>();
+        }
+        CHECK(count == ids.size());
+    }
+
+    void testMalformed()
+    {
+        const std::vector<std::vector<std::uint8_t>> batches =
+        {
+            //no frames
+            { NetBatchID },
+            //no size
+            { NetBatchID, 1 },
+            //truncated size
+            { NetBatchID, 1, 0x80 },
+            //size longer than a 32 bit value
+            { NetBatchID, 1, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 },
+            //size beyond the end of the packet
+            { NetBatchID, 1, 3, 0xaa, 0xbb },
+            //valid frame followed by a truncated one
+            { NetBatchID, 1, 1, 0xaa, 2, 2, 0xbb },
+        };
+
+        //the warnings are expected
+        const auto logLevel = Logger::getLogLevel();
+        Logger::setLogLevel(Logger::Type::Error);
+
+        NetDemux demux;
+        for (const auto& data : batches)
+        {
+            destroyedCount = 0;
+            CHECK(demux.push(createReceived(data), nullptr, 0));
+            CHECK(destroyedCount == 1);
+
+            NetEvent evt;
+            CHECK(!demux.pop(evt));
+        }
+
+        Logger::setLogLevel(logLevel);
+
+        //packets queued before a malformed batch are kept
+        destroyedCount = 0;
+        CHECK(demux.push(createReceived({ NetBatchID, 1, 1, 0xaa }), nullptr, 0));
+        Logger::setLogLevel(Logger::Type::Error);
+        CHECK(demux.push(createReceived({ NetBatchID, 2, 2, 0xbb }), nullptr, 0));
+        Logger::setLogLevel(logLevel);
+        CHECK(destroyedCount == 1);
+        {
+            NetEvent first;
+            NetEvent none;
+            CHECK(demux.pop(first));
+            CHECK(matches(first, 1, { 0xaa }));
+            CHECK(!demux.pop(none));
+        }
+        CHECK(destroyedCount == 2);
+
+        //empty packets and those which aren't batches aren't taken
+        auto* empty = createReceived({});
+        CHECK(!demux.push(empty, nullptr, 0));
+        auto* plain = createReceived({ 1, 0xaa });
+        CHECK(!demux.push(plain, nullptr, 0));
+        enet_packet_destroy(empty);
+        enet_packet_destroy(plain);
+    }
+
+    void testReferenceCount()
+    {
+        const std::vector<std::uint8_t> data = { NetBatchID, 1, 1, 0xaa, 2, 0, 3, 2, 0xbb, 0xcc };
+
+        NetDemux demux;
+        destroyedCount = 0;
+        auto* packet = createReceived(data);
+        CHECK(demux.push(packet, nullptr, 5));
+        CHECK(packet->referenceCount == 3);
+
+        auto first = std::make_unique<NetEvent>();
+        auto second = std::make_unique<NetEvent>();
+        auto third = std::make_unique<NetEvent>();
+        CHECK(demux.pop(*first));
+        CHECK(demux.pop(*second));
+        CHECK(demux.pop(*third));
+        CHECK(first->channel == 5);
+        CHECK(matches(*first, 1, { 0xaa }));
+        CHECK(matches(*second, 2, {}));
+        CHECK(matches(*third, 3, { 0xbb, 0xcc }));
+
+        //events may be destroyed in any order
+        second.reset();
+        CHECK(destroyedCount == 0);
+        CHECK(packet->referenceCount == 2);
+
+        //moving an event doesn't release the packet twice
+        NetEvent moved = std::move(*third);
+        third.reset();
+        CHECK(destroyedCount == 0);
+        CHECK(packet->referenceCount == 2);
+        CHECK(matches(moved, 3, { 0xbb, 0xcc }));
+
+        first.reset();
+        CHECK(destroyedCount == 0);
+        CHECK(packet->referenceCount == 1);
+        moved = NetEvent();
+        CHECK(destroyedCount == 1);
+
+        //clearing the queue releases the frames not yet popped
+        destroyedCount = 0;
+        packet = createReceived(data);
+        CHECK(demux.push(packet, nullptr, 0));
+        {
+            NetEvent evt;
+            CHECK(demux.pop(evt));
+            demux.clear();
+            CHECK(destroyedCount == 0);
+            CHECK(packet->referenceCount == 1);
+
+            NetEvent none;
+            CHECK(!demux.pop(none));
+        }
+        CHECK(destroyedCount == 1);
+    }
+}
+
+int main()
+{
+    testVarintSizes();
+    testSinglePacket();
+    testOrder();
+    testMalformed();
+    testReferenceCount();
+
+    return finish("NetBatch");
+}
@@ -0,0 +1,459 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Checks the bit packed delta encoding of Snapshots. A set of entities,
+some moving and some being added or removed, is encoded each tick and
+decoded by a client, and every decoded snapshot must match the one
+committed by the server exactly. This is done with full snapshots,
+with deltas, over a connection which loses and reorders packets, and
+with baselines which the client doesn't have or which are older than
+the history. Finally valid packets are corrupted by flipping bits and
+truncating them, and any which are rejected must leave the decoder
+exactly as it was.
+*/
+
+#include "Test.hpp"
+
+#include <crogine/network/Snapshot.hpp>
+
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t EntityCount = 200;
+    constexpr std::size_t TickCount = 2000;
+    constexpr std::size_t HistorySize = 32;
+    constexpr std::size_t CorruptionCount = 20000;
+
+    std::mt19937 rng(1234);
+
+    struct Fields final
+    {
+        std::size_t position = 0;
+        std::size_t rotation = 0;
+        std::size_t health = 0;
+        std::size_t state = 0;
+    };
+
+    cro::SnapshotSchema createSchema(Fields& fields)
+    {
+        cro::SnapshotSchema schema;
+        fields.position = schema.addVec3(glm::vec3(-100.f), glm::vec3(100.f), 16);
+        fields.rotation = schema.addQuat();
+        fields.health = schema.addFloat(0.f, 1.f, 8);
+        fields.state = schema.addUInt(6);
+        return schema;
+    }
+
+    struct Entity final
+    {
+        std::uint32_t id = 0;
+        glm::vec3 position = glm::vec3(0.f);
+        glm::quat rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
+        float health = 1.f;
+        std::uint32_t state = 0;
+        bool moving = false;
+    };
+
+    float randomFloat(float min, float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(rng);
+    }
+
+    Entity randomEntity(std::uint32_t id)
+    {
+        Entity e;
+        e.id = id;
+        e.position = glm::vec3(randomFloat(-100.f, 100.f), randomFloat(-100.f, 100.f), randomFloat(-100.f, 100.f));
+        e.rotation = glm::normalize(glm::quat(randomFloat(-1.f, 1.f), randomFloat(-1.f, 1.f), randomFloat(-1.f, 1.f), randomFloat(-1.f, 1.f)));
+        e.health = randomFloat(0.f, 1.f);
+        e.state = rng() % 64;
+        e.moving = (rng() % 4) == 0;
+        return e;
+    }
+
+    //moves some entities, and replaces a few with new IDs
+    void update(std::vector<Entity>& entities, std::uint32_t& nextID)
+    {
+        for (auto& e : entities)
+        {
+            if (e.moving)
+            {
+                e.position += glm::vec3(randomFloat(-1.f, 1.f), 0.f, randomFloat(-1.f, 1.f));
+                e.position = glm::clamp(e.position, glm::vec3(-100.f), glm::vec3(100.f));
+                e.rotation = glm::normalize(e.rotation * glm::quat(glm::vec3(0.f, 0.05f, 0.f)));
+            }
+        }
+
+        if (rng() % 4 == 0)
+        {
+            auto& e = entities[rng() % entities.size()];
+            e = randomEntity(nextID);
+            nextID += 1 + (rng() % 100);
+        }
+    }
+
+    void commit(cro::SnapshotEncoder& encoder, const Fields& fields, const std::vector<Entity>& entities, std::int32_t timestamp)
+    {
+        auto& snapshot = encoder.beginSnapshot(timestamp);
+        for (const auto& e : entities)
+        {
+            auto index = snapshot.addEntity(e.id);
+            snapshot.setVec3(index, fields.position, e.position);
+            snapshot.setQuat(index, fields.rotation, e.rotation);
+            snapshot.setFloat(index, fields.health, e.health);
+            snapshot.setUInt(index, fields.state, e.state);
+        }
+        encoder.commit();
+    }
+
+    bool equal(const cro::Snapshot& a, const cro::Snapshot& b, const Fields& fields)
+    {
+        if (a.getSequence() != b.getSequence()
+            || a.getTimestamp() != b.getTimestamp()
+            || a.getEntityCount() != b.getEntityCount())
+        {
+            return false;
+        }
+
+        for (auto i = 0u; i < a.getEntityCount(); ++i)
+        {
+            if (a.getEntityID(i) != b.getEntityID(i)
+                || a.getVec3(i, fields.position) != b.getVec3(i, fields.position)
+                || a.getQuat(i, fields.rotation) != b.getQuat(i, fields.rotation)
+                || a.getFloat(i, fields.health) != b.getFloat(i, fields.health)
+                || a.getUInt(i, fields.state) != b.getUInt(i, fields.state))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //the byte following the 32 bit sequence number is the distance to the baseline
+    bool isDelta(const std::vector<std::uint8_t>& data)
+    {
+        return data.size() > 4 && data[4] != 0;
+    }
+
+    void testFullAndDelta()
+    {
+        Fields fields;
+        const auto schema = createSchema(fields);
+        cro::SnapshotEncoder encoder(schema, HistorySize);
+        cro::SnapshotDecoder decoder(schema, HistorySize);
+
+        std::vector<Entity> entities;
+        std::uint32_t nextID = 0;
+        for (auto i = 0u; i < EntityCount; ++i)
+        {
+            entities.push_back(randomEntity(nextID));
+            nextID += 1 + (rng() % 4);
+        }
+
+        //nothing committed yet so nothing to send
+        std::vector<std::uint8_t> data;
+        encoder.encode(0, data);
+        CHECK(data.empty());
+        CHECK(!decoder.decode(data.data(), data.size()));
+
+        //unacknowledged, so full
+        commit(encoder, fields, entities, 0);
+        encoder.encode(0, data);
+        CHECK(!isDelta(data));
+        CHECK(decoder.decode(data.data(), data.size()));
+        CHECK(decoder.getSequence() == 1);
+        CHECK(equal(decoder.getSnapshot(), encoder.getSnapshot(), fields));
+
+        //the same data again is older than the current snapshot
+        CHECK(!decoder.decode(data.data(), data.size()));
+
+        for (auto i = 1u; i < 100; ++i)
+        {
+            update(entities, nextID);
+            commit(encoder, fields, entities, static_cast<std::int32_t>(i * 50));
+
+            std::vector<std::uint8_t> full;
+            encoder.encode(0, full);
+            encoder.encode(decoder.getSequence(), data);
+            CHECK(isDelta(data));
+            CHECK(data.size() < full.size());
+
+            //a full snapshot decodes to the same thing on a fresh client
+            cro::SnapshotDecoder other(schema, HistorySize);
+            CHECK(other.decode(full.data(), full.size()));
+            CHECK(equal(other.getSnapshot(), encoder.getSnapshot(), fields));
+
+            CHECK(decoder.decode(data.data(), data.size()));
+            CHECK(equal(decoder.getSnapshot(), encoder.getSnapshot(), fields));
+        }
+
+        //unchanged entities cost little more than their IDs
+        commit(encoder, fields, entities, 5000);
+        encoder.encode(decoder.getSequence(), data);
+        CHECK(data.size() < 9 + EntityCount);
+        CHECK(decoder.decode(data.data(), data.size()));
+        CHECK(equal(decoder.getSnapshot(), encoder.getSnapshot(), fields));
+    }
+
+    void testBaselines()
+    {
+        Fields fields;
+        const auto schema = createSchema(fields);
+        cro::SnapshotEncoder encoder(schema, HistorySize);
+
+        std::vector<Entity> entities;
+        std::uint32_t nextID = 0;
+        for (auto i = 0u; i < EntityCount; ++i)
+        {
+            entities.push_back(randomEntity(nextID++));
+        }
+
+        commit(encoder, fields, entities, 0);
+        const auto first = encoder.getSnapshot().getSequence();
+        update(entities, nextID);
+        commit(encoder, fields, entities, 1);
+
+        //a delta against a baseline the client never received is rejected
+        std::vector<std::uint8_t> data;
+        encoder.encode(first, data);
+        CHECK(isDelta(data));
+
+        cro::SnapshotDecoder decoder(schema, HistorySize);
+        CHECK(!decoder.decode(data.data(), data.size()));
+        CHECK(decoder.getSequence() == 0);
+        CHECK(decoder.getSnapshot().getEntityCount() == 0);
+
+        //acknowledgements older than the history get a full snapshot
+        for (auto i = 0u; i < HistorySize; ++i)
+        {
+            update(entities, nextID);
+            commit(encoder, fields, entities, static_cast<std::int32_t>(i + 2));
+        }
+        encoder.encode(first, data);
+        CHECK(!isDelta(data));
+        CHECK(decoder.decode(data.data(), data.size()));
+        CHECK(equal(decoder.getSnapshot(), encoder.getSnapshot(), fields));
+
+        //as do acknowledgements from the future
+        update(entities, nextID);
+        commit(encoder, fields, entities, 100);
+        encoder.encode(encoder.getSnapshot().getSequence() + 10, data);
+        CHECK(!isDelta(data));
+        CHECK(decoder.decode(data.data(), data.size()));
+        CHECK(equal(decoder.getSnapshot(), encoder.getSnapshot(), fields));
+
+        //after a reset the client needs a full snapshot again
+        update(entities, nextID);
+        commit(encoder, fields, entities, 101);
+        encoder.encode(decoder.getSequence(), data);
+        decoder.reset();
+        CHECK(decoder.getSequence() == 0);
+        CHECK(!decoder.decode(data.data(), data.size()));
+    }
+
+    void testLossAndReorder()
+    {
+        Fields fields;
+        const auto schema = createSchema(fields);
+        cro::SnapshotEncoder encoder(schema, HistorySize);
+        cro::SnapshotDecoder decoder(schema, HistorySize);
+
+        std::vector<Entity> entities;
+        std::uint32_t nextID = 0;
+        for (auto i = 0u; i < EntityCount; ++i)
+        {
+            entities.push_back(randomEntity(nextID++));
+        }
+
+        //every committed snapshot, to check what the client decodes
+        std::map<std::uint32_t, cro::Snapshot> committed;
+
+        struct Packet final
+        {
+            std::size_t arrival = 0;
+            std::vector<std::uint8_t> data;
+        };
+        std::vector<Packet> inFlight;
+
+        //acknowledgements are delayed and lost too
+        std::deque<std::pair<std::size_t, std::uint32_t>> acks;
+        std::uint32_t serverAck = 0;
+
+        std::size_t decodedCount = 0;
+        std::size_t deltaCount = 0;
+        for (auto tick = 0u; tick < TickCount; ++tick)
+        {
+            update(entities, nextID);
+            commit(encoder, fields, entities, static_cast<std::int32_t>(tick));
+            committed[encoder.getSnapshot().getSequence()] = encoder.getSnapshot();
+
+            while (!acks.empty() && acks.front().first <= tick)
+            {
+                serverAck = std::max(serverAck, acks.front().second);
+                acks.pop_front();
+            }
+
+            Packet packet;
+            encoder.encode(serverAck, packet.data);
+            deltaCount += isDelta(packet.data) ? 1 : 0;
+
+            //20% lost, the rest arrive 1 to 4 ticks later so some overtake others
+            if (rng() % 5 != 0)
+            {
+                packet.arrival = tick + 1 + (rng() % 4);
+                inFlight.push_back(std::move(packet));
+            }
+
+            for (auto it = inFlight.begin(); it != inFlight.end();)
+            {
+                if (it->arrival <= tick)
+                {
+                    const auto previous = decoder.getSequence();
+                    if (decoder.decode(it->data.data(), it->data.size()))
+                    {
+                        decodedCount++;
+                        CHECK(decoder.getSequence() > previous);
+                        CHECK(equal(decoder.getSnapshot(), committed[decoder.getSequence()], fields));
+
+                        if (rng() % 5 != 0)
+                        {
+                            acks.emplace_back(tick + 1 + (rng() % 3), decoder.getSequence());
+                        }
+                    }
+                    else
+                    {
+                        CHECK(decoder.getSequence() == previous);
+                    }
+                    it = inFlight.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        //most packets should get through, and most as deltas
+        CHECK(decodedCount > TickCount / 2);
+        CHECK(deltaCount > TickCount / 2);
+    }
+
+    void testCorruption()
+    {
+        Fields fields;
+        const auto schema = createSchema(fields);
+        cro::SnapshotEncoder encoder(schema, HistorySize);
+        cro::SnapshotDecoder decoder(schema, HistorySize);
+
+        std::vector<Entity> entities;
+        std::uint32_t nextID = 0;
+        for (auto i = 0u; i < EntityCount; ++i)
+        {
+            entities.push_back(randomEntity(nextID++));
+        }
+
+        std::vector<std::uint8_t> data;
+        for (auto i = 0; i < 3; ++i)
+        {
+            update(entities, nextID);
+            commit(encoder, fields, entities, i);
+            encoder.encode(decoder.getSequence(), data);
+            CHECK(decoder.decode(data.data(), data.size()));
+        }
+
+        update(entities, nextID);
+        commit(encoder, fields, entities, 3);
+
+        std::vector<std::uint8_t> full;
+        encoder.encode(0, full);
+        encoder.encode(decoder.getSequence(), data);
+        CHECK(isDelta(data));
+
+        const auto sequence = decoder.getSequence();
+        const auto snapshot = decoder.getSnapshot();
+
+        std::size_t rejected = 0;
+        for (auto i = 0u; i < CorruptionCount; ++i)
+        {
+            auto corrupt = (i % 2) ? full : data;
+            const auto flips = 1 + (rng() % 4);
+            for (auto j = 0u; j < flips; ++j)
+            {
+                const auto bit = rng() % (corrupt.size() * 8);
+                corrupt[bit / 8] ^= static_cast<std::uint8_t>(1u << (bit % 8));
+            }
+
+            //decoding into a copy so each attempt starts from the same state
+            auto copy = decoder;
+            if (!copy.decode(corrupt.data(), corrupt.size()))
+            {
+                rejected++;
+                CHECK(copy.getSequence() == sequence);
+                CHECK(equal(copy.getSnapshot(), snapshot, fields));
+            }
+        }
+        CHECK(rejected != 0);
+
+        //every truncation loses bits which are read
+        for (auto size = 0u; size < data.size(); ++size)
+        {
+            auto copy = decoder;
+            CHECK(!copy.decode(data.data(), size));
+            CHECK(copy.getSequence() == sequence);
+            CHECK(equal(copy.getSnapshot(), snapshot, fields));
+        }
+
+        for (auto size = 0u; size < full.size(); ++size)
+        {
+            auto copy = decoder;
+            CHECK(!copy.decode(full.data(), size));
+            CHECK(copy.getSequence() == sequence);
+        }
+
+        //the original data still decodes afterwards
+        CHECK(decoder.decode(data.data(), data.size()));
+        CHECK(equal(decoder.getSnapshot(), encoder.getSnapshot(), fields));
+    }
+}
+
+int main()
+{
+    testFullAndDelta();
+    testBaselines();
+    testLossAndReorder();
+    testCorruption();
+
+    return finish("Snapshot");
+}
@@ -0,0 +1,199 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Checks that sorting the ModelRenderer's draw list keys puts opaque
+draws first, grouped by shader, material and mesh, then front to back,
+followed by transparent draws back to front. Each opaque mesh must be
+a single run within its shader and material so that it can be instanced,
+even when there are more than 256 meshes.
+*/
+
+#include "Test.hpp"
+
+#include <crogine/detail/SortKey.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace cro::Detail;
+
+namespace
+{
+    struct Draw final
+    {
+        std::uint32_t shader = 0;
+        std::uint32_t material = 0;
+        std::uint32_t mesh = 0;
+        float distance = 0.f;
+        bool transparent = false;
+        std::uint64_t key = 0;
+    };
+
+    std::uint64_t createKey(const Draw& d)
+    {
+        return d.transparent ?
+            SortKey::transparent(d.shader, d.material, d.mesh, d.distance) :
+            SortKey::opaque(d.shader, d.material, d.mesh, d.distance);
+    }
+
+    void testDepth()
+    {
+        //negative distances are behind the camera, so are drawn first
+        CHECK(SortKey::quantiseDepth(-10.f) == SortKey::quantiseDepth(0.f));
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> dist(0.f, 10000.f);
+        for (auto i = 0; i < 10000; ++i)
+        {
+            const auto a = dist(rng);
+            const auto b = dist(rng);
+            if (a < b)
+            {
+                CHECK(SortKey::quantiseDepth(a) <= SortKey::quantiseDepth(b));
+            }
+        }
+
+        //the depth has to be at least this precise to order
+        //models a few centimetres apart across a golf course
+        CHECK(SortKey::quantiseDepth(300.f) < SortKey::quantiseDepth(300.05f));
+        CHECK(SortKey::quantiseDepth(0.1f) < SortKey::quantiseDepth(0.11f));
+
+        //opaque draws only need to be roughly front to back
+        for (auto i = 0; i < 10000; ++i)
+        {
+            const auto a = dist(rng);
+            const auto b = dist(rng);
+            if (a < b)
+            {
+                CHECK(SortKey::quantiseOpaqueDepth(a) <= SortKey::quantiseOpaqueDepth(b));
+            }
+        }
+        CHECK(SortKey::quantiseOpaqueDepth(300.f) < SortKey::quantiseOpaqueDepth(303.f));
+        CHECK(SortKey::quantiseOpaqueDepth(0.1f) < SortKey::quantiseOpaqueDepth(0.101f));
+    }
+
+    void testFixedOrder()
+    {
+        //opaque groups by state before depth
+        CHECK(SortKey::opaque(1, 5, 5, 100.f) < SortKey::opaque(2, 0, 0, 1.f));
+        CHECK(SortKey::opaque(1, 1, 5, 100.f) < SortKey::opaque(1, 2, 0, 1.f));
+        CHECK(SortKey::opaque(1, 1, 1, 100.f) < SortKey::opaque(1, 1, 2, 1.f));
+        CHECK(SortKey::opaque(1, 1, 1, 1.f) < SortKey::opaque(1, 1, 1, 100.f));
+
+        //transparent is always after opaque, and sorted by depth first
+        CHECK(SortKey::opaque(0x7FFF, 0xFFFF, 0xFFFF, 100000.f) < SortKey::transparent(0, 0, 0, 100000.f));
+        CHECK(SortKey::transparent(2, 0, 0, 100.f) < SortKey::transparent(1, 0, 0, 1.f));
+        CHECK(SortKey::transparent(1, 1, 1, 1.f) < SortKey::transparent(1, 1, 2, 1.f));
+
+        //IDs are truncated to fit, and mustn't overflow into the other fields
+        CHECK((SortKey::opaque(0xFFFFFFFF, 0, 0, 0.f) & SortKey::TransparentBit) == 0);
+        CHECK(SortKey::opaque(0, 0xFFFFFFFF, 0, 0.f) < SortKey::opaque(1, 0, 0, 0.f));
+        CHECK(SortKey::opaque(0, 0, 0xFFFFFFFF, 0.f) < SortKey::opaque(0, 1, 0, 0.f));
+
+        //opaque meshes don't collide until there are more than 65536 buffers
+        CHECK(SortKey::opaque(1, 1, 0, 100.f) < SortKey::opaque(1, 1, 0x100, 1.f));
+        CHECK(SortKey::opaque(1, 1, 0xFFFE, 100.f) < SortKey::opaque(1, 1, 0xFFFF, 1.f));
+    }
+
+    void testRandomOrder()
+    {
+        std::mt19937 rng(5678);
+        std::uniform_int_distribution<std::uint32_t> id(0, 6);
+        std::uniform_int_distribution<std::uint32_t> meshID(0, 2000);
+        std::uniform_real_distribution<float> dist(0.f, 500.f);
+
+        std::vector<Draw> draws(5000);
+        for (auto& d : draws)
+        {
+            d.shader = id(rng);
+            d.material = id(rng);
+            d.mesh = meshID(rng);
+            d.distance = dist(rng);
+            d.transparent = id(rng) == 0;
+            d.key = createKey(d);
+        }
+
+        std::sort(draws.begin(), draws.end(), [](const Draw& a, const Draw& b) { return a.key < b.key; });
+
+        for (auto i = 1u; i < draws.size(); ++i)
+        {
+            const auto& a = draws[i - 1];
+            const auto& b = draws[i];
+
+            CHECK(a.transparent <= b.transparent);
+            if (!a.transparent && !b.transparent)
+            {
+                CHECK(a.shader <= b.shader);
+                if (a.shader == b.shader)
+                {
+                    CHECK(a.material <= b.material);
+                    if (a.material == b.material)
+                    {
+                        CHECK(a.mesh <= b.mesh);
+                        if (a.mesh == b.mesh)
+                        {
+                            CHECK(SortKey::quantiseOpaqueDepth(a.distance) <= SortKey::quantiseOpaqueDepth(b.distance));
+                        }
+                    }
+                }
+            }
+            else if (a.transparent && b.transparent)
+            {
+                CHECK(SortKey::quantiseDepth(a.distance) >= SortKey::quantiseDepth(b.distance));
+            }
+        }
+
+        //each mesh is a single run within its shader and material, so it can be instanced
+        std::vector<std::uint64_t> runs;
+        for (auto i = 0u; i < draws.size(); ++i)
+        {
+            const auto& d = draws[i];
+            if (!d.transparent
+                && (i == 0 || d.shader != draws[i - 1].shader || d.material != draws[i - 1].material || d.mesh != draws[i - 1].mesh))
+            {
+                runs.push_back((static_cast<std::uint64_t>(d.shader) << 48) | (static_cast<std::uint64_t>(d.material) << 32) | d.mesh);
+            }
+        }
+        const auto runCount = runs.size();
+        std::sort(runs.begin(), runs.end());
+        CHECK(std::unique(runs.begin(), runs.end()) - runs.begin() == static_cast<std::ptrdiff_t>(runCount));
+    }
+}
+
+int main()
+{
+    testDepth();
+    testFixedOrder();
+    testRandomOrder();
+
+    return finish("SortKey");
+}
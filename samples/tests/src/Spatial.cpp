@@ -0,0 +1,230 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Checks that the batched frustum tests in Spatial, which use SSE/AVX or
+NEON where available, give exactly the same results as testing each
+Sphere or Box against every plane with the scalar functions. Batches
+of every size up to a few words of results are tested so that the
+scalar remainder is covered, along with bounds placed exactly on the
+frustum planes, where differences in rounding would show up first.
+*/
+
+#include "Test.hpp"
+
+#include <crogine/graphics/Spatial.hpp>
+#include <crogine/graphics/BoundingBox.hpp>
+#include <crogine/detail/glm/gtc/matrix_transform.hpp>
+
+#include <random>
+
+namespace
+{
+    constexpr std::size_t FrustumCount = 50;
+    constexpr std::size_t MaxBatchSize = 200;
+
+    std::mt19937 rng(1234);
+
+    bool scalarVisible(const cro::Frustum& frustum, const cro::Sphere& sphere)
+    {
+        for (const auto& plane : frustum)
+        {
+            if (cro::Spatial::intersects(plane, sphere) == cro::Planar::Back)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool scalarVisible(const cro::Frustum& frustum, const cro::Box& box)
+    {
+        for (const auto& plane : frustum)
+        {
+            if (cro::Spatial::intersects(plane, box) == cro::Planar::Back)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    cro::Frustum randomFrustum()
+    {
+        std::uniform_real_distribution<float> pos(-50.f, 50.f);
+        std::uniform_real_distribution<float> fov(0.3f, 1.5f);
+        std::uniform_real_distribution<float> aspect(0.5f, 2.5f);
+        std::uniform_int_distribution<int> type(0, 3);
+
+        const glm::vec3 eye(pos(rng), pos(rng), pos(rng));
+        glm::vec3 target(pos(rng), pos(rng), pos(rng));
+        if (glm::length(target - eye) < 1.f)
+        {
+            target = eye + glm::vec3(0.f, 0.f, -10.f);
+        }
+        const auto view = glm::lookAt(eye, target, glm::vec3(0.f, 1.f, 0.f));
+
+        //orthographic as used by shadow map cascades
+        const auto projection = type(rng) == 0 ?
+            glm::ortho(-30.f, 30.f, -20.f, 20.f, 0.1f, 100.f) :
+            glm::perspective(fov(rng), aspect(rng), 0.1f, 150.f);
+
+        cro::Frustum frustum;
+        cro::Spatial::updateFrustum(frustum, projection * view);
+        return frustum;
+    }
+
+    //a sphere which touches the given plane from behind, so that
+    //the scalar distance is exactly equal to the radius
+    cro::Sphere boundarySphere(const cro::Frustum& frustum)
+    {
+        std::uniform_real_distribution<float> pos(-50.f, 50.f);
+        std::uniform_int_distribution<std::size_t> plane(0, frustum.size() - 1);
+
+        cro::Sphere sphere;
+        sphere.centre = glm::vec3(pos(rng), pos(rng), pos(rng));
+        sphere.radius = std::abs(cro::Spatial::distance(frustum[plane(rng)], sphere.centre));
+        return sphere;
+    }
+
+    void testSpheres()
+    {
+        std::uniform_real_distribution<float> pos(-80.f, 80.f);
+        std::uniform_real_distribution<float> radius(0.f, 20.f);
+        std::uniform_int_distribution<int> boundary(0, 3);
+
+        cro::SphereBatch batch;
+        cro::VisibilityMask mask;
+        std::size_t visibleCount = 0;
+
+        for (auto f = 0u; f < FrustumCount; ++f)
+        {
+            const auto frustum = randomFrustum();
+            for (auto size = 0u; size < MaxBatchSize; ++size)
+            {
+                batch.clear();
+                for (auto i = 0u; i < size; ++i)
+                {
+                    if (boundary(rng) == 0)
+                    {
+                        batch.push_back(boundarySphere(frustum));
+                    }
+                    else
+                    {
+                        batch.push_back(cro::Sphere(radius(rng), glm::vec3(pos(rng), pos(rng), pos(rng))));
+                    }
+                }
+
+                cro::Spatial::intersects(frustum, batch, mask);
+                CHECK(mask.size() == (size + 63) / 64);
+
+                for (auto i = 0u; i < size; ++i)
+                {
+                    const auto expected = scalarVisible(frustum, batch[i]);
+                    CHECK(cro::Spatial::isVisible(mask, i) == expected);
+                    visibleCount += expected ? 1 : 0;
+                }
+
+                //bits past the end of the batch are never set
+                if (size % 64)
+                {
+                    CHECK((mask.back() >> (size % 64)) == 0);
+                }
+            }
+        }
+
+        //make sure the test isn't passing because everything was culled
+        CHECK(visibleCount > 0);
+    }
+
+    void testBoxes()
+    {
+        std::uniform_real_distribution<float> pos(-80.f, 80.f);
+        std::uniform_real_distribution<float> size(0.f, 30.f);
+
+        cro::BoxBatch batch;
+        cro::VisibilityMask mask;
+        std::size_t visibleCount = 0;
+
+        for (auto f = 0u; f < FrustumCount; ++f)
+        {
+            const auto frustum = randomFrustum();
+            for (auto count = 0u; count < MaxBatchSize; ++count)
+            {
+                batch.clear();
+                for (auto i = 0u; i < count; ++i)
+                {
+                    const glm::vec3 min(pos(rng), pos(rng), pos(rng));
+                    batch.push_back(cro::Box(min, min + glm::vec3(size(rng), size(rng), size(rng))));
+                }
+
+                cro::Spatial::intersects(frustum, batch, mask);
+                CHECK(mask.size() == (count + 63) / 64);
+
+                for (auto i = 0u; i < count; ++i)
+                {
+                    const auto expected = scalarVisible(frustum, batch[i]);
+                    CHECK(cro::Spatial::isVisible(mask, i) == expected);
+                    visibleCount += expected ? 1 : 0;
+                }
+            }
+        }
+        CHECK(visibleCount > 0);
+    }
+
+    void testBatchStorage()
+    {
+        cro::SphereBatch spheres;
+        spheres.push_back(cro::Sphere(2.f, glm::vec3(1.f, 2.f, 3.f)));
+        CHECK(spheres.size() == 1);
+        CHECK(spheres[0].radius == 2.f);
+        CHECK(spheres[0].centre == glm::vec3(1.f, 2.f, 3.f));
+
+        cro::BoxBatch boxes;
+        boxes.push_back(cro::Box(glm::vec3(-1.f), glm::vec3(2.f)));
+        CHECK(boxes.size() == 1);
+        CHECK(boxes[0][0] == glm::vec3(-1.f));
+        CHECK(boxes[0][1] == glm::vec3(2.f));
+
+        spheres.clear();
+        boxes.clear();
+        CHECK(spheres.size() == 0);
+        CHECK(boxes.size() == 0);
+    }
+}
+
+int main()
+{
+    testBatchStorage();
+    testSpheres();
+    testBoxes();
+
+    return finish("Spatial");
+}
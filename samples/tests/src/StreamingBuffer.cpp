@@ -0,0 +1,439 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Checks the StreamingBuffer allocator with a fake backend, so that no
+graphics context is needed. The backend records which regions were
+written in each frame against the fence inserted at the end of it,
+and the test checks that no write touches a region of an earlier
+frame until its fence has been waited on, that offsets are aligned,
+that data written this frame stays intact, that buffers replaced
+when growing are only deleted at the start of the next frame and
+that nothing is leaked. The same random workload is then run with
+a backend which orphans the buffer each frame, as on GL 4.1/GLES.
+*/
+
+#include "Test.hpp"
+
+#include <crogine/graphics/StreamingBuffer.hpp>
+
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t RandomFrames = 2000;
+    constexpr std::size_t MaxWritesPerFrame = 20;
+    constexpr std::size_t MaxWriteSize = 8 * 1024;
+    constexpr std::size_t Alignments[] = { 4, 12, 16, 36 };
+
+    std::mt19937 rng(1234);
+
+    struct Range final
+    {
+        std::uint32_t buffer = 0;
+        std::size_t start = 0;
+        std::size_t end = 0;
+        std::uint8_t seed = 0; //byte i of the data is seed + i
+    };
+
+    bool overlaps(const Range& a, const Range& b)
+    {
+        return a.buffer == b.buffer && a.start < b.end && b.start < a.end;
+    }
+
+    //shared between the backend, owned by the StreamingBuffer, and the test
+    struct Recorder final
+    {
+        std::map<std::uint32_t, std::vector<std::uint8_t>> buffers;
+        std::uint32_t nextBuffer = 1;
+
+        struct Fence final
+        {
+            std::vector<Range> ranges;
+            bool signalled = false;
+            bool deleted = false;
+        };
+        std::vector<Fence> fences; //handle is index + 1
+        std::size_t liveFences = 0;
+
+        //written since the last call to beginFrame()
+        std::vector<Range> frameRanges;
+        bool inBeginFrame = false;
+
+        std::size_t createCount = 0;
+        std::size_t orphanCount = 0;
+        std::size_t uploadCount = 0;
+        std::size_t waitCount = 0;
+    };
+
+    class FakeBackend final : public cro::Detail::StreamingBackend
+    {
+    public:
+        FakeBackend(Recorder& recorder, bool persistent)
+            : m_recorder(recorder), m_persistent(persistent) {}
+
+        bool persistentMapping() const override { return m_persistent; }
+
+        std::uint32_t createBuffer(std::size_t size, std::uint8_t** mappedData) override
+        {
+            //handles are never reused so stale ranges can't alias new buffers
+            auto handle = m_recorder.nextBuffer++;
+            auto& storage = m_recorder.buffers[handle];
+            storage.resize(size);
+            if (m_persistent)
+            {
+                *mappedData = storage.data();
+            }
+            m_recorder.createCount++;
+            return handle;
+        }
+
+        void deleteBuffer(std::uint32_t buffer) override
+        {
+            CHECK(m_recorder.buffers.count(buffer) == 1);
+            if (!m_recorder.inBeginFrame)
+            {
+                //still referenced by this frame's draw calls
+                for (const auto& range : m_recorder.frameRanges)
+                {
+                    CHECK(range.buffer != buffer);
+                }
+            }
+            m_recorder.buffers.erase(buffer);
+        }
+
+        void orphanBuffer(std::uint32_t buffer, std::size_t size) override
+        {
+            CHECK(!m_persistent);
+            CHECK(m_recorder.buffers.count(buffer) == 1);
+            CHECK(m_recorder.buffers[buffer].size() == size);
+            m_recorder.orphanCount++;
+        }
+
+        void uploadData(std::uint32_t buffer, std::size_t offset, const void* data, std::size_t size) override
+        {
+            CHECK(!m_persistent);
+            CHECK(m_recorder.buffers.count(buffer) == 1);
+
+            auto& storage = m_recorder.buffers[buffer];
+            CHECK(offset + size <= storage.size());
+            if (offset + size <= storage.size())
+            {
+                std::memcpy(storage.data() + offset, data, size);
+            }
+            m_recorder.uploadCount++;
+        }
+
+        std::uintptr_t insertFence() override
+        {
+            CHECK(m_persistent);
+
+            auto& fence = m_recorder.fences.emplace_back();
+            fence.ranges.swap(m_recorder.frameRanges);
+            m_recorder.liveFences++;
+            return m_recorder.fences.size();
+        }
+
+        void waitFence(std::uintptr_t handle) override
+        {
+            CHECK(handle != 0 && handle <= m_recorder.fences.size());
+            CHECK(!m_recorder.fences[handle - 1].deleted);
+
+            //fences signal in the order they were inserted
+            for (auto i = 0u; i < handle; ++i)
+            {
+                auto& fence = m_recorder.fences[i];
+                if (!fence.deleted)
+                {
+                    fence.signalled = true;
+                    fence.ranges.clear();
+                }
+            }
+            m_recorder.waitCount++;
+        }
+
+        void deleteFence(std::uintptr_t handle) override
+        {
+            CHECK(handle != 0 && handle <= m_recorder.fences.size());
+            CHECK(!m_recorder.fences[handle - 1].deleted);
+
+            //if this wasn't waited on its ranges are kept, and
+            //treated as in use by the GPU for the rest of the test
+            m_recorder.fences[handle - 1].deleted = true;
+            m_recorder.liveFences--;
+        }
+
+    private:
+        Recorder& m_recorder;
+        bool m_persistent;
+    };
+
+    std::vector<std::uint8_t> makeData(std::size_t size, std::uint8_t seed)
+    {
+        std::vector<std::uint8_t> data(size);
+        for (auto i = 0u; i < size; ++i)
+        {
+            data[i] = static_cast<std::uint8_t>(seed + i);
+        }
+        return data;
+    }
+
+    bool intact(const Recorder& recorder, const Range& range)
+    {
+        auto result = recorder.buffers.find(range.buffer);
+        if (result == recorder.buffers.end())
+        {
+            return false;
+        }
+
+        for (auto i = range.start; i < range.end; ++i)
+        {
+            if (result->second[i] != static_cast<std::uint8_t>(range.seed + (i - range.start)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    cro::StreamingBuffer::Allocation write(cro::StreamingBuffer& buffer, Recorder& recorder, std::size_t size, std::size_t alignment)
+    {
+        const auto seed = static_cast<std::uint8_t>(rng());
+        const auto data = makeData(size, seed);
+        const auto allocation = buffer.write(data.data(), size, alignment);
+
+        CHECK(allocation.buffer == buffer.getBuffer());
+        CHECK(allocation.offset % alignment == 0);
+        CHECK(allocation.offset + size <= buffer.getSize());
+
+        Range range;
+        range.buffer = allocation.buffer;
+        range.start = allocation.offset;
+        range.end = allocation.offset + size;
+        range.seed = seed;
+
+        for (const auto& other : recorder.frameRanges)
+        {
+            CHECK(!overlaps(range, other));
+        }
+
+        for (const auto& fence : recorder.fences)
+        {
+            if (!fence.signalled)
+            {
+                for (const auto& other : fence.ranges)
+                {
+                    CHECK(!overlaps(range, other));
+                }
+            }
+        }
+
+        recorder.frameRanges.push_back(range);
+        return allocation;
+    }
+
+    void endFrame(cro::StreamingBuffer& buffer, Recorder& recorder, bool persistent)
+    {
+        //nothing written this frame has been overwritten
+        for (const auto& range : recorder.frameRanges)
+        {
+            CHECK(intact(recorder, range));
+        }
+
+        recorder.inBeginFrame = true;
+        buffer.beginFrame();
+        recorder.inBeginFrame = false;
+
+        if (!persistent)
+        {
+            recorder.frameRanges.clear();
+        }
+        CHECK(recorder.frameRanges.empty());
+    }
+
+    void testRandom(bool persistent)
+    {
+        Recorder recorder;
+        std::size_t writeCount = 0;
+        std::size_t framesWithData = 0;
+        {
+            cro::StreamingBuffer buffer(std::make_unique<FakeBackend>(recorder, persistent), 64 * 1024);
+
+            std::uniform_int_distribution<std::size_t> writeDist(0, MaxWritesPerFrame);
+            std::uniform_int_distribution<std::size_t> sizeDist(1, MaxWriteSize);
+            std::uniform_int_distribution<std::size_t> alignDist(0, std::size(Alignments) - 1);
+
+            for (auto i = 0u; i < RandomFrames; ++i)
+            {
+                const auto writes = writeDist(rng);
+                for (auto j = 0u; j < writes; ++j)
+                {
+                    write(buffer, recorder, sizeDist(rng), Alignments[alignDist(rng)]);
+                }
+                writeCount += writes;
+
+                if (writes != 0)
+                {
+                    framesWithData++;
+                }
+                endFrame(buffer, recorder, persistent);
+            }
+            recorder.frameRanges.clear();
+        }
+
+        if (persistent)
+        {
+            CHECK(recorder.uploadCount == 0);
+            CHECK(recorder.orphanCount == 0);
+        }
+        else
+        {
+            CHECK(recorder.uploadCount == writeCount);
+            CHECK(recorder.fences.empty());
+            CHECK(recorder.orphanCount == framesWithData);
+        }
+
+        //nothing leaked
+        CHECK(recorder.buffers.empty());
+        CHECK(recorder.liveFences == 0);
+    }
+
+    void testGrowth()
+    {
+        Recorder recorder;
+        {
+            //storage is created on the first write, large enough for it
+            cro::StreamingBuffer buffer(std::make_unique<FakeBackend>(recorder, true), 256);
+            CHECK(buffer.getBuffer() == 0);
+
+            auto allocation = write(buffer, recorder, 1000, 4);
+            CHECK(buffer.getSize() == 1000);
+            CHECK(allocation.offset == 0);
+            CHECK(recorder.createCount == 1);
+            endFrame(buffer, recorder, true);
+
+            //doesn't fit after the previous frame, so wraps around
+            //once the previous frame's fence has been waited on
+            allocation = write(buffer, recorder, 600, 4);
+            CHECK(allocation.offset == 0);
+            CHECK(allocation.buffer == 1);
+            CHECK(recorder.waitCount == 1);
+
+            //can't wrap again without overwriting this frame so grows
+            allocation = write(buffer, recorder, 500, 4);
+            CHECK(buffer.getSize() == 2000);
+            CHECK(allocation.offset == 0);
+            CHECK(allocation.buffer == 2);
+
+            //doubled until it fits, the replaced buffers stay
+            //alive until the start of the next frame
+            allocation = write(buffer, recorder, 5000, 4);
+            CHECK(buffer.getSize() == 8000);
+            CHECK(allocation.offset == 0);
+            CHECK(allocation.buffer == 3);
+            CHECK(recorder.buffers.size() == 3);
+            CHECK(recorder.createCount == 3);
+
+            //earlier ranges of this frame are checked in the retired buffers
+            endFrame(buffer, recorder, true);
+
+            CHECK(recorder.buffers.size() == 1);
+            CHECK(recorder.buffers.count(buffer.getBuffer()) == 1);
+            recorder.frameRanges.clear();
+        }
+        CHECK(recorder.buffers.empty());
+        CHECK(recorder.liveFences == 0);
+    }
+
+    void testSteadyState()
+    {
+        //a constant amount of data per frame which fits in the
+        //buffer several times over should never grow the buffer
+        //and should wrap around, waiting on the oldest frames.
+        Recorder recorder;
+        {
+            cro::StreamingBuffer buffer(std::make_unique<FakeBackend>(recorder, true), 64 * 1024);
+            for (auto i = 0u; i < 1000; ++i)
+            {
+                for (auto j = 0u; j < 5; ++j)
+                {
+                    write(buffer, recorder, 2000, 16);
+                }
+                endFrame(buffer, recorder, true);
+
+                //fences are limited when the buffer is much larger than a frame
+                CHECK(recorder.liveFences <= 4);
+            }
+            CHECK(recorder.createCount == 1);
+            CHECK(buffer.getSize() == 64 * 1024);
+            CHECK(recorder.waitCount != 0);
+        }
+        CHECK(recorder.buffers.empty());
+        CHECK(recorder.liveFences == 0);
+    }
+
+    void testOrphaned()
+    {
+        //each frame starts at the beginning of the freshly orphaned buffer
+        Recorder recorder;
+        {
+            cro::StreamingBuffer buffer(std::make_unique<FakeBackend>(recorder, false), 4096);
+            for (auto i = 0u; i < 10; ++i)
+            {
+                auto allocation = write(buffer, recorder, 1000, 4);
+                CHECK(allocation.offset == 0);
+                allocation = write(buffer, recorder, 1000, 12);
+                CHECK(allocation.offset == 1008);
+                endFrame(buffer, recorder, false);
+            }
+
+            //nothing written, so nothing to orphan
+            buffer.beginFrame();
+            CHECK(recorder.orphanCount == 10);
+            CHECK(recorder.createCount == 1);
+        }
+        CHECK(recorder.buffers.empty());
+    }
+}
+
+int main()
+{
+    testRandom(true);
+    testRandom(false);
+    testGrowth();
+    testSteadyState();
+    testOrphaned();
+
+    return finish("StreamingBuffer");
+}
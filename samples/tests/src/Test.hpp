@@ -0,0 +1,64 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2024
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <cstdio>
+
+/*
+Shared helpers for the tests. Each test is its own executable, which
+prints any failed checks and returns non-zero if there were any, so
+that it can be run by ctest.
+*/
+
+namespace
+{
+    int failures = 0;
+    int checks = 0;
+
+    void check(bool result, const char* expression, const char* file, int line)
+    {
+        checks++;
+        if (!result)
+        {
+            failures++;
+            std::printf("%s(%d): check failed: %s\n", file, line, expression);
+        }
+    }
+
+    //prints a summary and returns the exit code for main()
+    int finish(const char* name)
+    {
+        std::printf("%s: %d of %d checks failed\n", name, failures, checks);
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+#define CHECK(x) check((x), #x, __FILE__, __LINE__)